@@ -0,0 +1,201 @@
+// parallel.h
+// A non-stl header only set of parallel algorithms over random access containers
+// running on a non_stl::parallel::thread_pool
+
+/*
+ * for_each, transform, reduce and sort split a container such as non_stl::vector or non_stl::deque
+ * into chunks of grain elements which run on a work stealing thread_pool. Each call takes a policy,
+ * par for the shared pool and an automatic grain, or par.on(pool) / par.with_grain(n) to choose them.
+ * The automatic grain makes about 8 chunks per thread. For containers with a block_size, such as
+ * deque, the grain is rounded up to whole blocks so chunks mostly touch blocks of their own.
+ * As with std::execution::par the functions given must be safe to call concurrently and reduce
+ * requires an associative and commutative operation. reduce combines the chunks in order, so its
+ * result only depends on the grain and not on the scheduling.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::max, std::min, std::sort, std::inplace_merge
+#include <functional>		// std::plus, std::less
+#include <iterator>			// std::begin
+#include <optional>			// std::optional
+#include <type_traits>		// std::void_t
+#include <utility>			// std::move
+
+#include "thread_pool.h"	// non_stl::parallel::thread_pool
+#include "../containers/vector.h"	// non_stl::vector
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	namespace parallel
+	{
+		// Chooses the pool the algorithms run on and the amount of elements per chunk
+		struct policy
+		{
+			// The pool to run on, thread_pool::shared() when null
+			thread_pool* pool = nullptr;
+
+			// Elements per chunk, chosen from the size of the container and the pool when 0
+			size_type grain = 0;
+
+			// Returns a copy of this policy running on p
+			constexpr policy on(thread_pool& p) const noexcept { return policy{ &p, grain }; }
+
+			// Returns a copy of this policy with chunks of n elements
+			constexpr policy with_grain(size_type n) const noexcept { return policy{ pool, n }; }
+		};
+
+		// Runs on the shared pool with an automatic grain
+		inline constexpr policy par{};
+
+		// Calls f on every element of r
+		template <class Range, class F>
+		void for_each(const policy& exec, Range& r, F f);
+
+		// Assigns op(e) to the element of out at the position of each element e of in
+		// out must hold at least as many elements as in, the two must not overlap
+		template <class InRange, class OutRange, class UnaryOp>
+		void transform(const policy& exec, const InRange& in, OutRange& out, UnaryOp op);
+
+		// Returns init combined by op with every element of r, in an unspecified grouping
+		template <class Range, class T, class BinaryOp = std::plus<> >
+		T reduce(const policy& exec, const Range& r, T init, BinaryOp op = BinaryOp());
+
+		// Sorts the elements of r with comp, not stable
+		// Each thread sorts a run, the runs are then merged pairwise in parallel
+		template <class Range, class Compare = std::less<> >
+		void sort(const policy& exec, Range& r, Compare comp = Compare());
+
+		// ---------------
+		// PRIVATE
+		// ---------------
+		namespace detail
+		{
+			template <class Range, class = void>
+			struct block_size_of : std::integral_constant<size_type, 1> {};
+
+			template <class Range>
+			struct block_size_of<Range, std::void_t<decltype(Range::block_size)> > :
+				std::integral_constant<size_type, Range::block_size> {};
+
+			inline thread_pool& pool_of(const policy& exec)
+			{
+				return exec.pool ? *exec.pool : thread_pool::shared();
+			}
+
+			// Returns the grain of exec for n elements of Range on pool
+			template <class Range>
+			size_type grain_of(const policy& exec, const thread_pool& pool, size_type n)
+			{
+				constexpr size_type block = block_size_of<std::remove_const_t<Range> >::value;
+				size_type grain = exec.grain ? exec.grain : std::max<size_type>(n / (pool.size() * 8), 1);
+				return (grain + block - 1) / block * block;
+			}
+		}
+
+		// PARALLEL IMPL
+
+		template <class Range, class F>
+		void for_each(const policy& exec, Range& r, F f)
+		{
+			auto& pool = detail::pool_of(exec);
+			const size_type n = r.size();
+			const auto first = std::begin(r);
+
+			pool.run(n, detail::grain_of<Range>(exec, pool, n), [&](size_type begin, size_type end) {
+				auto it = first + begin;
+				for (size_type i = begin; i < end; ++i, ++it)
+				{
+					f(*it);
+				}
+			});
+		}
+
+		template <class InRange, class OutRange, class UnaryOp>
+		void transform(const policy& exec, const InRange& in, OutRange& out, UnaryOp op)
+		{
+			auto& pool = detail::pool_of(exec);
+			const size_type n = in.size();
+			const auto first = std::begin(in);
+			const auto dest = std::begin(out);
+
+			pool.run(n, detail::grain_of<InRange>(exec, pool, n), [&](size_type begin, size_type end) {
+				auto it = first + begin;
+				auto to = dest + begin;
+				for (size_type i = begin; i < end; ++i, ++it, ++to)
+				{
+					*to = op(*it);
+				}
+			});
+		}
+
+		template <class Range, class T, class BinaryOp>
+		T reduce(const policy& exec, const Range& r, T init, BinaryOp op)
+		{
+			auto& pool = detail::pool_of(exec);
+			const size_type n = r.size();
+			const auto first = std::begin(r);
+			const size_type grain = detail::grain_of<Range>(exec, pool, n);
+
+			// One partial result per chunk, combined in order once all of them are done
+			vector<std::optional<T> > partials(n / grain + (n % grain != 0));
+
+			pool.run(n, grain, [&](size_type begin, size_type end) {
+				auto it = first + begin;
+				T acc = *it;
+				for (size_type i = begin + 1; i < end; ++i)
+				{
+					acc = op(std::move(acc), *++it);
+				}
+				partials[begin / grain].emplace(std::move(acc));
+			});
+
+			for (auto& partial : partials)
+			{
+				init = op(std::move(init), std::move(*partial));
+			}
+			return init;
+		}
+
+		template <class Range, class Compare>
+		void sort(const policy& exec, Range& r, Compare comp)
+		{
+			auto& pool = detail::pool_of(exec);
+			const size_type n = r.size();
+			const auto first = std::begin(r);
+
+			// One run per thread unless that makes runs smaller than the grain
+			const size_type grain = detail::grain_of<Range>(exec, pool, n);
+			const size_type runs = std::max<size_type>(std::min(pool.size(), n / grain), 1);
+			const size_type run_size = n / runs + (n % runs != 0);
+
+			pool.run(runs, 1, [&](size_type begin, size_type end) {
+				for (size_type i = begin; i < end; ++i)
+				{
+					std::sort(first + std::min(i * run_size, n), first + std::min((i + 1) * run_size, n), comp);
+				}
+			});
+
+			// Merge neighbouring runs, halving their amount each round
+			for (size_type width = run_size; width < n; width *= 2)
+			{
+				const size_type pairs = n / (2 * width) + (n % (2 * width) != 0);
+				pool.run(pairs, 1, [&](size_type begin, size_type end) {
+					for (size_type i = begin; i < end; ++i)
+					{
+						const size_type lo = i * 2 * width;
+						const size_type mid = std::min(lo + width, n);
+						const size_type hi = std::min(lo + 2 * width, n);
+						if (mid < hi)
+						{
+							std::inplace_merge(first + lo, first + mid, first + hi, comp);
+						}
+					}
+				});
+			}
+		}
+	}
+}
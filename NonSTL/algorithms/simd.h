@@ -0,0 +1,1135 @@
+// simd.h
+// A non-stl header only set of vectorized bulk algorithms over contiguous ranges
+// Note, the standard is used for some components such as std::atomic and type traits
+
+/*
+ * The algorithms mirror find, count, min_element, max_element, accumulate, fill and replace from
+ * <algorithm> and <numeric>, with the scan done 32 or 64 bytes at a time. The instruction set is chosen
+ * once at runtime from what the CPU supports: AVX-512 (F and BW), then AVX2, then plain loops which the
+ * compiler is free to vectorize for the baseline target.
+ *
+ * Only element types whose equality and ordering match their bits are vectorized:
+ * find, count and replace take integers, enums and pointers of 1, 2, 4 or 8 bytes, fill takes any
+ * trivially copyable type of those sizes, and min / max / accumulate take integers. Every other type,
+ * including floating point where reordering would change the results, runs the plain loop.
+ * min / max of those types compare with operator< only, in a single pass like std::min_element, so
+ * unordered values such as NaN give the same position the standard algorithm does.
+ * accumulate of integers with an init of the element type wraps around on overflow, signed ones included.
+ *
+ * Each algorithm takes either a pointer range, returning a pointer as <algorithm> does, or a range:
+ * anything with data() and size() such as non_stl::vector, non_stl::span or std::vector, or a circular
+ * buffer exposing its elements as the two runs array_one() and array_two(). Range overloads return the
+ * position of the element in iteration order, or size() when there is none.
+ */
+
+#pragma once
+
+// Includes
+#include <array>			// std::array
+#include <atomic>			// std::atomic
+#include <cstdint>			// std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+#include <cstring>			// std::memcpy, std::memset
+#include <type_traits>		// std::conditional_t, std::is_integral_v, std::void_t
+#include <utility>			// std::declval
+
+#include "../containers/span.h"	// non_stl::span
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NON_STL_SIMD_X86
+#include <immintrin.h>		// AVX2 and AVX-512 intrinsics
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>			// __cpuid, __cpuidex, _BitScanForward64, __popcnt64
+#endif
+
+// GCC and Clang only emit the intrinsics inside functions compiled for their instruction set
+#if defined(NON_STL_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NON_STL_SIMD_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define NON_STL_SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,popcnt")))
+#else
+#define NON_STL_SIMD_TARGET_AVX2
+#define NON_STL_SIMD_TARGET_AVX512
+#endif
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	namespace simd
+	{
+		// Instruction sets the algorithms can run on, ordered from the least to the most capable
+		enum class isa
+		{
+			scalar,
+			avx2,
+			avx512
+		};
+
+		// Returns the most capable instruction set supported by the CPU and operating system
+		inline isa detected_isa() noexcept;
+
+		// Returns the instruction set the algorithms currently use, detected_isa() unless changed
+		inline isa active_isa() noexcept;
+
+		// Makes the algorithms use requested, or the detected instruction set if the CPU lacks it
+		// Returns the instruction set now in use. Meant for testing and benchmarking each path
+		inline isa set_isa(isa requested) noexcept;
+
+		// ---------------
+		// POINTER RANGES
+		// ---------------
+
+		// Returns a pointer to the first element of [first, last) equal to value, or last
+		template <class T>
+		T* find(T* first, T* last, const std::remove_const_t<T>& value);
+
+		// Returns the amount of elements of [first, last) equal to value
+		template <class T>
+		size_type count(T* first, T* last, const std::remove_const_t<T>& value);
+
+		// Returns a pointer to the first smallest / largest element of [first, last), or last if empty
+		template <class T>
+		T* min_element(T* first, T* last);
+		template <class T>
+		T* max_element(T* first, T* last);
+
+		// Returns init plus the sum of the elements of [first, last)
+		template <class T, class Init>
+		Init accumulate(T* first, T* last, Init init);
+
+		// Assigns value to every element of [first, last)
+		template <class T>
+		void fill(T* first, T* last, const T& value);
+
+		// Replaces every element of [first, last) equal to old_value by new_value
+		template <class T>
+		void replace(T* first, T* last, const T& old_value, const T& new_value);
+
+		// ---------------
+		// RANGES
+		// ---------------
+
+		namespace detail
+		{
+			template <class Range, class = void>
+			struct has_two_runs : std::false_type {};
+
+			template <class Range>
+			struct has_two_runs<Range, std::void_t<decltype(std::declval<Range&>().array_one()),
+				decltype(std::declval<Range&>().array_two())> > : std::true_type {};
+
+			// Returns the elements of r as at most two contiguous runs, in iteration order
+			template <class Range>
+			auto runs(Range& r)
+			{
+				if constexpr (has_two_runs<Range>::value)
+				{
+					return std::array<decltype(r.array_one()), 2>{ r.array_one(), r.array_two() };
+				}
+				else
+				{
+					using T = std::remove_pointer_t<decltype(r.data())>;
+					return std::array<span<T>, 2>{ span<T>(r.data(), r.size()), span<T>() };
+				}
+			}
+
+			// The element type of r, const qualified if r only gives read access
+			template <class Range>
+			using element_t = typename decltype(runs(std::declval<Range&>()))::value_type::element_type;
+
+			template <class Range>
+			using value_t = std::remove_const_t<element_t<Range> >;
+		}
+
+		// Returns the position of the first element of r equal to value, or its size if there is none
+		template <class Range>
+		size_type find(const Range& r, const detail::value_t<const Range>& value);
+
+		// Returns the amount of elements of r equal to value
+		template <class Range>
+		size_type count(const Range& r, const detail::value_t<const Range>& value);
+
+		// Returns the position of the first smallest / largest element of r, or its size if empty
+		template <class Range>
+		size_type min_element(const Range& r);
+		template <class Range>
+		size_type max_element(const Range& r);
+
+		// Returns init plus the sum of the elements of r
+		template <class Range, class Init>
+		Init accumulate(const Range& r, Init init);
+
+		// Assigns value to every element of r
+		template <class Range>
+		void fill(Range& r, const detail::value_t<Range>& value);
+
+		// Replaces every element of r equal to old_value by new_value
+		template <class Range>
+		void replace(Range& r, const detail::value_t<Range>& old_value, const detail::value_t<Range>& new_value);
+
+		// ---------------
+		// PRIVATE
+		// ---------------
+
+		namespace detail
+		{
+			template <class T>
+			inline constexpr bool is_vector_width_v = sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8;
+
+			// Types whose equality is equality of their bits
+			template <class T>
+			inline constexpr bool is_bitwise_comparable_v =
+				(std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>) && is_vector_width_v<T>;
+
+			// Types which can be broadcast and stored as raw bits
+			template <class T>
+			inline constexpr bool is_bitwise_fillable_v = std::is_trivially_copyable_v<T> && is_vector_width_v<T>;
+
+			// Integers which have vector min, max and add
+			template <class T>
+			inline constexpr bool is_vector_integer_v = std::is_integral_v<T> && !std::is_same_v<T, bool> && is_vector_width_v<T>;
+
+			// Unsigned integer holding the bits of T
+			template <class T>
+			using bits_t = std::conditional_t<sizeof(T) == 1, std::uint8_t,
+				std::conditional_t<sizeof(T) == 2, std::uint16_t,
+				std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t> > >;
+
+			template <class T>
+			inline bits_t<T> to_bits(const T& value) noexcept
+			{
+				bits_t<T> bits;
+				std::memcpy(&bits, &value, sizeof(T));
+				return bits;
+			}
+
+			template <class T>
+			inline T from_bits(bits_t<T> bits) noexcept
+			{
+				T value;
+				std::memcpy(&value, &bits, sizeof(T));
+				return value;
+			}
+
+			inline unsigned lowest_bit(std::uint64_t mask) noexcept
+			{
+#if defined(_MSC_VER) && defined(NON_STL_SIMD_X86)
+				unsigned long index;
+				_BitScanForward64(&index, mask);
+				return static_cast<unsigned>(index);
+#else
+				return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+			}
+
+			inline unsigned popcount(std::uint64_t mask) noexcept
+			{
+#if defined(_MSC_VER) && defined(NON_STL_SIMD_X86)
+				return static_cast<unsigned>(__popcnt64(mask));
+#else
+				return static_cast<unsigned>(__builtin_popcountll(mask));
+#endif
+			}
+
+			inline isa detect_isa() noexcept
+			{
+#if defined(NON_STL_SIMD_X86)
+#if defined(_MSC_VER)
+				int info[4];
+				__cpuid(info, 0);
+				if (info[0] < 7)
+				{
+					return isa::scalar;
+				}
+
+				// The operating system has to save the wider registers too
+				__cpuid(info, 1);
+				if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)))
+				{
+					return isa::scalar;
+				}
+				const auto xcr0 = _xgetbv(0);
+
+				__cpuidex(info, 7, 0);
+				if ((xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) && (info[1] & (1 << 30)))
+				{
+					return isa::avx512;
+				}
+				if ((xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)))
+				{
+					return isa::avx2;
+				}
+#else
+				__builtin_cpu_init();
+				if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+				{
+					return isa::avx512;
+				}
+				if (__builtin_cpu_supports("avx2"))
+				{
+					return isa::avx2;
+				}
+#endif
+#endif
+				return isa::scalar;
+			}
+
+			inline std::atomic<isa>& active_isa_state() noexcept
+			{
+				static std::atomic<isa> state(detected_isa());
+				return state;
+			}
+
+			// Scalar loops, also used for the elements past the last full vector
+
+			template <class T>
+			size_type find_scalar(const T* data, size_type n, const T& value)
+			{
+				for (size_type i = 0; i < n; ++i)
+				{
+					if (data[i] == value)
+					{
+						return i;
+					}
+				}
+				return n;
+			}
+
+			template <class T>
+			size_type count_scalar(const T* data, size_type n, const T& value)
+			{
+				size_type total = 0;
+				for (size_type i = 0; i < n; ++i)
+				{
+					total += data[i] == value;
+				}
+				return total;
+			}
+
+			// Returns the smallest or, if Max, the largest element, n must be at least 1
+			template <bool Max, class T>
+			T extreme_scalar(const T* data, size_type n)
+			{
+				T best = data[0];
+				for (size_type i = 1; i < n; ++i)
+				{
+					if (Max ? best < data[i] : data[i] < best)
+					{
+						best = data[i];
+					}
+				}
+				return best;
+			}
+
+			// Returns the position of the first smallest or, if Max, the first largest element
+			// Compares with operator< only, as std::min_element and std::max_element do
+			template <bool Max, class T>
+			size_type extreme_index_scalar(const T* data, size_type n)
+			{
+				size_type best = 0;
+				for (size_type i = 1; i < n; ++i)
+				{
+					if (Max ? data[best] < data[i] : data[i] < data[best])
+					{
+						best = i;
+					}
+				}
+				return best;
+			}
+
+			// Sums in the bits of T so integer overflow wraps around
+			template <class T>
+			bits_t<T> sum_scalar(const T* data, size_type n)
+			{
+				bits_t<T> total = 0;
+				for (size_type i = 0; i < n; ++i)
+				{
+					total = static_cast<bits_t<T> >(total + to_bits(data[i]));
+				}
+				return total;
+			}
+
+			template <class T>
+			void fill_scalar(T* data, size_type n, const T& value)
+			{
+				for (size_type i = 0; i < n; ++i)
+				{
+					data[i] = value;
+				}
+			}
+
+			template <class T>
+			void replace_scalar(T* data, size_type n, const T& old_value, const T& new_value)
+			{
+				for (size_type i = 0; i < n; ++i)
+				{
+					if (data[i] == old_value)
+					{
+						data[i] = new_value;
+					}
+				}
+			}
+
+#if defined(NON_STL_SIMD_X86)
+			// ---------------
+			// AVX2
+			// ---------------
+			// 32 byte vectors, comparisons give a mask with a bit per byte which is divided by the width
+			namespace avx2
+			{
+				NON_STL_SIMD_TARGET_AVX2 inline __m256i load(const void* p) noexcept
+				{
+					return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+				}
+
+				NON_STL_SIMD_TARGET_AVX2 inline void store(void* p, __m256i v) noexcept
+				{
+					_mm256_storeu_si256(static_cast<__m256i*>(p), v);
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX2 inline __m256i broadcast(const T& value) noexcept
+				{
+					const auto bits = to_bits(value);
+					if constexpr (sizeof(T) == 1) return _mm256_set1_epi8(static_cast<char>(bits));
+					else if constexpr (sizeof(T) == 2) return _mm256_set1_epi16(static_cast<short>(bits));
+					else if constexpr (sizeof(T) == 4) return _mm256_set1_epi32(static_cast<int>(bits));
+					else return _mm256_set1_epi64x(static_cast<long long>(bits));
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX2 inline __m256i equal(__m256i a, __m256i b) noexcept
+				{
+					if constexpr (sizeof(T) == 1) return _mm256_cmpeq_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) return _mm256_cmpeq_epi16(a, b);
+					else if constexpr (sizeof(T) == 4) return _mm256_cmpeq_epi32(a, b);
+					else return _mm256_cmpeq_epi64(a, b);
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX2 inline std::uint32_t equal_bytes(__m256i a, __m256i b) noexcept
+				{
+					return static_cast<std::uint32_t>(_mm256_movemask_epi8(equal<T>(a, b)));
+				}
+
+				// AVX2 has no 8 byte min and max, those are left to the scalar loop
+				template <bool Max, class T>
+				NON_STL_SIMD_TARGET_AVX2 inline __m256i extreme(__m256i a, __m256i b) noexcept
+				{
+					if constexpr (std::is_signed_v<T>)
+					{
+						if constexpr (sizeof(T) == 1) return Max ? _mm256_max_epi8(a, b) : _mm256_min_epi8(a, b);
+						else if constexpr (sizeof(T) == 2) return Max ? _mm256_max_epi16(a, b) : _mm256_min_epi16(a, b);
+						else return Max ? _mm256_max_epi32(a, b) : _mm256_min_epi32(a, b);
+					}
+					else
+					{
+						if constexpr (sizeof(T) == 1) return Max ? _mm256_max_epu8(a, b) : _mm256_min_epu8(a, b);
+						else if constexpr (sizeof(T) == 2) return Max ? _mm256_max_epu16(a, b) : _mm256_min_epu16(a, b);
+						else return Max ? _mm256_max_epu32(a, b) : _mm256_min_epu32(a, b);
+					}
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX2 inline __m256i add(__m256i a, __m256i b) noexcept
+				{
+					if constexpr (sizeof(T) == 1) return _mm256_add_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) return _mm256_add_epi16(a, b);
+					else if constexpr (sizeof(T) == 4) return _mm256_add_epi32(a, b);
+					else return _mm256_add_epi64(a, b);
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX2 size_type find(const T* data, size_type n, const T& value)
+				{
+					constexpr size_type L = 32 / sizeof(T);
+					const __m256i needle = broadcast(value);
+
+					size_type i = 0;
+					// Two vectors per iteration to keep both load ports busy
+					for (; i + 2 * L <= n; i += 2 * L)
+					{
+						const auto lo = equal_bytes<T>(load(data + i), needle);
+						const auto hi = equal_bytes<T>(load(data + i + L), needle);
+						if (lo | hi)
+						{
+							return i + (lo ? lowest_bit(lo) : 32 + lowest_bit(hi)) / sizeof(T);
+						}
+					}
+					for (; i + L <= n; i += L)
+					{
+						const auto mask = equal_bytes<T>(load(data + i), needle);
+						if (mask)
+						{
+							return i + lowest_bit(mask) / sizeof(T);
+						}
+					}
+					return i + find_scalar(data + i, n - i, value);
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX2 size_type count(const T* data, size_type n, const T& value)
+				{
+					constexpr size_type L = 32 / sizeof(T);
+					const __m256i needle = broadcast(value);
+
+					size_type bytes = 0;
+					size_type i = 0;
+					for (; i + L <= n; i += L)
+					{
+						bytes += popcount(equal_bytes<T>(load(data + i), needle));
+					}
+					return bytes / sizeof(T) + count_scalar(data + i, n - i, value);
+				}
+
+				template <bool Max, class T>
+				NON_STL_SIMD_TARGET_AVX2 T extreme(const T* data, size_type n)
+				{
+					constexpr size_type L = 32 / sizeof(T);
+					if (n < L)
+					{
+						return extreme_scalar<Max>(data, n);
+					}
+
+					__m256i best = load(data);
+					size_type i = L;
+					for (; i + L <= n; i += L)
+					{
+						best = extreme<Max, T>(best, load(data + i));
+					}
+
+					T lanes[L];
+					store(lanes, best);
+					T result = extreme_scalar<Max>(lanes, L);
+					for (; i < n; ++i)
+					{
+						if (Max ? result < data[i] : data[i] < result)
+						{
+							result = data[i];
+						}
+					}
+					return result;
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX2 bits_t<T> sum(const T* data, size_type n)
+				{
+					constexpr size_type L = 32 / sizeof(T);
+
+					__m256i total = _mm256_setzero_si256();
+					size_type i = 0;
+					for (; i + L <= n; i += L)
+					{
+						total = add<T>(total, load(data + i));
+					}
+
+					T lanes[L];
+					store(lanes, total);
+					return static_cast<bits_t<T> >(sum_scalar(lanes, L) + sum_scalar(data + i, n - i));
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX2 void fill(T* data, size_type n, const T& value)
+				{
+					constexpr size_type L = 32 / sizeof(T);
+					const __m256i v = broadcast(value);
+
+					size_type i = 0;
+					for (; i + L <= n; i += L)
+					{
+						store(data + i, v);
+					}
+					fill_scalar(data + i, n - i, value);
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX2 void replace(T* data, size_type n, const T& old_value, const T& new_value)
+				{
+					constexpr size_type L = 32 / sizeof(T);
+					const __m256i from = broadcast(old_value);
+					const __m256i to = broadcast(new_value);
+
+					size_type i = 0;
+					for (; i + L <= n; i += L)
+					{
+						const __m256i v = load(data + i);
+						store(data + i, _mm256_blendv_epi8(v, to, equal<T>(v, from)));
+					}
+					replace_scalar(data + i, n - i, old_value, new_value);
+				}
+			}
+
+			// ---------------
+			// AVX-512
+			// ---------------
+			// 64 byte vectors, comparisons give a mask with a bit per lane and the elements past the
+			// last full vector are handled by masked loads and stores
+			namespace avx512
+			{
+				// Returns a mask of the first n lanes
+				inline std::uint64_t first_lanes(size_type n) noexcept
+				{
+					return n >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 inline __m512i load(const T* p) noexcept
+				{
+					return _mm512_loadu_si512(static_cast<const void*>(p));
+				}
+
+				// Loads the lanes of mask from p and takes the others from src
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 inline __m512i load(__m512i src, std::uint64_t mask, const T* p) noexcept
+				{
+					if constexpr (sizeof(T) == 1) return _mm512_mask_loadu_epi8(src, static_cast<__mmask64>(mask), p);
+					else if constexpr (sizeof(T) == 2) return _mm512_mask_loadu_epi16(src, static_cast<__mmask32>(mask), p);
+					else if constexpr (sizeof(T) == 4) return _mm512_mask_loadu_epi32(src, static_cast<__mmask16>(mask), p);
+					else return _mm512_mask_loadu_epi64(src, static_cast<__mmask8>(mask), p);
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 inline void store(T* p, std::uint64_t mask, __m512i v) noexcept
+				{
+					if constexpr (sizeof(T) == 1) _mm512_mask_storeu_epi8(p, static_cast<__mmask64>(mask), v);
+					else if constexpr (sizeof(T) == 2) _mm512_mask_storeu_epi16(p, static_cast<__mmask32>(mask), v);
+					else if constexpr (sizeof(T) == 4) _mm512_mask_storeu_epi32(p, static_cast<__mmask16>(mask), v);
+					else _mm512_mask_storeu_epi64(p, static_cast<__mmask8>(mask), v);
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 inline __m512i broadcast(const T& value) noexcept
+				{
+					const auto bits = to_bits(value);
+					if constexpr (sizeof(T) == 1) return _mm512_set1_epi8(static_cast<char>(bits));
+					else if constexpr (sizeof(T) == 2) return _mm512_set1_epi16(static_cast<short>(bits));
+					else if constexpr (sizeof(T) == 4) return _mm512_set1_epi32(static_cast<int>(bits));
+					else return _mm512_set1_epi64(static_cast<long long>(bits));
+				}
+
+				// Returns the lanes of mask where a and b are equal
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 inline std::uint64_t equal(std::uint64_t mask, __m512i a, __m512i b) noexcept
+				{
+					if constexpr (sizeof(T) == 1) return _mm512_mask_cmpeq_epi8_mask(static_cast<__mmask64>(mask), a, b);
+					else if constexpr (sizeof(T) == 2) return _mm512_mask_cmpeq_epi16_mask(static_cast<__mmask32>(mask), a, b);
+					else if constexpr (sizeof(T) == 4) return _mm512_mask_cmpeq_epi32_mask(static_cast<__mmask16>(mask), a, b);
+					else return _mm512_mask_cmpeq_epi64_mask(static_cast<__mmask8>(mask), a, b);
+				}
+
+				// The 4 and 8 byte forms are zero masked with every lane set, the unmasked ones pass an
+				// undefined vector through which GCC 12 reports as maybe uninitialized
+				template <bool Max, class T>
+				NON_STL_SIMD_TARGET_AVX512 inline __m512i extreme(__m512i a, __m512i b) noexcept
+				{
+					if constexpr (std::is_signed_v<T>)
+					{
+						if constexpr (sizeof(T) == 1) return Max ? _mm512_max_epi8(a, b) : _mm512_min_epi8(a, b);
+						else if constexpr (sizeof(T) == 2) return Max ? _mm512_max_epi16(a, b) : _mm512_min_epi16(a, b);
+						else if constexpr (sizeof(T) == 4) return Max ? _mm512_maskz_max_epi32(0xFFFF, a, b) : _mm512_maskz_min_epi32(0xFFFF, a, b);
+						else return Max ? _mm512_maskz_max_epi64(0xFF, a, b) : _mm512_maskz_min_epi64(0xFF, a, b);
+					}
+					else
+					{
+						if constexpr (sizeof(T) == 1) return Max ? _mm512_max_epu8(a, b) : _mm512_min_epu8(a, b);
+						else if constexpr (sizeof(T) == 2) return Max ? _mm512_max_epu16(a, b) : _mm512_min_epu16(a, b);
+						else if constexpr (sizeof(T) == 4) return Max ? _mm512_maskz_max_epu32(0xFFFF, a, b) : _mm512_maskz_min_epu32(0xFFFF, a, b);
+						else return Max ? _mm512_maskz_max_epu64(0xFF, a, b) : _mm512_maskz_min_epu64(0xFF, a, b);
+					}
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 inline __m512i add(__m512i a, __m512i b) noexcept
+				{
+					if constexpr (sizeof(T) == 1) return _mm512_add_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) return _mm512_add_epi16(a, b);
+					else if constexpr (sizeof(T) == 4) return _mm512_add_epi32(a, b);
+					else return _mm512_add_epi64(a, b);
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 size_type find(const T* data, size_type n, const T& value)
+				{
+					constexpr size_type L = 64 / sizeof(T);
+					const __m512i needle = broadcast(value);
+
+					size_type i = 0;
+					for (; i + L <= n; i += L)
+					{
+						const auto mask = equal<T>(first_lanes(L), load(data + i), needle);
+						if (mask)
+						{
+							return i + lowest_bit(mask);
+						}
+					}
+					if (i < n)
+					{
+						const auto lanes = first_lanes(n - i);
+						const auto mask = equal<T>(lanes, load(needle, lanes, data + i), needle);
+						if (mask)
+						{
+							return i + lowest_bit(mask);
+						}
+					}
+					return n;
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 size_type count(const T* data, size_type n, const T& value)
+				{
+					constexpr size_type L = 64 / sizeof(T);
+					const __m512i needle = broadcast(value);
+
+					size_type total = 0;
+					size_type i = 0;
+					for (; i + L <= n; i += L)
+					{
+						total += popcount(equal<T>(first_lanes(L), load(data + i), needle));
+					}
+					if (i < n)
+					{
+						const auto lanes = first_lanes(n - i);
+						total += popcount(equal<T>(lanes, load(needle, lanes, data + i), needle));
+					}
+					return total;
+				}
+
+				template <bool Max, class T>
+				NON_STL_SIMD_TARGET_AVX512 T extreme(const T* data, size_type n)
+				{
+					constexpr size_type L = 64 / sizeof(T);
+
+					// The lanes past the end start as the first element so they never win
+					__m512i best = broadcast(data[0]);
+					size_type i = 0;
+					for (; i + L <= n; i += L)
+					{
+						best = extreme<Max, T>(best, load(data + i));
+					}
+					if (i < n)
+					{
+						best = extreme<Max, T>(best, load(best, first_lanes(n - i), data + i));
+					}
+
+					T lanes[L];
+					_mm512_storeu_si512(static_cast<void*>(lanes), best);
+					return extreme_scalar<Max>(lanes, L);
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 bits_t<T> sum(const T* data, size_type n)
+				{
+					constexpr size_type L = 64 / sizeof(T);
+
+					__m512i total = _mm512_setzero_si512();
+					size_type i = 0;
+					for (; i + L <= n; i += L)
+					{
+						total = add<T>(total, load(data + i));
+					}
+					if (i < n)
+					{
+						total = add<T>(total, load(_mm512_setzero_si512(), first_lanes(n - i), data + i));
+					}
+
+					T lanes[L];
+					_mm512_storeu_si512(static_cast<void*>(lanes), total);
+					return sum_scalar(lanes, L);
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 void fill(T* data, size_type n, const T& value)
+				{
+					constexpr size_type L = 64 / sizeof(T);
+					const __m512i v = broadcast(value);
+
+					size_type i = 0;
+					for (; i + L <= n; i += L)
+					{
+						_mm512_storeu_si512(static_cast<void*>(data + i), v);
+					}
+					if (i < n)
+					{
+						store(data + i, first_lanes(n - i), v);
+					}
+				}
+
+				template <class T>
+				NON_STL_SIMD_TARGET_AVX512 void replace(T* data, size_type n, const T& old_value, const T& new_value)
+				{
+					constexpr size_type L = 64 / sizeof(T);
+					const __m512i from = broadcast(old_value);
+					const __m512i to = broadcast(new_value);
+
+					// Only the lanes which matched are written
+					size_type i = 0;
+					for (; i + L <= n; i += L)
+					{
+						store(data + i, equal<T>(first_lanes(L), load(data + i), from), to);
+					}
+					if (i < n)
+					{
+						const auto lanes = first_lanes(n - i);
+						store(data + i, equal<T>(lanes, load(to, lanes, data + i), from), to);
+					}
+				}
+			}
+#endif
+
+			// Dispatchers on a pointer and an element count
+
+			template <class T>
+			size_type find_n(const T* data, size_type n, const T& value)
+			{
+#if defined(NON_STL_SIMD_X86)
+				if constexpr (is_bitwise_comparable_v<T>)
+				{
+					switch (active_isa())
+					{
+					case isa::avx512: return avx512::find(data, n, value);
+					case isa::avx2: return avx2::find(data, n, value);
+					default: break;
+					}
+				}
+#endif
+				return find_scalar(data, n, value);
+			}
+
+			template <class T>
+			size_type count_n(const T* data, size_type n, const T& value)
+			{
+#if defined(NON_STL_SIMD_X86)
+				if constexpr (is_bitwise_comparable_v<T>)
+				{
+					switch (active_isa())
+					{
+					case isa::avx512: return avx512::count(data, n, value);
+					case isa::avx2: return avx2::count(data, n, value);
+					default: break;
+					}
+				}
+#endif
+				return count_scalar(data, n, value);
+			}
+
+			// n must be at least 1
+			template <bool Max, class T>
+			T extreme_n(const T* data, size_type n)
+			{
+#if defined(NON_STL_SIMD_X86)
+				if constexpr (is_vector_integer_v<T>)
+				{
+					switch (active_isa())
+					{
+					case isa::avx512: return avx512::extreme<Max>(data, n);
+					case isa::avx2:
+						if constexpr (sizeof(T) != 8)
+						{
+							return avx2::extreme<Max>(data, n);
+						}
+						break;
+					default: break;
+					}
+				}
+#endif
+				return extreme_scalar<Max>(data, n);
+			}
+
+			template <class T, class Init>
+			Init accumulate_n(const T* data, size_type n, Init init)
+			{
+				if constexpr (is_vector_integer_v<T> && std::is_same_v<T, Init>)
+				{
+#if defined(NON_STL_SIMD_X86)
+					switch (active_isa())
+					{
+					case isa::avx512: return from_bits<T>(static_cast<bits_t<T> >(to_bits(init) + avx512::sum(data, n)));
+					case isa::avx2: return from_bits<T>(static_cast<bits_t<T> >(to_bits(init) + avx2::sum(data, n)));
+					default: break;
+					}
+#endif
+					// Summed in the bits of T as signed overflow is undefined
+					return from_bits<T>(static_cast<bits_t<T> >(to_bits(init) + sum_scalar(data, n)));
+				}
+				else
+				{
+					for (size_type i = 0; i < n; ++i)
+					{
+						init = init + data[i];
+					}
+					return init;
+				}
+			}
+
+			template <class T>
+			void fill_n(T* data, size_type n, const T& value)
+			{
+				if constexpr (sizeof(T) == 1 && std::is_trivially_copyable_v<T>)
+				{
+					if (n > 0)
+					{
+						std::memset(static_cast<void*>(data), to_bits(value), n);
+					}
+					return;
+				}
+#if defined(NON_STL_SIMD_X86)
+				if constexpr (is_bitwise_fillable_v<T>)
+				{
+					switch (active_isa())
+					{
+					case isa::avx512: avx512::fill(data, n, value); return;
+					case isa::avx2: avx2::fill(data, n, value); return;
+					default: break;
+					}
+				}
+#endif
+				fill_scalar(data, n, value);
+			}
+
+			template <class T>
+			void replace_n(T* data, size_type n, const T& old_value, const T& new_value)
+			{
+#if defined(NON_STL_SIMD_X86)
+				if constexpr (is_bitwise_comparable_v<T>)
+				{
+					switch (active_isa())
+					{
+					case isa::avx512: avx512::replace(data, n, old_value, new_value); return;
+					case isa::avx2: avx2::replace(data, n, old_value, new_value); return;
+					default: break;
+					}
+				}
+#endif
+				replace_scalar(data, n, old_value, new_value);
+			}
+
+			// Finds the smallest / largest value with the vector extreme, then its first position
+			template <bool Max, class Runs>
+			size_type extreme_value_position(const Runs& parts)
+			{
+				bool found = false;
+				std::remove_const_t<typename Runs::value_type::element_type> best{};
+				for (const auto& part : parts)
+				{
+					if (part.size() == 0)
+					{
+						continue;
+					}
+					const auto candidate = extreme_n<Max>(part.data(), part.size());
+					if (!found || (Max ? best < candidate : candidate < best))
+					{
+						best = candidate;
+						found = true;
+					}
+				}
+
+				size_type offset = 0;
+				for (const auto& part : parts)
+				{
+					if (found)
+					{
+						const auto i = find_n(part.data(), part.size(), best);
+						if (i != part.size())
+						{
+							return offset + i;
+						}
+					}
+					offset += part.size();
+				}
+				return offset;
+			}
+
+			// Returns the position of the first smallest / largest element of the runs
+			template <bool Max, class Runs>
+			size_type extreme_position(const Runs& parts)
+			{
+				using T = std::remove_const_t<typename Runs::value_type::element_type>;
+				if constexpr (!is_vector_integer_v<T>)
+				{
+					// One pass over every run comparing against the best so far, as std::min_element does
+					const T* best = nullptr;
+					size_type position = 0;
+					size_type offset = 0;
+					for (const auto& part : parts)
+					{
+						for (size_type i = 0; i < part.size(); ++i)
+						{
+							if (!best || (Max ? *best < part.data()[i] : part.data()[i] < *best))
+							{
+								best = part.data() + i;
+								position = offset + i;
+							}
+						}
+						offset += part.size();
+					}
+					return best ? position : offset;
+				}
+				else
+				{
+					return extreme_value_position<Max>(parts);
+				}
+			}
+		}
+
+		// ---------------
+		// ISA IMPL
+		// ---------------
+		inline isa detected_isa() noexcept
+		{
+			static const isa detected = detail::detect_isa();
+			return detected;
+		}
+
+		inline isa active_isa() noexcept
+		{
+			return detail::active_isa_state().load(std::memory_order_relaxed);
+		}
+
+		inline isa set_isa(isa requested) noexcept
+		{
+			const isa chosen = requested < detected_isa() ? requested : detected_isa();
+			detail::active_isa_state().store(chosen, std::memory_order_relaxed);
+			return chosen;
+		}
+
+		// ---------------
+		// POINTER RANGES
+		// ---------------
+		template <class T>
+		inline T* find(T* first, T* last, const std::remove_const_t<T>& value)
+		{
+			return first + detail::find_n<std::remove_const_t<T> >(first, static_cast<size_type>(last - first), value);
+		}
+
+		template <class T>
+		inline size_type count(T* first, T* last, const std::remove_const_t<T>& value)
+		{
+			return detail::count_n<std::remove_const_t<T> >(first, static_cast<size_type>(last - first), value);
+		}
+
+		template <class T>
+		T* min_element(T* first, T* last)
+		{
+			if (first == last)
+			{
+				return last;
+			}
+			const auto n = static_cast<size_type>(last - first);
+			if constexpr (detail::is_vector_integer_v<std::remove_const_t<T> >)
+			{
+				return simd::find(first, last, detail::extreme_n<false>(first, n));
+			}
+			else
+			{
+				return first + detail::extreme_index_scalar<false>(first, n);
+			}
+		}
+
+		template <class T>
+		T* max_element(T* first, T* last)
+		{
+			if (first == last)
+			{
+				return last;
+			}
+			const auto n = static_cast<size_type>(last - first);
+			if constexpr (detail::is_vector_integer_v<std::remove_const_t<T> >)
+			{
+				return simd::find(first, last, detail::extreme_n<true>(first, n));
+			}
+			else
+			{
+				return first + detail::extreme_index_scalar<true>(first, n);
+			}
+		}
+
+		template <class T, class Init>
+		inline Init accumulate(T* first, T* last, Init init)
+		{
+			return detail::accumulate_n(first, static_cast<size_type>(last - first), std::move(init));
+		}
+
+		template <class T>
+		inline void fill(T* first, T* last, const T& value)
+		{
+			detail::fill_n(first, static_cast<size_type>(last - first), value);
+		}
+
+		template <class T>
+		inline void replace(T* first, T* last, const T& old_value, const T& new_value)
+		{
+			detail::replace_n(first, static_cast<size_type>(last - first), old_value, new_value);
+		}
+
+		// ---------------
+		// RANGES
+		// ---------------
+		template <class Range>
+		size_type find(const Range& r, const detail::value_t<const Range>& value)
+		{
+			size_type offset = 0;
+			for (const auto& part : detail::runs(r))
+			{
+				const auto i = detail::find_n(part.data(), part.size(), value);
+				if (i != part.size())
+				{
+					return offset + i;
+				}
+				offset += part.size();
+			}
+			return offset;
+		}
+
+		template <class Range>
+		size_type count(const Range& r, const detail::value_t<const Range>& value)
+		{
+			size_type total = 0;
+			for (const auto& part : detail::runs(r))
+			{
+				total += detail::count_n(part.data(), part.size(), value);
+			}
+			return total;
+		}
+
+		template <class Range>
+		inline size_type min_element(const Range& r)
+		{
+			return detail::extreme_position<false>(detail::runs(r));
+		}
+
+		template <class Range>
+		inline size_type max_element(const Range& r)
+		{
+			return detail::extreme_position<true>(detail::runs(r));
+		}
+
+		template <class Range, class Init>
+		Init accumulate(const Range& r, Init init)
+		{
+			for (const auto& part : detail::runs(r))
+			{
+				init = detail::accumulate_n(part.data(), part.size(), std::move(init));
+			}
+			return init;
+		}
+
+		template <class Range>
+		void fill(Range& r, const detail::value_t<Range>& value)
+		{
+			for (const auto& part : detail::runs(r))
+			{
+				detail::fill_n(part.data(), part.size(), value);
+			}
+		}
+
+		template <class Range>
+		void replace(Range& r, const detail::value_t<Range>& old_value, const detail::value_t<Range>& new_value)
+		{
+			for (const auto& part : detail::runs(r))
+			{
+				detail::replace_n(part.data(), part.size(), old_value, new_value);
+			}
+		}
+	}
+}
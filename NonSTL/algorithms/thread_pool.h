@@ -0,0 +1,344 @@
+// thread_pool.h
+// A non-stl header only work stealing thread pool running index ranges split into chunks
+// Note, the standard is used for some components such as std::thread and std::mutex
+
+/*
+ * A thread_pool of n threads starts n - 1 workers, the thread calling run() being the last one.
+ * run(n, grain, f) splits [0, n) into chunks of grain indices and deals them out in order to the
+ * per thread deques, each worker then takes chunks from the front of its own deque and once it is
+ * empty steals from the back of the others'. The caller steals as well until every chunk of its call
+ * has finished, so calls made from inside a chunk never deadlock. If f throws, the chunks not started
+ * yet are skipped and the first exception is rethrown by run().
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::max, std::min
+#include <atomic>			// std::atomic
+#include <condition_variable>	// std::condition_variable
+#include <exception>		// std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <memory>			// std::unique_ptr
+#include <mutex>			// std::mutex, std::lock_guard, std::unique_lock
+#include <thread>			// std::thread, std::this_thread::yield
+#include <type_traits>		// std::remove_reference_t
+
+#include "../containers/deque.h"	// non_stl::deque
+#include "../containers/vector.h"	// non_stl::vector
+#include "../memory/cache_line.h"	// non_stl::cache_line_size
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	namespace parallel
+	{
+		class thread_pool
+		{
+			// ---------------
+			// BEGIN INTERFACE
+			// ---------------
+		public:
+			// ---------------
+			// CONSTRUCTORS
+			// ---------------
+
+			// Constructs a pool running on threads threads including the caller of run()
+			// A pool of 1 thread runs every chunk on the caller
+			explicit thread_pool(size_type threads = default_concurrency());
+
+			thread_pool(const thread_pool&) = delete;
+			thread_pool& operator=(const thread_pool&) = delete;
+
+			// ---------------
+			// DESTRUCTOR
+			// ---------------
+			// Stops and joins the workers, no run() may be in progress
+			~thread_pool();
+
+			// Returns the process wide pool of default_concurrency() threads, started on first use
+			static thread_pool& shared();
+
+			// Returns the amount of hardware threads, at least 1
+			static size_type default_concurrency() noexcept;
+
+			// ---------------
+			// CAPACITY
+			// ---------------
+
+			// Returns the amount of threads chunks run on, including the caller
+			size_type size() const noexcept;
+
+			// ---------------
+			// MODIFIERS
+			// ---------------
+
+			// Calls f(begin, end) for consecutive chunks [begin, end) of grain indices covering [0, n)
+			// and returns once all of them finished. Chunks run concurrently, f must be safe to call so
+			// Rethrows the first exception thrown by f
+			template <class F>
+			void run(size_type n, size_type grain, F&& f);
+
+			// ---------------
+			// END INTERFACE
+			// ---------------
+		private:
+			// A call to run(), living on the stack of its caller
+			struct job
+			{
+				void (*invoke)(void* fn, size_type begin, size_type end);
+				void* fn;
+
+				// Chunks not finished yet
+				std::atomic<size_type> remaining;
+
+				// Set once f threw, the remaining chunks are then skipped
+				std::atomic<bool> failed;
+				std::exception_ptr error;
+			};
+
+			struct chunk
+			{
+				job* owner;
+				size_type begin;
+				size_type end;
+			};
+
+			// The chunks dealt to one thread, padded so the deques of two threads never share a line
+			struct alignas(cache_line_size) slot
+			{
+				std::mutex mutex;
+				deque<chunk> chunks;
+			};
+
+			// Body of the worker owning slot index
+			void work(size_type index);
+
+			// Takes a chunk from the front of slot index, or steals one from the back of another slot
+			bool take(size_type index, chunk& out);
+
+			// Runs out and marks it finished
+			static void execute(const chunk& out) noexcept;
+
+			// One slot per worker, the caller of run() only steals
+			size_type _workers;
+			std::unique_ptr<slot[]> _slots;
+			vector<std::thread> _threads;
+
+			// Chunks sitting in the slots, workers sleep while it is 0
+			std::atomic<size_type> _queued;
+			std::mutex _sleep_mutex;
+			std::condition_variable _wake;
+			bool _stop;
+		};
+
+		// THREAD POOL IMPL
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+		inline thread_pool::thread_pool(size_type threads) :
+			_workers(std::max<size_type>(threads, 1) - 1),
+			_slots(new slot[std::max<size_type>(_workers, 1)]),
+			_threads(),
+			_queued(0),
+			_stop(false)
+		{
+			_threads.reserve(_workers);
+			for (size_type i = 0; i < _workers; ++i)
+			{
+				_threads.emplace_back([this, i] { work(i); });
+			}
+		}
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+		inline thread_pool::~thread_pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_sleep_mutex);
+				_stop = true;
+			}
+			_wake.notify_all();
+			for (auto& thread : _threads)
+			{
+				thread.join();
+			}
+		}
+
+		inline thread_pool& thread_pool::shared()
+		{
+			static thread_pool pool;
+			return pool;
+		}
+
+		inline size_type thread_pool::default_concurrency() noexcept
+		{
+			return std::max<size_type>(std::thread::hardware_concurrency(), 1);
+		}
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+		inline size_type thread_pool::size() const noexcept
+		{
+			return _workers + 1;
+		}
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+		template <class F>
+		void thread_pool::run(size_type n, size_type grain, F&& f)
+		{
+			grain = std::max<size_type>(grain, 1);
+			const size_type chunks = n / grain + (n % grain != 0);
+			if (chunks == 0)
+			{
+				return;
+			}
+
+			// Nothing to share the work with
+			if (_workers == 0 || chunks == 1)
+			{
+				for (size_type begin = 0; begin < n; begin += grain)
+				{
+					f(begin, std::min(begin + grain, n));
+				}
+				return;
+			}
+
+			job call;
+			call.invoke = [](void* fn, size_type begin, size_type end) { (*static_cast<std::remove_reference_t<F>*>(fn))(begin, end); };
+			call.fn = const_cast<void*>(static_cast<const void*>(&f));
+			call.remaining.store(chunks, std::memory_order_relaxed);
+			call.failed.store(false, std::memory_order_relaxed);
+
+			{
+				// Counted before the chunks are dealt so the count is never below the chunks in the slots
+				// Taking the lock orders it before any worker checks it and goes to sleep
+				std::lock_guard<std::mutex> lock(_sleep_mutex);
+				_queued.fetch_add(chunks, std::memory_order_relaxed);
+			}
+
+			// Consecutive chunks go to the same slot so each worker starts on a contiguous range
+			for (size_type s = 0; s < _workers; ++s)
+			{
+				const size_type first = chunks * s / _workers;
+				const size_type last = chunks * (s + 1) / _workers;
+				if (first == last)
+				{
+					continue;
+				}
+
+				std::lock_guard<std::mutex> lock(_slots[s].mutex);
+				for (size_type c = first; c < last; ++c)
+				{
+					_slots[s].chunks.push_back(chunk{ &call, c * grain, std::min((c + 1) * grain, n) });
+				}
+			}
+			_wake.notify_all();
+
+			// Help until every chunk of this call finished, possibly running chunks of other calls
+			while (call.remaining.load(std::memory_order_acquire) != 0)
+			{
+				chunk next;
+				if (take(_workers, next))
+				{
+					execute(next);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+
+			if (call.failed.load(std::memory_order_relaxed))
+			{
+				std::rethrow_exception(call.error);
+			}
+		}
+
+		// ---------------
+		// PRIVATE
+		// ---------------
+		inline void thread_pool::work(size_type index)
+		{
+			for (;;)
+			{
+				chunk next;
+				if (take(index, next))
+				{
+					execute(next);
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(_sleep_mutex);
+				_wake.wait(lock, [this] { return _stop || _queued.load(std::memory_order_relaxed) != 0; });
+				if (_stop)
+				{
+					return;
+				}
+			}
+		}
+
+		inline bool thread_pool::take(size_type index, chunk& out)
+		{
+			if (_queued.load(std::memory_order_relaxed) == 0)
+			{
+				return false;
+			}
+
+			// Own chunks first, in order
+			if (index < _workers)
+			{
+				std::lock_guard<std::mutex> lock(_slots[index].mutex);
+				if (!_slots[index].chunks.empty())
+				{
+					out = _slots[index].chunks.front();
+					_slots[index].chunks.pop_front();
+					_queued.fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+
+			// Then the far end of the others, which the owners reach last
+			for (size_type i = 1; i <= _workers; ++i)
+			{
+				const size_type victim = (index + i) % _workers;
+				std::lock_guard<std::mutex> lock(_slots[victim].mutex);
+				if (!_slots[victim].chunks.empty())
+				{
+					out = _slots[victim].chunks.back();
+					_slots[victim].chunks.pop_back();
+					_queued.fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		inline void thread_pool::execute(const chunk& out) noexcept
+		{
+			job& call = *out.owner;
+			if (!call.failed.load(std::memory_order_relaxed))
+			{
+				try
+				{
+					call.invoke(call.fn, out.begin, out.end);
+				}
+				catch (...)
+				{
+					// Only the first exception is kept
+					bool expected = false;
+					if (call.failed.compare_exchange_strong(expected, true, std::memory_order_relaxed))
+					{
+						call.error = std::current_exception();
+					}
+				}
+			}
+			call.remaining.fetch_sub(1, std::memory_order_release);
+		}
+	}
+}
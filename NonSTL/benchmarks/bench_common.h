@@ -0,0 +1,73 @@
+// bench_common.h
+// Element types and size ranges shared by the container benchmarks
+
+/*
+ * Every benchmark runs over three element types: int, a 64 byte trivially copyable struct
+ * and std::string (long enough to defeat the small string optimisation), and over sizes from 16
+ * up to 100M elements. The largest sizes are capped so a single container stays under 1GB.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::min
+#include <cstdint>			// std::int64_t
+#include <string>			// std::string
+
+#include <benchmark/benchmark.h>
+
+using size_type = size_t;
+
+namespace non_stl_bench
+{
+	// Trivially copyable element filling a cache line
+	struct pod64
+	{
+		std::int64_t values[8];
+	};
+
+	// Returns the i-th value of type T used to fill the containers
+	template <class T>
+	inline T make_value(size_type i);
+
+	template <>
+	inline int make_value<int>(size_type i)
+	{
+		return static_cast<int>(i);
+	}
+
+	template <>
+	inline pod64 make_value<pod64>(size_type i)
+	{
+		pod64 p{};
+		p.values[0] = static_cast<std::int64_t>(i);
+		return p;
+	}
+
+	template <>
+	inline std::string make_value<std::string>(size_type i)
+	{
+		return std::string(32, static_cast<char>('a' + i % 26));
+	}
+
+	// Returns a value derived from element so iterating can't be optimised away
+	inline std::int64_t touch(int element) { return element; }
+	inline std::int64_t touch(const pod64& element) { return element.values[0]; }
+	inline std::int64_t touch(const std::string& element) { return static_cast<std::int64_t>(element.size()); }
+
+	// Largest amount of elements of type T a benchmark creates
+	template <class T>
+	constexpr std::int64_t max_elements()
+	{
+		constexpr std::int64_t limit = 100'000'000;
+		constexpr std::int64_t bytes = std::int64_t(1) << 30;
+		return std::min<std::int64_t>(limit, bytes / static_cast<std::int64_t>(sizeof(T)));
+	}
+
+	// Registers sizes from 16 to max_elements<T> growing 8x at a time
+	template <class T>
+	void sizes(benchmark::internal::Benchmark* b)
+	{
+		b->RangeMultiplier(8)->Range(16, max_elements<T>());
+	}
+}
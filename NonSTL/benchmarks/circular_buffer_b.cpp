@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+#ifdef NON_STL_BENCH_BOOST
+#include <boost/circular_buffer.hpp>
+#endif
+
+#include "bench_common.h"
+#include "../containers/circular_buffer.h"
+#include "../containers/dynamic_circular_buffer.h"
+
+using namespace non_stl_bench;
+
+// Each buffer kind is created through make(capacity), on the heap so the inline storage of
+// circular_buffer never ends up on the stack
+template <class T>
+struct dynamic_buffer
+{
+	using type = non_stl::dynamic_circular_buffer<T>;
+	static std::unique_ptr<type> make(size_type capacity) { return std::make_unique<type>(capacity); }
+};
+
+// circular_buffer fixes its capacity at compile time, N must match the registered size
+template <class T, size_type N>
+struct fixed_buffer
+{
+	using type = non_stl::circular_buffer<T, N>;
+	static std::unique_ptr<type> make(size_type) { return std::make_unique<type>(); }
+};
+
+#ifdef NON_STL_BENCH_BOOST
+template <class T>
+struct boost_buffer
+{
+	using type = boost::circular_buffer<T>;
+	static std::unique_ptr<type> make(size_type capacity) { return std::make_unique<type>(capacity); }
+};
+#endif
+
+// Writing
+
+// Fills the buffer then keeps pushing so every further push overwrites the oldest element
+template <class Buffer, class T>
+static void BM_push_overwrite(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	auto buffer = Buffer::make(n);
+	const T value = make_value<T>(1);
+
+	for (auto _ : state) {
+		for (size_type i = 0; i < n; ++i) {
+			buffer->push_back(value);
+		}
+		benchmark::DoNotOptimize(&buffer->back());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Uses the buffer as a queue, pushing n elements then popping them all
+template <class Buffer, class T>
+static void BM_push_pop(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	auto buffer = Buffer::make(n);
+	const T value = make_value<T>(1);
+
+	for (auto _ : state) {
+		for (size_type i = 0; i < n; ++i) {
+			buffer->push_back(value);
+		}
+		std::int64_t sum = 0;
+		for (size_type i = 0; i < n; ++i) {
+			sum += touch(buffer->front());
+			buffer->pop_front();
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+// Reading
+
+// Iterates a full buffer whose elements wrap around the end of the array
+template <class Buffer, class T>
+static void BM_iterate(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	auto buffer = Buffer::make(n);
+	for (size_type i = 0; i < n + n / 2; ++i) {
+		buffer->push_back(make_value<T>(i));
+	}
+	const auto& view = *buffer;
+
+	for (auto _ : state) {
+		std::int64_t sum = 0;
+		for (const auto& element : view) {
+			sum += touch(element);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#ifdef NON_STL_BENCH_BOOST
+#define RUNTIME_BUFFER_BENCHMARK(name, T) \
+	BENCHMARK_TEMPLATE(name, dynamic_buffer<T>, T)->Apply(sizes<T>); \
+	BENCHMARK_TEMPLATE(name, boost_buffer<T>, T)->Apply(sizes<T>)
+#else
+#define RUNTIME_BUFFER_BENCHMARK(name, T) \
+	BENCHMARK_TEMPLATE(name, dynamic_buffer<T>, T)->Apply(sizes<T>)
+#endif
+
+#define FIXED_BUFFER_BENCHMARK(name, T, N) \
+	BENCHMARK_TEMPLATE(name, fixed_buffer<T, N>, T)->Arg(N)
+
+// The fixed capacity buffer is measured at a few sizes spanning the cache levels
+#define BUFFER_BENCHMARK(name, T) \
+	RUNTIME_BUFFER_BENCHMARK(name, T); \
+	FIXED_BUFFER_BENCHMARK(name, T, 1024); \
+	FIXED_BUFFER_BENCHMARK(name, T, 65536); \
+	FIXED_BUFFER_BENCHMARK(name, T, 1048576)
+
+#define BUFFER_BENCHMARKS(T) \
+	BUFFER_BENCHMARK(BM_push_overwrite, T); \
+	BUFFER_BENCHMARK(BM_push_pop, T); \
+	BUFFER_BENCHMARK(BM_iterate, T)
+
+BUFFER_BENCHMARKS(int);
+BUFFER_BENCHMARKS(pod64);
+BUFFER_BENCHMARKS(std::string);
+
+BENCHMARK_MAIN();
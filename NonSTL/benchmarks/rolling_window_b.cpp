@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "bench_common.h"
+#include "../containers/circular_buffer.h"
+#include "../containers/rolling_window.h"
+
+using namespace non_stl_bench;
+
+// Latency samples in nanoseconds
+static std::uint32_t sample(size_type i) {
+	return static_cast<std::uint32_t>(1000 + (i * 2654435761u) % 50000);
+}
+
+// A window of N samples updated then read once per sample, as a per connection latency tracker does
+
+template <size_type N>
+static void BM_recompute(benchmark::State& state) {
+	non_stl::circular_buffer<std::uint32_t, N> window;
+	size_type i = 0;
+	for (auto _ : state) {
+		window.push_back(sample(i++));
+
+		// Sum, min and max iterating the whole window
+		std::uint64_t sum = 0;
+		std::uint32_t lo = UINT32_MAX;
+		std::uint32_t hi = 0;
+		for (std::uint32_t v : window) {
+			sum += v;
+			lo = std::min(lo, v);
+			hi = std::max(hi, v);
+		}
+		benchmark::DoNotOptimize(sum);
+		benchmark::DoNotOptimize(lo);
+		benchmark::DoNotOptimize(hi);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+template <size_type N>
+static void BM_rolling(benchmark::State& state) {
+	using non_stl::rolling_max;
+	using non_stl::rolling_min;
+	using non_stl::rolling_sum;
+	non_stl::rolling_window<std::uint32_t, N, rolling_sum, rolling_min, rolling_max> window;
+	size_type i = 0;
+	for (auto _ : state) {
+		window.push_back(sample(i++));
+		benchmark::DoNotOptimize(window.template get<rolling_sum>().value());
+		benchmark::DoNotOptimize(window.template get<rolling_min>().value());
+		benchmark::DoNotOptimize(window.template get<rolling_max>().value());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+// The histogram behind percentiles costs a log per sample, reading it walks the buckets
+template <size_type N>
+static void BM_rolling_quantile(benchmark::State& state) {
+	using quantiles = non_stl::rolling_quantile<>;
+	non_stl::rolling_window<std::uint32_t, N, quantiles> window;
+	size_type i = 0;
+	for (auto _ : state) {
+		window.push_back(sample(i++));
+	}
+	benchmark::DoNotOptimize(window.template get<quantiles>().quantile(0.99));
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_recompute, 64);
+BENCHMARK_TEMPLATE(BM_rolling, 64);
+BENCHMARK_TEMPLATE(BM_recompute, 1024);
+BENCHMARK_TEMPLATE(BM_rolling, 1024);
+BENCHMARK_TEMPLATE(BM_recompute, 16384);
+BENCHMARK_TEMPLATE(BM_rolling, 16384);
+BENCHMARK_TEMPLATE(BM_rolling_quantile, 1024);
+
+BENCHMARK_MAIN();
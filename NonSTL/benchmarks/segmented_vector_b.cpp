@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "bench_common.h"
+#include "../containers/segmented_vector.h"
+#include "../containers/vector.h"
+
+using namespace non_stl_bench;
+
+// Fills the container one push_back at a time, timing each push so the worst one is reported
+// alongside the throughput. For vector it is the final reallocation, segmented_vector never copies
+template <class V, class T>
+static void BM_push_back_latency(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	const T value = make_value<T>(1);
+	double worst = 0;
+
+	for (auto _ : state) {
+		V v;
+		for (size_type i = 0; i < n; ++i) {
+			const auto start = std::chrono::steady_clock::now();
+			v.push_back(value);
+			const auto end = std::chrono::steady_clock::now();
+			worst = std::max(worst, std::chrono::duration<double, std::nano>(end - start).count());
+		}
+		benchmark::DoNotOptimize(&v.back());
+	}
+	state.counters["max_push_ns"] = worst;
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Indexed reads, which segmented_vector pays a bit scan for
+template <class V, class T>
+static void BM_index(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	V v;
+	for (size_type i = 0; i < n; ++i) {
+		v.push_back(make_value<T>(i));
+	}
+
+	for (auto _ : state) {
+		std::int64_t sum = 0;
+		for (size_type i = 0; i < n; ++i) {
+			sum += touch(v[i]);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void large(benchmark::internal::Benchmark* b) {
+	b->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+}
+
+#define SEGMENTED_BENCHMARK(name, T) \
+	BENCHMARK_TEMPLATE(name, non_stl::vector<T>, T)->Apply(large); \
+	BENCHMARK_TEMPLATE(name, non_stl::segmented_vector<T>, T)->Apply(large)
+
+SEGMENTED_BENCHMARK(BM_push_back_latency, int);
+SEGMENTED_BENCHMARK(BM_push_back_latency, pod64);
+SEGMENTED_BENCHMARK(BM_index, int);
+SEGMENTED_BENCHMARK(BM_index, pod64);
+
+BENCHMARK_MAIN();
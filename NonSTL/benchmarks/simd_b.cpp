@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+#include "bench_common.h"
+#include "../algorithms/simd.h"
+#include "../containers/vector.h"
+
+using namespace non_stl_bench;
+
+namespace simd = non_stl::simd;
+
+// The scans run over vector<uint32_t> as log filters do, the value searched for is absent
+static non_stl::vector<std::uint32_t> filled(size_type n) {
+	non_stl::vector<std::uint32_t> v;
+	v.reserve(n);
+	for (size_type i = 0; i < n; ++i) {
+		v.push_back(static_cast<std::uint32_t>(i % 1000));
+	}
+	return v;
+}
+
+// Runs scan with the instruction set given as the second argument
+template <class F>
+static void run(benchmark::State& state, F scan) {
+	const auto v = filled(static_cast<size_type>(state.range(0)));
+	simd::set_isa(static_cast<simd::isa>(state.range(1)));
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(scan(v));
+	}
+	simd::set_isa(simd::detected_isa());
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetLabel(state.range(1) == 0 ? "scalar" : state.range(1) == 1 ? "avx2" : "avx512");
+}
+
+static void isas(benchmark::internal::Benchmark* b) {
+	for (std::int64_t n : { 1 << 10, 1 << 16, 1 << 22 }) {
+		for (int set = 0; set <= static_cast<int>(simd::detected_isa()); ++set) {
+			b->Args({ n, set });
+		}
+	}
+}
+
+// The standard algorithms don't depend on the instruction set
+static void scalar(benchmark::internal::Benchmark* b) {
+	for (std::int64_t n : { 1 << 10, 1 << 16, 1 << 22 }) {
+		b->Args({ n, 0 });
+	}
+}
+
+static void BM_std_find(benchmark::State& state) {
+	run(state, [](const auto& v) { return std::find(v.data(), v.data() + v.size(), 5000u); });
+}
+
+static void BM_simd_find(benchmark::State& state) {
+	run(state, [](const auto& v) { return simd::find(v, 5000u); });
+}
+
+static void BM_std_count(benchmark::State& state) {
+	run(state, [](const auto& v) { return std::count(v.data(), v.data() + v.size(), 7u); });
+}
+
+static void BM_simd_count(benchmark::State& state) {
+	run(state, [](const auto& v) { return simd::count(v, 7u); });
+}
+
+static void BM_std_min_element(benchmark::State& state) {
+	run(state, [](const auto& v) { return std::min_element(v.data(), v.data() + v.size()); });
+}
+
+static void BM_simd_min_element(benchmark::State& state) {
+	run(state, [](const auto& v) { return simd::min_element(v); });
+}
+
+static void BM_std_accumulate(benchmark::State& state) {
+	run(state, [](const auto& v) { return std::accumulate(v.data(), v.data() + v.size(), std::uint32_t(0)); });
+}
+
+static void BM_simd_accumulate(benchmark::State& state) {
+	run(state, [](const auto& v) { return simd::accumulate(v, std::uint32_t(0)); });
+}
+
+BENCHMARK(BM_std_find)->Apply(scalar);
+BENCHMARK(BM_simd_find)->Apply(isas);
+BENCHMARK(BM_std_count)->Apply(scalar);
+BENCHMARK(BM_simd_count)->Apply(isas);
+BENCHMARK(BM_std_min_element)->Apply(scalar);
+BENCHMARK(BM_simd_min_element)->Apply(isas);
+BENCHMARK(BM_std_accumulate)->Apply(scalar);
+BENCHMARK(BM_simd_accumulate)->Apply(isas);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "bench_common.h"
+#include "../algorithms/simd.h"
+#include "../containers/soa_vector.h"
+#include "../containers/vector.h"
+
+using namespace non_stl_bench;
+
+// An order book level, of which a scan usually reads a single field
+struct order
+{
+	double price;
+	std::uint32_t quantity;
+	std::uint32_t trader;
+	std::int64_t timestamp;
+	std::int64_t flags;
+};
+
+using order_columns = non_stl::soa_vector<double, std::uint32_t, std::uint32_t, std::int64_t, std::int64_t>;
+
+static void rows(benchmark::internal::Benchmark* b) {
+	b->RangeMultiplier(8)->Range(1 << 10, 1 << 24);
+}
+
+// Appending
+
+static void BM_push_back_aos(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	for (auto _ : state) {
+		non_stl::vector<order> book;
+		for (size_type i = 0; i < n; ++i) {
+			book.push_back(order{ 1.0, static_cast<std::uint32_t>(i), 0, 0, 0 });
+		}
+		benchmark::DoNotOptimize(book.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_push_back_soa(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	for (auto _ : state) {
+		order_columns book;
+		for (size_type i = 0; i < n; ++i) {
+			book.emplace_back(1.0, static_cast<std::uint32_t>(i), 0u, std::int64_t(0), std::int64_t(0));
+		}
+		benchmark::DoNotOptimize(book.data<0>());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Summing the quantity of every level, the column wise access soa_vector is made for
+
+static void BM_sum_field_aos(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	non_stl::vector<order> book;
+	for (size_type i = 0; i < n; ++i) {
+		book.push_back(order{ 1.0, static_cast<std::uint32_t>(i % 100), 0, 0, 0 });
+	}
+
+	for (auto _ : state) {
+		std::uint64_t sum = 0;
+		for (const auto& level : book) {
+			sum += level.quantity;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_sum_field_soa(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	order_columns book;
+	for (size_type i = 0; i < n; ++i) {
+		book.emplace_back(1.0, static_cast<std::uint32_t>(i % 100), 0u, std::int64_t(0), std::int64_t(0));
+	}
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(non_stl::simd::accumulate(book.column<1>(), std::uint64_t(0)));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_push_back_aos)->Apply(rows);
+BENCHMARK(BM_push_back_soa)->Apply(rows);
+BENCHMARK(BM_sum_field_aos)->Apply(rows);
+BENCHMARK(BM_sum_field_soa)->Apply(rows);
+
+BENCHMARK_MAIN();
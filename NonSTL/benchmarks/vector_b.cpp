@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_common.h"
+#include "../containers/vector.h"
+
+using namespace non_stl_bench;
+
+// Returns a container holding the first n values
+template <class V, class T>
+static V filled(size_type n) {
+	V v;
+	v.reserve(n);
+	for (size_type i = 0; i < n; ++i) {
+		v.push_back(make_value<T>(i));
+	}
+	return v;
+}
+
+// Growing
+
+template <class V, class T>
+static void BM_push_back(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	const T value = make_value<T>(1);
+
+	for (auto _ : state) {
+		V v;
+		for (size_type i = 0; i < n; ++i) {
+			v.push_back(value);
+		}
+		benchmark::DoNotOptimize(v.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class V, class T>
+static void BM_emplace_back(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+
+	for (auto _ : state) {
+		V v;
+		for (size_type i = 0; i < n; ++i) {
+			v.emplace_back(make_value<T>(i));
+		}
+		benchmark::DoNotOptimize(v.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class V, class T>
+static void BM_reserve_fill(benchmark::State& state) {
+	const auto n = static_cast<size_type>(state.range(0));
+	const T value = make_value<T>(1);
+
+	for (auto _ : state) {
+		V v;
+		v.reserve(n);
+		for (size_type i = 0; i < n; ++i) {
+			v.push_back(value);
+		}
+		benchmark::DoNotOptimize(v.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Shifting
+
+// Inserts then erases an element in the middle, shifting half the elements twice
+template <class V, class T>
+static void BM_insert_middle(benchmark::State& state) {
+	auto v = filled<V, T>(static_cast<size_type>(state.range(0)));
+	const T value = make_value<T>(1);
+
+	for (auto _ : state) {
+		auto it = v.insert(v.begin() + v.size() / 2, value);
+		v.erase(it);
+		benchmark::DoNotOptimize(v.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Reading
+
+template <class V, class T>
+static void BM_iterate(benchmark::State& state) {
+	const auto v = filled<V, T>(static_cast<size_type>(state.range(0)));
+
+	for (auto _ : state) {
+		std::int64_t sum = 0;
+		for (const auto& element : v) {
+			sum += touch(element);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Copying
+
+template <class V, class T>
+static void BM_copy(benchmark::State& state) {
+	const auto v = filled<V, T>(static_cast<size_type>(state.range(0)));
+
+	for (auto _ : state) {
+		V copy(v);
+		benchmark::DoNotOptimize(copy.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(T)));
+}
+
+// Moves the vector out and back again
+template <class V, class T>
+static void BM_move(benchmark::State& state) {
+	auto v = filled<V, T>(static_cast<size_type>(state.range(0)));
+
+	for (auto _ : state) {
+		V moved(std::move(v));
+		benchmark::DoNotOptimize(moved.data());
+		v = std::move(moved);
+	}
+}
+
+// The containers don't all declare value_type, the element type is passed along
+#define VECTOR_BENCHMARK(name, T) \
+	BENCHMARK_TEMPLATE(name, std::vector<T>, T)->Apply(sizes<T>); \
+	BENCHMARK_TEMPLATE(name, non_stl::vector<T>, T)->Apply(sizes<T>)
+
+#define VECTOR_BENCHMARKS(T) \
+	VECTOR_BENCHMARK(BM_push_back, T); \
+	VECTOR_BENCHMARK(BM_emplace_back, T); \
+	VECTOR_BENCHMARK(BM_reserve_fill, T); \
+	VECTOR_BENCHMARK(BM_insert_middle, T); \
+	VECTOR_BENCHMARK(BM_iterate, T); \
+	VECTOR_BENCHMARK(BM_copy, T); \
+	VECTOR_BENCHMARK(BM_move, T)
+
+VECTOR_BENCHMARKS(int);
+VECTOR_BENCHMARKS(pod64);
+VECTOR_BENCHMARKS(std::string);
+
+BENCHMARK_MAIN();
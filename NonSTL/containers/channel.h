@@ -0,0 +1,684 @@
+// channel.h
+// A non-stl header only implementation of a bounded channel between C++20 coroutines
+// on top of the lock-free mpmc_ring or spsc_circular_buffer.
+// Note, the standard is used for some components such as std::coroutine_handle and std::mutex
+// Note, this component requires C++20 coroutines
+
+/*
+ * A channel passes elements between coroutines through a lock-free ring. co_await ch.send(v) and
+ * co_await ch.recv() complete without suspending whenever the ring has room or an element, which only
+ * costs the ring operation and a fence. Otherwise the coroutine registers itself as a waiter and
+ * suspends instead of spinning or blocking its thread. The side making progress later hands the
+ * element over to the first waiter and resumes it, so a waiting receiver gets the element pushed for it
+ * and a waiting sender gets its element pushed.
+ * Waiters are kept in lists guarded by a mutex which the fast path only takes when the waiter count is
+ * non zero, it is never held while a coroutine runs.
+ * Woken coroutines are resumed on the executor given at construction, any object with a
+ * post(std::coroutine_handle<>) member, or inline on the thread which woke them by default.
+ * close() fails every later send and wakes every waiter: receivers still get the elements left in the
+ * ring and then std::nullopt, senders still waiting for room resume with false.
+ * spsc_channel uses spsc_circular_buffer, at most one coroutine may send and one receive at a time.
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine)
+
+// Includes
+#include <atomic>			// std::atomic, std::atomic_thread_fence
+#include <coroutine>		// std::coroutine_handle
+#include <initializer_list>	// std::initializer_list
+#include <mutex>			// std::mutex, std::lock_guard
+#include <optional>			// std::optional, std::nullopt
+#include <type_traits>		// std::is_nothrow_move_constructible, std::is_nothrow_move_assignable
+#include <utility>			// std::move
+
+#include "mpmc_ring.h"				// non_stl::mpmc_ring
+#include "spsc_circular_buffer.h"	// non_stl::spsc_circular_buffer
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Resumes the coroutines woken by a channel
+	// Refers to an executor with a post(std::coroutine_handle<>) member, which must outlive the channel
+	class executor_ref
+	{
+	public:
+		// Resumes inline, on the thread waking the coroutine
+		executor_ref() noexcept : _post(nullptr), _executor(nullptr) {}
+
+		template <class Executor>
+			requires requires(Executor& ex, std::coroutine_handle<> h) { ex.post(h); }
+		executor_ref(Executor& ex) noexcept :
+			_post([](void* executor, std::coroutine_handle<> h) { static_cast<Executor*>(executor)->post(h); }),
+			_executor(&ex)
+		{
+		}
+
+		// Resumes h, or posts it to the executor
+		void resume(std::coroutine_handle<> h) const
+		{
+			if (_post) {
+				_post(_executor, h);
+			}
+			else {
+				h.resume();
+			}
+		}
+
+	private:
+		void (*_post)(void* executor, std::coroutine_handle<> h);
+		void* _executor;
+	};
+
+	// Template parameter T is the generic object being passed, which has to be nothrow movable
+	// size_type N is the amount of elements the ring can hold before senders wait
+	// Template parameter Ring is the lock-free ring holding the elements
+	template <class T, size_type N, class Ring = mpmc_ring<T, N> >
+	class channel
+	{
+		static_assert(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+			"channel requires a nothrow movable type");
+
+		// A suspended coroutine, kept in the awaiter living in its frame
+		struct waiter
+		{
+			waiter* next = nullptr;
+			std::coroutine_handle<> handle;
+
+			// Receivers: where the element goes. Senders: the element to push
+			T* item = nullptr;
+
+			// Whether the element was handed over
+			bool done = false;
+		};
+
+		// First in first out list of waiters
+		struct waiter_list
+		{
+			waiter* head = nullptr;
+			waiter* tail = nullptr;
+
+			void push(waiter* w) noexcept;
+			waiter* pop() noexcept;
+			bool remove(waiter* w) noexcept;
+		};
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		class send_awaiter;
+		class recv_awaiter;
+		class recv_n_awaiter;
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Constructs an empty channel resuming woken coroutines on executor
+		explicit channel(executor_ref executor = executor_ref()) noexcept;
+
+		// The channel is shared by reference and is neither copyable nor movable
+		channel(const channel&) = delete;
+		channel& operator=(const channel&) = delete;
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+
+		// Destroys the elements still in the ring
+		// No coroutine may be waiting on the channel
+		~channel() = default;
+
+		// ---------------
+		// PRODUCERS
+		// ---------------
+
+		// co_await send(val) adds val to the channel, suspending while the ring is full
+		// Resumes with false, val not being sent, if the channel is closed
+		send_awaiter send(const T& val);
+		send_awaiter send(T&& val) noexcept;
+
+		// Adds val to the channel without waiting
+		// Returns false, leaving val untouched, if the ring is full or the channel is closed
+		bool try_send(const T& val);
+		bool try_send(T&& val) noexcept;
+
+		// ---------------
+		// CONSUMERS
+		// ---------------
+
+		// co_await recv() removes the oldest element, suspending while the ring is empty
+		// Resumes with std::nullopt once the channel is closed and empty
+		// T must be default constructible, the element is moved into a T of the awaiter
+		recv_awaiter recv() noexcept;
+
+		// co_await recv_n(out, n) moves up to n elements into out, in order, suspending while the ring is empty
+		// Resumes with the amount of elements moved, 0 once the channel is closed and empty
+		recv_n_awaiter recv_n(T* out, size_type n) noexcept;
+
+		// Moves the oldest element into out without waiting
+		// Returns false, leaving out untouched, if the ring is empty
+		bool try_recv(T& out) noexcept;
+
+		// Moves up to n elements into out, in order, without waiting
+		// Returns the amount of elements moved
+		size_type try_recv_n(T* out, size_type n) noexcept;
+
+		// ---------------
+		// CLOSE
+		// ---------------
+
+		// Fails every later send and wakes every waiter
+		// Receivers keep getting the elements left in the ring
+		void close();
+
+		// Returns whether close() was called
+		bool closed() const noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of elements in the ring, a snapshot while other threads are active
+		size_type size() const noexcept;
+
+		// Returns whether the ring is empty, with the same caveat as size()
+		bool empty() const noexcept;
+
+		// Returns the maximum number of elements the ring can hold
+		static constexpr size_type capacity() noexcept;
+
+		// ---------------
+		// AWAITERS
+		// ---------------
+
+		// Returned by send(), recv() and recv_n() to be co_awaited straight away
+		// A suspended coroutine's waiter lives in its awaiter, so they are neither copyable nor movable
+		class send_awaiter
+		{
+		public:
+			send_awaiter(const send_awaiter&) = delete;
+			send_awaiter& operator=(const send_awaiter&) = delete;
+
+			bool await_ready() noexcept;
+			bool await_suspend(std::coroutine_handle<> h);
+			bool await_resume() noexcept;
+
+		private:
+			friend class channel;
+			send_awaiter(channel& ch, T&& val) noexcept;
+
+			channel* _channel;
+			T _value;
+			waiter _waiter;
+		};
+
+		class recv_awaiter
+		{
+		public:
+			recv_awaiter(const recv_awaiter&) = delete;
+			recv_awaiter& operator=(const recv_awaiter&) = delete;
+
+			bool await_ready() noexcept;
+			bool await_suspend(std::coroutine_handle<> h);
+			std::optional<T> await_resume() noexcept;
+
+		private:
+			friend class channel;
+			explicit recv_awaiter(channel& ch) noexcept;
+
+			channel* _channel;
+			T _value;
+			waiter _waiter;
+		};
+
+		class recv_n_awaiter
+		{
+		public:
+			recv_n_awaiter(const recv_n_awaiter&) = delete;
+			recv_n_awaiter& operator=(const recv_n_awaiter&) = delete;
+
+			bool await_ready() noexcept;
+			bool await_suspend(std::coroutine_handle<> h);
+			size_type await_resume() noexcept;
+
+		private:
+			friend class channel;
+			recv_n_awaiter(channel& ch, T* out, size_type n) noexcept;
+
+			channel* _channel;
+			T* _out;
+			size_type _n;
+			size_type _count;
+			waiter _waiter;
+		};
+
+		// ---------------
+		// END INTERFACE
+		// ---------------
+	private:
+		// Moves up to n elements from the ring into out
+		size_type pop_some(T* out, size_type n) noexcept;
+
+		// Called after a successful ring operation, hands elements to the waiters if there are any
+		void notify();
+
+		// Registers w on list, then suspends unless w is completed straight away or the channel is closed
+		// Returns whether the coroutine stays suspended
+		bool suspend(waiter& w, waiter_list& list);
+
+		// Hands elements between the ring and the waiters until neither can progress
+		// The mutex must be held. Returns the chain of completed waiters, linked by next
+		waiter* transfer_locked() noexcept;
+
+		// Resumes every waiter of chain
+		void resume(waiter* chain);
+
+		Ring _ring;
+		executor_ref _executor;
+
+		// Waiters of both lists, read without the mutex by notify()
+		std::atomic<size_type> _waiting;
+		std::atomic<bool> _closed;
+
+		std::mutex _mutex;
+		waiter_list _receivers;
+		waiter_list _senders;
+	};
+
+	// A channel between one sending and one receiving coroutine at a time
+	template <class T, size_type N>
+	using spsc_channel = channel<T, N, spsc_circular_buffer<T, N> >;
+
+	// CHANNEL IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, size_type N, class Ring>
+	channel<T, N, Ring>::channel(executor_ref executor) noexcept
+		: _ring()
+		, _executor(executor)
+		, _waiting(0)
+		, _closed(false)
+	{
+	}
+
+	// ---------------
+	// PRODUCERS
+	// ---------------
+	template <class T, size_type N, class Ring>
+	typename channel<T, N, Ring>::send_awaiter channel<T, N, Ring>::send(const T& val)
+	{
+		return send_awaiter(*this, T(val));
+	}
+
+	template <class T, size_type N, class Ring>
+	typename channel<T, N, Ring>::send_awaiter channel<T, N, Ring>::send(T&& val) noexcept
+	{
+		return send_awaiter(*this, std::move(val));
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::try_send(const T& val)
+	{
+		T copy(val);
+		return try_send(std::move(copy));
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::try_send(T&& val) noexcept
+	{
+		if (_closed.load(std::memory_order_acquire) || !_ring.try_push(std::move(val))) {
+			return false;
+		}
+		notify();
+		return true;
+	}
+
+	// ---------------
+	// CONSUMERS
+	// ---------------
+	template <class T, size_type N, class Ring>
+	typename channel<T, N, Ring>::recv_awaiter channel<T, N, Ring>::recv() noexcept
+	{
+		return recv_awaiter(*this);
+	}
+
+	template <class T, size_type N, class Ring>
+	typename channel<T, N, Ring>::recv_n_awaiter channel<T, N, Ring>::recv_n(T* out, size_type n) noexcept
+	{
+		return recv_n_awaiter(*this, out, n);
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::try_recv(T& out) noexcept
+	{
+		return try_recv_n(&out, 1) == 1;
+	}
+
+	template <class T, size_type N, class Ring>
+	size_type channel<T, N, Ring>::try_recv_n(T* out, size_type n) noexcept
+	{
+		const size_type count = pop_some(out, n);
+		if (count != 0) {
+			notify();
+		}
+		return count;
+	}
+
+	// ---------------
+	// CLOSE
+	// ---------------
+	template <class T, size_type N, class Ring>
+	void channel<T, N, Ring>::close()
+	{
+		_closed.store(true, std::memory_order_release);
+
+		waiter* chain;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			chain = transfer_locked();
+
+			// Whoever is left can't progress anymore, all of them resume without their element
+			for (waiter_list* list : { &_receivers, &_senders }) {
+				while (waiter* w = list->pop()) {
+					w->next = chain;
+					chain = w;
+					_waiting.fetch_sub(1, std::memory_order_relaxed);
+				}
+			}
+		}
+		resume(chain);
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::closed() const noexcept
+	{
+		return _closed.load(std::memory_order_acquire);
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, size_type N, class Ring>
+	size_type channel<T, N, Ring>::size() const noexcept
+	{
+		return _ring.size();
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::empty() const noexcept
+	{
+		return _ring.empty();
+	}
+
+	template <class T, size_type N, class Ring>
+	constexpr size_type channel<T, N, Ring>::capacity() noexcept
+	{
+		return N;
+	}
+
+	// ---------------
+	// AWAITERS
+	// ---------------
+	template <class T, size_type N, class Ring>
+	channel<T, N, Ring>::send_awaiter::send_awaiter(channel& ch, T&& val) noexcept
+		: _channel(&ch)
+		, _value(std::move(val))
+		, _waiter()
+	{
+		_waiter.item = &_value;
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::send_awaiter::await_ready() noexcept
+	{
+		// A closed channel completes straight away, with done left false
+		_waiter.done = _channel->try_send(std::move(_value));
+		return _waiter.done || _channel->closed();
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::send_awaiter::await_suspend(std::coroutine_handle<> h)
+	{
+		_waiter.handle = h;
+		return _channel->suspend(_waiter, _channel->_senders);
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::send_awaiter::await_resume() noexcept
+	{
+		return _waiter.done;
+	}
+
+	template <class T, size_type N, class Ring>
+	channel<T, N, Ring>::recv_awaiter::recv_awaiter(channel& ch) noexcept
+		: _channel(&ch)
+		, _value()
+		, _waiter()
+	{
+		_waiter.item = &_value;
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::recv_awaiter::await_ready() noexcept
+	{
+		// The elements left in a closed channel are received first
+		_waiter.done = _channel->try_recv(_value);
+		return _waiter.done || (_channel->closed() && _channel->empty());
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::recv_awaiter::await_suspend(std::coroutine_handle<> h)
+	{
+		_waiter.handle = h;
+		return _channel->suspend(_waiter, _channel->_receivers);
+	}
+
+	template <class T, size_type N, class Ring>
+	std::optional<T> channel<T, N, Ring>::recv_awaiter::await_resume() noexcept
+	{
+		if (!_waiter.done) {
+			return std::nullopt;
+		}
+		return std::optional<T>(std::move(_value));
+	}
+
+	template <class T, size_type N, class Ring>
+	channel<T, N, Ring>::recv_n_awaiter::recv_n_awaiter(channel& ch, T* out, size_type n) noexcept
+		: _channel(&ch)
+		, _out(out)
+		, _n(n)
+		, _count(0)
+		, _waiter()
+	{
+		_waiter.item = out;
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::recv_n_awaiter::await_ready() noexcept
+	{
+		_count = _channel->try_recv_n(_out, _n);
+		return _count != 0 || _n == 0 || (_channel->closed() && _channel->empty());
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::recv_n_awaiter::await_suspend(std::coroutine_handle<> h)
+	{
+		_waiter.handle = h;
+		return _channel->suspend(_waiter, _channel->_receivers);
+	}
+
+	template <class T, size_type N, class Ring>
+	size_type channel<T, N, Ring>::recv_n_awaiter::await_resume() noexcept
+	{
+		// Woken with the first element, drain what else is there in one go
+		if (_count == 0 && _waiter.done) {
+			_count = 1 + _channel->try_recv_n(_out + 1, _n - 1);
+		}
+		return _count;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T, size_type N, class Ring>
+	size_type channel<T, N, Ring>::pop_some(T* out, size_type n) noexcept
+	{
+		if constexpr (requires(Ring& ring) { ring.try_pop_n(out, n); }) {
+			return _ring.try_pop_n(out, n);
+		}
+		else {
+			size_type count = 0;
+			while (count < n && _ring.try_pop(out[count])) {
+				++count;
+			}
+			return count;
+		}
+	}
+
+	template <class T, size_type N, class Ring>
+	void channel<T, N, Ring>::notify()
+	{
+		// Pairs with the fence in suspend(): either the waiter sees the ring operation
+		// when it retries, or this sees the waiter
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (_waiting.load(std::memory_order_relaxed) == 0) {
+			return;
+		}
+
+		waiter* chain;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			chain = transfer_locked();
+		}
+		resume(chain);
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::suspend(waiter& w, waiter_list& list)
+	{
+		waiter* chain;
+		bool suspended = true;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			// A send which didn't get through before close() fails
+			if (&list == &_senders && _closed.load(std::memory_order_relaxed)) {
+				return false;
+			}
+
+			list.push(&w);
+			_waiting.fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			// Retry now that notify() can't miss w, this may complete w or any other waiter
+			chain = transfer_locked();
+			for (waiter** link = &chain; *link; link = &(*link)->next) {
+				if (*link == &w) {
+					*link = w.next;
+					suspended = false;
+					break;
+				}
+			}
+
+			// Nobody would wake w anymore, for receivers only once the ring is empty as well
+			if (suspended && _closed.load(std::memory_order_relaxed)) {
+				list.remove(&w);
+				_waiting.fetch_sub(1, std::memory_order_relaxed);
+				suspended = false;
+			}
+		}
+
+		// w may already be resumed by another thread once the mutex is released, it is not touched anymore
+		resume(chain);
+		return suspended;
+	}
+
+	template <class T, size_type N, class Ring>
+	typename channel<T, N, Ring>::waiter* channel<T, N, Ring>::transfer_locked() noexcept
+	{
+		waiter* chain = nullptr;
+		waiter** chain_tail = &chain;
+		const auto complete = [&](waiter_list& list) {
+			waiter* w = list.pop();
+			w->done = true;
+			w->next = nullptr;
+			*chain_tail = w;
+			chain_tail = &w->next;
+			_waiting.fetch_sub(1, std::memory_order_relaxed);
+		};
+
+		for (bool progress = true; progress;) {
+			progress = false;
+			if (_receivers.head && _ring.try_pop(*_receivers.head->item)) {
+				complete(_receivers);
+				progress = true;
+			}
+			if (_senders.head && _ring.try_push(std::move(*_senders.head->item))) {
+				complete(_senders);
+				progress = true;
+			}
+		}
+		return chain;
+	}
+
+	template <class T, size_type N, class Ring>
+	void channel<T, N, Ring>::resume(waiter* chain)
+	{
+		while (chain) {
+			// The awaiter holding the waiter may be gone as soon as its coroutine resumes
+			waiter* next = chain->next;
+			_executor.resume(chain->handle);
+			chain = next;
+		}
+	}
+
+	template <class T, size_type N, class Ring>
+	void channel<T, N, Ring>::waiter_list::push(waiter* w) noexcept
+	{
+		w->next = nullptr;
+		if (tail) {
+			tail->next = w;
+		}
+		else {
+			head = w;
+		}
+		tail = w;
+	}
+
+	template <class T, size_type N, class Ring>
+	typename channel<T, N, Ring>::waiter* channel<T, N, Ring>::waiter_list::pop() noexcept
+	{
+		waiter* w = head;
+		if (w) {
+			head = w->next;
+			if (!head) {
+				tail = nullptr;
+			}
+		}
+		return w;
+	}
+
+	template <class T, size_type N, class Ring>
+	bool channel<T, N, Ring>::waiter_list::remove(waiter* w) noexcept
+	{
+		waiter* prev = nullptr;
+		for (waiter* it = head; it; prev = it, it = it->next) {
+			if (it == w) {
+				(prev ? prev->next : head) = w->next;
+				if (tail == w) {
+					tail = prev;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+#endif
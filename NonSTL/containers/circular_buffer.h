@@ -1,26 +1,163 @@
 // circular_buffer.h
 // A non-stl header only implementation of a circular buffer data structure which attempts to adhere to
 // standard practices.
-// Note, the standard is used for some components such as std::array and std::move
+// Note, the standard is used for some components such as std::move
 
 /*
  * A circular buffer is a container of fixed size which uses a block of memory allocated at construction.
  * When the buffer fills new data is written over the oldest data in the buffer.
- * This container throws no exceptions.
+ * The memory is inline and left uninitialized, elements are constructed in place when pushed and
+ * destroyed when popped, overwritten or when the buffer is destroyed. T need not be default constructible.
+ * When N is a power of two the head and tail are free running counters which are masked on access,
+ * so no access divides and pushing or popping never branches on wraparound.
+ * This container throws no exceptions besides at().
+ * With NON_STL_DEBUG operator[] is bounds checked and iterators check that the element they refer to
+ * hasn't been overwritten or popped since they were obtained, see debug.h.
  */
 
 #pragma once
 
 // Includes
-#include <array>			// std::array
-#include <iterator>			// std::random_access_iterator_tag
-#include <type_traits>		// std::conditional_t
+#include <algorithm>		// std::copy_n, std::min
+#include <cstdint>			// std::uint64_t
+#include <iterator>			// std::random_access_iterator_tag, std::make_move_iterator
+#include <new>				// placement new
+#include <stdexcept>		// std::out_of_range
+#include <type_traits>		// std::conditional_t, std::is_trivially_copyable, std::is_trivially_destructible
 #include <utility>			// std::forward, std::move
 
+#include "debug.h"			// NON_STL_DEBUG_CHECK
+#include "span.h"			// non_stl::span
+
 using size_type = size_t;
 
 namespace non_stl
 {
+	// Head and tail bookkeeping of a circular_buffer of size N, selected at compile time
+	// The primary template keeps wrapped indices and an element count and is used for any N
+	template <size_type N, bool isPowerOfTwo = (N & (N - 1)) == 0>
+	struct circular_index
+	{
+		// Index which represents the oldest data to be overwritten
+		size_type head = 0;
+
+		// Index which represents the newest data
+		size_type tail = N - 1;
+
+		// Amount of elements written into the buffer
+		size_type count = 0;
+
+		// Maps a head or tail relative position onto an index into the storage
+		// Positions are always less than 2 * N
+		static constexpr size_type wrap(size_type n) noexcept { return n % N; }
+
+		constexpr size_type head_index() const noexcept { return head; }
+		constexpr size_type tail_index() const noexcept { return tail; }
+		constexpr size_type size() const noexcept { return count; }
+
+		// Appends an element, dropping the oldest one when the buffer is full
+		void push() noexcept
+		{
+			increment_tail();
+			if (count > N) {
+				increment_head();
+			}
+		}
+
+		// Removes the oldest element, if any
+		void increment_head() noexcept
+		{
+			// Only do this on non-empty buffers
+			if (count != 0) {
+				++head;
+				--count;
+				if (head == N) {
+					head = 0;
+				}
+			}
+		}
+
+		void increment_tail() noexcept
+		{
+			++tail;
+			++count;
+			if (tail == N) {
+				tail = 0;
+			}
+		}
+
+		// Appends n elements, dropping the oldest ones past N. Assumed n <= N
+		void push_n(size_type n) noexcept
+		{
+			tail = wrap(tail + n);
+			count += n;
+			if (count > N) {
+				head = wrap(head + count - N);
+				count = N;
+			}
+		}
+
+		// Removes the n oldest elements. Assumed n <= size()
+		void pop_n(size_type n) noexcept
+		{
+			head = wrap(head + n);
+			count -= n;
+		}
+	};
+
+	// Power of two N, head and tail run freely and are masked on access
+	// Unsigned overflow keeps them consistent since N divides the range of size_type
+	template <size_type N>
+	struct circular_index<N, true>
+	{
+		static constexpr size_type MASK = N - 1;
+
+		// Position of the oldest data
+		size_type head = 0;
+
+		// Position of the newest data, one before head while empty
+		size_type tail = static_cast<size_type>(-1);
+
+		static constexpr size_type wrap(size_type n) noexcept { return n & MASK; }
+
+		constexpr size_type head_index() const noexcept { return head & MASK; }
+		constexpr size_type tail_index() const noexcept { return tail & MASK; }
+		constexpr size_type size() const noexcept { return tail + 1 - head; }
+
+		// Appends an element, dropping the oldest one when the buffer is full
+		void push() noexcept
+		{
+			++tail;
+			head += size() > N;
+		}
+
+		// Removes the oldest element, if any
+		void increment_head() noexcept
+		{
+			head += size() != 0;
+		}
+
+		void increment_tail() noexcept
+		{
+			++tail;
+		}
+
+		// Appends n elements, dropping the oldest ones past N. Assumed n <= N
+		void push_n(size_type n) noexcept
+		{
+			tail += n;
+			if (size() > N) {
+				head = tail + 1 - N;
+			}
+		}
+
+		// Removes the n oldest elements. Assumed n <= size()
+		void pop_n(size_type n) noexcept
+		{
+			head += n;
+		}
+	};
+
 	// Template parameter T is the generic object being stored within the container
 	// size_type N is the size of the container which cannot be changed
 	template <class T, size_type N>
@@ -28,21 +165,26 @@ namespace non_stl
 	{
 	private:
 		static constexpr size_type BUFFER_SIZE = N;
-		using container = std::array<T, BUFFER_SIZE>;
+		using index = circular_index<BUFFER_SIZE>;
 
-		// Container which holds the buffer data
-		container d_container;
+		// Uninitialized storage which holds the buffer data
+		// Only the size() slots starting at the head hold constructed elements
+		alignas(T) unsigned char d_storage[BUFFER_SIZE * sizeof(T)];
 
-		// Index which represents the oldest data to be overwritten
-		size_type d_head;
+		// Head, tail and size of the buffer
+		index d_index;
 
-		// Index which represents the newest data
-		size_type d_tail;
-
-		// Amount of elements written into the buffer
-		size_type d_size;
+#if defined(NON_STL_DEBUG)
+		// Amount of elements which ever left the front of the buffer, by being popped or overwritten
+		// An element's position in the sequence of every element pushed is d_removed plus its index
+		std::uint64_t d_removed = 0;
+#endif
 
 	public:
+		// Whether N is a power of two and indexing masks instead of dividing
+		// e.g. static_assert(circular_buffer<T, 4096>::is_power_of_two) to guard against a resize
+		static constexpr bool is_power_of_two = (N & (N - 1)) == 0;
+
 		// ---------------
 		// CONSTRUCTORS
 		// ---------------
@@ -54,6 +196,7 @@ namespace non_stl
 		circular_buffer(const circular_buffer& other) noexcept;
 
 		// Move constructor
+		// Each element of other is moved, other keeps its size with moved from elements
 		circular_buffer(circular_buffer&& other) noexcept;
 		
 		// ---------------
@@ -65,7 +208,8 @@ namespace non_stl
 		// ---------------
 		// DESTRUCTOR
 		// ---------------
-		~circular_buffer() = default;
+		// Destroys every element in the buffer
+		~circular_buffer();
 		
 		// ---------------
 		// ELEMENT ACCESS
@@ -77,9 +221,9 @@ namespace non_stl
 		const T& operator[](size_type n) const noexcept;
 
 		// Returns a reference to the element at position n in the buffer
-		// Operationally same as operator[]
-		T& at(size_type n) noexcept;
-		const T& at(size_type n) const noexcept;
+		// Function throws an out of range exception if the input is not within range
+		T& at(size_type n);
+		const T& at(size_type n) const;
 		
 		// Returns a reference to the first element in the buffer
 		T& front() noexcept;
@@ -88,6 +232,22 @@ namespace non_stl
 		// Returns a reference to the last element in the buffer
 		T& back() noexcept;
 		const T& back() const noexcept;
+
+		// The elements are stored in at most two contiguous runs of the underlying array
+		// array_one() is the run starting at front(), array_two() is the wrapped around remainder
+		// which is empty unless the elements wrap past the end of the array
+		// Together they hold size() elements in order, e.g. for scatter / gather I/O
+		span<T> array_one() noexcept;
+		span<const T> array_one() const noexcept;
+		span<T> array_two() noexcept;
+		span<const T> array_two() const noexcept;
+
+		// The unused slots are the other at most two runs, starting after back()
+		// free_one() is the run up to the end of the array, free_two() the wrapped around remainder
+		// Together they hold capacity() - size() slots, to be written in place, e.g. by readv,
+		// and then appended with commit_back()
+		span<T> free_one() noexcept;
+		span<T> free_two() noexcept;
 		
 		// ---------------
 		// ITERATORS
@@ -123,12 +283,24 @@ namespace non_stl
 			using iterator_category = std::random_access_iterator_tag;
 			using reference = typename std::conditional_t< isconst, T const&, T& >;
 			using pointer = typename std::conditional_t< isconst, T const*, T* >;
-			using vec_pointer = typename std::conditional_t<isconst, std::array<T,N> const*, std::array<T,N>*>;
+			using buffer_pointer = typename std::conditional_t<isconst, T const*, T*>;
 		private:
-			vec_pointer ptrToBuffer;
+			buffer_pointer ptrToBuffer;
 			size_type	offset;
 			size_type	index;
 			bool		reverse;
+#if defined(NON_STL_DEBUG)
+			// Buffer the iterator came from and the position of the element at index 0
+			// in the sequence of every element pushed, see d_removed
+			const circular_buffer* owner = nullptr;
+			std::uint64_t first = 0;
+
+			void check() const {
+				const std::uint64_t pos = reverse ? first - index : first + index;
+				NON_STL_DEBUG_CHECK(owner != nullptr && owner->d_removed <= pos && pos < owner->d_removed + owner->size(),
+					"circular_buffer iterator refers to an overwritten or removed element");
+			}
+#endif
 
 			bool comparable(const myIterator& other) {
 				return (reverse == other.reverse);
@@ -140,11 +312,19 @@ namespace non_stl
 				ptrToBuffer(i.ptrToBuffer),
 				offset(i.offset),
 				index(i.index),
-				reverse(i.reverse) {}
+				reverse(i.reverse)
+#if defined(NON_STL_DEBUG)
+				, owner(i.owner)
+				, first(i.first)
+#endif
+			{}
 			reference operator*() {
+#if defined(NON_STL_DEBUG)
+				check();
+#endif
 				if (reverse)
-					return (*ptrToBuffer)[(ptrToBuffer->size() + offset - index) % (ptrToBuffer->size())];
-				return (*ptrToBuffer)[(offset + index) % (ptrToBuffer->size())];
+					return ptrToBuffer[circular_buffer::index::wrap(BUFFER_SIZE + offset - index)];
+				return ptrToBuffer[circular_buffer::index::wrap(offset + index)];
 			}
 			reference operator[](size_type index) {
 				myIterator iter = *this;
@@ -267,9 +447,49 @@ namespace non_stl
 		// Removes the first element in the buffer
 		void pop_front() noexcept;
 
+		// Removes every element from the buffer leaving it with a size of 0
+		void clear() noexcept;
+
+		// Adds n elements copied from src at the end of the buffer, as if by n calls to push_back
+		// Only the last N elements of src are kept if n > N
+		// Performs at most two copies, which are memmove for trivially copyable types
+		void push_back_n(const T* src, size_type n) noexcept;
+
+		// Moves up to n elements from the front of the buffer into dest and removes them
+		// Returns the amount of elements moved, which is less than n if the buffer holds fewer
+		size_type pop_front_into(T* dest, size_type n) noexcept;
+
+		// Appends the first n slots of free_one() followed by free_two(), once written in place
+		// Assumed n <= capacity() - size(). Only for trivially copyable types
+		void commit_back(size_type n) noexcept;
+
+		// Removes up to n elements from the front of the buffer without moving them anywhere
+		// Returns the amount of elements removed, which is less than n if the buffer holds fewer
+		size_type pop_front_n(size_type n) noexcept;
+
 	private:
-		void increment_head() noexcept;
-		void increment_tail() noexcept;
+		// Returns a pointer to the first slot of the storage
+		T* storage() noexcept;
+		const T* storage() const noexcept;
+
+		// Records that n elements left the front of the buffer, for the NON_STL_DEBUG iterator checks
+		void removed(size_type n) noexcept;
+
+		// Forgets the first n elements once they have been destroyed
+		// An emptied buffer starts over at the first slot so the free slots are a single run
+		void drop_front(size_type n) noexcept;
+
+		// Ties iter to the elements currently in the buffer under NON_STL_DEBUG
+		template <bool isConst>
+		void stamp(myIterator<isConst>& iter) const noexcept;
+
+		// Constructs a copy of every element of other in the same slot of this buffer
+		// Assumed that this buffer is empty
+		void copy_from(const circular_buffer& other) noexcept;
+
+		// Move constructs every element of other into the same slot of this buffer
+		// Assumed that this buffer is empty
+		void move_from(circular_buffer& other) noexcept;
 	};
 
 	// IMPL
@@ -279,32 +499,23 @@ namespace non_stl
 	// ---------------
 	template <class T, size_type N>
 	circular_buffer<T, N>::circular_buffer() noexcept 
-		: d_container()
-		, d_head(0)
-		, d_tail(BUFFER_SIZE - 1)
-		, d_size(0)
+		: d_index()
 	{
 
 	}
 
 	template <class T, size_type N>
 	circular_buffer<T, N>::circular_buffer(const circular_buffer& other) noexcept
-		: d_container(other.d_container)
-		, d_head(other.d_head)
-		, d_tail(other.d_tail)
-		, d_size(other.d_size)
+		: d_index()
 	{
-
+		copy_from(other);
 	}
 
 	template <class T, size_type N>
 	circular_buffer<T, N>::circular_buffer(circular_buffer&& other) noexcept
-		: d_container(std::move(other.d_container))
-		, d_head(other.d_head)
-		, d_tail(other.d_tail)
-		, d_size(other.d_size)
+		: d_index()
 	{
-
+		move_from(other);
 	}
 
 	// ---------------
@@ -314,11 +525,10 @@ namespace non_stl
 	template <class T, size_type N>
 	circular_buffer<T, N>& circular_buffer<T, N>::operator=(const circular_buffer<T, N>& rhs) noexcept
 	{
-		// Assign member variables
-		d_container = rhs.d_container;
-		d_head = rhs.d_head;
-		d_tail = rhs.d_tail;
-		d_size = rhs.d_size;
+		if (this != &rhs) {
+			clear();
+			copy_from(rhs);
+		}
 
 		return *this;
 	}
@@ -326,15 +536,23 @@ namespace non_stl
 	template <class T, size_type N>
 	circular_buffer<T, N>& circular_buffer<T, N>::operator=(circular_buffer<T, N>&& rhs) noexcept
 	{
-		// Assign member variables
-		d_container = std::move(rhs.d_container);
-		d_head = rhs.d_head;
-		d_tail = rhs.d_tail;
-		d_size = rhs.d_size;
+		if (this != &rhs) {
+			clear();
+			move_from(rhs);
+		}
 
 		return *this;
 	}
 
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class T, size_type N>
+	circular_buffer<T, N>::~circular_buffer()
+	{
+		clear();
+	}
+
 	// ---------------
 	// ELEMENT ACCESS
 	// ---------------
@@ -342,53 +560,100 @@ namespace non_stl
 	template <class T, size_type N>
 	T& circular_buffer<T, N>::operator[](size_type n) noexcept
 	{
-		n += d_head;
-		n %= BUFFER_SIZE;
-		return d_container[n];
+		NON_STL_DEBUG_CHECK(n < d_index.size(), "circular_buffer::operator[] - index out of range");
+		return storage()[index::wrap(d_index.head + n)];
 	}
 
 	template <class T, size_type N>
 	const T& circular_buffer<T, N>::operator[](size_type n) const noexcept
 	{
-		n += d_head;
-		n %= BUFFER_SIZE;
-		return d_container[n];
+		NON_STL_DEBUG_CHECK(n < d_index.size(), "circular_buffer::operator[] - index out of range");
+		return storage()[index::wrap(d_index.head + n)];
 	}
 
 	template <class T, size_type N>
-	T& circular_buffer<T, N>::at(size_type n) noexcept
+	T& circular_buffer<T, N>::at(size_type n)
 	{
+		if (n >= d_index.size()) {
+			throw std::out_of_range("circular_buffer::at - index out of range");
+		}
 		return this->operator[](n);
 	}
 
 	template <class T, size_type N>
-	const T& circular_buffer<T, N>::at(size_type n) const noexcept
+	const T& circular_buffer<T, N>::at(size_type n) const
 	{
+		if (n >= d_index.size()) {
+			throw std::out_of_range("circular_buffer::at - index out of range");
+		}
 		return this->operator[](n);
 	}
 
 	template <class T, size_type N>
 	T& circular_buffer<T, N>::front() noexcept
 	{
-		return d_container[d_head];
+		NON_STL_DEBUG_CHECK(d_index.size() != 0, "circular_buffer::front - buffer is empty");
+		return storage()[d_index.head_index()];
 	}
 
 	template <class T, size_type N>
 	const T& circular_buffer<T, N>::front() const noexcept
 	{
-		return d_container[d_head];
+		NON_STL_DEBUG_CHECK(d_index.size() != 0, "circular_buffer::front - buffer is empty");
+		return storage()[d_index.head_index()];
 	}
 
 	template <class T, size_type N>
 	T& circular_buffer<T, N>::back() noexcept
 	{
-		return d_container[d_tail];
+		NON_STL_DEBUG_CHECK(d_index.size() != 0, "circular_buffer::back - buffer is empty");
+		return storage()[d_index.tail_index()];
 	}
 
 	template <class T, size_type N>
 	const T& circular_buffer<T, N>::back() const noexcept
 	{
-		return d_container[d_tail];
+		NON_STL_DEBUG_CHECK(d_index.size() != 0, "circular_buffer::back - buffer is empty");
+		return storage()[d_index.tail_index()];
+	}
+
+	template <class T, size_type N>
+	span<T> circular_buffer<T, N>::array_one() noexcept
+	{
+		const size_type head = d_index.head_index();
+		return span<T>(storage() + head, std::min(d_index.size(), BUFFER_SIZE - head));
+	}
+
+	template <class T, size_type N>
+	span<const T> circular_buffer<T, N>::array_one() const noexcept
+	{
+		const size_type head = d_index.head_index();
+		return span<const T>(storage() + head, std::min(d_index.size(), BUFFER_SIZE - head));
+	}
+
+	template <class T, size_type N>
+	span<T> circular_buffer<T, N>::array_two() noexcept
+	{
+		return span<T>(storage(), d_index.size() - array_one().size());
+	}
+
+	template <class T, size_type N>
+	span<const T> circular_buffer<T, N>::array_two() const noexcept
+	{
+		return span<const T>(storage(), d_index.size() - array_one().size());
+	}
+
+	template <class T, size_type N>
+	span<T> circular_buffer<T, N>::free_one() noexcept
+	{
+		const size_type start = index::wrap(d_index.tail + 1);
+		return span<T>(storage() + start, std::min(BUFFER_SIZE - d_index.size(), BUFFER_SIZE - start));
+	}
+
+	template <class T, size_type N>
+	span<T> circular_buffer<T, N>::free_two() noexcept
+	{
+		return span<T>(storage(), BUFFER_SIZE - d_index.size() - free_one().size());
 	}
 
 	// ---------------
@@ -399,10 +664,11 @@ namespace non_stl
 	typename circular_buffer<T, N>::iterator circular_buffer<T, N>::begin() noexcept
 	{
 		iterator iter;
-		iter.ptrToBuffer = &d_container;
-		iter.offset = d_head;
+		iter.ptrToBuffer = storage();
+		iter.offset = d_index.head;
 		iter.index = 0;
 		iter.reverse = false;
+		stamp(iter);
 		return iter;
 	}
 
@@ -410,10 +676,11 @@ namespace non_stl
 	typename circular_buffer<T, N>::const_iterator circular_buffer<T, N>::begin() const noexcept
 	{
 		const_iterator iter;
-		iter.ptrToBuffer = &d_container;
-		iter.offset = d_head;
+		iter.ptrToBuffer = storage();
+		iter.offset = d_index.head;
 		iter.index = 0;
 		iter.reverse = false;
+		stamp(iter);
 		return iter;
 	}
 
@@ -421,10 +688,11 @@ namespace non_stl
 	typename circular_buffer<T, N>::const_iterator circular_buffer<T, N>::cbegin() const noexcept
 	{
 		const_iterator iter;
-		iter.ptrToBuffer = &d_container;
-		iter.offset = d_head;
+		iter.ptrToBuffer = storage();
+		iter.offset = d_index.head;
 		iter.index = 0;
 		iter.reverse = false;
+		stamp(iter);
 		return iter;
 	}
 
@@ -432,10 +700,11 @@ namespace non_stl
 	typename circular_buffer<T, N>::iterator circular_buffer<T, N>::rbegin() noexcept
 	{
 		iterator iter;
-		iter.ptrToBuffer = &d_container;
-		iter.offset = d_tail;
+		iter.ptrToBuffer = storage();
+		iter.offset = d_index.tail;
 		iter.index = 0;
 		iter.reverse = true;
+		stamp(iter);
 		return iter;
 	}
 
@@ -443,10 +712,11 @@ namespace non_stl
 	typename circular_buffer<T, N>::const_iterator circular_buffer<T, N>::rbegin() const noexcept
 	{
 		const_iterator iter;
-		iter.ptrToBuffer = &d_container;
-		iter.offset = d_tail;
+		iter.ptrToBuffer = storage();
+		iter.offset = d_index.tail;
 		iter.index = 0;
 		iter.reverse = true;
+		stamp(iter);
 		return iter;
 	}
 
@@ -454,10 +724,11 @@ namespace non_stl
 	typename circular_buffer<T, N>::iterator circular_buffer<T, N>::end() noexcept
 	{
 		iterator iter;
-		iter.ptrToBuffer = &d_container;
-		iter.offset = d_head;
-		iter.index = d_size;
+		iter.ptrToBuffer = storage();
+		iter.offset = d_index.head;
+		iter.index = d_index.size();
 		iter.reverse = false;
+		stamp(iter);
 		return iter;
 	}
 
@@ -465,10 +736,11 @@ namespace non_stl
 	typename circular_buffer<T, N>::const_iterator circular_buffer<T, N>::end() const noexcept
 	{
 		const_iterator iter;
-		iter.ptrToBuffer = &d_container;
-		iter.offset = d_head;
-		iter.index = d_size;
+		iter.ptrToBuffer = storage();
+		iter.offset = d_index.head;
+		iter.index = d_index.size();
 		iter.reverse = false;
+		stamp(iter);
 		return iter;
 	}
 
@@ -476,10 +748,11 @@ namespace non_stl
 	typename circular_buffer<T, N>::const_iterator circular_buffer<T, N>::cend() const noexcept
 	{
 		const_iterator iter;
-		iter.ptrToBuffer = &d_container;
-		iter.offset = d_head;
-		iter.index = d_size;
+		iter.ptrToBuffer = storage();
+		iter.offset = d_index.head;
+		iter.index = d_index.size();
 		iter.reverse = false;
+		stamp(iter);
 		return iter;
 	}
 
@@ -487,10 +760,11 @@ namespace non_stl
 	typename circular_buffer<T, N>::iterator circular_buffer<T, N>::rend() noexcept
 	{
 		iterator iter;
-		iter.ptrToBuffer = &d_container;
-		iter.offset = d_tail;
-		iter.index = d_size;
+		iter.ptrToBuffer = storage();
+		iter.offset = d_index.tail;
+		iter.index = d_index.size();
 		iter.reverse = true;
+		stamp(iter);
 		return iter;
 	}
 
@@ -498,10 +772,11 @@ namespace non_stl
 	typename circular_buffer<T, N>::const_iterator circular_buffer<T, N>::rend() const noexcept
 	{
 		const_iterator iter;
-		iter.ptrToBuffer = &d_container;
-		iter.offset = d_tail;
-		iter.index = d_size;
+		iter.ptrToBuffer = storage();
+		iter.offset = d_index.tail;
+		iter.index = d_index.size();
 		iter.reverse = true;
+		stamp(iter);
 		return iter;
 	}
 
@@ -512,13 +787,13 @@ namespace non_stl
 	template <class T, size_type N>
 	size_type circular_buffer<T, N>::size() const noexcept
 	{
-		return d_size;
+		return d_index.size();
 	}
 
 	template <class T, size_type N>
 	bool circular_buffer<T, N>::empty() const noexcept
 	{
-		return d_size == 0;
+		return d_index.size() == 0;
 	}
 
 	template <class T, size_type N>
@@ -539,64 +814,214 @@ namespace non_stl
 	template <class T, size_type N>
 	void circular_buffer<T, N>::push_back(const T& val) noexcept 
 	{
-		increment_tail();
-		if (d_size > BUFFER_SIZE) {
-			increment_head();
+		if (d_index.size() == BUFFER_SIZE) {
+			// Overwrite the oldest element, assignment also copes with val being that element
+			removed(1);
+			d_index.push();
+			storage()[d_index.tail_index()] = val;
+			return;
 		}
-		d_container[d_tail] = val;
+
+		::new (static_cast<void*>(storage() + index::wrap(d_index.tail + 1))) T(val);
+		d_index.push();
 	}
 
 	template <class T, size_type N>
 	void circular_buffer<T, N>::push_back(T&& val) noexcept
 	{
-		increment_tail();
-		if (d_size > BUFFER_SIZE) {
-			increment_head();
+		if (d_index.size() == BUFFER_SIZE) {
+			// Overwrite the oldest element, assignment also copes with val being that element
+			removed(1);
+			d_index.push();
+			storage()[d_index.tail_index()] = std::move(val);
+			return;
 		}
-		d_container[d_tail] = std::forward<T>(val);
+
+		::new (static_cast<void*>(storage() + index::wrap(d_index.tail + 1))) T(std::move(val));
+		d_index.push();
 	}
 
 	template <class T, size_type N>
 	template <class... Args>
 	void circular_buffer<T, N>::emplace_back(Args&& ... args) noexcept
 	{
-		increment_tail();
-		if (d_size > BUFFER_SIZE) {
-			increment_head();
+		// A full buffer overwrites the oldest element, args may refer to it so the new element
+		// is built before the old one goes
+		if (d_index.size() == BUFFER_SIZE) {
+			T val(std::forward<Args>(args)...);
+			removed(1);
+			d_index.push();
+			storage()[d_index.tail_index()] = std::move(val);
+			return;
 		}
-		d_container[d_tail] = T(std::forward<Args>(args)...);
+
+		::new (static_cast<void*>(storage() + index::wrap(d_index.tail + 1))) T(std::forward<Args>(args)...);
+		d_index.push();
 	}
 
 	template <class T, size_type N>
 	void circular_buffer<T, N>::pop_front() noexcept
 	{
-		increment_head();
+		if (d_index.size() != 0) {
+			storage()[d_index.head_index()].~T();
+			removed(1);
+		}
+		d_index.increment_head();
+	}
+
+	template <class T, size_type N>
+	void circular_buffer<T, N>::clear() noexcept
+	{
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			for (size_type i = 0; i < d_index.size(); ++i) {
+				storage()[index::wrap(d_index.head + i)].~T();
+			}
+		}
+		removed(d_index.size());
+		d_index = index();
+	}
+
+	template <class T, size_type N>
+	void circular_buffer<T, N>::push_back_n(const T* src, size_type n) noexcept
+	{
+		// Anything before the last N elements would be overwritten anyway
+		if (n > BUFFER_SIZE) {
+			src += n - BUFFER_SIZE;
+			n = BUFFER_SIZE;
+		}
+		removed(n - std::min(n, BUFFER_SIZE - d_index.size()));
+
+		// Write up to the end of the array then wrap around to its start
+		const size_type start = index::wrap(d_index.tail + 1);
+		if constexpr (std::is_trivially_copyable<T>::value) {
+			const size_type first = std::min(n, BUFFER_SIZE - start);
+			std::copy_n(src, first, storage() + start);
+			std::copy_n(src + first, n - first, storage());
+		}
+		else {
+			// Free slots are filled first, after them the oldest elements are overwritten
+			const size_type free = BUFFER_SIZE - d_index.size();
+			for (size_type i = 0; i < n; ++i) {
+				T* slot = storage() + index::wrap(start + i);
+				if (i < free) {
+					::new (static_cast<void*>(slot)) T(src[i]);
+				}
+				else {
+					*slot = src[i];
+				}
+			}
+		}
+
+		d_index.push_n(n);
+	}
+
+	template <class T, size_type N>
+	size_type circular_buffer<T, N>::pop_front_into(T* dest, size_type n) noexcept
+	{
+		n = std::min(n, d_index.size());
+
+		// Read up to the end of the array then wrap around to its start
+		const size_type start = d_index.head_index();
+		const size_type first = std::min(n, BUFFER_SIZE - start);
+		std::copy_n(std::make_move_iterator(storage() + start), first, dest);
+		std::copy_n(std::make_move_iterator(storage()), n - first, dest + first);
+
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			for (size_type i = 0; i < n; ++i) {
+				storage()[index::wrap(start + i)].~T();
+			}
+		}
+
+		drop_front(n);
+		return n;
+	}
+
+	template <class T, size_type N>
+	void circular_buffer<T, N>::commit_back(size_type n) noexcept
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "commit_back requires a trivially copyable type");
+		d_index.push_n(n);
+	}
+
+	template <class T, size_type N>
+	size_type circular_buffer<T, N>::pop_front_n(size_type n) noexcept
+	{
+		n = std::min(n, d_index.size());
+
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			const size_type start = d_index.head_index();
+			for (size_type i = 0; i < n; ++i) {
+				storage()[index::wrap(start + i)].~T();
+			}
+		}
+
+		drop_front(n);
+		return n;
 	}
 
 	// ---------------
 	// PRIVATE
 	// ---------------
 	template <class T, size_type N>
-	void circular_buffer<T, N>::increment_head() noexcept
+	T* circular_buffer<T, N>::storage() noexcept
 	{
-		// Only do this on non-empty buffers
-		if (d_size != 0) {
-			++d_head;
-			--d_size;
-			if (d_head == BUFFER_SIZE) {
-				d_head = 0;
-			}
+		return reinterpret_cast<T*>(d_storage);
+	}
+
+	template <class T, size_type N>
+	const T* circular_buffer<T, N>::storage() const noexcept
+	{
+		return reinterpret_cast<const T*>(d_storage);
+	}
+
+	template <class T, size_type N>
+	void circular_buffer<T, N>::removed([[maybe_unused]] size_type n) noexcept
+	{
+#if defined(NON_STL_DEBUG)
+		d_removed += n;
+#endif
+	}
+
+	template <class T, size_type N>
+	void circular_buffer<T, N>::drop_front(size_type n) noexcept
+	{
+		removed(n);
+		if (n == d_index.size()) {
+			d_index = index();
+		}
+		else {
+			d_index.pop_n(n);
 		}
+	}
+
+	template <class T, size_type N>
+	template <bool isConst>
+	void circular_buffer<T, N>::stamp([[maybe_unused]] myIterator<isConst>& iter) const noexcept
+	{
+#if defined(NON_STL_DEBUG)
+		// Reverse iterators count down from the newest element
+		iter.owner = this;
+		iter.first = iter.reverse ? d_removed + d_index.size() - 1 : d_removed;
+#endif
+	}
 
+	template <class T, size_type N>
+	void circular_buffer<T, N>::copy_from(const circular_buffer& other) noexcept
+	{
+		for (size_type i = 0; i < other.d_index.size(); ++i) {
+			const size_type slot = index::wrap(other.d_index.head + i);
+			::new (static_cast<void*>(storage() + slot)) T(other.storage()[slot]);
+		}
+		d_index = other.d_index;
 	}
 
 	template <class T, size_type N>
-	void circular_buffer<T, N>::increment_tail() noexcept
+	void circular_buffer<T, N>::move_from(circular_buffer& other) noexcept
 	{
-		++d_tail;
-		++d_size;
-		if (d_tail == BUFFER_SIZE) {
-			d_tail = 0;
+		for (size_type i = 0; i < other.d_index.size(); ++i) {
+			const size_type slot = index::wrap(other.d_index.head + i);
+			::new (static_cast<void*>(storage() + slot)) T(std::move(other.storage()[slot]));
 		}
+		d_index = other.d_index;
 	}
 }
\ No newline at end of file
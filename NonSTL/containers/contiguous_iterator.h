@@ -0,0 +1,145 @@
+// contiguous_iterator.h
+// A non-stl header only implementation of an iterator over elements stored contiguously in memory,
+// used by every container which keeps its elements in a single array.
+
+/*
+ * A contiguous_iterator is a thin wrapper around a pointer. It holds no state besides the pointer
+ * and has no virtual functions, so every operation compiles down to plain pointer arithmetic and
+ * loops over it optimize exactly as loops over a raw array would.
+ * Reverse iteration is provided by std::reverse_iterator.
+ */
+
+#pragma once
+
+// Includes
+#include <cstddef>			// std::ptrdiff_t
+#include <iterator>			// std::random_access_iterator_tag, std::contiguous_iterator_tag
+#include <type_traits>		// std::conditional_t, std::enable_if_t, std::remove_cv_t
+
+namespace non_stl
+{
+	// Template parameter T is the element type the iterator refers to
+	// Template parameter isConst selects whether the elements may be modified through the iterator
+	template <class T, bool isConst = false>
+	class contiguous_iterator
+	{
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+		using iterator_concept = std::contiguous_iterator_tag;
+#endif
+		using value_type = std::remove_cv_t<T>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<isConst, const T*, T*>;
+		using reference = std::conditional_t<isConst, const T&, T&>;
+
+		constexpr contiguous_iterator() noexcept : _ptr(nullptr) {}
+		constexpr explicit contiguous_iterator(pointer ptr) noexcept : _ptr(ptr) {}
+
+		// A non const iterator is implicitly convertible to a const iterator
+		template <bool otherConst, class = std::enable_if_t<isConst && !otherConst> >
+		constexpr contiguous_iterator(const contiguous_iterator<T, otherConst>& other) noexcept : _ptr(other.base()) {}
+
+		// Returns the underlying pointer
+		constexpr pointer base() const noexcept { return _ptr; }
+
+		constexpr reference operator*() const noexcept { return *_ptr; }
+		constexpr pointer operator->() const noexcept { return _ptr; }
+		constexpr reference operator[](difference_type n) const noexcept { return _ptr[n]; }
+
+		constexpr contiguous_iterator& operator++() noexcept
+		{
+			++_ptr;
+			return *this;
+		}
+
+		constexpr contiguous_iterator operator++(int) noexcept
+		{
+			contiguous_iterator iter = *this;
+			++_ptr;
+			return iter;
+		}
+
+		constexpr contiguous_iterator& operator--() noexcept
+		{
+			--_ptr;
+			return *this;
+		}
+
+		constexpr contiguous_iterator operator--(int) noexcept
+		{
+			contiguous_iterator iter = *this;
+			--_ptr;
+			return iter;
+		}
+
+		constexpr contiguous_iterator& operator+=(difference_type n) noexcept
+		{
+			_ptr += n;
+			return *this;
+		}
+
+		constexpr contiguous_iterator& operator-=(difference_type n) noexcept
+		{
+			_ptr -= n;
+			return *this;
+		}
+
+		friend constexpr contiguous_iterator operator+(contiguous_iterator lhs, difference_type rhs) noexcept
+		{
+			lhs += rhs;
+			return lhs;
+		}
+
+		friend constexpr contiguous_iterator operator+(difference_type lhs, contiguous_iterator rhs) noexcept
+		{
+			rhs += lhs;
+			return rhs;
+		}
+
+		friend constexpr contiguous_iterator operator-(contiguous_iterator lhs, difference_type rhs) noexcept
+		{
+			lhs -= rhs;
+			return lhs;
+		}
+
+		friend constexpr difference_type operator-(const contiguous_iterator& lhs, const contiguous_iterator& rhs) noexcept
+		{
+			return lhs._ptr - rhs._ptr;
+		}
+
+		// Comparisons only look at the address, never at the elements
+		friend constexpr bool operator==(const contiguous_iterator& lhs, const contiguous_iterator& rhs) noexcept
+		{
+			return lhs._ptr == rhs._ptr;
+		}
+
+		friend constexpr bool operator!=(const contiguous_iterator& lhs, const contiguous_iterator& rhs) noexcept
+		{
+			return lhs._ptr != rhs._ptr;
+		}
+
+		friend constexpr bool operator<(const contiguous_iterator& lhs, const contiguous_iterator& rhs) noexcept
+		{
+			return lhs._ptr < rhs._ptr;
+		}
+
+		friend constexpr bool operator<=(const contiguous_iterator& lhs, const contiguous_iterator& rhs) noexcept
+		{
+			return lhs._ptr <= rhs._ptr;
+		}
+
+		friend constexpr bool operator>(const contiguous_iterator& lhs, const contiguous_iterator& rhs) noexcept
+		{
+			return lhs._ptr > rhs._ptr;
+		}
+
+		friend constexpr bool operator>=(const contiguous_iterator& lhs, const contiguous_iterator& rhs) noexcept
+		{
+			return lhs._ptr >= rhs._ptr;
+		}
+
+	private:
+		pointer _ptr;
+	};
+}
@@ -0,0 +1,218 @@
+// debug.h
+// Opt-in hardened mode for the containers, enabled by defining NON_STL_DEBUG.
+
+/*
+ * With NON_STL_DEBUG defined the containers check their preconditions on the hot path:
+ * operator[], front, back and pop_back are bounds checked, vector iterators remember the generation
+ * of the array they point into and catch use after a reallocation or clear, and circular_buffer
+ * iterators catch use after their element was overwritten or popped.
+ * A failed check calls the debug handler with a message and the location of the check, the default
+ * handler prints them to stderr. The program is aborted once the handler returns.
+ * Without NON_STL_DEBUG NON_STL_DEBUG_CHECK expands to nothing, the condition isn't evaluated, and
+ * the containers keep no extra state, so release builds are exactly as fast as before.
+ * A vector iterator stays tied to the vector it was obtained from, so after a swap or move it is
+ * checked against that vector rather than the one now owning the elements.
+ * The checked iterators change the layout of vector::iterator, every translation unit sharing
+ * containers must agree on NON_STL_DEBUG.
+ */
+
+#pragma once
+
+// Includes
+#include <cstddef>			// std::ptrdiff_t
+#include <cstdint>			// std::uint64_t
+#include <cstdio>			// std::fprintf
+#include <cstdlib>			// std::abort
+#include <iterator>			// std::random_access_iterator_tag, std::contiguous_iterator_tag
+#include <type_traits>		// std::conditional_t, std::enable_if_t, std::remove_cv_t
+#include <utility>			// std::exchange
+
+#if defined(NON_STL_DEBUG)
+#define NON_STL_DEBUG_CHECK(cond, message) \
+	((cond) ? static_cast<void>(0) : ::non_stl::debug_failure(message, __FILE__, __LINE__))
+#else
+#define NON_STL_DEBUG_CHECK(cond, message) static_cast<void>(0)
+#endif
+
+namespace non_stl
+{
+	// Called with the message and location of a failed check
+	using debug_handler = void (*)(const char* message, const char* file, int line);
+
+	inline void default_debug_handler(const char* message, const char* file, int line)
+	{
+		std::fprintf(stderr, "%s:%d: non_stl check failed: %s\n", file, line, message);
+	}
+
+	inline debug_handler current_debug_handler = default_debug_handler;
+
+	// Replaces the handler, e.g. to log through the application's own sink before the abort
+	// Returns the previous handler
+	inline debug_handler set_debug_handler(debug_handler handler) noexcept
+	{
+		return std::exchange(current_debug_handler, handler ? handler : default_debug_handler);
+	}
+
+	[[noreturn]] inline void debug_failure(const char* message, const char* file, int line) noexcept
+	{
+		current_debug_handler(message, file, line);
+		std::abort();
+	}
+
+	// An iterator over contiguous elements which also remembers the generation of the container
+	// it was obtained from. The container bumps its generation whenever the elements move or are
+	// destroyed, after which dereferencing the iterator fails a check
+	// Used in place of contiguous_iterator under NON_STL_DEBUG
+	template <class T, bool isConst = false>
+	class checked_iterator
+	{
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+		using iterator_concept = std::contiguous_iterator_tag;
+#endif
+		using value_type = std::remove_cv_t<T>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<isConst, const T*, T*>;
+		using reference = std::conditional_t<isConst, const T&, T&>;
+
+		constexpr checked_iterator() noexcept : _ptr(nullptr), _source(nullptr), _generation(0) {}
+		constexpr checked_iterator(pointer ptr, const std::uint64_t* source) noexcept
+			: _ptr(ptr), _source(source), _generation(*source) {}
+
+		// A non const iterator is implicitly convertible to a const iterator
+		template <bool otherConst, class = std::enable_if_t<isConst && !otherConst> >
+		constexpr checked_iterator(const checked_iterator<T, otherConst>& other) noexcept
+			: _ptr(other._ptr), _source(other._source), _generation(other._generation) {}
+
+		// Returns the underlying pointer
+		constexpr pointer base() const noexcept { return _ptr; }
+
+		// Returns whether the container hasn't moved or destroyed its elements since the iterator was obtained
+		constexpr bool valid() const noexcept { return _source != nullptr && *_source == _generation; }
+
+		constexpr reference operator*() const noexcept
+		{
+			check();
+			return *_ptr;
+		}
+
+		constexpr pointer operator->() const noexcept
+		{
+			check();
+			return _ptr;
+		}
+
+		constexpr reference operator[](difference_type n) const noexcept
+		{
+			check();
+			return _ptr[n];
+		}
+
+		constexpr checked_iterator& operator++() noexcept
+		{
+			++_ptr;
+			return *this;
+		}
+
+		constexpr checked_iterator operator++(int) noexcept
+		{
+			checked_iterator iter = *this;
+			++_ptr;
+			return iter;
+		}
+
+		constexpr checked_iterator& operator--() noexcept
+		{
+			--_ptr;
+			return *this;
+		}
+
+		constexpr checked_iterator operator--(int) noexcept
+		{
+			checked_iterator iter = *this;
+			--_ptr;
+			return iter;
+		}
+
+		constexpr checked_iterator& operator+=(difference_type n) noexcept
+		{
+			_ptr += n;
+			return *this;
+		}
+
+		constexpr checked_iterator& operator-=(difference_type n) noexcept
+		{
+			_ptr -= n;
+			return *this;
+		}
+
+		friend constexpr checked_iterator operator+(checked_iterator lhs, difference_type rhs) noexcept
+		{
+			lhs += rhs;
+			return lhs;
+		}
+
+		friend constexpr checked_iterator operator+(difference_type lhs, checked_iterator rhs) noexcept
+		{
+			rhs += lhs;
+			return rhs;
+		}
+
+		friend constexpr checked_iterator operator-(checked_iterator lhs, difference_type rhs) noexcept
+		{
+			lhs -= rhs;
+			return lhs;
+		}
+
+		friend constexpr difference_type operator-(const checked_iterator& lhs, const checked_iterator& rhs) noexcept
+		{
+			return lhs._ptr - rhs._ptr;
+		}
+
+		// Comparisons only look at the address, never at the elements
+		friend constexpr bool operator==(const checked_iterator& lhs, const checked_iterator& rhs) noexcept
+		{
+			return lhs._ptr == rhs._ptr;
+		}
+
+		friend constexpr bool operator!=(const checked_iterator& lhs, const checked_iterator& rhs) noexcept
+		{
+			return lhs._ptr != rhs._ptr;
+		}
+
+		friend constexpr bool operator<(const checked_iterator& lhs, const checked_iterator& rhs) noexcept
+		{
+			return lhs._ptr < rhs._ptr;
+		}
+
+		friend constexpr bool operator<=(const checked_iterator& lhs, const checked_iterator& rhs) noexcept
+		{
+			return lhs._ptr <= rhs._ptr;
+		}
+
+		friend constexpr bool operator>(const checked_iterator& lhs, const checked_iterator& rhs) noexcept
+		{
+			return lhs._ptr > rhs._ptr;
+		}
+
+		friend constexpr bool operator>=(const checked_iterator& lhs, const checked_iterator& rhs) noexcept
+		{
+			return lhs._ptr >= rhs._ptr;
+		}
+
+	private:
+		template <class, bool> friend class checked_iterator;
+
+		constexpr void check() const noexcept
+		{
+			NON_STL_DEBUG_CHECK(valid(), "iterator used after its container reallocated or was cleared");
+		}
+
+		pointer _ptr;
+
+		// Generation counter of the container and its value when the iterator was obtained
+		const std::uint64_t* _source;
+		std::uint64_t _generation;
+	};
+}
@@ -0,0 +1,1467 @@
+// deque.h
+// A non-stl header only implementation of std::deque which attempts to adhere to the
+// standard interface as closely as possible.
+// Note, the standard is used for some components such as std::allocator and exceptions
+
+/*
+ * Deques are sequence containers with O(1) insertion and removal at both ends.
+ * The elements live in fixed size blocks obtained from the allocator. A map, an array of block pointers,
+ * keeps the blocks in order, so element i is found with a shift and a mask on its position.
+ * Blocks never move, growing only ever allocates a new block or reallocates the map of pointers,
+ * which keeps references to the elements valid through push_front and push_back and avoids the
+ * copy spikes of a vector used as a queue.
+ * Blocks left empty by pops are kept and reused by later pushes at either end, a deque used as a
+ * queue therefore stops allocating once it reached its working size. shrink_to_fit releases them.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::fill, std::min, std::move, std::move_backward, std::reverse, std::rotate
+#include <cstddef>			// std::ptrdiff_t
+#include <cstring>			// std::memcpy, std::memmove
+#include <initializer_list>	// std::initializer_list
+#include <iterator>			// std::random_access_iterator_tag, std::reverse_iterator, std::make_move_iterator
+#include <memory>			// std::allocator, std::allocator_traits
+#include <memory_resource>	// std::pmr::polymorphic_allocator
+#include <stdexcept>		// std::out_of_range
+#include <type_traits>		// std::conditional_t, std::enable_if_t, std::is_integral, std::is_trivially_copyable
+#include <utility>			// std::forward, std::move, std::swap
+
+#include "contiguous_iterator.h"	// non_stl::contiguous_iterator
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Returns the amount of elements of element_size bytes held by a deque block of about block_bytes
+	// A block holds at least 16 elements and the amount is rounded down to a power of two
+	constexpr size_type deque_block_size(size_type element_size, size_type block_bytes) noexcept
+	{
+		size_type n = block_bytes / element_size;
+		if (n < 16)
+		{
+			n = 16;
+		}
+
+		size_type pow2 = 1;
+		while (pow2 * 2 <= n)
+		{
+			pow2 *= 2;
+		}
+		return pow2;
+	}
+
+	// Template parameter T is the generic object being stored within the container
+	// Template parameter Alloc is the allocator the blocks and the map are obtained from.
+	// If a custom allocator is not provided then the default std::allocator<T> will be used
+	// Template parameter BlockBytes is the approximate size of a block, a page by default,
+	// see deque_block_size for the exact amount of elements per block
+	template <class T, class Alloc = std::allocator<T>, size_type BlockBytes = 4096>
+	class deque
+	{
+		using alloc_traits = std::allocator_traits<Alloc>;
+		using map_alloc = typename alloc_traits::template rebind_alloc<T*>;
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		// Amount of elements held by each block
+		static constexpr size_type block_size = deque_block_size(sizeof(T), BlockBytes);
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor
+		// Nothing is allocated until the first element is added
+		deque() noexcept;
+		explicit deque(const Alloc& alloc) noexcept;
+
+		// Fill constructor
+		// Constructs a deque with size elements
+		// Each element is a copy of val if provided, value initialized otherwise
+		explicit deque(size_type size, const Alloc& alloc = Alloc());
+		deque(size_type size, const T& val, const Alloc& alloc = Alloc());
+
+		// Range constructor
+		template <class InputIterator>
+		deque(InputIterator first, InputIterator last, const Alloc& alloc = Alloc());
+
+		// Copy constructor
+		// The allocator is obtained from select_on_container_copy_construction unless provided
+		deque(const deque& rhs);
+		deque(const deque& rhs, const Alloc& alloc);
+
+		// Move constructor
+		// The blocks are moved along with the allocator
+		// If an unequal allocator is provided the elements are moved one by one instead
+		deque(deque&& rhs) noexcept;
+		deque(deque&& rhs, const Alloc& alloc);
+
+		// Initializer list constructor
+		deque(std::initializer_list<T> init, const Alloc& alloc = Alloc());
+
+		// ---------------
+		// OPERATOR=
+		// ---------------
+
+		// The allocator follows the propagate_on_container_copy_assignment and
+		// propagate_on_container_move_assignment traits. When it doesn't propagate
+		// and the allocators are unequal a move assignment moves the elements one by one
+		deque& operator=(const deque& rhs);
+		deque& operator=(deque&& rhs) noexcept(
+			std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+			std::allocator_traits<Alloc>::is_always_equal::value);
+		deque& operator=(std::initializer_list<T> init);
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+		~deque();
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns a reference to the element at position n in the deque
+		// with no range check
+		T& operator[](size_type n) noexcept;
+		const T& operator[](size_type n) const noexcept;
+
+		// Returns a reference to the element at position n in the deque
+		// Function throws std::out_of_range if the input is not within range
+		T& at(size_type n);
+		const T& at(size_type n) const;
+
+		// Returns a reference to the first element in the deque
+		T& front() noexcept;
+		const T& front() const noexcept;
+
+		// Returns a reference to the last element in the deque
+		T& back() noexcept;
+		const T& back() const noexcept;
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+
+		// An iterator is the map and the position of an element,
+		// dereferencing it splits the position into a block and an offset in the block
+		template <bool isConst> struct myIterator;
+		using iterator = myIterator<false>;
+		using const_iterator = myIterator<true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Returns an iterator to the first element of the container
+		// If the container is empty, the returned iterator will be equal to end()
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+
+		// Returns an iterator to the element following the last element of the container
+		// Attempting to access or modify this element results in undefined behavior
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+
+		// Returns a reverse iterator to the first element of the reversed container
+		reverse_iterator rbegin() noexcept;
+		const_reverse_iterator rbegin() const noexcept;
+		const_reverse_iterator crbegin() const noexcept;
+
+		// Returns a reverse iterator to the element following the last element of the reversed container
+		reverse_iterator rend() noexcept;
+		const_reverse_iterator rend() const noexcept;
+		const_reverse_iterator crend() const noexcept;
+
+		template <bool isconst = false>
+		struct myIterator
+		{
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using reference = typename std::conditional_t< isconst, T const&, T& >;
+			using pointer = typename std::conditional_t< isconst, T const*, T* >;
+		private:
+			T* const*	map;
+			size_type	pos;
+
+			myIterator(T* const* m, size_type p) : map(m), pos(p) {}
+
+		public:
+			myIterator() : map(nullptr), pos(0) {}
+			// A non const iterator is implicitly convertible to a const iterator
+			template <bool otherConst, class = std::enable_if_t<isconst && !otherConst> >
+			myIterator(const myIterator<otherConst>& i) : map(i.map), pos(i.pos) {}
+
+			reference operator*() const {
+				return map[pos / block_size][pos % block_size];
+			}
+			reference operator[](difference_type n) const {
+				const size_type p = pos + n;
+				return map[p / block_size][p % block_size];
+			}
+			pointer operator->() const { return &(operator *()); }
+
+			myIterator& operator++()
+			{
+				++pos;
+				return *this;
+			}
+			myIterator operator++(int)
+			{
+				myIterator iter = *this;
+				++pos;
+				return iter;
+			}
+			myIterator& operator--()
+			{
+				--pos;
+				return *this;
+			}
+			myIterator operator--(int) {
+				myIterator iter = *this;
+				--pos;
+				return iter;
+			}
+			friend myIterator operator+(myIterator lhs, difference_type rhs) {
+				lhs.pos += rhs;
+				return lhs;
+			}
+			friend myIterator operator+(difference_type lhs, myIterator rhs) {
+				rhs.pos += lhs;
+				return rhs;
+			}
+			myIterator& operator+=(difference_type n) {
+				pos += n;
+				return *this;
+			}
+			friend myIterator operator-(myIterator lhs, difference_type rhs) {
+				lhs.pos -= rhs;
+				return lhs;
+			}
+			friend difference_type operator-(const myIterator& lhs, const myIterator& rhs) {
+				return static_cast<difference_type>(lhs.pos - rhs.pos);
+			}
+			myIterator& operator-=(difference_type n) {
+				pos -= n;
+				return *this;
+			}
+
+			friend bool operator==(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.pos == rhs.pos;
+			}
+			friend bool operator!=(const myIterator& lhs, const myIterator& rhs) {
+				return !(lhs == rhs);
+			}
+			friend bool operator<(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.pos < rhs.pos;
+			}
+			friend bool operator<=(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.pos <= rhs.pos;
+			}
+			friend bool operator>(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.pos > rhs.pos;
+			}
+			friend bool operator>=(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.pos >= rhs.pos;
+			}
+			friend class deque;
+			friend struct myIterator<!isconst>;
+		};
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of elements in the deque
+		size_type size() const noexcept;
+
+		// Return the maximum number of elements the deque can hold
+		size_type max_size() const noexcept;
+
+		// Returns whether the deque is empty
+		// (i.e. whether its size is 0)
+		bool empty() const noexcept;
+
+		// Resizes the container so that it contains n elements
+		// If the container is expanded the new elements are value initialized
+		// or set to val if it is provided
+		void resize(size_type n);
+		void resize(size_type n, const T& val);
+
+		// Returns the blocks holding no element to the allocator and shrinks the map to the blocks left
+		void shrink_to_fit();
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Assign new contents to the deque, replacing its current contents
+		// Blocks already allocated are reused
+
+		// Range version
+		template <class InputIterator>
+		void assign(InputIterator first, InputIterator last);
+
+		// Fill version
+		void assign(size_type n, const T& val);
+
+		// Initializer list version
+		void assign(std::initializer_list<T> il);
+
+		// Adds a new element at the end of the deque after its current last element
+		void push_back(const T& val);
+		void push_back(T&& val);
+
+		// Adds a new element at the start of the deque before its current first element
+		void push_front(const T& val);
+		void push_front(T&& val);
+
+		// Constructs a new element at the end or at the start of the deque
+		// The arguments args... are forwarded to the constructor as std::forward<Args>(args)....
+		// No element is moved so args may refer to an element of this deque
+		template <class... Args>
+		T& emplace_back(Args&& ... args);
+		template <class... Args>
+		T& emplace_front(Args&& ... args);
+
+		// Removes the last element in the deque
+		void pop_back() noexcept;
+
+		// Removes the first element in the deque
+		void pop_front() noexcept;
+
+		// Inserts new elements before position
+		// Inserting at either end constructs the elements in place, the blocks needed are
+		// allocated up front, otherwise the elements on the shorter side of position are shifted
+
+		// Single element
+		iterator insert(const_iterator position, const T& val);
+
+		// Move
+		iterator insert(const_iterator position, T&& val);
+
+		// Fill
+		iterator insert(const_iterator position, size_type n, const T& val);
+
+		// Range
+		template <class InputIterator>
+		iterator insert(const_iterator position, InputIterator first, InputIterator last);
+
+		// Initializer list
+		iterator insert(const_iterator position, std::initializer_list<T> il);
+
+		// Constructs a new element before position from args
+		template <class... Args>
+		iterator emplace(const_iterator position, Args&& ... args);
+
+		// Appends, or prepends in order, copies of the elements of rg
+		// Contiguous ranges of trivially copyable elements are copied with one memcpy per block
+		template <class Range>
+		void append_range(Range&& rg);
+		template <class Range>
+		void prepend_range(Range&& rg);
+
+		// Removes the element at position, or the elements in [first, last)
+		// The elements on the shorter side of the removed ones are shifted
+		// Returns an iterator to the element following the last one removed
+		iterator erase(const_iterator position);
+		iterator erase(const_iterator first, const_iterator last);
+
+		// Exchanges the content of the container by the content of x
+		// The allocators are only exchanged if propagate_on_container_swap is set
+		// Unequal allocators which don't propagate fall back to moving the elements
+		void swap(deque& x);
+
+		// Removes all elements from the deque leaving the container with a size of 0
+		// The blocks are kept for reuse
+		void clear() noexcept;
+
+		// ---------------
+		// ALLOCATOR
+		// ---------------
+
+		// Returns a copy of the allocator object associated with this deque
+		Alloc get_allocator() const noexcept;
+
+	private:
+		// Private functions
+
+		// Returns the element at position pos, where pos counts from the start of the map
+		T* slot(size_type pos) const noexcept;
+
+		// Makes sure blocks exist for n more elements at the back, or at the front
+		// Empty blocks at the other end are moved over before new ones are allocated
+		void reserve_back(size_type n);
+		void reserve_front(size_type n);
+
+		// Makes room in the map for front more blocks before the first one and back more after the last
+		// The map is recentered when it is at most half full, reallocated otherwise
+		void reshape_map(size_type front, size_type back);
+
+		// Constructs n elements at the back, or at the front, calling construct(T*) on each slot in order
+		// If a construction throws the elements already added are destroyed and the deque is unchanged
+		template <class Construct>
+		void construct_back(size_type n, Construct construct);
+		template <class Construct>
+		void construct_front(size_type n, Construct construct);
+
+		// Constructs the n elements of the range starting at first at the back, or in order at the front
+		template <class ForwardIterator>
+		void append_n(ForwardIterator first, size_type n);
+		template <class ForwardIterator>
+		void prepend_n(ForwardIterator first, size_type n);
+
+		// Copies n trivially copyable elements from src to the slots starting at pos, one memcpy per block
+		void copy_to_blocks(size_type pos, const T* src, size_type n) noexcept;
+
+		// Destroys the n elements starting at position pos
+		void destroy_n(size_type pos, size_type n) noexcept;
+
+		// Destroys every element and returns the blocks and the map to the allocator
+		// leaving the deque as if default constructed
+		void release() noexcept;
+
+		// Takes the map and the blocks of rhs, leaving rhs empty
+		// Assumed that this deque holds no map
+		void steal(deque& rhs) noexcept;
+
+		// Returns a new block, or gives one back, to the allocator
+		T* allocate_block();
+		void deallocate_block(T* block) noexcept;
+
+		// Member variables
+
+		// Allocator object, used to allocate the blocks and, rebound, the map
+		Alloc _alloc;
+
+		// Array of block pointers. The slots [_blocks_begin, _blocks_end) hold a block, the others are nullptr
+		T** _map;
+		size_type _map_capacity;
+		size_type _blocks_begin;
+		size_type _blocks_end;
+
+		// Position of the first element, counted from the start of the map
+		// Element i is at block (_start + i) / block_size, offset (_start + i) % block_size
+		size_type _start;
+
+		// The current amount of elements stored within the deque
+		size_type _size;
+	};
+
+	// DEQUE IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>::deque() noexcept :
+		deque(Alloc())
+	{
+
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>::deque(const Alloc& alloc) noexcept :
+		_alloc(alloc),
+		_map(nullptr),
+		_map_capacity(0),
+		_blocks_begin(0),
+		_blocks_end(0),
+		_start(0),
+		_size(0)
+	{
+
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>::deque(size_type size, const Alloc& alloc) :
+		deque(alloc)
+	{
+		resize(size);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>::deque(size_type size, const T& val, const Alloc& alloc) :
+		deque(alloc)
+	{
+		resize(size, val);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class InputIterator>
+	deque<T, Alloc, BlockBytes>::deque(InputIterator first, InputIterator last, const Alloc& alloc) :
+		deque(alloc)
+	{
+		insert(cend(), first, last);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>::deque(const deque<T, Alloc, BlockBytes>& rhs) :
+		deque(rhs, alloc_traits::select_on_container_copy_construction(rhs._alloc))
+	{
+
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>::deque(const deque<T, Alloc, BlockBytes>& rhs, const Alloc& alloc) :
+		deque(alloc)
+	{
+		append_n(rhs.begin(), rhs._size);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>::deque(deque<T, Alloc, BlockBytes>&& rhs) noexcept :
+		deque(std::move(rhs._alloc))
+	{
+		steal(rhs);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>::deque(deque<T, Alloc, BlockBytes>&& rhs, const Alloc& alloc) :
+		deque(alloc)
+	{
+		if (_alloc == rhs._alloc)
+		{
+			steal(rhs);
+		}
+		else
+		{
+			// The blocks belong to another allocator, move the elements into our own
+			append_n(std::make_move_iterator(rhs.begin()), rhs._size);
+			rhs.clear();
+		}
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>::deque(std::initializer_list<T> init, const Alloc& alloc) :
+		deque(alloc)
+	{
+		append_n(init.begin(), init.size());
+	}
+
+	// ---------------
+	// OPERATOR=
+	// ---------------
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>& deque<T, Alloc, BlockBytes>::operator=(const deque<T, Alloc, BlockBytes>& rhs)
+	{
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+		{
+			// Blocks from the current allocator can't be kept if the new one can't free them
+			if (!(_alloc == rhs._alloc))
+			{
+				release();
+			}
+			_alloc = rhs._alloc;
+		}
+
+		clear();
+		append_n(rhs.begin(), rhs._size);
+		return *this;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>& deque<T, Alloc, BlockBytes>::operator=(deque<T, Alloc, BlockBytes>&& rhs) noexcept(
+		std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+		std::allocator_traits<Alloc>::is_always_equal::value)
+	{
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+		{
+			// Take the allocator along with the blocks
+			release();
+			_alloc = std::move(rhs._alloc);
+			steal(rhs);
+		}
+		else
+		{
+			if (_alloc == rhs._alloc)
+			{
+				release();
+				steal(rhs);
+			}
+			else
+			{
+				// Can't adopt blocks from another allocator, move the elements one by one
+				clear();
+				append_n(std::make_move_iterator(rhs.begin()), rhs._size);
+				rhs.clear();
+			}
+		}
+
+		return *this;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>& deque<T, Alloc, BlockBytes>::operator=(std::initializer_list<T> init)
+	{
+		assign(init);
+		return *this;
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class T, class Alloc, size_type BlockBytes>
+	deque<T, Alloc, BlockBytes>::~deque()
+	{
+		release();
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T, class Alloc, size_type BlockBytes>
+	inline T& deque<T, Alloc, BlockBytes>::operator[](size_type n) noexcept
+	{
+		return *slot(_start + n);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline const T& deque<T, Alloc, BlockBytes>::operator[](size_type n) const noexcept
+	{
+		return *slot(_start + n);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	T& deque<T, Alloc, BlockBytes>::at(size_type n)
+	{
+		if (n >= _size)
+		{
+			throw std::out_of_range("deque::at - index out of range");
+		}
+		return *slot(_start + n);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	const T& deque<T, Alloc, BlockBytes>::at(size_type n) const
+	{
+		if (n >= _size)
+		{
+			throw std::out_of_range("deque::at - index out of range");
+		}
+		return *slot(_start + n);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline T& deque<T, Alloc, BlockBytes>::front() noexcept
+	{
+		return *slot(_start);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline const T& deque<T, Alloc, BlockBytes>::front() const noexcept
+	{
+		return *slot(_start);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline T& deque<T, Alloc, BlockBytes>::back() noexcept
+	{
+		return *slot(_start + _size - 1);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline const T& deque<T, Alloc, BlockBytes>::back() const noexcept
+	{
+		return *slot(_start + _size - 1);
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::iterator deque<T, Alloc, BlockBytes>::begin() noexcept
+	{
+		return iterator(_map, _start);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::const_iterator deque<T, Alloc, BlockBytes>::begin() const noexcept
+	{
+		return const_iterator(_map, _start);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::const_iterator deque<T, Alloc, BlockBytes>::cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::iterator deque<T, Alloc, BlockBytes>::end() noexcept
+	{
+		return iterator(_map, _start + _size);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::const_iterator deque<T, Alloc, BlockBytes>::end() const noexcept
+	{
+		return const_iterator(_map, _start + _size);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::const_iterator deque<T, Alloc, BlockBytes>::cend() const noexcept
+	{
+		return end();
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::reverse_iterator deque<T, Alloc, BlockBytes>::rbegin() noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::const_reverse_iterator deque<T, Alloc, BlockBytes>::rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::const_reverse_iterator deque<T, Alloc, BlockBytes>::crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::reverse_iterator deque<T, Alloc, BlockBytes>::rend() noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::const_reverse_iterator deque<T, Alloc, BlockBytes>::rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline typename deque<T, Alloc, BlockBytes>::const_reverse_iterator deque<T, Alloc, BlockBytes>::crend() const noexcept
+	{
+		return rend();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, class Alloc, size_type BlockBytes>
+	inline size_type deque<T, Alloc, BlockBytes>::size() const noexcept
+	{
+		return _size;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline size_type deque<T, Alloc, BlockBytes>::max_size() const noexcept
+	{
+		return alloc_traits::max_size(_alloc);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline bool deque<T, Alloc, BlockBytes>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::resize(size_type n)
+	{
+		if (n < _size)
+		{
+			destroy_n(_start + n, _size - n);
+			_size = n;
+			return;
+		}
+
+		construct_back(n - _size, [this](T* p) { alloc_traits::construct(_alloc, p); });
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::resize(size_type n, const T& val)
+	{
+		if (n < _size)
+		{
+			destroy_n(_start + n, _size - n);
+			_size = n;
+			return;
+		}
+
+		// No element moves when the deque grows so val may refer to one of them
+		construct_back(n - _size, [this, &val](T* p) { alloc_traits::construct(_alloc, p, val); });
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::shrink_to_fit()
+	{
+		if (_size == 0)
+		{
+			release();
+			return;
+		}
+
+		// Blocks holding at least one element
+		const size_type first = _start / block_size;
+		const size_type last = (_start + _size + block_size - 1) / block_size;
+		const size_type used = last - first;
+
+		if (used == _map_capacity)
+		{
+			return;
+		}
+
+		map_alloc malloc(_alloc);
+		T** map = malloc.allocate(used);
+
+		for (size_type i = _blocks_begin; i < first; ++i)
+		{
+			deallocate_block(_map[i]);
+		}
+		for (size_type i = last; i < _blocks_end; ++i)
+		{
+			deallocate_block(_map[i]);
+		}
+		std::memcpy(static_cast<void*>(map), static_cast<const void*>(_map + first), used * sizeof(T*));
+
+		malloc.deallocate(_map, _map_capacity);
+		_map = map;
+		_map_capacity = used;
+		_blocks_begin = 0;
+		_blocks_end = used;
+		_start -= first * block_size;
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class InputIterator>
+	void deque<T, Alloc, BlockBytes>::assign(InputIterator first, InputIterator last)
+	{
+		clear();
+		insert(cend(), first, last);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::assign(size_type n, const T& val)
+	{
+		// Take a copy in case val refers to an element which is about to be destroyed
+		const T copy(val);
+		clear();
+		construct_back(n, [this, &copy](T* p) { alloc_traits::construct(_alloc, p, copy); });
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::assign(std::initializer_list<T> il)
+	{
+		clear();
+		append_n(il.begin(), il.size());
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::push_back(const T& val)
+	{
+		emplace_back(val);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::push_back(T&& val)
+	{
+		emplace_back(std::move(val));
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::push_front(const T& val)
+	{
+		emplace_front(val);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::push_front(T&& val)
+	{
+		emplace_front(std::move(val));
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class... Args>
+	T& deque<T, Alloc, BlockBytes>::emplace_back(Args&& ... args)
+	{
+		// Only the last block being full needs any work
+		if (_start + _size == _blocks_end * block_size)
+		{
+			reserve_back(1);
+		}
+
+		T* p = slot(_start + _size);
+		alloc_traits::construct(_alloc, p, std::forward<Args>(args)...);
+		++_size;
+		return *p;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class... Args>
+	T& deque<T, Alloc, BlockBytes>::emplace_front(Args&& ... args)
+	{
+		if (_start == _blocks_begin * block_size)
+		{
+			reserve_front(1);
+		}
+
+		T* p = slot(_start - 1);
+		alloc_traits::construct(_alloc, p, std::forward<Args>(args)...);
+		--_start;
+		++_size;
+		return *p;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::pop_back() noexcept
+	{
+		alloc_traits::destroy(_alloc, slot(_start + _size - 1));
+		--_size;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::pop_front() noexcept
+	{
+		alloc_traits::destroy(_alloc, slot(_start));
+		++_start;
+		--_size;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	typename deque<T, Alloc, BlockBytes>::iterator deque<T, Alloc, BlockBytes>::insert(const_iterator position, const T& val)
+	{
+		return emplace(position, val);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	typename deque<T, Alloc, BlockBytes>::iterator deque<T, Alloc, BlockBytes>::insert(const_iterator position, T&& val)
+	{
+		return emplace(position, std::move(val));
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	typename deque<T, Alloc, BlockBytes>::iterator deque<T, Alloc, BlockBytes>::insert(const_iterator position, size_type n, const T& val)
+	{
+		const auto idx = (size_type)(position - cbegin());
+
+		// Take a copy in case val refers to an element which is about to be shifted
+		const T copy(val);
+		auto construct = [this, &copy](T* p) { alloc_traits::construct(_alloc, p, copy); };
+
+		if (idx <= _size - idx)
+		{
+			construct_front(n, construct);
+			std::rotate(begin(), begin() + n, begin() + n + idx);
+		}
+		else
+		{
+			const auto old_size = _size;
+			construct_back(n, construct);
+			std::rotate(begin() + idx, begin() + old_size, end());
+		}
+
+		return begin() + idx;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class InputIterator>
+	typename deque<T, Alloc, BlockBytes>::iterator deque<T, Alloc, BlockBytes>::insert(const_iterator position, InputIterator first, InputIterator last)
+	{
+		if constexpr (std::is_integral<InputIterator>::value) {
+			return insert(position, (size_type)first, (T)last);
+		}
+		else {
+			const auto idx = (size_type)(position - cbegin());
+
+			using category = typename std::iterator_traits<InputIterator>::iterator_category;
+			if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+				const auto n = (size_type)std::distance(first, last);
+
+				// Construct the new elements at the end closest to position and rotate them into place
+				if (idx <= _size - idx)
+				{
+					prepend_n(first, n);
+					std::rotate(begin(), begin() + n, begin() + n + idx);
+				}
+				else
+				{
+					const auto old_size = _size;
+					append_n(first, n);
+					std::rotate(begin() + idx, begin() + old_size, end());
+				}
+			}
+			else {
+				// Single pass iterators can't be measured, append and rotate into place
+				const auto old_size = _size;
+				for (; first != last; ++first)
+				{
+					emplace_back(*first);
+				}
+				std::rotate(begin() + idx, begin() + old_size, end());
+			}
+
+			return begin() + idx;
+		}
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	typename deque<T, Alloc, BlockBytes>::iterator deque<T, Alloc, BlockBytes>::insert(const_iterator position, std::initializer_list<T> il)
+	{
+		return insert(position, il.begin(), il.end());
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class... Args>
+	typename deque<T, Alloc, BlockBytes>::iterator deque<T, Alloc, BlockBytes>::emplace(const_iterator position, Args&& ... args)
+	{
+		const auto idx = (size_type)(position - cbegin());
+
+		if (idx == 0)
+		{
+			emplace_front(std::forward<Args>(args)...);
+			return begin();
+		}
+		if (idx == _size)
+		{
+			emplace_back(std::forward<Args>(args)...);
+			return end() - 1;
+		}
+
+		// Build the element before shifting as args may refer to an element of this deque
+		T tmp(std::forward<Args>(args)...);
+
+		if (idx < _size / 2)
+		{
+			// Shift the elements before position one step towards the front
+			emplace_front(std::move(front()));
+			std::move(begin() + 2, begin() + idx + 1, begin() + 1);
+		}
+		else
+		{
+			// Shift the elements from position one step towards the back
+			emplace_back(std::move(back()));
+			std::move_backward(begin() + idx, end() - 2, end() - 1);
+		}
+
+		*(begin() + idx) = std::move(tmp);
+		return begin() + idx;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class Range>
+	void deque<T, Alloc, BlockBytes>::append_range(Range&& rg)
+	{
+		insert(cend(), std::begin(rg), std::end(rg));
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class Range>
+	void deque<T, Alloc, BlockBytes>::prepend_range(Range&& rg)
+	{
+		insert(cbegin(), std::begin(rg), std::end(rg));
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	typename deque<T, Alloc, BlockBytes>::iterator deque<T, Alloc, BlockBytes>::erase(const_iterator position)
+	{
+		return erase(position, position + 1);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	typename deque<T, Alloc, BlockBytes>::iterator deque<T, Alloc, BlockBytes>::erase(const_iterator first, const_iterator last)
+	{
+		const auto idx = (size_type)(first - cbegin());
+		const auto n = (size_type)(last - first);
+
+		if (n == 0)
+		{
+			return begin() + idx;
+		}
+
+		if (idx < _size - idx - n)
+		{
+			// Fewer elements before the range, shift them back over it and drop the front
+			std::move_backward(begin(), begin() + idx, begin() + idx + n);
+			destroy_n(_start, n);
+			_start += n;
+		}
+		else
+		{
+			std::move(begin() + idx + n, end(), begin() + idx);
+			destroy_n(_start + _size - n, n);
+		}
+		_size -= n;
+
+		return begin() + idx;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::swap(deque<T, Alloc, BlockBytes>& x)
+	{
+		if (this == &x)
+		{
+			return;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_swap::value)
+		{
+			using std::swap;
+			swap(_alloc, x._alloc);
+		}
+		else if constexpr (!alloc_traits::is_always_equal::value)
+		{
+			// Each set of blocks has to stay with the allocator it came from
+			if (!(_alloc == x._alloc))
+			{
+				deque tmp(std::move(x), _alloc);
+				x = std::move(*this);
+				*this = std::move(tmp);
+				return;
+			}
+		}
+
+		std::swap(_map, x._map);
+		std::swap(_map_capacity, x._map_capacity);
+		std::swap(_blocks_begin, x._blocks_begin);
+		std::swap(_blocks_end, x._blocks_end);
+		std::swap(_start, x._start);
+		std::swap(_size, x._size);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::clear() noexcept
+	{
+		destroy_n(_start, _size);
+		_size = 0;
+	}
+
+	// ---------------
+	// ALLOCATOR
+	// ---------------
+	template <class T, class Alloc, size_type BlockBytes>
+	Alloc deque<T, Alloc, BlockBytes>::get_allocator() const noexcept
+	{
+		return _alloc;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T, class Alloc, size_type BlockBytes>
+	inline T* deque<T, Alloc, BlockBytes>::slot(size_type pos) const noexcept
+	{
+		return _map[pos / block_size] + pos % block_size;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::reserve_back(size_type n)
+	{
+		const size_type needed_end = (_start + _size + n + block_size - 1) / block_size;
+		if (needed_end <= _blocks_end)
+		{
+			return;
+		}
+
+		const size_type count = needed_end - _blocks_end;
+		if (_blocks_end + count > _map_capacity)
+		{
+			reshape_map(0, count);
+		}
+
+		for (size_type i = 0; i < count; ++i)
+		{
+			// A block before the one holding the first element is free to move to the back
+			if (_start >= (_blocks_begin + 1) * block_size)
+			{
+				_map[_blocks_end] = _map[_blocks_begin];
+				_map[_blocks_begin] = nullptr;
+				++_blocks_begin;
+			}
+			else
+			{
+				_map[_blocks_end] = allocate_block();
+			}
+			++_blocks_end;
+		}
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::reserve_front(size_type n)
+	{
+		const size_type room = _start - _blocks_begin * block_size;
+		if (n <= room)
+		{
+			return;
+		}
+
+		const size_type count = (n - room + block_size - 1) / block_size;
+		if (_blocks_begin < count)
+		{
+			reshape_map(count, 0);
+		}
+
+		for (size_type i = 0; i < count; ++i)
+		{
+			// A block after the one holding the last element is free to move to the front
+			if (_blocks_end > _blocks_begin && (_blocks_end - 1) * block_size >= _start + _size)
+			{
+				--_blocks_end;
+				_map[_blocks_begin - 1] = _map[_blocks_end];
+				_map[_blocks_end] = nullptr;
+			}
+			else
+			{
+				_map[_blocks_begin - 1] = allocate_block();
+			}
+			--_blocks_begin;
+		}
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::reshape_map(size_type front, size_type back)
+	{
+		const size_type used = _blocks_end - _blocks_begin;
+		const size_type needed = used + front + back;
+
+		T** map = _map;
+		size_type cap = _map_capacity;
+		map_alloc malloc(_alloc);
+
+		if (needed * 2 > _map_capacity)
+		{
+			cap = std::max<size_type>({ 2 * _map_capacity, 2 * needed, 8 });
+			map = malloc.allocate(cap);
+		}
+
+		// Center the blocks in what is left once front and back are accounted for
+		const size_type begin = front + (cap - needed) / 2;
+
+		if (used > 0)
+		{
+			std::memmove(static_cast<void*>(map + begin), static_cast<const void*>(_map + _blocks_begin), used * sizeof(T*));
+		}
+		std::fill(map, map + begin, nullptr);
+		std::fill(map + begin + used, map + cap, nullptr);
+
+		if (map != _map)
+		{
+			if (_map)
+			{
+				malloc.deallocate(_map, _map_capacity);
+			}
+			_map = map;
+			_map_capacity = cap;
+		}
+
+		_start = _start - _blocks_begin * block_size + begin * block_size;
+		_blocks_begin = begin;
+		_blocks_end = begin + used;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class Construct>
+	void deque<T, Alloc, BlockBytes>::construct_back(size_type n, Construct construct)
+	{
+		reserve_back(n);
+
+		const size_type old_size = _size;
+		try
+		{
+			for (size_type i = 0; i < n; ++i)
+			{
+				construct(slot(_start + _size));
+				++_size;
+			}
+		}
+		catch (...)
+		{
+			destroy_n(_start + old_size, _size - old_size);
+			_size = old_size;
+			throw;
+		}
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class Construct>
+	void deque<T, Alloc, BlockBytes>::construct_front(size_type n, Construct construct)
+	{
+		reserve_front(n);
+
+		// Construct in order from the new first position so the elements keep the order they are given in
+		const size_type first = _start - n;
+		size_type constructed = 0;
+		try
+		{
+			for (; constructed < n; ++constructed)
+			{
+				construct(slot(first + constructed));
+			}
+		}
+		catch (...)
+		{
+			destroy_n(first, constructed);
+			throw;
+		}
+
+		_start = first;
+		_size += n;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class ForwardIterator>
+	void deque<T, Alloc, BlockBytes>::append_n(ForwardIterator first, size_type n)
+	{
+		constexpr bool contiguous =
+			std::is_same<ForwardIterator, T*>::value ||
+			std::is_same<ForwardIterator, const T*>::value ||
+			std::is_same<ForwardIterator, contiguous_iterator<T> >::value ||
+			std::is_same<ForwardIterator, contiguous_iterator<T, true> >::value;
+
+		if constexpr (contiguous && std::is_trivially_copyable<T>::value)
+		{
+			if (n > 0)
+			{
+				reserve_back(n);
+				copy_to_blocks(_start + _size, &*first, n);
+				_size += n;
+			}
+		}
+		else
+		{
+			construct_back(n, [this, &first](T* p) {
+				alloc_traits::construct(_alloc, p, *first);
+				++first;
+			});
+		}
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	template <class ForwardIterator>
+	void deque<T, Alloc, BlockBytes>::prepend_n(ForwardIterator first, size_type n)
+	{
+		constexpr bool contiguous =
+			std::is_same<ForwardIterator, T*>::value ||
+			std::is_same<ForwardIterator, const T*>::value ||
+			std::is_same<ForwardIterator, contiguous_iterator<T> >::value ||
+			std::is_same<ForwardIterator, contiguous_iterator<T, true> >::value;
+
+		if constexpr (contiguous && std::is_trivially_copyable<T>::value)
+		{
+			if (n > 0)
+			{
+				reserve_front(n);
+				copy_to_blocks(_start - n, &*first, n);
+				_start -= n;
+				_size += n;
+			}
+		}
+		else
+		{
+			construct_front(n, [this, &first](T* p) {
+				alloc_traits::construct(_alloc, p, *first);
+				++first;
+			});
+		}
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::copy_to_blocks(size_type pos, const T* src, size_type n) noexcept
+	{
+		while (n > 0)
+		{
+			const size_type count = std::min(n, block_size - pos % block_size);
+			std::memcpy(static_cast<void*>(slot(pos)), static_cast<const void*>(src), count * sizeof(T));
+			pos += count;
+			src += count;
+			n -= count;
+		}
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::destroy_n(size_type pos, size_type n) noexcept
+	{
+		if constexpr (!std::is_trivially_destructible<T>::value)
+		{
+			for (size_type i = 0; i < n; ++i)
+			{
+				alloc_traits::destroy(_alloc, slot(pos + i));
+			}
+		}
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::release() noexcept
+	{
+		if (_map)
+		{
+			clear();
+
+			for (size_type i = _blocks_begin; i < _blocks_end; ++i)
+			{
+				deallocate_block(_map[i]);
+			}
+
+			map_alloc malloc(_alloc);
+			malloc.deallocate(_map, _map_capacity);
+
+			_map = nullptr;
+			_map_capacity = 0;
+			_blocks_begin = 0;
+			_blocks_end = 0;
+			_start = 0;
+		}
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	void deque<T, Alloc, BlockBytes>::steal(deque<T, Alloc, BlockBytes>& rhs) noexcept
+	{
+		_map = rhs._map;
+		_map_capacity = rhs._map_capacity;
+		_blocks_begin = rhs._blocks_begin;
+		_blocks_end = rhs._blocks_end;
+		_start = rhs._start;
+		_size = rhs._size;
+
+		// set the rvalue to an empty state since we have moved from it
+		rhs._map = nullptr;
+		rhs._map_capacity = 0;
+		rhs._blocks_begin = 0;
+		rhs._blocks_end = 0;
+		rhs._start = 0;
+		rhs._size = 0;
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline T* deque<T, Alloc, BlockBytes>::allocate_block()
+	{
+		return _alloc.allocate(block_size);
+	}
+
+	template <class T, class Alloc, size_type BlockBytes>
+	inline void deque<T, Alloc, BlockBytes>::deallocate_block(T* block) noexcept
+	{
+		_alloc.deallocate(block, block_size);
+	}
+
+	namespace pmr
+	{
+		// deque using a polymorphic allocator, e.g. backed by a non_stl::monotonic_buffer
+		template <class T, size_type BlockBytes = 4096>
+		using deque = non_stl::deque<T, std::pmr::polymorphic_allocator<T>, BlockBytes>;
+	}
+}
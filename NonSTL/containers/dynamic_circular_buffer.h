@@ -0,0 +1,1101 @@
+// dynamic_circular_buffer.h
+// A non-stl header only implementation of a circular buffer whose capacity is chosen at runtime
+// and whose storage is obtained from an allocator.
+// Note, the standard is used for some components such as std::allocator and std::move
+
+/*
+ * A dynamic_circular_buffer behaves as circular_buffer but its capacity is a constructor argument and
+ * its elements live in a single array obtained from the allocator instead of inside the object itself,
+ * so large buffers never end up on the stack.
+ * When the buffer fills it either overwrites the oldest data, as circular_buffer does, or when constructed
+ * with overflow_policy::grow it moves the elements in order into a bigger array chosen by the growth policy.
+ * Elements are constructed in place when pushed and destroyed when popped, overwritten or when the buffer
+ * is destroyed.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::copy_n, std::min, std::max
+#include <cstddef>			// std::ptrdiff_t
+#include <iterator>			// std::random_access_iterator_tag, std::make_move_iterator
+#include <memory>			// std::allocator, std::allocator_traits
+#include <memory_resource>	// std::pmr::polymorphic_allocator
+#include <new>				// placement new
+#include <stdexcept>		// std::out_of_range
+#include <type_traits>		// std::conditional_t, std::enable_if_t, std::is_lvalue_reference, std::is_trivially_copyable
+#include <utility>			// std::forward, std::move, std::swap
+
+#include "growth_policy.h"	// non_stl::double_growth
+#include "span.h"			// non_stl::span
+#include "../memory/relocate.h"	// non_stl::relocate_n
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// What a full dynamic_circular_buffer does with a new element
+	enum class overflow_policy
+	{
+		// The oldest element is overwritten
+		overwrite,
+
+		// The elements are moved into a bigger array
+		grow
+	};
+
+	// Template parameter T is the generic object being stored within the container
+	// Template parameter Alloc is the allocator the array is obtained from
+	// Template parameter Growth is the growth policy used by overflow_policy::grow, see growth_policy.h
+	template <class T, class Alloc = std::allocator<T>, class Growth = double_growth>
+	class dynamic_circular_buffer
+	{
+		using alloc_traits = std::allocator_traits<Alloc>;
+
+	public:
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor
+		// The buffer starts with no capacity, which is only useful with overflow_policy::grow
+		// or once a capacity is given by reserve() or an assignment
+		dynamic_circular_buffer() noexcept;
+		explicit dynamic_circular_buffer(const Alloc& alloc) noexcept;
+
+		// Constructs an empty buffer able to hold capacity elements
+		// With overflow_policy::overwrite the capacity must be at least 1
+		explicit dynamic_circular_buffer(size_type capacity, overflow_policy policy = overflow_policy::overwrite,
+			const Alloc& alloc = Alloc());
+
+		// Copy constructor
+		// The copy has the same capacity and policy, the allocator is obtained from
+		// select_on_container_copy_construction
+		dynamic_circular_buffer(const dynamic_circular_buffer& other);
+
+		// Move constructor
+		// The array is stolen along with the allocator leaving other with no capacity
+		dynamic_circular_buffer(dynamic_circular_buffer&& other) noexcept;
+
+		// ---------------
+		// OPERATOR=
+		// ---------------
+
+		// The allocator follows the propagate_on_container_copy_assignment and
+		// propagate_on_container_move_assignment traits. When it doesn't propagate and the
+		// allocators are unequal a move assignment moves the elements one by one
+		dynamic_circular_buffer& operator=(const dynamic_circular_buffer& rhs);
+		dynamic_circular_buffer& operator=(dynamic_circular_buffer&& rhs) noexcept(
+			std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+			std::allocator_traits<Alloc>::is_always_equal::value);
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+
+		// Destroys every element and returns the array to the allocator
+		~dynamic_circular_buffer();
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns a reference to the element at position n in the buffer
+		// with no range check
+		T& operator[](size_type n) noexcept;
+		const T& operator[](size_type n) const noexcept;
+
+		// Returns a reference to the element at position n in the buffer
+		// Function throws std::out_of_range if the input is not within range
+		T& at(size_type n);
+		const T& at(size_type n) const;
+
+		// Returns a reference to the first element in the buffer
+		T& front() noexcept;
+		const T& front() const noexcept;
+
+		// Returns a reference to the last element in the buffer
+		T& back() noexcept;
+		const T& back() const noexcept;
+
+		// The elements are stored in at most two contiguous runs of the array
+		// array_one() is the run starting at front(), array_two() is the wrapped around remainder
+		// which is empty unless the elements wrap past the end of the array
+		span<T> array_one() noexcept;
+		span<const T> array_one() const noexcept;
+		span<T> array_two() noexcept;
+		span<const T> array_two() const noexcept;
+
+		// The unused slots are the other at most two runs, starting after back()
+		// free_one() is the run up to the end of the array, free_two() the wrapped around remainder
+		// Together they hold capacity() - size() slots, to be written in place, e.g. by readv,
+		// and then appended with commit_back()
+		span<T> free_one() noexcept;
+		span<T> free_two() noexcept;
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+
+		template <bool isConst> struct myIterator;
+		using iterator = myIterator<false>;
+		using const_iterator = myIterator<true>;
+
+		// Returns an iterator to the first element of the container
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+
+		// Returns a reverse iterator to the first element of the reversed container
+		// Equivalent to the last element (not end) of the non-reversed container
+		iterator rbegin() noexcept;
+		const_iterator rbegin() const noexcept;
+
+		// Returns an iterator to the element following the last element of the container
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+
+		// Returns a reverse iterator to the element following the last element of the reversed container
+		// It corresponds to the element preceding the first element of the non-reversed container
+		iterator rend() noexcept;
+		const_iterator rend() const noexcept;
+
+		// Same model as circular_buffer::myIterator, an offset into the array and a distance from it
+		// The capacity is carried along since it is only known at runtime
+		template <bool isconst = false>
+		struct myIterator
+		{
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using reference = typename std::conditional_t< isconst, T const&, T& >;
+			using pointer = typename std::conditional_t< isconst, T const*, T* >;
+		private:
+			pointer		ptrToBuffer;
+			size_type	capacity;
+			size_type	offset;
+			size_type	index;
+			bool		reverse;
+
+		public:
+			myIterator() : ptrToBuffer(nullptr), capacity(0), offset(0), index(0), reverse(false) {}
+			// A non const iterator is implicitly convertible to a const iterator
+			template <bool otherConst, class = std::enable_if_t<isconst && !otherConst> >
+			myIterator(const myIterator<otherConst>& i) :
+				ptrToBuffer(i.ptrToBuffer),
+				capacity(i.capacity),
+				offset(i.offset),
+				index(i.index),
+				reverse(i.reverse) {}
+			reference operator*() const {
+				if (reverse)
+					return ptrToBuffer[dynamic_circular_buffer::wrap(capacity + offset - index, capacity)];
+				return ptrToBuffer[dynamic_circular_buffer::wrap(offset + index, capacity)];
+			}
+			reference operator[](difference_type n) const {
+				myIterator iter = *this;
+				iter.index += n;
+				return *iter;
+			}
+			pointer operator->() const { return &(operator *()); }
+
+			myIterator& operator++()
+			{
+				++index;
+				return *this;
+			}
+			myIterator operator++(int)
+			{
+				myIterator iter = *this;
+				++index;
+				return iter;
+			}
+			myIterator& operator--()
+			{
+				--index;
+				return *this;
+			}
+			myIterator operator--(int) {
+				myIterator iter = *this;
+				--index;
+				return iter;
+			}
+			friend myIterator operator+(myIterator lhs, difference_type rhs) {
+				lhs.index += rhs;
+				return lhs;
+			}
+			friend myIterator operator+(difference_type lhs, myIterator rhs) {
+				rhs.index += lhs;
+				return rhs;
+			}
+			myIterator& operator+=(difference_type n) {
+				index += n;
+				return *this;
+			}
+			friend myIterator operator-(myIterator lhs, difference_type rhs) {
+				lhs.index -= rhs;
+				return lhs;
+			}
+			friend difference_type operator-(const myIterator& lhs, const myIterator& rhs) {
+				return static_cast<difference_type>(lhs.index - rhs.index);
+			}
+			myIterator& operator-=(difference_type n) {
+				index -= n;
+				return *this;
+			}
+
+			// Iterators are only comparable with iterators of the same direction over the same buffer
+			friend bool operator==(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.reverse == rhs.reverse && lhs.index == rhs.index;
+			}
+			friend bool operator!=(const myIterator& lhs, const myIterator& rhs) {
+				return !(lhs == rhs);
+			}
+			friend bool operator<(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.index < rhs.index;
+			}
+			friend bool operator<=(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.index <= rhs.index;
+			}
+			friend bool operator>(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.index > rhs.index;
+			}
+			friend bool operator>=(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.index >= rhs.index;
+			}
+			friend class dynamic_circular_buffer;
+			friend struct myIterator<!isconst>;
+		};
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of elements in the buffer
+		size_type size() const noexcept;
+
+		// Returns whether the buffer is empty
+		// (i.e. whether its size is 0)
+		bool empty() const noexcept;
+
+		// Returns whether the next push would overwrite or grow
+		bool full() const noexcept;
+
+		// Return the maximum number of elements the buffer could ever hold
+		size_type max_size() const noexcept;
+
+		// Returns the amount of elements the buffer can hold before it overwrites or grows
+		size_type capacity() const noexcept;
+
+		// Returns what the buffer does once it is full
+		overflow_policy policy() const noexcept;
+
+		// Requests that the capacity be at least enough to contain n elements
+		// The elements are moved in order to the start of the new array
+		// If moving an element throws, the elements not yet moved are kept and the rest are lost
+		void reserve(size_type n);
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Adds a new element at the end of the buffer after its current last element
+		void push_back(const T& val);
+		void push_back(T&& val);
+
+		// Appends a new element to the end of the buffer.
+		// The arguments args... are forwarded to the constructor as std::forward<Args>(args)....
+		// With overflow_policy::overwrite args may refer to the element being overwritten, the new
+		// element is built before the oldest one is replaced
+		template <class... Args>
+		void emplace_back(Args&& ... args);
+
+		// Removes the first element in the buffer
+		void pop_front() noexcept;
+
+		// Removes every element from the buffer leaving it with a size of 0
+		// The capacity is left unchanged
+		void clear() noexcept;
+
+		// Adds n elements copied from src at the end of the buffer, as if by n calls to push_back
+		// Grows at most once. When overwriting only the last capacity() elements of src are kept
+		void push_back_n(const T* src, size_type n);
+
+		// Moves up to n elements from the front of the buffer into dest and removes them
+		// Returns the amount of elements moved, which is less than n if the buffer holds fewer
+		size_type pop_front_into(T* dest, size_type n);
+
+		// Appends the first n slots of free_one() followed by free_two(), once written in place
+		// Assumed n <= capacity() - size(). Only for trivially copyable types
+		void commit_back(size_type n) noexcept;
+
+		// Removes up to n elements from the front of the buffer without moving them anywhere
+		// Returns the amount of elements removed, which is less than n if the buffer holds fewer
+		size_type pop_front_n(size_type n) noexcept;
+
+		// Exchanges the content of the container by the content of x
+		// The allocators are only exchanged if propagate_on_container_swap is set
+		void swap(dynamic_circular_buffer& x);
+
+		// ---------------
+		// ALLOCATOR
+		// ---------------
+
+		// Returns a copy of the allocator object associated with the buffer
+		Alloc get_allocator() const noexcept;
+
+	private:
+		// Private functions
+
+		// Maps a position less than 2 * capacity onto an index into the array
+		// A compare instead of a modulo since the capacity isn't known at compile time
+		static constexpr size_type wrap(size_type n, size_type capacity) noexcept;
+
+		// Returns the index of the slot following the last element
+		size_type tail_slot() const noexcept;
+
+		// Grows the array to hold at least n elements and constructs a new element
+		// at the end from args before relocating, so args may refer to an element of the buffer
+		template <class... Args>
+		void grow_append(Args&& ... args);
+
+		// Relocates the elements in order to the start of dest, leaving the buffer with no elements
+		// If relocating throws the elements already relocated are destroyed, the ones which
+		// weren't are kept so the buffer remains valid
+		void relocate_into(T* dest);
+
+		// Destroys every element and returns the array to the allocator
+		void release() noexcept;
+
+		// Takes the array of other, leaving other with no capacity
+		// Assumed that this buffer holds no array
+		void steal(dynamic_circular_buffer& other) noexcept;
+
+		// Copies or moves every element of other to the start of the array
+		// Assumed that this buffer is empty and its capacity is at least other.size()
+		template <class Buffer>
+		void construct_from(Buffer&& other);
+
+		// Member variables
+
+		// Allocator object used to obtain the array
+		Alloc d_alloc;
+
+		// Array holding the buffer data, only the size() slots starting at d_head are constructed
+		T* d_data;
+
+		// Amount of slots in d_data
+		size_type d_capacity;
+
+		// Index which represents the oldest data to be overwritten
+		size_type d_head;
+
+		// Amount of elements written into the buffer
+		size_type d_size;
+
+		// What to do once the buffer is full
+		overflow_policy d_policy;
+	};
+
+	// IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	dynamic_circular_buffer<T, Alloc, Growth>::dynamic_circular_buffer() noexcept
+		: dynamic_circular_buffer(Alloc())
+	{
+
+	}
+
+	template <class T, class Alloc, class Growth>
+	dynamic_circular_buffer<T, Alloc, Growth>::dynamic_circular_buffer(const Alloc& alloc) noexcept
+		: d_alloc(alloc)
+		, d_data(nullptr)
+		, d_capacity(0)
+		, d_head(0)
+		, d_size(0)
+		, d_policy(overflow_policy::grow)
+	{
+
+	}
+
+	template <class T, class Alloc, class Growth>
+	dynamic_circular_buffer<T, Alloc, Growth>::dynamic_circular_buffer(size_type capacity, overflow_policy policy,
+		const Alloc& alloc)
+		: d_alloc(alloc)
+		, d_data(capacity ? d_alloc.allocate(capacity) : nullptr)
+		, d_capacity(capacity)
+		, d_head(0)
+		, d_size(0)
+		, d_policy(policy)
+	{
+
+	}
+
+	template <class T, class Alloc, class Growth>
+	dynamic_circular_buffer<T, Alloc, Growth>::dynamic_circular_buffer(const dynamic_circular_buffer& other)
+		: d_alloc(alloc_traits::select_on_container_copy_construction(other.d_alloc))
+		, d_data(other.d_capacity ? d_alloc.allocate(other.d_capacity) : nullptr)
+		, d_capacity(other.d_capacity)
+		, d_head(0)
+		, d_size(0)
+		, d_policy(other.d_policy)
+	{
+		try {
+			construct_from(other);
+		}
+		catch (...) {
+			release();
+			throw;
+		}
+	}
+
+	template <class T, class Alloc, class Growth>
+	dynamic_circular_buffer<T, Alloc, Growth>::dynamic_circular_buffer(dynamic_circular_buffer&& other) noexcept
+		: d_alloc(std::move(other.d_alloc))
+		, d_data(nullptr)
+		, d_capacity(0)
+		, d_head(0)
+		, d_size(0)
+		, d_policy(other.d_policy)
+	{
+		steal(other);
+	}
+
+	// ---------------
+	// OPERATOR=
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	dynamic_circular_buffer<T, Alloc, Growth>& dynamic_circular_buffer<T, Alloc, Growth>::operator=(const dynamic_circular_buffer& rhs)
+	{
+		if (this == &rhs) {
+			return *this;
+		}
+
+		clear();
+
+		// A different allocator or capacity needs a new array
+		bool same_alloc = true;
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+			same_alloc = d_alloc == rhs.d_alloc;
+		}
+		if (!same_alloc || d_capacity != rhs.d_capacity) {
+			release();
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+				d_alloc = rhs.d_alloc;
+			}
+			if (rhs.d_capacity) {
+				d_data = d_alloc.allocate(rhs.d_capacity);
+				d_capacity = rhs.d_capacity;
+			}
+		}
+
+		d_policy = rhs.d_policy;
+		construct_from(rhs);
+		return *this;
+	}
+
+	template <class T, class Alloc, class Growth>
+	dynamic_circular_buffer<T, Alloc, Growth>& dynamic_circular_buffer<T, Alloc, Growth>::operator=(dynamic_circular_buffer&& rhs) noexcept(
+		std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+		std::allocator_traits<Alloc>::is_always_equal::value)
+	{
+		if (this == &rhs) {
+			return *this;
+		}
+
+		d_policy = rhs.d_policy;
+		if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+			release();
+			d_alloc = std::move(rhs.d_alloc);
+			steal(rhs);
+		}
+		else {
+			if (d_alloc == rhs.d_alloc) {
+				release();
+				steal(rhs);
+			}
+			else {
+				// Can't adopt an array from another allocator, move the elements one by one
+				clear();
+				if (d_capacity < rhs.d_size) {
+					reserve(rhs.d_size);
+				}
+				construct_from(std::move(rhs));
+				rhs.clear();
+			}
+		}
+		return *this;
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	dynamic_circular_buffer<T, Alloc, Growth>::~dynamic_circular_buffer()
+	{
+		release();
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	T& dynamic_circular_buffer<T, Alloc, Growth>::operator[](size_type n) noexcept
+	{
+		return d_data[wrap(d_head + n, d_capacity)];
+	}
+
+	template <class T, class Alloc, class Growth>
+	const T& dynamic_circular_buffer<T, Alloc, Growth>::operator[](size_type n) const noexcept
+	{
+		return d_data[wrap(d_head + n, d_capacity)];
+	}
+
+	template <class T, class Alloc, class Growth>
+	T& dynamic_circular_buffer<T, Alloc, Growth>::at(size_type n)
+	{
+		if (n >= d_size) {
+			throw std::out_of_range("dynamic_circular_buffer::at - index out of range");
+		}
+		return this->operator[](n);
+	}
+
+	template <class T, class Alloc, class Growth>
+	const T& dynamic_circular_buffer<T, Alloc, Growth>::at(size_type n) const
+	{
+		if (n >= d_size) {
+			throw std::out_of_range("dynamic_circular_buffer::at - index out of range");
+		}
+		return this->operator[](n);
+	}
+
+	template <class T, class Alloc, class Growth>
+	T& dynamic_circular_buffer<T, Alloc, Growth>::front() noexcept
+	{
+		return d_data[d_head];
+	}
+
+	template <class T, class Alloc, class Growth>
+	const T& dynamic_circular_buffer<T, Alloc, Growth>::front() const noexcept
+	{
+		return d_data[d_head];
+	}
+
+	template <class T, class Alloc, class Growth>
+	T& dynamic_circular_buffer<T, Alloc, Growth>::back() noexcept
+	{
+		return this->operator[](d_size - 1);
+	}
+
+	template <class T, class Alloc, class Growth>
+	const T& dynamic_circular_buffer<T, Alloc, Growth>::back() const noexcept
+	{
+		return this->operator[](d_size - 1);
+	}
+
+	template <class T, class Alloc, class Growth>
+	span<T> dynamic_circular_buffer<T, Alloc, Growth>::array_one() noexcept
+	{
+		return span<T>(d_data + d_head, std::min(d_size, d_capacity - d_head));
+	}
+
+	template <class T, class Alloc, class Growth>
+	span<const T> dynamic_circular_buffer<T, Alloc, Growth>::array_one() const noexcept
+	{
+		return span<const T>(d_data + d_head, std::min(d_size, d_capacity - d_head));
+	}
+
+	template <class T, class Alloc, class Growth>
+	span<T> dynamic_circular_buffer<T, Alloc, Growth>::array_two() noexcept
+	{
+		return span<T>(d_data, d_size - array_one().size());
+	}
+
+	template <class T, class Alloc, class Growth>
+	span<const T> dynamic_circular_buffer<T, Alloc, Growth>::array_two() const noexcept
+	{
+		return span<const T>(d_data, d_size - array_one().size());
+	}
+
+	template <class T, class Alloc, class Growth>
+	span<T> dynamic_circular_buffer<T, Alloc, Growth>::free_one() noexcept
+	{
+		const size_type start = tail_slot();
+		return span<T>(d_data + start, std::min(d_capacity - d_size, d_capacity - start));
+	}
+
+	template <class T, class Alloc, class Growth>
+	span<T> dynamic_circular_buffer<T, Alloc, Growth>::free_two() noexcept
+	{
+		return span<T>(d_data, d_capacity - d_size - free_one().size());
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	typename dynamic_circular_buffer<T, Alloc, Growth>::iterator dynamic_circular_buffer<T, Alloc, Growth>::begin() noexcept
+	{
+		iterator iter;
+		iter.ptrToBuffer = d_data;
+		iter.capacity = d_capacity;
+		iter.offset = d_head;
+		iter.index = 0;
+		iter.reverse = false;
+		return iter;
+	}
+
+	template <class T, class Alloc, class Growth>
+	typename dynamic_circular_buffer<T, Alloc, Growth>::const_iterator dynamic_circular_buffer<T, Alloc, Growth>::begin() const noexcept
+	{
+		const_iterator iter;
+		iter.ptrToBuffer = d_data;
+		iter.capacity = d_capacity;
+		iter.offset = d_head;
+		iter.index = 0;
+		iter.reverse = false;
+		return iter;
+	}
+
+	template <class T, class Alloc, class Growth>
+	typename dynamic_circular_buffer<T, Alloc, Growth>::const_iterator dynamic_circular_buffer<T, Alloc, Growth>::cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	template <class T, class Alloc, class Growth>
+	typename dynamic_circular_buffer<T, Alloc, Growth>::iterator dynamic_circular_buffer<T, Alloc, Growth>::rbegin() noexcept
+	{
+		iterator iter = begin();
+		iter.offset = d_size ? wrap(d_head + d_size - 1, d_capacity) : d_head;
+		iter.reverse = true;
+		return iter;
+	}
+
+	template <class T, class Alloc, class Growth>
+	typename dynamic_circular_buffer<T, Alloc, Growth>::const_iterator dynamic_circular_buffer<T, Alloc, Growth>::rbegin() const noexcept
+	{
+		const_iterator iter = begin();
+		iter.offset = d_size ? wrap(d_head + d_size - 1, d_capacity) : d_head;
+		iter.reverse = true;
+		return iter;
+	}
+
+	template <class T, class Alloc, class Growth>
+	typename dynamic_circular_buffer<T, Alloc, Growth>::iterator dynamic_circular_buffer<T, Alloc, Growth>::end() noexcept
+	{
+		iterator iter = begin();
+		iter.index = d_size;
+		return iter;
+	}
+
+	template <class T, class Alloc, class Growth>
+	typename dynamic_circular_buffer<T, Alloc, Growth>::const_iterator dynamic_circular_buffer<T, Alloc, Growth>::end() const noexcept
+	{
+		const_iterator iter = begin();
+		iter.index = d_size;
+		return iter;
+	}
+
+	template <class T, class Alloc, class Growth>
+	typename dynamic_circular_buffer<T, Alloc, Growth>::const_iterator dynamic_circular_buffer<T, Alloc, Growth>::cend() const noexcept
+	{
+		return end();
+	}
+
+	template <class T, class Alloc, class Growth>
+	typename dynamic_circular_buffer<T, Alloc, Growth>::iterator dynamic_circular_buffer<T, Alloc, Growth>::rend() noexcept
+	{
+		iterator iter = rbegin();
+		iter.index = d_size;
+		return iter;
+	}
+
+	template <class T, class Alloc, class Growth>
+	typename dynamic_circular_buffer<T, Alloc, Growth>::const_iterator dynamic_circular_buffer<T, Alloc, Growth>::rend() const noexcept
+	{
+		const_iterator iter = rbegin();
+		iter.index = d_size;
+		return iter;
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	size_type dynamic_circular_buffer<T, Alloc, Growth>::size() const noexcept
+	{
+		return d_size;
+	}
+
+	template <class T, class Alloc, class Growth>
+	bool dynamic_circular_buffer<T, Alloc, Growth>::empty() const noexcept
+	{
+		return d_size == 0;
+	}
+
+	template <class T, class Alloc, class Growth>
+	bool dynamic_circular_buffer<T, Alloc, Growth>::full() const noexcept
+	{
+		return d_size == d_capacity;
+	}
+
+	template <class T, class Alloc, class Growth>
+	size_type dynamic_circular_buffer<T, Alloc, Growth>::max_size() const noexcept
+	{
+		return alloc_traits::max_size(d_alloc);
+	}
+
+	template <class T, class Alloc, class Growth>
+	size_type dynamic_circular_buffer<T, Alloc, Growth>::capacity() const noexcept
+	{
+		return d_capacity;
+	}
+
+	template <class T, class Alloc, class Growth>
+	overflow_policy dynamic_circular_buffer<T, Alloc, Growth>::policy() const noexcept
+	{
+		return d_policy;
+	}
+
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::reserve(size_type n)
+	{
+		if (n <= d_capacity) {
+			return;
+		}
+
+		T* new_data = d_alloc.allocate(n);
+		const size_type size = d_size;
+		try {
+			relocate_into(new_data);
+		}
+		catch (...) {
+			d_alloc.deallocate(new_data, n);
+			throw;
+		}
+
+		release();
+		d_data = new_data;
+		d_capacity = n;
+		d_size = size;
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::push_back(const T& val)
+	{
+		if (d_size == d_capacity && d_policy == overflow_policy::overwrite) {
+			// Overwrite the oldest element, assignment also copes with val being that element
+			d_data[d_head] = val;
+			d_head = wrap(d_head + 1, d_capacity);
+			return;
+		}
+
+		emplace_back(val);
+	}
+
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::push_back(T&& val)
+	{
+		if (d_size == d_capacity && d_policy == overflow_policy::overwrite) {
+			// Overwrite the oldest element, assignment also copes with val being that element
+			d_data[d_head] = std::move(val);
+			d_head = wrap(d_head + 1, d_capacity);
+			return;
+		}
+
+		emplace_back(std::move(val));
+	}
+
+	template <class T, class Alloc, class Growth>
+	template <class... Args>
+	void dynamic_circular_buffer<T, Alloc, Growth>::emplace_back(Args&& ... args)
+	{
+		if (d_size == d_capacity) {
+			if (d_policy == overflow_policy::grow) {
+				grow_append(std::forward<Args>(args)...);
+				return;
+			}
+
+			// Overwrite the oldest element, building the new one first as args may refer to it
+			T val(std::forward<Args>(args)...);
+			d_data[d_head] = std::move(val);
+			d_head = wrap(d_head + 1, d_capacity);
+			return;
+		}
+
+		alloc_traits::construct(d_alloc, d_data + tail_slot(), std::forward<Args>(args)...);
+		++d_size;
+	}
+
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::pop_front() noexcept
+	{
+		if (d_size != 0) {
+			alloc_traits::destroy(d_alloc, d_data + d_head);
+			d_head = wrap(d_head + 1, d_capacity);
+			--d_size;
+		}
+	}
+
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::clear() noexcept
+	{
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			for (size_type i = 0; i < d_size; ++i) {
+				alloc_traits::destroy(d_alloc, d_data + wrap(d_head + i, d_capacity));
+			}
+		}
+		d_head = 0;
+		d_size = 0;
+	}
+
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::push_back_n(const T* src, size_type n)
+	{
+		if (d_size + n > d_capacity) {
+			if (d_policy == overflow_policy::grow) {
+				reserve(std::max(Growth::grow(d_capacity, sizeof(T)), d_size + n));
+			}
+			else if (n > d_capacity) {
+				// Anything before the last capacity() elements would be overwritten anyway
+				src += n - d_capacity;
+				n = d_capacity;
+			}
+		}
+
+		// Free slots are filled first, after them the oldest elements are overwritten
+		const size_type start = tail_slot();
+		const size_type free = d_capacity - d_size;
+		if constexpr (std::is_trivially_copyable<T>::value) {
+			const size_type first = std::min(n, d_capacity - start);
+			std::copy_n(src, first, d_data + start);
+			std::copy_n(src + first, n - first, d_data);
+		}
+		else {
+			for (size_type i = 0; i < n; ++i) {
+				T* slot = d_data + wrap(start + i, d_capacity);
+				if (i < free) {
+					alloc_traits::construct(d_alloc, slot, src[i]);
+					++d_size;
+				}
+				else {
+					*slot = src[i];
+					d_head = wrap(d_head + 1, d_capacity);
+				}
+			}
+			return;
+		}
+
+		const size_type overwritten = n > free ? n - free : 0;
+		d_size += n - overwritten;
+		d_head = wrap(d_head + overwritten, d_capacity);
+	}
+
+	template <class T, class Alloc, class Growth>
+	size_type dynamic_circular_buffer<T, Alloc, Growth>::pop_front_into(T* dest, size_type n)
+	{
+		n = std::min(n, d_size);
+
+		// Read up to the end of the array then wrap around to its start
+		const size_type first = std::min(n, d_capacity - d_head);
+		std::copy_n(std::make_move_iterator(d_data + d_head), first, dest);
+		std::copy_n(std::make_move_iterator(d_data), n - first, dest + first);
+
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			for (size_type i = 0; i < n; ++i) {
+				alloc_traits::destroy(d_alloc, d_data + wrap(d_head + i, d_capacity));
+			}
+		}
+
+		d_head = d_size == n ? 0 : wrap(d_head + n, d_capacity);
+		d_size -= n;
+		return n;
+	}
+
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::commit_back(size_type n) noexcept
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "commit_back requires a trivially copyable type");
+		d_size += n;
+	}
+
+	template <class T, class Alloc, class Growth>
+	size_type dynamic_circular_buffer<T, Alloc, Growth>::pop_front_n(size_type n) noexcept
+	{
+		n = std::min(n, d_size);
+
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			for (size_type i = 0; i < n; ++i) {
+				alloc_traits::destroy(d_alloc, d_data + wrap(d_head + i, d_capacity));
+			}
+		}
+
+		// An emptied buffer starts over at the first slot so the free slots are a single run
+		d_head = d_size == n ? 0 : wrap(d_head + n, d_capacity);
+		d_size -= n;
+		return n;
+	}
+
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::swap(dynamic_circular_buffer& x)
+	{
+		if (this == &x) {
+			return;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_swap::value) {
+			using std::swap;
+			swap(d_alloc, x.d_alloc);
+		}
+		else if constexpr (!alloc_traits::is_always_equal::value) {
+			// Each array has to stay with the allocator it came from
+			if (!(d_alloc == x.d_alloc)) {
+				dynamic_circular_buffer tmp(std::move(x));
+				x = std::move(*this);
+				*this = std::move(tmp);
+				return;
+			}
+		}
+
+		std::swap(d_data, x.d_data);
+		std::swap(d_capacity, x.d_capacity);
+		std::swap(d_head, x.d_head);
+		std::swap(d_size, x.d_size);
+		std::swap(d_policy, x.d_policy);
+	}
+
+	// ---------------
+	// ALLOCATOR
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	Alloc dynamic_circular_buffer<T, Alloc, Growth>::get_allocator() const noexcept
+	{
+		return d_alloc;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	constexpr size_type dynamic_circular_buffer<T, Alloc, Growth>::wrap(size_type n, size_type capacity) noexcept
+	{
+		return n >= capacity ? n - capacity : n;
+	}
+
+	template <class T, class Alloc, class Growth>
+	size_type dynamic_circular_buffer<T, Alloc, Growth>::tail_slot() const noexcept
+	{
+		return wrap(d_head + d_size, d_capacity);
+	}
+
+	template <class T, class Alloc, class Growth>
+	template <class... Args>
+	void dynamic_circular_buffer<T, Alloc, Growth>::grow_append(Args&& ... args)
+	{
+		const size_type new_capacity = Growth::grow(d_capacity, sizeof(T));
+		T* new_data = d_alloc.allocate(new_capacity);
+
+		// Build the new element first, args may refer to an element about to be relocated
+		try {
+			alloc_traits::construct(d_alloc, new_data + d_size, std::forward<Args>(args)...);
+		}
+		catch (...) {
+			d_alloc.deallocate(new_data, new_capacity);
+			throw;
+		}
+
+		const size_type size = d_size;
+		try {
+			relocate_into(new_data);
+		}
+		catch (...) {
+			alloc_traits::destroy(d_alloc, new_data + size);
+			d_alloc.deallocate(new_data, new_capacity);
+			throw;
+		}
+
+		release();
+		d_data = new_data;
+		d_capacity = new_capacity;
+		d_size = size + 1;
+	}
+
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::relocate_into(T* dest)
+	{
+		const size_type first = std::min(d_size, d_capacity - d_head);
+		const size_type second = d_size - first;
+
+		relocate_n(d_alloc, d_data + d_head, first, dest);
+		try {
+			relocate_n(d_alloc, d_data, second, dest + first);
+		}
+		catch (...) {
+			// The first run is gone from the array, keep the second run which is still intact
+			for (size_type i = 0; i < first; ++i) {
+				alloc_traits::destroy(d_alloc, dest + i);
+			}
+			d_head = 0;
+			d_size = second;
+			throw;
+		}
+
+		d_head = 0;
+		d_size = 0;
+	}
+
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::release() noexcept
+	{
+		clear();
+		if (d_data) {
+			d_alloc.deallocate(d_data, d_capacity);
+			d_data = nullptr;
+			d_capacity = 0;
+		}
+	}
+
+	template <class T, class Alloc, class Growth>
+	void dynamic_circular_buffer<T, Alloc, Growth>::steal(dynamic_circular_buffer& other) noexcept
+	{
+		d_data = other.d_data;
+		d_capacity = other.d_capacity;
+		d_head = other.d_head;
+		d_size = other.d_size;
+
+		other.d_data = nullptr;
+		other.d_capacity = 0;
+		other.d_head = 0;
+		other.d_size = 0;
+	}
+
+	template <class T, class Alloc, class Growth>
+	template <class Buffer>
+	void dynamic_circular_buffer<T, Alloc, Growth>::construct_from(Buffer&& other)
+	{
+		for (size_type i = 0; i < other.d_size; ++i) {
+			if constexpr (std::is_lvalue_reference<Buffer>::value) {
+				alloc_traits::construct(d_alloc, d_data + i, other[i]);
+			}
+			else {
+				alloc_traits::construct(d_alloc, d_data + i, std::move(other[i]));
+			}
+			++d_size;
+		}
+	}
+
+	namespace pmr
+	{
+		// dynamic_circular_buffer using a polymorphic allocator, e.g. backed by a non_stl::monotonic_buffer
+		template <class T, class Growth = double_growth>
+		using dynamic_circular_buffer = non_stl::dynamic_circular_buffer<T, std::pmr::polymorphic_allocator<T>, Growth>;
+	}
+}
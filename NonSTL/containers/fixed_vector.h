@@ -0,0 +1,793 @@
+// fixed_vector.h
+// A non-stl header only implementation of a vector with a fixed inline capacity which shares the
+// interface of non_stl::vector.
+// Note, the standard is used for some components such as std::length_error and type traits
+
+/*
+ * A fixed_vector holds up to N elements inside the object itself and never allocates. Pushing past
+ * N throws std::length_error instead of growing.
+ * Elements which are default constructible and trivially destructible (ints, enums, pointers,
+ * std::string_view, structs of those) are kept in a value initialized T[N] array, the same way
+ * std::array stores them. Every member is then constexpr from C++17 on, so a table can be built by
+ * a constexpr function and stored in a constexpr variable, which the compiler places in .rodata.
+ * All N slots are live objects in this case, so constructing or copying one costs N elements.
+ * Any other T is kept in uninitialized storage as circular_buffer does, and is constructed and
+ * destroyed in place. Those instances are usable at run time only.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::min
+#include <initializer_list>	// std::initializer_list
+#include <iterator>			// std::reverse_iterator
+#include <new>				// placement new, std::launder
+#include <stdexcept>		// std::length_error, std::out_of_range
+#include <type_traits>		// std::enable_if_t, std::is_default_constructible, std::is_trivially_destructible
+#include <utility>			// std::forward, std::move
+
+#include "contiguous_iterator.h"	// non_stl::contiguous_iterator
+#include "debug.h"				// NON_STL_DEBUG_CHECK
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	namespace detail
+	{
+		// Element storage of a fixed_vector
+		// The primary template is a T[N] array in which every slot always holds a live object,
+		// so constructing an element is an assignment and destroying one does nothing
+		template <class T, size_type N, bool isArray =
+			std::is_default_constructible<T>::value &&
+			std::is_trivially_destructible<T>::value &&
+			std::is_move_assignable<T>::value>
+		struct fixed_vector_storage
+		{
+			constexpr T* data() noexcept { return _data; }
+			constexpr const T* data() const noexcept { return _data; }
+
+			template <class... Args>
+			constexpr void construct(size_type i, Args&& ... args)
+			{
+				_data[i] = T(std::forward<Args>(args)...);
+			}
+
+			constexpr void destroy(size_type /*i*/) noexcept {}
+
+			T _data[N]{};
+			size_type _size = 0;
+		};
+
+		// Uninitialized storage for every other T, only the first _size slots hold live objects
+		template <class T, size_type N>
+		struct fixed_vector_storage<T, N, false>
+		{
+			fixed_vector_storage() noexcept {}
+
+			fixed_vector_storage(const fixed_vector_storage& other)
+			{
+				construct_from(other.data(), other._size);
+			}
+
+			fixed_vector_storage(fixed_vector_storage&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+			{
+				construct_from(other.data(), other._size);
+			}
+
+			fixed_vector_storage& operator=(const fixed_vector_storage& other)
+			{
+				if (this != &other)
+				{
+					assign_from(other.data(), other._size);
+				}
+				return *this;
+			}
+
+			fixed_vector_storage& operator=(fixed_vector_storage&& other) noexcept(
+				std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value)
+			{
+				if (this != &other)
+				{
+					assign_from(other.data(), other._size);
+				}
+				return *this;
+			}
+
+			~fixed_vector_storage()
+			{
+				for (size_type i = 0; i < _size; ++i)
+				{
+					destroy(i);
+				}
+			}
+
+			T* data() noexcept { return std::launder(reinterpret_cast<T*>(_storage)); }
+			const T* data() const noexcept { return std::launder(reinterpret_cast<const T*>(_storage)); }
+
+			template <class... Args>
+			void construct(size_type i, Args&& ... args)
+			{
+				::new (static_cast<void*>(_storage + i * sizeof(T))) T(std::forward<Args>(args)...);
+			}
+
+			void destroy(size_type i) noexcept
+			{
+				data()[i].~T();
+			}
+
+			// Copies the n elements at src, or moves them when U is non const
+			// Assumed that the storage is empty
+			template <class U>
+			void construct_from(U* src, size_type n)
+			{
+				try
+				{
+					for (; _size < n; ++_size)
+					{
+						construct(_size, static_cast<U&&>(src[_size]));
+					}
+				}
+				catch (...)
+				{
+					// The destructor doesn't run for a partially constructed object
+					for (size_type i = 0; i < _size; ++i)
+					{
+						destroy(i);
+					}
+					throw;
+				}
+			}
+
+			// Assigns over the elements both sides hold and constructs or destroys the rest
+			template <class U>
+			void assign_from(U* src, size_type n)
+			{
+				const size_type common = std::min(_size, n);
+				for (size_type i = 0; i < common; ++i)
+				{
+					data()[i] = static_cast<U&&>(src[i]);
+				}
+
+				for (; _size > n; --_size)
+				{
+					destroy(_size - 1);
+				}
+				for (; _size < n; ++_size)
+				{
+					construct(_size, static_cast<U&&>(src[_size]));
+				}
+			}
+
+			alignas(T) unsigned char _storage[N * sizeof(T)];
+			size_type _size = 0;
+		};
+	}
+
+	// Template parameter T is the generic object being stored within the container
+	// size_type N is the maximum amount of elements which cannot be changed
+	template <class T, size_type N>
+	class fixed_vector
+	{
+		static_assert(N > 0, "fixed_vector requires a capacity of at least one element");
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor
+		// constexpr whenever the storage is, i.e. for the T[N] array
+		fixed_vector() = default;
+
+		// Fill constructor
+		// Constructs a fixed_vector with size elements
+		// Each element is a copy of val if provided
+		constexpr explicit fixed_vector(size_type size);
+		constexpr fixed_vector(size_type size, const T& val);
+
+		// Range constructor
+		template <class InputIterator, class = std::enable_if_t<!std::is_integral<InputIterator>::value> >
+		constexpr fixed_vector(InputIterator first, InputIterator last);
+
+		// Initializer list constructor
+		constexpr fixed_vector(std::initializer_list<T> init);
+
+		// Copy and move construct and assign element by element
+
+		// ---------------
+		// OPERATOR=
+		// ---------------
+		constexpr fixed_vector& operator=(std::initializer_list<T> init);
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns a reference to the element at position n with no range check
+		constexpr T& operator[](size_type n) noexcept;
+		constexpr const T& operator[](size_type n) const noexcept;
+
+		// Returns a reference to the element at position n
+		// Function throws an out of range exception if the input is not within range
+		constexpr T& at(size_type n);
+		constexpr const T& at(size_type n) const;
+
+		// Returns a reference to the first element
+		constexpr T& front() noexcept;
+		constexpr const T& front() const noexcept;
+
+		// Returns a reference to the last element
+		constexpr T& back() noexcept;
+		constexpr const T& back() const noexcept;
+
+		// Returns a direct pointer to the inline array
+		constexpr T* data() noexcept;
+		constexpr const T* data() const noexcept;
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+
+		// Iterators are thin wrappers around a pointer into the inline array, see contiguous_iterator.h
+		using iterator = contiguous_iterator<T>;
+		using const_iterator = contiguous_iterator<T, true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		constexpr iterator begin() noexcept;
+		constexpr const_iterator begin() const noexcept;
+		constexpr const_iterator cbegin() const noexcept;
+
+		constexpr iterator end() noexcept;
+		constexpr const_iterator end() const noexcept;
+		constexpr const_iterator cend() const noexcept;
+
+		constexpr reverse_iterator rbegin() noexcept;
+		constexpr const_reverse_iterator rbegin() const noexcept;
+		constexpr const_reverse_iterator crbegin() const noexcept;
+
+		constexpr reverse_iterator rend() noexcept;
+		constexpr const_reverse_iterator rend() const noexcept;
+		constexpr const_reverse_iterator crend() const noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of elements held
+		constexpr size_type size() const noexcept;
+
+		// Returns N, the capacity never changes
+		static constexpr size_type max_size() noexcept { return N; }
+		static constexpr size_type capacity() noexcept { return N; }
+
+		// Returns whether no elements are held
+		constexpr bool empty() const noexcept;
+
+		// Returns whether N elements are held and nothing more can be pushed
+		constexpr bool full() const noexcept;
+
+		// Resizes the container so that it contains n elements
+		// New elements are value initialized or set to val if it is provided
+		// Throws a length error if n is greater than N
+		constexpr void resize(size_type n);
+		constexpr void resize(size_type n, const T& val);
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Assign new contents, replacing the current contents
+		// Throws a length error if they exceed N, leaving the elements assigned so far
+		template <class InputIterator, class = std::enable_if_t<!std::is_integral<InputIterator>::value> >
+		constexpr void assign(InputIterator first, InputIterator last);
+		constexpr void assign(size_type n, const T& val);
+		constexpr void assign(std::initializer_list<T> il);
+
+		// Adds a new element after the current last element
+		// Throws a length error when the container is full
+		constexpr void push_back(const T& val);
+		constexpr void push_back(T&& val);
+
+		// Appends a new element constructed from args
+		// Throws a length error when the container is full
+		template <class... Args>
+		constexpr T& emplace_back(Args&& ... args);
+
+		// Removes the last element
+		constexpr void pop_back() noexcept;
+
+		// Inserts an element before position, shifting the elements after it up by one
+		// Throws a length error when the container is full
+		constexpr iterator insert(const_iterator position, const T& val);
+		constexpr iterator insert(const_iterator position, T&& val);
+
+		template <class... Args>
+		constexpr iterator emplace(const_iterator position, Args&& ... args);
+
+		// Removes the element at position, or the elements in [first, last)
+		// The elements after them are shifted down, returns an iterator to the element
+		// following the last one removed
+		constexpr iterator erase(const_iterator position);
+		constexpr iterator erase(const_iterator first, const_iterator last);
+
+		// Exchanges the elements with those of x
+		constexpr void swap(fixed_vector& x);
+
+		// Removes all elements leaving the container with a size of 0
+		constexpr void clear() noexcept;
+
+		// ---------------
+		// RELATIONAL OPERATORS
+		// ---------------
+		friend constexpr bool operator==(const fixed_vector& lhs, const fixed_vector& rhs)
+		{
+			if (lhs.size() != rhs.size())
+			{
+				return false;
+			}
+			for (size_type i = 0; i < lhs.size(); ++i)
+			{
+				if (!(lhs[i] == rhs[i]))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+		friend constexpr bool operator!=(const fixed_vector& lhs, const fixed_vector& rhs) { return !(lhs == rhs); }
+
+		// ---------------
+		// END INTERFACE
+		// ---------------
+	private:
+		// Private functions
+
+		// Throws a length error if n more elements don't fit
+		constexpr void check_capacity(size_type n) const;
+
+		// Member variables
+
+		// Inline elements and the amount of them which are held
+		detail::fixed_vector_storage<T, N> _storage;
+	};
+
+	// FIXED_VECTOR IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, size_type N>
+	constexpr fixed_vector<T, N>::fixed_vector(size_type size)
+	{
+		resize(size);
+	}
+
+	template <class T, size_type N>
+	constexpr fixed_vector<T, N>::fixed_vector(size_type size, const T& val)
+	{
+		resize(size, val);
+	}
+
+	template <class T, size_type N>
+	template <class InputIterator, class>
+	constexpr fixed_vector<T, N>::fixed_vector(InputIterator first, InputIterator last)
+	{
+		assign(first, last);
+	}
+
+	template <class T, size_type N>
+	constexpr fixed_vector<T, N>::fixed_vector(std::initializer_list<T> init)
+	{
+		assign(init);
+	}
+
+	// ---------------
+	// OPERATOR=
+	// ---------------
+	template <class T, size_type N>
+	constexpr fixed_vector<T, N>& fixed_vector<T, N>::operator=(std::initializer_list<T> init)
+	{
+		assign(init);
+		return *this;
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T, size_type N>
+	constexpr T& fixed_vector<T, N>::operator[](size_type n) noexcept
+	{
+		NON_STL_DEBUG_CHECK(n < _storage._size, "fixed_vector::operator[] - index out of range");
+		return _storage.data()[n];
+	}
+
+	template <class T, size_type N>
+	constexpr const T& fixed_vector<T, N>::operator[](size_type n) const noexcept
+	{
+		NON_STL_DEBUG_CHECK(n < _storage._size, "fixed_vector::operator[] - index out of range");
+		return _storage.data()[n];
+	}
+
+	template <class T, size_type N>
+	constexpr T& fixed_vector<T, N>::at(size_type n)
+	{
+		if (n >= _storage._size)
+		{
+			throw std::out_of_range("fixed_vector::at");
+		}
+		return _storage.data()[n];
+	}
+
+	template <class T, size_type N>
+	constexpr const T& fixed_vector<T, N>::at(size_type n) const
+	{
+		if (n >= _storage._size)
+		{
+			throw std::out_of_range("fixed_vector::at");
+		}
+		return _storage.data()[n];
+	}
+
+	template <class T, size_type N>
+	constexpr T& fixed_vector<T, N>::front() noexcept
+	{
+		NON_STL_DEBUG_CHECK(_storage._size != 0, "fixed_vector::front - vector is empty");
+		return _storage.data()[0];
+	}
+
+	template <class T, size_type N>
+	constexpr const T& fixed_vector<T, N>::front() const noexcept
+	{
+		NON_STL_DEBUG_CHECK(_storage._size != 0, "fixed_vector::front - vector is empty");
+		return _storage.data()[0];
+	}
+
+	template <class T, size_type N>
+	constexpr T& fixed_vector<T, N>::back() noexcept
+	{
+		NON_STL_DEBUG_CHECK(_storage._size != 0, "fixed_vector::back - vector is empty");
+		return _storage.data()[_storage._size - 1];
+	}
+
+	template <class T, size_type N>
+	constexpr const T& fixed_vector<T, N>::back() const noexcept
+	{
+		NON_STL_DEBUG_CHECK(_storage._size != 0, "fixed_vector::back - vector is empty");
+		return _storage.data()[_storage._size - 1];
+	}
+
+	template <class T, size_type N>
+	constexpr T* fixed_vector<T, N>::data() noexcept
+	{
+		return _storage.data();
+	}
+
+	template <class T, size_type N>
+	constexpr const T* fixed_vector<T, N>::data() const noexcept
+	{
+		return _storage.data();
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::iterator fixed_vector<T, N>::begin() noexcept
+	{
+		return iterator(_storage.data());
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::const_iterator fixed_vector<T, N>::begin() const noexcept
+	{
+		return const_iterator(_storage.data());
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::const_iterator fixed_vector<T, N>::cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::iterator fixed_vector<T, N>::end() noexcept
+	{
+		return iterator(_storage.data() + _storage._size);
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::const_iterator fixed_vector<T, N>::end() const noexcept
+	{
+		return const_iterator(_storage.data() + _storage._size);
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::const_iterator fixed_vector<T, N>::cend() const noexcept
+	{
+		return end();
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::reverse_iterator fixed_vector<T, N>::rbegin() noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::const_reverse_iterator fixed_vector<T, N>::rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::const_reverse_iterator fixed_vector<T, N>::crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::reverse_iterator fixed_vector<T, N>::rend() noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::const_reverse_iterator fixed_vector<T, N>::rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::const_reverse_iterator fixed_vector<T, N>::crend() const noexcept
+	{
+		return rend();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, size_type N>
+	constexpr size_type fixed_vector<T, N>::size() const noexcept
+	{
+		return _storage._size;
+	}
+
+	template <class T, size_type N>
+	constexpr bool fixed_vector<T, N>::empty() const noexcept
+	{
+		return _storage._size == 0;
+	}
+
+	template <class T, size_type N>
+	constexpr bool fixed_vector<T, N>::full() const noexcept
+	{
+		return _storage._size == N;
+	}
+
+	template <class T, size_type N>
+	constexpr void fixed_vector<T, N>::resize(size_type n)
+	{
+		if (n > N)
+		{
+			throw std::length_error("fixed_vector - size exceeds capacity");
+		}
+
+		for (; _storage._size > n; --_storage._size)
+		{
+			_storage.destroy(_storage._size - 1);
+		}
+		for (; _storage._size < n; ++_storage._size)
+		{
+			_storage.construct(_storage._size);
+		}
+	}
+
+	template <class T, size_type N>
+	constexpr void fixed_vector<T, N>::resize(size_type n, const T& val)
+	{
+		if (n > N)
+		{
+			throw std::length_error("fixed_vector - size exceeds capacity");
+		}
+
+		for (; _storage._size > n; --_storage._size)
+		{
+			_storage.destroy(_storage._size - 1);
+		}
+		for (; _storage._size < n; ++_storage._size)
+		{
+			_storage.construct(_storage._size, val);
+		}
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class T, size_type N>
+	template <class InputIterator, class>
+	constexpr void fixed_vector<T, N>::assign(InputIterator first, InputIterator last)
+	{
+		clear();
+		for (; first != last; ++first)
+		{
+			emplace_back(*first);
+		}
+	}
+
+	template <class T, size_type N>
+	constexpr void fixed_vector<T, N>::assign(size_type n, const T& val)
+	{
+		// Checked up front so a failed assign leaves the contents untouched
+		if (n > N)
+		{
+			throw std::length_error("fixed_vector - size exceeds capacity");
+		}
+
+		clear();
+		resize(n, val);
+	}
+
+	template <class T, size_type N>
+	constexpr void fixed_vector<T, N>::assign(std::initializer_list<T> il)
+	{
+		if (il.size() > N)
+		{
+			throw std::length_error("fixed_vector - size exceeds capacity");
+		}
+
+		assign(il.begin(), il.end());
+	}
+
+	template <class T, size_type N>
+	constexpr void fixed_vector<T, N>::push_back(const T& val)
+	{
+		emplace_back(val);
+	}
+
+	template <class T, size_type N>
+	constexpr void fixed_vector<T, N>::push_back(T&& val)
+	{
+		emplace_back(std::move(val));
+	}
+
+	template <class T, size_type N>
+	template <class... Args>
+	constexpr T& fixed_vector<T, N>::emplace_back(Args&& ... args)
+	{
+		check_capacity(1);
+		_storage.construct(_storage._size, std::forward<Args>(args)...);
+		return _storage.data()[_storage._size++];
+	}
+
+	template <class T, size_type N>
+	constexpr void fixed_vector<T, N>::pop_back() noexcept
+	{
+		NON_STL_DEBUG_CHECK(_storage._size != 0, "fixed_vector::pop_back - vector is empty");
+		_storage.destroy(--_storage._size);
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::iterator fixed_vector<T, N>::insert(const_iterator position, const T& val)
+	{
+		return emplace(position, val);
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::iterator fixed_vector<T, N>::insert(const_iterator position, T&& val)
+	{
+		return emplace(position, std::move(val));
+	}
+
+	template <class T, size_type N>
+	template <class... Args>
+	constexpr typename fixed_vector<T, N>::iterator fixed_vector<T, N>::emplace(const_iterator position, Args&& ... args)
+	{
+		const auto idx = (size_type)(position - cbegin());
+		check_capacity(1);
+
+		T* arr = _storage.data();
+		if (idx == _storage._size)
+		{
+			_storage.construct(idx, std::forward<Args>(args)...);
+			++_storage._size;
+			return iterator(arr + idx);
+		}
+
+		// Build the element before shifting as args may refer to an element of this vector
+		T tmp(std::forward<Args>(args)...);
+
+		// The last element moves into the free slot, the rest shift up by assignment
+		_storage.construct(_storage._size, std::move(arr[_storage._size - 1]));
+		++_storage._size;
+		for (size_type i = _storage._size - 2; i > idx; --i)
+		{
+			arr[i] = std::move(arr[i - 1]);
+		}
+		arr[idx] = std::move(tmp);
+
+		return iterator(arr + idx);
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::iterator fixed_vector<T, N>::erase(const_iterator position)
+	{
+		return erase(position, position + 1);
+	}
+
+	template <class T, size_type N>
+	constexpr typename fixed_vector<T, N>::iterator fixed_vector<T, N>::erase(const_iterator first, const_iterator last)
+	{
+		const auto idx = (size_type)(first - cbegin());
+		const auto n = (size_type)(last - first);
+
+		T* arr = _storage.data();
+		for (size_type i = idx; i + n < _storage._size; ++i)
+		{
+			arr[i] = std::move(arr[i + n]);
+		}
+		for (size_type i = 0; i < n; ++i)
+		{
+			pop_back();
+		}
+
+		return iterator(arr + idx);
+	}
+
+	template <class T, size_type N>
+	constexpr void fixed_vector<T, N>::swap(fixed_vector<T, N>& x)
+	{
+		if (this == &x)
+		{
+			return;
+		}
+
+		auto& shorter = size() < x.size() ? *this : x;
+		auto& longer = size() < x.size() ? x : *this;
+
+		for (size_type i = 0; i < shorter.size(); ++i)
+		{
+			T tmp(std::move(shorter[i]));
+			shorter[i] = std::move(longer[i]);
+			longer[i] = std::move(tmp);
+		}
+
+		// Move the surplus of the longer side over
+		const size_type common = shorter.size();
+		for (size_type i = common; i < longer.size(); ++i)
+		{
+			shorter._storage.construct(i, std::move(longer[i]));
+			++shorter._storage._size;
+		}
+		while (longer.size() > common)
+		{
+			longer.pop_back();
+		}
+	}
+
+	template <class T, size_type N>
+	constexpr void fixed_vector<T, N>::clear() noexcept
+	{
+		for (size_type i = 0; i < _storage._size; ++i)
+		{
+			_storage.destroy(i);
+		}
+		_storage._size = 0;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T, size_type N>
+	constexpr void fixed_vector<T, N>::check_capacity(size_type n) const
+	{
+		if (n > N - _storage._size)
+		{
+			throw std::length_error("fixed_vector - size exceeds capacity");
+		}
+	}
+}
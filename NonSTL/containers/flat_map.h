@@ -0,0 +1,984 @@
+// flat_map.h
+// A non-stl header only implementation of a sorted associative container in the spirit of
+// std::flat_map, keeping its keys and its values in two separate sorted arrays.
+// Note, the standard is used for some components such as std::less and exceptions
+
+/*
+ * A flat_map stores its keys in one non_stl::vector and the mapped values at the same positions in another
+ * (a structure of arrays), so lookups only touch the densely packed keys and a 10K entries table stays in
+ * the L1 / L2 caches instead of chasing the nodes of a tree.
+ * Lookups are O(log n) through the Search policy, see sorted_search.h, and iteration is in key order.
+ * Inserting or erasing a single entry is O(n) as the entries after it are shifted, so tables are best built
+ * in bulk: the range constructors and the range insert append everything first and sort once.
+ * Inserting or erasing invalidates every iterator, references and pointers to values are invalidated
+ * whenever the entries after them shift.
+ * Iterators dereference to a std::pair<const Key&, T&> proxy rather than a reference to a stored pair.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::stable_sort, std::inplace_merge, std::equal
+#include <functional>		// std::less
+#include <initializer_list>	// std::initializer_list
+#include <iterator>			// std::random_access_iterator_tag, std::reverse_iterator
+#include <numeric>			// std::iota
+#include <stdexcept>		// std::out_of_range, std::invalid_argument
+#include <type_traits>		// std::conditional_t, std::enable_if_t
+#include <utility>			// std::forward, std::move, std::pair, std::swap
+
+#include "sorted_search.h"	// non_stl::sorted_unique, non_stl::branchless_search, non_stl::branchless_upper_bound
+#include "vector.h"			// non_stl::vector
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter Key is the type of the keys, T the type of the mapped values
+	// Template parameter Compare orders the keys, lookups by other types than Key are
+	// enabled when it declares is_transparent
+	// Template parameter Search is the lookup policy, branchless_search or eytzinger_search
+	// Template parameters KeyContainer and MappedContainer are the random access containers holding
+	// the keys and the values
+	template <class Key, class T, class Compare = std::less<Key>, class Search = branchless_search,
+		class KeyContainer = vector<Key>, class MappedContainer = vector<T> >
+	class flat_map
+	{
+		// Enables the heterogeneous overloads when C is transparent
+		template <class C>
+		using transparent = typename C::is_transparent;
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = std::pair<Key, T>;
+		using key_compare = Compare;
+		using reference = std::pair<const Key&, T&>;
+		using const_reference = std::pair<const Key&, const T&>;
+		using key_container_type = KeyContainer;
+		using mapped_container_type = MappedContainer;
+
+		// Both containers, as handed out by extract
+		struct containers
+		{
+			KeyContainer keys;
+			MappedContainer values;
+		};
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Constructs an empty map
+		flat_map() = default;
+		explicit flat_map(const Compare& comp);
+
+		// Bulk constructors
+		// Takes over the containers, sorts them once by key and keeps the first of every equivalent key
+		// Throws std::invalid_argument if their sizes differ
+		flat_map(KeyContainer keys, MappedContainer values, const Compare& comp = Compare());
+
+		// Takes over containers already sorted and free of equivalent keys
+		flat_map(sorted_unique_t, KeyContainer keys, MappedContainer values, const Compare& comp = Compare());
+
+		// Range constructor
+		// Appends every pair of [first, last) then sorts once
+		template <class InputIterator>
+		flat_map(InputIterator first, InputIterator last, const Compare& comp = Compare());
+
+		// Initializer list constructor
+		flat_map(std::initializer_list<value_type> init, const Compare& comp = Compare());
+
+		// Copies and moves are those of the containers
+		flat_map(const flat_map& rhs) = default;
+		flat_map(flat_map&& rhs) = default;
+		flat_map& operator=(const flat_map& rhs) = default;
+		flat_map& operator=(flat_map&& rhs) = default;
+		flat_map& operator=(std::initializer_list<value_type> init);
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+
+		// Iterators walk the entries in key order
+		template <bool isConst> struct myIterator;
+		using iterator = myIterator<false>;
+		using const_iterator = myIterator<true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Returns an iterator to the entry with the smallest key
+		// If the container is empty, the returned iterator will be equal to end()
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+
+		// Returns an iterator to the element following the entry with the largest key
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+
+		reverse_iterator rbegin() noexcept;
+		const_reverse_iterator rbegin() const noexcept;
+		const_reverse_iterator crbegin() const noexcept;
+		reverse_iterator rend() noexcept;
+		const_reverse_iterator rend() const noexcept;
+		const_reverse_iterator crend() const noexcept;
+
+		// Random access iterator over both arrays at once
+		template <bool isconst = false>
+		struct myIterator
+		{
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = typename flat_map::value_type;
+			using difference_type = std::ptrdiff_t;
+			using reference = std::pair<const Key&, std::conditional_t< isconst, const T&, T& > >;
+
+			// operator-> returns the proxy by value, holding it until the member access is done
+			struct pointer
+			{
+				reference ref;
+				const reference* operator->() const { return &ref; }
+			};
+		private:
+			using mapped_pointer = std::conditional_t< isconst, const T*, T* >;
+
+			const Key*		key;
+			mapped_pointer	value;
+
+			myIterator(const Key* k, mapped_pointer v) : key(k), value(v) {}
+
+		public:
+			myIterator() : key(nullptr), value(nullptr) {}
+			// A non const iterator is implicitly convertible to a const iterator
+			template <bool otherConst, class = std::enable_if_t<isconst && !otherConst> >
+			myIterator(const myIterator<otherConst>& i) : key(i.key), value(i.value) {}
+
+			reference operator*() const { return reference(*key, *value); }
+			pointer operator->() const { return pointer{ operator *() }; }
+			reference operator[](difference_type n) const { return reference(key[n], value[n]); }
+
+			myIterator& operator++()
+			{
+				++key;
+				++value;
+				return *this;
+			}
+			myIterator operator++(int)
+			{
+				auto tmp = *this;
+				++(*this);
+				return tmp;
+			}
+			myIterator& operator--()
+			{
+				--key;
+				--value;
+				return *this;
+			}
+			myIterator operator--(int)
+			{
+				auto tmp = *this;
+				--(*this);
+				return tmp;
+			}
+			myIterator& operator+=(difference_type n)
+			{
+				key += n;
+				value += n;
+				return *this;
+			}
+			myIterator& operator-=(difference_type n)
+			{
+				return *this += -n;
+			}
+
+			friend myIterator operator+(myIterator lhs, difference_type rhs) { return lhs += rhs; }
+			friend myIterator operator+(difference_type lhs, myIterator rhs) { return rhs += lhs; }
+			friend myIterator operator-(myIterator lhs, difference_type rhs) { return lhs -= rhs; }
+			friend difference_type operator-(const myIterator& lhs, const myIterator& rhs) { return lhs.key - rhs.key; }
+
+			friend bool operator==(const myIterator& lhs, const myIterator& rhs) { return lhs.key == rhs.key; }
+			friend bool operator!=(const myIterator& lhs, const myIterator& rhs) { return lhs.key != rhs.key; }
+			friend bool operator<(const myIterator& lhs, const myIterator& rhs) { return lhs.key < rhs.key; }
+			friend bool operator<=(const myIterator& lhs, const myIterator& rhs) { return lhs.key <= rhs.key; }
+			friend bool operator>(const myIterator& lhs, const myIterator& rhs) { return lhs.key > rhs.key; }
+			friend bool operator>=(const myIterator& lhs, const myIterator& rhs) { return lhs.key >= rhs.key; }
+
+			friend class flat_map;
+			friend struct myIterator<!isconst>;
+		};
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of entries
+		size_type size() const noexcept;
+
+		// Returns whether the container is empty
+		// (i.e. whether its size is 0)
+		bool empty() const noexcept;
+
+		// Makes room for n entries in both containers
+		void reserve(size_type n);
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns the value mapped to key
+		// Throws std::out_of_range if there is none
+		T& at(const Key& key);
+		const T& at(const Key& key) const;
+
+		// Returns the value mapped to key, inserting a value initialized one if there is none
+		T& operator[](const Key& key);
+		T& operator[](Key&& key);
+
+		// Returns the sorted keys and the values at the same positions
+		const KeyContainer& keys() const noexcept;
+		const MappedContainer& values() const noexcept;
+
+		// ---------------
+		// LOOKUP
+		// ---------------
+
+		// Returns an iterator to the entry with key, or end() if there is none
+		iterator find(const Key& key);
+		const_iterator find(const Key& key) const;
+		template <class K, class C = Compare, class = transparent<C> >
+		iterator find(const K& key);
+		template <class K, class C = Compare, class = transparent<C> >
+		const_iterator find(const K& key) const;
+
+		size_type count(const Key& key) const;
+		template <class K, class C = Compare, class = transparent<C> >
+		size_type count(const K& key) const;
+
+		bool contains(const Key& key) const;
+		template <class K, class C = Compare, class = transparent<C> >
+		bool contains(const K& key) const;
+
+		// Returns an iterator to the first entry whose key is not ordered before key
+		iterator lower_bound(const Key& key);
+		const_iterator lower_bound(const Key& key) const;
+
+		// Returns an iterator to the first entry whose key is ordered after key
+		iterator upper_bound(const Key& key);
+		const_iterator upper_bound(const Key& key) const;
+
+		// Returns the range of entries equivalent to key, holding at most one entry
+		std::pair<iterator, iterator> equal_range(const Key& key);
+		std::pair<const_iterator, const_iterator> equal_range(const Key& key) const;
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Inserts value if there is no entry with an equivalent key
+		// Returns an iterator to the entry with the key and whether value was inserted
+		std::pair<iterator, bool> insert(const value_type& value);
+		std::pair<iterator, bool> insert(value_type&& value);
+
+		// Bulk insert
+		// Appends every pair of [first, last) then sorts and merges them in once, O(n + m log m)
+		// Existing entries win over equivalent keys of the range
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last);
+		void insert(std::initializer_list<value_type> il);
+
+		// Inserts obj for key, or assigns it to the value already mapped to key
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj);
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(Key&& key, M&& obj);
+
+		// Constructs a value_type from args and inserts it if its key isn't already present
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&& ... args);
+
+		// Only constructs the value from args if key isn't already present
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(const Key& key, Args&& ... args);
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(Key&& key, Args&& ... args);
+
+		// Removes the entry at position, or the entries in [first, last)
+		// Returns an iterator to the entry following the last one removed
+		iterator erase(const_iterator position);
+		iterator erase(const_iterator first, const_iterator last);
+
+		// Removes the entry with key, returns the amount of entries removed
+		size_type erase(const Key& key);
+
+		// Moves both containers out, leaving the map empty
+		containers extract();
+
+		// Takes over containers already sorted and free of equivalent keys
+		void replace(KeyContainer&& keys, MappedContainer&& values);
+
+		// Exchanges the content of the container with the content of x
+		void swap(flat_map& x);
+
+		// Removes every entry
+		void clear() noexcept;
+
+		// ---------------
+		// OBSERVERS
+		// ---------------
+		key_compare key_comp() const;
+
+		// ---------------
+		// RELATIONAL OPERATORS
+		// ---------------
+		friend bool operator==(const flat_map& lhs, const flat_map& rhs)
+		{
+			return lhs._keys.size() == rhs._keys.size() &&
+				std::equal(lhs._keys.begin(), lhs._keys.end(), rhs._keys.begin()) &&
+				std::equal(lhs._values.begin(), lhs._values.end(), rhs._values.begin());
+		}
+		friend bool operator!=(const flat_map& lhs, const flat_map& rhs) { return !(lhs == rhs); }
+
+		// ---------------
+		// END INTERFACE
+		// ---------------
+	private:
+		// Private functions
+
+		// Returns the position of the first key not ordered before key
+		template <class K>
+		size_type lower_index(const K& key) const;
+
+		// Returns the position of the entry with key, or size() if there is none
+		template <class K>
+		size_type find_index(const K& key) const;
+
+		// Inserts the entry at idx, the key being absent
+		template <class K, class... Args>
+		iterator insert_at(size_type idx, K&& key, Args&& ... args);
+
+		// Sorts the entries from sorted onwards and merges them into the sorted ones before,
+		// keeping the first of every equivalent key
+		void sort_from(size_type sorted);
+
+		// Rebuilds the Search index after the keys changed
+		void reindex();
+
+		iterator get_iterator(size_type n);
+		const_iterator get_iterator(size_type n) const;
+
+		// Member variables
+
+		// The sorted keys and the values at the same positions
+		KeyContainer _keys;
+		MappedContainer _values;
+
+		Compare _comp;
+
+		typename Search::template index<Key> _index;
+	};
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	void swap(flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>& lhs,
+		flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+	// FLAT MAP IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::flat_map(const Compare& comp) :
+		_comp(comp)
+	{
+
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::flat_map(KeyContainer keys, MappedContainer values, const Compare& comp) :
+		_keys(std::move(keys)),
+		_values(std::move(values)),
+		_comp(comp)
+	{
+		if (_keys.size() != _values.size())
+		{
+			throw std::invalid_argument("flat_map - keys and values differ in size");
+		}
+		sort_from(0);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::flat_map(sorted_unique_t, KeyContainer keys, MappedContainer values, const Compare& comp) :
+		_keys(std::move(keys)),
+		_values(std::move(values)),
+		_comp(comp)
+	{
+		if (_keys.size() != _values.size())
+		{
+			throw std::invalid_argument("flat_map - keys and values differ in size");
+		}
+		reindex();
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class InputIterator>
+	flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::flat_map(InputIterator first, InputIterator last, const Compare& comp) :
+		_comp(comp)
+	{
+		insert(first, last);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::flat_map(std::initializer_list<value_type> init, const Compare& comp) :
+		_comp(comp)
+	{
+		insert(init.begin(), init.end());
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>& flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::operator=(std::initializer_list<value_type> init)
+	{
+		clear();
+		insert(init.begin(), init.end());
+		return *this;
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::begin() noexcept
+	{
+		return get_iterator(0);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::begin() const noexcept
+	{
+		return get_iterator(0);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::end() noexcept
+	{
+		return get_iterator(_keys.size());
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::end() const noexcept
+	{
+		return get_iterator(_keys.size());
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::cend() const noexcept
+	{
+		return end();
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::reverse_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::rbegin() noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_reverse_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_reverse_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::reverse_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::rend() noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_reverse_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_reverse_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::crend() const noexcept
+	{
+		return rend();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline size_type flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::size() const noexcept
+	{
+		return _keys.size();
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline bool flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	void flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::reserve(size_type n)
+	{
+		_keys.reserve(n);
+		_values.reserve(n);
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	T& flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::at(const Key& key)
+	{
+		const auto idx = find_index(key);
+		if (idx == _keys.size())
+		{
+			throw std::out_of_range("flat_map::at - key not found");
+		}
+		return _values[idx];
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	const T& flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::at(const Key& key) const
+	{
+		const auto idx = find_index(key);
+		if (idx == _keys.size())
+		{
+			throw std::out_of_range("flat_map::at - key not found");
+		}
+		return _values[idx];
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	T& flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::operator[](const Key& key)
+	{
+		return try_emplace(key).first->second;
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	T& flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::operator[](Key&& key)
+	{
+		return try_emplace(std::move(key)).first->second;
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline const KeyContainer& flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::keys() const noexcept
+	{
+		return _keys;
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline const MappedContainer& flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::values() const noexcept
+	{
+		return _values;
+	}
+
+	// ---------------
+	// LOOKUP
+	// ---------------
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::find(const Key& key)
+	{
+		return get_iterator(find_index(key));
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::find(const Key& key) const
+	{
+		return get_iterator(find_index(key));
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class K, class C, class>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::find(const K& key)
+	{
+		return get_iterator(find_index(key));
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class K, class C, class>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::find(const K& key) const
+	{
+		return get_iterator(find_index(key));
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	size_type flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::count(const Key& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class K, class C, class>
+	size_type flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::count(const K& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	bool flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::contains(const Key& key) const
+	{
+		return find_index(key) != _keys.size();
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class K, class C, class>
+	bool flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::contains(const K& key) const
+	{
+		return find_index(key) != _keys.size();
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::lower_bound(const Key& key)
+	{
+		return get_iterator(lower_index(key));
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::lower_bound(const Key& key) const
+	{
+		return get_iterator(lower_index(key));
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::upper_bound(const Key& key)
+	{
+		return get_iterator(branchless_upper_bound(_keys.data(), _keys.size(), key, _comp));
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::upper_bound(const Key& key) const
+	{
+		return get_iterator(branchless_upper_bound(_keys.data(), _keys.size(), key, _comp));
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	std::pair<typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator, typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator>
+		flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::equal_range(const Key& key)
+	{
+		const auto idx = lower_index(key);
+		const auto found = idx != _keys.size() && !_comp(key, _keys[idx]);
+		return { get_iterator(idx), get_iterator(found ? idx + 1 : idx) };
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	std::pair<typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator, typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator>
+		flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::equal_range(const Key& key) const
+	{
+		const auto idx = lower_index(key);
+		const auto found = idx != _keys.size() && !_comp(key, _keys[idx]);
+		return { get_iterator(idx), get_iterator(found ? idx + 1 : idx) };
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	std::pair<typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator, bool> flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::insert(const value_type& value)
+	{
+		return try_emplace(value.first, value.second);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	std::pair<typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator, bool> flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::insert(value_type&& value)
+	{
+		return try_emplace(std::move(value.first), std::move(value.second));
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class InputIterator>
+	void flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::insert(InputIterator first, InputIterator last)
+	{
+		const auto sorted = _keys.size();
+		try
+		{
+			for (; first != last; ++first)
+			{
+				const value_type& value = *first;
+				_keys.push_back(value.first);
+				try
+				{
+					_values.push_back(value.second);
+				}
+				catch (...)
+				{
+					_keys.pop_back();
+					throw;
+				}
+			}
+		}
+		catch (...)
+		{
+			// Drop the partially appended range, the sorted entries are untouched
+			_keys.erase(_keys.begin() + sorted, _keys.end());
+			_values.erase(_values.begin() + sorted, _values.end());
+			throw;
+		}
+
+		sort_from(sorted);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	void flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::insert(std::initializer_list<value_type> il)
+	{
+		insert(il.begin(), il.end());
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class M>
+	std::pair<typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator, bool> flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::insert_or_assign(const Key& key, M&& obj)
+	{
+		const auto idx = lower_index(key);
+		if (idx != _keys.size() && !_comp(key, _keys[idx]))
+		{
+			_values[idx] = std::forward<M>(obj);
+			return { get_iterator(idx), false };
+		}
+		return { insert_at(idx, key, std::forward<M>(obj)), true };
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class M>
+	std::pair<typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator, bool> flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::insert_or_assign(Key&& key, M&& obj)
+	{
+		const auto idx = lower_index(key);
+		if (idx != _keys.size() && !_comp(key, _keys[idx]))
+		{
+			_values[idx] = std::forward<M>(obj);
+			return { get_iterator(idx), false };
+		}
+		return { insert_at(idx, std::move(key), std::forward<M>(obj)), true };
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class... Args>
+	std::pair<typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator, bool> flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::emplace(Args&& ... args)
+	{
+		value_type value(std::forward<Args>(args)...);
+		return try_emplace(std::move(value.first), std::move(value.second));
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class... Args>
+	std::pair<typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator, bool> flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::try_emplace(const Key& key, Args&& ... args)
+	{
+		const auto idx = lower_index(key);
+		if (idx != _keys.size() && !_comp(key, _keys[idx]))
+		{
+			return { get_iterator(idx), false };
+		}
+		return { insert_at(idx, key, std::forward<Args>(args)...), true };
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class... Args>
+	std::pair<typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator, bool> flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::try_emplace(Key&& key, Args&& ... args)
+	{
+		const auto idx = lower_index(key);
+		if (idx != _keys.size() && !_comp(key, _keys[idx]))
+		{
+			return { get_iterator(idx), false };
+		}
+		return { insert_at(idx, std::move(key), std::forward<Args>(args)...), true };
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::erase(const_iterator position)
+	{
+		return erase(position, position + 1);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::erase(const_iterator first, const_iterator last)
+	{
+		const auto idx = static_cast<size_type>(first - cbegin());
+		const auto n = static_cast<size_type>(last - first);
+
+		_keys.erase(_keys.begin() + idx, _keys.begin() + idx + n);
+		_values.erase(_values.begin() + idx, _values.begin() + idx + n);
+		reindex();
+
+		return get_iterator(idx);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	size_type flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::erase(const Key& key)
+	{
+		const auto idx = find_index(key);
+		if (idx == _keys.size())
+		{
+			return 0;
+		}
+
+		erase(get_iterator(idx));
+		return 1;
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::containers flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::extract()
+	{
+		containers result{ std::move(_keys), std::move(_values) };
+		clear();
+		return result;
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	void flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::replace(KeyContainer&& keys, MappedContainer&& values)
+	{
+		if (keys.size() != values.size())
+		{
+			throw std::invalid_argument("flat_map::replace - keys and values differ in size");
+		}
+		_keys = std::move(keys);
+		_values = std::move(values);
+		reindex();
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	void flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::swap(flat_map& x)
+	{
+		using std::swap;
+		swap(_keys, x._keys);
+		swap(_values, x._values);
+		swap(_comp, x._comp);
+		swap(_index, x._index);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	void flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::clear() noexcept
+	{
+		_keys.clear();
+		_values.clear();
+		_index.build(_keys.data(), 0);
+	}
+
+	// ---------------
+	// OBSERVERS
+	// ---------------
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::key_compare flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::key_comp() const
+	{
+		return _comp;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class K>
+	inline size_type flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::lower_index(const K& key) const
+	{
+		return _index.lower_bound(_keys.data(), _keys.size(), key, _comp);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class K>
+	inline size_type flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::find_index(const K& key) const
+	{
+		const auto idx = lower_index(key);
+		return idx != _keys.size() && !_comp(key, _keys[idx]) ? idx : _keys.size();
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	template <class K, class... Args>
+	typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::insert_at(size_type idx, K&& key, Args&& ... args)
+	{
+		_keys.insert(_keys.begin() + idx, Key(std::forward<K>(key)));
+		try
+		{
+			_values.insert(_values.begin() + idx, T(std::forward<Args>(args)...));
+		}
+		catch (...)
+		{
+			_keys.erase(_keys.begin() + idx);
+			throw;
+		}
+		reindex();
+
+		return get_iterator(idx);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	void flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::sort_from(size_type sorted)
+	{
+		const auto n = _keys.size();
+
+		// Appending keys in order which all sort after the existing ones needs no sort at all
+		bool in_order = sorted == 0 || sorted == n || _comp(_keys[sorted - 1], _keys[sorted]);
+		for (size_type i = sorted + 1; in_order && i < n; ++i)
+		{
+			in_order = _comp(_keys[i - 1], _keys[i]);
+		}
+		if (in_order)
+		{
+			reindex();
+			return;
+		}
+
+		// Sort positions rather than the entries so both containers are permuted together
+		// The stable sort and merge keep equivalent keys in order, existing entries first
+		vector<size_type> order(n);
+		std::iota(order.begin(), order.end(), size_type(0));
+		auto by_key = [this](size_type lhs, size_type rhs) { return _comp(_keys[lhs], _keys[rhs]); };
+		std::stable_sort(order.begin() + sorted, order.end(), by_key);
+		std::inplace_merge(order.begin(), order.begin() + sorted, order.end(), by_key);
+
+		KeyContainer keys;
+		MappedContainer values;
+		keys.reserve(n);
+		values.reserve(n);
+		for (auto i : order)
+		{
+			if (keys.empty() || _comp(keys.back(), _keys[i]))
+			{
+				keys.push_back(std::move(_keys[i]));
+				values.push_back(std::move(_values[i]));
+			}
+		}
+
+		_keys = std::move(keys);
+		_values = std::move(values);
+		reindex();
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline void flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::reindex()
+	{
+		_index.build(_keys.data(), _keys.size());
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::get_iterator(size_type n)
+	{
+		return iterator(_keys.data() + n, _values.data() + n);
+	}
+
+	template <class Key, class T, class Compare, class Search, class KeyContainer, class MappedContainer>
+	inline typename flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::const_iterator flat_map<Key, T, Compare, Search, KeyContainer, MappedContainer>::get_iterator(size_type n) const
+	{
+		return const_iterator(_keys.data() + n, _values.data() + n);
+	}
+}
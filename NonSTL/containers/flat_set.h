@@ -0,0 +1,638 @@
+// flat_set.h
+// A non-stl header only implementation of a sorted set in the spirit of std::flat_set,
+// keeping its keys in a single sorted array.
+// Note, the standard is used for some components such as std::less and exceptions
+
+/*
+ * A flat_set stores its keys sorted in one non_stl::vector, lookups are O(log n) through the Search policy,
+ * see sorted_search.h, and iteration is in key order.
+ * Inserting or erasing a single key is O(n) as the keys after it are shifted, so sets are best built
+ * in bulk: the range constructors and the range insert append everything first and sort once.
+ * Inserting or erasing invalidates every iterator.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::stable_sort, std::inplace_merge, std::unique, std::equal
+#include <functional>		// std::less
+#include <initializer_list>	// std::initializer_list
+#include <iterator>			// std::reverse_iterator
+#include <utility>			// std::forward, std::move, std::pair, std::swap
+
+#include "contiguous_iterator.h"	// non_stl::contiguous_iterator
+#include "sorted_search.h"	// non_stl::sorted_unique, non_stl::branchless_search, non_stl::branchless_upper_bound
+#include "vector.h"			// non_stl::vector
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter Key is the type of the keys
+	// Template parameter Compare orders the keys, lookups by other types than Key are
+	// enabled when it declares is_transparent
+	// Template parameter Search is the lookup policy, branchless_search or eytzinger_search
+	// Template parameter KeyContainer is the contiguous container holding the keys
+	template <class Key, class Compare = std::less<Key>, class Search = branchless_search, class KeyContainer = vector<Key> >
+	class flat_set
+	{
+		// Enables the heterogeneous overloads when C is transparent
+		template <class C>
+		using transparent = typename C::is_transparent;
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		using key_type = Key;
+		using value_type = Key;
+		using key_compare = Compare;
+		using value_compare = Compare;
+		using reference = Key&;
+		using const_reference = const Key&;
+		using container_type = KeyContainer;
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Constructs an empty set
+		flat_set() = default;
+		explicit flat_set(const Compare& comp);
+
+		// Bulk constructors
+		// Takes over the container, sorts it once and keeps the first of every equivalent key
+		explicit flat_set(KeyContainer keys, const Compare& comp = Compare());
+
+		// Takes over a container already sorted and free of equivalent keys
+		flat_set(sorted_unique_t, KeyContainer keys, const Compare& comp = Compare());
+
+		// Range constructor
+		// Appends every key of [first, last) then sorts once
+		template <class InputIterator>
+		flat_set(InputIterator first, InputIterator last, const Compare& comp = Compare());
+
+		// Initializer list constructor
+		flat_set(std::initializer_list<Key> init, const Compare& comp = Compare());
+
+		// Copies and moves are those of the container
+		flat_set(const flat_set& rhs) = default;
+		flat_set(flat_set&& rhs) = default;
+		flat_set& operator=(const flat_set& rhs) = default;
+		flat_set& operator=(flat_set&& rhs) = default;
+		flat_set& operator=(std::initializer_list<Key> init);
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+
+		// Iterators walk the keys in order, keys can't be modified through them
+		using iterator = contiguous_iterator<Key, true>;
+		using const_iterator = contiguous_iterator<Key, true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Returns an iterator to the smallest key
+		// If the container is empty, the returned iterator will be equal to end()
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+
+		// Returns an iterator to the element following the largest key
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+
+		const_reverse_iterator rbegin() const noexcept;
+		const_reverse_iterator crbegin() const noexcept;
+		const_reverse_iterator rend() const noexcept;
+		const_reverse_iterator crend() const noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of keys
+		size_type size() const noexcept;
+
+		// Returns whether the container is empty
+		// (i.e. whether its size is 0)
+		bool empty() const noexcept;
+
+		// Makes room for n keys
+		void reserve(size_type n);
+
+		// Returns the sorted keys
+		const KeyContainer& keys() const noexcept;
+
+		// ---------------
+		// LOOKUP
+		// ---------------
+
+		// Returns an iterator to key, or end() if it isn't present
+		const_iterator find(const Key& key) const;
+		template <class K, class C = Compare, class = transparent<C> >
+		const_iterator find(const K& key) const;
+
+		size_type count(const Key& key) const;
+		template <class K, class C = Compare, class = transparent<C> >
+		size_type count(const K& key) const;
+
+		bool contains(const Key& key) const;
+		template <class K, class C = Compare, class = transparent<C> >
+		bool contains(const K& key) const;
+
+		// Returns an iterator to the first key not ordered before key
+		const_iterator lower_bound(const Key& key) const;
+
+		// Returns an iterator to the first key ordered after key
+		const_iterator upper_bound(const Key& key) const;
+
+		// Returns the range of keys equivalent to key, holding at most one key
+		std::pair<const_iterator, const_iterator> equal_range(const Key& key) const;
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Inserts key if there is no equivalent key
+		// Returns an iterator to the key and whether it was inserted
+		std::pair<iterator, bool> insert(const Key& key);
+		std::pair<iterator, bool> insert(Key&& key);
+
+		// Bulk insert
+		// Appends every key of [first, last) then sorts and merges them in once, O(n + m log m)
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last);
+		void insert(std::initializer_list<Key> il);
+
+		// Constructs a key from args and inserts it if there is no equivalent key
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&& ... args);
+
+		// Removes the key at position, or the keys in [first, last)
+		// Returns an iterator to the key following the last one removed
+		iterator erase(const_iterator position);
+		iterator erase(const_iterator first, const_iterator last);
+
+		// Removes key, returns the amount of keys removed
+		size_type erase(const Key& key);
+
+		// Moves the container out, leaving the set empty
+		KeyContainer extract();
+
+		// Takes over a container already sorted and free of equivalent keys
+		void replace(KeyContainer&& keys);
+
+		// Exchanges the content of the container with the content of x
+		void swap(flat_set& x);
+
+		// Removes every key
+		void clear() noexcept;
+
+		// ---------------
+		// OBSERVERS
+		// ---------------
+		key_compare key_comp() const;
+		value_compare value_comp() const;
+
+		// ---------------
+		// RELATIONAL OPERATORS
+		// ---------------
+		friend bool operator==(const flat_set& lhs, const flat_set& rhs)
+		{
+			return lhs._keys.size() == rhs._keys.size() &&
+				std::equal(lhs._keys.begin(), lhs._keys.end(), rhs._keys.begin());
+		}
+		friend bool operator!=(const flat_set& lhs, const flat_set& rhs) { return !(lhs == rhs); }
+
+		// ---------------
+		// END INTERFACE
+		// ---------------
+	private:
+		// Private functions
+
+		// Returns the position of the first key not ordered before key
+		template <class K>
+		size_type lower_index(const K& key) const;
+
+		// Returns the position of key, or size() if it isn't present
+		template <class K>
+		size_type find_index(const K& key) const;
+
+		// Inserts key in order if there is no equivalent key
+		std::pair<iterator, bool> insert_unique(Key&& key);
+
+		// Sorts the keys from sorted onwards and merges them into the sorted ones before,
+		// keeping the first of every equivalent key
+		void sort_from(size_type sorted);
+
+		// Rebuilds the Search index after the keys changed
+		void reindex();
+
+		const_iterator get_iterator(size_type n) const;
+
+		// Member variables
+
+		// The sorted keys
+		KeyContainer _keys;
+
+		Compare _comp;
+
+		typename Search::template index<Key> _index;
+	};
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	void swap(flat_set<Key, Compare, Search, KeyContainer>& lhs, flat_set<Key, Compare, Search, KeyContainer>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+	// FLAT SET IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class Key, class Compare, class Search, class KeyContainer>
+	flat_set<Key, Compare, Search, KeyContainer>::flat_set(const Compare& comp) :
+		_comp(comp)
+	{
+
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	flat_set<Key, Compare, Search, KeyContainer>::flat_set(KeyContainer keys, const Compare& comp) :
+		_keys(std::move(keys)),
+		_comp(comp)
+	{
+		sort_from(0);
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	flat_set<Key, Compare, Search, KeyContainer>::flat_set(sorted_unique_t, KeyContainer keys, const Compare& comp) :
+		_keys(std::move(keys)),
+		_comp(comp)
+	{
+		reindex();
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	template <class InputIterator>
+	flat_set<Key, Compare, Search, KeyContainer>::flat_set(InputIterator first, InputIterator last, const Compare& comp) :
+		_comp(comp)
+	{
+		insert(first, last);
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	flat_set<Key, Compare, Search, KeyContainer>::flat_set(std::initializer_list<Key> init, const Compare& comp) :
+		_comp(comp)
+	{
+		insert(init.begin(), init.end());
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	flat_set<Key, Compare, Search, KeyContainer>& flat_set<Key, Compare, Search, KeyContainer>::operator=(std::initializer_list<Key> init)
+	{
+		clear();
+		insert(init.begin(), init.end());
+		return *this;
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator flat_set<Key, Compare, Search, KeyContainer>::begin() const noexcept
+	{
+		return get_iterator(0);
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator flat_set<Key, Compare, Search, KeyContainer>::cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator flat_set<Key, Compare, Search, KeyContainer>::end() const noexcept
+	{
+		return get_iterator(_keys.size());
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator flat_set<Key, Compare, Search, KeyContainer>::cend() const noexcept
+	{
+		return end();
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::const_reverse_iterator flat_set<Key, Compare, Search, KeyContainer>::rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::const_reverse_iterator flat_set<Key, Compare, Search, KeyContainer>::crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::const_reverse_iterator flat_set<Key, Compare, Search, KeyContainer>::rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::const_reverse_iterator flat_set<Key, Compare, Search, KeyContainer>::crend() const noexcept
+	{
+		return rend();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline size_type flat_set<Key, Compare, Search, KeyContainer>::size() const noexcept
+	{
+		return _keys.size();
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline bool flat_set<Key, Compare, Search, KeyContainer>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	void flat_set<Key, Compare, Search, KeyContainer>::reserve(size_type n)
+	{
+		_keys.reserve(n);
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline const KeyContainer& flat_set<Key, Compare, Search, KeyContainer>::keys() const noexcept
+	{
+		return _keys;
+	}
+
+	// ---------------
+	// LOOKUP
+	// ---------------
+	template <class Key, class Compare, class Search, class KeyContainer>
+	typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator flat_set<Key, Compare, Search, KeyContainer>::find(const Key& key) const
+	{
+		return get_iterator(find_index(key));
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	template <class K, class C, class>
+	typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator flat_set<Key, Compare, Search, KeyContainer>::find(const K& key) const
+	{
+		return get_iterator(find_index(key));
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	size_type flat_set<Key, Compare, Search, KeyContainer>::count(const Key& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	template <class K, class C, class>
+	size_type flat_set<Key, Compare, Search, KeyContainer>::count(const K& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	bool flat_set<Key, Compare, Search, KeyContainer>::contains(const Key& key) const
+	{
+		return find_index(key) != _keys.size();
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	template <class K, class C, class>
+	bool flat_set<Key, Compare, Search, KeyContainer>::contains(const K& key) const
+	{
+		return find_index(key) != _keys.size();
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator flat_set<Key, Compare, Search, KeyContainer>::lower_bound(const Key& key) const
+	{
+		return get_iterator(lower_index(key));
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator flat_set<Key, Compare, Search, KeyContainer>::upper_bound(const Key& key) const
+	{
+		return get_iterator(branchless_upper_bound(_keys.data(), _keys.size(), key, _comp));
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	std::pair<typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator, typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator>
+		flat_set<Key, Compare, Search, KeyContainer>::equal_range(const Key& key) const
+	{
+		const auto idx = lower_index(key);
+		const auto found = idx != _keys.size() && !_comp(key, _keys[idx]);
+		return { get_iterator(idx), get_iterator(found ? idx + 1 : idx) };
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class Key, class Compare, class Search, class KeyContainer>
+	std::pair<typename flat_set<Key, Compare, Search, KeyContainer>::iterator, bool> flat_set<Key, Compare, Search, KeyContainer>::insert(const Key& key)
+	{
+		return insert_unique(Key(key));
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	std::pair<typename flat_set<Key, Compare, Search, KeyContainer>::iterator, bool> flat_set<Key, Compare, Search, KeyContainer>::insert(Key&& key)
+	{
+		return insert_unique(std::move(key));
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	template <class InputIterator>
+	void flat_set<Key, Compare, Search, KeyContainer>::insert(InputIterator first, InputIterator last)
+	{
+		const auto sorted = _keys.size();
+		try
+		{
+			for (; first != last; ++first)
+			{
+				_keys.push_back(*first);
+			}
+		}
+		catch (...)
+		{
+			// Drop the partially appended range, the sorted keys are untouched
+			_keys.erase(_keys.begin() + sorted, _keys.end());
+			throw;
+		}
+
+		sort_from(sorted);
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	void flat_set<Key, Compare, Search, KeyContainer>::insert(std::initializer_list<Key> il)
+	{
+		insert(il.begin(), il.end());
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	template <class... Args>
+	std::pair<typename flat_set<Key, Compare, Search, KeyContainer>::iterator, bool> flat_set<Key, Compare, Search, KeyContainer>::emplace(Args&& ... args)
+	{
+		return insert_unique(Key(std::forward<Args>(args)...));
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	typename flat_set<Key, Compare, Search, KeyContainer>::iterator flat_set<Key, Compare, Search, KeyContainer>::erase(const_iterator position)
+	{
+		return erase(position, position + 1);
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	typename flat_set<Key, Compare, Search, KeyContainer>::iterator flat_set<Key, Compare, Search, KeyContainer>::erase(const_iterator first, const_iterator last)
+	{
+		const auto idx = static_cast<size_type>(first - cbegin());
+		const auto n = static_cast<size_type>(last - first);
+
+		_keys.erase(_keys.begin() + idx, _keys.begin() + idx + n);
+		reindex();
+
+		return get_iterator(idx);
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	size_type flat_set<Key, Compare, Search, KeyContainer>::erase(const Key& key)
+	{
+		const auto idx = find_index(key);
+		if (idx == _keys.size())
+		{
+			return 0;
+		}
+
+		erase(get_iterator(idx));
+		return 1;
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	KeyContainer flat_set<Key, Compare, Search, KeyContainer>::extract()
+	{
+		KeyContainer result(std::move(_keys));
+		clear();
+		return result;
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	void flat_set<Key, Compare, Search, KeyContainer>::replace(KeyContainer&& keys)
+	{
+		_keys = std::move(keys);
+		reindex();
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	void flat_set<Key, Compare, Search, KeyContainer>::swap(flat_set& x)
+	{
+		using std::swap;
+		swap(_keys, x._keys);
+		swap(_comp, x._comp);
+		swap(_index, x._index);
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	void flat_set<Key, Compare, Search, KeyContainer>::clear() noexcept
+	{
+		_keys.clear();
+		_index.build(_keys.data(), 0);
+	}
+
+	// ---------------
+	// OBSERVERS
+	// ---------------
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::key_compare flat_set<Key, Compare, Search, KeyContainer>::key_comp() const
+	{
+		return _comp;
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::value_compare flat_set<Key, Compare, Search, KeyContainer>::value_comp() const
+	{
+		return _comp;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class Key, class Compare, class Search, class KeyContainer>
+	template <class K>
+	inline size_type flat_set<Key, Compare, Search, KeyContainer>::lower_index(const K& key) const
+	{
+		return _index.lower_bound(_keys.data(), _keys.size(), key, _comp);
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	template <class K>
+	inline size_type flat_set<Key, Compare, Search, KeyContainer>::find_index(const K& key) const
+	{
+		const auto idx = lower_index(key);
+		return idx != _keys.size() && !_comp(key, _keys[idx]) ? idx : _keys.size();
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	std::pair<typename flat_set<Key, Compare, Search, KeyContainer>::iterator, bool> flat_set<Key, Compare, Search, KeyContainer>::insert_unique(Key&& key)
+	{
+		const auto idx = lower_index(key);
+		if (idx != _keys.size() && !_comp(key, _keys[idx]))
+		{
+			return { get_iterator(idx), false };
+		}
+
+		_keys.insert(_keys.begin() + idx, std::move(key));
+		reindex();
+		return { get_iterator(idx), true };
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	void flat_set<Key, Compare, Search, KeyContainer>::sort_from(size_type sorted)
+	{
+		const auto n = _keys.size();
+
+		// Appending keys in order which all sort after the existing ones needs no sort at all
+		bool in_order = sorted == 0 || sorted == n || _comp(_keys[sorted - 1], _keys[sorted]);
+		for (size_type i = sorted + 1; in_order && i < n; ++i)
+		{
+			in_order = _comp(_keys[i - 1], _keys[i]);
+		}
+		if (in_order)
+		{
+			reindex();
+			return;
+		}
+
+		// Keys carry nothing along so they are sorted in place, the stable sort and merge
+		// keep equivalent keys in order with the existing ones first
+		std::stable_sort(_keys.begin() + sorted, _keys.end(), _comp);
+		std::inplace_merge(_keys.begin(), _keys.begin() + sorted, _keys.end(), _comp);
+
+		auto equivalent = [this](const Key& lhs, const Key& rhs) { return !_comp(lhs, rhs); };
+		_keys.erase(std::unique(_keys.begin(), _keys.end(), equivalent), _keys.end());
+		reindex();
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline void flat_set<Key, Compare, Search, KeyContainer>::reindex()
+	{
+		_index.build(_keys.data(), _keys.size());
+	}
+
+	template <class Key, class Compare, class Search, class KeyContainer>
+	inline typename flat_set<Key, Compare, Search, KeyContainer>::const_iterator flat_set<Key, Compare, Search, KeyContainer>::get_iterator(size_type n) const
+	{
+		return const_iterator(_keys.data() + n);
+	}
+}
@@ -0,0 +1,62 @@
+// growth_policy.h
+// A non-stl header only set of growth policies used by the dynamically sized containers
+// to decide how much capacity to request when they run out of room.
+
+/*
+ * A growth policy is a stateless type exposing
+ *     static constexpr size_type grow(size_type n, size_type element_size) noexcept;
+ * which returns the capacity to allocate when a container needs to hold more than n elements.
+ * The returned capacity is always strictly greater than n so a container growing from an
+ * empty state always makes progress.
+ */
+
+#pragma once
+
+// Includes
+#include <cstddef>			// size_t
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Grows the capacity geometrically by the factor Num / Den
+	// Num must be strictly greater than Den otherwise the container would never grow
+	template <size_type Num, size_type Den = 1>
+	struct growth_factor
+	{
+		static_assert(Den != 0, "growth_factor denominator cannot be 0");
+		static_assert(Num > Den, "growth_factor must be greater than 1");
+
+		static constexpr size_type grow(size_type n, size_type /*element_size*/) noexcept
+		{
+			const size_type next = n / Den * Num + n % Den * Num / Den;
+			return next > n ? next : n + 1;
+		}
+	};
+
+	// Doubles the capacity, the historical behaviour of non_stl::vector
+	using double_growth = growth_factor<2>;
+
+	// Grows the capacity by 1.5x which allows freed blocks to be reused by later allocations
+	using one_and_half_growth = growth_factor<3, 2>;
+
+	// Applies Base and then rounds the resulting allocation up to a whole number of pages
+	// so that large containers never leave the tail of their last page unused
+	template <class Base = double_growth, size_type PageSize = 4096>
+	struct page_rounded_growth
+	{
+		static_assert(PageSize != 0 && (PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+
+		static constexpr size_type grow(size_type n, size_type element_size) noexcept
+		{
+			const size_type next = Base::grow(n, element_size);
+			if (element_size == 0 || element_size > PageSize)
+			{
+				return next;
+			}
+
+			const size_type bytes = (next * element_size + PageSize - 1) & ~(PageSize - 1);
+			return bytes / element_size;
+		}
+	};
+}
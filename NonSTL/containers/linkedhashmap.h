@@ -0,0 +1,1677 @@
+// linkedhashmap.h
+// A non-stl header only implementation of a hash map which follows the interface of std::unordered_map
+// while iterating in insertion order.
+// Note, the standard is used for some components such as std::allocator, std::hash and exceptions
+
+/*
+ * A linkedhashmap keeps its entries in nodes threaded on a doubly linked list in insertion order.
+ * Nodes are index linked and carved out of fixed size blocks, so there is no allocation per entry,
+ * and nodes never move: references, pointers and iterators to entries stay valid until the entry is erased.
+ * Erased nodes go on a free list and are reused by the next insertion.
+ * Lookup goes through an open addressing table in the style of SwissTable. Every table slot holds a node
+ * index and a control byte, either empty, deleted, or 7 bits of the hash of the entry stored there.
+ * A lookup compares the control bytes of a whole group of 16 slots at once, using SSE2 when it is available,
+ * and only looks at the nodes whose control byte matches.
+ * Erasing is O(1) and keeps the order of the other entries, move_to_back and move_to_front reorder an entry
+ * in O(1), which makes the container usable as the storage of an LRU cache.
+ */
+
+#pragma once
+
+// Includes
+#include <cstddef>			// std::ptrdiff_t
+#include <cstdint>			// std::uint8_t, std::uint32_t, std::uint64_t
+#include <cstring>			// std::memcpy, std::memset
+#include <functional>		// std::hash, std::equal_to
+#include <initializer_list>	// std::initializer_list
+#include <iterator>			// std::bidirectional_iterator_tag, std::reverse_iterator
+#include <memory>			// std::allocator, std::allocator_traits
+#include <memory_resource>	// std::pmr::polymorphic_allocator
+#include <new>				// std::launder
+#include <stdexcept>		// std::out_of_range
+#include <tuple>			// std::forward_as_tuple
+#include <type_traits>		// std::conditional_t, std::enable_if_t, std::void_t
+#include <utility>			// std::pair, std::piecewise_construct, std::forward, std::move, std::swap
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NON_STL_LINKEDHASHMAP_SSE2
+#include <emmintrin.h>		// _mm_loadu_si128, _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>			// _BitScanForward
+#endif
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter Key is the type of the keys, T the type of the mapped values
+	// Template parameter Hash hashes keys, it is mixed before use so std::hash of integers is fine
+	// Template parameter KeyEqual compares keys. When both Hash and KeyEqual define is_transparent
+	// the lookup functions also accept any type they can hash and compare against a key
+	// Template parameter Alloc is the allocator of std::pair<const Key, T>, it is rebound to allocate
+	// the node blocks and the table
+	template <class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
+		class Alloc = std::allocator<std::pair<const Key, T> > >
+	class linkedhashmap
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = std::pair<const Key, T>;
+		using hasher = Hash;
+		using key_equal = KeyEqual;
+		using allocator_type = Alloc;
+
+	private:
+		using alloc_traits = std::allocator_traits<Alloc>;
+
+		// Index used for the end of the lists
+		static constexpr size_type npos = static_cast<size_type>(-1);
+
+		// An entry, linked in insertion order, or on the free list through next once erased
+		struct node
+		{
+			alignas(value_type) unsigned char storage[sizeof(value_type)];
+			size_type prev;
+			size_type next;
+			size_type hash;
+
+			value_type* ptr() noexcept { return reinterpret_cast<value_type*>(storage); }
+			value_type& value() noexcept { return *std::launder(ptr()); }
+			const value_type& value() const noexcept { return *std::launder(reinterpret_cast<const value_type*>(storage)); }
+		};
+
+		using node_alloc = typename alloc_traits::template rebind_alloc<node>;
+		using block_alloc = typename alloc_traits::template rebind_alloc<node*>;
+		using table_alloc = typename alloc_traits::template rebind_alloc<size_type>;
+
+		// Amount of nodes in a block
+		static constexpr size_type NODE_BLOCK = 32;
+
+		// Amount of control bytes compared at once
+		static constexpr size_type GROUP_WIDTH = 16;
+
+		// Control bytes, a full slot holds the low 7 bits of the hash so its high bit is clear
+		static constexpr std::uint8_t CTRL_EMPTY = 0x80;
+		static constexpr std::uint8_t CTRL_DELETED = 0xFE;
+
+		// Lookup is enabled for other key types when both the hash and the comparison are transparent
+		template <class H, class E>
+		using transparent = std::void_t<typename H::is_transparent, typename E::is_transparent>;
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor
+		// Nothing is allocated until the first entry is inserted
+		linkedhashmap() noexcept;
+		explicit linkedhashmap(const Alloc& alloc) noexcept;
+
+		// Constructs an empty map able to hold n entries without growing
+		explicit linkedhashmap(size_type n, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+			const Alloc& alloc = Alloc());
+
+		// Range constructor
+		// Keys appearing more than once keep their first value
+		template <class InputIterator>
+		linkedhashmap(InputIterator first, InputIterator last, size_type n = 0, const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc());
+
+		// Initializer list constructor
+		linkedhashmap(std::initializer_list<value_type> init, size_type n = 0, const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc());
+
+		// Copy constructor
+		// The copy iterates in the same order, the allocator is obtained from
+		// select_on_container_copy_construction
+		linkedhashmap(const linkedhashmap& rhs);
+
+		// Move constructor
+		// The nodes and the table are stolen along with the allocator
+		linkedhashmap(linkedhashmap&& rhs) noexcept;
+
+		// ---------------
+		// OPERATOR=
+		// ---------------
+
+		// The allocator follows the propagate_on_container_copy_assignment and
+		// propagate_on_container_move_assignment traits. When it doesn't propagate
+		// and the allocators are unequal a move assignment moves the entries one by one
+		linkedhashmap& operator=(const linkedhashmap& rhs);
+		linkedhashmap& operator=(linkedhashmap&& rhs) noexcept(
+			std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+			std::allocator_traits<Alloc>::is_always_equal::value);
+		linkedhashmap& operator=(std::initializer_list<value_type> init);
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+		~linkedhashmap();
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+
+		// Iterators walk the entries in insertion order
+		// They are only invalidated by erasing the entry they point to
+		template <bool isConst> struct myIterator;
+		using iterator = myIterator<false>;
+		using const_iterator = myIterator<true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Returns an iterator to the oldest entry
+		// If the container is empty, the returned iterator will be equal to end()
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+
+		// Returns an iterator to the element following the newest entry
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+
+		// Reverse iterators walk the entries from the newest to the oldest
+		reverse_iterator rbegin() noexcept;
+		const_reverse_iterator rbegin() const noexcept;
+		const_reverse_iterator crbegin() const noexcept;
+		reverse_iterator rend() noexcept;
+		const_reverse_iterator rend() const noexcept;
+		const_reverse_iterator crend() const noexcept;
+
+		template <bool isconst = false>
+		struct myIterator
+		{
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = typename linkedhashmap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using reference = typename std::conditional_t< isconst, value_type const&, value_type& >;
+			using pointer = typename std::conditional_t< isconst, value_type const*, value_type* >;
+		private:
+			using owner = typename std::conditional_t< isconst, const linkedhashmap, linkedhashmap >;
+
+			owner*		map;
+			size_type	index;
+
+			myIterator(owner* m, size_type i) : map(m), index(i) {}
+
+		public:
+			myIterator() : map(nullptr), index(npos) {}
+			// A non const iterator is implicitly convertible to a const iterator
+			template <bool otherConst, class = std::enable_if_t<isconst && !otherConst> >
+			myIterator(const myIterator<otherConst>& i) : map(i.map), index(i.index) {}
+
+			reference operator*() const { return map->node_at(index).value(); }
+			pointer operator->() const { return &(operator *()); }
+
+			myIterator& operator++()
+			{
+				index = map->node_at(index).next;
+				return *this;
+			}
+			myIterator operator++(int)
+			{
+				myIterator iter = *this;
+				++(*this);
+				return iter;
+			}
+			myIterator& operator--()
+			{
+				index = index == npos ? map->_tail : map->node_at(index).prev;
+				return *this;
+			}
+			myIterator operator--(int) {
+				myIterator iter = *this;
+				--(*this);
+				return iter;
+			}
+
+			friend bool operator==(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.index == rhs.index;
+			}
+			friend bool operator!=(const myIterator& lhs, const myIterator& rhs) {
+				return !(lhs == rhs);
+			}
+			friend class linkedhashmap;
+			friend struct myIterator<!isconst>;
+		};
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of entries in the map
+		size_type size() const noexcept;
+
+		// Returns whether the map is empty
+		// (i.e. whether its size is 0)
+		bool empty() const noexcept;
+
+		// Return the maximum number of entries the map can hold
+		size_type max_size() const noexcept;
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns a reference to the value mapped to key
+		// Function throws std::out_of_range if there is no such key
+		T& at(const Key& key);
+		const T& at(const Key& key) const;
+
+		// Returns a reference to the value mapped to key, inserting a value initialized one if there is none
+		T& operator[](const Key& key);
+		T& operator[](Key&& key);
+
+		// Returns the oldest, or newest, entry
+		value_type& front() noexcept;
+		const value_type& front() const noexcept;
+		value_type& back() noexcept;
+		const value_type& back() const noexcept;
+
+		// ---------------
+		// LOOKUP
+		// ---------------
+
+		// Returns an iterator to the entry with key, or end() if there is none
+		iterator find(const Key& key);
+		const_iterator find(const Key& key) const;
+		template <class K, class H = Hash, class E = KeyEqual, class = transparent<H, E> >
+		iterator find(const K& key);
+		template <class K, class H = Hash, class E = KeyEqual, class = transparent<H, E> >
+		const_iterator find(const K& key) const;
+
+		// Returns the number of entries with key, either 0 or 1
+		size_type count(const Key& key) const;
+		template <class K, class H = Hash, class E = KeyEqual, class = transparent<H, E> >
+		size_type count(const K& key) const;
+
+		// Returns whether there is an entry with key
+		bool contains(const Key& key) const;
+		template <class K, class H = Hash, class E = KeyEqual, class = transparent<H, E> >
+		bool contains(const K& key) const;
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Inserts value at the end of the order unless its key is already present
+		// Returns an iterator to the entry with the key and whether the insertion took place
+		std::pair<iterator, bool> insert(const value_type& value);
+		std::pair<iterator, bool> insert(value_type&& value);
+
+		// Inserts every entry of the range whose key isn't present yet
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last);
+		void insert(std::initializer_list<value_type> il);
+
+		// Inserts key mapped to obj, or assigns obj to the value already mapped to key
+		// An assignment keeps the position of the entry in the order
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj);
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(Key&& key, M&& obj);
+
+		// Constructs an entry from args and inserts it unless its key is already present
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&& ... args);
+
+		// Inserts key mapped to a value constructed from args unless key is already present,
+		// in which case args are left untouched
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(const Key& key, Args&& ... args);
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(Key&& key, Args&& ... args);
+
+		// Removes the entry at position, or the entries in [first, last), keeping the order of the others
+		// Returns an iterator to the entry following the last one removed
+		iterator erase(const_iterator position);
+		iterator erase(const_iterator first, const_iterator last);
+
+		// Removes the entry with key, returns the number of entries removed
+		size_type erase(const Key& key);
+
+		// Removes the oldest entry
+		void pop_front() noexcept;
+
+		// Makes the entry at position the newest, or the oldest, one
+		void move_to_back(const_iterator position) noexcept;
+		void move_to_front(const_iterator position) noexcept;
+
+		// Exchanges the content of the container by the content of x
+		// The allocators are only exchanged if propagate_on_container_swap is set
+		// Unequal allocators which don't propagate fall back to moving the entries
+		void swap(linkedhashmap& x);
+
+		// Removes every entry, the node blocks and the table are kept for reuse
+		void clear() noexcept;
+
+		// ---------------
+		// HASH POLICY
+		// ---------------
+
+		// Makes room for n entries, the table and the node blocks are allocated up front
+		// so inserting up to n entries never allocates nor rehashes
+		void reserve(size_type n);
+
+		// Sets the amount of slots in the table to the smallest power of two of at least count
+		// which still holds every entry
+		void rehash(size_type count);
+
+		// Returns the amount of slots in the table
+		size_type bucket_count() const noexcept;
+
+		// Returns the average amount of entries per slot
+		float load_factor() const noexcept;
+
+		// Returns the load factor the table is grown at, fixed to 7/8
+		float max_load_factor() const noexcept;
+
+		// ---------------
+		// OBSERVERS
+		// ---------------
+		Alloc get_allocator() const noexcept;
+		Hash hash_function() const;
+		KeyEqual key_eq() const;
+
+	private:
+		// Private functions
+
+		// Returns the node with index i
+		node& node_at(size_type i) noexcept;
+		const node& node_at(size_type i) const noexcept;
+
+		// Mixes the user hash so its low and high bits are both usable
+		template <class K>
+		size_type hash_key(const K& key) const;
+
+		// Returns the index of the node holding key, or npos
+		template <class K>
+		size_type find_index(const K& key, size_type hash) const;
+
+		// Returns the table slot holding node index i, whose hash is hash
+		size_type find_slot(size_type i, size_type hash) const noexcept;
+
+		// Returns the first free slot of the probe sequence of hash
+		size_type find_free_slot(size_type hash) const noexcept;
+
+		// Records node index i with hash in the table, which must have room for it
+		void insert_slot(size_type i, size_type hash) noexcept;
+
+		// Makes sure the table has room for one more entry
+		void prepare_insert();
+
+		// Rebuilds the table with cap slots from the nodes
+		void rehash_table(size_type cap);
+
+		// Takes a node off the free list, or from the end of the blocks, adding a block if needed
+		size_type allocate_node();
+		void free_node(size_type i) noexcept;
+
+		// Makes sure there are blocks for n nodes
+		void reserve_nodes(size_type n);
+
+		// Links node i at the end, or at the start, of the order, or takes it out of the order
+		void link_back(size_type i) noexcept;
+		void link_front(size_type i) noexcept;
+		void unlink(size_type i) noexcept;
+
+		// Constructs a new entry from args for a key known not to be present and with hash
+		template <class... Args>
+		size_type insert_unique(size_type hash, Args&& ... args);
+
+		// Removes the entry of node i
+		void erase_index(size_type i) noexcept;
+
+		// Copies, or moves, every entry of rhs keeping their order, the map is assumed empty
+		void copy_from(const linkedhashmap& rhs);
+		void move_from(linkedhashmap& rhs);
+
+		// Destroys every entry and returns the blocks and the table to the allocator
+		// leaving the map as if default constructed
+		void release() noexcept;
+
+		// Takes the nodes and the table of rhs, leaving rhs empty
+		// Assumed that this map holds nothing
+		void steal(linkedhashmap& rhs) noexcept;
+
+		// Returns the amount of entries a table of cap slots holds before it grows
+		static constexpr size_type growth_capacity(size_type cap) noexcept;
+
+		// Returns a mask with bit i set when control byte i of the group at ctrl is b,
+		// or is free (empty or deleted)
+		static std::uint32_t match_byte(const std::uint8_t* ctrl, std::uint8_t b) noexcept;
+		static std::uint32_t match_free(const std::uint8_t* ctrl) noexcept;
+
+		// Returns the position of the lowest set bit of a non zero mask
+		static unsigned lowest_bit(std::uint32_t mask) noexcept;
+
+		// Member variables
+
+		// Allocator object, rebound to allocate the node blocks and the table
+		Alloc _alloc;
+		Hash _hash;
+		KeyEqual _equal;
+
+		// Array of _block_capacity pointers, of which _block_count point to blocks of NODE_BLOCK nodes
+		node** _blocks;
+		size_type _block_count;
+		size_type _block_capacity;
+
+		// Amount of nodes ever handed out from the blocks and the head of the free list
+		size_type _node_count;
+		size_type _free;
+
+		// Oldest and newest entries
+		size_type _head;
+		size_type _tail;
+
+		// Table of _table_capacity node indices followed by as many control bytes
+		size_type* _slots;
+		std::uint8_t* _ctrl;
+		size_type _table_capacity;
+
+		// Entries which can still be inserted before the table is rebuilt
+		size_type _growth_left;
+
+		// The current amount of entries stored within the map
+		size_type _size;
+	};
+
+	// LINKEDHASHMAP IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::linkedhashmap() noexcept :
+		linkedhashmap(Alloc())
+	{
+
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::linkedhashmap(const Alloc& alloc) noexcept :
+		_alloc(alloc),
+		_hash(),
+		_equal(),
+		_blocks(nullptr),
+		_block_count(0),
+		_block_capacity(0),
+		_node_count(0),
+		_free(npos),
+		_head(npos),
+		_tail(npos),
+		_slots(nullptr),
+		_ctrl(nullptr),
+		_table_capacity(0),
+		_growth_left(0),
+		_size(0)
+	{
+
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::linkedhashmap(size_type n, const Hash& hash, const KeyEqual& equal, const Alloc& alloc) :
+		linkedhashmap(alloc)
+	{
+		_hash = hash;
+		_equal = equal;
+		reserve(n);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class InputIterator>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::linkedhashmap(InputIterator first, InputIterator last, size_type n,
+		const Hash& hash, const KeyEqual& equal, const Alloc& alloc) :
+		linkedhashmap(n, hash, equal, alloc)
+	{
+		insert(first, last);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::linkedhashmap(std::initializer_list<value_type> init, size_type n,
+		const Hash& hash, const KeyEqual& equal, const Alloc& alloc) :
+		linkedhashmap(n > init.size() ? n : init.size(), hash, equal, alloc)
+	{
+		insert(init);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::linkedhashmap(const linkedhashmap& rhs) :
+		linkedhashmap(alloc_traits::select_on_container_copy_construction(rhs._alloc))
+	{
+		_hash = rhs._hash;
+		_equal = rhs._equal;
+		copy_from(rhs);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::linkedhashmap(linkedhashmap&& rhs) noexcept :
+		linkedhashmap(std::move(rhs._alloc))
+	{
+		_hash = std::move(rhs._hash);
+		_equal = std::move(rhs._equal);
+		steal(rhs);
+	}
+
+	// ---------------
+	// OPERATOR=
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::operator=(const linkedhashmap& rhs)
+	{
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+		{
+			// Blocks from the current allocator can't be kept if the new one can't free them
+			if (!(_alloc == rhs._alloc))
+			{
+				release();
+			}
+			_alloc = rhs._alloc;
+		}
+
+		clear();
+		_hash = rhs._hash;
+		_equal = rhs._equal;
+		copy_from(rhs);
+		return *this;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::operator=(linkedhashmap&& rhs) noexcept(
+		std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+		std::allocator_traits<Alloc>::is_always_equal::value)
+	{
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		_hash = std::move(rhs._hash);
+		_equal = std::move(rhs._equal);
+
+		if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+		{
+			// Take the allocator along with the nodes
+			release();
+			_alloc = std::move(rhs._alloc);
+			steal(rhs);
+		}
+		else
+		{
+			if (_alloc == rhs._alloc)
+			{
+				release();
+				steal(rhs);
+			}
+			else
+			{
+				// Can't adopt nodes from another allocator, move the entries one by one
+				clear();
+				move_from(rhs);
+				rhs.clear();
+			}
+		}
+
+		return *this;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::operator=(std::initializer_list<value_type> init)
+	{
+		clear();
+		insert(init);
+		return *this;
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::~linkedhashmap()
+	{
+		release();
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::begin() noexcept
+	{
+		return iterator(this, _head);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::const_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::begin() const noexcept
+	{
+		return const_iterator(this, _head);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::const_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::end() noexcept
+	{
+		return iterator(this, npos);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::const_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::end() const noexcept
+	{
+		return const_iterator(this, npos);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::const_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::cend() const noexcept
+	{
+		return end();
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::reverse_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::rbegin() noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::const_reverse_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::const_reverse_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::reverse_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::rend() noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::const_reverse_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::const_reverse_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::crend() const noexcept
+	{
+		return rend();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::size() const noexcept
+	{
+		return _size;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline bool linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::max_size() const noexcept
+	{
+		// Keep npos free to mark the end of the lists
+		return npos / sizeof(node);
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	T& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::at(const Key& key)
+	{
+		const size_type i = find_index(key, hash_key(key));
+		if (i == npos)
+		{
+			throw std::out_of_range("linkedhashmap::at - key not found");
+		}
+		return node_at(i).value().second;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	const T& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::at(const Key& key) const
+	{
+		const size_type i = find_index(key, hash_key(key));
+		if (i == npos)
+		{
+			throw std::out_of_range("linkedhashmap::at - key not found");
+		}
+		return node_at(i).value().second;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	T& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::operator[](const Key& key)
+	{
+		return try_emplace(key).first->second;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	T& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::operator[](Key&& key)
+	{
+		return try_emplace(std::move(key)).first->second;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::value_type& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::front() noexcept
+	{
+		return node_at(_head).value();
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline const typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::value_type& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::front() const noexcept
+	{
+		return node_at(_head).value();
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::value_type& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::back() noexcept
+	{
+		return node_at(_tail).value();
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline const typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::value_type& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::back() const noexcept
+	{
+		return node_at(_tail).value();
+	}
+
+	// ---------------
+	// LOOKUP
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::find(const Key& key)
+	{
+		return iterator(this, find_index(key, hash_key(key)));
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::const_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::find(const Key& key) const
+	{
+		return const_iterator(this, find_index(key, hash_key(key)));
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class K, class H, class E, class>
+	typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::find(const K& key)
+	{
+		return iterator(this, find_index(key, hash_key(key)));
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class K, class H, class E, class>
+	typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::const_iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::find(const K& key) const
+	{
+		return const_iterator(this, find_index(key, hash_key(key)));
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::count(const Key& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class K, class H, class E, class>
+	size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::count(const K& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	bool linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::contains(const Key& key) const
+	{
+		return find_index(key, hash_key(key)) != npos;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class K, class H, class E, class>
+	bool linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::contains(const K& key) const
+	{
+		return find_index(key, hash_key(key)) != npos;
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	std::pair<typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator, bool> linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::insert(const value_type& value)
+	{
+		return try_emplace(value.first, value.second);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	std::pair<typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator, bool> linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::insert(value_type&& value)
+	{
+		// The key is const, only the mapped value can be moved from
+		return try_emplace(value.first, std::move(value.second));
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class InputIterator>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::insert(InputIterator first, InputIterator last)
+	{
+		using category = typename std::iterator_traits<InputIterator>::iterator_category;
+		if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+			// Grow at most once, assuming the keys are distinct
+			reserve(_size + (size_type)std::distance(first, last));
+		}
+
+		for (; first != last; ++first)
+		{
+			emplace(*first);
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::insert(std::initializer_list<value_type> il)
+	{
+		insert(il.begin(), il.end());
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class M>
+	std::pair<typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator, bool> linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::insert_or_assign(const Key& key, M&& obj)
+	{
+		auto result = try_emplace(key, std::forward<M>(obj));
+		if (!result.second)
+		{
+			result.first->second = std::forward<M>(obj);
+		}
+		return result;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class M>
+	std::pair<typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator, bool> linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::insert_or_assign(Key&& key, M&& obj)
+	{
+		auto result = try_emplace(std::move(key), std::forward<M>(obj));
+		if (!result.second)
+		{
+			result.first->second = std::forward<M>(obj);
+		}
+		return result;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class... Args>
+	std::pair<typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator, bool> linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::emplace(Args&& ... args)
+	{
+		// The key is only known once the entry is built, build it in a free node
+		const size_type i = allocate_node();
+		node& n = node_at(i);
+		try
+		{
+			alloc_traits::construct(_alloc, n.ptr(), std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			free_node(i);
+			throw;
+		}
+
+		try
+		{
+			const Key& key = n.value().first;
+			const size_type hash = hash_key(key);
+			const size_type found = find_index(key, hash);
+			if (found != npos)
+			{
+				alloc_traits::destroy(_alloc, n.ptr());
+				free_node(i);
+				return { iterator(this, found), false };
+			}
+
+			prepare_insert();
+			n.hash = hash;
+		}
+		catch (...)
+		{
+			alloc_traits::destroy(_alloc, n.ptr());
+			free_node(i);
+			throw;
+		}
+
+		insert_slot(i, n.hash);
+		link_back(i);
+		++_size;
+		return { iterator(this, i), true };
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class... Args>
+	std::pair<typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator, bool> linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::try_emplace(const Key& key, Args&& ... args)
+	{
+		const size_type hash = hash_key(key);
+		const size_type found = find_index(key, hash);
+		if (found != npos)
+		{
+			return { iterator(this, found), false };
+		}
+
+		const size_type i = insert_unique(hash, std::piecewise_construct,
+			std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		return { iterator(this, i), true };
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class... Args>
+	std::pair<typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator, bool> linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::try_emplace(Key&& key, Args&& ... args)
+	{
+		const size_type hash = hash_key(key);
+		const size_type found = find_index(key, hash);
+		if (found != npos)
+		{
+			return { iterator(this, found), false };
+		}
+
+		const size_type i = insert_unique(hash, std::piecewise_construct,
+			std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		return { iterator(this, i), true };
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::erase(const_iterator position)
+	{
+		const size_type next = node_at(position.index).next;
+		erase_index(position.index);
+		return iterator(this, next);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::iterator linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::erase(const_iterator first, const_iterator last)
+	{
+		size_type i = first.index;
+		while (i != last.index)
+		{
+			const size_type next = node_at(i).next;
+			erase_index(i);
+			i = next;
+		}
+		return iterator(this, i);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::erase(const Key& key)
+	{
+		const size_type i = find_index(key, hash_key(key));
+		if (i == npos)
+		{
+			return 0;
+		}
+
+		erase_index(i);
+		return 1;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::pop_front() noexcept
+	{
+		erase_index(_head);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::move_to_back(const_iterator position) noexcept
+	{
+		if (position.index != _tail)
+		{
+			unlink(position.index);
+			link_back(position.index);
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::move_to_front(const_iterator position) noexcept
+	{
+		if (position.index != _head)
+		{
+			unlink(position.index);
+			link_front(position.index);
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::swap(linkedhashmap& x)
+	{
+		if (this == &x)
+		{
+			return;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_swap::value)
+		{
+			using std::swap;
+			swap(_alloc, x._alloc);
+		}
+		else if constexpr (!alloc_traits::is_always_equal::value)
+		{
+			// Each set of blocks has to stay with the allocator it came from
+			if (!(_alloc == x._alloc))
+			{
+				linkedhashmap tmp(std::move(*this));
+				*this = std::move(x);
+				x = std::move(tmp);
+				return;
+			}
+		}
+
+		using std::swap;
+		swap(_hash, x._hash);
+		swap(_equal, x._equal);
+		std::swap(_blocks, x._blocks);
+		std::swap(_block_count, x._block_count);
+		std::swap(_block_capacity, x._block_capacity);
+		std::swap(_node_count, x._node_count);
+		std::swap(_free, x._free);
+		std::swap(_head, x._head);
+		std::swap(_tail, x._tail);
+		std::swap(_slots, x._slots);
+		std::swap(_ctrl, x._ctrl);
+		std::swap(_table_capacity, x._table_capacity);
+		std::swap(_growth_left, x._growth_left);
+		std::swap(_size, x._size);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::clear() noexcept
+	{
+		for (size_type i = _head; i != npos; i = node_at(i).next)
+		{
+			alloc_traits::destroy(_alloc, node_at(i).ptr());
+		}
+
+		// Every node is free again, hand them out from the start of the blocks
+		_node_count = 0;
+		_free = npos;
+		_head = npos;
+		_tail = npos;
+		_size = 0;
+
+		if (_table_capacity != 0)
+		{
+			std::memset(_ctrl, CTRL_EMPTY, _table_capacity);
+			_growth_left = growth_capacity(_table_capacity);
+		}
+	}
+
+	// ---------------
+	// HASH POLICY
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::reserve(size_type n)
+	{
+		if (n == 0)
+		{
+			return;
+		}
+
+		size_type cap = GROUP_WIDTH;
+		while (growth_capacity(cap) < n)
+		{
+			cap *= 2;
+		}
+		if (cap > _table_capacity)
+		{
+			rehash_table(cap);
+		}
+
+		reserve_nodes(n);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::rehash(size_type count)
+	{
+		if (count == 0 && _size == 0)
+		{
+			return;
+		}
+
+		size_type cap = GROUP_WIDTH;
+		while (cap < count || growth_capacity(cap) < _size)
+		{
+			cap *= 2;
+		}
+		if (cap != _table_capacity)
+		{
+			rehash_table(cap);
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::bucket_count() const noexcept
+	{
+		return _table_capacity;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline float linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::load_factor() const noexcept
+	{
+		return _table_capacity == 0 ? 0.0f : static_cast<float>(_size) / static_cast<float>(_table_capacity);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline float linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::max_load_factor() const noexcept
+	{
+		return 0.875f;
+	}
+
+	// ---------------
+	// OBSERVERS
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	Alloc linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::get_allocator() const noexcept
+	{
+		return _alloc;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	Hash linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::hash_function() const
+	{
+		return _hash;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	KeyEqual linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::key_eq() const
+	{
+		return _equal;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::node& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::node_at(size_type i) noexcept
+	{
+		return _blocks[i / NODE_BLOCK][i % NODE_BLOCK];
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline const typename linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::node& linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::node_at(size_type i) const noexcept
+	{
+		return _blocks[i / NODE_BLOCK][i % NODE_BLOCK];
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class K>
+	inline size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::hash_key(const K& key) const
+	{
+		// Multiplicative mixing so sequential keys spread over the groups and the control bytes
+		std::uint64_t h = static_cast<std::uint64_t>(_hash(key)) * 0x9E3779B97F4A7C15ull;
+		return static_cast<size_type>(h ^ (h >> 32));
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class K>
+	size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::find_index(const K& key, size_type hash) const
+	{
+		if (_table_capacity == 0)
+		{
+			return npos;
+		}
+
+		const size_type groups_mask = _table_capacity / GROUP_WIDTH - 1;
+		const std::uint8_t h2 = static_cast<std::uint8_t>(hash & 0x7F);
+		size_type group = (hash >> 7) & groups_mask;
+
+		// Triangular probing over the groups visits every group once
+		for (size_type step = 1; ; ++step)
+		{
+			const std::uint8_t* ctrl = _ctrl + group * GROUP_WIDTH;
+			for (std::uint32_t match = match_byte(ctrl, h2); match != 0; match &= match - 1)
+			{
+				const size_type i = _slots[group * GROUP_WIDTH + lowest_bit(match)];
+				const node& n = node_at(i);
+				if (n.hash == hash && _equal(n.value().first, key))
+				{
+					return i;
+				}
+			}
+
+			// No entry probed past a group which still has an empty slot
+			if (match_byte(ctrl, CTRL_EMPTY) != 0)
+			{
+				return npos;
+			}
+			group = (group + step) & groups_mask;
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::find_slot(size_type i, size_type hash) const noexcept
+	{
+		const size_type groups_mask = _table_capacity / GROUP_WIDTH - 1;
+		const std::uint8_t h2 = static_cast<std::uint8_t>(hash & 0x7F);
+		size_type group = (hash >> 7) & groups_mask;
+
+		for (size_type step = 1; ; ++step)
+		{
+			for (std::uint32_t match = match_byte(_ctrl + group * GROUP_WIDTH, h2); match != 0; match &= match - 1)
+			{
+				const size_type slot = group * GROUP_WIDTH + lowest_bit(match);
+				if (_slots[slot] == i)
+				{
+					return slot;
+				}
+			}
+			group = (group + step) & groups_mask;
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::find_free_slot(size_type hash) const noexcept
+	{
+		const size_type groups_mask = _table_capacity / GROUP_WIDTH - 1;
+		size_type group = (hash >> 7) & groups_mask;
+
+		for (size_type step = 1; ; ++step)
+		{
+			const std::uint32_t match = match_free(_ctrl + group * GROUP_WIDTH);
+			if (match != 0)
+			{
+				return group * GROUP_WIDTH + lowest_bit(match);
+			}
+			group = (group + step) & groups_mask;
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::insert_slot(size_type i, size_type hash) noexcept
+	{
+		const size_type slot = find_free_slot(hash);
+
+		// Reusing a deleted slot doesn't use up an empty one
+		if (_ctrl[slot] == CTRL_EMPTY)
+		{
+			--_growth_left;
+		}
+		_ctrl[slot] = static_cast<std::uint8_t>(hash & 0x7F);
+		_slots[slot] = i;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::prepare_insert()
+	{
+		if (_growth_left > 0)
+		{
+			return;
+		}
+
+		// Out of empty slots, drop the deleted ones if the table is mostly tombstones, grow otherwise
+		if (_table_capacity == 0)
+		{
+			rehash_table(GROUP_WIDTH);
+		}
+		else if (_size <= growth_capacity(_table_capacity) / 2)
+		{
+			rehash_table(_table_capacity);
+		}
+		else
+		{
+			rehash_table(_table_capacity * 2);
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::rehash_table(size_type cap)
+	{
+		// Only dropping tombstones, the slots are rebuilt from the node list in the same table
+		if (cap == _table_capacity)
+		{
+			std::memset(_ctrl, CTRL_EMPTY, cap);
+			_growth_left = growth_capacity(cap);
+			for (size_type i = _head; i != npos; i = node_at(i).next)
+			{
+				insert_slot(i, node_at(i).hash);
+			}
+			return;
+		}
+
+		// Node indices followed by the control bytes in a single allocation
+		table_alloc talloc(_alloc);
+		const size_type words = cap + cap / sizeof(size_type);
+		size_type* slots = talloc.allocate(words);
+
+		size_type* old_slots = _slots;
+		const size_type old_capacity = _table_capacity;
+
+		_slots = slots;
+		_ctrl = reinterpret_cast<std::uint8_t*>(slots + cap);
+		_table_capacity = cap;
+		std::memset(_ctrl, CTRL_EMPTY, cap);
+		_growth_left = growth_capacity(cap);
+
+		// Nodes remember their hash so the keys are never hashed again
+		for (size_type i = _head; i != npos; i = node_at(i).next)
+		{
+			insert_slot(i, node_at(i).hash);
+		}
+
+		if (old_slots)
+		{
+			talloc.deallocate(old_slots, old_capacity + old_capacity / sizeof(size_type));
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::allocate_node()
+	{
+		if (_free != npos)
+		{
+			const size_type i = _free;
+			_free = node_at(i).next;
+			return i;
+		}
+
+		reserve_nodes(_node_count + 1);
+		return _node_count++;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::free_node(size_type i) noexcept
+	{
+		node_at(i).next = _free;
+		_free = i;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::reserve_nodes(size_type n)
+	{
+		const size_type blocks = (n + NODE_BLOCK - 1) / NODE_BLOCK;
+		if (blocks <= _block_count)
+		{
+			return;
+		}
+
+		if (blocks > _block_capacity)
+		{
+			block_alloc balloc(_alloc);
+			size_type cap = _block_capacity ? _block_capacity * 2 : 4;
+			while (cap < blocks)
+			{
+				cap *= 2;
+			}
+
+			node** array = balloc.allocate(cap);
+			if (_blocks)
+			{
+				std::memcpy(static_cast<void*>(array), static_cast<const void*>(_blocks), _block_count * sizeof(node*));
+				balloc.deallocate(_blocks, _block_capacity);
+			}
+			_blocks = array;
+			_block_capacity = cap;
+		}
+
+		node_alloc nalloc(_alloc);
+		for (; _block_count < blocks; ++_block_count)
+		{
+			_blocks[_block_count] = nalloc.allocate(NODE_BLOCK);
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::link_back(size_type i) noexcept
+	{
+		node& n = node_at(i);
+		n.prev = _tail;
+		n.next = npos;
+
+		if (_tail != npos)
+		{
+			node_at(_tail).next = i;
+		}
+		else
+		{
+			_head = i;
+		}
+		_tail = i;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::link_front(size_type i) noexcept
+	{
+		node& n = node_at(i);
+		n.prev = npos;
+		n.next = _head;
+
+		if (_head != npos)
+		{
+			node_at(_head).prev = i;
+		}
+		else
+		{
+			_tail = i;
+		}
+		_head = i;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::unlink(size_type i) noexcept
+	{
+		const node& n = node_at(i);
+
+		if (n.prev != npos)
+		{
+			node_at(n.prev).next = n.next;
+		}
+		else
+		{
+			_head = n.next;
+		}
+
+		if (n.next != npos)
+		{
+			node_at(n.next).prev = n.prev;
+		}
+		else
+		{
+			_tail = n.prev;
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	template <class... Args>
+	size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::insert_unique(size_type hash, Args&& ... args)
+	{
+		// Grow before building the entry so nothing can fail once it exists
+		prepare_insert();
+		const size_type i = allocate_node();
+		node& n = node_at(i);
+
+		try
+		{
+			alloc_traits::construct(_alloc, n.ptr(), std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			free_node(i);
+			throw;
+		}
+
+		n.hash = hash;
+		insert_slot(i, hash);
+		link_back(i);
+		++_size;
+		return i;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::erase_index(size_type i) noexcept
+	{
+		node& n = node_at(i);
+		const size_type slot = find_slot(i, n.hash);
+		const size_type group = slot / GROUP_WIDTH * GROUP_WIDTH;
+
+		// A group which still has an empty slot never made a probe continue past it,
+		// so the slot can go back to empty instead of leaving a tombstone
+		if (match_byte(_ctrl + group, CTRL_EMPTY) != 0)
+		{
+			_ctrl[slot] = CTRL_EMPTY;
+			++_growth_left;
+		}
+		else
+		{
+			_ctrl[slot] = CTRL_DELETED;
+		}
+
+		unlink(i);
+		alloc_traits::destroy(_alloc, n.ptr());
+		free_node(i);
+		--_size;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::copy_from(const linkedhashmap& rhs)
+	{
+		reserve(rhs._size);
+		for (size_type i = rhs._head; i != npos; i = rhs.node_at(i).next)
+		{
+			const node& n = rhs.node_at(i);
+			insert_unique(n.hash, n.value());
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::move_from(linkedhashmap& rhs)
+	{
+		reserve(rhs._size);
+		for (size_type i = rhs._head; i != npos; i = rhs.node_at(i).next)
+		{
+			node& n = rhs.node_at(i);
+			insert_unique(n.hash, std::piecewise_construct,
+				std::forward_as_tuple(n.value().first), std::forward_as_tuple(std::move(n.value().second)));
+		}
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::release() noexcept
+	{
+		clear();
+
+		node_alloc nalloc(_alloc);
+		for (size_type b = 0; b < _block_count; ++b)
+		{
+			nalloc.deallocate(_blocks[b], NODE_BLOCK);
+		}
+		if (_blocks)
+		{
+			block_alloc balloc(_alloc);
+			balloc.deallocate(_blocks, _block_capacity);
+		}
+		if (_slots)
+		{
+			table_alloc talloc(_alloc);
+			talloc.deallocate(_slots, _table_capacity + _table_capacity / sizeof(size_type));
+		}
+
+		_blocks = nullptr;
+		_block_count = 0;
+		_block_capacity = 0;
+		_slots = nullptr;
+		_ctrl = nullptr;
+		_table_capacity = 0;
+		_growth_left = 0;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::steal(linkedhashmap& rhs) noexcept
+	{
+		_blocks = std::exchange(rhs._blocks, nullptr);
+		_block_count = std::exchange(rhs._block_count, 0);
+		_block_capacity = std::exchange(rhs._block_capacity, 0);
+		_node_count = std::exchange(rhs._node_count, 0);
+		_free = std::exchange(rhs._free, npos);
+		_head = std::exchange(rhs._head, npos);
+		_tail = std::exchange(rhs._tail, npos);
+		_slots = std::exchange(rhs._slots, nullptr);
+		_ctrl = std::exchange(rhs._ctrl, nullptr);
+		_table_capacity = std::exchange(rhs._table_capacity, 0);
+		_growth_left = std::exchange(rhs._growth_left, 0);
+		_size = std::exchange(rhs._size, 0);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	constexpr size_type linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::growth_capacity(size_type cap) noexcept
+	{
+		// Maximum load factor of 7/8
+		return cap - cap / 8;
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline std::uint32_t linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::match_byte(const std::uint8_t* ctrl, std::uint8_t b) noexcept
+	{
+#if defined(NON_STL_LINKEDHASHMAP_SSE2)
+		const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+		return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(b)))));
+#else
+		std::uint32_t mask = 0;
+		for (size_type i = 0; i < GROUP_WIDTH; ++i)
+		{
+			mask |= static_cast<std::uint32_t>(ctrl[i] == b) << i;
+		}
+		return mask;
+#endif
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline std::uint32_t linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::match_free(const std::uint8_t* ctrl) noexcept
+	{
+		// Empty and deleted are the only control bytes with the high bit set
+#if defined(NON_STL_LINKEDHASHMAP_SSE2)
+		return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))));
+#else
+		std::uint32_t mask = 0;
+		for (size_type i = 0; i < GROUP_WIDTH; ++i)
+		{
+			mask |= static_cast<std::uint32_t>(ctrl[i] >> 7) << i;
+		}
+		return mask;
+#endif
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	inline unsigned linkedhashmap<Key, T, Hash, KeyEqual, Alloc>::lowest_bit(std::uint32_t mask) noexcept
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return static_cast<unsigned>(index);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
+
+	namespace pmr
+	{
+		// linkedhashmap using a polymorphic allocator, e.g. backed by a non_stl::monotonic_buffer
+		template <class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key> >
+		using linkedhashmap = non_stl::linkedhashmap<Key, T, Hash, KeyEqual, std::pmr::polymorphic_allocator<std::pair<const Key, T> > >;
+	}
+}
@@ -0,0 +1,512 @@
+// lru_cache.h
+// A non-stl header only implementation of a bounded cache which evicts the least recently used entry,
+// together with a sharded variant which can be shared between threads.
+// Note, the standard is used for some components such as std::mutex and std::optional
+
+/*
+ * An lru_cache holds at most Capacity entries in a linkedhashmap whose insertion order is the recency order:
+ * the front is the least recently used entry and the back the most recently used one. A hit moves the entry
+ * to the back and a put into a full cache evicts the front, all in O(1).
+ * Room for Capacity entries is reserved on construction, so a cache which reached its capacity never
+ * allocates again: evicted nodes are reused by the next put.
+ * The OnEvict policy is called with the key and the value of every entry evicted to make room, before it is
+ * destroyed. Entries removed by erase or clear are not reported.
+ * lru_cache is not thread safe. sharded_lru_cache splits the entries over Shards independent caches, each
+ * behind its own mutex on its own cache line, so threads using different keys rarely wait on each other.
+ * Recency is tracked per shard, the entry evicted is the least recently used one of its shard.
+ */
+
+#pragma once
+
+// Includes
+#include <cstdint>			// std::uint64_t
+#include <functional>		// std::hash, std::equal_to
+#include <memory>			// std::allocator
+#include <mutex>			// std::mutex, std::lock_guard
+#include <optional>			// std::optional
+#include <utility>			// std::forward, std::move, std::pair, std::index_sequence
+
+#include "linkedhashmap.h"	// non_stl::linkedhashmap
+#include "../memory/cache_line.h"	// non_stl::cache_line_size
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Eviction policy which does nothing
+	struct ignore_eviction
+	{
+		template <class Key, class T>
+		void operator()(const Key& /*key*/, T& /*value*/) const noexcept {}
+	};
+
+	// Template parameter Key is the type of the keys, T the type of the cached values
+	// size_type Capacity is the maximum amount of entries held by the cache
+	// Template parameter OnEvict is called as on_evict(const Key&, T&) with every evicted entry
+	// Template parameters Hash, KeyEqual and Alloc are those of the underlying linkedhashmap
+	template <class Key, class T, size_type Capacity, class OnEvict = ignore_eviction, class Hash = std::hash<Key>,
+		class KeyEqual = std::equal_to<Key>, class Alloc = std::allocator<std::pair<const Key, T> > >
+	class lru_cache
+	{
+		static_assert(Capacity > 0, "lru_cache requires a capacity of at least one entry");
+
+		using map_type = linkedhashmap<Key, T, Hash, KeyEqual, Alloc>;
+
+	public:
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = typename map_type::value_type;
+
+		// Iterators walk the entries from the least to the most recently used
+		using const_iterator = typename map_type::const_iterator;
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Constructs an empty cache with room for Capacity entries
+		explicit lru_cache(OnEvict on_evict = OnEvict(), const Alloc& alloc = Alloc());
+
+		// ---------------
+		// LOOKUP
+		// ---------------
+
+		// Returns a pointer to the value cached for key and marks it as the most recently used,
+		// or nullptr if there is none
+		// The pointer is valid until the entry is evicted or erased
+		template <class K>
+		T* get(const K& key);
+
+		// Returns a pointer to the value cached for key without changing the recency order,
+		// or nullptr if there is none
+		template <class K>
+		const T* peek(const K& key) const;
+
+		// Returns whether a value is cached for key, without changing the recency order
+		template <class K>
+		bool contains(const K& key) const;
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Caches value for key, replacing the value already cached if there is one,
+		// and marks it as the most recently used
+		// When the cache is full and key is new the least recently used entry is evicted first
+		// Returns a reference to the cached value
+		template <class K, class M>
+		T& put(K&& key, M&& value);
+
+		// Returns the value cached for key marked as the most recently used, constructing it from
+		// args as if by put if there is none
+		template <class K, class... Args>
+		T& get_or_emplace(K&& key, Args&& ... args);
+
+		// Removes the entry of key without reporting it to OnEvict
+		// Returns whether there was one
+		bool erase(const Key& key);
+
+		// Evicts the least recently used entry, reported to OnEvict
+		void evict() noexcept(noexcept(std::declval<OnEvict&>()(std::declval<const Key&>(), std::declval<T&>())));
+
+		// Removes every entry without reporting them to OnEvict
+		void clear() noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of cached entries
+		size_type size() const noexcept;
+
+		// Returns whether the cache is empty
+		// (i.e. whether its size is 0)
+		bool empty() const noexcept;
+
+		// Returns the maximum amount of entries held by the cache
+		static constexpr size_type capacity() noexcept { return Capacity; }
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+		const_iterator begin() const noexcept;
+		const_iterator end() const noexcept;
+
+		// Returns the eviction policy
+		OnEvict& on_evict() noexcept;
+
+	private:
+		// Member variables
+
+		// Entries in recency order, least recently used first
+		map_type _map;
+
+		// Called with every evicted entry
+		OnEvict _on_evict;
+	};
+
+	// Template parameter Shards is the amount of independent caches, a power of two,
+	// each holding up to Capacity / Shards entries
+	// The other parameters are those of lru_cache
+	// OnEvict is called with the lock of the shard held, it must not use the cache
+	template <class Key, class T, size_type Capacity, size_type Shards = 16, class OnEvict = ignore_eviction,
+		class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>, class Alloc = std::allocator<std::pair<const Key, T> > >
+	class sharded_lru_cache
+	{
+		static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "sharded_lru_cache requires a power of two amount of shards");
+		static_assert(Capacity >= Shards, "sharded_lru_cache requires at least one entry per shard");
+
+		using shard_cache = lru_cache<Key, T, Capacity / Shards, OnEvict, Hash, KeyEqual, Alloc>;
+
+		// A cache and its lock, on cache lines of their own so shards never falsely share
+		struct alignas(cache_line_size) shard
+		{
+			explicit shard(const OnEvict& on_evict, const Alloc& alloc) : cache(on_evict, alloc) {}
+
+			std::mutex lock;
+			shard_cache cache;
+		};
+
+	public:
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Constructs every shard with a copy of on_evict and of alloc
+		explicit sharded_lru_cache(const OnEvict& on_evict = OnEvict(), const Alloc& alloc = Alloc());
+
+		// The shards hold mutexes, the cache is shared by reference
+		sharded_lru_cache(const sharded_lru_cache&) = delete;
+		sharded_lru_cache& operator=(const sharded_lru_cache&) = delete;
+
+		// ---------------
+		// LOOKUP
+		// ---------------
+
+		// Returns a copy of the value cached for key and marks it as the most recently used of its shard
+		template <class K>
+		std::optional<T> get(const K& key);
+
+		// Calls f(T&) on the value cached for key with the lock of its shard held, avoiding the copy of get
+		// Returns whether there was a value
+		template <class K, class F>
+		bool visit(const K& key, F&& f);
+
+		// Returns whether a value is cached for key
+		template <class K>
+		bool contains(const K& key) const;
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Caches value for key in its shard, evicting the least recently used entry of the shard if it is full
+		template <class K, class M>
+		void put(K&& key, M&& value);
+
+		// Removes the entry of key without reporting it to OnEvict
+		bool erase(const Key& key);
+
+		// Removes every entry without reporting them to OnEvict
+		void clear();
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of cached entries
+		// The shards are counted one after the other so concurrent updates may be partly counted
+		size_type size() const;
+
+		// Returns the maximum amount of entries held by the cache
+		static constexpr size_type capacity() noexcept { return Capacity / Shards * Shards; }
+
+		// Returns the amount of shards
+		static constexpr size_type shard_count() noexcept { return Shards; }
+
+	private:
+		// Private functions
+
+		// Constructs the array of shards element by element, shards can be neither copied nor moved
+		template <size_type... I>
+		sharded_lru_cache(const OnEvict& on_evict, const Alloc& alloc, std::index_sequence<I...>);
+
+		// Returns the shard holding key
+		// Uses other bits of the hash than the shards' own tables to keep their load even
+		template <class K>
+		shard& shard_for(const K& key) const;
+
+		// Member variables
+		Hash _hash;
+
+		// Shards are never moved, mutable so const lookups can take their lock
+		mutable shard _shards[Shards];
+	};
+
+	// LRU CACHE IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::lru_cache(OnEvict on_evict, const Alloc& alloc) :
+		_map(Capacity, Hash(), KeyEqual(), alloc),
+		_on_evict(std::move(on_evict))
+	{
+		// Twice the slots needed keeps a full cache at most half loaded, so the tombstones left by
+		// evictions are dropped in place instead of growing the table
+		_map.rehash(_map.bucket_count() * 2);
+	}
+
+	// ---------------
+	// LOOKUP
+	// ---------------
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <class K>
+	T* lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::get(const K& key)
+	{
+		auto it = _map.find(key);
+		if (it == _map.end())
+		{
+			return nullptr;
+		}
+
+		_map.move_to_back(it);
+		return &it->second;
+	}
+
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <class K>
+	const T* lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::peek(const K& key) const
+	{
+		auto it = _map.find(key);
+		return it == _map.end() ? nullptr : &it->second;
+	}
+
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <class K>
+	bool lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::contains(const K& key) const
+	{
+		return _map.contains(key);
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <class K, class M>
+	T& lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::put(K&& key, M&& value)
+	{
+		auto it = _map.find(key);
+		if (it != _map.end())
+		{
+			it->second = std::forward<M>(value);
+			_map.move_to_back(it);
+			return it->second;
+		}
+
+		// Make room first so the map never grows past the reserved capacity
+		if (_map.size() == Capacity)
+		{
+			evict();
+		}
+		return _map.try_emplace(std::forward<K>(key), std::forward<M>(value)).first->second;
+	}
+
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <class K, class... Args>
+	T& lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::get_or_emplace(K&& key, Args&& ... args)
+	{
+		auto it = _map.find(key);
+		if (it != _map.end())
+		{
+			_map.move_to_back(it);
+			return it->second;
+		}
+
+		if (_map.size() == Capacity)
+		{
+			evict();
+		}
+		return _map.try_emplace(std::forward<K>(key), std::forward<Args>(args)...).first->second;
+	}
+
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	bool lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::erase(const Key& key)
+	{
+		return _map.erase(key) != 0;
+	}
+
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	void lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::evict() noexcept(
+		noexcept(std::declval<OnEvict&>()(std::declval<const Key&>(), std::declval<T&>())))
+	{
+		auto& victim = _map.front();
+		_on_evict(victim.first, victim.second);
+		_map.pop_front();
+	}
+
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	void lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::clear() noexcept
+	{
+		_map.clear();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	inline size_type lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::size() const noexcept
+	{
+		return _map.size();
+	}
+
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	inline bool lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	inline typename lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::const_iterator lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::begin() const noexcept
+	{
+		return _map.begin();
+	}
+
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	inline typename lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::const_iterator lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::end() const noexcept
+	{
+		return _map.end();
+	}
+
+	template <class Key, class T, size_type Capacity, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	inline OnEvict& lru_cache<Key, T, Capacity, OnEvict, Hash, KeyEqual, Alloc>::on_evict() noexcept
+	{
+		return _on_evict;
+	}
+
+	// SHARDED LRU CACHE IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class Key, class T, size_type Capacity, size_type Shards, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::sharded_lru_cache(const OnEvict& on_evict, const Alloc& alloc) :
+		sharded_lru_cache(on_evict, alloc, std::make_index_sequence<Shards>())
+	{
+
+	}
+
+	template <class Key, class T, size_type Capacity, size_type Shards, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <size_type... I>
+	sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::sharded_lru_cache(const OnEvict& on_evict, const Alloc& alloc, std::index_sequence<I...>) :
+		_hash(),
+		_shards{ ((void)I, shard(on_evict, alloc))... }
+	{
+
+	}
+
+	// ---------------
+	// LOOKUP
+	// ---------------
+	template <class Key, class T, size_type Capacity, size_type Shards, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <class K>
+	std::optional<T> sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::get(const K& key)
+	{
+		shard& s = shard_for(key);
+		std::lock_guard<std::mutex> guard(s.lock);
+
+		T* value = s.cache.get(key);
+		if (!value)
+		{
+			return std::nullopt;
+		}
+		return *value;
+	}
+
+	template <class Key, class T, size_type Capacity, size_type Shards, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <class K, class F>
+	bool sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::visit(const K& key, F&& f)
+	{
+		shard& s = shard_for(key);
+		std::lock_guard<std::mutex> guard(s.lock);
+
+		T* value = s.cache.get(key);
+		if (!value)
+		{
+			return false;
+		}
+		std::forward<F>(f)(*value);
+		return true;
+	}
+
+	template <class Key, class T, size_type Capacity, size_type Shards, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <class K>
+	bool sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::contains(const K& key) const
+	{
+		shard& s = shard_for(key);
+		std::lock_guard<std::mutex> guard(s.lock);
+		return s.cache.contains(key);
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class Key, class T, size_type Capacity, size_type Shards, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <class K, class M>
+	void sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::put(K&& key, M&& value)
+	{
+		shard& s = shard_for(key);
+		std::lock_guard<std::mutex> guard(s.lock);
+		s.cache.put(std::forward<K>(key), std::forward<M>(value));
+	}
+
+	template <class Key, class T, size_type Capacity, size_type Shards, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	bool sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::erase(const Key& key)
+	{
+		shard& s = shard_for(key);
+		std::lock_guard<std::mutex> guard(s.lock);
+		return s.cache.erase(key);
+	}
+
+	template <class Key, class T, size_type Capacity, size_type Shards, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	void sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::clear()
+	{
+		for (auto& s : _shards)
+		{
+			std::lock_guard<std::mutex> guard(s.lock);
+			s.cache.clear();
+		}
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class Key, class T, size_type Capacity, size_type Shards, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	size_type sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::size() const
+	{
+		size_type total = 0;
+		for (auto& s : _shards)
+		{
+			std::lock_guard<std::mutex> guard(s.lock);
+			total += s.cache.size();
+		}
+		return total;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class Key, class T, size_type Capacity, size_type Shards, class OnEvict, class Hash, class KeyEqual, class Alloc>
+	template <class K>
+	inline typename sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::shard&
+		sharded_lru_cache<Key, T, Capacity, Shards, OnEvict, Hash, KeyEqual, Alloc>::shard_for(const K& key) const
+	{
+		// The top bits of a different multiplicative mix than the one linkedhashmap uses
+		const std::uint64_t h = static_cast<std::uint64_t>(_hash(key)) * 0xFF51AFD7ED558CCDull;
+		return _shards[static_cast<size_type>(h >> 40) & (Shards - 1)];
+	}
+}
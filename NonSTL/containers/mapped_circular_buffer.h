@@ -0,0 +1,488 @@
+// mapped_circular_buffer.h
+// A non-stl header only implementation of a persistent circular buffer stored in a memory mapped file.
+// Note, the standard is used for some components such as std::atomic and std::system_error
+// Note, this component relies on POSIX mmap and is only available on POSIX systems
+
+/*
+ * A mapped_circular_buffer keeps the last capacity() elements pushed into it in a file, so they survive the
+ * process crashing and can be read back after a restart, e.g. as a flight recorder of recent events.
+ * The file holds a header page with the head and tail, followed by the ring data. The ring data is mapped
+ * twice, back to back, so the slot after the last one is the first one again: the contents are always a
+ * single contiguous span, even when they wrap around, and pushing never splits an element.
+ * Elements are written straight into the mapping, there is no serialization on the hot path. Once the
+ * process is gone the kernel writes the pages back, flush() only matters to survive a machine crash.
+ * Reopening an existing file maps it again without reading or copying the elements.
+ * T must be trivially copyable since its bytes are persisted as is.
+ * This class is not thread safe.
+ */
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Includes
+#include <atomic>			// std::atomic
+#include <cerrno>			// errno
+#include <cstdint>			// std::uint32_t, std::uint64_t
+#include <cstring>			// std::memcpy
+#include <new>				// placement new, std::launder
+#include <numeric>			// std::lcm
+#include <string>			// std::string
+#include <system_error>		// std::system_error, std::system_category
+#include <type_traits>		// std::is_trivially_copyable
+#include <utility>			// std::exchange
+
+#include <fcntl.h>			// open
+#include <sys/mman.h>		// mmap, munmap, msync
+#include <sys/stat.h>		// fstat
+#include <unistd.h>			// close, ftruncate, sysconf
+
+#include "span.h"			// non_stl::span
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter T is the trivially copyable object being stored within the container
+	template <class T>
+	class mapped_circular_buffer
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "mapped_circular_buffer requires a trivially copyable type");
+
+		// Layout of the first page of the file
+		struct header
+		{
+			std::uint64_t magic;
+			std::uint32_t version;
+			std::uint32_t element_size;
+			std::uint64_t capacity;
+
+			// Free running positions of the oldest element and one past the newest element
+			std::atomic<std::uint64_t> head;
+			std::atomic<std::uint64_t> tail;
+		};
+
+		static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "mapped_circular_buffer requires lock free 64 bit atomics");
+
+		static constexpr std::uint64_t MAGIC = 0x4e4f4e53544c5242;	// "NONSTLRB"
+		static constexpr std::uint32_t VERSION = 1;
+
+	public:
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Opens the buffer stored in the file at path, creating it if it doesn't exist
+		// A new file is sized for at least capacity elements, rounded up so the ring fills whole pages
+		// An existing file keeps the capacity it was created with and its contents
+		// Throws std::system_error if the file can't be opened or mapped, or holds a buffer
+		// of a different element size
+		mapped_circular_buffer(const std::string& path, size_type capacity);
+
+		// The mapping is owned by a single object and can't be copied
+		mapped_circular_buffer(const mapped_circular_buffer&) = delete;
+		mapped_circular_buffer& operator=(const mapped_circular_buffer&) = delete;
+
+		// Move constructor
+		// Other is left without a mapping and may only be destroyed or assigned to
+		mapped_circular_buffer(mapped_circular_buffer&& other) noexcept;
+		mapped_circular_buffer& operator=(mapped_circular_buffer&& rhs) noexcept;
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+
+		// Unmaps the file, the contents stay in it
+		~mapped_circular_buffer();
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns a reference to the element at position n in the buffer
+		// with no range check
+		T& operator[](size_type n) noexcept;
+		const T& operator[](size_type n) const noexcept;
+
+		// Returns a reference to the first element in the buffer
+		T& front() noexcept;
+		const T& front() const noexcept;
+
+		// Returns a reference to the last element in the buffer
+		T& back() noexcept;
+		const T& back() const noexcept;
+
+		// Returns every element, oldest first, as a single contiguous span
+		span<T> contents() noexcept;
+		span<const T> contents() const noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of elements in the buffer
+		size_type size() const noexcept;
+
+		// Returns whether the buffer is empty
+		// (i.e. whether its size is 0)
+		bool empty() const noexcept;
+
+		// Returns the amount of elements the buffer holds before it overwrites the oldest one
+		size_type capacity() const noexcept;
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Adds a new element at the end of the buffer, overwriting the oldest one when full
+		void push_back(const T& val) noexcept;
+
+		// Adds n elements copied from src at the end of the buffer, as if by n calls to push_back
+		// Only the last capacity() elements of src are kept if n > capacity()
+		// Performs a single copy thanks to the mirrored mapping
+		void push_back_n(const T* src, size_type n) noexcept;
+
+		// Removes the first element in the buffer
+		void pop_front() noexcept;
+
+		// Removes every element from the buffer
+		void clear() noexcept;
+
+		// ---------------
+		// PERSISTENCE
+		// ---------------
+
+		// Writes the mapping back to the file and waits for it to reach the disk
+		// Throws std::system_error if the write fails
+		void flush();
+
+	private:
+		// Private functions
+
+		// Throws std::system_error for the current errno after releasing what was acquired so far
+		[[noreturn]] void fail(const char* what);
+
+		// Unmaps everything and closes the file
+		void unmap() noexcept;
+
+		// Returns the slot holding position pos
+		T* slot(std::uint64_t pos) const noexcept;
+
+		// Member variables
+
+		// File descriptor of the backing file
+		int d_fd;
+
+		// Header page mapping
+		header* d_header;
+
+		// Start of the two mirrored mappings of the ring data
+		unsigned char* d_data;
+
+		// Size in bytes of one mapping of the ring data
+		size_type d_data_bytes;
+
+		// Amount of elements in the ring
+		size_type d_capacity;
+	};
+
+	// IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T>
+	mapped_circular_buffer<T>::mapped_circular_buffer(const std::string& path, size_type capacity)
+		: d_fd(-1)
+		, d_header(nullptr)
+		, d_data(nullptr)
+		, d_data_bytes(0)
+		, d_capacity(0)
+	{
+		const size_type page = static_cast<size_type>(sysconf(_SC_PAGESIZE));
+
+		d_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+		if (d_fd < 0) {
+			fail("mapped_circular_buffer: open");
+		}
+
+		struct stat st;
+		if (::fstat(d_fd, &st) != 0) {
+			fail("mapped_circular_buffer: fstat");
+		}
+		const bool created = st.st_size == 0;
+
+		if (created) {
+			// Each mapping must be whole pages and whole elements so the mirror lines up
+			const size_type unit = std::lcm(page, sizeof(T));
+			const size_type wanted = (capacity ? capacity : 1) * sizeof(T);
+			d_data_bytes = (wanted + unit - 1) / unit * unit;
+
+			if (::ftruncate(d_fd, static_cast<off_t>(page + d_data_bytes)) != 0) {
+				fail("mapped_circular_buffer: ftruncate");
+			}
+		}
+		else if (static_cast<size_type>(st.st_size) <= page) {
+			errno = EINVAL;
+			fail("mapped_circular_buffer: truncated file");
+		}
+		else {
+			d_data_bytes = static_cast<size_type>(st.st_size) - page;
+		}
+
+		void* head_page = ::mmap(nullptr, page, PROT_READ | PROT_WRITE, MAP_SHARED, d_fd, 0);
+		if (head_page == MAP_FAILED) {
+			fail("mapped_circular_buffer: mmap header");
+		}
+
+		if (created) {
+			d_header = ::new (head_page) header{ MAGIC, VERSION, static_cast<std::uint32_t>(sizeof(T)),
+				d_data_bytes / sizeof(T), { 0 }, { 0 } };
+		}
+		else {
+			// Reopening reuses the header written by the previous owner in place
+			d_header = std::launder(static_cast<header*>(head_page));
+		}
+
+		if (!created && (d_header->magic != MAGIC || d_header->version != VERSION ||
+			d_header->element_size != sizeof(T) || d_header->capacity * sizeof(T) != d_data_bytes)) {
+			errno = EINVAL;
+			fail("mapped_circular_buffer: file holds a different buffer");
+		}
+		d_capacity = static_cast<size_type>(d_header->capacity);
+
+		// A torn or corrupted header page could otherwise claim more elements than the ring holds
+		if (!created) {
+			const std::uint64_t head = d_header->head.load(std::memory_order_relaxed);
+			const std::uint64_t tail = d_header->tail.load(std::memory_order_relaxed);
+			if (tail < head || tail - head > d_capacity) {
+				errno = EINVAL;
+				fail("mapped_circular_buffer: corrupted head and tail");
+			}
+		}
+
+		// Reserve room for both mappings, then place the ring data twice inside it
+		void* reserved = ::mmap(nullptr, 2 * d_data_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (reserved == MAP_FAILED) {
+			fail("mapped_circular_buffer: mmap reserve");
+		}
+		d_data = static_cast<unsigned char*>(reserved);
+
+		for (int i = 0; i < 2; ++i) {
+			void* mirror = ::mmap(d_data + i * d_data_bytes, d_data_bytes, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_FIXED, d_fd, static_cast<off_t>(page));
+			if (mirror == MAP_FAILED) {
+				fail("mapped_circular_buffer: mmap data");
+			}
+		}
+	}
+
+	template <class T>
+	mapped_circular_buffer<T>::mapped_circular_buffer(mapped_circular_buffer&& other) noexcept
+		: d_fd(std::exchange(other.d_fd, -1))
+		, d_header(std::exchange(other.d_header, nullptr))
+		, d_data(std::exchange(other.d_data, nullptr))
+		, d_data_bytes(std::exchange(other.d_data_bytes, 0))
+		, d_capacity(std::exchange(other.d_capacity, 0))
+	{
+
+	}
+
+	// ---------------
+	// OPERATOR=
+	// ---------------
+	template <class T>
+	mapped_circular_buffer<T>& mapped_circular_buffer<T>::operator=(mapped_circular_buffer&& rhs) noexcept
+	{
+		if (this != &rhs) {
+			unmap();
+			d_fd = std::exchange(rhs.d_fd, -1);
+			d_header = std::exchange(rhs.d_header, nullptr);
+			d_data = std::exchange(rhs.d_data, nullptr);
+			d_data_bytes = std::exchange(rhs.d_data_bytes, 0);
+			d_capacity = std::exchange(rhs.d_capacity, 0);
+		}
+		return *this;
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class T>
+	mapped_circular_buffer<T>::~mapped_circular_buffer()
+	{
+		unmap();
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T>
+	T& mapped_circular_buffer<T>::operator[](size_type n) noexcept
+	{
+		return *slot(d_header->head.load(std::memory_order_relaxed) + n);
+	}
+
+	template <class T>
+	const T& mapped_circular_buffer<T>::operator[](size_type n) const noexcept
+	{
+		return *slot(d_header->head.load(std::memory_order_relaxed) + n);
+	}
+
+	template <class T>
+	T& mapped_circular_buffer<T>::front() noexcept
+	{
+		return this->operator[](0);
+	}
+
+	template <class T>
+	const T& mapped_circular_buffer<T>::front() const noexcept
+	{
+		return this->operator[](0);
+	}
+
+	template <class T>
+	T& mapped_circular_buffer<T>::back() noexcept
+	{
+		return *slot(d_header->tail.load(std::memory_order_relaxed) - 1);
+	}
+
+	template <class T>
+	const T& mapped_circular_buffer<T>::back() const noexcept
+	{
+		return *slot(d_header->tail.load(std::memory_order_relaxed) - 1);
+	}
+
+	template <class T>
+	span<T> mapped_circular_buffer<T>::contents() noexcept
+	{
+		// The mirror makes the elements past the end of the first mapping continue into the second
+		return span<T>(&front(), size());
+	}
+
+	template <class T>
+	span<const T> mapped_circular_buffer<T>::contents() const noexcept
+	{
+		return span<const T>(&front(), size());
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T>
+	size_type mapped_circular_buffer<T>::size() const noexcept
+	{
+		return static_cast<size_type>(d_header->tail.load(std::memory_order_relaxed) -
+			d_header->head.load(std::memory_order_relaxed));
+	}
+
+	template <class T>
+	bool mapped_circular_buffer<T>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template <class T>
+	size_type mapped_circular_buffer<T>::capacity() const noexcept
+	{
+		return d_capacity;
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class T>
+	void mapped_circular_buffer<T>::push_back(const T& val) noexcept
+	{
+		push_back_n(&val, 1);
+	}
+
+	template <class T>
+	void mapped_circular_buffer<T>::push_back_n(const T* src, size_type n) noexcept
+	{
+		// Anything before the last capacity() elements would be overwritten anyway
+		if (n > d_capacity) {
+			src += n - d_capacity;
+			n = d_capacity;
+		}
+
+		const std::uint64_t head = d_header->head.load(std::memory_order_relaxed);
+		const std::uint64_t tail = d_header->tail.load(std::memory_order_relaxed);
+
+		// Drop the elements about to be overwritten before writing over them
+		// so a crash part way through never leaves new data where the header expects old data
+		const size_type free = d_capacity - static_cast<size_type>(tail - head);
+		if (n > free) {
+			d_header->head.store(head + (n - free), std::memory_order_release);
+		}
+
+		// A single copy, the mirror takes care of the wraparound
+		std::memcpy(static_cast<void*>(slot(tail)), src, n * sizeof(T));
+
+		// Publish the elements only once they are written
+		d_header->tail.store(tail + n, std::memory_order_release);
+	}
+
+	template <class T>
+	void mapped_circular_buffer<T>::pop_front() noexcept
+	{
+		if (!empty()) {
+			d_header->head.fetch_add(1, std::memory_order_release);
+		}
+	}
+
+	template <class T>
+	void mapped_circular_buffer<T>::clear() noexcept
+	{
+		d_header->head.store(d_header->tail.load(std::memory_order_relaxed), std::memory_order_release);
+	}
+
+	// ---------------
+	// PERSISTENCE
+	// ---------------
+	template <class T>
+	void mapped_circular_buffer<T>::flush()
+	{
+		// Data first so the header never points at elements which didn't reach the disk
+		if (::msync(d_data, d_data_bytes, MS_SYNC) != 0 ||
+			::msync(d_header, static_cast<size_type>(sysconf(_SC_PAGESIZE)), MS_SYNC) != 0) {
+			throw std::system_error(errno, std::system_category(), "mapped_circular_buffer: msync");
+		}
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T>
+	void mapped_circular_buffer<T>::fail(const char* what)
+	{
+		const int error = errno;
+		unmap();
+		throw std::system_error(error, std::system_category(), what);
+	}
+
+	template <class T>
+	void mapped_circular_buffer<T>::unmap() noexcept
+	{
+		if (d_data) {
+			::munmap(d_data, 2 * d_data_bytes);
+			d_data = nullptr;
+		}
+		if (d_header) {
+			::munmap(d_header, static_cast<size_type>(sysconf(_SC_PAGESIZE)));
+			d_header = nullptr;
+		}
+		if (d_fd >= 0) {
+			::close(d_fd);
+			d_fd = -1;
+		}
+	}
+
+	template <class T>
+	T* mapped_circular_buffer<T>::slot(std::uint64_t pos) const noexcept
+	{
+		return reinterpret_cast<T*>(d_data + static_cast<size_type>(pos % d_capacity) * sizeof(T));
+	}
+}
+
+#endif
@@ -0,0 +1,355 @@
+// mpmc_ring.h
+// A non-stl header only implementation of a lock-free bounded multi producer multi consumer queue.
+// Note, the standard is used for some components such as std::array and std::atomic
+
+/*
+ * An mpmc_ring is a fixed size ring which any number of threads may push into and pop from concurrently.
+ * Like circular_buffer the storage is a std::array of N slots inside the object, no allocation is made.
+ * Each slot carries a sequence number (D. Vyukov's bounded queue) telling whether it is ready to be written
+ * for a given lap of the ring or holds an element ready to be read. A thread claims a position with a single
+ * compare exchange on the shared enqueue or dequeue counter and then only touches its own slot, so producers
+ * and consumers never wait on each other unless the ring is full or empty.
+ * The try_ functions never block. push and pop spin, yielding the thread, until they succeed.
+ * Elements are constructed on push and destroyed on pop.
+ */
+
+#pragma once
+
+// Includes
+#include <array>			// std::array
+#include <atomic>			// std::atomic, std::memory_order
+#include <cstddef>			// std::ptrdiff_t
+#include <new>				// placement new, std::launder
+#include <thread>			// std::this_thread::yield
+#include <type_traits>		// std::is_nothrow_constructible
+#include <utility>			// std::forward, std::move
+
+#include "../memory/cache_line.h"	// non_stl::cache_line_size
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter T is the generic object being stored within the container
+	// size_type N is the amount of elements the ring can hold which cannot be changed
+	// A power of two N turns every index computation into a mask
+	template <class T, size_type N>
+	class mpmc_ring
+	{
+		static_assert(N > 1, "mpmc_ring requires a capacity of at least two elements");
+
+		struct slot
+		{
+			// Equal to the position when the slot is free for the producer claiming that position
+			// Equal to the position + 1 once the element for that position is constructed
+			std::atomic<size_type> sequence;
+
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+		using container = std::array<slot, N>;
+
+	public:
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor
+		mpmc_ring() noexcept;
+
+		// The ring is shared between threads by reference and is neither copyable nor movable
+		mpmc_ring(const mpmc_ring&) = delete;
+		mpmc_ring& operator=(const mpmc_ring&) = delete;
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+
+		// Destroys every element still in the ring
+		// No thread may be using the ring
+		~mpmc_ring();
+
+		// ---------------
+		// PRODUCERS
+		// ---------------
+
+		// Adds a new element at the end of the ring
+		// Returns false, leaving val untouched, if the ring is full
+		bool try_push(const T& val) noexcept(std::is_nothrow_copy_constructible<T>::value);
+		bool try_push(T&& val) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+		// Constructs a new element at the end of the ring from args
+		// Returns false without constructing anything if the ring is full
+		template <class... Args>
+		bool try_emplace(Args&& ... args) noexcept(std::is_nothrow_constructible<T, Args...>::value);
+
+		// Adds a new element at the end of the ring, waiting for room if the ring is full
+		void push(const T& val) noexcept(std::is_nothrow_copy_constructible<T>::value);
+		void push(T&& val) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+		// Constructs a new element at the end of the ring from args, waiting for room if the ring is full
+		template <class... Args>
+		void emplace(Args&& ... args) noexcept(std::is_nothrow_constructible<T, Args...>::value);
+
+		// ---------------
+		// CONSUMERS
+		// ---------------
+
+		// Moves the first element into out and removes it from the ring
+		// Returns false, leaving out untouched, if the ring is empty
+		bool try_pop(T& out) noexcept(std::is_nothrow_move_assignable<T>::value);
+
+		// Moves up to n elements into out, in order, with a single claim on the ring
+		// Returns the amount of elements moved, which is 0 if the ring is empty
+		size_type try_pop_n(T* out, size_type n) noexcept(std::is_nothrow_move_assignable<T>::value);
+
+		// Moves the first element into out and removes it from the ring,
+		// waiting for an element if the ring is empty
+		void pop(T& out) noexcept(std::is_nothrow_move_assignable<T>::value);
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of elements in the ring
+		// A snapshot which may be stale by the time it is returned while other threads are active
+		size_type size() const noexcept;
+
+		// Returns whether the ring is empty, with the same caveat as size()
+		bool empty() const noexcept;
+
+		// Returns the maximum number of elements the ring can hold
+		static constexpr size_type capacity() noexcept;
+
+	private:
+		// Returns the slot used by position pos
+		slot& slot_at(size_type pos) noexcept;
+
+		// Returns the element held by s
+		static T* element(slot& s) noexcept;
+
+		// Member variables
+
+		// Slots holding the ring data
+		container d_container;
+
+		// Position the next element is pushed into, shared by every producer
+		alignas(cache_line_size) std::atomic<size_type> d_enqueue_pos;
+
+		// Position of the oldest element, shared by every consumer
+		// The alignment also pads the ring to a whole cache line so nothing else shares it
+		alignas(cache_line_size) std::atomic<size_type> d_dequeue_pos;
+	};
+
+	// IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, size_type N>
+	mpmc_ring<T, N>::mpmc_ring() noexcept
+		: d_enqueue_pos(0)
+		, d_dequeue_pos(0)
+	{
+		for (size_type i = 0; i < N; ++i) {
+			d_container[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class T, size_type N>
+	mpmc_ring<T, N>::~mpmc_ring()
+	{
+		const size_type end = d_enqueue_pos.load(std::memory_order_relaxed);
+		for (size_type pos = d_dequeue_pos.load(std::memory_order_relaxed); pos != end; ++pos) {
+			element(slot_at(pos))->~T();
+		}
+	}
+
+	// ---------------
+	// PRODUCERS
+	// ---------------
+	template <class T, size_type N>
+	bool mpmc_ring<T, N>::try_push(const T& val) noexcept(std::is_nothrow_copy_constructible<T>::value)
+	{
+		return try_emplace(val);
+	}
+
+	template <class T, size_type N>
+	bool mpmc_ring<T, N>::try_push(T&& val) noexcept(std::is_nothrow_move_constructible<T>::value)
+	{
+		return try_emplace(std::move(val));
+	}
+
+	template <class T, size_type N>
+	template <class... Args>
+	bool mpmc_ring<T, N>::try_emplace(Args&& ... args) noexcept(std::is_nothrow_constructible<T, Args...>::value)
+	{
+		size_type pos = d_enqueue_pos.load(std::memory_order_relaxed);
+		for (;;) {
+			slot& s = slot_at(pos);
+
+			// Acquire pairs with the release of the consumer which freed the slot
+			const size_type seq = s.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+
+			if (diff == 0) {
+				// The slot is free for this lap, try to claim the position
+				// On failure pos is reloaded with the position another producer left behind
+				if (d_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					::new (static_cast<void*>(s.storage)) T(std::forward<Args>(args)...);
+
+					// Publish the element, pairs with the acquire in the consumers
+					s.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0) {
+				// The slot still holds the element from the previous lap, the ring is full
+				return false;
+			}
+			else {
+				// Another producer claimed pos already
+				pos = d_enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	template <class T, size_type N>
+	void mpmc_ring<T, N>::push(const T& val) noexcept(std::is_nothrow_copy_constructible<T>::value)
+	{
+		emplace(val);
+	}
+
+	template <class T, size_type N>
+	void mpmc_ring<T, N>::push(T&& val) noexcept(std::is_nothrow_move_constructible<T>::value)
+	{
+		emplace(std::move(val));
+	}
+
+	template <class T, size_type N>
+	template <class... Args>
+	void mpmc_ring<T, N>::emplace(Args&& ... args) noexcept(std::is_nothrow_constructible<T, Args...>::value)
+	{
+		// args are only forwarded by the attempt that succeeds
+		while (!try_emplace(std::forward<Args>(args)...)) {
+			std::this_thread::yield();
+		}
+	}
+
+	// ---------------
+	// CONSUMERS
+	// ---------------
+	template <class T, size_type N>
+	bool mpmc_ring<T, N>::try_pop(T& out) noexcept(std::is_nothrow_move_assignable<T>::value)
+	{
+		return try_pop_n(&out, 1) == 1;
+	}
+
+	template <class T, size_type N>
+	size_type mpmc_ring<T, N>::try_pop_n(T* out, size_type n) noexcept(std::is_nothrow_move_assignable<T>::value)
+	{
+		if (n > N) {
+			n = N;
+		}
+
+		size_type pos = d_dequeue_pos.load(std::memory_order_relaxed);
+		size_type count;
+		for (;;) {
+			// Count the run of published elements starting at pos
+			// Acquire pairs with the release of the producers so the elements are fully constructed
+			count = 0;
+			while (count < n) {
+				const size_type seq = slot_at(pos + count).sequence.load(std::memory_order_acquire);
+				if (static_cast<std::ptrdiff_t>(seq - (pos + count + 1)) != 0) {
+					break;
+				}
+				++count;
+			}
+
+			if (count == 0) {
+				const size_type seq = slot_at(pos).sequence.load(std::memory_order_acquire);
+				if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0) {
+					// Nothing has been published at pos yet, the ring is empty
+					return 0;
+				}
+
+				// Another consumer took pos already
+				pos = d_dequeue_pos.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			// Claim the whole run at once. Published slots can't be taken by producers
+			// so every slot in the run is still ours if the exchange succeeds
+			if (d_dequeue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+				break;
+			}
+		}
+
+		for (size_type i = 0; i < count; ++i) {
+			slot& s = slot_at(pos + i);
+			T* elem = element(s);
+			out[i] = std::move(*elem);
+			elem->~T();
+
+			// Free the slot for the producer of the next lap
+			s.sequence.store(pos + i + N, std::memory_order_release);
+		}
+		return count;
+	}
+
+	template <class T, size_type N>
+	void mpmc_ring<T, N>::pop(T& out) noexcept(std::is_nothrow_move_assignable<T>::value)
+	{
+		while (!try_pop(out)) {
+			std::this_thread::yield();
+		}
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, size_type N>
+	size_type mpmc_ring<T, N>::size() const noexcept
+	{
+		const size_type dequeue = d_dequeue_pos.load(std::memory_order_acquire);
+		const size_type enqueue = d_enqueue_pos.load(std::memory_order_acquire);
+
+		// The counters are read separately so the difference may briefly be out of range
+		const auto diff = static_cast<std::ptrdiff_t>(enqueue - dequeue);
+		if (diff < 0) {
+			return 0;
+		}
+		return static_cast<size_type>(diff) > N ? N : static_cast<size_type>(diff);
+	}
+
+	template <class T, size_type N>
+	bool mpmc_ring<T, N>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template <class T, size_type N>
+	constexpr size_type mpmc_ring<T, N>::capacity() noexcept
+	{
+		return N;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T, size_type N>
+	typename mpmc_ring<T, N>::slot& mpmc_ring<T, N>::slot_at(size_type pos) noexcept
+	{
+		// Positions run freely, N being a constant this is a mask whenever N is a power of two
+		return d_container[pos % N];
+	}
+
+	template <class T, size_type N>
+	T* mpmc_ring<T, N>::element(slot& s) noexcept
+	{
+		return std::launder(reinterpret_cast<T*>(s.storage));
+	}
+}
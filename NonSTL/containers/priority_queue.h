@@ -0,0 +1,787 @@
+// priority_queue.h
+// A non-stl header only implementation of std::priority_queue on a d-ary heap, together with
+// an indexed variant whose elements can be updated or erased in place.
+// Note, the standard is used for some components such as std::less
+
+/*
+ * The heap is stored implicitly in a contiguous container: the children of the element at i are at
+ * Arity * i + 1 up to Arity * i + Arity. Wider heaps are shallower, so a push sifts up through fewer levels
+ * and a pop sifts down through fewer levels each comparing Arity adjacent children, which share a cache line.
+ * A 4-ary heap usually beats the binary heap of std::priority_queue on both, 2 gives the classic binary heap.
+ * As for std::priority_queue the top is the element ranked highest by Compare, the largest one for std::less,
+ * use std::greater for a min heap.
+ * The heap algorithms are also provided as free functions over random access iterators.
+ *
+ * indexed_priority_queue hands out a handle for every element pushed, through which the element can be
+ * read, updated in either direction (decrease_key of the classic algorithms) or erased in O(log n).
+ * A handle stays valid until its element is popped or erased, after which it may be handed out again.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::min
+#include <functional>		// std::less
+#include <initializer_list>	// std::initializer_list
+#include <utility>			// std::forward, std::move, std::swap
+
+#include "vector.h"			// non_stl::vector
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// ---------------
+	// HEAP ALGORITHMS
+	// ---------------
+
+	// Moves the element at i of the heap at first up until its parent ranks at least as high
+	template <size_type Arity, class RandomIt, class Compare>
+	void dary_sift_up(RandomIt first, size_type i, Compare& comp);
+
+	// Moves the element at i of the n element heap at first down until it ranks at least as high as its children
+	template <size_type Arity, class RandomIt, class Compare>
+	void dary_sift_down(RandomIt first, size_type n, size_type i, Compare& comp);
+
+	// Adds the element at last - 1 to the heap [first, last - 1)
+	template <size_type Arity, class RandomIt, class Compare>
+	void dary_push_heap(RandomIt first, RandomIt last, Compare comp);
+
+	// Moves the top of the heap [first, last) to last - 1 and makes [first, last - 1) a heap
+	template <size_type Arity, class RandomIt, class Compare>
+	void dary_pop_heap(RandomIt first, RandomIt last, Compare comp);
+
+	// Makes [first, last) a heap in O(n)
+	template <size_type Arity, class RandomIt, class Compare>
+	void dary_make_heap(RandomIt first, RandomIt last, Compare comp);
+
+	// Returns whether [first, last) is a heap
+	template <size_type Arity, class RandomIt, class Compare>
+	bool dary_is_heap(RandomIt first, RandomIt last, Compare comp);
+
+	// Template parameter T is the generic object being stored within the container
+	// Template parameter Container is the random access container holding the heap
+	// Template parameter Compare ranks the elements, the top being the highest
+	// Template parameter Arity is the amount of children of every heap node, 2 for a binary heap
+	template <class T, class Container = vector<T>, class Compare = std::less<T>, size_type Arity = 4>
+	class priority_queue
+	{
+		static_assert(Arity >= 2, "priority_queue requires an arity of at least 2");
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		using container_type = Container;
+		using value_compare = Compare;
+		using value_type = T;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Constructs an empty queue
+		priority_queue() = default;
+		explicit priority_queue(const Compare& compare);
+
+		// Constructs the queue on a copy of, or by moving, cont which is heapified in O(n)
+		priority_queue(const Compare& compare, const Container& cont);
+		priority_queue(const Compare& compare, Container&& cont);
+
+		// Range constructor
+		// Heapifies the elements of [first, last) in O(n)
+		template <class InputIterator>
+		priority_queue(InputIterator first, InputIterator last, const Compare& compare = Compare());
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns the highest ranked element, the queue must not be empty
+		const_reference top() const;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns whether the queue is empty
+		// (i.e. whether its size is 0)
+		bool empty() const;
+
+		// Returns the number of elements
+		size_type size() const;
+
+		// Returns the amount of children of every heap node
+		static constexpr size_type arity() noexcept { return Arity; }
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Inserts val, O(log n)
+		void push(const value_type& val);
+		void push(value_type&& val);
+
+		// Constructs an element from args and inserts it
+		template <class... Args>
+		void emplace(Args&& ... args);
+
+		// Inserts every element of [first, last)
+		// When they are many compared to the elements already queued the whole heap is rebuilt in O(n),
+		// otherwise they are sifted up one by one
+		template <class InputIterator>
+		void push_bulk(InputIterator first, InputIterator last);
+		void push_bulk(std::initializer_list<value_type> il);
+
+		// Removes the highest ranked element, the queue must not be empty
+		void pop();
+
+		// Replaces the highest ranked element with val in a single sift down,
+		// cheaper than pop followed by push
+		void replace_top(value_type val);
+
+		// Exchanges the content of the queue with the content of x
+		void swap(priority_queue& x);
+
+		// ---------------
+		// END INTERFACE
+		// ---------------
+	protected:
+		// The heap and its ordering, accessible to derived adapters as for std::priority_queue
+		Container c;
+		Compare comp;
+	};
+
+	template <class T, class Container, class Compare, size_type Arity>
+	void swap(priority_queue<T, Container, Compare, Arity>& lhs, priority_queue<T, Container, Compare, Arity>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+	// Template parameter T is the generic object being stored within the container
+	// Template parameter Compare ranks the elements, the top being the highest
+	// Template parameter Arity is the amount of children of every heap node, 2 for a binary heap
+	template <class T, class Compare = std::less<T>, size_type Arity = 4>
+	class indexed_priority_queue
+	{
+		static_assert(Arity >= 2, "indexed_priority_queue requires an arity of at least 2");
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		using value_type = T;
+		using value_compare = Compare;
+		using const_reference = const T&;
+
+		// Identifies a queued element
+		using handle = size_type;
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Constructs an empty queue
+		indexed_priority_queue() = default;
+		explicit indexed_priority_queue(const Compare& compare);
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns the highest ranked element, the queue must not be empty
+		const_reference top() const;
+
+		// Returns the handle of the highest ranked element, the queue must not be empty
+		handle top_handle() const;
+
+		// Returns the element of h, which must be queued
+		const_reference operator[](handle h) const;
+
+		// Returns whether h refers to a queued element
+		bool contains(handle h) const noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns whether the queue is empty
+		// (i.e. whether its size is 0)
+		bool empty() const noexcept;
+
+		// Returns the number of elements
+		size_type size() const noexcept;
+
+		// Makes room for n elements
+		void reserve(size_type n);
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Inserts val, O(log n)
+		// Returns the handle of the new element
+		handle push(const T& val);
+		handle push(T&& val);
+
+		// Constructs an element from args and inserts it
+		template <class... Args>
+		handle emplace(Args&& ... args);
+
+		// Removes the highest ranked element, the queue must not be empty
+		void pop();
+
+		// Replaces the element of h with val, moving it up or down as needed, O(log n)
+		void update(handle h, T val);
+
+		// Replaces the element of h with val which must rank at least as high, only moving it up
+		// This is decrease_key for a min heap (Compare = std::greater)
+		void decrease_key(handle h, T val);
+
+		// Removes the element of h, O(log n)
+		void erase(handle h);
+
+		// Removes every element, every handle is released
+		void clear() noexcept;
+
+		// ---------------
+		// END INTERFACE
+		// ---------------
+	private:
+		// Heap nodes hold their handle so moving them keeps _position up to date
+		struct entry
+		{
+			T value;
+			handle owner;
+		};
+
+		static constexpr size_type npos = static_cast<size_type>(-1);
+
+		// Private functions
+
+		// Allocates a handle and appends val as the last heap node
+		template <class... Args>
+		handle append(Args&& ... args);
+
+		// Moves the node at i up or down to its place
+		void sift_up(size_type i);
+		void sift_down(size_type i);
+
+		// Places e as the heap node at i
+		void place(size_type i, entry&& e);
+
+		// Member variables
+
+		// The heap
+		vector<entry> _heap;
+
+		// Heap position of every handle, npos for released ones
+		vector<size_type> _position;
+
+		// Released handles, reused before new ones
+		vector<handle> _free;
+
+		Compare _comp;
+	};
+
+	// HEAP ALGORITHMS IMPL
+
+	template <size_type Arity, class RandomIt, class Compare>
+	void dary_sift_up(RandomIt first, size_type i, Compare& comp)
+	{
+		auto value = std::move(first[i]);
+		while (i > 0)
+		{
+			const size_type parent = (i - 1) / Arity;
+			if (!comp(first[parent], value))
+			{
+				break;
+			}
+			first[i] = std::move(first[parent]);
+			i = parent;
+		}
+		first[i] = std::move(value);
+	}
+
+	template <size_type Arity, class RandomIt, class Compare>
+	void dary_sift_down(RandomIt first, size_type n, size_type i, Compare& comp)
+	{
+		auto value = std::move(first[i]);
+		for (;;)
+		{
+			const size_type child = Arity * i + 1;
+			if (child >= n)
+			{
+				break;
+			}
+
+			// Find the highest ranked child, a full set of children is a fixed length loop the compiler unrolls
+			size_type best = child;
+			if (child + Arity <= n)
+			{
+				for (size_type k = 1; k < Arity; ++k)
+				{
+					best = comp(first[best], first[child + k]) ? child + k : best;
+				}
+			}
+			else
+			{
+				for (size_type k = child + 1; k < n; ++k)
+				{
+					best = comp(first[best], first[k]) ? k : best;
+				}
+			}
+
+			if (!comp(value, first[best]))
+			{
+				break;
+			}
+			first[i] = std::move(first[best]);
+			i = best;
+		}
+		first[i] = std::move(value);
+	}
+
+	template <size_type Arity, class RandomIt, class Compare>
+	void dary_push_heap(RandomIt first, RandomIt last, Compare comp)
+	{
+		const auto n = static_cast<size_type>(last - first);
+		if (n > 1)
+		{
+			dary_sift_up<Arity>(first, n - 1, comp);
+		}
+	}
+
+	template <size_type Arity, class RandomIt, class Compare>
+	void dary_pop_heap(RandomIt first, RandomIt last, Compare comp)
+	{
+		const auto n = static_cast<size_type>(last - first);
+		if (n > 1)
+		{
+			using std::swap;
+			swap(first[0], first[n - 1]);
+			dary_sift_down<Arity>(first, n - 1, 0, comp);
+		}
+	}
+
+	template <size_type Arity, class RandomIt, class Compare>
+	void dary_make_heap(RandomIt first, RandomIt last, Compare comp)
+	{
+		const auto n = static_cast<size_type>(last - first);
+		if (n < 2)
+		{
+			return;
+		}
+
+		// Sift down every node with children, from the last one up to the root
+		for (size_type i = (n - 2) / Arity + 1; i-- > 0;)
+		{
+			dary_sift_down<Arity>(first, n, i, comp);
+		}
+	}
+
+	template <size_type Arity, class RandomIt, class Compare>
+	bool dary_is_heap(RandomIt first, RandomIt last, Compare comp)
+	{
+		const auto n = static_cast<size_type>(last - first);
+		for (size_type i = 1; i < n; ++i)
+		{
+			if (comp(first[(i - 1) / Arity], first[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// PRIORITY QUEUE IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, class Container, class Compare, size_type Arity>
+	priority_queue<T, Container, Compare, Arity>::priority_queue(const Compare& compare) :
+		comp(compare)
+	{
+
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	priority_queue<T, Container, Compare, Arity>::priority_queue(const Compare& compare, const Container& cont) :
+		c(cont),
+		comp(compare)
+	{
+		dary_make_heap<Arity>(c.begin(), c.end(), comp);
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	priority_queue<T, Container, Compare, Arity>::priority_queue(const Compare& compare, Container&& cont) :
+		c(std::move(cont)),
+		comp(compare)
+	{
+		dary_make_heap<Arity>(c.begin(), c.end(), comp);
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	template <class InputIterator>
+	priority_queue<T, Container, Compare, Arity>::priority_queue(InputIterator first, InputIterator last, const Compare& compare) :
+		c(first, last),
+		comp(compare)
+	{
+		dary_make_heap<Arity>(c.begin(), c.end(), comp);
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T, class Container, class Compare, size_type Arity>
+	inline typename priority_queue<T, Container, Compare, Arity>::const_reference priority_queue<T, Container, Compare, Arity>::top() const
+	{
+		return c.front();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, class Container, class Compare, size_type Arity>
+	inline bool priority_queue<T, Container, Compare, Arity>::empty() const
+	{
+		return c.empty();
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	inline size_type priority_queue<T, Container, Compare, Arity>::size() const
+	{
+		return c.size();
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class T, class Container, class Compare, size_type Arity>
+	void priority_queue<T, Container, Compare, Arity>::push(const value_type& val)
+	{
+		c.push_back(val);
+		dary_sift_up<Arity>(c.begin(), c.size() - 1, comp);
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	void priority_queue<T, Container, Compare, Arity>::push(value_type&& val)
+	{
+		c.push_back(std::move(val));
+		dary_sift_up<Arity>(c.begin(), c.size() - 1, comp);
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	template <class... Args>
+	void priority_queue<T, Container, Compare, Arity>::emplace(Args&& ... args)
+	{
+		c.emplace_back(std::forward<Args>(args)...);
+		dary_sift_up<Arity>(c.begin(), c.size() - 1, comp);
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	template <class InputIterator>
+	void priority_queue<T, Container, Compare, Arity>::push_bulk(InputIterator first, InputIterator last)
+	{
+		const size_type old_size = c.size();
+		c.insert(c.end(), first, last);
+
+		const size_type n = c.size();
+		const size_type added = n - old_size;
+		if (added == 0)
+		{
+			return;
+		}
+
+		// Sifting up costs at most the depth of the heap per element, rebuilding costs O(n) overall
+		size_type depth = 0;
+		for (size_type level = 1, total = 1; total < n; level *= Arity, total += level)
+		{
+			++depth;
+		}
+
+		if (added * depth >= n)
+		{
+			dary_make_heap<Arity>(c.begin(), c.end(), comp);
+		}
+		else
+		{
+			for (size_type i = old_size; i < n; ++i)
+			{
+				dary_sift_up<Arity>(c.begin(), i, comp);
+			}
+		}
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	void priority_queue<T, Container, Compare, Arity>::push_bulk(std::initializer_list<value_type> il)
+	{
+		push_bulk(il.begin(), il.end());
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	void priority_queue<T, Container, Compare, Arity>::pop()
+	{
+		dary_pop_heap<Arity>(c.begin(), c.end(), comp);
+		c.pop_back();
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	void priority_queue<T, Container, Compare, Arity>::replace_top(value_type val)
+	{
+		c.front() = std::move(val);
+		dary_sift_down<Arity>(c.begin(), c.size(), 0, comp);
+	}
+
+	template <class T, class Container, class Compare, size_type Arity>
+	void priority_queue<T, Container, Compare, Arity>::swap(priority_queue& x)
+	{
+		using std::swap;
+		swap(c, x.c);
+		swap(comp, x.comp);
+	}
+
+	// INDEXED PRIORITY QUEUE IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, class Compare, size_type Arity>
+	indexed_priority_queue<T, Compare, Arity>::indexed_priority_queue(const Compare& compare) :
+		_comp(compare)
+	{
+
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T, class Compare, size_type Arity>
+	inline typename indexed_priority_queue<T, Compare, Arity>::const_reference indexed_priority_queue<T, Compare, Arity>::top() const
+	{
+		return _heap.front().value;
+	}
+
+	template <class T, class Compare, size_type Arity>
+	inline typename indexed_priority_queue<T, Compare, Arity>::handle indexed_priority_queue<T, Compare, Arity>::top_handle() const
+	{
+		return _heap.front().owner;
+	}
+
+	template <class T, class Compare, size_type Arity>
+	inline typename indexed_priority_queue<T, Compare, Arity>::const_reference indexed_priority_queue<T, Compare, Arity>::operator[](handle h) const
+	{
+		return _heap[_position[h]].value;
+	}
+
+	template <class T, class Compare, size_type Arity>
+	inline bool indexed_priority_queue<T, Compare, Arity>::contains(handle h) const noexcept
+	{
+		return h < _position.size() && _position[h] != npos;
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, class Compare, size_type Arity>
+	inline bool indexed_priority_queue<T, Compare, Arity>::empty() const noexcept
+	{
+		return _heap.empty();
+	}
+
+	template <class T, class Compare, size_type Arity>
+	inline size_type indexed_priority_queue<T, Compare, Arity>::size() const noexcept
+	{
+		return _heap.size();
+	}
+
+	template <class T, class Compare, size_type Arity>
+	void indexed_priority_queue<T, Compare, Arity>::reserve(size_type n)
+	{
+		_heap.reserve(n);
+		_position.reserve(n);
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class T, class Compare, size_type Arity>
+	typename indexed_priority_queue<T, Compare, Arity>::handle indexed_priority_queue<T, Compare, Arity>::push(const T& val)
+	{
+		return append(val);
+	}
+
+	template <class T, class Compare, size_type Arity>
+	typename indexed_priority_queue<T, Compare, Arity>::handle indexed_priority_queue<T, Compare, Arity>::push(T&& val)
+	{
+		return append(std::move(val));
+	}
+
+	template <class T, class Compare, size_type Arity>
+	template <class... Args>
+	typename indexed_priority_queue<T, Compare, Arity>::handle indexed_priority_queue<T, Compare, Arity>::emplace(Args&& ... args)
+	{
+		return append(std::forward<Args>(args)...);
+	}
+
+	template <class T, class Compare, size_type Arity>
+	void indexed_priority_queue<T, Compare, Arity>::pop()
+	{
+		erase(_heap.front().owner);
+	}
+
+	template <class T, class Compare, size_type Arity>
+	void indexed_priority_queue<T, Compare, Arity>::update(handle h, T val)
+	{
+		const size_type i = _position[h];
+		const bool up = _comp(_heap[i].value, val);
+		_heap[i].value = std::move(val);
+
+		if (up)
+		{
+			sift_up(i);
+		}
+		else
+		{
+			sift_down(i);
+		}
+	}
+
+	template <class T, class Compare, size_type Arity>
+	void indexed_priority_queue<T, Compare, Arity>::decrease_key(handle h, T val)
+	{
+		const size_type i = _position[h];
+		_heap[i].value = std::move(val);
+		sift_up(i);
+	}
+
+	template <class T, class Compare, size_type Arity>
+	void indexed_priority_queue<T, Compare, Arity>::erase(handle h)
+	{
+		const size_type i = _position[h];
+		const size_type last = _heap.size() - 1;
+
+		_position[h] = npos;
+		_free.push_back(h);
+
+		if (i == last)
+		{
+			_heap.pop_back();
+			return;
+		}
+
+		// The last node fills the hole and moves whichever way it ranks against the erased one
+		const bool up = _comp(_heap[i].value, _heap[last].value);
+		place(i, std::move(_heap[last]));
+		_heap.pop_back();
+
+		if (up)
+		{
+			sift_up(i);
+		}
+		else
+		{
+			sift_down(i);
+		}
+	}
+
+	template <class T, class Compare, size_type Arity>
+	void indexed_priority_queue<T, Compare, Arity>::clear() noexcept
+	{
+		_heap.clear();
+		_position.clear();
+		_free.clear();
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T, class Compare, size_type Arity>
+	template <class... Args>
+	typename indexed_priority_queue<T, Compare, Arity>::handle indexed_priority_queue<T, Compare, Arity>::append(Args&& ... args)
+	{
+		// A throwing construction leaves the queue unchanged
+		handle h;
+		if (_free.empty())
+		{
+			h = _position.size();
+			_position.push_back(npos);
+			try
+			{
+				_heap.push_back(entry{ T(std::forward<Args>(args)...), h });
+			}
+			catch (...)
+			{
+				_position.pop_back();
+				throw;
+			}
+		}
+		else
+		{
+			h = _free.back();
+			_heap.push_back(entry{ T(std::forward<Args>(args)...), h });
+			_free.pop_back();
+		}
+
+		_position[h] = _heap.size() - 1;
+		sift_up(_heap.size() - 1);
+		return h;
+	}
+
+	template <class T, class Compare, size_type Arity>
+	void indexed_priority_queue<T, Compare, Arity>::sift_up(size_type i)
+	{
+		entry e = std::move(_heap[i]);
+		while (i > 0)
+		{
+			const size_type parent = (i - 1) / Arity;
+			if (!_comp(_heap[parent].value, e.value))
+			{
+				break;
+			}
+			place(i, std::move(_heap[parent]));
+			i = parent;
+		}
+		place(i, std::move(e));
+	}
+
+	template <class T, class Compare, size_type Arity>
+	void indexed_priority_queue<T, Compare, Arity>::sift_down(size_type i)
+	{
+		const size_type n = _heap.size();
+		entry e = std::move(_heap[i]);
+		for (;;)
+		{
+			const size_type child = Arity * i + 1;
+			if (child >= n)
+			{
+				break;
+			}
+
+			size_type best = child;
+			const size_type end = std::min(child + Arity, n);
+			for (size_type k = child + 1; k < end; ++k)
+			{
+				best = _comp(_heap[best].value, _heap[k].value) ? k : best;
+			}
+
+			if (!_comp(e.value, _heap[best].value))
+			{
+				break;
+			}
+			place(i, std::move(_heap[best]));
+			i = best;
+		}
+		place(i, std::move(e));
+	}
+
+	template <class T, class Compare, size_type Arity>
+	inline void indexed_priority_queue<T, Compare, Arity>::place(size_type i, entry&& e)
+	{
+		_position[e.owner] = i;
+		_heap[i] = std::move(e);
+	}
+}
@@ -0,0 +1,547 @@
+// rolling_window.h
+// A non-stl header only sliding window of the last N samples keeping aggregates over them up to date
+// on every push, on top of circular_buffer.
+// Note, the standard is used for some components such as std::tuple and std::log
+
+/*
+ * A rolling_window<T, N, Aggregates...> holds the last N samples pushed into it in a circular_buffer and
+ * updates each aggregate from the sample pushed and the sample it overwrote, so reading an aggregate never
+ * iterates the window:
+ *  rolling_sum         sum and mean, O(1) per push
+ *  rolling_variance    mean, variance and standard deviation with Welford's updates, O(1) per push
+ *  rolling_min / _max  the smallest / largest sample from a monotonic queue, O(1) amortized per push
+ *  rolling_quantile    approximate quantiles from a log scale histogram, O(1) per push, O(Buckets) per query
+ * Floating point sums and variances are recomputed from the samples once every N overwrites so rounding
+ * errors can't build up while the window slides, which keeps them O(1) amortized.
+ * An aggregate is a type with a nested template state<T, N> providing
+ *  template <class Window> void push(const Window& w, const T& in, const T* out)
+ *  void clear()
+ * push is called once in has been appended to w, out points to the sample overwritten by it or is null
+ * while the window wasn't full. get<A>() returns the state of A.
+ * This container throws no exceptions unless copying T does.
+ */
+
+#pragma once
+
+// Includes
+#include <cmath>			// std::log, std::exp, std::sqrt, std::ceil
+#include <cstdint>			// std::uint16_t, std::uint32_t
+#include <ratio>			// std::ratio
+#include <tuple>			// std::tuple, std::get, std::apply
+#include <type_traits>		// std::conditional_t, std::is_floating_point, std::is_signed, std::is_same
+
+#include "circular_buffer.h"	// non_stl::circular_buffer
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter T is the sample type
+	// size_type N is the amount of samples the window spans
+	// Aggregates are the statistics kept over the window, e.g. rolling_sum, rolling_min
+	template <class T, size_type N, class... Aggregates>
+	class rolling_window
+	{
+		static_assert(N > 0, "rolling_window requires a window of at least one sample");
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		using samples_type = circular_buffer<T, N>;
+
+		// The state kept for aggregate A
+		template <class A>
+		using state_type = typename A::template state<T, N>;
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor, an empty window
+		rolling_window() noexcept;
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns the samples in the window, oldest first
+		const samples_type& samples() const noexcept;
+
+		// Returns the state of aggregate A, which must be one of Aggregates
+		template <class A>
+		const state_type<A>& get() const noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the amount of samples in the window
+		size_type size() const noexcept;
+
+		// Returns whether the window holds no sample
+		bool empty() const noexcept;
+
+		// Returns whether the window holds N samples and the next push overwrites the oldest
+		bool full() const noexcept;
+
+		// Returns N
+		static constexpr size_type capacity() noexcept;
+
+		// Returns the amount of samples pushed since construction or the last clear()
+		// Sample i of samples() was the (pushed() - size() + i)th one
+		size_type pushed() const noexcept;
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Appends val, overwriting the oldest sample once the window is full, and updates every aggregate
+		void push_back(const T& val);
+
+		// Removes every sample and resets every aggregate
+		void clear() noexcept;
+
+		// ---------------
+		// END INTERFACE
+		// ---------------
+	private:
+		// Returns the index of A in Aggregates
+		template <class A>
+		static constexpr size_type index_of() noexcept;
+
+		samples_type _samples;
+		size_type _pushed;
+		std::tuple<state_type<Aggregates>...> _states;
+	};
+
+	// ---------------
+	// AGGREGATES
+	// ---------------
+	namespace detail
+	{
+		// Type sums of T are kept in, wide enough not to overflow on a window of ints
+		template <class T>
+		using rolling_accumulator_t = std::conditional_t<std::is_floating_point<T>::value,
+			std::conditional_t<(sizeof(T) > sizeof(double)), T, double>,
+			std::conditional_t<std::is_signed<T>::value, long long, unsigned long long> >;
+
+		// A double ended queue of at most N entries within a fixed array
+		template <class E, size_type N>
+		class bounded_deque
+		{
+		public:
+			bool empty() const noexcept { return _size == 0; }
+			const E& front() const noexcept { return _entries[_head]; }
+			const E& back() const noexcept { return _entries[slot(_size - 1)]; }
+			void push_back(const E& e) noexcept { _entries[slot(_size++)] = e; }
+			void pop_back() noexcept { --_size; }
+			void pop_front() noexcept { _head = slot(1); --_size; }
+			void clear() noexcept { _head = 0; _size = 0; }
+
+		private:
+			size_type slot(size_type i) const noexcept { return _head + i < N ? _head + i : _head + i - N; }
+
+			E _entries[N];
+			size_type _head = 0;
+			size_type _size = 0;
+		};
+
+		// Keeps the sample for which no later sample compares before it with Compare
+		template <class T, size_type N, class Compare>
+		class rolling_extreme_state
+		{
+		public:
+			// Returns the smallest sample by Compare. Assumed the window is not empty
+			const T& value() const noexcept { return _queue.front().value; }
+
+			template <class Window>
+			void push(const Window& w, const T& in, const T*)
+			{
+				const size_type position = w.pushed() - 1;
+
+				// The oldest entry leaves once its sample is overwritten
+				if (!_queue.empty() && _queue.front().position + N <= position) {
+					_queue.pop_front();
+				}
+
+				// Entries which in compares before can never be the extreme again
+				while (!_queue.empty() && !Compare()(_queue.back().value, in)) {
+					_queue.pop_back();
+				}
+				_queue.push_back(entry{ in, position });
+			}
+
+			void clear() noexcept { _queue.clear(); }
+
+		private:
+			struct entry
+			{
+				T value;
+				size_type position;
+			};
+
+			// Samples in increasing order by Compare and in the order they were pushed
+			bounded_deque<entry, N> _queue;
+		};
+
+		struct less
+		{
+			template <class T>
+			constexpr bool operator()(const T& a, const T& b) const { return a < b; }
+		};
+
+		struct greater
+		{
+			template <class T>
+			constexpr bool operator()(const T& a, const T& b) const { return b < a; }
+		};
+
+		// Returns log((1 + a) / (1 - a)) = 2 atanh(a), as a series so it is a constant expression
+		constexpr double log_gamma(double a) noexcept
+		{
+			double sum = 0.0;
+			double power = a;
+			for (int k = 0; k < 64; ++k) {
+				sum += power / (2 * k + 1);
+				power *= a * a;
+			}
+			return 2.0 * sum;
+		}
+	}
+
+	// Sum and mean of the window
+	struct rolling_sum
+	{
+		template <class T, size_type N>
+		class state
+		{
+		public:
+			using value_type = detail::rolling_accumulator_t<T>;
+
+			// Returns the sum of the samples
+			value_type value() const noexcept { return _sum; }
+
+			// Returns the mean of the samples, 0 for an empty window
+			double mean() const noexcept { return _count ? static_cast<double>(_sum) / _count : 0.0; }
+
+			template <class Window>
+			void push(const Window& w, const T& in, const T* out)
+			{
+				if (!out) {
+					_sum += static_cast<value_type>(in);
+					++_count;
+					return;
+				}
+
+				if constexpr (std::is_floating_point<value_type>::value) {
+					if (++_overwrites == N) {
+						refresh(w);
+						return;
+					}
+				}
+				// Unsigned sums wrap around and back, which is still exact
+				_sum += static_cast<value_type>(in);
+				_sum -= static_cast<value_type>(*out);
+			}
+
+			void clear() noexcept { _sum = value_type(); _count = 0; _overwrites = 0; }
+
+		private:
+			template <class Window>
+			void refresh(const Window& w)
+			{
+				_sum = value_type();
+				for (const T& sample : w.samples()) {
+					_sum += static_cast<value_type>(sample);
+				}
+				_overwrites = 0;
+			}
+
+			value_type _sum = value_type();
+			size_type _count = 0;
+			size_type _overwrites = 0;
+		};
+	};
+
+	// Mean, variance and standard deviation of the window
+	struct rolling_variance
+	{
+		template <class T, size_type N>
+		class state
+		{
+		public:
+			// Returns the mean of the samples, 0 for an empty window
+			double mean() const noexcept { return _mean; }
+
+			// Returns the population variance of the samples, 0 for an empty window
+			double variance() const noexcept { return _count ? _m2 / _count : 0.0; }
+
+			// Returns the variance with Bessel's correction, 0 for fewer than two samples
+			double sample_variance() const noexcept { return _count > 1 ? _m2 / (_count - 1) : 0.0; }
+
+			// Returns the square root of variance()
+			double stddev() const noexcept { return std::sqrt(variance()); }
+
+			template <class Window>
+			void push(const Window& w, const T& in, const T* out)
+			{
+				const double x = static_cast<double>(in);
+				if (!out) {
+					++_count;
+					const double delta = x - _mean;
+					_mean += delta / _count;
+					_m2 += delta * (x - _mean);
+					return;
+				}
+
+				if (++_overwrites == N) {
+					refresh(w);
+					return;
+				}
+
+				// Replacing y by x keeps the count, the mean moves by (x - y) / n
+				const double y = static_cast<double>(*out);
+				const double old_mean = _mean;
+				_mean += (x - y) / _count;
+				_m2 += (x - y) * (x - _mean + y - old_mean);
+				if (_m2 < 0.0) {
+					_m2 = 0.0;
+				}
+			}
+
+			void clear() noexcept { _mean = 0.0; _m2 = 0.0; _count = 0; _overwrites = 0; }
+
+		private:
+			// Two passes over the samples, the exact mean first
+			template <class Window>
+			void refresh(const Window& w)
+			{
+				double sum = 0.0;
+				for (const T& sample : w.samples()) {
+					sum += static_cast<double>(sample);
+				}
+				_mean = sum / _count;
+
+				_m2 = 0.0;
+				for (const T& sample : w.samples()) {
+					const double delta = static_cast<double>(sample) - _mean;
+					_m2 += delta * delta;
+				}
+				_overwrites = 0;
+			}
+
+			double _mean = 0.0;
+
+			// Sum of the squared differences to the mean
+			double _m2 = 0.0;
+			size_type _count = 0;
+			size_type _overwrites = 0;
+		};
+	};
+
+	// Smallest sample of the window by operator<
+	struct rolling_min
+	{
+		template <class T, size_type N>
+		using state = detail::rolling_extreme_state<T, N, detail::less>;
+	};
+
+	// Largest sample of the window by operator<
+	struct rolling_max
+	{
+		template <class T, size_type N>
+		using state = detail::rolling_extreme_state<T, N, detail::greater>;
+	};
+
+	// Approximate quantiles of the window, for positive samples such as latencies
+	// Template parameter Accuracy is the relative error of the quantiles, as a std::ratio
+	// size_type Buckets is the amount of histogram buckets, which bounds the range of the samples
+	// Bucket i counts the samples in (gamma^(i - 1), gamma^i] with gamma = (1 + Accuracy) / (1 - Accuracy),
+	// samples up to 1 fall into the first bucket and samples past the last bucket into the last one.
+	// With the defaults the samples range from 1 to about 10^8.7 at 1% error
+	template <class Accuracy = std::ratio<1, 100>, size_type Buckets = 1024>
+	struct rolling_quantile
+	{
+		template <class T, size_type N>
+		class state
+		{
+			static constexpr double alpha = static_cast<double>(Accuracy::num) / Accuracy::den;
+			static_assert(alpha > 0.0 && alpha < 1.0, "rolling_quantile requires an accuracy between 0 and 1");
+
+			static constexpr double gamma = (1.0 + alpha) / (1.0 - alpha);
+			static constexpr double inv_log_gamma = 1.0 / detail::log_gamma(alpha);
+
+			// The smallest counter which can count every sample of the window
+			using counter = std::conditional_t<(N <= 0xFFFF), std::uint16_t,
+				std::conditional_t<(N <= 0xFFFFFFFF), std::uint32_t, size_type> >;
+
+		public:
+			// Returns the sample at quantile q in [0, 1] within the relative accuracy, 0 for an empty window
+			// e.g. quantile(0.99) for the 99th percentile
+			double quantile(double q) const noexcept
+			{
+				if (_count == 0) {
+					return 0.0;
+				}
+
+				const double rank = q <= 0.0 ? 0.0 : q >= 1.0 ? _count - 1 : q * (_count - 1);
+				size_type seen = 0;
+				for (size_type i = 0; i < Buckets; ++i) {
+					seen += _counts[i];
+					if (static_cast<double>(seen) > rank) {
+						return representative(i);
+					}
+				}
+				return representative(Buckets - 1);
+			}
+
+			template <class Window>
+			void push(const Window&, const T& in, const T* out)
+			{
+				++_counts[bucket_of(in)];
+				if (out) {
+					--_counts[bucket_of(*out)];
+				}
+				else {
+					++_count;
+				}
+			}
+
+			void clear() noexcept
+			{
+				for (counter& c : _counts) {
+					c = 0;
+				}
+				_count = 0;
+			}
+
+		private:
+			static size_type bucket_of(const T& sample) noexcept
+			{
+				const double x = static_cast<double>(sample);
+				if (!(x > 1.0)) {
+					return 0;
+				}
+				const double index = std::ceil(std::log(x) * inv_log_gamma);
+				return index < Buckets - 1 ? static_cast<size_type>(index) : Buckets - 1;
+			}
+
+			// The value within the relative accuracy of every sample of bucket i
+			static double representative(size_type i) noexcept
+			{
+				return i == 0 ? 1.0 : 2.0 * std::exp(i / inv_log_gamma) / (gamma + 1.0);
+			}
+
+			counter _counts[Buckets] = {};
+			size_type _count = 0;
+		};
+	};
+
+	// ROLLING WINDOW IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, size_type N, class... Aggregates>
+	rolling_window<T, N, Aggregates...>::rolling_window() noexcept
+		: _samples()
+		, _pushed(0)
+		, _states()
+	{
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T, size_type N, class... Aggregates>
+	const typename rolling_window<T, N, Aggregates...>::samples_type& rolling_window<T, N, Aggregates...>::samples() const noexcept
+	{
+		return _samples;
+	}
+
+	template <class T, size_type N, class... Aggregates>
+	template <class A>
+	const typename rolling_window<T, N, Aggregates...>::template state_type<A>& rolling_window<T, N, Aggregates...>::get() const noexcept
+	{
+		return std::get<index_of<A>()>(_states);
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, size_type N, class... Aggregates>
+	size_type rolling_window<T, N, Aggregates...>::size() const noexcept
+	{
+		return _samples.size();
+	}
+
+	template <class T, size_type N, class... Aggregates>
+	bool rolling_window<T, N, Aggregates...>::empty() const noexcept
+	{
+		return _samples.empty();
+	}
+
+	template <class T, size_type N, class... Aggregates>
+	bool rolling_window<T, N, Aggregates...>::full() const noexcept
+	{
+		return _samples.size() == N;
+	}
+
+	template <class T, size_type N, class... Aggregates>
+	constexpr size_type rolling_window<T, N, Aggregates...>::capacity() noexcept
+	{
+		return N;
+	}
+
+	template <class T, size_type N, class... Aggregates>
+	size_type rolling_window<T, N, Aggregates...>::pushed() const noexcept
+	{
+		return _pushed;
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class T, size_type N, class... Aggregates>
+	void rolling_window<T, N, Aggregates...>::push_back(const T& val)
+	{
+		if (full()) {
+			// The aggregates still need the sample being overwritten
+			const T out = _samples.front();
+			_samples.push_back(val);
+			++_pushed;
+			std::apply([&](auto&... states) { (states.push(*this, val, &out), ...); }, _states);
+		}
+		else {
+			_samples.push_back(val);
+			++_pushed;
+			std::apply([&](auto&... states) { (states.push(*this, val, nullptr), ...); }, _states);
+		}
+	}
+
+	template <class T, size_type N, class... Aggregates>
+	void rolling_window<T, N, Aggregates...>::clear() noexcept
+	{
+		_samples.clear();
+		_pushed = 0;
+		std::apply([](auto&... states) { (states.clear(), ...); }, _states);
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T, size_type N, class... Aggregates>
+	template <class A>
+	constexpr size_type rolling_window<T, N, Aggregates...>::index_of() noexcept
+	{
+		constexpr bool matches[] = { std::is_same<A, Aggregates>::value..., false };
+		size_type i = 0;
+		while (i < sizeof...(Aggregates) && !matches[i]) {
+			++i;
+		}
+		static_assert(((std::is_same<A, Aggregates>::value ? 1 : 0) + ... + 0) == 1,
+			"rolling_window::get requires one of the window's aggregates");
+		return i;
+	}
+}
@@ -0,0 +1,1292 @@
+// segmented_vector.h
+// A non-stl header only implementation of a vector which grows by appending segments instead of
+// reallocating, sharing the interface of non_stl::vector.
+// Note, the standard is used for some components such as std::allocator and exceptions
+
+/*
+ * A segmented_vector keeps its elements in segments of geometrically increasing size. The first segment
+ * holds first_segment_size elements, a power of two, and every following one twice as many as the previous.
+ * Growing only ever allocates the next segment, no element is ever copied or moved, so push_back has no
+ * reallocation spike, the memory in use never transiently doubles, and references, pointers and
+ * iterators stay valid as elements are appended.
+ * The segments are found through a table allocated once with room for every segment the vector could ever
+ * have. Element i lives in the segment given by the highest set bit of i + first_segment_size, so indexing
+ * is a bit scan, a shift and two loads. Unlike vector the elements are not contiguous, segment(k) hands out
+ * each segment as a span for code which wants contiguous runs.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::min, std::move, std::move_backward, std::rotate
+#include <cstddef>			// std::ptrdiff_t
+#include <cstring>			// std::memcpy
+#include <initializer_list>	// std::initializer_list
+#include <iterator>			// std::random_access_iterator_tag, std::reverse_iterator, std::make_move_iterator
+#include <limits>			// std::numeric_limits
+#include <memory>			// std::allocator, std::allocator_traits
+#include <memory_resource>	// std::pmr::polymorphic_allocator
+#include <stdexcept>		// std::out_of_range, std::length_error
+#include <type_traits>		// std::conditional_t, std::enable_if_t, std::is_integral, std::is_trivially_copyable
+#include <utility>			// std::forward, std::move, std::swap
+
+#include "contiguous_iterator.h"	// non_stl::contiguous_iterator
+#include "span.h"			// non_stl::span
+
+#if defined(_MSC_VER)
+#include <intrin.h>			// _BitScanReverse, _BitScanReverse64
+#endif
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Returns the amount of elements of element_size bytes held by the first segment of about segment_bytes
+	// The first segment holds at least 16 elements and the amount is rounded down to a power of two
+	constexpr size_type segmented_vector_first_segment(size_type element_size, size_type segment_bytes) noexcept
+	{
+		size_type n = segment_bytes / element_size;
+		if (n < 16)
+		{
+			n = 16;
+		}
+
+		size_type pow2 = 1;
+		while (pow2 * 2 <= n)
+		{
+			pow2 *= 2;
+		}
+		return pow2;
+	}
+
+	// Template parameter T is the generic object being stored within the container
+	// Template parameter Alloc is the allocator the segments and the segment table are obtained from.
+	// If a custom allocator is not provided then the default std::allocator<T> will be used
+	// Template parameter FirstSegmentBytes is the approximate size of the first segment,
+	// see segmented_vector_first_segment for the exact amount of elements
+	template <class T, class Alloc = std::allocator<T>, size_type FirstSegmentBytes = 4096>
+	class segmented_vector
+	{
+		using alloc_traits = std::allocator_traits<Alloc>;
+		using table_alloc = typename alloc_traits::template rebind_alloc<T*>;
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		// Amount of elements held by the first segment, segment k holds first_segment_size << k
+		static constexpr size_type first_segment_size = segmented_vector_first_segment(sizeof(T), FirstSegmentBytes);
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor
+		// Nothing is allocated until the first element is added
+		segmented_vector() noexcept;
+		explicit segmented_vector(const Alloc& alloc) noexcept;
+
+		// Fill constructor
+		// Constructs a segmented_vector with size elements
+		// Each element is a copy of val if provided, value initialized otherwise
+		explicit segmented_vector(size_type size, const Alloc& alloc = Alloc());
+		segmented_vector(size_type size, const T& val, const Alloc& alloc = Alloc());
+
+		// Range constructor
+		template <class InputIterator>
+		segmented_vector(InputIterator first, InputIterator last, const Alloc& alloc = Alloc());
+
+		// Copy constructor
+		// The allocator is obtained from select_on_container_copy_construction unless provided
+		segmented_vector(const segmented_vector& rhs);
+		segmented_vector(const segmented_vector& rhs, const Alloc& alloc);
+
+		// Move constructor
+		// The segments are moved along with the allocator
+		// If an unequal allocator is provided the elements are moved one by one instead
+		segmented_vector(segmented_vector&& rhs) noexcept;
+		segmented_vector(segmented_vector&& rhs, const Alloc& alloc);
+
+		// Initializer list constructor
+		segmented_vector(std::initializer_list<T> init, const Alloc& alloc = Alloc());
+
+		// ---------------
+		// OPERATOR=
+		// ---------------
+
+		// The allocator follows the propagate_on_container_copy_assignment and
+		// propagate_on_container_move_assignment traits. When it doesn't propagate
+		// and the allocators are unequal a move assignment moves the elements one by one
+		segmented_vector& operator=(const segmented_vector& rhs);
+		segmented_vector& operator=(segmented_vector&& rhs) noexcept(
+			std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+			std::allocator_traits<Alloc>::is_always_equal::value);
+		segmented_vector& operator=(std::initializer_list<T> init);
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+		~segmented_vector();
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns a reference to the element at position n
+		// with no range check
+		T& operator[](size_type n) noexcept;
+		const T& operator[](size_type n) const noexcept;
+
+		// Returns a reference to the element at position n
+		// Function throws std::out_of_range if the input is not within range
+		T& at(size_type n);
+		const T& at(size_type n) const;
+
+		// Returns a reference to the first element
+		T& front() noexcept;
+		const T& front() const noexcept;
+
+		// Returns a reference to the last element
+		T& back() noexcept;
+		const T& back() const noexcept;
+
+		// Returns the amount of segments allocated
+		size_type segment_count() const noexcept;
+
+		// Returns the elements held by segment k, which are contiguous
+		// Segments past the last element are empty
+		span<T> segment(size_type k) noexcept;
+		span<const T> segment(size_type k) const noexcept;
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+
+		// An iterator is the segment table and the position of an element,
+		// dereferencing it splits the position into a segment and an offset in the segment
+		// The table is allocated with the first segment and never moves, so appending never
+		// invalidates iterators other than end()
+		template <bool isConst> struct myIterator;
+		using iterator = myIterator<false>;
+		using const_iterator = myIterator<true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Returns an iterator to the first element of the container
+		// If the container is empty, the returned iterator will be equal to end()
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+
+		// Returns an iterator to the element following the last element of the container
+		// Attempting to access or modify this element results in undefined behavior
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+
+		// Returns a reverse iterator to the first element of the reversed container
+		reverse_iterator rbegin() noexcept;
+		const_reverse_iterator rbegin() const noexcept;
+		const_reverse_iterator crbegin() const noexcept;
+
+		// Returns a reverse iterator to the element following the last element of the reversed container
+		reverse_iterator rend() noexcept;
+		const_reverse_iterator rend() const noexcept;
+		const_reverse_iterator crend() const noexcept;
+
+		template <bool isconst = false>
+		struct myIterator
+		{
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using reference = typename std::conditional_t< isconst, T const&, T& >;
+			using pointer = typename std::conditional_t< isconst, T const*, T* >;
+		private:
+			T* const*	table;
+			size_type	pos;
+
+			myIterator(T* const* t, size_type p) : table(t), pos(p) {}
+
+		public:
+			myIterator() : table(nullptr), pos(0) {}
+			// A non const iterator is implicitly convertible to a const iterator
+			template <bool otherConst, class = std::enable_if_t<isconst && !otherConst> >
+			myIterator(const myIterator<otherConst>& i) : table(i.table), pos(i.pos) {}
+
+			reference operator*() const {
+				return *locate(table, pos);
+			}
+			reference operator[](difference_type n) const {
+				return *locate(table, pos + n);
+			}
+			pointer operator->() const { return &(operator *()); }
+
+			myIterator& operator++()
+			{
+				++pos;
+				return *this;
+			}
+			myIterator operator++(int)
+			{
+				myIterator iter = *this;
+				++pos;
+				return iter;
+			}
+			myIterator& operator--()
+			{
+				--pos;
+				return *this;
+			}
+			myIterator operator--(int) {
+				myIterator iter = *this;
+				--pos;
+				return iter;
+			}
+			friend myIterator operator+(myIterator lhs, difference_type rhs) {
+				lhs.pos += rhs;
+				return lhs;
+			}
+			friend myIterator operator+(difference_type lhs, myIterator rhs) {
+				rhs.pos += lhs;
+				return rhs;
+			}
+			myIterator& operator+=(difference_type n) {
+				pos += n;
+				return *this;
+			}
+			friend myIterator operator-(myIterator lhs, difference_type rhs) {
+				lhs.pos -= rhs;
+				return lhs;
+			}
+			friend difference_type operator-(const myIterator& lhs, const myIterator& rhs) {
+				return static_cast<difference_type>(lhs.pos - rhs.pos);
+			}
+			myIterator& operator-=(difference_type n) {
+				pos -= n;
+				return *this;
+			}
+
+			friend bool operator==(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.pos == rhs.pos;
+			}
+			friend bool operator!=(const myIterator& lhs, const myIterator& rhs) {
+				return !(lhs == rhs);
+			}
+			friend bool operator<(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.pos < rhs.pos;
+			}
+			friend bool operator<=(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.pos <= rhs.pos;
+			}
+			friend bool operator>(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.pos > rhs.pos;
+			}
+			friend bool operator>=(const myIterator& lhs, const myIterator& rhs) {
+				return lhs.pos >= rhs.pos;
+			}
+			friend class segmented_vector;
+			friend struct myIterator<!isconst>;
+		};
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of elements in the segmented_vector
+		size_type size() const noexcept;
+
+		// Return the maximum number of elements the segmented_vector can hold
+		size_type max_size() const noexcept;
+
+		// Returns whether the segmented_vector is empty
+		// (i.e. whether its size is 0)
+		bool empty() const noexcept;
+
+		// Resizes the container so that it contains n elements
+		// If the container is expanded the new elements are value initialized
+		// or set to val if it is provided
+		void resize(size_type n);
+		void resize(size_type n, const T& val);
+
+		// Returns the amount of elements the allocated segments can hold
+		size_type capacity() const noexcept;
+
+		// Allocates segments until the capacity is at least n, no element is moved
+		void reserve(size_type n);
+
+		// Returns the segments holding no element to the allocator
+		void shrink_to_fit();
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Assign new contents to the segmented_vector, replacing its current contents
+		// Segments already allocated are reused
+
+		// Range version
+		template <class InputIterator>
+		void assign(InputIterator first, InputIterator last);
+
+		// Fill version
+		void assign(size_type n, const T& val);
+
+		// Initializer list version
+		void assign(std::initializer_list<T> il);
+
+		// Adds a new element at the end after its current last element
+		void push_back(const T& val);
+		void push_back(T&& val);
+
+		// Constructs a new element at the end
+		// The arguments args... are forwarded to the constructor as std::forward<Args>(args)....
+		// No element is moved so args may refer to an element of this segmented_vector
+		template <class... Args>
+		T& emplace_back(Args&& ... args);
+
+		// Removes the last element
+		void pop_back() noexcept;
+
+		// Inserts new elements before position
+		// The elements are constructed at the end and rotated into place, shifting the ones after position
+
+		// Single element
+		iterator insert(const_iterator position, const T& val);
+
+		// Move
+		iterator insert(const_iterator position, T&& val);
+
+		// Fill
+		iterator insert(const_iterator position, size_type n, const T& val);
+
+		// Range
+		template <class InputIterator>
+		iterator insert(const_iterator position, InputIterator first, InputIterator last);
+
+		// Initializer list
+		iterator insert(const_iterator position, std::initializer_list<T> il);
+
+		// Constructs a new element before position from args
+		template <class... Args>
+		iterator emplace(const_iterator position, Args&& ... args);
+
+		// Appends copies of the elements of rg
+		// Contiguous ranges of trivially copyable elements are copied with one memcpy per segment
+		template <class Range>
+		void append_range(Range&& rg);
+
+		// Removes the element at position, or the elements in [first, last)
+		// The elements after them are shifted down, returns an iterator to the element
+		// following the last one removed
+		iterator erase(const_iterator position);
+		iterator erase(const_iterator first, const_iterator last);
+
+		// Exchanges the content of the container by the content of x
+		// The allocators are only exchanged if propagate_on_container_swap is set
+		// Unequal allocators which don't propagate fall back to moving the elements
+		void swap(segmented_vector& x);
+
+		// Removes all elements leaving the container with a size of 0
+		// The segments are kept for reuse
+		void clear() noexcept;
+
+		// ---------------
+		// ALLOCATOR
+		// ---------------
+
+		// Returns a copy of the allocator object associated with this segmented_vector
+		Alloc get_allocator() const noexcept;
+
+	private:
+		// Private functions
+
+		// log2 of first_segment_size, and the amount of segments needed to cover every position
+		static constexpr size_type first_segment_shift = [] {
+			size_type shift = 0;
+			while ((size_type(1) << shift) < first_segment_size)
+			{
+				++shift;
+			}
+			return shift;
+		}();
+		static constexpr size_type max_segments = std::numeric_limits<size_type>::digits - first_segment_shift;
+
+		// Returns the index of the highest set bit of n, n must not be 0
+		static unsigned highest_bit(size_type n) noexcept;
+
+		// Returns the element at position pos of the segments in table
+		static T* locate(T* const* table, size_type pos) noexcept;
+
+		// Returns the position of the first element of segment k, and the amount of elements it holds
+		static constexpr size_type segment_start(size_type k) noexcept;
+		static constexpr size_type segment_capacity(size_type k) noexcept;
+
+		// Returns the element at position pos
+		T* slot(size_type pos) const noexcept;
+
+		// Calls f(T* first, size_type count) for each contiguous run of the positions [pos, pos + n)
+		// The segments covering them must be allocated
+		template <class F>
+		void for_each_run(size_type pos, size_type n, F f) const;
+
+		// Allocates the next segment, and the table on the first call
+		void allocate_segment();
+
+		// Constructs n elements at the back calling construct(T*) on each slot in order
+		// If a construction throws the elements already added are destroyed and the size is unchanged
+		template <class Construct>
+		void construct_back(size_type n, Construct construct);
+
+		// Constructs the n elements of the range starting at first at the back
+		template <class ForwardIterator>
+		void append_n(ForwardIterator first, size_type n);
+
+		// Destroys the n elements starting at position pos
+		void destroy_n(size_type pos, size_type n) noexcept;
+
+		// Destroys every element and returns the segments and the table to the allocator
+		// leaving the segmented_vector as if default constructed
+		void release() noexcept;
+
+		// Takes the table and the segments of rhs, leaving rhs empty
+		// Assumed that this segmented_vector holds no table
+		void steal(segmented_vector& rhs) noexcept;
+
+		// Member variables
+
+		// Allocator object, used to allocate the segments and, rebound, the table
+		Alloc _alloc;
+
+		// Table of max_segments segment pointers, the first _segment_count hold a segment, the others are nullptr
+		T** _table;
+		size_type _segment_count;
+
+		// The current amount of elements stored within the segmented_vector
+		size_type _size;
+	};
+
+	// SEGMENTED VECTOR IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::segmented_vector() noexcept :
+		segmented_vector(Alloc())
+	{
+
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::segmented_vector(const Alloc& alloc) noexcept :
+		_alloc(alloc),
+		_table(nullptr),
+		_segment_count(0),
+		_size(0)
+	{
+
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::segmented_vector(size_type size, const Alloc& alloc) :
+		segmented_vector(alloc)
+	{
+		resize(size);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::segmented_vector(size_type size, const T& val, const Alloc& alloc) :
+		segmented_vector(alloc)
+	{
+		resize(size, val);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	template <class InputIterator>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::segmented_vector(InputIterator first, InputIterator last, const Alloc& alloc) :
+		segmented_vector(alloc)
+	{
+		insert(cend(), first, last);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::segmented_vector(const segmented_vector<T, Alloc, FirstSegmentBytes>& rhs) :
+		segmented_vector(rhs, alloc_traits::select_on_container_copy_construction(rhs._alloc))
+	{
+
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::segmented_vector(const segmented_vector<T, Alloc, FirstSegmentBytes>& rhs, const Alloc& alloc) :
+		segmented_vector(alloc)
+	{
+		append_n(rhs.begin(), rhs._size);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::segmented_vector(segmented_vector<T, Alloc, FirstSegmentBytes>&& rhs) noexcept :
+		segmented_vector(std::move(rhs._alloc))
+	{
+		steal(rhs);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::segmented_vector(segmented_vector<T, Alloc, FirstSegmentBytes>&& rhs, const Alloc& alloc) :
+		segmented_vector(alloc)
+	{
+		if (_alloc == rhs._alloc)
+		{
+			steal(rhs);
+		}
+		else
+		{
+			// The segments belong to another allocator, move the elements into our own
+			append_n(std::make_move_iterator(rhs.begin()), rhs._size);
+			rhs.clear();
+		}
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::segmented_vector(std::initializer_list<T> init, const Alloc& alloc) :
+		segmented_vector(alloc)
+	{
+		append_n(init.begin(), init.size());
+	}
+
+	// ---------------
+	// OPERATOR=
+	// ---------------
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>& segmented_vector<T, Alloc, FirstSegmentBytes>::operator=(const segmented_vector<T, Alloc, FirstSegmentBytes>& rhs)
+	{
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+		{
+			// Segments from the current allocator can't be kept if the new one can't free them
+			if (!(_alloc == rhs._alloc))
+			{
+				release();
+			}
+			_alloc = rhs._alloc;
+		}
+
+		clear();
+		append_n(rhs.begin(), rhs._size);
+		return *this;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>& segmented_vector<T, Alloc, FirstSegmentBytes>::operator=(segmented_vector<T, Alloc, FirstSegmentBytes>&& rhs) noexcept(
+		std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+		std::allocator_traits<Alloc>::is_always_equal::value)
+	{
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+		{
+			// Take the allocator along with the segments
+			release();
+			_alloc = std::move(rhs._alloc);
+			steal(rhs);
+		}
+		else
+		{
+			if (_alloc == rhs._alloc)
+			{
+				release();
+				steal(rhs);
+			}
+			else
+			{
+				// Can't adopt segments from another allocator, move the elements one by one
+				clear();
+				append_n(std::make_move_iterator(rhs.begin()), rhs._size);
+				rhs.clear();
+			}
+		}
+
+		return *this;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>& segmented_vector<T, Alloc, FirstSegmentBytes>::operator=(std::initializer_list<T> init)
+	{
+		assign(init);
+		return *this;
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	segmented_vector<T, Alloc, FirstSegmentBytes>::~segmented_vector()
+	{
+		release();
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline T& segmented_vector<T, Alloc, FirstSegmentBytes>::operator[](size_type n) noexcept
+	{
+		return *slot(n);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline const T& segmented_vector<T, Alloc, FirstSegmentBytes>::operator[](size_type n) const noexcept
+	{
+		return *slot(n);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	T& segmented_vector<T, Alloc, FirstSegmentBytes>::at(size_type n)
+	{
+		if (n >= _size)
+		{
+			throw std::out_of_range("segmented_vector::at - index out of range");
+		}
+		return *slot(n);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	const T& segmented_vector<T, Alloc, FirstSegmentBytes>::at(size_type n) const
+	{
+		if (n >= _size)
+		{
+			throw std::out_of_range("segmented_vector::at - index out of range");
+		}
+		return *slot(n);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline T& segmented_vector<T, Alloc, FirstSegmentBytes>::front() noexcept
+	{
+		return *_table[0];
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline const T& segmented_vector<T, Alloc, FirstSegmentBytes>::front() const noexcept
+	{
+		return *_table[0];
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline T& segmented_vector<T, Alloc, FirstSegmentBytes>::back() noexcept
+	{
+		return *slot(_size - 1);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline const T& segmented_vector<T, Alloc, FirstSegmentBytes>::back() const noexcept
+	{
+		return *slot(_size - 1);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline size_type segmented_vector<T, Alloc, FirstSegmentBytes>::segment_count() const noexcept
+	{
+		return _segment_count;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	span<T> segmented_vector<T, Alloc, FirstSegmentBytes>::segment(size_type k) noexcept
+	{
+		if (k >= _segment_count || segment_start(k) >= _size)
+		{
+			return span<T>();
+		}
+		return span<T>(_table[k], std::min(segment_capacity(k), _size - segment_start(k)));
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	span<const T> segmented_vector<T, Alloc, FirstSegmentBytes>::segment(size_type k) const noexcept
+	{
+		if (k >= _segment_count || segment_start(k) >= _size)
+		{
+			return span<const T>();
+		}
+		return span<const T>(_table[k], std::min(segment_capacity(k), _size - segment_start(k)));
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::iterator segmented_vector<T, Alloc, FirstSegmentBytes>::begin() noexcept
+	{
+		return iterator(_table, 0);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::const_iterator segmented_vector<T, Alloc, FirstSegmentBytes>::begin() const noexcept
+	{
+		return const_iterator(_table, 0);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::const_iterator segmented_vector<T, Alloc, FirstSegmentBytes>::cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::iterator segmented_vector<T, Alloc, FirstSegmentBytes>::end() noexcept
+	{
+		return iterator(_table, _size);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::const_iterator segmented_vector<T, Alloc, FirstSegmentBytes>::end() const noexcept
+	{
+		return const_iterator(_table, _size);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::const_iterator segmented_vector<T, Alloc, FirstSegmentBytes>::cend() const noexcept
+	{
+		return end();
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::reverse_iterator segmented_vector<T, Alloc, FirstSegmentBytes>::rbegin() noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::const_reverse_iterator segmented_vector<T, Alloc, FirstSegmentBytes>::rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::const_reverse_iterator segmented_vector<T, Alloc, FirstSegmentBytes>::crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::reverse_iterator segmented_vector<T, Alloc, FirstSegmentBytes>::rend() noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::const_reverse_iterator segmented_vector<T, Alloc, FirstSegmentBytes>::rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline typename segmented_vector<T, Alloc, FirstSegmentBytes>::const_reverse_iterator segmented_vector<T, Alloc, FirstSegmentBytes>::crend() const noexcept
+	{
+		return rend();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline size_type segmented_vector<T, Alloc, FirstSegmentBytes>::size() const noexcept
+	{
+		return _size;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline size_type segmented_vector<T, Alloc, FirstSegmentBytes>::max_size() const noexcept
+	{
+		return alloc_traits::max_size(_alloc);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline bool segmented_vector<T, Alloc, FirstSegmentBytes>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::resize(size_type n)
+	{
+		if (n < _size)
+		{
+			destroy_n(n, _size - n);
+			_size = n;
+			return;
+		}
+
+		construct_back(n - _size, [this](T* p) { alloc_traits::construct(_alloc, p); });
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::resize(size_type n, const T& val)
+	{
+		if (n < _size)
+		{
+			destroy_n(n, _size - n);
+			_size = n;
+			return;
+		}
+
+		// No element moves when the segmented_vector grows so val may refer to one of them
+		construct_back(n - _size, [this, &val](T* p) { alloc_traits::construct(_alloc, p, val); });
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline size_type segmented_vector<T, Alloc, FirstSegmentBytes>::capacity() const noexcept
+	{
+		return segment_start(_segment_count);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::reserve(size_type n)
+	{
+		while (capacity() < n)
+		{
+			allocate_segment();
+		}
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::shrink_to_fit()
+	{
+		if (_size == 0)
+		{
+			release();
+			return;
+		}
+
+		// Segments holding at least one element
+		const size_type used = highest_bit(_size - 1 + first_segment_size) - first_segment_shift + 1;
+		while (_segment_count > used)
+		{
+			--_segment_count;
+			_alloc.deallocate(_table[_segment_count], segment_capacity(_segment_count));
+			_table[_segment_count] = nullptr;
+		}
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	template <class InputIterator>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::assign(InputIterator first, InputIterator last)
+	{
+		clear();
+		insert(cend(), first, last);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::assign(size_type n, const T& val)
+	{
+		clear();
+		resize(n, val);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::assign(std::initializer_list<T> il)
+	{
+		clear();
+		append_n(il.begin(), il.size());
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::push_back(const T& val)
+	{
+		emplace_back(val);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::push_back(T&& val)
+	{
+		emplace_back(std::move(val));
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	template <class... Args>
+	T& segmented_vector<T, Alloc, FirstSegmentBytes>::emplace_back(Args&& ... args)
+	{
+		if (_size == capacity())
+		{
+			allocate_segment();
+		}
+
+		T* p = slot(_size);
+		alloc_traits::construct(_alloc, p, std::forward<Args>(args)...);
+		++_size;
+		return *p;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::pop_back() noexcept
+	{
+		--_size;
+		alloc_traits::destroy(_alloc, slot(_size));
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	typename segmented_vector<T, Alloc, FirstSegmentBytes>::iterator segmented_vector<T, Alloc, FirstSegmentBytes>::insert(const_iterator position, const T& val)
+	{
+		return emplace(position, val);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	typename segmented_vector<T, Alloc, FirstSegmentBytes>::iterator segmented_vector<T, Alloc, FirstSegmentBytes>::insert(const_iterator position, T&& val)
+	{
+		return emplace(position, std::move(val));
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	typename segmented_vector<T, Alloc, FirstSegmentBytes>::iterator segmented_vector<T, Alloc, FirstSegmentBytes>::insert(const_iterator position, size_type n, const T& val)
+	{
+		const auto idx = (size_type)(position - cbegin());
+		const auto old_size = _size;
+
+		// Appending moves nothing so val may refer to an element
+		construct_back(n, [this, &val](T* p) { alloc_traits::construct(_alloc, p, val); });
+		std::rotate(begin() + idx, begin() + old_size, end());
+
+		return begin() + idx;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	template <class InputIterator>
+	typename segmented_vector<T, Alloc, FirstSegmentBytes>::iterator segmented_vector<T, Alloc, FirstSegmentBytes>::insert(const_iterator position, InputIterator first, InputIterator last)
+	{
+		if constexpr (std::is_integral<InputIterator>::value) {
+			return insert(position, (size_type)first, (T)last);
+		}
+		else {
+			const auto idx = (size_type)(position - cbegin());
+			const auto old_size = _size;
+
+			using category = typename std::iterator_traits<InputIterator>::iterator_category;
+			if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+				append_n(first, (size_type)std::distance(first, last));
+			}
+			else {
+				// Single pass iterators can't be measured
+				for (; first != last; ++first)
+				{
+					emplace_back(*first);
+				}
+			}
+
+			// The new elements were constructed at the end, rotate them into place
+			std::rotate(begin() + idx, begin() + old_size, end());
+			return begin() + idx;
+		}
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	typename segmented_vector<T, Alloc, FirstSegmentBytes>::iterator segmented_vector<T, Alloc, FirstSegmentBytes>::insert(const_iterator position, std::initializer_list<T> il)
+	{
+		return insert(position, il.begin(), il.end());
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	template <class... Args>
+	typename segmented_vector<T, Alloc, FirstSegmentBytes>::iterator segmented_vector<T, Alloc, FirstSegmentBytes>::emplace(const_iterator position, Args&& ... args)
+	{
+		const auto idx = (size_type)(position - cbegin());
+
+		if (idx == _size)
+		{
+			emplace_back(std::forward<Args>(args)...);
+			return end() - 1;
+		}
+
+		// Build the element before shifting as args may refer to an element of this segmented_vector
+		T tmp(std::forward<Args>(args)...);
+
+		// Shift the elements from position one step towards the back
+		emplace_back(std::move(back()));
+		std::move_backward(begin() + idx, end() - 2, end() - 1);
+
+		*(begin() + idx) = std::move(tmp);
+		return begin() + idx;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	template <class Range>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::append_range(Range&& rg)
+	{
+		insert(cend(), std::begin(rg), std::end(rg));
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	typename segmented_vector<T, Alloc, FirstSegmentBytes>::iterator segmented_vector<T, Alloc, FirstSegmentBytes>::erase(const_iterator position)
+	{
+		return erase(position, position + 1);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	typename segmented_vector<T, Alloc, FirstSegmentBytes>::iterator segmented_vector<T, Alloc, FirstSegmentBytes>::erase(const_iterator first, const_iterator last)
+	{
+		const auto idx = (size_type)(first - cbegin());
+		const auto n = (size_type)(last - first);
+
+		if (n == 0)
+		{
+			return begin() + idx;
+		}
+
+		std::move(begin() + idx + n, end(), begin() + idx);
+		destroy_n(_size - n, n);
+		_size -= n;
+
+		return begin() + idx;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::swap(segmented_vector<T, Alloc, FirstSegmentBytes>& x)
+	{
+		if (this == &x)
+		{
+			return;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_swap::value)
+		{
+			using std::swap;
+			swap(_alloc, x._alloc);
+		}
+		else if constexpr (!alloc_traits::is_always_equal::value)
+		{
+			// Each set of segments has to stay with the allocator it came from
+			if (!(_alloc == x._alloc))
+			{
+				segmented_vector tmp(std::move(x), _alloc);
+				x = std::move(*this);
+				*this = std::move(tmp);
+				return;
+			}
+		}
+
+		std::swap(_table, x._table);
+		std::swap(_segment_count, x._segment_count);
+		std::swap(_size, x._size);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::clear() noexcept
+	{
+		destroy_n(0, _size);
+		_size = 0;
+	}
+
+	// ---------------
+	// ALLOCATOR
+	// ---------------
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	Alloc segmented_vector<T, Alloc, FirstSegmentBytes>::get_allocator() const noexcept
+	{
+		return _alloc;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline unsigned segmented_vector<T, Alloc, FirstSegmentBytes>::highest_bit(size_type n) noexcept
+	{
+#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanReverse64(&index, n);
+		return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, n);
+		return static_cast<unsigned>(index);
+#else
+		return static_cast<unsigned>(std::numeric_limits<unsigned long long>::digits - 1 - __builtin_clzll(n));
+#endif
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline T* segmented_vector<T, Alloc, FirstSegmentBytes>::locate(T* const* table, size_type pos) noexcept
+	{
+		// Segment k starts at position first_segment_size * (2^k - 1), so the highest bit of
+		// pos + first_segment_size is k + first_segment_shift and the bits below it the offset
+		const size_type biased = pos + first_segment_size;
+		const unsigned bit = highest_bit(biased);
+		return table[bit - first_segment_shift] + (biased - (size_type(1) << bit));
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	constexpr size_type segmented_vector<T, Alloc, FirstSegmentBytes>::segment_start(size_type k) noexcept
+	{
+		return (first_segment_size << k) - first_segment_size;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	constexpr size_type segmented_vector<T, Alloc, FirstSegmentBytes>::segment_capacity(size_type k) noexcept
+	{
+		return first_segment_size << k;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	inline T* segmented_vector<T, Alloc, FirstSegmentBytes>::slot(size_type pos) const noexcept
+	{
+		return locate(_table, pos);
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	template <class F>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::for_each_run(size_type pos, size_type n, F f) const
+	{
+		while (n > 0)
+		{
+			const size_type biased = pos + first_segment_size;
+			const unsigned bit = highest_bit(biased);
+			const size_type offset = biased - (size_type(1) << bit);
+			const size_type count = std::min(n, (size_type(1) << bit) - offset);
+
+			f(_table[bit - first_segment_shift] + offset, count);
+			pos += count;
+			n -= count;
+		}
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::allocate_segment()
+	{
+		if (_segment_count == max_segments)
+		{
+			throw std::length_error("segmented_vector - too many segments");
+		}
+
+		// The table is sized for every segment up front so it never moves
+		if (_table == nullptr)
+		{
+			table_alloc talloc(_alloc);
+			_table = talloc.allocate(max_segments);
+			for (size_type i = 0; i < max_segments; ++i)
+			{
+				_table[i] = nullptr;
+			}
+		}
+
+		_table[_segment_count] = _alloc.allocate(segment_capacity(_segment_count));
+		++_segment_count;
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	template <class Construct>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::construct_back(size_type n, Construct construct)
+	{
+		reserve(_size + n);
+
+		const size_type old_size = _size;
+		try
+		{
+			for_each_run(_size, n, [this, &construct](T* first, size_type count) {
+				for (size_type i = 0; i < count; ++i)
+				{
+					construct(first + i);
+					++_size;
+				}
+			});
+		}
+		catch (...)
+		{
+			destroy_n(old_size, _size - old_size);
+			_size = old_size;
+			throw;
+		}
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	template <class ForwardIterator>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::append_n(ForwardIterator first, size_type n)
+	{
+		constexpr bool contiguous =
+			std::is_same<ForwardIterator, T*>::value ||
+			std::is_same<ForwardIterator, const T*>::value ||
+			std::is_same<ForwardIterator, contiguous_iterator<T> >::value ||
+			std::is_same<ForwardIterator, contiguous_iterator<T, true> >::value;
+
+		if constexpr (contiguous && std::is_trivially_copyable<T>::value)
+		{
+			if (n > 0)
+			{
+				reserve(_size + n);
+				const T* src = &*first;
+				for_each_run(_size, n, [&src](T* dest, size_type count) {
+					std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(T));
+					src += count;
+				});
+				_size += n;
+			}
+		}
+		else
+		{
+			construct_back(n, [this, &first](T* p) {
+				alloc_traits::construct(_alloc, p, *first);
+				++first;
+			});
+		}
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::destroy_n(size_type pos, size_type n) noexcept
+	{
+		if constexpr (!std::is_trivially_destructible<T>::value)
+		{
+			for_each_run(pos, n, [this](T* first, size_type count) {
+				for (size_type i = 0; i < count; ++i)
+				{
+					alloc_traits::destroy(_alloc, first + i);
+				}
+			});
+		}
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::release() noexcept
+	{
+		if (_table)
+		{
+			clear();
+
+			for (size_type i = 0; i < _segment_count; ++i)
+			{
+				_alloc.deallocate(_table[i], segment_capacity(i));
+			}
+
+			table_alloc talloc(_alloc);
+			talloc.deallocate(_table, max_segments);
+
+			_table = nullptr;
+			_segment_count = 0;
+		}
+	}
+
+	template <class T, class Alloc, size_type FirstSegmentBytes>
+	void segmented_vector<T, Alloc, FirstSegmentBytes>::steal(segmented_vector<T, Alloc, FirstSegmentBytes>& rhs) noexcept
+	{
+		_table = rhs._table;
+		_segment_count = rhs._segment_count;
+		_size = rhs._size;
+
+		rhs._table = nullptr;
+		rhs._segment_count = 0;
+		rhs._size = 0;
+	}
+
+	namespace pmr
+	{
+		// segmented_vector using a polymorphic allocator, e.g. backed by a non_stl::monotonic_buffer
+		template <class T, size_type FirstSegmentBytes = 4096>
+		using segmented_vector = non_stl::segmented_vector<T, std::pmr::polymorphic_allocator<T>, FirstSegmentBytes>;
+	}
+}
@@ -0,0 +1,1021 @@
+// small_vector.h
+// A non-stl header only implementation of a small buffer optimized vector which shares the
+// interface of non_stl::vector.
+// Note, the standard is used for some components such as std::allocator and exceptions
+
+/*
+ * A small_vector is a sequence container which stores its first N elements inside the object itself.
+ * Only once more than N elements are held does it spill over into storage obtained from the allocator,
+ * after which it behaves exactly as a vector. Containers which usually stay small never allocate.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::rotate, std::swap
+#include <initializer_list>	// std::initializer_list
+#include <iterator>			// std::reverse_iterator, std::distance, std::make_move_iterator
+#include <limits>			// std::numeric_limits
+#include <memory>			// std::allocator, std::allocator_traits
+#include <memory_resource>	// std::pmr::polymorphic_allocator
+#include <stdexcept>		// std::out_of_range
+#include <type_traits>		// std::is_integral
+#include <utility>			// std::forward, std::move
+
+#include "contiguous_iterator.h"	// non_stl::contiguous_iterator
+#include "growth_policy.h"	// non_stl::double_growth
+#include "../memory/relocate.h"	// non_stl::relocate_n
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter T is the generic object being stored within the container
+	// size_type N is the amount of elements stored inline before the allocator is used
+	// Template parameter Alloc is the allocator used once the inline storage is exhausted
+	// Template parameter Growth is the growth policy used past the inline storage, see growth_policy.h
+	template <class T, size_type N, class Alloc = std::allocator<T>, class Growth = double_growth>
+	class small_vector
+	{
+		static_assert(N > 0, "small_vector requires an inline capacity of at least one element");
+
+		using alloc_traits = std::allocator_traits<Alloc>;
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		// Iterators are thin wrappers around a pointer into the active storage, see contiguous_iterator.h
+		using iterator = contiguous_iterator<T>;
+		using const_iterator = contiguous_iterator<T, true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor
+		// The small_vector starts with a capacity of N and performs no allocation
+		// Every constructor optionally takes the allocator used past the inline storage
+		small_vector() noexcept;
+		explicit small_vector(const Alloc& alloc) noexcept;
+
+		// Fill constructor
+		// Constructs a small_vector with size elements
+		// Each element is a copy of val if provided
+		explicit small_vector(size_type size, const Alloc& alloc = Alloc());
+		small_vector(size_type size, const T& val, const Alloc& alloc = Alloc());
+
+		// Range constructor
+		template <class InputIterator>
+		small_vector(InputIterator first, InputIterator last, const Alloc& alloc = Alloc());
+
+		// Copy constructor
+		// The allocator is obtained from select_on_container_copy_construction unless provided
+		small_vector(const small_vector& rhs);
+		small_vector(const small_vector& rhs, const Alloc& alloc);
+
+		// Move constructor
+		// If rhs is still using its inline storage the elements are relocated
+		// otherwise the allocated array is stolen along with the allocator
+		small_vector(small_vector&& rhs) noexcept;
+
+		// Initializer list constructor
+		small_vector(std::initializer_list<T> init, const Alloc& alloc = Alloc());
+
+		// ---------------
+		// OPERATOR=
+		// ---------------
+
+		// The allocator follows the propagate_on_container_copy_assignment and
+		// propagate_on_container_move_assignment traits. When it doesn't propagate and the
+		// allocators are unequal an allocated rhs is moved element by element
+		small_vector& operator=(const small_vector& rhs);
+		small_vector& operator=(small_vector&& rhs) noexcept(
+			std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+			std::allocator_traits<Alloc>::is_always_equal::value);
+		small_vector& operator=(std::initializer_list<T> init);
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+		~small_vector();
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns a reference to the element at position n in the small_vector
+		// with no range check
+		T& operator[](size_type n);
+		const T& operator[](size_type n) const;
+
+		// Returns a reference to the element at position n in the small_vector
+		// Function throws std::out_of_range if the input is not within range
+		// Use the operator[] overload to access without range checking
+		T& at(size_type n);
+		const T& at(size_type n) const;
+
+		// Returns a reference to the first element in the small_vector
+		T& front();
+		const T& front() const;
+
+		// Returns a reference to the last element in the small_vector
+		T& back();
+		const T& back() const;
+
+		// Returns a direct pointer to the memory array used internally by the small_vector
+		// This points inside the object itself while size() <= N
+		T* data() noexcept;
+		const T* data() const noexcept;
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+
+		// Returns an iterator to the first element of the container
+		// If the container is empty, the returned iterator will be equal to end()
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+
+		// Returns an iterator to the element following the last element of the container
+		// Attempting to access or modify this element results in undefined behavior
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+
+		// Returns a reverse iterator to the first element of the reversed container
+		// Equivalent to the last element (not end) of the non-reversed container
+		reverse_iterator rbegin() noexcept;
+		const_reverse_iterator rbegin() const noexcept;
+		const_reverse_iterator crbegin() const noexcept;
+
+		// Returns a reverse iterator to the element following the last element of the reversed container
+		// Attempting to access or modify this element results in undefined behavior
+		reverse_iterator rend() noexcept;
+		const_reverse_iterator rend() const noexcept;
+		const_reverse_iterator crend() const noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of elements in the small_vector
+		size_type size() const noexcept;
+
+		// Return the maximum number of elements the small_vector can hold
+		constexpr size_type max_size() const noexcept;
+
+		// Resizes the container so that it contains n elements
+		// May reduce or increase the size of small_vector
+		// If the container is expanded the new elements are value initialized
+		// or set to val if it is provided
+		void resize(size_type n);
+		void resize(size_type n, const T& val);
+
+		// Returns the size of the storage space currently available to the small_vector,
+		// expressed in terms of elements. This is never less than N
+		size_type capacity() const noexcept;
+
+		// Returns the amount of elements which can be held without allocating
+		static constexpr size_type inline_capacity() noexcept;
+
+		// Returns whether the elements are currently stored inline
+		bool is_inline() const noexcept;
+
+		// Returns whether the small_vector is empty
+		// (i.e. whether its size is 0)
+		bool empty() const noexcept;
+
+		// Requests that the small_vector capacity be at least enough to contain n elements
+		void reserve(size_type n);
+
+		// Requests the container to reduce its capacity to fit its size
+		// Moves the elements back inline if they fit
+		void shrink_to_fit();
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Assign new contents to the small_vector, replacing its current contents
+		// and modifying its size if necessary
+
+		// Range version
+		template <class InputIterator>
+		void assign(InputIterator first, InputIterator last);
+
+		// Fill version
+		void assign(size_type n, const T& val);
+
+		// Initializer list version
+		void assign(std::initializer_list<T> il);
+
+		// Adds a new element at the end of the small_vector after its current last element
+		void push_back(const T& val);
+		void push_back(T&& val);
+
+		// Appends a new element to the end of the container.
+		// The arguments args... are forwarded to the constructor as std::forward<Args>(args)....
+		template <class... Args>
+		void emplace_back(Args&& ... args);
+
+		// Removes the last element in the small_vector
+		void pop_back();
+
+		// The small_vector is extended by inserting new elements before the element
+		// at the specified position, effectively increasing the container size
+		// by the number of elements inserted
+
+		// Single element
+		iterator insert(iterator position, const T& val);
+
+		// Range
+		template <class InputIterator>
+		iterator insert(iterator position, InputIterator first, InputIterator last);
+
+		// Move
+		iterator insert(iterator position, T&& val);
+
+		// Initializer list
+		iterator insert(iterator position, std::initializer_list<T> il);
+
+		// Exchanges the content of the container by the content of x
+		// which is another small_vector object of the same type
+		// The allocators are only exchanged if propagate_on_container_swap is set
+		void swap(small_vector& x);
+
+		// Removes all elements from the small_vector leaving the container with a size of 0
+		// The capacity is left unchanged
+		void clear() noexcept;
+
+		// ---------------
+		// ALLOCATOR
+		// ---------------
+
+		// Returns a copy of the allocator object associated with this small_vector
+		Alloc get_allocator() const noexcept;
+
+	private:
+		// Private functions
+
+		// Returns a pointer to the inline storage
+		T* inline_data() noexcept;
+		const T* inline_data() const noexcept;
+
+		// Move all elements into storage of capacity cap and assign _capacity
+		// Storage is inline whenever cap <= N
+		void reallocate(size_type cap);
+
+		// Grows the storage past its current capacity and constructs a new element
+		// at the end from args before relocating, so args may refer to an element
+		// of this small_vector
+		template <class... Args>
+		void reallocate_append(Args&& ... args);
+
+		// Returns the capacity requested from the growth policy when
+		// the small_vector needs room for more than n elements
+		static constexpr size_type grow_capacity(size_type n) noexcept;
+
+		// Takes the contents of rhs, leaving rhs empty and inline
+		// Assumed that this small_vector is empty and inline
+		void steal(small_vector& rhs) noexcept;
+
+		// Destroys every element and releases any allocated storage
+		// leaving the small_vector empty and inline
+		void reset() noexcept;
+
+		// Member variables
+
+		// Allocator object, used once the inline storage is exhausted
+		Alloc _alloc;
+
+		// Storage capacity of the small_vector. N while inline
+		size_type _capacity;
+
+		// The current amount of elements stored within the small_vector
+		size_type _size;
+
+		// Points at either _inline or an array obtained from _alloc
+		T* _data;
+
+		// Inline storage for the first N elements
+		alignas(T) unsigned char _inline[N * sizeof(T)];
+	};
+
+	// SMALL VECTOR IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>::small_vector() noexcept :
+		small_vector(Alloc())
+	{
+
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>::small_vector(const Alloc& alloc) noexcept :
+		_alloc(alloc),
+		_capacity(N),
+		_size(0),
+		_data(inline_data())
+	{
+
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>::small_vector(size_type size, const Alloc& alloc) :
+		small_vector(alloc)
+	{
+		resize(size);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>::small_vector(size_type size, const T& val, const Alloc& alloc) :
+		small_vector(alloc)
+	{
+		assign(size, val);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	template <class InputIterator>
+	small_vector<T, N, Alloc, Growth>::small_vector(InputIterator first, InputIterator last, const Alloc& alloc) :
+		small_vector(alloc)
+	{
+		assign(first, last);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>::small_vector(const small_vector& rhs) :
+		small_vector(rhs, alloc_traits::select_on_container_copy_construction(rhs._alloc))
+	{
+
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>::small_vector(const small_vector& rhs, const Alloc& alloc) :
+		small_vector(alloc)
+	{
+		assign(rhs.begin(), rhs.end());
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>::small_vector(small_vector&& rhs) noexcept :
+		_alloc(std::move(rhs._alloc)),
+		_capacity(N),
+		_size(0),
+		_data(inline_data())
+	{
+		steal(rhs);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>::small_vector(std::initializer_list<T> init, const Alloc& alloc) :
+		small_vector(alloc)
+	{
+		assign(init.begin(), init.end());
+	}
+
+	// ---------------
+	// OPERATOR=
+	// ---------------
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>& small_vector<T, N, Alloc, Growth>::operator=(const small_vector& rhs)
+	{
+		if (this != &rhs)
+		{
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+			{
+				// Storage from the old allocator has to go back to it first
+				if (!(_alloc == rhs._alloc))
+				{
+					reset();
+				}
+				_alloc = rhs._alloc;
+			}
+			assign(rhs.begin(), rhs.end());
+		}
+		return *this;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>& small_vector<T, N, Alloc, Growth>::operator=(small_vector&& rhs) noexcept(
+		std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+		std::allocator_traits<Alloc>::is_always_equal::value)
+	{
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+		{
+			reset();
+			_alloc = std::move(rhs._alloc);
+			steal(rhs);
+		}
+		else
+		{
+			// Inline elements are always relocated, only an allocated array is tied to its allocator
+			if (rhs.is_inline() || _alloc == rhs._alloc)
+			{
+				reset();
+				steal(rhs);
+			}
+			else
+			{
+				assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+				rhs.clear();
+			}
+		}
+		return *this;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>& small_vector<T, N, Alloc, Growth>::operator=(std::initializer_list<T> init)
+	{
+		assign(init.begin(), init.end());
+		return *this;
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class T, size_type N, class Alloc, class Growth>
+	small_vector<T, N, Alloc, Growth>::~small_vector()
+	{
+		reset();
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T, size_type N, class Alloc, class Growth>
+	inline T& small_vector<T, N, Alloc, Growth>::operator[](size_type n)
+	{
+		return _data[n];
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline const T& small_vector<T, N, Alloc, Growth>::operator[](size_type n) const
+	{
+		return _data[n];
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline T& small_vector<T, N, Alloc, Growth>::at(size_type n)
+	{
+		// n < 0 not allowed due to unsigned typing
+		if (n >= _size)
+		{
+			throw std::out_of_range("small_vector::at");
+		}
+		return _data[n];
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline const T& small_vector<T, N, Alloc, Growth>::at(size_type n) const
+	{
+		// n < 0 not allowed due to unsigned typing
+		if (n >= _size)
+		{
+			throw std::out_of_range("small_vector::at");
+		}
+		return _data[n];
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline T& small_vector<T, N, Alloc, Growth>::front()
+	{
+		return _data[0];
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline const T& small_vector<T, N, Alloc, Growth>::front() const
+	{
+		return _data[0];
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline T& small_vector<T, N, Alloc, Growth>::back()
+	{
+		return _data[_size - 1];
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline const T& small_vector<T, N, Alloc, Growth>::back() const
+	{
+		return _data[_size - 1];
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline T* small_vector<T, N, Alloc, Growth>::data() noexcept
+	{
+		return _data;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline const T* small_vector<T, N, Alloc, Growth>::data() const noexcept
+	{
+		return _data;
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::iterator small_vector<T, N, Alloc, Growth>::begin() noexcept
+	{
+		return iterator(_data);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::const_iterator small_vector<T, N, Alloc, Growth>::begin() const noexcept
+	{
+		return const_iterator(_data);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::const_iterator small_vector<T, N, Alloc, Growth>::cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::iterator small_vector<T, N, Alloc, Growth>::end() noexcept
+	{
+		return iterator(_data + _size);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::const_iterator small_vector<T, N, Alloc, Growth>::end() const noexcept
+	{
+		return const_iterator(_data + _size);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::const_iterator small_vector<T, N, Alloc, Growth>::cend() const noexcept
+	{
+		return end();
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::reverse_iterator small_vector<T, N, Alloc, Growth>::rbegin() noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::const_reverse_iterator small_vector<T, N, Alloc, Growth>::rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::const_reverse_iterator small_vector<T, N, Alloc, Growth>::crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::reverse_iterator small_vector<T, N, Alloc, Growth>::rend() noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::const_reverse_iterator small_vector<T, N, Alloc, Growth>::rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline typename small_vector<T, N, Alloc, Growth>::const_reverse_iterator small_vector<T, N, Alloc, Growth>::crend() const noexcept
+	{
+		return rend();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, size_type N, class Alloc, class Growth>
+	inline size_type small_vector<T, N, Alloc, Growth>::size() const noexcept
+	{
+		return _size;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	constexpr size_type small_vector<T, N, Alloc, Growth>::max_size() const noexcept
+	{
+		return std::numeric_limits<size_type>::max();
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::resize(size_type n)
+	{
+		if (n < _size)
+		{
+			while (_size > n)
+			{
+				pop_back();
+			}
+			return;
+		}
+
+		reserve(n);
+		for (; _size < n; ++_size)
+		{
+			alloc_traits::construct(_alloc, _data + _size);
+		}
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::resize(size_type n, const T& val)
+	{
+		if (n < _size)
+		{
+			while (_size > n)
+			{
+				pop_back();
+			}
+			return;
+		}
+
+		while (_size < n)
+		{
+			push_back(val);
+		}
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline size_type small_vector<T, N, Alloc, Growth>::capacity() const noexcept
+	{
+		return _capacity;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	constexpr size_type small_vector<T, N, Alloc, Growth>::inline_capacity() noexcept
+	{
+		return N;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline bool small_vector<T, N, Alloc, Growth>::is_inline() const noexcept
+	{
+		return _data == inline_data();
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline bool small_vector<T, N, Alloc, Growth>::empty() const noexcept
+	{
+		return _size == 0;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::reserve(size_type n)
+	{
+		if (n <= _capacity)
+		{
+			return;
+		}
+
+		reallocate(n);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::shrink_to_fit()
+	{
+		// Inline storage cannot shrink any further
+		if (!is_inline() && _capacity > _size)
+		{
+			reallocate(_size);
+		}
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class T, size_type N, class Alloc, class Growth>
+	template <class InputIterator>
+	void small_vector<T, N, Alloc, Growth>::assign(InputIterator first, InputIterator last)
+	{
+		if constexpr (std::is_integral<InputIterator>::value) {
+			assign((size_type)first, (T)last);
+		}
+		else {
+			// Need to clear out the elements currently assigned anyway so do it first
+			clear();
+
+			// Only forward iterators can be walked twice to size the storage up front
+			using category = typename std::iterator_traits<InputIterator>::iterator_category;
+			if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+				reserve((size_type)std::distance(first, last));
+			}
+
+			for (; first != last; ++first)
+			{
+				emplace_back(*first);
+			}
+		}
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::assign(size_type n, const T& val)
+	{
+		// Take a copy in case val refers to an element about to be cleared
+		T copy(val);
+
+		clear();
+		reserve(n);
+		for (; _size < n; ++_size)
+		{
+			alloc_traits::construct(_alloc, _data + _size, copy);
+		}
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::assign(std::initializer_list<T> il)
+	{
+		assign(il.begin(), il.end());
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::push_back(const T& val)
+	{
+		emplace_back(val);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::push_back(T&& val)
+	{
+		emplace_back(std::move(val));
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	template <class... Args>
+	void small_vector<T, N, Alloc, Growth>::emplace_back(Args&& ... args)
+	{
+		// Check for reallocation
+		if (_size == _capacity)
+		{
+			reallocate_append(std::forward<Args>(args)...);
+			return;
+		}
+
+		alloc_traits::construct(_alloc, _data + _size, std::forward<Args>(args)...);
+		++_size;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::pop_back()
+	{
+		// Call destructor on the last element in the small_vector
+		// and decrement size so we can write over it later
+		--_size;
+		alloc_traits::destroy(_alloc, _data + _size);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	typename small_vector<T, N, Alloc, Growth>::iterator small_vector<T, N, Alloc, Growth>::insert(iterator position, const T& val)
+	{
+		const auto idx = position - begin();
+
+		// Append and rotate the new element into place
+		emplace_back(val);
+		std::rotate(_data + idx, _data + _size - 1, _data + _size);
+
+		return begin() + idx;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	template <class InputIterator>
+	typename small_vector<T, N, Alloc, Growth>::iterator small_vector<T, N, Alloc, Growth>::insert(iterator position, InputIterator first, InputIterator last)
+	{
+		const auto idx = position - begin();
+		const auto old_size = _size;
+
+		// Only forward iterators can be walked twice to size the storage up front
+		using category = typename std::iterator_traits<InputIterator>::iterator_category;
+		if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+			reserve(_size + (size_type)std::distance(first, last));
+		}
+
+		// Append the whole range then rotate it into place
+		for (; first != last; ++first)
+		{
+			emplace_back(*first);
+		}
+		std::rotate(_data + idx, _data + old_size, _data + _size);
+
+		return begin() + idx;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	typename small_vector<T, N, Alloc, Growth>::iterator small_vector<T, N, Alloc, Growth>::insert(iterator position, T&& val)
+	{
+		const auto idx = position - begin();
+
+		// Append and rotate the new element into place
+		emplace_back(std::move(val));
+		std::rotate(_data + idx, _data + _size - 1, _data + _size);
+
+		return begin() + idx;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	typename small_vector<T, N, Alloc, Growth>::iterator small_vector<T, N, Alloc, Growth>::insert(iterator position, std::initializer_list<T> il)
+	{
+		return insert(position, il.begin(), il.end());
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::swap(small_vector& x)
+	{
+		if (this == &x)
+		{
+			return;
+		}
+
+		// Two allocated arrays can simply trade pointers
+		// unless each has to stay with an unequal allocator which doesn't propagate
+		constexpr bool swap_alloc = alloc_traits::propagate_on_container_swap::value;
+		if (!is_inline() && !x.is_inline() && (swap_alloc || _alloc == x._alloc))
+		{
+			if constexpr (swap_alloc)
+			{
+				using std::swap;
+				swap(_alloc, x._alloc);
+			}
+			std::swap(_capacity, x._capacity);
+			std::swap(_size, x._size);
+			std::swap(_data, x._data);
+			return;
+		}
+
+		// Otherwise at least one side lives inline and has to be relocated
+		small_vector tmp(std::move(x));
+		x = std::move(*this);
+		*this = std::move(tmp);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::clear() noexcept
+	{
+		for (size_type i = 0; i < _size; ++i)
+		{
+			alloc_traits::destroy(_alloc, _data + i);
+		}
+		_size = 0;
+	}
+
+	// ---------------
+	// ALLOCATOR
+	// ---------------
+
+	template <class T, size_type N, class Alloc, class Growth>
+	Alloc small_vector<T, N, Alloc, Growth>::get_allocator() const noexcept
+	{
+		return _alloc;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T, size_type N, class Alloc, class Growth>
+	inline T* small_vector<T, N, Alloc, Growth>::inline_data() noexcept
+	{
+		return reinterpret_cast<T*>(_inline);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	inline const T* small_vector<T, N, Alloc, Growth>::inline_data() const noexcept
+	{
+		return reinterpret_cast<const T*>(_inline);
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::reallocate(size_type cap)
+	{
+		// Everything fits inline, move back from the allocated array
+		if (cap <= N)
+		{
+			if (!is_inline())
+			{
+				relocate_n(_alloc, _data, _size, inline_data());
+				_alloc.deallocate(_data, _capacity);
+				_data = inline_data();
+				_capacity = N;
+			}
+			return;
+		}
+
+		auto cp = _alloc.allocate(cap);
+
+		try
+		{
+			relocate_n(_alloc, _data, _size, cp);
+		}
+		catch (...)
+		{
+			// Old storage is untouched, release the new one and leave the small_vector as it was
+			_alloc.deallocate(cp, cap);
+			throw;
+		}
+
+		if (!is_inline())
+		{
+			_alloc.deallocate(_data, _capacity);
+		}
+		_data = cp;
+		_capacity = cap;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	template <class... Args>
+	void small_vector<T, N, Alloc, Growth>::reallocate_append(Args&& ... args)
+	{
+		const auto cap = grow_capacity(_capacity);
+		auto cp = _alloc.allocate(cap);
+
+		// Construct the new element first as args may live in the current storage
+		try
+		{
+			alloc_traits::construct(_alloc, cp + _size, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			_alloc.deallocate(cp, cap);
+			throw;
+		}
+
+		try
+		{
+			relocate_n(_alloc, _data, _size, cp);
+		}
+		catch (...)
+		{
+			alloc_traits::destroy(_alloc, cp + _size);
+			_alloc.deallocate(cp, cap);
+			throw;
+		}
+
+		if (!is_inline())
+		{
+			_alloc.deallocate(_data, _capacity);
+		}
+		_data = cp;
+		_capacity = cap;
+		++_size;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	constexpr size_type small_vector<T, N, Alloc, Growth>::grow_capacity(size_type n) noexcept
+	{
+		return Growth::grow(n, sizeof(T));
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::steal(small_vector& rhs) noexcept
+	{
+		if (rhs.is_inline())
+		{
+			// Inline elements can't be stolen, relocate them across instead
+			// relocate_n only copies when the move constructor may throw
+			relocate_n(_alloc, rhs._data, rhs._size, inline_data());
+			_size = rhs._size;
+		}
+		else
+		{
+			_data = rhs._data;
+			_capacity = rhs._capacity;
+			_size = rhs._size;
+
+			rhs._data = rhs.inline_data();
+			rhs._capacity = N;
+		}
+		rhs._size = 0;
+	}
+
+	template <class T, size_type N, class Alloc, class Growth>
+	void small_vector<T, N, Alloc, Growth>::reset() noexcept
+	{
+		clear();
+		if (!is_inline())
+		{
+			_alloc.deallocate(_data, _capacity);
+			_data = inline_data();
+			_capacity = N;
+		}
+	}
+
+	namespace pmr
+	{
+		// small_vector using a polymorphic allocator once the inline storage is exhausted
+		template <class T, size_type N, class Growth = double_growth>
+		using small_vector = non_stl::small_vector<T, N, std::pmr::polymorphic_allocator<T>, Growth>;
+	}
+}
@@ -0,0 +1,620 @@
+// snapshot.h
+// A non-stl header only binary snapshot format for non_stl::vector and non_stl::circular_buffer
+// of trivially copyable elements, with a read only view which maps a snapshot without loading it.
+// Note, the standard is used for some components such as std::system_error
+// Note, this component relies on POSIX file I/O and mmap and is only available on POSIX systems
+
+/*
+ * A snapshot is a 64 byte header followed by the elements exactly as they are laid out in memory.
+ * The header records a magic number, the format version, a byte order tag, the element size and
+ * alignment and the element count. A circular_buffer is written oldest element first, so every
+ * snapshot is a flat array and can be loaded into either container or viewed by mapped_vector_view.
+ * save writes the header and the elements with a single writev, straight out of data() or the two
+ * runs of the circular buffer, and load reads them straight into the container, nothing is converted
+ * element by element. save goes through a temporary file which is synced and renamed over path,
+ * so a crash while checkpointing leaves the previous snapshot intact.
+ * mapped_vector_view maps the file read only and points into the mapping, opening it costs the same
+ * whatever its size and the pages are only read from disk when they are first touched.
+ * The elements are stored in the byte order of the machine which wrote them, a snapshot written with
+ * a different byte order, element size or version is rejected rather than misread.
+ * Errors are reported by throwing std::system_error, with EINVAL for files which aren't valid snapshots.
+ */
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Includes
+#include <cerrno>			// errno
+#include <cstdint>			// std::uint32_t, std::uint64_t
+#include <stdexcept>		// std::out_of_range
+#include <string>			// std::string
+#include <system_error>		// std::system_error, std::system_category
+#include <type_traits>		// std::is_trivially_copyable
+#include <utility>			// std::exchange
+
+#include <fcntl.h>			// open
+#include <stdio.h>			// rename
+#include <sys/mman.h>		// mmap, munmap
+#include <sys/stat.h>		// fstat
+#include <sys/uio.h>		// writev, iovec
+#include <unistd.h>			// read, lseek, close, fsync, unlink
+
+#include "circular_buffer.h"	// non_stl::circular_buffer
+#include "contiguous_iterator.h"	// non_stl::contiguous_iterator
+#include "span.h"			// non_stl::span
+#include "vector.h"			// non_stl::vector
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Layout of the start of a snapshot file
+	struct snapshot_header
+	{
+		static constexpr std::uint64_t MAGIC = 0x4e4f4e53544c534e;	// "NONSTLSN"
+		static constexpr std::uint32_t VERSION = 1;
+
+		// Written in the byte order of the machine, reads back as 0x04030201 on the opposite one
+		static constexpr std::uint32_t ORDER_TAG = 0x01020304;
+
+		// The elements start right after the header, aligned for any T the view can map
+		static constexpr std::uint64_t DATA_OFFSET = 64;
+
+		std::uint64_t magic;
+		std::uint32_t version;
+		std::uint32_t byte_order;
+		std::uint32_t element_size;
+		std::uint32_t element_align;
+		std::uint64_t count;
+		std::uint64_t data_offset;
+		unsigned char reserved[24];
+	};
+
+	static_assert(sizeof(snapshot_header) == snapshot_header::DATA_OFFSET, "snapshot_header must fill the space before the data");
+
+	// Writes the elements of vec, or the contents of buf oldest first, to path
+	// The file is replaced as a whole once the snapshot is complete
+	template <class T, class Alloc, class Growth>
+	void save(const std::string& path, const vector<T, Alloc, Growth>& vec);
+	template <class T, size_type N>
+	void save(const std::string& path, const circular_buffer<T, N>& buf);
+
+	// Writes the snapshot at the current position of the open file fd
+	template <class T, class Alloc, class Growth>
+	void save(int fd, const vector<T, Alloc, Growth>& vec);
+	template <class T, size_type N>
+	void save(int fd, const circular_buffer<T, N>& buf);
+
+	// Replaces the contents of vec or buf with the snapshot stored at path
+	// A circular_buffer must be able to hold every element of the snapshot
+	// If an exception is thrown the container is left empty
+	template <class T, class Alloc, class Growth>
+	void load(const std::string& path, vector<T, Alloc, Growth>& vec);
+	template <class T, size_type N>
+	void load(const std::string& path, circular_buffer<T, N>& buf);
+
+	// Reads a snapshot from the current position of the open file fd
+	template <class T, class Alloc, class Growth>
+	void load(int fd, vector<T, Alloc, Growth>& vec);
+	template <class T, size_type N>
+	void load(int fd, circular_buffer<T, N>& buf);
+
+	// Template parameter T is the trivially copyable object stored in the snapshot
+	template <class T>
+	class mapped_vector_view
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "mapped_vector_view requires a trivially copyable type");
+		static_assert(alignof(T) <= snapshot_header::DATA_OFFSET, "mapped_vector_view can't align the elements of T");
+
+	public:
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Maps the snapshot at path read only
+		// Throws std::system_error if the file can't be opened or mapped or isn't a snapshot of T
+		explicit mapped_vector_view(const std::string& path);
+
+		// The mapping is owned by a single object and can't be copied
+		mapped_vector_view(const mapped_vector_view&) = delete;
+		mapped_vector_view& operator=(const mapped_vector_view&) = delete;
+
+		// Move constructor
+		// Other is left without a mapping and may only be destroyed or assigned to
+		mapped_vector_view(mapped_vector_view&& other) noexcept;
+		mapped_vector_view& operator=(mapped_vector_view&& rhs) noexcept;
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+		~mapped_vector_view();
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns a reference to the element at position n with no range check
+		const T& operator[](size_type n) const noexcept;
+
+		// Returns a reference to the element at position n
+		// Function throws an out of range exception if the input is not within range
+		const T& at(size_type n) const;
+
+		const T& front() const noexcept;
+		const T& back() const noexcept;
+
+		// Returns a pointer to the first element inside the mapping
+		const T* data() const noexcept;
+
+		// Returns every element as a span, e.g. for the algorithms in algorithms/simd.h
+		span<const T> contents() const noexcept;
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+		using iterator = contiguous_iterator<T, true>;
+		using const_iterator = iterator;
+
+		iterator begin() const noexcept;
+		iterator end() const noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+		size_type size() const noexcept;
+		bool empty() const noexcept;
+
+	private:
+		// Unmaps the file
+		void unmap() noexcept;
+
+		// Member variables
+
+		// Start and length of the mapping of the whole file
+		void* d_map;
+		size_type d_map_bytes;
+
+		// First element and amount of elements inside the mapping
+		const T* d_data;
+		size_type d_size;
+	};
+
+	namespace detail
+	{
+		// Closes the file descriptor it holds when it goes out of scope
+		struct snapshot_file
+		{
+			explicit snapshot_file(int descriptor) noexcept : fd(descriptor) {}
+			snapshot_file(const snapshot_file&) = delete;
+			snapshot_file& operator=(const snapshot_file&) = delete;
+			~snapshot_file() { if (fd >= 0) ::close(fd); }
+
+			int fd;
+		};
+
+		[[noreturn]] inline void snapshot_fail(int error, const char* what)
+		{
+			throw std::system_error(error, std::system_category(), what);
+		}
+
+		template <class T>
+		snapshot_header make_snapshot_header(size_type count) noexcept
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "snapshots require a trivially copyable type");
+
+			snapshot_header header{};
+			header.magic = snapshot_header::MAGIC;
+			header.version = snapshot_header::VERSION;
+			header.byte_order = snapshot_header::ORDER_TAG;
+			header.element_size = static_cast<std::uint32_t>(sizeof(T));
+			header.element_align = static_cast<std::uint32_t>(alignof(T));
+			header.count = count;
+			header.data_offset = snapshot_header::DATA_OFFSET;
+			return header;
+		}
+
+		// Throws unless header describes a snapshot of T, returns the element count
+		template <class T>
+		size_type check_snapshot_header(const snapshot_header& header)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "snapshots require a trivially copyable type");
+
+			if (header.magic != snapshot_header::MAGIC) {
+				snapshot_fail(EINVAL, "snapshot: not a snapshot file");
+			}
+			if (header.byte_order != snapshot_header::ORDER_TAG) {
+				snapshot_fail(EINVAL, "snapshot: written with a different byte order");
+			}
+			if (header.version != snapshot_header::VERSION) {
+				snapshot_fail(EINVAL, "snapshot: unsupported version");
+			}
+			if (header.element_size != sizeof(T) || header.data_offset != snapshot_header::DATA_OFFSET) {
+				snapshot_fail(EINVAL, "snapshot: holds a different element type");
+			}
+			return static_cast<size_type>(header.count);
+		}
+
+		// Writes every buffer of iov, resuming after partial writes
+		inline void write_all(int fd, iovec* iov, int count)
+		{
+			while (count > 0) {
+				const ssize_t written = ::writev(fd, iov, count);
+				if (written < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					snapshot_fail(errno, "snapshot: writev");
+				}
+
+				// Skip the buffers which were written completely and advance into the next one
+				size_type left = static_cast<size_type>(written);
+				while (count > 0 && left >= iov->iov_len) {
+					left -= iov->iov_len;
+					++iov;
+					--count;
+				}
+				if (count > 0) {
+					iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+					iov->iov_len -= left;
+				}
+			}
+		}
+
+		// Reads exactly bytes into dest, a file ending early is not a valid snapshot
+		inline void read_all(int fd, void* dest, size_type bytes)
+		{
+			auto out = static_cast<char*>(dest);
+			while (bytes > 0) {
+				const ssize_t got = ::read(fd, out, bytes);
+				if (got < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					snapshot_fail(errno, "snapshot: read");
+				}
+				if (got == 0) {
+					snapshot_fail(EINVAL, "snapshot: truncated file");
+				}
+				out += got;
+				bytes -= static_cast<size_type>(got);
+			}
+		}
+
+		// Throws unless count elements of T can follow the current offset of fd
+		// Called before allocating so a corrupt count fails like any other malformed header
+		template <class T>
+		void check_snapshot_count(int fd, size_type count)
+		{
+			if (count > static_cast<size_type>(-1) / sizeof(T)) {
+				snapshot_fail(EINVAL, "snapshot: truncated file");
+			}
+
+			// Only regular files know their size, pipes and sockets are left to read_all
+			struct stat st;
+			if (::fstat(fd, &st) != 0) {
+				snapshot_fail(errno, "snapshot: fstat");
+			}
+			if (!S_ISREG(st.st_mode)) {
+				return;
+			}
+			const off_t offset = ::lseek(fd, 0, SEEK_CUR);
+			if (offset < 0) {
+				snapshot_fail(errno, "snapshot: lseek");
+			}
+			const size_type left = st.st_size > offset ? static_cast<size_type>(st.st_size - offset) : 0;
+			if (count > left / sizeof(T)) {
+				snapshot_fail(EINVAL, "snapshot: truncated file");
+			}
+		}
+
+		template <class T>
+		void save_runs(int fd, span<const T> one, span<const T> two)
+		{
+			snapshot_header header = make_snapshot_header<T>(one.size() + two.size());
+
+			iovec iov[3];
+			iov[0] = { &header, sizeof(header) };
+			iov[1] = { const_cast<T*>(one.data()), one.size() * sizeof(T) };
+			iov[2] = { const_cast<T*>(two.data()), two.size() * sizeof(T) };
+			write_all(fd, iov, 3);
+		}
+
+		// Writes a snapshot to a temporary file next to path using save_fd, then replaces path with it
+		template <class Save>
+		void save_file(const std::string& path, Save save_fd)
+		{
+			const std::string tmp = path + ".tmp";
+			{
+				snapshot_file file(::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+				if (file.fd < 0) {
+					snapshot_fail(errno, "snapshot: open");
+				}
+				try {
+					save_fd(file.fd);
+
+					// The data has to be on disk before the rename makes it the snapshot
+					if (::fsync(file.fd) != 0) {
+						snapshot_fail(errno, "snapshot: fsync");
+					}
+				}
+				catch (...) {
+					// Don't leave a partial snapshot behind
+					::unlink(tmp.c_str());
+					throw;
+				}
+			}
+			if (::rename(tmp.c_str(), path.c_str()) != 0) {
+				const int error = errno;
+				::unlink(tmp.c_str());
+				snapshot_fail(error, "snapshot: rename");
+			}
+		}
+
+		inline int open_snapshot(const std::string& path)
+		{
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				snapshot_fail(errno, "snapshot: open");
+			}
+			return fd;
+		}
+	}
+
+	// SNAPSHOT IMPL
+
+	// ---------------
+	// SAVE
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	void save(int fd, const vector<T, Alloc, Growth>& vec)
+	{
+		detail::save_runs<T>(fd, span<const T>(vec.data(), vec.size()), span<const T>());
+	}
+
+	template <class T, size_type N>
+	void save(int fd, const circular_buffer<T, N>& buf)
+	{
+		// Oldest first, the wrapped second run follows the first in the file
+		detail::save_runs<T>(fd, buf.array_one(), buf.array_two());
+	}
+
+	template <class T, class Alloc, class Growth>
+	void save(const std::string& path, const vector<T, Alloc, Growth>& vec)
+	{
+		detail::save_file(path, [&](int fd) { save(fd, vec); });
+	}
+
+	template <class T, size_type N>
+	void save(const std::string& path, const circular_buffer<T, N>& buf)
+	{
+		detail::save_file(path, [&](int fd) { save(fd, buf); });
+	}
+
+	// ---------------
+	// LOAD
+	// ---------------
+	template <class T, class Alloc, class Growth>
+	void load(int fd, vector<T, Alloc, Growth>& vec)
+	{
+		vec.clear();
+
+		snapshot_header header;
+		detail::read_all(fd, &header, sizeof(header));
+		const size_type count = detail::check_snapshot_header<T>(header);
+		detail::check_snapshot_count<T>(fd, count);
+
+		// The elements are read straight into the vector, they need no initialization beforehand
+		try {
+			detail::read_all(fd, vec.append_uninitialized(count).data(), count * sizeof(T));
+		}
+		catch (...) {
+			vec.clear();
+			throw;
+		}
+	}
+
+	template <class T, size_type N>
+	void load(int fd, circular_buffer<T, N>& buf)
+	{
+		buf.clear();
+
+		snapshot_header header;
+		detail::read_all(fd, &header, sizeof(header));
+		const size_type count = detail::check_snapshot_header<T>(header);
+		if (count > N) {
+			detail::snapshot_fail(EINVAL, "snapshot: more elements than the circular_buffer holds");
+		}
+		detail::check_snapshot_count<T>(fd, count);
+
+		// Read into the free slots after the back and append them once they are complete
+		const span<T> one = buf.free_one();
+		const size_type first = count < one.size() ? count : one.size();
+		detail::read_all(fd, one.data(), first * sizeof(T));
+		detail::read_all(fd, buf.free_two().data(), (count - first) * sizeof(T));
+		buf.commit_back(count);
+	}
+
+	template <class T, class Alloc, class Growth>
+	void load(const std::string& path, vector<T, Alloc, Growth>& vec)
+	{
+		detail::snapshot_file file(detail::open_snapshot(path));
+		load(file.fd, vec);
+	}
+
+	template <class T, size_type N>
+	void load(const std::string& path, circular_buffer<T, N>& buf)
+	{
+		detail::snapshot_file file(detail::open_snapshot(path));
+		load(file.fd, buf);
+	}
+
+	// MAPPED_VECTOR_VIEW IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T>
+	mapped_vector_view<T>::mapped_vector_view(const std::string& path)
+		: d_map(nullptr)
+		, d_map_bytes(0)
+		, d_data(nullptr)
+		, d_size(0)
+	{
+		// The mapping stays valid once the descriptor is closed
+		detail::snapshot_file file(detail::open_snapshot(path));
+
+		struct stat st;
+		if (::fstat(file.fd, &st) != 0) {
+			detail::snapshot_fail(errno, "snapshot: fstat");
+		}
+		d_map_bytes = static_cast<size_type>(st.st_size);
+		if (d_map_bytes < sizeof(snapshot_header)) {
+			detail::snapshot_fail(EINVAL, "snapshot: truncated file");
+		}
+
+		d_map = ::mmap(nullptr, d_map_bytes, PROT_READ, MAP_PRIVATE, file.fd, 0);
+		if (d_map == MAP_FAILED) {
+			d_map = nullptr;
+			detail::snapshot_fail(errno, "snapshot: mmap");
+		}
+
+		try {
+			const auto header = static_cast<const snapshot_header*>(d_map);
+			d_size = detail::check_snapshot_header<T>(*header);
+			if (d_size > (d_map_bytes - sizeof(snapshot_header)) / sizeof(T)) {
+				detail::snapshot_fail(EINVAL, "snapshot: truncated file");
+			}
+		}
+		catch (...) {
+			unmap();
+			throw;
+		}
+
+		// The bytes were written from live objects of T, so they are objects of T again
+		d_data = reinterpret_cast<const T*>(static_cast<const unsigned char*>(d_map) + sizeof(snapshot_header));
+	}
+
+	template <class T>
+	mapped_vector_view<T>::mapped_vector_view(mapped_vector_view&& other) noexcept
+		: d_map(std::exchange(other.d_map, nullptr))
+		, d_map_bytes(std::exchange(other.d_map_bytes, 0))
+		, d_data(std::exchange(other.d_data, nullptr))
+		, d_size(std::exchange(other.d_size, 0))
+	{
+
+	}
+
+	// ---------------
+	// OPERATOR=
+	// ---------------
+	template <class T>
+	mapped_vector_view<T>& mapped_vector_view<T>::operator=(mapped_vector_view&& rhs) noexcept
+	{
+		if (this != &rhs) {
+			unmap();
+			d_map = std::exchange(rhs.d_map, nullptr);
+			d_map_bytes = std::exchange(rhs.d_map_bytes, 0);
+			d_data = std::exchange(rhs.d_data, nullptr);
+			d_size = std::exchange(rhs.d_size, 0);
+		}
+		return *this;
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class T>
+	mapped_vector_view<T>::~mapped_vector_view()
+	{
+		unmap();
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T>
+	const T& mapped_vector_view<T>::operator[](size_type n) const noexcept
+	{
+		return d_data[n];
+	}
+
+	template <class T>
+	const T& mapped_vector_view<T>::at(size_type n) const
+	{
+		if (n >= d_size) {
+			throw std::out_of_range("mapped_vector_view::at - index out of range");
+		}
+		return d_data[n];
+	}
+
+	template <class T>
+	const T& mapped_vector_view<T>::front() const noexcept
+	{
+		return d_data[0];
+	}
+
+	template <class T>
+	const T& mapped_vector_view<T>::back() const noexcept
+	{
+		return d_data[d_size - 1];
+	}
+
+	template <class T>
+	const T* mapped_vector_view<T>::data() const noexcept
+	{
+		return d_data;
+	}
+
+	template <class T>
+	span<const T> mapped_vector_view<T>::contents() const noexcept
+	{
+		return span<const T>(d_data, d_size);
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class T>
+	typename mapped_vector_view<T>::iterator mapped_vector_view<T>::begin() const noexcept
+	{
+		return iterator(d_data);
+	}
+
+	template <class T>
+	typename mapped_vector_view<T>::iterator mapped_vector_view<T>::end() const noexcept
+	{
+		return iterator(d_data + d_size);
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T>
+	size_type mapped_vector_view<T>::size() const noexcept
+	{
+		return d_size;
+	}
+
+	template <class T>
+	bool mapped_vector_view<T>::empty() const noexcept
+	{
+		return d_size == 0;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T>
+	void mapped_vector_view<T>::unmap() noexcept
+	{
+		if (d_map) {
+			::munmap(d_map, d_map_bytes);
+			d_map = nullptr;
+		}
+		d_data = nullptr;
+		d_size = 0;
+	}
+}
+
+#endif
@@ -0,0 +1,1207 @@
+// soa_vector.h
+// A non-stl header only implementation of a structure of arrays vector which stores each field
+// of its rows in an array of its own, sharing the growth policies and allocators of non_stl::vector.
+// Note, the standard is used for some components such as std::allocator, std::tuple and exceptions
+
+/*
+ * A soa_vector<Ts...> holds rows of the types Ts... but instead of interleaving them as a vector of
+ * structs would, every field lives in its own contiguous column. Loops which only read one field then
+ * stream exactly the bytes of that field, and column<I>() hands the field out as a span which can be
+ * given straight to the algorithms in simd.h.
+ * The columns share a single allocation, each starting on a cache line, so growing reallocates once
+ * for all of them. Rows are accessed as tuples of references, through operator[] or the zip iterator.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::equal, std::max
+#include <cstddef>			// std::byte, std::ptrdiff_t
+#include <cstring>			// std::memcpy
+#include <iterator>			// std::random_access_iterator_tag, std::reverse_iterator
+#include <limits>			// std::numeric_limits
+#include <memory>			// std::allocator, std::allocator_traits
+#include <memory_resource>	// std::pmr::polymorphic_allocator
+#include <stdexcept>		// std::out_of_range
+#include <tuple>			// std::tuple, std::get, std::forward_as_tuple
+#include <type_traits>		// std::conditional_t, std::integral_constant, std::is_trivially_copyable_v
+#include <utility>			// std::forward, std::move, std::index_sequence
+
+#include "growth_policy.h"	// non_stl::double_growth
+#include "span.h"			// non_stl::span
+#include "../memory/cache_line.h"	// non_stl::cache_line_size
+#include "../memory/relocate.h"	// non_stl::relocate_n, non_stl::is_trivially_relocatable_v
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Random access iterator over the rows of a soa_vector, dereferencing to a tuple of references
+	// to the fields of the row. As the reference is a proxy, algorithms which swap elements
+	// through it such as std::sort are not supported
+	template <bool isConst, class... Ts>
+	class soa_iterator
+	{
+		template <bool otherConst, class... Us>
+		friend class soa_iterator;
+
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::tuple<Ts...>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = std::conditional_t<isConst, std::tuple<const Ts&...>, std::tuple<Ts&...> >;
+		using columns = std::conditional_t<isConst, std::tuple<const Ts*...>, std::tuple<Ts*...> >;
+
+		constexpr soa_iterator() noexcept : _columns(), _idx(0) {}
+		constexpr soa_iterator(const columns& cols, difference_type idx) noexcept : _columns(cols), _idx(idx) {}
+
+		// A non const iterator is implicitly convertible to a const iterator
+		template <bool otherConst, class = std::enable_if_t<isConst && !otherConst> >
+		constexpr soa_iterator(const soa_iterator<otherConst, Ts...>& other) noexcept :
+			_columns(other._columns), _idx(other._idx) {}
+
+		// Returns the position of the row this iterator refers to
+		constexpr difference_type index() const noexcept { return _idx; }
+
+		constexpr reference operator*() const noexcept { return (*this)[0]; }
+
+		constexpr reference operator[](difference_type n) const noexcept
+		{
+			return std::apply([this, n](auto*... cols) { return reference(cols[_idx + n]...); }, _columns);
+		}
+
+		constexpr soa_iterator& operator++() noexcept { ++_idx; return *this; }
+		constexpr soa_iterator operator++(int) noexcept { soa_iterator iter = *this; ++_idx; return iter; }
+		constexpr soa_iterator& operator--() noexcept { --_idx; return *this; }
+		constexpr soa_iterator operator--(int) noexcept { soa_iterator iter = *this; --_idx; return iter; }
+		constexpr soa_iterator& operator+=(difference_type n) noexcept { _idx += n; return *this; }
+		constexpr soa_iterator& operator-=(difference_type n) noexcept { _idx -= n; return *this; }
+
+		constexpr soa_iterator operator+(difference_type n) const noexcept { return soa_iterator(_columns, _idx + n); }
+		constexpr soa_iterator operator-(difference_type n) const noexcept { return soa_iterator(_columns, _idx - n); }
+		friend constexpr soa_iterator operator+(difference_type n, const soa_iterator& iter) noexcept { return iter + n; }
+
+		// Iterators are only comparable when they belong to the same soa_vector
+		template <bool otherConst>
+		constexpr difference_type operator-(const soa_iterator<otherConst, Ts...>& rhs) const noexcept { return _idx - rhs._idx; }
+		template <bool otherConst>
+		constexpr bool operator==(const soa_iterator<otherConst, Ts...>& rhs) const noexcept { return _idx == rhs._idx; }
+		template <bool otherConst>
+		constexpr bool operator!=(const soa_iterator<otherConst, Ts...>& rhs) const noexcept { return _idx != rhs._idx; }
+		template <bool otherConst>
+		constexpr bool operator<(const soa_iterator<otherConst, Ts...>& rhs) const noexcept { return _idx < rhs._idx; }
+		template <bool otherConst>
+		constexpr bool operator>(const soa_iterator<otherConst, Ts...>& rhs) const noexcept { return _idx > rhs._idx; }
+		template <bool otherConst>
+		constexpr bool operator<=(const soa_iterator<otherConst, Ts...>& rhs) const noexcept { return _idx <= rhs._idx; }
+		template <bool otherConst>
+		constexpr bool operator>=(const soa_iterator<otherConst, Ts...>& rhs) const noexcept { return _idx >= rhs._idx; }
+
+	private:
+		// Start of every column, the row is found by indexing each of them
+		columns _columns;
+		difference_type _idx;
+	};
+
+	// Template parameter Alloc is the allocator the storage of the columns is obtained from, it is
+	// rebound to cache line sized blocks so any allocator of non_stl::vector may be used
+	// Template parameter Growth is the growth policy which decides the new capacity, see growth_policy.h
+	// Template parameters Ts are the fields of a row, each stored in its own column
+	template <class Alloc, class Growth, class... Ts>
+	class basic_soa_vector
+	{
+		static_assert(sizeof...(Ts) > 0, "soa_vector requires at least one column");
+		static_assert(((alignof(Ts) <= cache_line_size) && ...), "soa_vector columns cannot be aligned past a cache line");
+
+		// Unit of allocation, so every column can start on its own cache line
+		struct alignas(cache_line_size) block
+		{
+			unsigned char bytes[cache_line_size];
+		};
+
+		using block_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<block>;
+		using block_traits = std::allocator_traits<block_allocator>;
+
+		using columns = std::tuple<Ts*...>;
+		using const_columns = std::tuple<const Ts*...>;
+
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		using value_type = std::tuple<Ts...>;
+		using reference = std::tuple<Ts&...>;
+		using const_reference = std::tuple<const Ts&...>;
+		using allocator_type = Alloc;
+
+		using iterator = soa_iterator<false, Ts...>;
+		using const_iterator = soa_iterator<true, Ts...>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Type of the column at index I
+		template <size_type I>
+		using column_type = std::tuple_element_t<I, value_type>;
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor
+		// Every constructor optionally takes the allocator to use
+		basic_soa_vector() noexcept(noexcept(Alloc()));
+		explicit basic_soa_vector(const Alloc& alloc) noexcept;
+
+		// Fill constructor
+		// Constructs size rows, value initialized or copies of row if provided
+		explicit basic_soa_vector(size_type size, const Alloc& alloc = Alloc());
+		basic_soa_vector(size_type size, const value_type& row, const Alloc& alloc = Alloc());
+
+		// Copy constructor
+		// The allocator is obtained from select_on_container_copy_construction unless provided
+		basic_soa_vector(const basic_soa_vector& rhs);
+		basic_soa_vector(const basic_soa_vector& rhs, const Alloc& alloc);
+
+		// Move constructor
+		// If an unequal allocator is provided the rows are moved one column at a time instead
+		basic_soa_vector(basic_soa_vector&& rhs) noexcept;
+		basic_soa_vector(basic_soa_vector&& rhs, const Alloc& alloc);
+
+		// ---------------
+		// OPERATOR=
+		// ---------------
+
+		// The allocator follows the propagate_on_container traits as in non_stl::vector
+		basic_soa_vector& operator=(const basic_soa_vector& rhs);
+		basic_soa_vector& operator=(basic_soa_vector&& rhs) noexcept(
+			block_traits::propagate_on_container_move_assignment::value ||
+			block_traits::is_always_equal::value);
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+		~basic_soa_vector();
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns the fields of the row at position n
+		reference operator[](size_type n) noexcept;
+		const_reference operator[](size_type n) const noexcept;
+
+		// Returns the fields of the row at position n
+		// Throws std::out_of_range if n is not a position within the soa_vector
+		reference at(size_type n);
+		const_reference at(size_type n) const;
+
+		// Returns the fields of the first row
+		reference front() noexcept;
+		const_reference front() const noexcept;
+
+		// Returns the fields of the last row
+		reference back() noexcept;
+		const_reference back() const noexcept;
+
+		// Returns the column I as a contiguous span of size() elements
+		template <size_type I>
+		span<column_type<I> > column() noexcept;
+		template <size_type I>
+		span<const column_type<I> > column() const noexcept;
+
+		// Returns a pointer to the first element of column I, aligned to a cache line
+		template <size_type I>
+		column_type<I>* data() noexcept;
+		template <size_type I>
+		const column_type<I>* data() const noexcept;
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+
+		// Zip iterators over the rows
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		reverse_iterator rbegin() noexcept;
+		const_reverse_iterator rbegin() const noexcept;
+		reverse_iterator rend() noexcept;
+		const_reverse_iterator rend() const noexcept;
+		const_iterator cbegin() const noexcept;
+		const_iterator cend() const noexcept;
+		const_reverse_iterator crbegin() const noexcept;
+		const_reverse_iterator crend() const noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+		bool empty() const noexcept;
+		size_type size() const noexcept;
+		size_type capacity() const noexcept;
+		size_type max_size() const noexcept;
+
+		// Resizes to n rows, removing rows from the end or appending value initialized rows
+		// or copies of row if provided
+		void resize(size_type n);
+		void resize(size_type n, const value_type& row);
+
+		// Ensures room for at least n rows, reallocating every column at once if needed
+		void reserve(size_type n);
+
+		// Reduces the capacity to the size
+		void shrink_to_fit();
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Appends a row with the fields of row
+		void push_back(const value_type& row);
+		void push_back(value_type&& row);
+
+		// Appends a row constructing each column from the matching argument
+		// An empty argument list appends a value initialized row
+		template <class... Args>
+		reference emplace_back(Args&& ... args);
+
+		// Removes the last row
+		void pop_back();
+
+		// Exchanges the contents of this soa_vector and x
+		void swap(basic_soa_vector& x) noexcept;
+
+		// Removes every row, the capacity is unchanged
+		void clear() noexcept;
+
+		// ---------------
+		// ALLOCATOR
+		// ---------------
+		Alloc get_allocator() const noexcept;
+
+		// ---------------
+		// END INTERFACE
+		// ---------------
+	private:
+		// Private functions
+
+		template <size_type I>
+		using column_allocator = typename block_traits::template rebind_alloc<column_type<I> >;
+
+		// Calls f with std::integral_constant<size_type, I> for the index I of every column in order
+		template <class F, size_t... Is>
+		static void for_each_column(F&& f, std::index_sequence<Is...>);
+		template <class F>
+		static void for_each_column(F&& f);
+
+		// Returns the amount of blocks column storage for cap rows takes
+		static constexpr size_type blocks_for(size_type cap) noexcept;
+
+		// Returns the start of every column of cap rows within the blocks at base
+		static columns layout(block* base, size_type cap) noexcept;
+
+		// Returns the capacity requested from the growth policy when
+		// the soa_vector needs room for more than n rows
+		static constexpr size_type grow_capacity(size_type n) noexcept;
+
+		// Allocates the blocks for cap rows, nullptr when cap is 0
+		block* allocate(size_type cap);
+
+		// Returns the blocks of cap rows at base to the allocator
+		void deallocate(block* base, size_type cap) noexcept;
+
+		// Reallocates every column to capacity cap, relocating the rows over
+		void reallocate(size_type cap);
+
+		// Ensures the capacity is at least n, growing by the policy if needed
+		void grow_for(size_type n);
+
+		// Relocates n rows from columns from into the uninitialized columns to
+		// Columns which can be relocated without throwing are, otherwise every column is copied
+		// and the originals destroyed once all copies succeeded, so from is untouched on failure
+		void relocate_rows(const columns& from, size_type n, const columns& to);
+
+		// Constructs n rows at to copied, or moved if Move, from the rows at from
+		// If an exception is thrown the columns already constructed are destroyed
+		template <bool Move, class From>
+		void construct_rows(const From& from, size_type n, const columns& to);
+
+		// Constructs the n elements of column I at dest from src, rolled back on failure
+		template <size_type I, bool Move, class Src>
+		void construct_column(Src* src, size_type n, column_type<I>* dest);
+
+		// Constructs the row at idx of cols, column I and after from the matching field of args,
+		// value initializing the columns args has no field for
+		// If an exception is thrown the columns of the row already constructed are destroyed
+		template <size_type I = 0, class Tuple>
+		void construct_row(const columns& cols, size_type idx, Tuple&& args);
+
+		// Destroys the rows [first, last) of cols
+		void destroy_rows(const columns& cols, size_type first, size_type last) noexcept;
+
+		// Appends a row constructed from the fields of args
+		template <class Tuple>
+		void append_row(Tuple&& args);
+
+		// Grows past the current capacity and constructs the new row from args before
+		// relocating, so args may refer to a row of this soa_vector
+		template <class Tuple>
+		void reallocate_append(Tuple&& args);
+
+		// Destroys every row and returns the storage to the allocator
+		void release() noexcept;
+
+		// Takes the storage of rhs, leaving rhs empty with no capacity
+		// Assumed that this soa_vector holds no storage
+		void steal(basic_soa_vector& rhs) noexcept;
+
+		// Returns the columns as pointers to const
+		const_columns const_cols() const noexcept;
+
+		// Member variables
+
+		// Allocator object, rebound to blocks
+		block_allocator _alloc;
+
+		// Maximum amount of rows the columns have room for
+		size_type _capacity;
+
+		// The current amount of rows
+		size_type _size;
+
+		// Start of the single allocation holding every column
+		block* _blocks;
+
+		// Start of each column within _blocks
+		columns _columns;
+	};
+
+	namespace detail
+	{
+		template <class Soa, size_t... Is>
+		bool soa_columns_equal(const Soa& lhs, const Soa& rhs, std::index_sequence<Is...>)
+		{
+			return (std::equal(lhs.template column<Is>().begin(), lhs.template column<Is>().end(),
+				rhs.template column<Is>().begin()) && ...);
+		}
+	}
+
+	// Structure of arrays vector with the default allocator and growth policy
+	template <class... Ts>
+	using soa_vector = basic_soa_vector<std::allocator<std::byte>, double_growth, Ts...>;
+
+	// SOA VECTOR IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>::basic_soa_vector() noexcept(noexcept(Alloc())) :
+		basic_soa_vector(Alloc())
+	{
+
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>::basic_soa_vector(const Alloc& alloc) noexcept :
+		_alloc(alloc),
+		_capacity(0),
+		_size(0),
+		_blocks(nullptr),
+		_columns()
+	{
+
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>::basic_soa_vector(size_type size, const Alloc& alloc) :
+		basic_soa_vector(alloc)
+	{
+		resize(size);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>::basic_soa_vector(size_type size, const value_type& row, const Alloc& alloc) :
+		basic_soa_vector(alloc)
+	{
+		resize(size, row);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>::basic_soa_vector(const basic_soa_vector& rhs) :
+		basic_soa_vector(rhs, Alloc(block_traits::select_on_container_copy_construction(rhs._alloc)))
+	{
+
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>::basic_soa_vector(const basic_soa_vector& rhs, const Alloc& alloc) :
+		basic_soa_vector(alloc)
+	{
+		reserve(rhs._size);
+		construct_rows<false>(rhs.const_cols(), rhs._size, _columns);
+		_size = rhs._size;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>::basic_soa_vector(basic_soa_vector&& rhs) noexcept :
+		_alloc(std::move(rhs._alloc)),
+		_capacity(0),
+		_size(0),
+		_blocks(nullptr),
+		_columns()
+	{
+		steal(rhs);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>::basic_soa_vector(basic_soa_vector&& rhs, const Alloc& alloc) :
+		basic_soa_vector(alloc)
+	{
+		if (_alloc == rhs._alloc)
+		{
+			steal(rhs);
+		}
+		else
+		{
+			// The storage belongs to another allocator, move the rows into our own
+			reserve(rhs._size);
+			construct_rows<true>(rhs._columns, rhs._size, _columns);
+			_size = rhs._size;
+			rhs.clear();
+		}
+	}
+
+	// ---------------
+	// OPERATOR=
+	// ---------------
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>& basic_soa_vector<Alloc, Growth, Ts...>::operator=(const basic_soa_vector& rhs)
+	{
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		// Deallocate current storage, with the allocator it came from
+		release();
+		if constexpr (block_traits::propagate_on_container_copy_assignment::value)
+		{
+			_alloc = rhs._alloc;
+		}
+
+		reserve(rhs._size);
+		construct_rows<false>(rhs.const_cols(), rhs._size, _columns);
+		_size = rhs._size;
+
+		return *this;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>& basic_soa_vector<Alloc, Growth, Ts...>::operator=(basic_soa_vector&& rhs) noexcept(
+		block_traits::propagate_on_container_move_assignment::value ||
+		block_traits::is_always_equal::value)
+	{
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		if constexpr (block_traits::propagate_on_container_move_assignment::value)
+		{
+			// Take the allocator along with the storage
+			release();
+			_alloc = std::move(rhs._alloc);
+			steal(rhs);
+		}
+		else
+		{
+			if (_alloc == rhs._alloc)
+			{
+				release();
+				steal(rhs);
+			}
+			else
+			{
+				// Can't adopt storage from another allocator, move the rows one column at a time
+				clear();
+				reserve(rhs._size);
+				construct_rows<true>(rhs._columns, rhs._size, _columns);
+				_size = rhs._size;
+				rhs.clear();
+			}
+		}
+
+		return *this;
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class Alloc, class Growth, class... Ts>
+	basic_soa_vector<Alloc, Growth, Ts...>::~basic_soa_vector()
+	{
+		release();
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::reference basic_soa_vector<Alloc, Growth, Ts...>::operator[](size_type n) noexcept
+	{
+		return begin()[n];
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_reference basic_soa_vector<Alloc, Growth, Ts...>::operator[](size_type n) const noexcept
+	{
+		return begin()[n];
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::reference basic_soa_vector<Alloc, Growth, Ts...>::at(size_type n)
+	{
+		if (n >= _size)
+		{
+			throw std::out_of_range("soa_vector::at - index out of range");
+		}
+		return (*this)[n];
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_reference basic_soa_vector<Alloc, Growth, Ts...>::at(size_type n) const
+	{
+		if (n >= _size)
+		{
+			throw std::out_of_range("soa_vector::at - index out of range");
+		}
+		return (*this)[n];
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::reference basic_soa_vector<Alloc, Growth, Ts...>::front() noexcept
+	{
+		return (*this)[0];
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_reference basic_soa_vector<Alloc, Growth, Ts...>::front() const noexcept
+	{
+		return (*this)[0];
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::reference basic_soa_vector<Alloc, Growth, Ts...>::back() noexcept
+	{
+		return (*this)[_size - 1];
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_reference basic_soa_vector<Alloc, Growth, Ts...>::back() const noexcept
+	{
+		return (*this)[_size - 1];
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <size_type I>
+	inline span<typename basic_soa_vector<Alloc, Growth, Ts...>::template column_type<I> > basic_soa_vector<Alloc, Growth, Ts...>::column() noexcept
+	{
+		return span<column_type<I> >(std::get<I>(_columns), _size);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <size_type I>
+	inline span<const typename basic_soa_vector<Alloc, Growth, Ts...>::template column_type<I> > basic_soa_vector<Alloc, Growth, Ts...>::column() const noexcept
+	{
+		return span<const column_type<I> >(std::get<I>(_columns), _size);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <size_type I>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::template column_type<I>* basic_soa_vector<Alloc, Growth, Ts...>::data() noexcept
+	{
+		return std::get<I>(_columns);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <size_type I>
+	inline const typename basic_soa_vector<Alloc, Growth, Ts...>::template column_type<I>* basic_soa_vector<Alloc, Growth, Ts...>::data() const noexcept
+	{
+		return std::get<I>(_columns);
+	}
+
+	// ---------------
+	// ITERATORS
+	// ---------------
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::iterator basic_soa_vector<Alloc, Growth, Ts...>::begin() noexcept
+	{
+		return iterator(_columns, 0);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_iterator basic_soa_vector<Alloc, Growth, Ts...>::begin() const noexcept
+	{
+		return const_iterator(const_cols(), 0);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::iterator basic_soa_vector<Alloc, Growth, Ts...>::end() noexcept
+	{
+		return iterator(_columns, static_cast<std::ptrdiff_t>(_size));
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_iterator basic_soa_vector<Alloc, Growth, Ts...>::end() const noexcept
+	{
+		return const_iterator(const_cols(), static_cast<std::ptrdiff_t>(_size));
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::reverse_iterator basic_soa_vector<Alloc, Growth, Ts...>::rbegin() noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_reverse_iterator basic_soa_vector<Alloc, Growth, Ts...>::rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::reverse_iterator basic_soa_vector<Alloc, Growth, Ts...>::rend() noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_reverse_iterator basic_soa_vector<Alloc, Growth, Ts...>::rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_iterator basic_soa_vector<Alloc, Growth, Ts...>::cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_iterator basic_soa_vector<Alloc, Growth, Ts...>::cend() const noexcept
+	{
+		return end();
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_reverse_iterator basic_soa_vector<Alloc, Growth, Ts...>::crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_reverse_iterator basic_soa_vector<Alloc, Growth, Ts...>::crend() const noexcept
+	{
+		return rend();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class Alloc, class Growth, class... Ts>
+	inline bool basic_soa_vector<Alloc, Growth, Ts...>::empty() const noexcept
+	{
+		return _size == 0;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline size_type basic_soa_vector<Alloc, Growth, Ts...>::size() const noexcept
+	{
+		return _size;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline size_type basic_soa_vector<Alloc, Growth, Ts...>::capacity() const noexcept
+	{
+		return _capacity;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline size_type basic_soa_vector<Alloc, Growth, Ts...>::max_size() const noexcept
+	{
+		return std::numeric_limits<size_type>::max() / (sizeof(Ts) + ...);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::resize(size_type n)
+	{
+		if (n <= _size)
+		{
+			destroy_rows(_columns, n, _size);
+			_size = n;
+			return;
+		}
+
+		grow_for(n);
+		while (_size < n)
+		{
+			construct_row(_columns, _size, std::tuple<>());
+			++_size;
+		}
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::resize(size_type n, const value_type& row)
+	{
+		if (n <= _size)
+		{
+			destroy_rows(_columns, n, _size);
+			_size = n;
+			return;
+		}
+
+		grow_for(n);
+		while (_size < n)
+		{
+			construct_row(_columns, _size, row);
+			++_size;
+		}
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::reserve(size_type n)
+	{
+		if (n > _capacity)
+		{
+			reallocate(n);
+		}
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::shrink_to_fit()
+	{
+		if (_capacity > _size)
+		{
+			reallocate(_size);
+		}
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::push_back(const value_type& row)
+	{
+		append_row(row);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::push_back(value_type&& row)
+	{
+		append_row(std::move(row));
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <class... Args>
+	typename basic_soa_vector<Alloc, Growth, Ts...>::reference basic_soa_vector<Alloc, Growth, Ts...>::emplace_back(Args&& ... args)
+	{
+		static_assert(sizeof...(Args) == 0 || sizeof...(Args) == sizeof...(Ts),
+			"soa_vector::emplace_back takes one argument per column or none");
+
+		append_row(std::forward_as_tuple(std::forward<Args>(args)...));
+		return back();
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::pop_back()
+	{
+		destroy_rows(_columns, _size - 1, _size);
+		--_size;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::swap(basic_soa_vector& x) noexcept
+	{
+		if constexpr (block_traits::propagate_on_container_swap::value)
+		{
+			using std::swap;
+			swap(_alloc, x._alloc);
+		}
+
+		std::swap(_capacity, x._capacity);
+		std::swap(_size, x._size);
+		std::swap(_blocks, x._blocks);
+		std::swap(_columns, x._columns);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::clear() noexcept
+	{
+		destroy_rows(_columns, 0, _size);
+		_size = 0;
+	}
+
+	// ---------------
+	// ALLOCATOR
+	// ---------------
+	template <class Alloc, class Growth, class... Ts>
+	Alloc basic_soa_vector<Alloc, Growth, Ts...>::get_allocator() const noexcept
+	{
+		return Alloc(_alloc);
+	}
+
+	// ---------------
+	// NON MEMBER FUNCTION
+	// OVERLOADS
+	// ---------------
+	template <class Alloc, class Growth, class... Ts>
+	bool operator==(const basic_soa_vector<Alloc, Growth, Ts...>& lhs, const basic_soa_vector<Alloc, Growth, Ts...>& rhs)
+	{
+		if (lhs.size() != rhs.size())
+		{
+			return false;
+		}
+
+		// Column by column, so each comparison streams a single array
+		return detail::soa_columns_equal(lhs, rhs, std::index_sequence_for<Ts...>());
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	bool operator!=(const basic_soa_vector<Alloc, Growth, Ts...>& lhs, const basic_soa_vector<Alloc, Growth, Ts...>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void swap(basic_soa_vector<Alloc, Growth, Ts...>& lhs, basic_soa_vector<Alloc, Growth, Ts...>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class Alloc, class Growth, class... Ts>
+	template <class F, size_t... Is>
+	inline void basic_soa_vector<Alloc, Growth, Ts...>::for_each_column(F&& f, std::index_sequence<Is...>)
+	{
+		(f(std::integral_constant<size_type, Is>()), ...);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <class F>
+	inline void basic_soa_vector<Alloc, Growth, Ts...>::for_each_column(F&& f)
+	{
+		for_each_column(std::forward<F>(f), std::index_sequence_for<Ts...>());
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	constexpr size_type basic_soa_vector<Alloc, Growth, Ts...>::blocks_for(size_type cap) noexcept
+	{
+		return (((cap * sizeof(Ts) + cache_line_size - 1) / cache_line_size) + ...);
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	typename basic_soa_vector<Alloc, Growth, Ts...>::columns basic_soa_vector<Alloc, Growth, Ts...>::layout(block* base, size_type cap) noexcept
+	{
+		columns cols;
+		if (base == nullptr)
+		{
+			return cols;
+		}
+
+		// Each column starts on the block following the end of the previous one
+		size_type offset = 0;
+		for_each_column([&](auto i) {
+			constexpr size_type I = decltype(i)::value;
+			std::get<I>(cols) = reinterpret_cast<column_type<I>*>(base + offset);
+			offset += (cap * sizeof(column_type<I>) + cache_line_size - 1) / cache_line_size;
+		});
+		return cols;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	constexpr size_type basic_soa_vector<Alloc, Growth, Ts...>::grow_capacity(size_type n) noexcept
+	{
+		// The policy sees a whole row as the element
+		return Growth::grow(n, (sizeof(Ts) + ...));
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	typename basic_soa_vector<Alloc, Growth, Ts...>::block* basic_soa_vector<Alloc, Growth, Ts...>::allocate(size_type cap)
+	{
+		return cap == 0 ? nullptr : block_traits::allocate(_alloc, blocks_for(cap));
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::deallocate(block* base, size_type cap) noexcept
+	{
+		if (base)
+		{
+			block_traits::deallocate(_alloc, base, blocks_for(cap));
+		}
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::reallocate(size_type cap)
+	{
+		block* blocks = allocate(cap);
+		const columns cols = layout(blocks, cap);
+
+		try
+		{
+			relocate_rows(_columns, _size, cols);
+		}
+		catch (...)
+		{
+			// Old columns are untouched, release the new ones and leave the soa_vector as it was
+			deallocate(blocks, cap);
+			throw;
+		}
+
+		deallocate(_blocks, _capacity);
+		_blocks = blocks;
+		_columns = cols;
+		_capacity = cap;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::grow_for(size_type n)
+	{
+		if (n > _capacity)
+		{
+			reallocate(std::max(grow_capacity(_capacity), n));
+		}
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::relocate_rows(const columns& from, size_type n, const columns& to)
+	{
+		if constexpr (((is_trivially_relocatable_v<Ts> || std::is_nothrow_move_constructible_v<Ts>) && ...))
+		{
+			// No column can throw so each is relocated on its own, with a memcpy where possible
+			for_each_column([&](auto i) {
+				constexpr size_type I = decltype(i)::value;
+				column_allocator<I> alloc(_alloc);
+				relocate_n(alloc, std::get<I>(from), n, std::get<I>(to));
+			});
+		}
+		else
+		{
+			construct_rows<false>(from, n, to);
+			destroy_rows(from, 0, n);
+		}
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <bool Move, class From>
+	void basic_soa_vector<Alloc, Growth, Ts...>::construct_rows(const From& from, size_type n, const columns& to)
+	{
+		size_type built = 0;
+		try
+		{
+			for_each_column([&](auto i) {
+				constexpr size_type I = decltype(i)::value;
+				construct_column<I, Move>(std::get<I>(from), n, std::get<I>(to));
+				++built;
+			});
+		}
+		catch (...)
+		{
+			for_each_column([&](auto i) {
+				constexpr size_type I = decltype(i)::value;
+				if (I < built)
+				{
+					column_allocator<I> alloc(_alloc);
+					for (size_type j = 0; j < n; ++j)
+					{
+						std::allocator_traits<column_allocator<I> >::destroy(alloc, std::get<I>(to) + j);
+					}
+				}
+			});
+			throw;
+		}
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <size_type I, bool Move, class Src>
+	void basic_soa_vector<Alloc, Growth, Ts...>::construct_column(Src* src, size_type n, column_type<I>* dest)
+	{
+		using T = column_type<I>;
+		using traits = std::allocator_traits<column_allocator<I> >;
+
+		if constexpr (std::is_trivially_copyable_v<T>)
+		{
+			if (n > 0)
+			{
+				std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), n * sizeof(T));
+			}
+		}
+		else
+		{
+			column_allocator<I> alloc(_alloc);
+			size_type constructed = 0;
+			try
+			{
+				for (; constructed < n; ++constructed)
+				{
+					// Move only columns are moved even when copying
+					if constexpr (Move || !std::is_copy_constructible_v<T>)
+					{
+						traits::construct(alloc, dest + constructed, std::move(src[constructed]));
+					}
+					else
+					{
+						traits::construct(alloc, dest + constructed, src[constructed]);
+					}
+				}
+			}
+			catch (...)
+			{
+				for (size_type j = 0; j < constructed; ++j)
+				{
+					traits::destroy(alloc, dest + j);
+				}
+				throw;
+			}
+		}
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <size_type I, class Tuple>
+	void basic_soa_vector<Alloc, Growth, Ts...>::construct_row(const columns& cols, size_type idx, Tuple&& args)
+	{
+		if constexpr (I < sizeof...(Ts))
+		{
+			using traits = std::allocator_traits<column_allocator<I> >;
+			column_allocator<I> alloc(_alloc);
+
+			if constexpr (I < std::tuple_size_v<std::remove_reference_t<Tuple> >)
+			{
+				traits::construct(alloc, std::get<I>(cols) + idx, std::get<I>(std::forward<Tuple>(args)));
+			}
+			else
+			{
+				traits::construct(alloc, std::get<I>(cols) + idx);
+			}
+
+			try
+			{
+				construct_row<I + 1>(cols, idx, std::forward<Tuple>(args));
+			}
+			catch (...)
+			{
+				traits::destroy(alloc, std::get<I>(cols) + idx);
+				throw;
+			}
+		}
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::destroy_rows(const columns& cols, size_type first, size_type last) noexcept
+	{
+		for_each_column([&](auto i) {
+			constexpr size_type I = decltype(i)::value;
+			if constexpr (!std::is_trivially_destructible_v<column_type<I> >)
+			{
+				column_allocator<I> alloc(_alloc);
+				for (size_type j = first; j < last; ++j)
+				{
+					std::allocator_traits<column_allocator<I> >::destroy(alloc, std::get<I>(cols) + j);
+				}
+			}
+		});
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <class Tuple>
+	void basic_soa_vector<Alloc, Growth, Ts...>::append_row(Tuple&& args)
+	{
+		// Check for reallocation
+		if (_size == _capacity)
+		{
+			reallocate_append(std::forward<Tuple>(args));
+			return;
+		}
+
+		construct_row(_columns, _size, std::forward<Tuple>(args));
+		++_size;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	template <class Tuple>
+	void basic_soa_vector<Alloc, Growth, Ts...>::reallocate_append(Tuple&& args)
+	{
+		const auto cap = grow_capacity(_capacity);
+		block* blocks = allocate(cap);
+		const columns cols = layout(blocks, cap);
+
+		// Construct the new row first as args may live in the current columns
+		try
+		{
+			construct_row(cols, _size, std::forward<Tuple>(args));
+		}
+		catch (...)
+		{
+			deallocate(blocks, cap);
+			throw;
+		}
+
+		try
+		{
+			relocate_rows(_columns, _size, cols);
+		}
+		catch (...)
+		{
+			destroy_rows(cols, _size, _size + 1);
+			deallocate(blocks, cap);
+			throw;
+		}
+
+		deallocate(_blocks, _capacity);
+		_blocks = blocks;
+		_columns = cols;
+		_capacity = cap;
+		++_size;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::release() noexcept
+	{
+		destroy_rows(_columns, 0, _size);
+		deallocate(_blocks, _capacity);
+		_blocks = nullptr;
+		_columns = columns();
+		_capacity = 0;
+		_size = 0;
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	void basic_soa_vector<Alloc, Growth, Ts...>::steal(basic_soa_vector& rhs) noexcept
+	{
+		_capacity = rhs._capacity;
+		_size = rhs._size;
+		_blocks = rhs._blocks;
+		_columns = rhs._columns;
+
+		rhs._capacity = 0;
+		rhs._size = 0;
+		rhs._blocks = nullptr;
+		rhs._columns = columns();
+	}
+
+	template <class Alloc, class Growth, class... Ts>
+	inline typename basic_soa_vector<Alloc, Growth, Ts...>::const_columns basic_soa_vector<Alloc, Growth, Ts...>::const_cols() const noexcept
+	{
+		return const_columns(_columns);
+	}
+
+	namespace pmr
+	{
+		// soa_vector using a polymorphic allocator, e.g. backed by a non_stl::monotonic_buffer
+		template <class... Ts>
+		using soa_vector = non_stl::basic_soa_vector<std::pmr::polymorphic_allocator<std::byte>, double_growth, Ts...>;
+	}
+}
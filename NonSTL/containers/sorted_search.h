@@ -0,0 +1,189 @@
+// sorted_search.h
+// Search policies for the sorted arrays behind flat_map and flat_set
+
+/*
+ * A search policy provides a nested index<Key> which the flat containers keep next to their sorted keys.
+ * The index is rebuilt with build(keys, n) after every change to the keys and answers
+ * lower_bound(keys, n, key, comp) with the position of the first key not ordered before key.
+ *
+ * branchless_search keeps no state and halves the sorted array with conditional moves instead of
+ * branches, so lookups don't pay for mispredicted comparisons.
+ * eytzinger_search additionally keeps a copy of the keys in breadth first (Eytzinger) order: the
+ * first levels of the implicit tree share a few cache lines which stay hot across lookups and the
+ * descendants of a node are contiguous so they can be prefetched several levels ahead.
+ * It suits read mostly tables, every change to the keys rebuilds the copy in O(n).
+ */
+
+#pragma once
+
+// Includes
+#include "vector.h"			// non_stl::vector
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Tag telling a flat container its input is already sorted and free of equivalent keys
+	struct sorted_unique_t { explicit sorted_unique_t() = default; };
+	inline constexpr sorted_unique_t sorted_unique{};
+
+	// Returns the position of the first key in [keys, keys + n) not ordered before key
+	template <class Key, class K, class Compare>
+	size_type branchless_lower_bound(const Key* keys, size_type n, const K& key, const Compare& comp);
+
+	// Returns the position of the first key in [keys, keys + n) ordered after key
+	template <class Key, class K, class Compare>
+	size_type branchless_upper_bound(const Key* keys, size_type n, const K& key, const Compare& comp);
+
+	// Binary search over the sorted keys themselves
+	struct branchless_search
+	{
+		template <class Key>
+		class index
+		{
+		public:
+			void build(const Key* /*keys*/, size_type /*n*/) noexcept {}
+
+			template <class K, class Compare>
+			size_type lower_bound(const Key* keys, size_type n, const K& key, const Compare& comp) const
+			{
+				return branchless_lower_bound(keys, n, key, comp);
+			}
+		};
+	};
+
+	// Search over an Eytzinger ordered copy of the keys
+	struct eytzinger_search
+	{
+		template <class Key>
+		class index
+		{
+		public:
+			// Rebuilds the copy from the n sorted keys
+			void build(const Key* keys, size_type n);
+
+			template <class K, class Compare>
+			size_type lower_bound(const Key* keys, size_type n, const K& key, const Compare& comp) const;
+
+		private:
+			// Assigns sorted positions from next onwards to the subtree rooted at node, in order
+			// Returns the position following the last one assigned
+			size_type assign_ranks(size_type node, size_type next, size_type n);
+
+			// Member variables
+
+			// The keys in breadth first order, the root is at 1 and the children of k at 2k and 2k + 1
+			// Slot 0 only pads the array
+			vector<Key> _tree;
+
+			// Position in the sorted keys of every tree node
+			vector<size_type> _rank;
+		};
+	};
+
+	// SORTED SEARCH IMPL
+
+	template <class Key, class K, class Compare>
+	size_type branchless_lower_bound(const Key* keys, size_type n, const K& key, const Compare& comp)
+	{
+		if (n == 0)
+		{
+			return 0;
+		}
+
+		// The answer stays within [base, base + n], the comparison only picks the next offset
+		const Key* base = keys;
+		while (n > 1)
+		{
+			const size_type half = n / 2;
+			base += comp(base[half], key) ? half : 0;
+			n -= half;
+		}
+		return static_cast<size_type>(base - keys) + (comp(*base, key) ? 1 : 0);
+	}
+
+	template <class Key, class K, class Compare>
+	size_type branchless_upper_bound(const Key* keys, size_type n, const K& key, const Compare& comp)
+	{
+		if (n == 0)
+		{
+			return 0;
+		}
+
+		const Key* base = keys;
+		while (n > 1)
+		{
+			const size_type half = n / 2;
+			base += comp(key, base[half]) ? 0 : half;
+			n -= half;
+		}
+		return static_cast<size_type>(base - keys) + (comp(key, *base) ? 0 : 1);
+	}
+
+	template <class Key>
+	void eytzinger_search::index<Key>::build(const Key* keys, size_type n)
+	{
+		_tree.clear();
+		_rank.clear();
+		if (n == 0)
+		{
+			return;
+		}
+
+		_rank.resize(n + 1);
+		assign_ranks(1, 0, n);
+
+		// Filled in order so Key needs no default constructor
+		_tree.reserve(n + 1);
+		_tree.push_back(keys[0]);
+		for (size_type k = 1; k <= n; ++k)
+		{
+			_tree.push_back(keys[_rank[k]]);
+		}
+	}
+
+	template <class Key>
+	template <class K, class Compare>
+	size_type eytzinger_search::index<Key>::lower_bound(const Key* /*keys*/, size_type n, const K& key, const Compare& comp) const
+	{
+		const Key* tree = _tree.data();
+
+		// Descend to a leaf, going right whenever the node is ordered before key
+		size_type k = 1;
+		while (k <= n)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			// The 16 descendants four levels down are contiguous
+			if (16 * k <= n)
+			{
+				__builtin_prefetch(tree + 16 * k);
+			}
+#endif
+			k = 2 * k + (comp(tree[k], key) ? 1 : 0);
+		}
+
+		// The answer is the last node where the descent went left: drop the trailing right turns and that left turn
+#if defined(__GNUC__) || defined(__clang__)
+		k >>= __builtin_ctzll(~static_cast<unsigned long long>(k)) + 1;
+#else
+		while (k & 1)
+		{
+			k >>= 1;
+		}
+		k >>= 1;
+#endif
+		return k == 0 ? n : _rank[k];
+	}
+
+	template <class Key>
+	size_type eytzinger_search::index<Key>::assign_ranks(size_type node, size_type next, size_type n)
+	{
+		if (node <= n)
+		{
+			next = assign_ranks(2 * node, next, n);
+			_rank[node] = next++;
+			next = assign_ranks(2 * node + 1, next, n);
+		}
+		return next;
+	}
+}
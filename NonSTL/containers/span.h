@@ -0,0 +1,121 @@
+// span.h
+// A non-stl header only implementation of a non owning view over a contiguous sequence of objects,
+// modeled on std::span with a dynamic extent.
+
+/*
+ * A span is a pointer and a length. It never owns the elements it refers to and is cheap to pass by value.
+ * Containers use it to hand out regions of their storage, for example the uninitialized tail of a vector
+ * or the two contiguous halves of a circular buffer.
+ */
+
+#pragma once
+
+// Includes
+#include <cstddef>			// std::byte
+#include <type_traits>		// std::enable_if_t, std::is_convertible, std::remove_cv_t
+
+#include "contiguous_iterator.h"	// non_stl::contiguous_iterator
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter T is the element type, which may be const qualified for a read only view
+	template <class T>
+	class span
+	{
+	public:
+		using element_type = T;
+		using value_type = std::remove_cv_t<T>;
+		using pointer = T*;
+		using reference = T&;
+		using iterator = contiguous_iterator<T>;
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor, an empty span
+		constexpr span() noexcept : _data(nullptr), _size(0) {}
+
+		// Views the n elements starting at ptr
+		constexpr span(pointer ptr, size_type n) noexcept : _data(ptr), _size(n) {}
+
+		// Views a whole array
+		template <size_type N>
+		constexpr span(element_type (&arr)[N]) noexcept : _data(arr), _size(N) {}
+
+		// A span of U converts to a span of T when U* converts to T*, e.g. span<int> to span<const int>
+		template <class U, class = std::enable_if_t<std::is_convertible<U(*)[], T(*)[]>::value> >
+		constexpr span(const span<U>& other) noexcept : _data(other.data()), _size(other.size()) {}
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns a reference to the element at position n with no range check
+		constexpr reference operator[](size_type n) const noexcept { return _data[n]; }
+
+		// Returns a reference to the first element
+		constexpr reference front() const noexcept { return _data[0]; }
+
+		// Returns a reference to the last element
+		constexpr reference back() const noexcept { return _data[_size - 1]; }
+
+		// Returns a pointer to the first element
+		constexpr pointer data() const noexcept { return _data; }
+
+		// ---------------
+		// ITERATORS
+		// ---------------
+		constexpr iterator begin() const noexcept { return iterator(_data); }
+		constexpr iterator end() const noexcept { return iterator(_data + _size); }
+
+		// ---------------
+		// OBSERVERS
+		// ---------------
+
+		// Returns the number of elements in the span
+		constexpr size_type size() const noexcept { return _size; }
+
+		// Returns the size of the viewed elements in bytes
+		constexpr size_type size_bytes() const noexcept { return _size * sizeof(T); }
+
+		// Returns whether the span is empty
+		constexpr bool empty() const noexcept { return _size == 0; }
+
+		// ---------------
+		// SUBVIEWS
+		// ---------------
+
+		// Returns a span over the first n elements
+		constexpr span first(size_type n) const noexcept { return span(_data, n); }
+
+		// Returns a span over the last n elements
+		constexpr span last(size_type n) const noexcept { return span(_data + _size - n, n); }
+
+		// Returns a span over n elements starting at offset, or every element after offset by default
+		constexpr span subspan(size_type offset, size_type n = (size_type)-1) const noexcept
+		{
+			return span(_data + offset, n == (size_type)-1 ? _size - offset : n);
+		}
+
+	private:
+		pointer _data;
+		size_type _size;
+	};
+
+	// Returns a read only view of the bytes making up the elements of s
+	template <class T>
+	span<const std::byte> as_bytes(span<T> s) noexcept
+	{
+		return span<const std::byte>(reinterpret_cast<const std::byte*>(s.data()), s.size_bytes());
+	}
+
+	// Returns a writable view of the bytes making up the elements of s
+	template <class T, class = std::enable_if_t<!std::is_const<T>::value> >
+	span<std::byte> as_writable_bytes(span<T> s) noexcept
+	{
+		return span<std::byte>(reinterpret_cast<std::byte*>(s.data()), s.size_bytes());
+	}
+}
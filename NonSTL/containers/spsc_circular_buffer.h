@@ -0,0 +1,282 @@
+// spsc_circular_buffer.h
+// A non-stl header only implementation of a lock-free single producer single consumer circular buffer.
+// Note, the standard is used for some components such as std::atomic
+
+/*
+ * An spsc_circular_buffer is a fixed size ring shared by exactly one producer thread and one consumer thread.
+ * Unlike circular_buffer it never overwrites data: try_push fails when the buffer is full and try_pop fails
+ * when it is empty, so neither side ever blocks or takes a lock.
+ * The producer only writes the tail index and the consumer only writes the head index, there is no shared
+ * size counter. Each index lives on its own cache line next to a cached copy of the other side's index,
+ * so the sides only touch each other's cache line when the cached copy says the buffer looks full or empty.
+ * Elements are constructed on push and destroyed on pop.
+ * Calling producer functions from more than one thread, or consumer functions from more than one thread,
+ * is undefined behavior.
+ */
+
+#pragma once
+
+// Includes
+#include <atomic>			// std::atomic, std::memory_order
+#include <new>				// placement new, std::launder
+#include <type_traits>		// std::is_nothrow_move_constructible
+#include <utility>			// std::forward, std::move
+
+#include "../memory/cache_line.h"	// non_stl::cache_line_size
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter T is the generic object being stored within the container
+	// size_type N is the amount of elements the buffer can hold which cannot be changed
+	template <class T, size_type N>
+	class spsc_circular_buffer
+	{
+		static_assert(N > 0, "spsc_circular_buffer requires a capacity of at least one element");
+
+		// One slot is always left empty so a full buffer can be told apart from an empty one
+		// without a shared size counter
+		static constexpr size_type SLOTS = N + 1;
+
+	public:
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Default constructor
+		spsc_circular_buffer() noexcept;
+
+		// The buffer is shared between threads by reference and is neither copyable nor movable
+		spsc_circular_buffer(const spsc_circular_buffer&) = delete;
+		spsc_circular_buffer& operator=(const spsc_circular_buffer&) = delete;
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+
+		// Destroys every element still in the buffer
+		// No thread may be using the buffer
+		~spsc_circular_buffer();
+
+		// ---------------
+		// PRODUCER
+		// ---------------
+
+		// Adds a new element at the end of the buffer
+		// Returns false, leaving val untouched, if the buffer is full
+		bool try_push(const T& val) noexcept(std::is_nothrow_copy_constructible<T>::value);
+		bool try_push(T&& val) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+		// Constructs a new element at the end of the buffer from args
+		// Returns false without constructing anything if the buffer is full
+		template <class... Args>
+		bool try_emplace(Args&& ... args) noexcept(std::is_nothrow_constructible<T, Args...>::value);
+
+		// ---------------
+		// CONSUMER
+		// ---------------
+
+		// Moves the first element into out and removes it from the buffer
+		// Returns false, leaving out untouched, if the buffer is empty
+		bool try_pop(T& out) noexcept(std::is_nothrow_move_assignable<T>::value);
+
+		// Returns a pointer to the first element, or nullptr if the buffer is empty
+		// The element stays valid until the consumer removes it
+		T* front() noexcept;
+
+		// Removes the first element in the buffer
+		// Assumed that the buffer is not empty, e.g. front() returned an element
+		void pop_front() noexcept;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns the number of elements in the buffer
+		// Exact when called by the producer or consumer while the other side is idle,
+		// otherwise a snapshot which may be stale by the time it is returned
+		size_type size() const noexcept;
+
+		// Returns whether the buffer is empty, with the same caveat as size()
+		bool empty() const noexcept;
+
+		// Returns the maximum number of elements the buffer can hold
+		static constexpr size_type capacity() noexcept;
+
+	private:
+		// Returns the slot following index
+		static constexpr size_type next(size_type index) noexcept;
+
+		// Returns a pointer to the element storage of slot index
+		T* slot(size_type index) noexcept;
+
+		// Member variables
+
+		// Producer cache line
+		// Index of the slot the next element is pushed into, only written by the producer
+		alignas(cache_line_size) std::atomic<size_type> d_tail;
+
+		// The producer's last observed value of d_head
+		size_type d_head_cache;
+
+		// Consumer cache line
+		// Index of the oldest element, only written by the consumer
+		alignas(cache_line_size) std::atomic<size_type> d_head;
+
+		// The consumer's last observed value of d_tail
+		size_type d_tail_cache;
+
+		// Element storage, constructed lazily
+		alignas(cache_line_size) alignas(T) unsigned char d_storage[SLOTS * sizeof(T)];
+	};
+
+	// IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, size_type N>
+	spsc_circular_buffer<T, N>::spsc_circular_buffer() noexcept
+		: d_tail(0)
+		, d_head_cache(0)
+		, d_head(0)
+		, d_tail_cache(0)
+	{
+
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	template <class T, size_type N>
+	spsc_circular_buffer<T, N>::~spsc_circular_buffer()
+	{
+		const size_type tail = d_tail.load(std::memory_order_relaxed);
+		for (size_type i = d_head.load(std::memory_order_relaxed); i != tail; i = next(i)) {
+			slot(i)->~T();
+		}
+	}
+
+	// ---------------
+	// PRODUCER
+	// ---------------
+	template <class T, size_type N>
+	bool spsc_circular_buffer<T, N>::try_push(const T& val) noexcept(std::is_nothrow_copy_constructible<T>::value)
+	{
+		return try_emplace(val);
+	}
+
+	template <class T, size_type N>
+	bool spsc_circular_buffer<T, N>::try_push(T&& val) noexcept(std::is_nothrow_move_constructible<T>::value)
+	{
+		return try_emplace(std::move(val));
+	}
+
+	template <class T, size_type N>
+	template <class... Args>
+	bool spsc_circular_buffer<T, N>::try_emplace(Args&& ... args) noexcept(std::is_nothrow_constructible<T, Args...>::value)
+	{
+		// Only the producer writes d_tail so a relaxed load sees its own latest value
+		const size_type tail = d_tail.load(std::memory_order_relaxed);
+		const size_type next_tail = next(tail);
+
+		if (next_tail == d_head_cache) {
+			// Looks full, refresh the cached head. Acquire pairs with the release in pop_front
+			// so the consumer is done with the slot before it is reused
+			d_head_cache = d_head.load(std::memory_order_acquire);
+			if (next_tail == d_head_cache) {
+				return false;
+			}
+		}
+
+		::new (static_cast<void*>(d_storage + tail * sizeof(T))) T(std::forward<Args>(args)...);
+
+		// Publish the element, pairs with the acquire in front
+		d_tail.store(next_tail, std::memory_order_release);
+		return true;
+	}
+
+	// ---------------
+	// CONSUMER
+	// ---------------
+	template <class T, size_type N>
+	bool spsc_circular_buffer<T, N>::try_pop(T& out) noexcept(std::is_nothrow_move_assignable<T>::value)
+	{
+		T* elem = front();
+		if (!elem) {
+			return false;
+		}
+
+		out = std::move(*elem);
+		pop_front();
+		return true;
+	}
+
+	template <class T, size_type N>
+	T* spsc_circular_buffer<T, N>::front() noexcept
+	{
+		// Only the consumer writes d_head so a relaxed load sees its own latest value
+		const size_type head = d_head.load(std::memory_order_relaxed);
+
+		if (head == d_tail_cache) {
+			// Looks empty, refresh the cached tail. Acquire pairs with the release in try_emplace
+			// so the element is fully constructed before it is read
+			d_tail_cache = d_tail.load(std::memory_order_acquire);
+			if (head == d_tail_cache) {
+				return nullptr;
+			}
+		}
+
+		return slot(head);
+	}
+
+	template <class T, size_type N>
+	void spsc_circular_buffer<T, N>::pop_front() noexcept
+	{
+		const size_type head = d_head.load(std::memory_order_relaxed);
+		slot(head)->~T();
+
+		// Hand the slot back to the producer, pairs with the acquire in try_emplace
+		d_head.store(next(head), std::memory_order_release);
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, size_type N>
+	size_type spsc_circular_buffer<T, N>::size() const noexcept
+	{
+		const size_type head = d_head.load(std::memory_order_acquire);
+		const size_type tail = d_tail.load(std::memory_order_acquire);
+		return tail >= head ? tail - head : SLOTS - head + tail;
+	}
+
+	template <class T, size_type N>
+	bool spsc_circular_buffer<T, N>::empty() const noexcept
+	{
+		return d_head.load(std::memory_order_acquire) == d_tail.load(std::memory_order_acquire);
+	}
+
+	template <class T, size_type N>
+	constexpr size_type spsc_circular_buffer<T, N>::capacity() noexcept
+	{
+		return N;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	template <class T, size_type N>
+	constexpr size_type spsc_circular_buffer<T, N>::next(size_type index) noexcept
+	{
+		// A compare is cheaper than a modulo when N is not a power of two
+		return index + 1 == SLOTS ? 0 : index + 1;
+	}
+
+	template <class T, size_type N>
+	T* spsc_circular_buffer<T, N>::slot(size_type index) noexcept
+	{
+		return std::launder(reinterpret_cast<T*>(d_storage + index * sizeof(T)));
+	}
+}
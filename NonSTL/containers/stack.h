@@ -0,0 +1,222 @@
+// stack.h
+// A non-stl header only implementation of std::stack which attempts to adhere to the
+// standard interface as closely as possible.
+
+/*
+ * A stack is a container adapter giving last in first out access to the back of its underlying
+ * container, a non_stl::vector unless another one providing back, push_back, emplace_back
+ * and pop_back is given.
+ */
+
+#pragma once
+
+// Includes
+#include <algorithm>		// std::equal
+#include <utility>			// std::forward, std::move, std::swap
+
+#include "vector.h"			// non_stl::vector
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter T is the generic object being stored within the container
+	// Template parameter Container is the underlying sequence container
+	template <class T, class Container = vector<T> >
+	class stack
+	{
+		// ---------------
+		// BEGIN INTERFACE
+		// ---------------
+	public:
+		using container_type = Container;
+		using value_type = T;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Constructs an empty stack
+		stack() = default;
+
+		// Constructs the stack on a copy of, or by moving, cont
+		// The back of cont is the top of the stack
+		explicit stack(const Container& cont);
+		explicit stack(Container&& cont);
+
+		// Range constructor
+		// The last element of [first, last) is the top of the stack
+		template <class InputIterator>
+		stack(InputIterator first, InputIterator last);
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+
+		// Returns a reference to the top element, the stack must not be empty
+		reference top();
+		const_reference top() const;
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+
+		// Returns whether the stack is empty
+		// (i.e. whether its size is 0)
+		bool empty() const;
+
+		// Returns the number of elements
+		size_type size() const;
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+
+		// Pushes val on top of the stack
+		void push(const value_type& val);
+		void push(value_type&& val);
+
+		// Constructs an element from args on top of the stack
+		// Returns a reference to the new top
+		template <class... Args>
+		decltype(auto) emplace(Args&& ... args);
+
+		// Pushes every element of rg in order, the last one ending on top
+		template <class Range>
+		void push_range(Range&& rg);
+
+		// Removes the top element, the stack must not be empty
+		void pop();
+
+		// Exchanges the content of the stack with the content of x
+		void swap(stack& x) noexcept(noexcept(std::swap(std::declval<Container&>(), std::declval<Container&>())));
+
+		// ---------------
+		// RELATIONAL OPERATORS
+		// ---------------
+		// Compares the elements from the bottom to the top
+		friend bool operator==(const stack& lhs, const stack& rhs)
+		{
+			return lhs.c.size() == rhs.c.size() && std::equal(lhs.c.begin(), lhs.c.end(), rhs.c.begin());
+		}
+		friend bool operator!=(const stack& lhs, const stack& rhs) { return !(lhs == rhs); }
+
+		// ---------------
+		// END INTERFACE
+		// ---------------
+	protected:
+		// The underlying container, accessible to derived adapters as for std::stack
+		Container c;
+	};
+
+	template <class T, class Container>
+	void swap(stack<T, Container>& lhs, stack<T, Container>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+	{
+		lhs.swap(rhs);
+	}
+
+	// STACK IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	template <class T, class Container>
+	stack<T, Container>::stack(const Container& cont) :
+		c(cont)
+	{
+
+	}
+
+	template <class T, class Container>
+	stack<T, Container>::stack(Container&& cont) :
+		c(std::move(cont))
+	{
+
+	}
+
+	template <class T, class Container>
+	template <class InputIterator>
+	stack<T, Container>::stack(InputIterator first, InputIterator last) :
+		c(first, last)
+	{
+
+	}
+
+	// ---------------
+	// ELEMENT ACCESS
+	// ---------------
+	template <class T, class Container>
+	inline typename stack<T, Container>::reference stack<T, Container>::top()
+	{
+		return c.back();
+	}
+
+	template <class T, class Container>
+	inline typename stack<T, Container>::const_reference stack<T, Container>::top() const
+	{
+		return c.back();
+	}
+
+	// ---------------
+	// CAPACITY
+	// ---------------
+	template <class T, class Container>
+	inline bool stack<T, Container>::empty() const
+	{
+		return c.empty();
+	}
+
+	template <class T, class Container>
+	inline size_type stack<T, Container>::size() const
+	{
+		return c.size();
+	}
+
+	// ---------------
+	// MODIFIERS
+	// ---------------
+	template <class T, class Container>
+	inline void stack<T, Container>::push(const value_type& val)
+	{
+		c.push_back(val);
+	}
+
+	template <class T, class Container>
+	inline void stack<T, Container>::push(value_type&& val)
+	{
+		c.push_back(std::move(val));
+	}
+
+	template <class T, class Container>
+	template <class... Args>
+	inline decltype(auto) stack<T, Container>::emplace(Args&& ... args)
+	{
+		c.emplace_back(std::forward<Args>(args)...);
+		return c.back();
+	}
+
+	template <class T, class Container>
+	template <class Range>
+	void stack<T, Container>::push_range(Range&& rg)
+	{
+		for (auto&& val : rg)
+		{
+			c.emplace_back(std::forward<decltype(val)>(val));
+		}
+	}
+
+	template <class T, class Container>
+	inline void stack<T, Container>::pop()
+	{
+		c.pop_back();
+	}
+
+	template <class T, class Container>
+	void stack<T, Container>::swap(stack& x) noexcept(noexcept(std::swap(std::declval<Container&>(), std::declval<Container&>())))
+	{
+		using std::swap;
+		swap(c, x.c);
+	}
+}
@@ -5,16 +5,42 @@
 
 /*
  * Vectors are sequence containers representing arrays that can change in size
+ * With C++20 every member is constexpr, so a vector may be built and used inside a constant
+ * expression as long as it is destroyed before the evaluation ends. Compile time tables which
+ * have to outlive the evaluation should be copied into a non_stl::fixed_vector, see fixed_vector.h
  */
 
 #pragma once
 
 // Includes
-#include <algorithm>		// std::copy_n, std::swap
+#include <algorithm>		// std::max, std::rotate, std::swap
+#include <cstring>			// std::memcpy, std::memset
 #include <initializer_list>	// std::initializer_list
-#include <memory>			// std::allocator
+#include <iterator>			// std::reverse_iterator, std::distance, std::make_move_iterator
+#include <limits>			// std::numeric_limits
+#include <memory>			// std::allocator, std::allocator_traits
+#include <memory_resource>	// std::pmr::polymorphic_allocator
+#include <new>				// placement new
+#include <stdexcept>		// std::out_of_range
+#include <type_traits>		// std::is_trivially_copyable_v
 #include <utility>			// std::forward
 
+#include "contiguous_iterator.h"	// non_stl::contiguous_iterator
+#include "debug.h"			// NON_STL_DEBUG_CHECK, non_stl::checked_iterator
+#include "growth_policy.h"	// non_stl::double_growth
+#include "span.h"			// non_stl::span
+#include "vector_stats.h"	// non_stl::vector_stats, NON_STL_VECTOR_SITE
+#include "../algorithms/simd.h"	// non_stl::simd::fill
+#include "../memory/constant_evaluation.h"	// NON_STL_CONSTEXPR20, non_stl::is_constant_evaluated
+#include "../memory/relocate.h"	// non_stl::relocate_n, non_stl::relocate_overlapping_n
+
+// The statistics are kept in a global registry, which can't be touched during constant evaluation
+#if defined(NON_STL_VECTOR_STATS)
+#define NON_STL_VECTOR_CONSTEXPR
+#else
+#define NON_STL_VECTOR_CONSTEXPR NON_STL_CONSTEXPR20
+#endif
+
 using size_type = size_t;
 
 namespace non_stl
@@ -24,11 +50,12 @@ namespace non_stl
 	// objects of type T. If a custom allocator is not provided then the default 
 	// std::allocator<T> will be used which will call the operators 
 	// new, new[], delete, delete[]
-	template <class T, class Alloc = std::allocator<T> >
+	// Template parameter Growth is the growth policy which decides the new capacity
+	// whenever the underlying array needs to be expanded, see growth_policy.h
+	template <class T, class Alloc = std::allocator<T>, class Growth = double_growth>
 	class vector
 	{
-		// Coefficient for expanding the capacity of the underlying array
-		const double beta = 2.0;
+		using alloc_traits = std::allocator_traits<Alloc>;
 
 		// ---------------
 		// BEGIN INTERFACE
@@ -39,38 +66,57 @@ namespace non_stl
 		// ---------------
 
 		// Default constructor
-		vector();
+		// Every constructor optionally takes the allocator to use, which for
+		// stateful allocators such as arena_allocator decides where the memory comes from
+		// With NON_STL_VECTOR_STATS every constructor also takes the site it is called from
+#if defined(NON_STL_VECTOR_STATS)
+		vector(vector_site site = vector_site::current());
+#else
+		NON_STL_VECTOR_CONSTEXPR vector();
+#endif
+		NON_STL_VECTOR_CONSTEXPR explicit vector(const Alloc& alloc NON_STL_VECTOR_SITE);
 
 		// Fill constructor
 		// Constructs a vector with size elements
 		// Each element is a copy of val if provided
-		explicit vector(size_type size);
-		vector(size_type size, const T& val);
+		NON_STL_VECTOR_CONSTEXPR explicit vector(size_type size, const Alloc& alloc = Alloc() NON_STL_VECTOR_SITE);
+		NON_STL_VECTOR_CONSTEXPR vector(size_type size, const T& val, const Alloc& alloc = Alloc() NON_STL_VECTOR_SITE);
 
 		// Range constructor
 		template <class InputIterator>
-		vector(InputIterator first, InputIterator last);
+		NON_STL_VECTOR_CONSTEXPR vector(InputIterator first, InputIterator last, const Alloc& alloc = Alloc() NON_STL_VECTOR_SITE);
 
 		// Copy constructor
-		vector(const vector& rhs);
+		// The allocator is obtained from select_on_container_copy_construction unless provided
+		NON_STL_VECTOR_CONSTEXPR vector(const vector& rhs NON_STL_VECTOR_SITE);
+		NON_STL_VECTOR_CONSTEXPR vector(const vector& rhs, const Alloc& alloc NON_STL_VECTOR_SITE);
 
 		// Move constructor
-		vector(vector&& rhs) noexcept;
+		// The allocator is moved along with the array
+		// If an unequal allocator is provided the elements are moved one by one instead
+		NON_STL_VECTOR_CONSTEXPR vector(vector&& rhs NON_STL_VECTOR_SITE) noexcept;
+		NON_STL_VECTOR_CONSTEXPR vector(vector&& rhs, const Alloc& alloc NON_STL_VECTOR_SITE);
 
 		// Initializer list constructor
-		vector(std::initializer_list<T> init);
+		NON_STL_VECTOR_CONSTEXPR vector(std::initializer_list<T> init, const Alloc& alloc = Alloc() NON_STL_VECTOR_SITE);
 
 		// ---------------
 		// OPERATOR=
 		// ---------------
-		vector& operator=(const vector& rhs);
-		vector& operator=(vector&& rhs);
-		vector& operator=(std::initializer_list<T> init);
+
+		// The allocator follows the propagate_on_container_copy_assignment and
+		// propagate_on_container_move_assignment traits. When it doesn't propagate
+		// and the allocators are unequal a move assignment moves the elements one by one
+		NON_STL_VECTOR_CONSTEXPR vector& operator=(const vector& rhs);
+		NON_STL_VECTOR_CONSTEXPR vector& operator=(vector&& rhs) noexcept(
+			std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+			std::allocator_traits<Alloc>::is_always_equal::value);
+		NON_STL_VECTOR_CONSTEXPR vector& operator=(std::initializer_list<T> init);
 
 		// ---------------
 		// DESTRUCTOR
 		// ---------------
-		~vector();
+		NON_STL_VECTOR_CONSTEXPR ~vector();
 
 		// ---------------
 		// ELEMENT ACCESS
@@ -78,101 +124,113 @@ namespace non_stl
 
 		// Returns a reference to the element at position n in the vector
 		// with no range check
-		T& operator[](size_type n);
-		const T& operator[](size_type n) const;
+		NON_STL_VECTOR_CONSTEXPR T& operator[](size_type n);
+		NON_STL_VECTOR_CONSTEXPR const T& operator[](size_type n) const;
 
 		// Returns a reference to the element at position n in the vector
 		// Function throws an out of range exception if the input is not within range
 		// Use the operator[] overload to access without range checking
-		T& at(size_type n);
-		const T& at(size_type n) const;
+		NON_STL_VECTOR_CONSTEXPR T& at(size_type n);
+		NON_STL_VECTOR_CONSTEXPR const T& at(size_type n) const;
 
 		// Returns a reference to the first element in the vector
-		T& front();
-		const T& front() const;
+		NON_STL_VECTOR_CONSTEXPR T& front();
+		NON_STL_VECTOR_CONSTEXPR const T& front() const;
 
 		// Returns a reference to the last element in the vector
-		T& back();
-		const T& back() const;
+		NON_STL_VECTOR_CONSTEXPR T& back();
+		NON_STL_VECTOR_CONSTEXPR const T& back() const;
 
 		// Returns a direct pointer to the memory array used internally by the vector
 		// to store its owned elements
-		T* data();
-		const T* data() const;
+		NON_STL_VECTOR_CONSTEXPR T* data();
+		NON_STL_VECTOR_CONSTEXPR const T* data() const;
 
 		// ---------------
 		// ITERATORS
 		// ---------------
 
-		// forward declare base iterator types
-		class parent_iterator; // TODO better naming for these? parent -> base seems like a weird hierarchy
-		class base_iterator;
-		class base_const_iterator;
-		class forward_iterator;
-		class base_reverse_iterator;
-
-		// forward declare returned iterator types
-		class iterator;
-		class const_iterator;
-		class reverse_iterator;
-		class const_reverse_iterator;
+		// Iterators are thin wrappers around a pointer into _data, see contiguous_iterator.h
+		// With NON_STL_DEBUG they also check that the array hasn't been reallocated or cleared, see debug.h
+#if defined(NON_STL_DEBUG)
+		using iterator = checked_iterator<T>;
+		using const_iterator = checked_iterator<T, true>;
+#else
+		using iterator = contiguous_iterator<T>;
+		using const_iterator = contiguous_iterator<T, true>;
+#endif
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
 		// Returns an iterator to the first element of the container
 		// If the container is empty, the returned iterator will be equal to end()
-		iterator begin() noexcept;
-		const_iterator begin() const noexcept;
-		const_iterator cbegin() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR iterator begin() noexcept;
+		NON_STL_VECTOR_CONSTEXPR const_iterator begin() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR const_iterator cbegin() const noexcept;
 
 		// Returns an iterator to the element following the last element of the container
 		// Attempting to access or modify this element results in undefined behavior
-		iterator end() noexcept;
-		const_iterator end() const noexcept;
-		const_iterator cend() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR iterator end() noexcept;
+		NON_STL_VECTOR_CONSTEXPR const_iterator end() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR const_iterator cend() const noexcept;
 
 		// Returns a reverse iterator to the first element of the reversed container
 		// Equivalent to the last element (not end) of the non-reversed container
 		// If the container is empty, the returned iterator will be equal to rend()
-		reverse_iterator rbegin() noexcept;
-		const_reverse_iterator rbegin() const noexcept;
-		const_reverse_iterator crbegin() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR reverse_iterator rbegin() noexcept;
+		NON_STL_VECTOR_CONSTEXPR const_reverse_iterator rbegin() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR const_reverse_iterator crbegin() const noexcept;
 
 		// Returns a reverse iterator to the element following the last element of the reversed container
 		// It corresponds to the element preceding the first element of the non-reversed container
 		// Attempting to access or modify this element results in undefined behavior
-		reverse_iterator rend() noexcept;
-		const_reverse_iterator rend() const noexcept;
-		const_reverse_iterator crend() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR reverse_iterator rend() noexcept;
+		NON_STL_VECTOR_CONSTEXPR const_reverse_iterator rend() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR const_reverse_iterator crend() const noexcept;
 
 		// ---------------
 		// CAPACITY
 		// ---------------
 
 		// Returns the number of elements in the vector
-		size_type size() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR size_type size() const noexcept;
 
 		// Return the maximum number of elements the vector can hold
 		constexpr size_type max_size() const;
 
 		// Resizes the container so that it contains n elements
 		// May reduce or increase the size of vector
-		// If the container is expanded and val is provided
-		// the new elements of the container will be set to val
-		void resize(size_type n);
-		void resize(size_type n, const T& val);
+		// If the container is expanded the new elements are value initialized,
+		// which zeroes them with a single memset for trivial types,
+		// or set to val if it is provided
+		NON_STL_VECTOR_CONSTEXPR void resize(size_type n);
+		NON_STL_VECTOR_CONSTEXPR void resize(size_type n, const T& val);
+
+		// Resizes the container so that it contains n elements
+		// If the container is expanded the new elements are default initialized
+		// For trivial types such as uint8_t or float this leaves their values
+		// indeterminate, so they must be written before they are read
+		NON_STL_VECTOR_CONSTEXPR void resize_default_init(size_type n);
+
+		// Appends n default initialized elements to the end of the vector
+		// and returns a writable span over them, e.g. to read() straight into
+		// As with resize_default_init trivial elements are left indeterminate
+		// The span is invalidated by the next reallocation
+		NON_STL_VECTOR_CONSTEXPR span<T> append_uninitialized(size_type n);
 
 		// Returns the size of the storage space currently allocated for the vector,
 		// expressed in terms of elements
-		size_type capacity() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR size_type capacity() const noexcept;
 
 		// Returns whether the vector is empty 
 		// (i.e. whether its size is 0)
-		bool empty() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR bool empty() const noexcept;
 
 		// Requests that the vector capacity be at least enough to contain n elements
-		void reserve(size_type n);
+		NON_STL_VECTOR_CONSTEXPR void reserve(size_type n);
 
 		// Requests the container to reduce its capacity to fit its size
-		void shrink_to_fit();
+		NON_STL_VECTOR_CONSTEXPR void shrink_to_fit();
 
 		// ---------------
 		// MODIFIERS
@@ -183,56 +241,87 @@ namespace non_stl
 
 		// Range version
 		template <class InputIterator>
-		void assign(InputIterator first, InputIterator last);
+		NON_STL_VECTOR_CONSTEXPR void assign(InputIterator first, InputIterator last);
 
 		// Fill version
-		void assign(size_type n, const T& val);
+		NON_STL_VECTOR_CONSTEXPR void assign(size_type n, const T& val);
 
 		// Initializer list version
-		void assign(std::initializer_list<T> il);
+		NON_STL_VECTOR_CONSTEXPR void assign(std::initializer_list<T> il);
 
 		// Adds a new element at the end of the vector after its current last element
-		void push_back(const T& val);
-		void push_back(T&& val);
+		NON_STL_VECTOR_CONSTEXPR void push_back(const T& val);
+		NON_STL_VECTOR_CONSTEXPR void push_back(T&& val);
 
 		// Appends a new element to the end of the container.
 		// The arguments args... are forwarded to the constructor as std::forward<Args>(args).... 
 		template <class... Args>
-		void emplace_back(Args&& ... args);
+		NON_STL_VECTOR_CONSTEXPR void emplace_back(Args&& ... args);
 
 		// Removes the last element in the vector
-		void pop_back();
+		NON_STL_VECTOR_CONSTEXPR void pop_back();
 
 		// The vector is extended by inserting new elements before the element 
 		// at the specified position, effectively increasing the container size
 		// by the number of elements inserted
 
 		// Single element
-		iterator insert(iterator position, const T& val);
+		NON_STL_VECTOR_CONSTEXPR iterator insert(iterator position, const T& val);
 
 		// Range
 		template <class InputIterator>
-		iterator insert(iterator position, InputIterator first, InputIterator last);
+		NON_STL_VECTOR_CONSTEXPR iterator insert(iterator position, InputIterator first, InputIterator last);
 
 		// Move 
-		iterator insert(iterator position, T&& val);
+		NON_STL_VECTOR_CONSTEXPR iterator insert(iterator position, T&& val);
 
 		// Initializer list
-		iterator insert(iterator position, std::initializer_list<T> il);
+		NON_STL_VECTOR_CONSTEXPR iterator insert(iterator position, std::initializer_list<T> il);
+
+		// Inserts copies of the elements of rg before position
+		// Ranges of forward iterators are measured up front so the vector
+		// grows at most once and the elements after position are shifted once
+		template <class Range>
+		NON_STL_VECTOR_CONSTEXPR iterator insert_range(iterator position, Range&& rg);
+
+		// Appends copies of the elements of rg, or of [first, last), to the end of the vector
+		// Growing at most once for ranges of forward iterators
+		template <class Range>
+		NON_STL_VECTOR_CONSTEXPR void append_range(Range&& rg);
+		template <class InputIterator>
+		NON_STL_VECTOR_CONSTEXPR void append_range(InputIterator first, InputIterator last);
+
+		// Removes the element at position, or the elements in [first, last), from the vector
+		// The elements after them are shifted down, returns an iterator to the element
+		// following the last one removed
+		NON_STL_VECTOR_CONSTEXPR iterator erase(const_iterator position);
+		NON_STL_VECTOR_CONSTEXPR iterator erase(const_iterator first, const_iterator last);
 
 		// Exchanges the content of the container by the content of x
 		// which is another vector object of the same type
-		void swap(vector& x);
+		// The allocators are only exchanged if propagate_on_container_swap is set
+		// Unequal allocators which don't propagate fall back to moving the elements
+		NON_STL_VECTOR_CONSTEXPR void swap(vector& x);
 
 		// Removes all elements from the vector leaving the container with a size of 0
-		void clear() noexcept;
+		NON_STL_VECTOR_CONSTEXPR void clear() noexcept;
 
 		// ---------------
 		// ALLOCATOR
 		// ---------------
 
 		// Returns a copy of the allocator object associated with this vector
-		Alloc get_allocator() const noexcept;
+		NON_STL_VECTOR_CONSTEXPR Alloc get_allocator() const noexcept;
+
+#if defined(NON_STL_VECTOR_STATS)
+		// ---------------
+		// STATISTICS
+		// ---------------
+
+		// Returns the counters of this vector along with its current size and capacity
+		// The counters stay with the instance, moving or swapping only exchanges the elements
+		vector_stats stats() const noexcept;
+#endif
 
 		// ---------------
 		// NON MEMBER FUNCTION
@@ -243,25 +332,79 @@ namespace non_stl
 		// Private functions
 
 		// Reallocate _data to be of capacity cap
-		// Copy all elements from _data over and assign _capacity = cap
-		void reallocate(size_type cap);
+		// Relocate all elements from _data over and assign _capacity = cap
+		NON_STL_VECTOR_CONSTEXPR void reallocate(size_type cap);
+
+		// Returns the capacity requested from the growth policy when
+		// the vector needs room for more than n elements
+		static constexpr size_type grow_capacity(size_type n) noexcept;
 
 		// Call pop_back n times
-		void pop_back_n(size_type n);
+		NON_STL_VECTOR_CONSTEXPR void pop_back_n(size_type n);
+
+		// Destroys every element and returns the array to the allocator
+		// leaving the vector empty with no capacity
+		NON_STL_VECTOR_CONSTEXPR void release() noexcept;
+
+		// Takes the array of rhs, leaving rhs empty with no capacity
+		// Assumed that this vector holds no array
+		NON_STL_VECTOR_CONSTEXPR void steal(vector& rhs) noexcept;
 
 		// Copy items from initializer list into _data
 		// Assumed that _data is empty and properly sized
-		void copy_from_initializer_list(std::initializer_list<T>& init);
+		NON_STL_VECTOR_CONSTEXPR void copy_from_initializer_list(std::initializer_list<T>& init);
 
-		// Shift the underlying array for the vector by n indicies
-		// from idx until the end of the array
-		void shift_array(size_type n, size_type idx);
+		// Copy construct n items from src into _data
+		// Assumed that _data is empty and properly sized
+		NON_STL_VECTOR_CONSTEXPR void copy_construct_n(const T* src, size_type n);
+
+		// Value initializes n elements in the uninitialized storage at dest
+		NON_STL_VECTOR_CONSTEXPR void value_construct_n(T* dest, size_type n);
+
+		// Constructs n copies of val in the uninitialized storage at dest
+		// val must not live in that storage
+		NON_STL_VECTOR_CONSTEXPR void fill_construct_n(T* dest, size_type n, const T& val);
+
+		// Default initializes n elements in the uninitialized storage at dest
+		NON_STL_VECTOR_CONSTEXPR void default_construct_n(T* dest, size_type n);
+
+		// Ensures the capacity is at least n, growing by the policy if needed
+		NON_STL_VECTOR_CONSTEXPR void grow_for(size_type n);
+
+		// Grows the array past its current capacity and constructs a new element
+		// at the end from args before relocating, so args may refer to an element
+		// of this vector
+		template <class... Args>
+		NON_STL_VECTOR_CONSTEXPR void reallocate_append(Args&& ... args);
+
+		// Opens a gap of n uninitialized elements at idx by relocating the elements
+		// from idx until the end of the array, growing the array at most once
+		// _size is left unchanged until the gap has been filled
+		NON_STL_VECTOR_CONSTEXPR void open_gap(size_type idx, size_type n);
+
+		// Closes a gap of n uninitialized elements at idx previously opened by open_gap
+		NON_STL_VECTOR_CONSTEXPR void close_gap(size_type idx, size_type n);
+
+		// Constructs a new element at idx from args, shifting the elements after it
+		template <class... Args>
+		NON_STL_VECTOR_CONSTEXPR iterator emplace_at(size_type idx, Args&& ... args);
+
+		// Constructs n elements copied from the range starting at first into the
+		// uninitialized storage at dest. Contiguous ranges of trivially copyable
+		// elements are copied with a single memcpy
+		template <class ForwardIterator>
+		NON_STL_VECTOR_CONSTEXPR void construct_range(T* dest, ForwardIterator first, size_type n);
 
 		// Returns an iterator that is n positions from begin
-		iterator get_iterator(size_type n);
+		NON_STL_VECTOR_CONSTEXPR iterator get_iterator(size_type n);
+		NON_STL_VECTOR_CONSTEXPR const_iterator get_iterator(size_type n) const;
+
+		// Marks every iterator obtained so far as invalid under NON_STL_DEBUG
+		// Called whenever the elements move to a new array or are destroyed
+		NON_STL_VECTOR_CONSTEXPR void invalidate_iterators() noexcept;
 
 		template <class InputIterator>
-		size_type get_iterator_diff(InputIterator first, InputIterator last);
+		NON_STL_VECTOR_CONSTEXPR size_type get_iterator_diff(InputIterator first, InputIterator last);
 
 		// Member variables
 
@@ -269,7 +412,7 @@ namespace non_stl
 		Alloc _alloc;
 
 		// Maximum storage capacity of the vector. When _size == _capacity the vector
-		// will be reallocated and _capacity increased by a factor of beta
+		// will be reallocated and _capacity increased according to the Growth policy
 		size_type _capacity;
 
 		// The current amount of elements stored within the vector
@@ -277,233 +420,16 @@ namespace non_stl
 
 		// Underlying array of template type T which the vector wraps around
 		T* _data;
-	};
-
-	// BASE ITERATORS
-
-	// Define equivalency operators and all data members
-	// for every iterator to derive from
-	template <class T, class Alloc>
-	class vector<T, Alloc>::parent_iterator
-	{
-	public:
-		parent_iterator(T* ptr, size_type size, size_type idx) :
-			_curr(ptr),
-			_size(size),
-			_idx(idx)
-		{
-		}
-
-		virtual inline bool operator==(const parent_iterator& rhs) const
-		{
-			return (isEnd() && rhs.isEnd()) || (*_curr == *rhs._curr);
-		}
-
-		virtual inline bool operator!=(const parent_iterator& rhs) const
-		{
-			return !(*this == rhs);
-		}
-
-	protected:
-		inline bool isEnd() const
-		{
-			return _size == _idx;
-		}
-
-		T* _curr;
-		size_type _size;
-		size_type _idx;
-	};
-
-	// Define base_iterator which contains the standard access operators
-	// for all non_const iterators to derive from
-	template <class T, class Alloc>
-	class vector<T, Alloc>::base_iterator : virtual public parent_iterator
-	{
-	public:
-		base_iterator(T* ptr, size_type size, size_type idx) :
-			parent_iterator(ptr, size, idx)
-		{
-		}
-
-		virtual T& operator*()
-		{
-			return *_curr;
-		}
-
-		virtual T* operator->()
-		{
-			return _curr;
-		}
-	};
-
-	// Define base_const_iterator which contains the constant access operators
-	// for all const iterators to derive from
-	template <class T, class Alloc>
-	class vector<T, Alloc>::base_const_iterator : virtual public parent_iterator
-	{
-	public:
-		base_const_iterator(T* ptr, size_type size, size_type idx) :
-			parent_iterator(ptr, size, idx)
-		{
-		}
-
-		virtual const T& operator*() const
-		{
-			return *_curr;
-		}
-
-		virtual const T* operator->() const
-		{
-			return _curr;
-		}
-	};
-
-	// Define forward_iterator which defines the ability to iterate standardly through a container
-	// the contrast to this is reverse_iterator
-	template <class T, class Alloc>
-	class vector<T, Alloc>::forward_iterator : virtual public parent_iterator
-	{
-	public:
-		forward_iterator(T* ptr, size_type size, size_type idx) :
-			parent_iterator(ptr, size, idx)
-		{
-		}
-
-		// Prefix
-		virtual forward_iterator operator++(int)
-		{
-			++_curr;
-			++_idx;
-			return *this;
-		}
-
-		// Postfix
-		virtual forward_iterator& operator++()
-		{
-			_curr++;
-			_idx++;
-			return *this;
-		}
-
-		// Prefix
-		virtual forward_iterator operator--(int)
-		{
-			--_curr;
-			--_idx;
-			return *this;
-		}
-
-		// Postfix
-		virtual forward_iterator& operator--()
-		{
-			_curr--;
-			_idx--;
-			return *this;
-		}
-	};
-
-	// Define base_reverse_iterator which defines the ability to iterate through a container the opposite of the
-	// operator you are invoking. Increment operator takes you to the iterator before the current iterator.
-	// The contrast to this is forward_iterator
-	template <class T, class Alloc>
-	class vector<T, Alloc>::base_reverse_iterator : virtual public parent_iterator
-	{
-	public:
-		base_reverse_iterator(T* ptr, size_type size, size_type idx) :
-			parent_iterator(ptr, size, idx)
-		{
-		}
-
-		// Prefix
-		virtual base_reverse_iterator operator++(int)
-		{
-			--_curr;
-			--_idx;
-			return *this;
-		}
-
-		// Postfix
-		virtual base_reverse_iterator& operator++()
-		{
-			_curr--;
-			_idx--;
-			return *this;
-		}
-
-		// Prefix
-		virtual base_reverse_iterator operator--(int)
-		{
-			++_curr;
-			++_idx;
-			return *this;
-		}
-
-		// Postfix
-		virtual base_reverse_iterator& operator--()
-		{
-			_curr++;
-			_idx++;
-			return *this;
-		}
-	};
-
-	// ITERATOR IMPLEMENTATIONS
-
-	// Iterator definition and impl. Standard iterator is both a base_iterator and forward_iterator
-	template <class T, class Alloc>
-	class vector<T, Alloc>::iterator : public vector<T, Alloc>::base_iterator, 
-									   public vector<T, Alloc>::forward_iterator
-	{
-	public:
-		iterator(T* ptr, size_type size, size_type idx) :
-			parent_iterator(ptr, size, idx),
-			base_iterator(ptr, size, idx),
-			forward_iterator(ptr, size, idx)
-		{
-		}
-	};
 
-	// Const Iterator definition and impl. Const iterator is a base_const_iterator and forward_iterator
-	template <class T, class Alloc>
-	class vector<T, Alloc>::const_iterator : public vector<T, Alloc>::base_const_iterator, 
-											 public vector<T, Alloc>::forward_iterator
-	{
-	public:
-		const_iterator(T* ptr, size_type size, size_type idx) :
-			parent_iterator(ptr, size, idx),
-			base_const_iterator(ptr, size, idx),
-			forward_iterator(ptr, size, idx)
-		{
-		}
-	};
-
-	// Reverse Iterator definition and impl. Reverse iterator is both a base_iterator and base_reverse_iterator
-	template <class T, class Alloc>
-	class vector<T, Alloc>::reverse_iterator : public vector<T, Alloc>::base_iterator, 
-											   public vector<T, Alloc>::base_reverse_iterator
-	{
-	public:
-		reverse_iterator(T* ptr, size_type size, size_type idx) :
-			parent_iterator(ptr, size, idx),
-			base_iterator(ptr, size, idx),
-			base_reverse_iterator(ptr, size, idx)
-		{
-		}
-	};
+#if defined(NON_STL_DEBUG)
+		// Bumped by invalidate_iterators, each iterator keeps the value it was obtained at
+		std::uint64_t _generation = 0;
+#endif
 
-	// Const Reverse Iterator definition and impl. Const reverse iterator is both a base_cont_iterator and base_reverse_iterator
-	template <class T, class Alloc>
-	class vector<T, Alloc>::const_reverse_iterator : public vector<T, Alloc>::base_const_iterator,
-													 public vector<T, Alloc>::base_reverse_iterator
-	{
-	public:
-		const_reverse_iterator(T* ptr, size_type size, size_type idx) :
-			parent_iterator(ptr, size, idx),
-			base_const_iterator(ptr, size, idx),
-			base_reverse_iterator(ptr, size, idx)
-		{
-		}
+#if defined(NON_STL_VECTOR_STATS)
+		// Reallocation counters and construction site of this vector
+		vector_stats _stats;
+#endif
 	};
 
 	// VECTOR IMPL
@@ -511,96 +437,141 @@ namespace non_stl
 	// ---------------
 	// CONSTRUCTORS
 	// ---------------
-	template <class T, class Alloc>
-	vector<T, Alloc>::vector() :
+	template <class T, class Alloc, class Growth>
+#if defined(NON_STL_VECTOR_STATS)
+	vector<T, Alloc, Growth>::vector(vector_site site) :
+#else
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::vector() :
+#endif
+		vector(Alloc() NON_STL_VECTOR_SITE_ARG)
+	{
+
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::vector(const Alloc& alloc NON_STL_VECTOR_SITE_DEF) :
+		_alloc(alloc),
 		_capacity(10),
 		_size(0),
 		_data(_alloc.allocate(_capacity))
+		NON_STL_VECTOR_SITE_INIT
 	{
 
 	}
 
-	template <class T, class Alloc>
-	vector<T, Alloc>::vector(size_type size) :
-		_capacity((size_type)(beta* size)),
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::vector(size_type size, const Alloc& alloc NON_STL_VECTOR_SITE_DEF) :
+		_alloc(alloc),
+		_capacity(grow_capacity(size)),
 		_size(size),
-		_data(_alloc.allocate(size))
+		_data(_alloc.allocate(_capacity))
+		NON_STL_VECTOR_SITE_INIT
 	{
-		for (auto i = 0; i < size; ++i)
-		{
-			_data[i] = T();
-		}
+		value_construct_n(_data, size);
 	}
 
-	template <class T, class Alloc>
-	vector<T, Alloc>::vector(size_type size, const T& val) :
-		_capacity((size_type)(beta * size)),
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::vector(size_type size, const T& val, const Alloc& alloc NON_STL_VECTOR_SITE_DEF) :
+		_alloc(alloc),
+		_capacity(grow_capacity(size)),
 		_size(size),
 		_data(_alloc.allocate(_capacity))
+		NON_STL_VECTOR_SITE_INIT
 	{
-		for (auto i = 0; i < size; ++i)
-		{
-			_data[i] = val;
-		}
+		fill_construct_n(_data, size, val);
 	}
 
-	template <class T, class Alloc>
+	template <class T, class Alloc, class Growth>
 	template <class InputIterator>
-	vector<T, Alloc>::vector(InputIterator first, InputIterator last) :
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::vector(InputIterator first, InputIterator last, const Alloc& alloc NON_STL_VECTOR_SITE_DEF) :
+		_alloc(alloc),
 		_capacity(0),
-		_size(0)
+		_size(0),
+		_data(nullptr)
+		NON_STL_VECTOR_SITE_INIT
 	{
 		if constexpr (std::is_integral<InputIterator>::value) {
-			_capacity = (size_type)(beta * first);
+			_capacity = grow_capacity(first);
 			_size = first;
 			_data = _alloc.allocate(_capacity);
 
-			for (auto i = 0; i < first; ++i)
+			for (size_type i = 0; i < _size; ++i)
 			{
-				_data[i] = last;
+				alloc_traits::construct(_alloc, _data + i, last);
 			}
 		}
 		else {
 			_size = get_iterator_diff(first, last);
-			_capacity = (size_type)(beta * _size);
+			_capacity = grow_capacity(_size);
 			_data = _alloc.allocate(_capacity);
 
-			auto count = 0;
+			size_type count = 0;
 			for (auto it2 = first; it2 != last; ++it2)
 			{
-				_data[count++] = *it2;
+				alloc_traits::construct(_alloc, _data + count++, *it2);
 			}
 		}
 	}
 
-	template <class T, class Alloc>
-	vector<T, Alloc>::vector(const vector<T, Alloc>& rhs) :
-		_alloc(rhs._alloc),
-		_capacity(rhs._capacity),
-		_size(rhs._size),
-		_data(_alloc.allocate(_size))
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::vector(const vector<T, Alloc, Growth>& rhs NON_STL_VECTOR_SITE_DEF) :
+		vector(rhs, alloc_traits::select_on_container_copy_construction(rhs._alloc) NON_STL_VECTOR_SITE_ARG)
 	{
-		std::copy_n(rhs._data, _size, _data);
+
 	}
 
-	template <class T, class Alloc>
-	vector<T, Alloc>::vector(vector<T, Alloc>&& rhs) noexcept :
-		_alloc(rhs._alloc),
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::vector(const vector<T, Alloc, Growth>& rhs, const Alloc& alloc NON_STL_VECTOR_SITE_DEF) :
+		_alloc(alloc),
 		_capacity(rhs._capacity),
 		_size(rhs._size),
-		_data(rhs._data)
+		_data(_alloc.allocate(_capacity))
+		NON_STL_VECTOR_SITE_INIT
 	{
-		// set the rvalue to an undefined state since we have moved from it
-		rhs._capacity = 0;
-		rhs._size = 0;
-		rhs._data = nullptr;
+		copy_construct_n(rhs._data, _size);
 	}
 
-	template <class T, class Alloc>
-	vector<T, Alloc>::vector(std::initializer_list<T> init) :
-		_capacity((size_type)(beta * init.size())),
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::vector(vector<T, Alloc, Growth>&& rhs NON_STL_VECTOR_SITE_DEF) noexcept :
+		_alloc(std::move(rhs._alloc)),
+		_capacity(0),
+		_size(0),
+		_data(nullptr)
+		NON_STL_VECTOR_SITE_INIT
+	{
+		steal(rhs);
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::vector(vector<T, Alloc, Growth>&& rhs, const Alloc& alloc NON_STL_VECTOR_SITE_DEF) :
+		_alloc(alloc),
+		_capacity(0),
+		_size(0),
+		_data(nullptr)
+		NON_STL_VECTOR_SITE_INIT
+	{
+		if (_alloc == rhs._alloc)
+		{
+			steal(rhs);
+		}
+		else
+		{
+			// The array belongs to another allocator, move the elements into our own
+			_capacity = rhs._capacity;
+			_data = _alloc.allocate(_capacity);
+			construct_range(_data, std::make_move_iterator(rhs._data), rhs._size);
+			_size = rhs._size;
+			rhs.clear();
+		}
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::vector(std::initializer_list<T> init, const Alloc& alloc NON_STL_VECTOR_SITE_DEF) :
+		_alloc(alloc),
+		_capacity(grow_capacity(init.size())),
 		_size(init.size()),
 		_data(_alloc.allocate(_capacity))
+		NON_STL_VECTOR_SITE_INIT
 	{
 		copy_from_initializer_list(init);
 	}
@@ -608,45 +579,77 @@ namespace non_stl
 	// ---------------
 	// OPERATOR=
 	// ---------------
-	template <class T, class Alloc>
-	vector<T, Alloc>& vector<T, Alloc>::operator=(const vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(const vector<T, Alloc, Growth>& rhs)
 	{
-		// Deallocate currently allocated data
-		~vector();
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		// Deallocate currently allocated data, with the allocator it came from
+		release();
 
 		// Assign member variables
-		_alloc = rhs._alloc;
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+		{
+			_alloc = rhs._alloc;
+		}
 		_capacity = rhs._capacity;
 		_size = rhs._size;
 
 		// Initialize proper sized container and copy elements
 		_data = _alloc.allocate(_capacity);
-		std::copy_n(rhs_data, _size, _data);
+		copy_construct_n(rhs._data, _size);
 
 		return *this;
 	}
 
-	template <class T, class Alloc>
-	vector<T, Alloc>& vector<T, Alloc>::operator=(vector<T, Alloc>&& rhs)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(vector<T, Alloc, Growth>&& rhs) noexcept(
+		std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+		std::allocator_traits<Alloc>::is_always_equal::value)
 	{
-		// Swap all variables with the rvalue
-		// The destructor will be called on rvalue which will
-		// clean up the memory allocated to the original vector
-		swap(rhs);
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+		{
+			// Take the allocator along with the array
+			release();
+			_alloc = std::move(rhs._alloc);
+			steal(rhs);
+		}
+		else
+		{
+			if (_alloc == rhs._alloc)
+			{
+				release();
+				steal(rhs);
+			}
+			else
+			{
+				// Can't adopt an array from another allocator, move the elements one by one
+				assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+				rhs.clear();
+			}
+		}
 
 		return *this;
 	}
 
-	template <class T, class Alloc>
-	vector<T, Alloc>& vector<T, Alloc>::operator=(std::initializer_list<T> init)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(std::initializer_list<T> init)
 	{
 		// Deallocate current allocated data
-		~vector();
+		release();
 
 		// Assign member variables
 		// Note alloc will remain as is already assigned
 		_size = init.size();
-		_capacity = (size_type)beta * _size;
+		_capacity = grow_capacity(_size);
 
 		// Initialize proper sized container
 		_data = _alloc.allocate(_capacity);
@@ -660,94 +663,90 @@ namespace non_stl
 	// ---------------
 	// DESTRUCTOR
 	// ---------------
-	template <class T, class Alloc>
-	vector<T, Alloc>::~vector()
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR vector<T, Alloc, Growth>::~vector()
 	{
-		if (_data)
-		{
-			// Destruct every element contained in the vector
-			for (auto i = 0; i < _size; ++i)
-			{
-				_data[i].~T();
-			}
-
-			// Deallocate _data
-			_alloc.deallocate(_data, _capacity);
-			_data = nullptr;
-			_capacity = 0;
-			_size = 0;
-		}
+#if defined(NON_STL_VECTOR_STATS)
+		vector_stats_registry::instance().record(stats());
+#endif
+		release();
 	}
 
 	// ---------------
 	// ELEMENT ACCESS
 	// ---------------
-	template <class T, class Alloc>
-	inline T& vector<T, Alloc>::operator[](size_type n)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline T& vector<T, Alloc, Growth>::operator[](size_type n)
 	{
+		NON_STL_DEBUG_CHECK(n < _size, "vector::operator[] - index out of range");
 		return _data[n];
 	}
 
-	template <class T, class Alloc>
-	inline const T& vector<T, Alloc>::operator[](size_type n) const
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline const T& vector<T, Alloc, Growth>::operator[](size_type n) const
 	{
+		NON_STL_DEBUG_CHECK(n < _size, "vector::operator[] - index out of range");
 		return _data[n];
 	}
 
-	template <class T, class Alloc>
-	inline T& vector<T, Alloc>::at(size_type n)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline T& vector<T, Alloc, Growth>::at(size_type n)
 	{
 		// n < 0 not allowed due to unsigned typing
 		if (n >= _size)
 		{
-			// throw out of range exception
+			throw std::out_of_range("vector::at - index out of range");
 		}
 		return _data[n];
 	}
 
-	template <class T, class Alloc>
-	inline const T& vector<T, Alloc>::at(size_type n) const
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline const T& vector<T, Alloc, Growth>::at(size_type n) const
 	{
 		// n < 0 not allowed due to unsigned typing
 		if (n >= _size)
 		{
-			// throw out of range exception
+			throw std::out_of_range("vector::at - index out of range");
 		}
 		return _data[n];
 	}
 
-	template <class T, class Alloc>
-	inline T& vector<T, Alloc>::front()
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline T& vector<T, Alloc, Growth>::front()
 	{
+		NON_STL_DEBUG_CHECK(_size > 0, "vector::front - vector is empty");
 		return _data[0];
 	}
 
-	template <class T, class Alloc>
-	inline const T& vector<T, Alloc>::front() const
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline const T& vector<T, Alloc, Growth>::front() const
 	{
+		NON_STL_DEBUG_CHECK(_size > 0, "vector::front - vector is empty");
 		return _data[0];
 	}
 
-	template <class T, class Alloc>
-	inline T& vector<T, Alloc>::back()
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline T& vector<T, Alloc, Growth>::back()
 	{
+		NON_STL_DEBUG_CHECK(_size > 0, "vector::back - vector is empty");
 		return _data[_size - 1];
 	}
 
-	template <class T, class Alloc>
-	inline const T& vector<T, Alloc>::back() const
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline const T& vector<T, Alloc, Growth>::back() const
 	{
+		NON_STL_DEBUG_CHECK(_size > 0, "vector::back - vector is empty");
 		return _data[_size - 1];
 	}
 
-	template <class T, class Alloc>
-	inline T* vector<T, Alloc>::data()
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline T* vector<T, Alloc, Growth>::data()
 	{
 		return _data;
 	}
 
-	template <class T, class Alloc>
-	inline const T* vector<T, Alloc>::data() const
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline const T* vector<T, Alloc, Growth>::data() const
 	{
 		return _data;
 	}
@@ -756,78 +755,74 @@ namespace non_stl
 	// ITERATORS
 	// ---------------
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::iterator vector<T, Alloc>::begin() noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::begin() noexcept
 	{
-		return vector<T, Alloc>::iterator(&_data[0], _size, 0);
+		return get_iterator(0);
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::const_iterator vector<T, Alloc>::begin() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::const_iterator vector<T, Alloc, Growth>::begin() const noexcept
 	{
-		return vector<T, Alloc>::const_iterator(&_data[0], _size, 0);
+		return get_iterator(0);
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::const_iterator vector<T, Alloc>::cbegin() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::const_iterator vector<T, Alloc, Growth>::cbegin() const noexcept
 	{
 		return begin();
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::iterator vector<T, Alloc>::end() noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::end() noexcept
 	{
-		return vector<T, Alloc>::iterator(&_data[_size], _size, _size);
+		return get_iterator(_size);
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::const_iterator vector<T, Alloc>::end() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::const_iterator vector<T, Alloc, Growth>::end() const noexcept
 	{
-		return vector<T, Alloc>::const_iterator(&_data[_size], _size, _size);
+		return get_iterator(_size);
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::const_iterator vector<T, Alloc>::cend() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::const_iterator vector<T, Alloc, Growth>::cend() const noexcept
 	{
 		return end();
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::reverse_iterator vector<T, Alloc>::rbegin() noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::reverse_iterator vector<T, Alloc, Growth>::rbegin() noexcept
 	{
-		// Size for a reverse iterator is effectively -1 (one past normal beginning)
-		return vector<T, Alloc>::reverse_iterator(&_data[_size - 1], -1, _size-1);
+		return reverse_iterator(end());
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::const_reverse_iterator vector<T, Alloc>::rbegin() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::const_reverse_iterator vector<T, Alloc, Growth>::rbegin() const noexcept
 	{
-		// Size for a reverse iterator is effectively -1 (one past normal beginning)
-		return vector<T, Alloc>::const_reverse_iterator(&_data[_size - 1], -1, _size-1);
+		return const_reverse_iterator(end());
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::const_reverse_iterator vector<T, Alloc>::crbegin() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::const_reverse_iterator vector<T, Alloc, Growth>::crbegin() const noexcept
 	{
 		return rbegin();
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::reverse_iterator vector<T, Alloc>::rend() noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::reverse_iterator vector<T, Alloc, Growth>::rend() noexcept
 	{
-		// Size for a reverse iterator is effectively -1 (one past normal beginning)
-		return vector<T, Alloc>::reverse_iterator(&_data[-1], -1, -1);
+		return reverse_iterator(begin());
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::const_reverse_iterator vector<T, Alloc>::rend() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::const_reverse_iterator vector<T, Alloc, Growth>::rend() const noexcept
 	{
-		// Size for a reverse iterator is effectively -1 (one past normal beginning)
-		return vector<T, Alloc>::const_reverse_iterator(&_data[-1], -1, -1);
+		return const_reverse_iterator(begin());
 	}
 
-	template <class T, class Alloc>
-	inline typename vector<T, Alloc>::const_reverse_iterator vector<T, Alloc>::crend() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::const_reverse_iterator vector<T, Alloc, Growth>::crend() const noexcept
 	{
 		return rend();
 	}
@@ -835,22 +830,22 @@ namespace non_stl
 	// ---------------
 	// CAPACITY
 	// ---------------
-	template <class T, class Alloc>
-	inline size_type vector<T, Alloc>::size() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline size_type vector<T, Alloc, Growth>::size() const noexcept
 	{
 		return _size;
 	}
 
-	template <class T, class Alloc>
-	constexpr size_type vector<T, Alloc>::max_size() const
+	template <class T, class Alloc, class Growth>
+	constexpr size_type vector<T, Alloc, Growth>::max_size() const
 	{
 		// TODO probably not a completely accurate measure
 		// due to hitting memory constraints long before having this many elements
 		return std::numeric_limits<size_type>::max();
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::resize(size_type n)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::resize(size_type n)
 	{
 		// Reduce content to first n elements
 		// Discarding any others
@@ -858,51 +853,68 @@ namespace non_stl
 		{
 			// Pop back on the vector (_size - n) times
 			pop_back_n(_size - n);
+			return;
 		}
-		else if (n <= _capacity)
+
+		grow_for(n);
+		value_construct_n(_data + _size, n - _size);
+		_size = n;
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::resize(size_type n, const T& val)
+	{
+		if (n < _size)
 		{
-			// Insert at the end as many elements as needed to reach size n
-			// No element specified to assign, so leave uninitialized memory
-			_size = n;
+			pop_back_n(_size - n);
+			return;
 		}
-		else
+
+		// Take a copy in case val refers to an element which is about to be relocated
+		const T copy(val);
+		grow_for(n);
+
+		// Construct the new elements of the resized vector from val
+		fill_construct_n(_data + _size, n - _size, copy);
+		_size = n;
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::resize_default_init(size_type n)
+	{
+		if (n < _size)
 		{
-			// Perform reallocation of the array
-			reallocate(n);
-			_size = n;
+			pop_back_n(_size - n);
+			return;
 		}
+
+		grow_for(n);
+		default_construct_n(_data + _size, n - _size);
+		_size = n;
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::resize(size_type n, const T& val)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR span<T> vector<T, Alloc, Growth>::append_uninitialized(size_type n)
 	{
 		const auto old_size = _size;
-		resize(n);
-
-		// Need to assign the new values of the resized vector to val
-		if (n >= old_size)
-		{
-			for (auto i = old_size - 1; i < _size; ++i)
-			{
-				_data[i] = val;
-			}
-		}
+		resize_default_init(_size + n);
+		return span<T>(_data + old_size, n);
 	}
 
-	template <class T, class Alloc>
-	inline size_type vector<T, Alloc>::capacity() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline size_type vector<T, Alloc, Growth>::capacity() const noexcept
 	{
 		return _capacity;
 	}
 
-	template <class T, class Alloc>
-	inline bool vector<T, Alloc>::empty() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline bool vector<T, Alloc, Growth>::empty() const noexcept
 	{
 		return size() == 0;
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::reserve(size_type n)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::reserve(size_type n)
 	{
 		if (n <= _capacity)
 		{
@@ -912,8 +924,8 @@ namespace non_stl
 		reallocate(n);
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::shrink_to_fit()
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::shrink_to_fit()
 	{
 		// If capacity is bigger than size then reallocate to _size
 		// calling reallocate is safe since we are allocating the new
@@ -928,9 +940,9 @@ namespace non_stl
 	// ---------------
 	// MODIFIERS
 	// ---------------
-	template <class T, class Alloc>
+	template <class T, class Alloc, class Growth>
 	template <class InputIterator>
-	void vector<T, Alloc>::assign(InputIterator first, InputIterator last)
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::assign(InputIterator first, InputIterator last)
 	{
 		// Need to clear out the elements currently assigned anyway so do it first
 		clear();
@@ -939,16 +951,16 @@ namespace non_stl
 			if (first >= _capacity)
 			{
 				// Need to reallocate the inner array
-				reallocate((size_type)(beta * first));
+				reallocate(grow_capacity(first));
 			}
 
 			// Assign size of vector
 			_size = first;
 
 			// Assign each new element to val
-			for (auto i = 0; i < first; ++i)
+			for (size_type i = 0; i < _size; ++i)
 			{
-				_data[i] = last;
+				alloc_traits::construct(_alloc, _data + i, last);
 			}
 		}
 		else {
@@ -958,7 +970,7 @@ namespace non_stl
 			if (n >= _capacity)
 			{
 				// Need to reallocate the inner array
-				reallocate((size_type)(beta * n));
+				reallocate(grow_capacity(n));
 			}
 
 			// Assign size of vector
@@ -969,13 +981,13 @@ namespace non_stl
 			// Populate data
 			for (auto it2 = first; it2 != last; ++it2)
 			{
-				_data[n++] = *it2;
+				alloc_traits::construct(_alloc, _data + n++, *it2);
 			}
 		}
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::assign(size_type n, const T& val)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::assign(size_type n, const T& val)
 	{
 		// Need to clear out the elements currently assigned anyway so do it first
 		clear();
@@ -983,21 +995,18 @@ namespace non_stl
 		if (n >= _capacity)
 		{
 			// Need to reallocate the inner array
-			reallocate((size_type)(beta * n));
+			reallocate(grow_capacity(n));
 		}
 
+		// Assign each new element to val
+		fill_construct_n(_data, n, val);
+
 		// Assign size of vector
 		_size = n;
-
-		// Assign each new element to val
-		for (auto i = 0; i < n; ++i)
-		{
-			_data[i] = val;
-		}
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::assign(std::initializer_list<T> il)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::assign(std::initializer_list<T> il)
 	{
 		// Need to clear out elements currently assigned anyway so do it first
 		clear();
@@ -1007,7 +1016,7 @@ namespace non_stl
 		if (n >= _capacity)
 		{
 			// Need to reallocate the inner array
-			reallocate((size_type)(beta * n));
+			reallocate(grow_capacity(n));
 		}
 
 		// Assign size of vector
@@ -1017,152 +1026,183 @@ namespace non_stl
 		copy_from_initializer_list(il);
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::push_back(const T& val)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::push_back(const T& val)
 	{
-		// Check for reallocation
-		if (_size == _capacity)
-		{
-			reallocate((size_type)(beta * _capacity));
-		}
-
-		_data[_size++] = val;
+		emplace_back(val);
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::push_back(T&& val)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::push_back(T&& val)
 	{
-		// Check for reallocation
-		if (_size == _capacity)
-		{
-			reallocate((size_type)(beta * _capacity));
-		}
-
-		_data[_size++] = std::forward<T>(val);
+		emplace_back(std::move(val));
 	}
 
-	template <class T, class Alloc>
+	template <class T, class Alloc, class Growth>
 	template <class... Args>
-	void vector<T, Alloc>::emplace_back(Args&& ... args)
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::emplace_back(Args&& ... args)
 	{
 		// Check for reallocation
 		if (_size == _capacity)
 		{
-			reallocate((size_type)(beta * _capacity));
+			reallocate_append(std::forward<Args>(args)...);
+			return;
 		}
 
-		_data[_size++] = T(std::forward<Args>(args)...);
+		alloc_traits::construct(_alloc, _data + _size, std::forward<Args>(args)...);
+		++_size;
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::pop_back()
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::pop_back()
 	{
 		// Call destructor on the last element in the vector
 		// and decrement size so we can write over it later
+		NON_STL_DEBUG_CHECK(_size > 0, "vector::pop_back - vector is empty");
 		_data[_size - 1].~T();
 		--_size;
 	}
 
-	template <class T, class Alloc>
-	typename vector<T, Alloc>::iterator vector<T, Alloc>::insert(iterator position, const T& val)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert(iterator position, const T& val)
 	{
-		const auto idx = &(*position) - _data;
+		return emplace_at(position - begin(), val);
+	}
 
-		if (_size == _capacity)
-		{
-			// Need to reallocate
-			reallocate((size_type)(beta * _capacity));
-		}
+	template <class T, class Alloc, class Growth>
+	template <class InputIterator>
+	NON_STL_VECTOR_CONSTEXPR typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert(iterator position, InputIterator first, InputIterator last)
+	{
+		const auto idx = (size_type)(position - begin());
 
-		// Need to shift the array over by n indicies from the end until idx
-		shift_array(1, idx);
+		using category = typename std::iterator_traits<InputIterator>::iterator_category;
+		if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+			// O(1) for random access iterators
+			const auto n = (size_type)std::distance(first, last);
 
-		_data[idx] = val;
+			// Make room once and construct the new elements straight into the gap
+			open_gap(idx, n);
+			try
+			{
+				construct_range(_data + idx, first, n);
+			}
+			catch (...)
+			{
+				close_gap(idx, n);
+				throw;
+			}
+			_size += n;
+		}
+		else {
+			// Single pass iterators can't be measured, append and rotate into place
+			const auto old_size = _size;
+			for (; first != last; ++first)
+			{
+				emplace_back(*first);
+			}
+			std::rotate(_data + idx, _data + old_size, _data + _size);
+		}
 
 		return get_iterator(idx);
 	}
 
-	template <class T, class Alloc>
-	template <class InputIterator>
-	typename vector<T, Alloc>::iterator vector<T, Alloc>::insert(iterator position, InputIterator first, InputIterator last)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert(iterator position, T&& val)
 	{
-		const auto idx = &(*position) - _data;
-		const auto n = get_iterator_diff(first, last);
-		const auto old_size = _size;
+		return emplace_at(position - begin(), std::move(val));
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert(iterator position, std::initializer_list<T> il)
+	{
+		return insert(position, il.begin(), il.end());
+	}
 
-		if (_size + n >= _capacity)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::erase(const_iterator position)
+	{
+		return erase(position, position + 1);
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::erase(const_iterator first, const_iterator last)
+	{
+		const auto idx = (size_type)(first - cbegin());
+		const auto n = (size_type)(last - first);
+		NON_STL_DEBUG_CHECK(first <= last && idx + n <= _size, "vector::erase - range outside of the vector");
+
+		for (size_type i = idx; i < idx + n; ++i)
 		{
-			// Need to reallocate
-			reallocate((size_type)(beta * (_size + n)));
+			alloc_traits::destroy(_alloc, _data + i);
 		}
 
-		// Need to shift the array over by n indicies
-		shift_array(n, idx);
-
-		auto it = first;
-		for (auto i = idx; i < old_size; ++i)
+		// The destroyed elements leave a gap for the tail to be relocated into
+		_size -= n;
+		if (n > 0)
 		{
-			_data[i] = *(it);
-			++it;
+			close_gap(idx, n);
 		}
 
 		return get_iterator(idx);
 	}
 
-	template <class T, class Alloc>
-	typename vector<T, Alloc>::iterator vector<T, Alloc>::insert(iterator position, T&& val)
+	template <class T, class Alloc, class Growth>
+	template <class Range>
+	NON_STL_VECTOR_CONSTEXPR typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert_range(iterator position, Range&& rg)
 	{
-		const auto idx = &(*position) - _data;
-
-		if (_size == _capacity)
-		{
-			// Need to reallocate
-			reallocate((size_type)(beta * _capacity));
-		}
-
-		// Need to shift the array over by n indicies from the end until idx
-		shift_array(1, idx);
-
-		_data[idx] = val;
+		return insert(position, std::begin(rg), std::end(rg));
+	}
 
-		return get_iterator(idx);
+	template <class T, class Alloc, class Growth>
+	template <class Range>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::append_range(Range&& rg)
+	{
+		insert(end(), std::begin(rg), std::end(rg));
 	}
 
-	template <class T, class Alloc>
-	typename vector<T, Alloc>::iterator vector<T, Alloc>::insert(iterator position, std::initializer_list<T> il)
+	template <class T, class Alloc, class Growth>
+	template <class InputIterator>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::append_range(InputIterator first, InputIterator last)
 	{
-		const auto idx = &(*position) - _data;
-		const auto n = il.size();
+		insert(end(), first, last);
+	}
 
-		if (_size + n >= _capacity)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::swap(vector<T, Alloc, Growth>& x)
+	{
+		if (this == &x)
 		{
-			// Need to reallocate
-			reallocate((size_type)(beta * (_size + n)));
+			return;
 		}
 
-		// Need to shift the array over by n indicies
-		shift_array(n, idx);
-
-		auto i = idx;
-		for (auto& it : il)
+		if constexpr (alloc_traits::propagate_on_container_swap::value)
 		{
-			_data[idx++] = it;
+			using std::swap;
+			swap(_alloc, x._alloc);
+		}
+		else if constexpr (!alloc_traits::is_always_equal::value)
+		{
+			// Each array has to stay with the allocator it came from
+			if (!(_alloc == x._alloc))
+			{
+				vector tmp(std::move(x), _alloc);
+				x = std::move(*this);
+				*this = std::move(tmp);
+				return;
+			}
 		}
 
-		return get_iterator(idx);
-	}
-
-	template <class T, class Alloc>
-	void vector<T, Alloc>::swap(vector < T, Alloc>& x)
-	{
-		std::swap(_alloc, x._alloc);
+#if defined(NON_STL_VECTOR_STATS)
+		_stats.observe(_capacity);
+		x._stats.observe(x._capacity);
+#endif
 		std::swap(_capacity, x._capacity);
 		std::swap(_size, x._size);
 		std::swap(_data, x._data);
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::clear() noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::clear() noexcept
 	{
 		// pop_back_n(_size) would be a cleaner
 		// implementation in terms of reuse
@@ -1174,18 +1214,35 @@ namespace non_stl
 			_data[i].~T();
 		}
 		_size = 0;
+		invalidate_iterators();
 	}
 
 	// ---------------
 	// ALLOCATOR
 	// ---------------
 
-	template <class T, class Alloc>
-	Alloc vector<T, Alloc>::get_allocator() const noexcept
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR Alloc vector<T, Alloc, Growth>::get_allocator() const noexcept
 	{
 		return _alloc;
 	}
 
+#if defined(NON_STL_VECTOR_STATS)
+	// ---------------
+	// STATISTICS
+	// ---------------
+
+	template <class T, class Alloc, class Growth>
+	vector_stats vector<T, Alloc, Growth>::stats() const noexcept
+	{
+		auto stats = _stats;
+		stats.observe(_capacity);
+		stats.size = _size;
+		stats.capacity = _capacity;
+		return stats;
+	}
+#endif
+
 	// ---------------
 	// NON MEMBER FUNCTION
 	// OVERLOADS
@@ -1194,26 +1251,109 @@ namespace non_stl
 	// ---------------
 	// PRIVATE
 	// ---------------
-	template <class T, class Alloc>
-	void vector<T, Alloc>::reallocate(size_type cap)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::reallocate(size_type cap)
 	{
-		// Allocate new array and copy over data
+		// Allocate new array and relocate the data over
+		// relocate_n uses a single memcpy for trivially relocatable types
+		// otherwise each element is moved if its move is noexcept and copied if not
 		auto cp = _alloc.allocate(cap);
 
-		// Only copy_n if we have elements to copy
-		if(_size > 0)
+		try
+		{
+			relocate_n(_alloc, _data, _size, cp);
+		}
+		catch (...)
 		{
-			std::copy_n(_data, _size, cp);
+			// Old array is untouched, release the new one and leave the vector as it was
+			_alloc.deallocate(cp, cap);
+			throw;
 		}
 
+#if defined(NON_STL_VECTOR_STATS)
+		_stats.reallocated(_size * sizeof(T), cap);
+#endif
+
 		// Deallocate old array and reassign member variables
-		_alloc.deallocate(_data, _capacity);
+		if (_data)
+		{
+			_alloc.deallocate(_data, _capacity);
+		}
 		_data = cp;
 		_capacity = cap;
+		invalidate_iterators();
+	}
+
+	template <class T, class Alloc, class Growth>
+	constexpr size_type vector<T, Alloc, Growth>::grow_capacity(size_type n) noexcept
+	{
+		return Growth::grow(n, sizeof(T));
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::copy_construct_n(const T* src, size_type n)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+		{
+			// memcpy can't begin the lifetime of the elements during constant evaluation
+			if (!is_constant_evaluated())
+			{
+				if (n > 0)
+				{
+					std::memcpy(static_cast<void*>(_data), static_cast<const void*>(src), n * sizeof(T));
+				}
+				return;
+			}
+		}
+
+		for (size_type i = 0; i < n; ++i)
+		{
+			alloc_traits::construct(_alloc, _data + i, src[i]);
+		}
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::pop_back_n(size_type n)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::release() noexcept
+	{
+#if defined(NON_STL_VECTOR_STATS)
+		// Keep the capacity about to be given up for the peak
+		_stats.observe(_capacity);
+#endif
+		if (_data)
+		{
+			// Destruct every element contained in the vector
+			for (size_type i = 0; i < _size; ++i)
+			{
+				alloc_traits::destroy(_alloc, _data + i);
+			}
+
+			// Deallocate _data
+			_alloc.deallocate(_data, _capacity);
+			_data = nullptr;
+			_capacity = 0;
+			_size = 0;
+			invalidate_iterators();
+		}
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::steal(vector<T, Alloc, Growth>& rhs) noexcept
+	{
+#if defined(NON_STL_VECTOR_STATS)
+		rhs._stats.observe(rhs._capacity);
+#endif
+		_capacity = rhs._capacity;
+		_size = rhs._size;
+		_data = rhs._data;
+
+		// set the rvalue to an empty state since we have moved from it
+		rhs._capacity = 0;
+		rhs._size = 0;
+		rhs._data = nullptr;
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::pop_back_n(size_type n)
 	{
 		for (auto i = 0; i < n; ++i)
 		{
@@ -1221,81 +1361,353 @@ namespace non_stl
 		}
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::copy_from_initializer_list(std::initializer_list<T>& init)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::copy_from_initializer_list(std::initializer_list<T>& init)
 	{
-		auto count = 0;
+		size_type count = 0;
 		for (auto& it : init)
 		{
-			_data[count++] = it;
+			alloc_traits::construct(_alloc, _data + count++, it);
 		}
 	}
 
-	template <class T, class Alloc>
-	void vector<T, Alloc>::shift_array(size_type n, size_type idx)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::value_construct_n(T* dest, size_type n)
 	{
-		auto copy_to = _size + n;
-		auto copy_from = _size;
-		auto complete = false;
-
-		while(copy_from >= idx && !complete)
+		if constexpr (std::is_trivial<T>::value)
 		{
-			_data[copy_to--] = _data[copy_from];
-			if (copy_from == 0)
+			// Value initializing a trivial type zero initializes it
+			if (!is_constant_evaluated())
 			{
-				complete = true;
+				if (n > 0)
+				{
+					std::memset(static_cast<void*>(dest), 0, n * sizeof(T));
+				}
+				return;
 			}
-			--copy_from;
 		}
 
-		// Adjust the size counter for the vector
-		_size += n;
+		size_type constructed = 0;
+		try
+		{
+			for (; constructed < n; ++constructed)
+			{
+				alloc_traits::construct(_alloc, dest + constructed);
+			}
+		}
+		catch (...)
+		{
+			for (size_type i = 0; i < constructed; ++i)
+			{
+				alloc_traits::destroy(_alloc, dest + i);
+			}
+			throw;
+		}
 	}
 
-	template <class T, class Alloc>
-	typename vector<T, Alloc>::iterator vector<T, Alloc>::get_iterator(size_type n)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::fill_construct_n(T* dest, size_type n, const T& val)
 	{
-		// Get the difference from the index to the end of the vector
-		auto diff = _size - n;
+		if constexpr (std::is_trivial<T>::value)
+		{
+			// Trivial elements are stored directly, a whole vector register at a time
+			if (!is_constant_evaluated())
+			{
+				simd::fill(dest, dest + n, val);
+				return;
+			}
+		}
 
-		vector<T, Alloc>::iterator it = diff < n ? end() : begin();
+		size_type constructed = 0;
+		try
+		{
+			for (; constructed < n; ++constructed)
+			{
+				alloc_traits::construct(_alloc, dest + constructed, val);
+			}
+		}
+		catch (...)
+		{
+			for (size_type i = 0; i < constructed; ++i)
+			{
+				alloc_traits::destroy(_alloc, dest + i);
+			}
+			throw;
+		}
+	}
 
-		// Decide whether to iterate from the front or back of the vector
-		if (diff < n)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::default_construct_n(T* dest, size_type n)
+	{
+		// During constant evaluation every element has to be constructed before it is written,
+		// and placement new isn't allowed, so the elements are value initialized instead
+		if (is_constant_evaluated())
 		{
-			// Shorter to iterate from the back
-			it = end();
+			value_construct_n(dest, n);
+			return;
+		}
 
-			// Decrease the iterator diff times
-			for (auto i = 0; i < diff; ++i)
+		// Trivially default constructible elements need no work at all
+		if constexpr (!std::is_trivially_default_constructible<T>::value)
+		{
+			size_type constructed = 0;
+			try
+			{
+				// allocator construct always value initializes so placement new is used directly
+				for (; constructed < n; ++constructed)
+				{
+					::new (static_cast<void*>(dest + constructed)) T;
+				}
+			}
+			catch (...)
 			{
-				--it;
+				for (size_type i = 0; i < constructed; ++i)
+				{
+					alloc_traits::destroy(_alloc, dest + i);
+				}
+				throw;
 			}
 		}
-		else
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::grow_for(size_type n)
+	{
+		if (n > _capacity)
+		{
+			reallocate(std::max(grow_capacity(_capacity), n));
+		}
+	}
+
+	template <class T, class Alloc, class Growth>
+	template <class... Args>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::reallocate_append(Args&& ... args)
+	{
+		const auto cap = grow_capacity(_capacity);
+		auto cp = _alloc.allocate(cap);
+
+		// Construct the new element first as args may live in the current array
+		try
+		{
+			alloc_traits::construct(_alloc, cp + _size, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			_alloc.deallocate(cp, cap);
+			throw;
+		}
+
+		try
+		{
+			relocate_n(_alloc, _data, _size, cp);
+		}
+		catch (...)
+		{
+			alloc_traits::destroy(_alloc, cp + _size);
+			_alloc.deallocate(cp, cap);
+			throw;
+		}
+
+#if defined(NON_STL_VECTOR_STATS)
+		_stats.reallocated(_size * sizeof(T), cap);
+#endif
+
+		if (_data)
+		{
+			_alloc.deallocate(_data, _capacity);
+		}
+		_data = cp;
+		_capacity = cap;
+		++_size;
+		invalidate_iterators();
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::open_gap(size_type idx, size_type n)
+	{
+		if (n == 0)
+		{
+			return;
+		}
+
+		// Only grow when the gap doesn't already fit, and then grow enough for it in one step
+		if (_size + n > _capacity)
 		{
-			// Short to iterate from the front
-			it = begin();
+			const auto cap = std::max(grow_capacity(_capacity), _size + n);
 
-			// Increase the iterator n times
-			for (auto i = 0; i < n; ++i)
+			// Relocate both sides of the gap straight into their final place so every element moves once
+			auto cp = _alloc.allocate(cap);
+			try
 			{
-				++it;
+				relocate_n(_alloc, _data, idx, cp);
 			}
+			catch (...)
+			{
+				// Old array is untouched, release the new one and leave the vector as it was
+				_alloc.deallocate(cp, cap);
+				throw;
+			}
+
+			try
+			{
+				relocate_n(_alloc, _data + idx, _size - idx, cp + idx + n);
+			}
+			catch (...)
+			{
+				// The elements after idx are untouched, bring the ones before it back
+				try
+				{
+					relocate_n(_alloc, cp, idx, _data);
+				}
+				catch (...)
+				{
+					// The elements before idx are lost, keep the vector valid without them
+					for (size_type i = 0; i < idx; ++i)
+					{
+						alloc_traits::destroy(_alloc, cp + i);
+					}
+					for (size_type i = idx; i < _size; ++i)
+					{
+						alloc_traits::destroy(_alloc, _data + i);
+					}
+					_size = 0;
+					invalidate_iterators();
+				}
+				_alloc.deallocate(cp, cap);
+				throw;
+			}
+
+#if defined(NON_STL_VECTOR_STATS)
+			_stats.reallocated(_size * sizeof(T), cap);
+#endif
+
+			if (_data)
+			{
+				_alloc.deallocate(_data, _capacity);
+			}
+			_data = cp;
+			_capacity = cap;
+			invalidate_iterators();
+			return;
 		}
 
-		return it;
+		relocate_overlapping_n(_alloc, _data + idx, _size - idx, _data + idx + n);
 	}
 
-	template <class T, class Alloc>
-	template <class InputIterator>
-	size_type vector<T, Alloc>::get_iterator_diff(InputIterator first, InputIterator last)
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::close_gap(size_type idx, size_type n)
+	{
+		relocate_overlapping_n(_alloc, _data + idx + n, _size - idx, _data + idx);
+	}
+
+	template <class T, class Alloc, class Growth>
+	template <class... Args>
+	NON_STL_VECTOR_CONSTEXPR typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::emplace_at(size_type idx, Args&& ... args)
+	{
+		if (idx == _size)
+		{
+			emplace_back(std::forward<Args>(args)...);
+			return get_iterator(idx);
+		}
+
+		// Build the element before shifting as args may refer to an element of this vector
+		T tmp(std::forward<Args>(args)...);
+
+		open_gap(idx, 1);
+		try
+		{
+			alloc_traits::construct(_alloc, _data + idx, std::move(tmp));
+		}
+		catch (...)
+		{
+			close_gap(idx, 1);
+			throw;
+		}
+		++_size;
+
+		return get_iterator(idx);
+	}
+
+	template <class T, class Alloc, class Growth>
+	template <class ForwardIterator>
+	NON_STL_VECTOR_CONSTEXPR void vector<T, Alloc, Growth>::construct_range(T* dest, ForwardIterator first, size_type n)
 	{
-		auto ret = 0;
-		for (auto it = first; it != last; it++)
+		constexpr bool contiguous =
+			std::is_same<ForwardIterator, T*>::value ||
+			std::is_same<ForwardIterator, const T*>::value ||
+			std::is_same<ForwardIterator, iterator>::value ||
+			std::is_same<ForwardIterator, const_iterator>::value;
+
+		if constexpr (contiguous && std::is_trivially_copyable<T>::value)
 		{
-			++ret;
+			if (!is_constant_evaluated())
+			{
+				if (n > 0)
+				{
+					std::memcpy(static_cast<void*>(dest), static_cast<const void*>(&*first), n * sizeof(T));
+				}
+				return;
+			}
 		}
-		return ret;
+
+		size_type constructed = 0;
+		try
+		{
+			for (; constructed < n; ++constructed, ++first)
+			{
+				alloc_traits::construct(_alloc, dest + constructed, *first);
+			}
+		}
+		catch (...)
+		{
+			for (size_type i = 0; i < constructed; ++i)
+			{
+				alloc_traits::destroy(_alloc, dest + i);
+			}
+			throw;
+		}
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::get_iterator(size_type n)
+	{
+#if defined(NON_STL_DEBUG)
+		return iterator(_data + n, &_generation);
+#else
+		return iterator(_data + n);
+#endif
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline typename vector<T, Alloc, Growth>::const_iterator vector<T, Alloc, Growth>::get_iterator(size_type n) const
+	{
+#if defined(NON_STL_DEBUG)
+		return const_iterator(_data + n, &_generation);
+#else
+		return const_iterator(_data + n);
+#endif
+	}
+
+	template <class T, class Alloc, class Growth>
+	NON_STL_VECTOR_CONSTEXPR inline void vector<T, Alloc, Growth>::invalidate_iterators() noexcept
+	{
+#if defined(NON_STL_DEBUG)
+		++_generation;
+#endif
+	}
+
+	template <class T, class Alloc, class Growth>
+	template <class InputIterator>
+	NON_STL_VECTOR_CONSTEXPR size_type vector<T, Alloc, Growth>::get_iterator_diff(InputIterator first, InputIterator last)
+	{
+		// O(1) for random access iterators
+		return (size_type)std::distance(first, last);
+	}
+
+	namespace pmr
+	{
+		// vector using a polymorphic allocator, e.g. backed by a non_stl::monotonic_buffer
+		template <class T, class Growth = double_growth>
+		using vector = non_stl::vector<T, std::pmr::polymorphic_allocator<T>, Growth>;
 	}
 }
@@ -0,0 +1,186 @@
+// vector_stats.h
+// Opt-in allocation and growth statistics for non_stl::vector
+
+/*
+ * Defining NON_STL_VECTOR_STATS before including vector.h makes every vector count its reallocations,
+ * the bytes relocated by them and its peak capacity, and remember the call site it was constructed at.
+ * The counters of an instance are available from vector::stats(). When a vector is destroyed they are
+ * merged into vector_stats_registry under its call site, so the vectors which churn can be found and given
+ * a reserve(). Vectors constructed inside other containers report the site within that container.
+ * Without NON_STL_VECTOR_STATS this header only defines empty macros and vector is unchanged.
+ */
+
+#pragma once
+
+#if defined(NON_STL_VECTOR_STATS)
+
+// Includes
+#include <algorithm>		// std::max, std::sort
+#include <cstring>			// std::strcmp
+#include <map>				// std::map
+#include <mutex>			// std::mutex, std::lock_guard
+#include <utility>			// std::pair
+#include <vector>			// std::vector
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// The source location a vector was constructed at
+	struct vector_site
+	{
+		const char* file = "";
+		const char* function = "";
+		unsigned line = 0;
+
+		// Returns the location of the caller, used as a default argument so it is evaluated
+		// where the vector is constructed
+		static constexpr vector_site current(const char* file = __builtin_FILE(),
+			const char* function = __builtin_FUNCTION(), unsigned line = __builtin_LINE()) noexcept
+		{
+			return vector_site{ file, function, line };
+		}
+
+		// Sites are ordered by file then line, the function is only informative
+		friend bool operator<(const vector_site& lhs, const vector_site& rhs) noexcept
+		{
+			const int cmp = std::strcmp(lhs.file, rhs.file);
+			return cmp != 0 ? cmp < 0 : lhs.line < rhs.line;
+		}
+	};
+
+	// Counters of a single vector
+	struct vector_stats
+	{
+		vector_site site;
+
+		// Amount of times the underlying array was replaced by a bigger or smaller one
+		size_type reallocations = 0;
+
+		// Bytes of elements relocated into the new arrays
+		size_type bytes_relocated = 0;
+
+		// Largest capacity the vector had
+		size_type peak_capacity = 0;
+
+		// Size and capacity when the statistics were taken
+		size_type size = 0;
+		size_type capacity = 0;
+
+		constexpr vector_stats() noexcept = default;
+		constexpr explicit vector_stats(vector_site s) noexcept : site(s) {}
+
+		// Returns the fraction of the capacity not holding elements
+		double wasted_capacity_ratio() const noexcept
+		{
+			return capacity == 0 ? 0.0 : static_cast<double>(capacity - size) / static_cast<double>(capacity);
+		}
+
+		// Records a reallocation to capacity which relocated bytes of elements
+		void reallocated(size_type bytes, size_type cap) noexcept
+		{
+			++reallocations;
+			bytes_relocated += bytes;
+			peak_capacity = std::max(peak_capacity, cap);
+		}
+
+		// Records the capacity the vector currently has
+		void observe(size_type cap) noexcept
+		{
+			peak_capacity = std::max(peak_capacity, cap);
+		}
+	};
+
+	// Counters of every destroyed vector constructed at one site
+	struct vector_site_stats
+	{
+		size_type instances = 0;
+		size_type reallocations = 0;
+		size_type bytes_relocated = 0;
+
+		// Largest peak capacity of any instance
+		size_type peak_capacity = 0;
+
+		// Sums of the sizes and capacities at destruction
+		size_type total_size = 0;
+		size_type total_capacity = 0;
+
+		// Returns the fraction of the capacity at destruction not holding elements
+		double wasted_capacity_ratio() const noexcept
+		{
+			return total_capacity == 0 ? 0.0 :
+				static_cast<double>(total_capacity - total_size) / static_cast<double>(total_capacity);
+		}
+	};
+
+	// Process wide aggregate of the statistics of destroyed vectors, keyed by construction site
+	// Every member function is thread safe
+	class vector_stats_registry
+	{
+	public:
+		using entry = std::pair<vector_site, vector_site_stats>;
+
+		// Returns the process wide registry
+		// It is never destroyed, vectors with static storage duration record into it at exit
+		static vector_stats_registry& instance()
+		{
+			static vector_stats_registry* registry = new vector_stats_registry;
+			return *registry;
+		}
+
+		// Merges the statistics of a vector into its site
+		void record(const vector_stats& stats)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			auto& site = _sites[stats.site];
+			++site.instances;
+			site.reallocations += stats.reallocations;
+			site.bytes_relocated += stats.bytes_relocated;
+			site.peak_capacity = std::max(site.peak_capacity, stats.peak_capacity);
+			site.total_size += stats.size;
+			site.total_capacity += stats.capacity;
+		}
+
+		// Returns the statistics of every site, the sites with the most reallocations first
+		std::vector<entry> snapshot() const
+		{
+			std::vector<entry> entries;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				entries.assign(_sites.begin(), _sites.end());
+			}
+			std::sort(entries.begin(), entries.end(), [](const entry& lhs, const entry& rhs) {
+				return lhs.second.reallocations > rhs.second.reallocations;
+			});
+			return entries;
+		}
+
+		// Forgets every site
+		void reset()
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_sites.clear();
+		}
+
+	private:
+		vector_stats_registry() = default;
+
+		mutable std::mutex _mutex;
+		std::map<vector_site, vector_site_stats> _sites;
+	};
+}
+
+// Constructor parameter capturing the construction site, its definition and forwarding
+#define NON_STL_VECTOR_SITE , ::non_stl::vector_site site = ::non_stl::vector_site::current()
+#define NON_STL_VECTOR_SITE_DEF , ::non_stl::vector_site site
+#define NON_STL_VECTOR_SITE_ARG , site
+#define NON_STL_VECTOR_SITE_INIT , _stats(site)
+
+#else
+
+#define NON_STL_VECTOR_SITE
+#define NON_STL_VECTOR_SITE_DEF
+#define NON_STL_VECTOR_SITE_ARG
+#define NON_STL_VECTOR_SITE_INIT
+
+#endif
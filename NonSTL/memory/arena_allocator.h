@@ -0,0 +1,104 @@
+// arena_allocator.h
+// A non-stl header only implementation of a stateful allocator which allocates from a monotonic_buffer.
+
+/*
+ * An arena_allocator is a pointer to a monotonic_buffer. Allocation bumps the buffer's pointer without
+ * any virtual dispatch and deallocation is a no-op, the memory is reclaimed when the buffer is released.
+ * Containers keep the arena they were constructed with: the allocator does not propagate on copy
+ * assignment, move assignment or swap, so a long lived container never silently adopts a short lived arena.
+ * Copy constructed containers use the same arena as their source.
+ */
+
+#pragma once
+
+// Includes
+#include <cstddef>			// std::ptrdiff_t
+#include <new>				// std::bad_array_new_length
+#include <type_traits>		// std::false_type
+
+#include "monotonic_buffer.h"	// non_stl::monotonic_buffer
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Template parameter T is the type of object allocated
+	template <class T>
+	class arena_allocator
+	{
+	public:
+		using value_type = T;
+		using size_type = ::size_type;
+		using difference_type = std::ptrdiff_t;
+
+		// The allocator sticks to the container it was first given to
+		using propagate_on_container_copy_assignment = std::false_type;
+		using propagate_on_container_move_assignment = std::false_type;
+		using propagate_on_container_swap = std::false_type;
+		using is_always_equal = std::false_type;
+
+		template <class U>
+		struct rebind
+		{
+			using other = arena_allocator<U>;
+		};
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Constructs an allocator which allocates from buffer
+		// buffer must outlive every container using this allocator
+		arena_allocator(monotonic_buffer& buffer) noexcept : _buffer(&buffer) {}
+
+		// Rebinding copy constructor
+		template <class U>
+		arena_allocator(const arena_allocator<U>& other) noexcept : _buffer(other.buffer()) {}
+
+		// ---------------
+		// ALLOCATION
+		// ---------------
+
+		// Returns storage for n objects of type T
+		// Throws std::bad_array_new_length when n objects don't fit in a size_type, as std::allocator does
+		T* allocate(size_type n)
+		{
+			if (n > static_cast<size_type>(-1) / sizeof(T))
+			{
+				throw std::bad_array_new_length();
+			}
+			return static_cast<T*>(_buffer->allocate_bytes(n * sizeof(T), alignof(T)));
+		}
+
+		// No-op, the memory is reclaimed by monotonic_buffer::release
+		void deallocate(T* /*p*/, size_type /*n*/) noexcept {}
+
+		// Copy constructed containers allocate from the same arena
+		arena_allocator select_on_container_copy_construction() const noexcept
+		{
+			return *this;
+		}
+
+		// Returns the buffer being allocated from
+		monotonic_buffer* buffer() const noexcept
+		{
+			return _buffer;
+		}
+
+	private:
+		monotonic_buffer* _buffer;
+	};
+
+	// Two arena allocators are equal when they allocate from the same buffer
+	template <class T, class U>
+	bool operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept
+	{
+		return lhs.buffer() == rhs.buffer();
+	}
+
+	template <class T, class U>
+	bool operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+}
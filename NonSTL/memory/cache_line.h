@@ -0,0 +1,21 @@
+// cache_line.h
+// Cache line size used to pad data shared between threads.
+
+/*
+ * Two threads writing to different variables which share a cache line still contend for that line
+ * (false sharing). Concurrent containers align their per thread members to cache_line_size to keep them apart.
+ * 64 bytes matches x86-64 and most ARM cores. std::hardware_destructive_interference_size is not used
+ * as its value may differ between compilations, which would change the layout of the containers.
+ */
+
+#pragma once
+
+// Includes
+#include <cstddef>			// size_t
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	inline constexpr size_type cache_line_size = 64;
+}
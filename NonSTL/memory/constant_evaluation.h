@@ -0,0 +1,38 @@
+// constant_evaluation.h
+// Helpers for containers which are usable during constant evaluation.
+
+/*
+ * C++20 allows memory obtained from std::allocator inside a constant expression as long as it is
+ * released before the evaluation ends (transient allocation). NON_STL_CONSTEXPR20 expands to constexpr
+ * where the standard library supports this and to nothing otherwise, so the allocating containers
+ * stay valid C++17.
+ * The fast paths (memcpy, memset, SIMD stores, placement new) can't run during constant evaluation,
+ * non_stl::is_constant_evaluated lets them fall back to constructing elements one at a time.
+ */
+
+#pragma once
+
+// Includes
+#include <memory>			// __cpp_lib_constexpr_dynamic_alloc
+#include <type_traits>		// std::is_constant_evaluated
+
+#if defined(__cpp_lib_constexpr_dynamic_alloc) && defined(__cpp_lib_is_constant_evaluated)
+#define NON_STL_CONSTEXPR_DYNAMIC_ALLOC 1
+#define NON_STL_CONSTEXPR20 constexpr
+#else
+#define NON_STL_CONSTEXPR20
+#endif
+
+namespace non_stl
+{
+	// Returns true when called during constant evaluation
+	// Always false before C++20, where nothing allocating can be constant evaluated anyway
+	constexpr bool is_constant_evaluated() noexcept
+	{
+#if defined(__cpp_lib_is_constant_evaluated)
+		return std::is_constant_evaluated();
+#else
+		return false;
+#endif
+	}
+}
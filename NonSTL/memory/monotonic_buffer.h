@@ -0,0 +1,287 @@
+// monotonic_buffer.h
+// A non-stl header only implementation of a monotonic (bump pointer) memory resource.
+// Note, the standard is used for some components such as std::pmr::memory_resource
+
+/*
+ * A monotonic_buffer hands out memory by bumping a pointer through large chunks obtained from an upstream
+ * resource. Deallocation is a no-op, memory is only given back all at once by release() or the destructor.
+ * This makes it suited to per request arenas, every container built on the arena is freed by a single
+ * release() instead of one deallocate per allocation.
+ * It derives from std::pmr::memory_resource so it can back std::pmr::polymorphic_allocator and the
+ * non_stl::pmr container aliases. non_stl::arena_allocator uses it directly without virtual dispatch.
+ * This class is not thread safe.
+ */
+
+#pragma once
+
+// Includes
+#include <cstddef>			// std::max_align_t
+#include <memory>			// std::align
+#include <memory_resource>	// std::pmr::memory_resource, std::pmr::new_delete_resource
+#include <new>				// std::bad_alloc
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	class monotonic_buffer : public std::pmr::memory_resource
+	{
+	public:
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+
+		// Constructs an empty buffer which allocates its first chunk of initial_size bytes
+		// from upstream on first use. Each following chunk is twice the size of the previous one
+		explicit monotonic_buffer(size_type initial_size = 4096,
+			std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept;
+
+		// Constructs a buffer which serves allocations from the caller provided buffer first,
+		// e.g. a stack array, and only goes to upstream once it is exhausted
+		monotonic_buffer(void* buffer, size_type size,
+			std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept;
+
+		monotonic_buffer(const monotonic_buffer&) = delete;
+		monotonic_buffer& operator=(const monotonic_buffer&) = delete;
+
+		// ---------------
+		// DESTRUCTOR
+		// ---------------
+
+		// Returns every chunk to upstream
+		~monotonic_buffer() override;
+
+		// ---------------
+		// ALLOCATION
+		// ---------------
+
+		// Returns bytes of storage aligned to alignment
+		// Non virtual equivalent of allocate() used by arena_allocator
+		void* allocate_bytes(size_type bytes, size_type alignment = alignof(std::max_align_t));
+
+		// Invalidates every allocation made from the buffer at once
+		// When a caller buffer was provided every chunk is returned to upstream and allocation
+		// restarts from the caller buffer. Otherwise the largest chunk is kept so a buffer which
+		// is reused, e.g. once per request, stops going to upstream after a warm up
+		void release() noexcept;
+
+		// ---------------
+		// OBSERVERS
+		// ---------------
+
+		// Returns the amount of bytes handed out since construction or the last release()
+		size_type bytes_allocated() const noexcept;
+
+		// Returns the resource chunks are obtained from
+		std::pmr::memory_resource* upstream_resource() const noexcept;
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	private:
+		// Header stored at the start of every chunk obtained from upstream
+		struct chunk_header
+		{
+			chunk_header* next;
+			size_type size;
+		};
+
+		// Obtains a chunk from upstream big enough for bytes at alignment and makes it current
+		void allocate_chunk(size_type bytes, size_type alignment);
+
+		// Returns every chunk after keep to upstream, or every chunk if keep is nullptr
+		void free_chunks(chunk_header* keep) noexcept;
+
+		// Makes the space following the header of chunk the current space
+		void use_chunk(chunk_header* chunk) noexcept;
+
+		// Member variables
+
+		// Resource chunks are allocated from
+		std::pmr::memory_resource* _upstream;
+
+		// Caller provided buffer, nullptr if there is none
+		void* _initial_buffer;
+		size_type _initial_size;
+
+		// Most recently allocated chunk, which is also the largest
+		chunk_header* _chunks;
+
+		// Size of the next chunk requested from upstream
+		size_type _next_chunk_size;
+
+		// Bump pointer and the space left after it in the current chunk
+		unsigned char* _current;
+		size_type _remaining;
+
+		// Bytes handed out since the last release
+		size_type _allocated;
+	};
+
+	// MONOTONIC BUFFER IMPL
+
+	// ---------------
+	// CONSTRUCTORS
+	// ---------------
+	inline monotonic_buffer::monotonic_buffer(size_type initial_size, std::pmr::memory_resource* upstream) noexcept :
+		_upstream(upstream),
+		_initial_buffer(nullptr),
+		_initial_size(0),
+		_chunks(nullptr),
+		_next_chunk_size(initial_size > sizeof(chunk_header) ? initial_size : 2 * sizeof(chunk_header)),
+		_current(nullptr),
+		_remaining(0),
+		_allocated(0)
+	{
+
+	}
+
+	inline monotonic_buffer::monotonic_buffer(void* buffer, size_type size, std::pmr::memory_resource* upstream) noexcept :
+		_upstream(upstream),
+		_initial_buffer(buffer),
+		_initial_size(size),
+		_chunks(nullptr),
+		_next_chunk_size(2 * size > 4096 ? 2 * size : 4096),
+		_current(static_cast<unsigned char*>(buffer)),
+		_remaining(size),
+		_allocated(0)
+	{
+
+	}
+
+	// ---------------
+	// DESTRUCTOR
+	// ---------------
+	inline monotonic_buffer::~monotonic_buffer()
+	{
+		free_chunks(nullptr);
+	}
+
+	// ---------------
+	// ALLOCATION
+	// ---------------
+	inline void* monotonic_buffer::allocate_bytes(size_type bytes, size_type alignment)
+	{
+		void* p = _current;
+		size_type space = _remaining;
+
+		// Slow path, the current chunk can't fit the request
+		if (!std::align(alignment, bytes, p, space))
+		{
+			allocate_chunk(bytes, alignment);
+			p = _current;
+			space = _remaining;
+			std::align(alignment, bytes, p, space);
+		}
+
+		_current = static_cast<unsigned char*>(p) + bytes;
+		_remaining = space - bytes;
+		_allocated += bytes;
+		return p;
+	}
+
+	inline void monotonic_buffer::release() noexcept
+	{
+		_allocated = 0;
+
+		if (_initial_buffer || !_chunks)
+		{
+			free_chunks(nullptr);
+			_current = static_cast<unsigned char*>(_initial_buffer);
+			_remaining = _initial_size;
+			return;
+		}
+
+		// Keep only the newest chunk, it is the largest one
+		free_chunks(_chunks);
+		use_chunk(_chunks);
+	}
+
+	// ---------------
+	// OBSERVERS
+	// ---------------
+	inline size_type monotonic_buffer::bytes_allocated() const noexcept
+	{
+		return _allocated;
+	}
+
+	inline std::pmr::memory_resource* monotonic_buffer::upstream_resource() const noexcept
+	{
+		return _upstream;
+	}
+
+	// ---------------
+	// MEMORY RESOURCE
+	// ---------------
+	inline void* monotonic_buffer::do_allocate(size_t bytes, size_t alignment)
+	{
+		return allocate_bytes(bytes, alignment);
+	}
+
+	inline void monotonic_buffer::do_deallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/)
+	{
+		// Memory is only reclaimed by release()
+	}
+
+	inline bool monotonic_buffer::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+	{
+		return this == &other;
+	}
+
+	// ---------------
+	// PRIVATE
+	// ---------------
+	inline void monotonic_buffer::allocate_chunk(size_type bytes, size_type alignment)
+	{
+		// Leave room for the header and for aligning the first allocation
+		constexpr size_type max = static_cast<size_type>(-1);
+		if (bytes > max - sizeof(chunk_header) - alignment)
+		{
+			throw std::bad_alloc();
+		}
+		const size_type needed = sizeof(chunk_header) + bytes + alignment;
+
+		// Double up to the request, a request past half the address space gets a chunk of its own size
+		size_type size = _next_chunk_size;
+		while (size < needed)
+		{
+			size = size > max / 2 ? needed : size * 2;
+		}
+
+		auto chunk = static_cast<chunk_header*>(_upstream->allocate(size, alignof(std::max_align_t)));
+		chunk->next = _chunks;
+		chunk->size = size;
+		_chunks = chunk;
+		_next_chunk_size = size > max / 2 ? size : size * 2;
+
+		use_chunk(chunk);
+	}
+
+	inline void monotonic_buffer::free_chunks(chunk_header* keep) noexcept
+	{
+		chunk_header* chunk = keep ? keep->next : _chunks;
+		while (chunk)
+		{
+			chunk_header* next = chunk->next;
+			_upstream->deallocate(chunk, chunk->size, alignof(std::max_align_t));
+			chunk = next;
+		}
+
+		if (keep)
+		{
+			keep->next = nullptr;
+		}
+		else
+		{
+			_chunks = nullptr;
+		}
+	}
+
+	inline void monotonic_buffer::use_chunk(chunk_header* chunk) noexcept
+	{
+		_current = reinterpret_cast<unsigned char*>(chunk) + sizeof(chunk_header);
+		_remaining = chunk->size - sizeof(chunk_header);
+	}
+}
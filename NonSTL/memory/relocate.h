@@ -0,0 +1,128 @@
+// relocate.h
+// A non-stl header only set of helpers for relocating ranges of objects from one block
+// of storage into another, as happens when a container grows its underlying array.
+// Note, the standard is used for some components such as std::allocator_traits and type traits
+
+/*
+ * Relocation is a move construction into the destination followed by destruction of the source.
+ * For trivially relocatable types this is equivalent to copying the bytes, so the whole range
+ * is relocated with a single memcpy. Every other type is moved element by element using
+ * std::move_if_noexcept so that a throwing move constructor falls back to a copy and the
+ * source range is left intact if an exception is thrown.
+ * During constant evaluation every type takes the element by element path, as memcpy can't be used there.
+ */
+
+#pragma once
+
+// Includes
+#include <cstring>			// std::memcpy, std::memmove
+#include <memory>			// std::allocator_traits
+#include <type_traits>		// std::is_trivially_copyable
+#include <utility>			// std::move_if_noexcept
+
+#include "constant_evaluation.h"	// NON_STL_CONSTEXPR20, non_stl::is_constant_evaluated
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	// Trait which marks T as safe to relocate by copying its bytes and not running its destructor
+	// Defaults to std::is_trivially_copyable. Types which hold no self references (for example
+	// a handle wrapping a heap pointer) may specialize this to opt in to the memcpy fast path
+	template <class T>
+	struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+	template <class T>
+	inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+	// Relocates n objects starting at first into the uninitialized storage starting at dest
+	// After the call the source range no longer holds any live objects
+	// If an exception is thrown the objects already constructed in dest are destroyed
+	// and the source range is left untouched
+	template <class T, class Alloc>
+	NON_STL_CONSTEXPR20 void relocate_n(Alloc& alloc, T* first, size_type n, T* dest)
+	{
+		if (n == 0)
+		{
+			return;
+		}
+
+		if constexpr (is_trivially_relocatable_v<T>)
+		{
+			if (!is_constant_evaluated())
+			{
+				std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), n * sizeof(T));
+				return;
+			}
+		}
+
+		using traits = std::allocator_traits<Alloc>;
+
+		size_type constructed = 0;
+		try
+		{
+			for (; constructed < n; ++constructed)
+			{
+				traits::construct(alloc, dest + constructed, std::move_if_noexcept(first[constructed]));
+			}
+		}
+		catch (...)
+		{
+			// Roll back the partially built destination, source is still valid
+			for (size_type i = 0; i < constructed; ++i)
+			{
+				traits::destroy(alloc, dest + i);
+			}
+			throw;
+		}
+
+		// Every element now lives in dest so end the lifetime of the originals
+		for (size_type i = 0; i < n; ++i)
+		{
+			traits::destroy(alloc, first + i);
+		}
+	}
+
+	// Relocates n objects starting at first to dest where the two ranges may overlap,
+	// as happens when a gap is opened or closed inside a single array
+	// Objects are walked in the direction which never overwrites a source before it is moved
+	// Unlike relocate_n there is no rollback, if an element throws while being moved the
+	// range is left partially relocated
+	template <class T, class Alloc>
+	NON_STL_CONSTEXPR20 void relocate_overlapping_n(Alloc& alloc, T* first, size_type n, T* dest)
+	{
+		if (n == 0 || first == dest)
+		{
+			return;
+		}
+
+		if constexpr (is_trivially_relocatable_v<T>)
+		{
+			if (!is_constant_evaluated())
+			{
+				std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), n * sizeof(T));
+				return;
+			}
+		}
+
+		using traits = std::allocator_traits<Alloc>;
+
+		if (dest > first)
+		{
+			// Moving towards the end, start from the last element
+			for (size_type i = n; i > 0; --i)
+			{
+				traits::construct(alloc, dest + i - 1, std::move_if_noexcept(first[i - 1]));
+				traits::destroy(alloc, first + i - 1);
+			}
+		}
+		else
+		{
+			for (size_type i = 0; i < n; ++i)
+			{
+				traits::construct(alloc, dest + i, std::move_if_noexcept(first[i]));
+				traits::destroy(alloc, first + i);
+			}
+		}
+	}
+}
@@ -0,0 +1,573 @@
+// socket_buffer.h
+// A non-stl header only zero copy socket buffer doing scatter / gather I/O straight into and out of
+// a circular buffer of bytes, with in place parsing of length prefixed messages.
+// Note, this component relies on POSIX readv / writev and is only available on POSIX systems
+
+/*
+ * A basic_socket_buffer wraps a ring of std::byte, a circular_buffer<std::byte, N> for socket_buffer<N>
+ * or a dynamic_circular_buffer<std::byte> for dynamic_socket_buffer. recv() reads with a single readv
+ * into the at most two runs of free slots after the newest byte, send() writes with a single writev
+ * from the at most two runs of bytes held, so data never goes through an intermediate array.
+ * length_prefixed_framing then finds whole messages in the bytes held and hands out their payload as
+ * spans into the ring, which are valid until the message is popped.
+ * prepare_recv() / commit_recv() and prepare_send() / commit_send() split each call in two for other
+ * I/O backends. Defining NON_STL_IO_URING adds functions queueing them on an io_uring from liburing,
+ * so the buffers of many sockets are submitted in a batch.
+ * A buffer is meant for one direction, either received into then parsed, or filled then sent, and
+ * nothing may be popped from it while a queued recv or send has not completed.
+ * send() does not block SIGPIPE, servers usually ignore it process wide.
+ * This class is not thread safe.
+ */
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Includes
+#include <algorithm>		// std::min, std::copy_n
+#include <cerrno>			// errno, EINTR, EAGAIN, EWOULDBLOCK, ENOBUFS
+#include <cstddef>			// std::byte
+#include <cstdint>			// std::uint32_t
+#include <limits>			// std::numeric_limits
+#include <memory>			// std::allocator
+#include <type_traits>		// std::is_unsigned
+#include <utility>			// std::forward
+
+#include <sys/types.h>		// ssize_t
+#include <sys/uio.h>		// readv, writev, iovec
+
+#if defined(NON_STL_IO_URING)
+#include <liburing.h>		// io_uring, io_uring_get_sqe, io_uring_prep_readv, io_uring_prep_writev
+#endif
+
+#include "../containers/circular_buffer.h"			// non_stl::circular_buffer
+#include "../containers/dynamic_circular_buffer.h"	// non_stl::dynamic_circular_buffer
+#include "../containers/span.h"						// non_stl::span
+
+using size_type = size_t;
+
+namespace non_stl
+{
+	namespace net
+	{
+		// Outcome of a recv or send
+		struct io_result
+		{
+			// Bytes read into or written from the buffer
+			size_type bytes = 0;
+
+			// errno of the failed call, 0 on success
+			// ENOBUFS when recv found the buffer full
+			int error = 0;
+
+			// Whether the peer closed its end, only set by recv
+			bool eof = false;
+
+			// Returns whether the call failed only because the socket is non blocking and wasn't ready
+			bool would_block() const noexcept { return error == EAGAIN || error == EWOULDBLOCK; }
+
+			// Returns whether the call neither failed nor reached the end of the stream
+			explicit operator bool() const noexcept { return error == 0 && !eof; }
+		};
+
+		// Template parameter Ring is a circular buffer of std::byte providing array_one / array_two,
+		// free_one / free_two, commit_back and pop_front_n
+		template <class Ring>
+		class basic_socket_buffer
+		{
+			// ---------------
+			// BEGIN INTERFACE
+			// ---------------
+		public:
+			using ring_type = Ring;
+
+			// ---------------
+			// CONSTRUCTORS
+			// ---------------
+
+			// Constructs the ring from args, e.g. the capacity of a dynamic_circular_buffer
+			template <class... Args>
+			explicit basic_socket_buffer(Args&& ... args);
+
+			basic_socket_buffer(const basic_socket_buffer&) = delete;
+			basic_socket_buffer& operator=(const basic_socket_buffer&) = delete;
+
+			// ---------------
+			// ELEMENT ACCESS
+			// ---------------
+
+			// Returns the ring holding the bytes, oldest first
+			Ring& ring() noexcept;
+			const Ring& ring() const noexcept;
+
+			// ---------------
+			// CAPACITY
+			// ---------------
+
+			// Returns the amount of bytes held
+			size_type size() const noexcept;
+
+			// Returns whether no bytes are held
+			bool empty() const noexcept;
+
+			// Returns the amount of bytes recv can still read
+			size_type available() const noexcept;
+
+			// ---------------
+			// MODIFIERS
+			// ---------------
+
+			// Reads once from fd into the free slots and appends what was read, retrying on EINTR
+			io_result recv(int fd) noexcept;
+
+			// Writes once the bytes held to fd and removes what was written, retrying on EINTR
+			io_result send(int fd) noexcept;
+
+			// Returns the free slots as at most two iovecs, valid until the next prepare_recv()
+			// Empty when the buffer is full
+			span<const iovec> prepare_recv() noexcept;
+
+			// Turns the result of reading into prepare_recv(), a byte count or -errno, into an io_result
+			// and appends the bytes read
+			io_result commit_recv(ssize_t result) noexcept;
+
+			// Returns the bytes held as at most two iovecs, valid until the next prepare_send()
+			span<const iovec> prepare_send() noexcept;
+
+			// Turns the result of writing prepare_send(), a byte count or -errno, into an io_result
+			// and removes the bytes written
+			io_result commit_send(ssize_t result) noexcept;
+
+			// Removes up to n bytes from the front, returns the amount removed
+			size_type consume(size_type n) noexcept;
+
+			// ---------------
+			// END INTERFACE
+			// ---------------
+		private:
+			// Fills iov with the non empty spans of one and two and returns how many it used
+			template <class T>
+			static size_type to_iovecs(iovec (&iov)[2], span<T> one, span<T> two) noexcept;
+
+			Ring _ring;
+
+			// Kept in the buffer so a queued call can refer to them until it completes
+			iovec _recv_iov[2];
+			iovec _send_iov[2];
+		};
+
+		// A socket buffer of N bytes held inline
+		template <size_type N>
+		using socket_buffer = basic_socket_buffer<circular_buffer<std::byte, N> >;
+
+		// A socket buffer whose capacity is a constructor argument
+		template <class Alloc = std::allocator<std::byte> >
+		using dynamic_socket_buffer = basic_socket_buffer<dynamic_circular_buffer<std::byte, Alloc> >;
+
+		// Byte order of the length prefix
+		enum class byte_order
+		{
+			big,
+			little
+		};
+
+		// What length_prefixed_framing found at the front of a buffer
+		enum class frame_status
+		{
+			// A whole message is held
+			complete,
+
+			// More bytes have to be received first
+			incomplete,
+
+			// The length is over the limit or the message can never fit in the buffer
+			too_large
+		};
+
+		// The payload of a message inside a ring, in two runs when it wraps past the end of the ring
+		struct frame
+		{
+			span<const std::byte> one;
+			span<const std::byte> two;
+
+			// Returns the length of the payload
+			size_type size() const noexcept { return one.size() + two.size(); }
+
+			// Returns whether the payload is a single run, i.e. two is empty
+			bool contiguous() const noexcept { return two.empty(); }
+
+			// Copies the payload to dest, which must hold size() bytes
+			void copy_to(std::byte* dest) const noexcept;
+		};
+
+		// Messages made of an unsigned Length in Order followed by that many bytes of payload
+		// Template parameter Length is the unsigned integer type of the prefix, e.g. std::uint16_t
+		template <class Length = std::uint32_t, byte_order Order = byte_order::big>
+		class length_prefixed_framing
+		{
+			static_assert(std::is_unsigned<Length>::value, "length_prefixed_framing requires an unsigned length");
+
+			// ---------------
+			// BEGIN INTERFACE
+			// ---------------
+		public:
+			// Bytes taken by the prefix
+			static constexpr size_type header_size = sizeof(Length);
+
+			// ---------------
+			// CONSTRUCTORS
+			// ---------------
+
+			// Refuses payloads longer than max_length
+			explicit length_prefixed_framing(size_type max_length = std::numeric_limits<Length>::max()) noexcept;
+
+			// ---------------
+			// MODIFIERS
+			// ---------------
+
+			// Looks for a whole message at the front of ring and when there is one points out at its payload
+			// Nothing is copied but the prefix
+			template <class Ring>
+			frame_status next(const Ring& ring, frame& out) const noexcept;
+
+			// Removes the message out returned by next() from the front of ring
+			template <class Ring>
+			void pop(Ring& ring, const frame& out) const noexcept;
+
+			// Appends payload to ring as a message, returns false and appends nothing if it doesn't fit
+			// in the free slots or is longer than the limit, so nothing held is ever overwritten
+			template <class Ring>
+			bool push(Ring& ring, span<const std::byte> payload) const noexcept;
+
+			// Overloads taking a socket buffer
+			template <class Ring>
+			frame_status next(const basic_socket_buffer<Ring>& buffer, frame& out) const noexcept;
+			template <class Ring>
+			void pop(basic_socket_buffer<Ring>& buffer, const frame& out) const noexcept;
+			template <class Ring>
+			bool push(basic_socket_buffer<Ring>& buffer, span<const std::byte> payload) const noexcept;
+
+			// ---------------
+			// END INTERFACE
+			// ---------------
+		private:
+			size_type _max_length;
+		};
+
+#if defined(NON_STL_IO_URING)
+		// Queues a readv into the free slots of buffer on uring, to be submitted with the next io_uring_submit
+		// Returns false if the submission queue is full or the buffer has no free slot
+		template <class Ring>
+		bool queue_recv(io_uring& uring, int fd, basic_socket_buffer<Ring>& buffer, void* user_data) noexcept;
+
+		// Queues a writev of the bytes held by buffer on uring, to be submitted with the next io_uring_submit
+		// Returns false if the submission queue is full or the buffer is empty
+		template <class Ring>
+		bool queue_send(io_uring& uring, int fd, basic_socket_buffer<Ring>& buffer, void* user_data) noexcept;
+#endif
+
+		// ---------------
+		// PRIVATE
+		// ---------------
+		namespace detail
+		{
+			// Returns the n bytes starting offset bytes into the two runs one and two, in two runs
+			inline frame slice(span<const std::byte> one, span<const std::byte> two, size_type offset, size_type n) noexcept
+			{
+				if (offset >= one.size()) {
+					return frame{ span<const std::byte>(), two.subspan(offset - one.size(), n) };
+				}
+				const size_type first = std::min(n, one.size() - offset);
+				return frame{ one.subspan(offset, first), two.first(n - first) };
+			}
+		}
+
+		// SOCKET BUFFER IMPL
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+		template <class Ring>
+		template <class... Args>
+		basic_socket_buffer<Ring>::basic_socket_buffer(Args&& ... args) :
+			_ring(std::forward<Args>(args)...),
+			_recv_iov(),
+			_send_iov()
+		{
+		}
+
+		// ---------------
+		// ELEMENT ACCESS
+		// ---------------
+		template <class Ring>
+		Ring& basic_socket_buffer<Ring>::ring() noexcept
+		{
+			return _ring;
+		}
+
+		template <class Ring>
+		const Ring& basic_socket_buffer<Ring>::ring() const noexcept
+		{
+			return _ring;
+		}
+
+		// ---------------
+		// CAPACITY
+		// ---------------
+		template <class Ring>
+		size_type basic_socket_buffer<Ring>::size() const noexcept
+		{
+			return _ring.size();
+		}
+
+		template <class Ring>
+		bool basic_socket_buffer<Ring>::empty() const noexcept
+		{
+			return _ring.empty();
+		}
+
+		template <class Ring>
+		size_type basic_socket_buffer<Ring>::available() const noexcept
+		{
+			return _ring.capacity() - _ring.size();
+		}
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+		template <class Ring>
+		io_result basic_socket_buffer<Ring>::recv(int fd) noexcept
+		{
+			const span<const iovec> iov = prepare_recv();
+			if (iov.empty()) {
+				return commit_recv(-ENOBUFS);
+			}
+
+			ssize_t result;
+			do {
+				result = ::readv(fd, iov.data(), static_cast<int>(iov.size()));
+			} while (result < 0 && errno == EINTR);
+			return commit_recv(result < 0 ? -errno : result);
+		}
+
+		template <class Ring>
+		io_result basic_socket_buffer<Ring>::send(int fd) noexcept
+		{
+			const span<const iovec> iov = prepare_send();
+			if (iov.empty()) {
+				return io_result();
+			}
+
+			ssize_t result;
+			do {
+				result = ::writev(fd, iov.data(), static_cast<int>(iov.size()));
+			} while (result < 0 && errno == EINTR);
+			return commit_send(result < 0 ? -errno : result);
+		}
+
+		template <class Ring>
+		span<const iovec> basic_socket_buffer<Ring>::prepare_recv() noexcept
+		{
+			return span<const iovec>(_recv_iov, to_iovecs(_recv_iov, _ring.free_one(), _ring.free_two()));
+		}
+
+		template <class Ring>
+		io_result basic_socket_buffer<Ring>::commit_recv(ssize_t result) noexcept
+		{
+			io_result out;
+			if (result < 0) {
+				out.error = static_cast<int>(-result);
+			}
+			else if (result == 0) {
+				out.eof = true;
+			}
+			else {
+				out.bytes = static_cast<size_type>(result);
+				_ring.commit_back(out.bytes);
+			}
+			return out;
+		}
+
+		template <class Ring>
+		span<const iovec> basic_socket_buffer<Ring>::prepare_send() noexcept
+		{
+			const Ring& ring = _ring;
+			return span<const iovec>(_send_iov, to_iovecs(_send_iov, ring.array_one(), ring.array_two()));
+		}
+
+		template <class Ring>
+		io_result basic_socket_buffer<Ring>::commit_send(ssize_t result) noexcept
+		{
+			io_result out;
+			if (result < 0) {
+				out.error = static_cast<int>(-result);
+			}
+			else {
+				out.bytes = _ring.pop_front_n(static_cast<size_type>(result));
+			}
+			return out;
+		}
+
+		template <class Ring>
+		size_type basic_socket_buffer<Ring>::consume(size_type n) noexcept
+		{
+			return _ring.pop_front_n(n);
+		}
+
+		// ---------------
+		// PRIVATE
+		// ---------------
+		template <class Ring>
+		template <class T>
+		size_type basic_socket_buffer<Ring>::to_iovecs(iovec (&iov)[2], span<T> one, span<T> two) noexcept
+		{
+			size_type count = 0;
+			if (!one.empty()) {
+				iov[count].iov_base = const_cast<std::byte*>(one.data());
+				iov[count].iov_len = one.size();
+				++count;
+			}
+			if (!two.empty()) {
+				iov[count].iov_base = const_cast<std::byte*>(two.data());
+				iov[count].iov_len = two.size();
+				++count;
+			}
+			return count;
+		}
+
+		// FRAMING IMPL
+
+		inline void frame::copy_to(std::byte* dest) const noexcept
+		{
+			std::copy_n(one.data(), one.size(), dest);
+			std::copy_n(two.data(), two.size(), dest + one.size());
+		}
+
+		// ---------------
+		// CONSTRUCTORS
+		// ---------------
+		template <class Length, byte_order Order>
+		length_prefixed_framing<Length, Order>::length_prefixed_framing(size_type max_length) noexcept :
+			_max_length(max_length)
+		{
+		}
+
+		// ---------------
+		// MODIFIERS
+		// ---------------
+		template <class Length, byte_order Order>
+		template <class Ring>
+		frame_status length_prefixed_framing<Length, Order>::next(const Ring& ring, frame& out) const noexcept
+		{
+			const span<const std::byte> one = ring.array_one();
+			const span<const std::byte> two = ring.array_two();
+			if (ring.size() < header_size) {
+				return frame_status::incomplete;
+			}
+
+			// The prefix may wrap around as well
+			std::byte header[header_size];
+			detail::slice(one, two, 0, header_size).copy_to(header);
+
+			size_type length = 0;
+			for (size_type i = 0; i < header_size; ++i) {
+				const size_type b = std::to_integer<size_type>(header[Order == byte_order::big ? i : header_size - 1 - i]);
+				length = length << 8 | b;
+			}
+
+			if (length > _max_length || length > ring.capacity() - header_size) {
+				return frame_status::too_large;
+			}
+			if (ring.size() - header_size < length) {
+				return frame_status::incomplete;
+			}
+
+			out = detail::slice(one, two, header_size, length);
+			return frame_status::complete;
+		}
+
+		template <class Length, byte_order Order>
+		template <class Ring>
+		void length_prefixed_framing<Length, Order>::pop(Ring& ring, const frame& out) const noexcept
+		{
+			ring.pop_front_n(header_size + out.size());
+		}
+
+		template <class Length, byte_order Order>
+		template <class Ring>
+		bool length_prefixed_framing<Length, Order>::push(Ring& ring, span<const std::byte> payload) const noexcept
+		{
+			if (payload.size() > _max_length || payload.size() + header_size > ring.capacity() - ring.size()) {
+				return false;
+			}
+
+			std::byte header[header_size];
+			size_type length = payload.size();
+			for (size_type i = 0; i < header_size; ++i) {
+				header[Order == byte_order::big ? header_size - 1 - i : i] = static_cast<std::byte>(length & 0xFF);
+				length >>= 8;
+			}
+
+			ring.push_back_n(header, header_size);
+			ring.push_back_n(payload.data(), payload.size());
+			return true;
+		}
+
+		template <class Length, byte_order Order>
+		template <class Ring>
+		frame_status length_prefixed_framing<Length, Order>::next(const basic_socket_buffer<Ring>& buffer, frame& out) const noexcept
+		{
+			return next(buffer.ring(), out);
+		}
+
+		template <class Length, byte_order Order>
+		template <class Ring>
+		void length_prefixed_framing<Length, Order>::pop(basic_socket_buffer<Ring>& buffer, const frame& out) const noexcept
+		{
+			pop(buffer.ring(), out);
+		}
+
+		template <class Length, byte_order Order>
+		template <class Ring>
+		bool length_prefixed_framing<Length, Order>::push(basic_socket_buffer<Ring>& buffer, span<const std::byte> payload) const noexcept
+		{
+			return push(buffer.ring(), payload);
+		}
+
+#if defined(NON_STL_IO_URING)
+		// IO_URING IMPL
+
+		template <class Ring>
+		bool queue_recv(io_uring& uring, int fd, basic_socket_buffer<Ring>& buffer, void* user_data) noexcept
+		{
+			const span<const iovec> iov = buffer.prepare_recv();
+			io_uring_sqe* sqe = iov.empty() ? nullptr : io_uring_get_sqe(&uring);
+			if (sqe == nullptr) {
+				return false;
+			}
+
+			// The completion's res is what commit_recv expects
+			io_uring_prep_readv(sqe, fd, iov.data(), static_cast<unsigned>(iov.size()), 0);
+			io_uring_sqe_set_data(sqe, user_data);
+			return true;
+		}
+
+		template <class Ring>
+		bool queue_send(io_uring& uring, int fd, basic_socket_buffer<Ring>& buffer, void* user_data) noexcept
+		{
+			const span<const iovec> iov = buffer.prepare_send();
+			io_uring_sqe* sqe = iov.empty() ? nullptr : io_uring_get_sqe(&uring);
+			if (sqe == nullptr) {
+				return false;
+			}
+
+			// The completion's res is what commit_send expects
+			io_uring_prep_writev(sqe, fd, iov.data(), static_cast<unsigned>(iov.size()), 0);
+			io_uring_sqe_set_data(sqe, user_data);
+			return true;
+		}
+#endif
+	}
+}
+
+#endif
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../../algorithms/parallel.h"
+#include "../../algorithms/thread_pool.h"
+#include "../../containers/deque.h"
+#include "../../containers/vector.h"
+
+namespace parallel = non_stl::parallel;
+
+static std::vector<std::uint32_t> random_values(size_type n, std::uint32_t seed) {
+	std::mt19937 gen(seed);
+	std::vector<std::uint32_t> values(n);
+	for (auto& value : values) {
+		value = gen() % 1000;
+	}
+	return values;
+}
+
+TEST(thread_pool_test, run_covers_every_index_once) {
+	parallel::thread_pool pool(4);
+	EXPECT_EQ(pool.size(), 4);
+
+	for (size_type grain : { 1, 7, 64, 1000, 5000 }) {
+		std::vector<std::atomic<int> > hits(1000);
+		pool.run(hits.size(), grain, [&](size_type begin, size_type end) {
+			EXPECT_LE(end - begin, grain);
+			for (size_type i = begin; i < end; ++i) {
+				hits[i].fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+		for (const auto& hit : hits) {
+			EXPECT_EQ(hit.load(), 1);
+		}
+	}
+
+	bool called = false;
+	pool.run(0, 1, [&](size_type, size_type) { called = true; });
+	EXPECT_FALSE(called);
+}
+
+TEST(thread_pool_test, single_thread_runs_on_caller) {
+	parallel::thread_pool pool(1);
+	EXPECT_EQ(pool.size(), 1);
+
+	const auto caller = std::this_thread::get_id();
+	size_type total = 0;
+	pool.run(100, 10, [&](size_type begin, size_type end) {
+		EXPECT_EQ(std::this_thread::get_id(), caller);
+		total += end - begin;
+	});
+	EXPECT_EQ(total, 100);
+}
+
+TEST(thread_pool_test, rethrows_first_exception) {
+	parallel::thread_pool pool(4);
+	std::atomic<int> started(0);
+	EXPECT_THROW(pool.run(100, 1, [&](size_type begin, size_type) {
+		started.fetch_add(1);
+		if (begin == 10) {
+			throw std::runtime_error("chunk");
+		}
+	}), std::runtime_error);
+	EXPECT_LE(started.load(), 100);
+
+	// The pool stays usable
+	std::atomic<size_type> total(0);
+	pool.run(100, 1, [&](size_type begin, size_type end) { total += end - begin; });
+	EXPECT_EQ(total.load(), 100);
+}
+
+TEST(thread_pool_test, nested_runs_finish) {
+	parallel::thread_pool pool(4);
+	std::atomic<size_type> total(0);
+	pool.run(16, 1, [&](size_type, size_type) {
+		pool.run(64, 4, [&](size_type begin, size_type end) { total += end - begin; });
+	});
+	EXPECT_EQ(total.load(), 16 * 64);
+}
+
+TEST(parallel_test, for_each_and_transform) {
+	parallel::thread_pool pool(4);
+	const auto exec = parallel::par.on(pool);
+
+	non_stl::vector<int> vec(10000, 1);
+	parallel::for_each(exec, vec, [](int& value) { value += 2; });
+	EXPECT_TRUE(std::all_of(vec.begin(), vec.end(), [](int value) { return value == 3; }));
+
+	non_stl::deque<int> deq;
+	for (int i = 0; i < 5000; ++i) {
+		deq.push_back(i);
+	}
+	non_stl::vector<long> out(deq.size(), 0);
+	parallel::transform(exec.with_grain(3), deq, out, [](int value) { return value * 2L; });
+	for (size_type i = 0; i < out.size(); ++i) {
+		EXPECT_EQ(out[i], static_cast<long>(i) * 2);
+	}
+
+	non_stl::vector<int> empty;
+	parallel::for_each(exec, empty, [](int&) { FAIL(); });
+}
+
+TEST(parallel_test, reduce_matches_accumulate) {
+	parallel::thread_pool pool(4);
+	const auto values = random_values(100003, 1);
+
+	non_stl::vector<std::uint64_t> vec;
+	non_stl::deque<std::uint64_t> deq;
+	for (auto value : values) {
+		vec.push_back(value);
+		deq.push_back(value);
+	}
+	const auto expected = std::accumulate(values.begin(), values.end(), std::uint64_t(5));
+
+	for (size_type grain : { 0, 1, 100, 1000000 }) {
+		const auto exec = parallel::par.on(pool).with_grain(grain);
+		EXPECT_EQ(parallel::reduce(exec, vec, std::uint64_t(5)), expected);
+		EXPECT_EQ(parallel::reduce(exec, deq, std::uint64_t(5)), expected);
+	}
+
+	auto max = [](std::uint64_t lhs, std::uint64_t rhs) { return std::max(lhs, rhs); };
+	EXPECT_EQ(parallel::reduce(parallel::par.on(pool), vec, std::uint64_t(0), max),
+		*std::max_element(values.begin(), values.end()));
+
+	non_stl::vector<std::uint64_t> empty;
+	EXPECT_EQ(parallel::reduce(parallel::par.on(pool), empty, std::uint64_t(7)), 7);
+}
+
+TEST(parallel_test, sort_matches_std_sort) {
+	for (size_type threads : { 1, 3, 4 }) {
+		parallel::thread_pool pool(threads);
+		for (size_type n : { 0, 1, 2, 17, 1000, 65537 }) {
+			auto expected = random_values(n, static_cast<std::uint32_t>(n));
+
+			non_stl::vector<std::uint32_t> vec;
+			non_stl::deque<std::uint32_t> deq;
+			for (auto value : expected) {
+				vec.push_back(value);
+				deq.push_back(value);
+			}
+			std::sort(expected.begin(), expected.end(), std::greater<>());
+
+			parallel::sort(parallel::par.on(pool).with_grain(8), vec, std::greater<>());
+			parallel::sort(parallel::par.on(pool), deq, std::greater<>());
+			EXPECT_TRUE(std::equal(expected.begin(), expected.end(), vec.begin(), vec.end()));
+			EXPECT_TRUE(std::equal(expected.begin(), expected.end(), deq.begin(), deq.end()));
+		}
+	}
+}
+
+TEST(parallel_test, shared_pool) {
+	non_stl::vector<int> vec(1000, 2);
+	EXPECT_EQ(parallel::reduce(parallel::par, vec, 0), 2000);
+	EXPECT_GE(parallel::thread_pool::shared().size(), 1);
+}
+
+int main(int argc, char** argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../algorithms/simd.h"
+#include "../../containers/circular_buffer.h"
+#include "../../containers/dynamic_circular_buffer.h"
+#include "../../containers/vector.h"
+
+namespace simd = non_stl::simd;
+
+enum class level : std::uint16_t { low, high };
+
+// Every instruction set the CPU supports
+static std::vector<simd::isa> isas() {
+	std::vector<simd::isa> result{ simd::isa::scalar };
+	if (simd::detected_isa() >= simd::isa::avx2) {
+		result.push_back(simd::isa::avx2);
+	}
+	if (simd::detected_isa() >= simd::isa::avx512) {
+		result.push_back(simd::isa::avx512);
+	}
+	return result;
+}
+
+// Restores the detected instruction set when a test ends
+struct isa_guard {
+	~isa_guard() { simd::set_isa(simd::detected_isa()); }
+};
+
+// Compares every algorithm against <algorithm> over lengths on both sides of the vector widths
+// starting at unaligned offsets
+template <class T, class Make>
+static void check_algorithms(Make make) {
+	isa_guard guard;
+	std::mt19937 rng(7);
+
+	for (auto set : isas()) {
+		ASSERT_EQ(simd::set_isa(set), set);
+
+		for (size_t n = 0; n < 300; n += (n < 140 ? 1 : 37)) {
+			for (size_t offset = 0; offset < 3; ++offset) {
+				std::vector<T> storage(n + offset);
+				for (auto& value : storage) {
+					value = make(rng() % 9);
+				}
+				T* first = storage.data() + offset;
+				T* last = first + n;
+				const T needle = make(rng() % 9);
+
+				ASSERT_EQ(simd::find(first, last, needle), std::find(first, last, needle)) << n;
+				ASSERT_EQ(simd::count(first, last, needle), static_cast<size_t>(std::count(first, last, needle))) << n;
+
+				std::vector<T> expected(first, last);
+				std::replace(expected.begin(), expected.end(), needle, make(8));
+				simd::replace(first, last, needle, make(8));
+				ASSERT_TRUE(std::equal(first, last, expected.begin())) << n;
+
+				simd::fill(first, last, needle);
+				ASSERT_EQ(std::count(first, last, needle), static_cast<std::ptrdiff_t>(n));
+				ASSERT_EQ(storage.size() - n, static_cast<size_t>(offset));
+			}
+		}
+	}
+}
+
+template <class T>
+static void check_arithmetic() {
+	isa_guard guard;
+	std::mt19937_64 rng(3);
+
+	for (auto set : isas()) {
+		simd::set_isa(set);
+
+		for (size_t n = 0; n < 300; n += (n < 140 ? 1 : 37)) {
+			std::vector<T> values(n);
+			for (auto& value : values) {
+				value = static_cast<T>(rng());
+			}
+			// Plant repeated extremes so the first one has to be picked
+			if (n > 4) {
+				values[n / 2] = values[n - 1] = std::numeric_limits<T>::min();
+				values[1] = values[n - 2] = std::numeric_limits<T>::max();
+			}
+			const T* first = values.data();
+			const T* last = first + n;
+
+			ASSERT_EQ(simd::min_element(first, last), std::min_element(first, last)) << n;
+			ASSERT_EQ(simd::max_element(first, last), std::max_element(first, last)) << n;
+
+			// Sum in the unsigned counterpart as the wrapped around reference
+			using U = std::make_unsigned_t<T>;
+			U expected = 0;
+			for (auto value : values) {
+				expected = static_cast<U>(expected + static_cast<U>(value));
+			}
+			ASSERT_EQ(static_cast<U>(simd::accumulate(first, last, T(0))), expected) << n;
+		}
+	}
+}
+
+// Pointer ranges
+
+TEST(SimdPointerTest, Bitwise) {
+	check_algorithms<std::uint8_t>([](unsigned v) { return static_cast<std::uint8_t>(v); });
+	check_algorithms<char>([](unsigned v) { return static_cast<char>('a' + v); });
+	check_algorithms<std::int16_t>([](unsigned v) { return static_cast<std::int16_t>(-static_cast<int>(v)); });
+	check_algorithms<std::uint32_t>([](unsigned v) { return v * 0x01010101u; });
+	check_algorithms<std::int64_t>([](unsigned v) { return static_cast<std::int64_t>(v) << 40; });
+	check_algorithms<level>([](unsigned v) { return v % 2 ? level::high : level::low; });
+}
+
+TEST(SimdPointerTest, Scalar) {
+	// Types which are not vectorized still give the same results
+	check_algorithms<double>([](unsigned v) { return v * 0.5; });
+	check_algorithms<std::string>([](unsigned v) { return std::string(v, 'x'); });
+}
+
+TEST(SimdPointerTest, Arithmetic) {
+	check_arithmetic<std::int8_t>();
+	check_arithmetic<std::uint8_t>();
+	check_arithmetic<std::int16_t>();
+	check_arithmetic<std::uint16_t>();
+	check_arithmetic<std::int32_t>();
+	check_arithmetic<std::uint32_t>();
+	check_arithmetic<std::int64_t>();
+	check_arithmetic<std::uint64_t>();
+}
+
+TEST(SimdPointerTest, Accumulate) {
+	std::vector<std::uint8_t> bytes(1000, 200);
+	// A wider init is summed in its own type as std::accumulate would
+	ASSERT_EQ(simd::accumulate(bytes.data(), bytes.data() + bytes.size(), 0), 200000);
+	ASSERT_EQ(simd::accumulate(bytes.data(), bytes.data() + bytes.size(), std::uint8_t(0)), std::uint8_t(200000 % 256));
+
+	std::vector<float> floats{ 0.5f, 1.5f, 2.0f };
+	ASSERT_FLOAT_EQ(simd::accumulate(floats.data(), floats.data() + floats.size(), 0.0f), 4.0f);
+}
+
+TEST(SimdPointerTest, NaN) {
+	// Unordered values give the positions of std::min_element and std::max_element, never end
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	std::vector<double> values{ nan, 3.0, 1.0, 2.0 };
+	const double* first = values.data();
+	const double* last = first + values.size();
+	ASSERT_EQ(simd::min_element(first, last), std::min_element(first, last));
+	ASSERT_EQ(simd::max_element(first, last), std::max_element(first, last));
+	ASSERT_EQ(simd::min_element(values), 0);
+	ASSERT_EQ(simd::max_element(values), 0);
+
+	values = { 1.0, nan, 0.5, nan, 4.0 };
+	ASSERT_EQ(simd::min_element(values.data(), values.data() + values.size()) - values.data(), 2);
+	ASSERT_EQ(simd::max_element(values), 4);
+
+	// Across the two runs of a circular buffer the result is that of a single pass
+	non_stl::circular_buffer<double, 4> buffer;
+	for (double v : { 9.0, 9.0, 1.0, nan, 0.5, 7.0 }) {
+		buffer.push_back(v);
+	}
+	ASSERT_FALSE(buffer.array_two().empty());
+	ASSERT_EQ(simd::min_element(buffer), 2);
+	ASSERT_EQ(simd::max_element(buffer), 3);
+}
+
+TEST(SimdPointerTest, AccumulateWraps) {
+	// Signed sums of the element type wrap around on every instruction set
+	isa_guard guard;
+	std::vector<std::int32_t> values(1000, std::numeric_limits<std::int32_t>::max());
+	const auto expected = static_cast<std::int32_t>(static_cast<std::uint32_t>(std::numeric_limits<std::int32_t>::max()) * 1000u + 5u);
+	for (auto isa : isas()) {
+		simd::set_isa(isa);
+		ASSERT_EQ(simd::accumulate(values.data(), values.data() + values.size(), std::int32_t(5)), expected);
+	}
+}
+
+TEST(SimdPointerTest, Isa) {
+	isa_guard guard;
+	ASSERT_EQ(simd::active_isa(), simd::detected_isa());
+	ASSERT_EQ(simd::set_isa(simd::isa::scalar), simd::isa::scalar);
+	ASSERT_EQ(simd::active_isa(), simd::isa::scalar);
+	ASSERT_EQ(simd::set_isa(simd::isa::avx512), simd::detected_isa());
+}
+
+// Ranges
+
+TEST(SimdRangeTest, Vector) {
+	non_stl::vector<std::uint32_t> v;
+	for (std::uint32_t i = 0; i < 1000; ++i) {
+		v.push_back(i % 100);
+	}
+
+	ASSERT_EQ(simd::find(v, 42), 42);
+	ASSERT_EQ(simd::find(v, 1000), v.size());
+	ASSERT_EQ(simd::count(v, 7), 10);
+	ASSERT_EQ(simd::min_element(v), 0);
+	ASSERT_EQ(simd::max_element(v), 99);
+	ASSERT_EQ(simd::accumulate(v, std::uint64_t(0)), 49500);
+
+	simd::replace(v, 7, 8);
+	ASSERT_EQ(simd::count(v, 8), 20);
+
+	simd::fill(v, 3);
+	ASSERT_EQ(simd::count(v, 3), v.size());
+
+	const std::vector<int> empty;
+	ASSERT_EQ(simd::find(empty, 1), 0);
+	ASSERT_EQ(simd::min_element(empty), 0);
+}
+
+TEST(SimdRangeTest, CircularBuffer) {
+	// Wrapped around so both runs hold elements
+	non_stl::circular_buffer<int, 128> buffer;
+	for (int i = 0; i < 200; ++i) {
+		buffer.push_back(i);
+	}
+	ASSERT_FALSE(buffer.array_two().empty());
+
+	ASSERT_EQ(simd::find(buffer, 72), 0);
+	ASSERT_EQ(simd::find(buffer, 199), 127);
+	ASSERT_EQ(buffer[simd::find(buffer, 150)], 150);
+	ASSERT_EQ(simd::find(buffer, 10), buffer.size());
+	ASSERT_EQ(simd::count(buffer, 130), 1);
+	ASSERT_EQ(simd::min_element(buffer), 0);
+	ASSERT_EQ(simd::max_element(buffer), 127);
+	ASSERT_EQ(simd::accumulate(buffer, 0), (72 + 199) * 128 / 2);
+
+	simd::replace(buffer, 199, 72);
+	ASSERT_EQ(simd::count(buffer, 72), 2);
+	ASSERT_EQ(simd::min_element(buffer), 0);
+	ASSERT_EQ(simd::max_element(buffer), 126);
+
+	non_stl::dynamic_circular_buffer<std::uint8_t> bytes(100);
+	for (int i = 0; i < 150; ++i) {
+		bytes.push_back(static_cast<std::uint8_t>(i % 7));
+	}
+	simd::fill(bytes, std::uint8_t(9));
+	ASSERT_EQ(simd::count(bytes, 9), bytes.size());
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
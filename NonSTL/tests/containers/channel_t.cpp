@@ -0,0 +1,298 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../containers/channel.h"
+
+// A coroutine which starts straight away and frees itself once done
+struct task {
+	struct promise_type {
+		task get_return_object() noexcept { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+// Queues the coroutines posted to it until run() resumes them
+struct manual_executor {
+	std::deque<std::coroutine_handle<> > queue;
+
+	void post(std::coroutine_handle<> h) { queue.push_back(h); }
+
+	size_t run() {
+		size_t resumed = 0;
+		while (!queue.empty()) {
+			std::coroutine_handle<> h = queue.front();
+			queue.pop_front();
+			h.resume();
+			++resumed;
+		}
+		return resumed;
+	}
+};
+
+template <class Channel>
+task receive_all(Channel& ch, std::vector<int>& out, bool& finished) {
+	while (std::optional<int> v = co_await ch.recv()) {
+		out.push_back(*v);
+	}
+	finished = true;
+}
+
+template <class Channel>
+task send_all(Channel& ch, int first, int last, int& sent) {
+	for (int i = first; i < last; ++i) {
+		if (!co_await ch.send(i)) {
+			co_return;
+		}
+		++sent;
+	}
+}
+
+// Non awaiting
+
+TEST(ChannelTryTest, Basic) {
+	non_stl::channel<std::string, 2> ch;
+	ASSERT_EQ(ch.capacity(), 2);
+	ASSERT_TRUE(ch.empty());
+
+	ASSERT_TRUE(ch.try_send(std::string("a")));
+	std::string b = "b";
+	ASSERT_TRUE(ch.try_send(b));
+	ASSERT_EQ(b, "b");
+
+	// Full, the element is left untouched
+	std::string c = "c";
+	ASSERT_FALSE(ch.try_send(std::move(c)));
+	ASSERT_EQ(c, "c");
+	ASSERT_EQ(ch.size(), 2);
+
+	std::string out;
+	ASSERT_TRUE(ch.try_recv(out));
+	ASSERT_EQ(out, "a");
+
+	std::string outs[4];
+	ASSERT_EQ(ch.try_recv_n(outs, 4), 1);
+	ASSERT_EQ(outs[0], "b");
+	ASSERT_FALSE(ch.try_recv(out));
+
+	ch.close();
+	ASSERT_TRUE(ch.closed());
+	ASSERT_FALSE(ch.try_send(std::string("d")));
+}
+
+// Awaiting
+
+TEST(ChannelRecvTest, Basic) {
+	non_stl::channel<int, 4> ch;
+	std::vector<int> received;
+	bool finished = false;
+
+	// Suspends on the empty ring
+	receive_all(ch, received, finished);
+	ASSERT_TRUE(received.empty());
+
+	// Each send hands its element over to the waiting receiver, which runs inline until it waits again
+	ASSERT_TRUE(ch.try_send(1));
+	ASSERT_EQ(received, std::vector<int>({ 1 }));
+	ASSERT_TRUE(ch.try_send(2));
+	ASSERT_TRUE(ch.empty());
+
+	ch.close();
+	ASSERT_TRUE(finished);
+	ASSERT_EQ(received, std::vector<int>({ 1, 2 }));
+}
+
+TEST(ChannelSendTest, Basic) {
+	non_stl::channel<int, 2> ch;
+	int sent = 0;
+
+	// Suspends once the ring holds two elements
+	send_all(ch, 0, 5, sent);
+	ASSERT_EQ(sent, 2);
+
+	// Each slot freed takes the element of the waiting sender
+	int v = -1;
+	ASSERT_TRUE(ch.try_recv(v));
+	ASSERT_EQ(v, 0);
+	ASSERT_EQ(sent, 3);
+	ASSERT_EQ(ch.size(), 2);
+
+	int out[8];
+	ASSERT_EQ(ch.try_recv_n(out, 8), 2);
+	ASSERT_EQ(out[0], 1);
+	ASSERT_EQ(out[1], 2);
+	ASSERT_EQ(sent, 5);
+
+	ASSERT_EQ(ch.try_recv_n(out, 8), 2);
+	ASSERT_EQ(out[1], 4);
+	ASSERT_TRUE(ch.empty());
+}
+
+TEST(ChannelCloseTest, Basic) {
+	non_stl::channel<int, 2> ch;
+	int sent = 0;
+	send_all(ch, 0, 10, sent);
+	ASSERT_EQ(sent, 2);
+
+	// The waiting sender fails, the elements held are still received
+	ch.close();
+	ASSERT_EQ(sent, 2);
+
+	std::vector<int> received;
+	bool finished = false;
+	receive_all(ch, received, finished);
+	ASSERT_TRUE(finished);
+	ASSERT_EQ(received, std::vector<int>({ 0, 1 }));
+
+	// Sends after close fail straight away
+	int late = 0;
+	send_all(ch, 0, 1, late);
+	ASSERT_EQ(late, 0);
+}
+
+template <class Channel>
+task receive_batches(Channel& ch, std::vector<size_t>& batches, std::vector<int>& out) {
+	int buf[8];
+	while (size_t n = co_await ch.recv_n(buf, 8)) {
+		batches.push_back(n);
+		out.insert(out.end(), buf, buf + n);
+	}
+}
+
+TEST(ChannelRecvNTest, Basic) {
+	manual_executor executor;
+	non_stl::channel<int, 16> ch(executor);
+
+	std::vector<size_t> batches;
+	std::vector<int> received;
+	receive_batches(ch, batches, received);
+	ASSERT_TRUE(executor.queue.empty());
+
+	// The receiver is woken with the first element and posted, by the time it runs the rest is drained
+	for (int i = 0; i < 5; ++i) {
+		ASSERT_TRUE(ch.try_send(i));
+	}
+	ASSERT_TRUE(batches.empty());
+	ASSERT_EQ(executor.run(), 1);
+	ASSERT_EQ(batches, std::vector<size_t>({ 5 }));
+	ASSERT_EQ(received, std::vector<int>({ 0, 1, 2, 3, 4 }));
+
+	ch.close();
+	ASSERT_EQ(executor.run(), 1);
+	ASSERT_EQ(batches.size(), 1);
+}
+
+TEST(ChannelExecutorTest, Basic) {
+	manual_executor executor;
+	non_stl::channel<int, 2> ch(executor);
+
+	int sent = 0;
+	std::vector<int> received;
+	bool finished = false;
+	send_all(ch, 0, 100, sent);
+	receive_all(ch, received, finished);
+
+	// The receiver drains the ring by itself, which pushes the element of the waiting sender for it,
+	// but the sender only resumes once the executor runs it
+	ASSERT_EQ(received, std::vector<int>({ 0, 1, 2 }));
+	ASSERT_EQ(sent, 2);
+	ASSERT_EQ(executor.queue.size(), 1);
+	while (executor.run() != 0) {
+	}
+	ASSERT_EQ(sent, 100);
+	ASSERT_EQ(received.size(), 100);
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(received[i], i);
+	}
+	ASSERT_FALSE(finished);
+
+	ch.close();
+	executor.run();
+	ASSERT_TRUE(finished);
+}
+
+TEST(SpscChannelTest, Basic) {
+	non_stl::spsc_channel<std::unique_ptr<int>, 4> ch;
+
+	bool finished = false;
+	std::vector<int> received;
+	[](auto& ch, std::vector<int>& out, bool& done) -> task {
+		while (std::optional<std::unique_ptr<int> > v = co_await ch.recv()) {
+			out.push_back(**v);
+		}
+		done = true;
+	}(ch, received, finished);
+
+	for (int i = 0; i < 10; ++i) {
+		ASSERT_TRUE(ch.try_send(std::make_unique<int>(i)));
+	}
+	ch.close();
+	ASSERT_TRUE(finished);
+	ASSERT_EQ(received.size(), 10);
+	ASSERT_EQ(received[9], 9);
+}
+
+// Threads
+
+template <class Channel>
+task send_counted(Channel& ch, int first, int last, std::atomic<int>& sent) {
+	for (int i = first; i < last; ++i) {
+		co_await ch.send(i);
+		sent.fetch_add(1);
+	}
+}
+
+template <class Channel>
+task sum_all(Channel& ch, long long& sum, std::atomic<bool>& finished) {
+	while (std::optional<int> v = co_await ch.recv()) {
+		sum += *v;
+	}
+	finished.store(true);
+}
+
+TEST(ChannelThreadTest, Basic) {
+	constexpr int per_thread = 20000;
+	constexpr int threads = 3;
+	non_stl::channel<int, 8> ch;
+
+	// The receiver is resumed by whichever producer thread wakes it
+	long long sum = 0;
+	std::atomic<bool> finished(false);
+	sum_all(ch, sum, finished);
+
+	// A sender suspended on the full ring finishes on the thread which resumes it
+	std::atomic<int> sent(0);
+	std::vector<std::thread> producers;
+	for (int t = 0; t < threads; ++t) {
+		producers.emplace_back([&, t] {
+			send_counted(ch, t * per_thread, (t + 1) * per_thread, sent);
+		});
+	}
+	for (auto& p : producers) {
+		p.join();
+	}
+	while (sent.load() != per_thread * threads) {
+		std::this_thread::yield();
+	}
+	ch.close();
+
+	ASSERT_TRUE(finished.load());
+	const long long n = static_cast<long long>(per_thread) * threads;
+	ASSERT_EQ(sum, n * (n - 1) / 2);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
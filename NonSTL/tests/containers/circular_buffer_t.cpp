@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <string>
+
 #include "../../containers/circular_buffer.h"
 #include "../../containers/vector.h"
 
@@ -145,6 +148,19 @@ TEST(EmplaceBackTest, Basic) {
 	ASSERT_EQ(x[1], 6);
 }
 
+TEST(EmplaceBackOverwriteSelfTest, Basic) {
+	// The arguments may refer to the oldest element, which a full buffer overwrites
+	non_stl::circular_buffer<std::string, 4> buffer;
+	for (int i = 0; i < 4; ++i) {
+		buffer.emplace_back(32, static_cast<char>('a' + i));
+	}
+	buffer.emplace_back(buffer.front());
+	ASSERT_EQ(buffer.back(), std::string(32, 'a'));
+	buffer.emplace_back(buffer.front(), 1, 16);
+	ASSERT_EQ(buffer.back(), std::string(16, 'b'));
+	ASSERT_EQ(buffer.front(), std::string(32, 'c'));
+}
+
 TEST(PopFrontTest, Basic) {
 	// Basic two element test
 	non_stl::circular_buffer<int, 5> buffer;
@@ -331,12 +347,9 @@ TEST(IteratorTest, Basic) {
 	++it;
 
 	// Out of elements, should equal end
+	// end is past the last constructed element and may not be dereferenced
 	ASSERT_TRUE(it == buffer.end());
-
-	// Make sure iterator doesn't wrap around
-	ASSERT_NE(*it, 1);
-	// Or stay the same value
-	ASSERT_NE(*it, 3);
+	ASSERT_FALSE(it == buffer.begin());
 }
 
 TEST(ReverseIteratorTest, Basic) {
@@ -354,12 +367,344 @@ TEST(ReverseIteratorTest, Basic) {
 	++it;
 
 	// Out of elements, should equal end
+	// rend is before the first constructed element and may not be dereferenced
 	ASSERT_TRUE(it == buffer.rend());
+	ASSERT_FALSE(it == buffer.rbegin());
+}
+
+TEST(PowerOfTwoTest, Basic) {
+	static_assert(non_stl::circular_buffer<int, 4>::is_power_of_two, "4 is a power of two");
+	static_assert(!non_stl::circular_buffer<int, 5>::is_power_of_two, "5 is not a power of two");
+
+	non_stl::circular_buffer<int, 4> buffer;
+	ASSERT_TRUE(buffer.empty());
+
+	// Popping an empty buffer does nothing
+	buffer.pop_front();
+	ASSERT_EQ(buffer.size(), 0);
+
+	for (int i = 1; i <= 4; ++i) {
+		buffer.push_back(i);
+		ASSERT_EQ(buffer.size(), i);
+		ASSERT_EQ(buffer.front(), 1);
+		ASSERT_EQ(buffer.back(), i);
+	}
+
+	// Overwrite the oldest numbers until head wraps around several times
+	for (int i = 5; i <= 20; ++i) {
+		buffer.push_back(i);
+		ASSERT_EQ(buffer.size(), 4);
+		ASSERT_EQ(buffer.front(), i - 3);
+		ASSERT_EQ(buffer.back(), i);
+		ASSERT_EQ(buffer[1], i - 2);
+		ASSERT_EQ(buffer.at(3), i);
+	}
+
+	buffer.pop_front();
+	buffer.pop_front();
+	ASSERT_EQ(buffer.size(), 2);
+	ASSERT_EQ(buffer.front(), 19);
+
+	buffer.pop_front();
+	buffer.pop_front();
+	buffer.pop_front();
+	ASSERT_TRUE(buffer.empty());
+
+	buffer.push_back(21);
+	ASSERT_EQ(buffer.front(), 21);
+	ASSERT_EQ(buffer.back(), 21);
+}
+
+TEST(PowerOfTwoIteratorTest, Basic) {
+	non_stl::circular_buffer<int, 8> buffer;
+	for (int i = 0; i < 13; ++i) {
+		buffer.push_back(i);
+	}
+
+	int expected = 5;
+	for (auto it = buffer.begin(); it != buffer.end(); ++it) {
+		ASSERT_EQ(*it, expected++);
+	}
+	ASSERT_EQ(expected, 13);
+
+	for (auto it = buffer.rbegin(); it != buffer.rend(); ++it) {
+		ASSERT_EQ(*it, --expected);
+	}
+	ASSERT_EQ(expected, 5);
+
+	non_stl::circular_buffer<int, 8> copy(buffer);
+	ASSERT_EQ(copy.front(), 5);
+	ASSERT_EQ(copy.back(), 12);
+}
+
+TEST(PushBackNTest, Basic) {
+	non_stl::circular_buffer<int, 5> buffer;
+	const int values[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+
+	buffer.push_back_n(values, 3);
+	ASSERT_EQ(buffer.size(), 3);
+	ASSERT_EQ(buffer.front(), 1);
+	ASSERT_EQ(buffer.back(), 3);
+
+	// Wraps around and overwrites the oldest numbers
+	buffer.push_back_n(values + 3, 4);
+	ASSERT_EQ(buffer.size(), 5);
+	ASSERT_EQ(buffer.front(), 3);
+	ASSERT_EQ(buffer.back(), 7);
+	for (int i = 0; i < 5; ++i) {
+		ASSERT_EQ(buffer[i], i + 3);
+	}
+
+	// Only the last N values are kept
+	buffer.push_back_n(values, 12);
+	ASSERT_EQ(buffer.size(), 5);
+	ASSERT_EQ(buffer.front(), 8);
+	ASSERT_EQ(buffer.back(), 12);
+
+	// Matches pushing the values one by one
+	non_stl::circular_buffer<int, 8> bulk;
+	non_stl::circular_buffer<int, 8> single;
+	for (int round = 0; round < 5; ++round) {
+		bulk.push_back_n(values, 5);
+		for (int i = 0; i < 5; ++i) {
+			single.push_back(values[i]);
+		}
+		ASSERT_EQ(bulk.size(), single.size());
+		for (size_type i = 0; i < bulk.size(); ++i) {
+			ASSERT_EQ(bulk[i], single[i]);
+		}
+	}
+}
+
+TEST(PopFrontNTest, Basic) {
+	non_stl::circular_buffer<int, 5> buffer;
+	for (int i = 1; i <= 7; ++i) {
+		buffer.push_back(i);
+	}
+
+	// The elements 3 to 7 wrap around the end of the array
+	int out[8] = {};
+	ASSERT_EQ(buffer.pop_front_into(out, 4), 4);
+	ASSERT_EQ(out[0], 3);
+	ASSERT_EQ(out[3], 6);
+	ASSERT_EQ(buffer.size(), 1);
+	ASSERT_EQ(buffer.front(), 7);
+
+	// Only the available elements are moved
+	ASSERT_EQ(buffer.pop_front_into(out, 8), 1);
+	ASSERT_EQ(out[0], 7);
+	ASSERT_TRUE(buffer.empty());
+	// The emptied buffer starts over at the first slot, so its free slots are a single run
+	ASSERT_EQ(buffer.free_one().size(), buffer.capacity());
+	ASSERT_TRUE(buffer.free_two().empty());
+	ASSERT_EQ(buffer.pop_front_into(out, 8), 0);
+
+	non_stl::circular_buffer<int, 4> pow2;
+	const int values[] = { 1, 2, 3, 4, 5, 6 };
+	pow2.push_back_n(values, 6);
+	ASSERT_EQ(pow2.pop_front_into(out, 3), 3);
+	ASSERT_EQ(out[0], 3);
+	ASSERT_EQ(out[2], 5);
+	ASSERT_EQ(pow2.front(), 6);
+}
+
+TEST(TwoSpanTest, Basic) {
+	non_stl::circular_buffer<int, 5> buffer;
+	ASSERT_TRUE(buffer.array_one().empty());
+	ASSERT_TRUE(buffer.array_two().empty());
+
+	buffer.push_back(1);
+	buffer.push_back(2);
+	buffer.push_back(3);
+
+	// Contiguous contents only use the first span
+	ASSERT_EQ(buffer.array_one().size(), 3);
+	ASSERT_TRUE(buffer.array_two().empty());
+	ASSERT_EQ(buffer.array_one()[0], 1);
+
+	buffer.push_back(4);
+	buffer.push_back(5);
+	buffer.push_back(6);
+	buffer.push_back(7);
+
+	// 3 4 5 sit at the end of the array, 6 7 at its start
+	const auto& cbuffer = buffer;
+	non_stl::span<const int> one = cbuffer.array_one();
+	non_stl::span<const int> two = cbuffer.array_two();
+	ASSERT_EQ(one.size(), 3);
+	ASSERT_EQ(two.size(), 2);
+	ASSERT_EQ(one.front(), 3);
+	ASSERT_EQ(one.back(), 5);
+	ASSERT_EQ(two.front(), 6);
+	ASSERT_EQ(two.back(), 7);
+
+	// The spans are writable views of the buffer
+	buffer.array_two()[1] = 70;
+	ASSERT_EQ(buffer.back(), 70);
+}
+
+TEST(FreeSpanTest, Basic) {
+	non_stl::circular_buffer<int, 5> buffer;
+	ASSERT_EQ(buffer.free_one().size(), 5);
+	ASSERT_TRUE(buffer.free_two().empty());
+
+	// Written in place then appended
+	buffer.free_one()[0] = 1;
+	buffer.free_one()[1] = 2;
+	buffer.free_one()[2] = 3;
+	buffer.commit_back(3);
+	ASSERT_EQ(buffer.size(), 3);
+	ASSERT_EQ(buffer.back(), 3);
+
+	// The free slots wrap around once the front moved
+	ASSERT_EQ(buffer.pop_front_n(2), 2);
+	ASSERT_EQ(buffer.free_one().size(), 2);
+	ASSERT_EQ(buffer.free_two().size(), 2);
+	buffer.free_one()[0] = 4;
+	buffer.free_one()[1] = 5;
+	buffer.free_two()[0] = 6;
+	buffer.commit_back(3);
+	ASSERT_EQ(buffer.size(), 4);
+	ASSERT_EQ(buffer.front(), 3);
+	ASSERT_EQ(buffer.back(), 6);
+	ASSERT_EQ(buffer.free_one().size(), 1);
+	ASSERT_TRUE(buffer.free_two().empty());
+
+	// A literal 0 picks the size only overload
+	ASSERT_EQ(buffer.pop_front_n(0), 0);
+	ASSERT_EQ(buffer.size(), 4);
+
+	// Emptying the buffer makes the free slots a single run again
+	ASSERT_EQ(buffer.pop_front_n(10), 4);
+	ASSERT_TRUE(buffer.empty());
+	ASSERT_EQ(buffer.free_one().size(), 5);
+
+	non_stl::circular_buffer<int, 4> pow2;
+	pow2.free_one()[0] = 1;
+	pow2.free_one()[1] = 2;
+	pow2.free_one()[2] = 3;
+	pow2.commit_back(3);
+	ASSERT_EQ(pow2.pop_front_n(1), 1);
+	ASSERT_EQ(pow2.free_one().size(), 1);
+	ASSERT_EQ(pow2.free_two().size(), 1);
+	ASSERT_EQ(pow2.front(), 2);
+}
+
+// Counts the live objects and the copies / moves made
+struct Tracked {
+	static int alive;
+	static int copies;
+	static int moves;
+
+	explicit Tracked(int v) : value(v) { ++alive; }
+	Tracked(const Tracked& other) : value(other.value) { ++alive; ++copies; }
+	Tracked(Tracked&& other) noexcept : value(other.value) { ++alive; ++moves; }
+	Tracked& operator=(const Tracked& other) { value = other.value; ++copies; return *this; }
+	Tracked& operator=(Tracked&& other) noexcept { value = other.value; ++moves; return *this; }
+	~Tracked() { --alive; }
+
+	static void reset() { alive = copies = moves = 0; }
+
+	int value;
+};
+
+int Tracked::alive = 0;
+int Tracked::copies = 0;
+int Tracked::moves = 0;
+
+TEST(LazyLifetimeTest, Basic) {
+	Tracked::reset();
+	{
+		// Tracked isn't default constructible and nothing is constructed up front
+		non_stl::circular_buffer<Tracked, 3> buffer;
+		ASSERT_EQ(Tracked::alive, 0);
+
+		// emplace_back constructs in place without a temporary
+		buffer.emplace_back(1);
+		buffer.emplace_back(2);
+		ASSERT_EQ(Tracked::alive, 2);
+		ASSERT_EQ(Tracked::moves, 0);
+		ASSERT_EQ(Tracked::copies, 0);
+
+		buffer.pop_front();
+		ASSERT_EQ(Tracked::alive, 1);
+		ASSERT_EQ(buffer.front().value, 2);
+
+		// Overwriting keeps the amount of live objects at N
+		for (int i = 3; i < 10; ++i) {
+			buffer.emplace_back(i);
+			ASSERT_LE(Tracked::alive, 3);
+		}
+		ASSERT_EQ(Tracked::alive, 3);
+		ASSERT_EQ(buffer.front().value, 7);
+
+		// Only the 5 overwrites build a temporary, since args may refer to the oldest element
+		ASSERT_EQ(Tracked::moves, 5);
+
+		buffer.clear();
+		ASSERT_EQ(Tracked::alive, 0);
+		buffer.push_back(Tracked(10));
+		ASSERT_EQ(Tracked::alive, 1);
+	}
+	// The destructor destroys the remaining elements
+	ASSERT_EQ(Tracked::alive, 0);
+}
+
+TEST(LazyLifetimeCopyTest, Basic) {
+	Tracked::reset();
+	{
+		non_stl::circular_buffer<Tracked, 4> buffer;
+		for (int i = 0; i < 6; ++i) {
+			buffer.emplace_back(i);
+		}
+
+		non_stl::circular_buffer<Tracked, 4> copy(buffer);
+		ASSERT_EQ(Tracked::alive, 8);
+		ASSERT_EQ(copy.front().value, 2);
+		ASSERT_EQ(copy.back().value, 5);
+
+		non_stl::circular_buffer<Tracked, 4> other;
+		other.emplace_back(100);
+		other = std::move(copy);
+		ASSERT_EQ(other.size(), 4);
+		ASSERT_EQ(other[1].value, 3);
+
+		other = buffer;
+		ASSERT_EQ(other.size(), 4);
+		ASSERT_EQ(other.back().value, 5);
+		ASSERT_EQ(Tracked::alive, 12);
+	}
+	ASSERT_EQ(Tracked::alive, 0);
+}
+
+TEST(LazyLifetimeBulkTest, Basic) {
+	auto tracker = std::make_shared<int>(0);
+	{
+		non_stl::circular_buffer<std::shared_ptr<int>, 4> buffer;
+		std::shared_ptr<int> values[] = { tracker, tracker, tracker, tracker, tracker, tracker };
+
+		buffer.push_back_n(values, 3);
+		ASSERT_EQ(tracker.use_count(), 10);
+		buffer.push_back_n(values, 3);
+		ASSERT_EQ(tracker.use_count(), 11);
+
+		std::shared_ptr<int> out[4];
+		ASSERT_EQ(buffer.pop_front_into(out, 2), 2);
+		ASSERT_EQ(buffer.size(), 2);
+		ASSERT_EQ(tracker.use_count(), 11);
+	}
+	ASSERT_EQ(tracker.use_count(), 1);
+}
+
+TEST(OverwriteSelfTest, Basic) {
+	non_stl::circular_buffer<std::string, 2> buffer;
+	buffer.push_back("first");
+	buffer.push_back("second");
 
-	// Make sure iterator doesn't wrap around
-	ASSERT_NE(*it, 3);
-	// Or stay the same value
-	ASSERT_NE(*it, 1);
+	// The value being pushed is the one being overwritten
+	buffer.push_back(buffer.front());
+	ASSERT_EQ(buffer.front(), "second");
+	ASSERT_EQ(buffer.back(), "first");
 }
 
 int main(int argc, char** argv) {
@@ -0,0 +1,195 @@
+#define NON_STL_DEBUG
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include "../../containers/circular_buffer.h"
+#include "../../containers/fixed_vector.h"
+#include "../../containers/vector.h"
+
+// Bounds checks
+
+TEST(DebugVectorIndexTest, Basic) {
+	non_stl::vector<int> vec = { 1, 2, 3 };
+	ASSERT_EQ(vec[2], 3);
+	ASSERT_DEATH(vec[3], "vector::operator\\[\\] - index out of range");
+
+	non_stl::vector<int> empty;
+	ASSERT_DEATH(empty.front(), "vector::front - vector is empty");
+	ASSERT_DEATH(empty.back(), "vector::back - vector is empty");
+	ASSERT_DEATH(empty.pop_back(), "vector::pop_back - vector is empty");
+}
+
+TEST(DebugVectorAtTest, Basic) {
+	non_stl::vector<int> vec = { 1, 2, 3 };
+	ASSERT_EQ(vec.at(0), 1);
+	ASSERT_THROW(vec.at(3), std::out_of_range);
+
+	const non_stl::vector<int>& cvec = vec;
+	ASSERT_THROW(cvec.at(100), std::out_of_range);
+}
+
+TEST(DebugFixedVectorIndexTest, Basic) {
+	non_stl::fixed_vector<std::string, 4> vec = { "a", "b" };
+	ASSERT_EQ(vec[1], "b");
+	ASSERT_DEATH(vec[2], "fixed_vector::operator\\[\\] - index out of range");
+
+	vec.clear();
+	ASSERT_DEATH(vec.pop_back(), "fixed_vector::pop_back - vector is empty");
+}
+
+TEST(DebugCircularBufferIndexTest, Basic) {
+	non_stl::circular_buffer<int, 4> buf;
+	ASSERT_DEATH(buf.front(), "circular_buffer::front - buffer is empty");
+
+	buf.push_back(1);
+	buf.push_back(2);
+	ASSERT_EQ(buf[1], 2);
+	ASSERT_DEATH(buf[2], "circular_buffer::operator\\[\\] - index out of range");
+	ASSERT_THROW(buf.at(2), std::out_of_range);
+	ASSERT_EQ(buf.at(0), 1);
+}
+
+// Vector iterators
+
+TEST(DebugVectorIteratorTest, Basic) {
+	non_stl::vector<int> vec;
+	vec.push_back(1);
+
+	// Growing within the capacity keeps the iterator valid
+	auto it = vec.begin();
+	vec.push_back(2);
+	ASSERT_TRUE(it.valid());
+	ASSERT_EQ(*it, 1);
+
+	non_stl::vector<int>::const_iterator cit = it;
+	ASSERT_EQ(cit[1], 2);
+
+	// Reallocation invalidates it
+	while (vec.size() < vec.capacity()) {
+		vec.push_back(static_cast<int>(vec.size()) + 1);
+	}
+	ASSERT_TRUE(it.valid());
+	vec.push_back(static_cast<int>(vec.size()) + 1);
+	ASSERT_FALSE(it.valid());
+	ASSERT_FALSE(cit.valid());
+	ASSERT_DEATH(*it, "iterator used after its container reallocated or was cleared");
+	ASSERT_DEATH(cit[0], "iterator used after its container reallocated or was cleared");
+
+	// So does clear
+	auto last = vec.end() - 1;
+	ASSERT_EQ(*last, static_cast<int>(vec.size()));
+	vec.clear();
+	ASSERT_DEATH(*last, "iterator used after its container reallocated or was cleared");
+}
+
+TEST(DebugVectorShrinkTest, Basic) {
+	non_stl::vector<std::string> vec = { "a", "b", "c" };
+	vec.reserve(64);
+	auto it = vec.begin() + 1;
+	ASSERT_EQ(it->size(), 1);
+
+	vec.shrink_to_fit();
+	ASSERT_DEATH(static_cast<void>(it->size()), "reallocated or was cleared");
+}
+
+TEST(DebugVectorAlgorithmsTest, Basic) {
+	// Valid use through the standard algorithms passes every check
+	non_stl::vector<int> vec;
+	for (int i = 0; i < 100; ++i) {
+		vec.push_back(99 - i);
+	}
+	std::sort(vec.begin(), vec.end());
+	ASSERT_TRUE(std::is_sorted(vec.cbegin(), vec.cend()));
+
+	vec.insert(vec.begin() + 50, { -1, -2 });
+	vec.erase(vec.begin() + 50, vec.begin() + 52);
+	auto found = std::find(vec.begin(), vec.end(), 42);
+	ASSERT_EQ(found - vec.begin(), 42);
+	ASSERT_EQ(*vec.rbegin(), 99);
+}
+
+// Circular buffer iterators
+
+TEST(DebugCircularBufferIteratorTest, Basic) {
+	non_stl::circular_buffer<int, 4> buf;
+	for (int i = 0; i < 4; ++i) {
+		buf.push_back(i);
+	}
+
+	auto oldest = buf.begin();
+	auto newest = buf.rbegin();
+	ASSERT_EQ(*oldest, 0);
+	ASSERT_EQ(*newest, 3);
+
+	// Overwriting the oldest element invalidates the iterator at it, but not its neighbours
+	buf.push_back(4);
+	ASSERT_DEATH(*oldest, "circular_buffer iterator refers to an overwritten or removed element");
+	ASSERT_EQ(*(oldest + 1), 1);
+	ASSERT_EQ(*newest, 3);
+	ASSERT_EQ(*(newest + 2), 1);
+	ASSERT_DEATH(*(newest + 3), "overwritten or removed element");
+
+	// Popping removes elements from the front
+	buf.pop_front();
+	ASSERT_DEATH(oldest[1], "overwritten or removed element");
+	ASSERT_EQ(oldest[2], 2);
+
+	// Three more elements overwrite two, 2 and 3
+	int values[3] = { 5, 6, 7 };
+	buf.push_back_n(values, 3);
+	ASSERT_DEATH(*newest, "overwritten or removed element");
+	ASSERT_EQ(*buf.begin(), 4);
+	ASSERT_EQ(*buf.rbegin(), 7);
+
+	buf.clear();
+	ASSERT_DEATH(*(oldest + 4), "overwritten or removed element");
+}
+
+TEST(DebugCircularBufferIterateTest, Basic) {
+	non_stl::circular_buffer<std::string, 8> buf;
+	for (int i = 0; i < 13; ++i) {
+		buf.emplace_back(std::to_string(i));
+	}
+
+	int expected = 5;
+	for (const auto& s : buf) {
+		ASSERT_EQ(s, std::to_string(expected++));
+	}
+
+	non_stl::circular_buffer<std::string, 8>::const_iterator it = buf.begin();
+	ASSERT_EQ(*it, "5");
+	ASSERT_EQ(buf.pop_front_n(3), 3);
+	ASSERT_DEATH(*(it + 2), "overwritten or removed element");
+	ASSERT_EQ(*(it + 3), "8");
+}
+
+// Handler
+
+static int handler_calls = 0;
+
+static void counting_handler(const char* message, const char* file, int line) {
+	++handler_calls;
+	std::fprintf(stderr, "counted %d: %s at %s:%d\n", handler_calls, message, file, line);
+}
+
+TEST(DebugHandlerTest, Basic) {
+	const non_stl::debug_handler previous = non_stl::set_debug_handler(counting_handler);
+	ASSERT_EQ(previous, non_stl::default_debug_handler);
+
+	// The program still aborts once the handler returns
+	non_stl::vector<int> vec;
+	ASSERT_DEATH(vec.back(), "counted 1: vector::back - vector is empty at .*vector.h");
+
+	ASSERT_EQ(non_stl::set_debug_handler(nullptr), counting_handler);
+	ASSERT_EQ(non_stl::set_debug_handler(nullptr), non_stl::default_debug_handler);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
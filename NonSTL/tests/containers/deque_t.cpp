@@ -0,0 +1,392 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../containers/deque.h"
+#include "../../containers/vector.h"
+#include "../../memory/arena_allocator.h"
+
+// Allocator counting the blocks it currently has handed out
+static int live_allocations = 0;
+
+template <class T>
+struct counting_allocator
+{
+	using value_type = T;
+
+	counting_allocator() = default;
+	template <class U>
+	counting_allocator(const counting_allocator<U>&) {}
+
+	T* allocate(size_t n) {
+		++live_allocations;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T* p, size_t n) {
+		--live_allocations;
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	friend bool operator==(const counting_allocator&, const counting_allocator&) { return true; }
+	friend bool operator!=(const counting_allocator&, const counting_allocator&) { return false; }
+};
+
+// Small blocks so a few elements already span several of them
+using small_deque = non_stl::deque<int, std::allocator<int>, 16 * sizeof(int)>;
+
+// Constructors
+
+TEST(DequeConstructTest, Basic) {
+	non_stl::deque<int> empty;
+	ASSERT_TRUE(empty.empty());
+	ASSERT_EQ(empty.begin(), empty.end());
+
+	non_stl::deque<int> sized(100);
+	ASSERT_EQ(sized.size(), 100);
+	ASSERT_EQ(sized[99], 0);
+
+	non_stl::deque<std::string> filled(40, "a");
+	ASSERT_EQ(filled.size(), 40);
+	ASSERT_EQ(filled.back(), "a");
+
+	non_stl::deque<int> init{ 1, 2, 3 };
+	ASSERT_EQ(init.size(), 3);
+	ASSERT_EQ(init.front(), 1);
+	ASSERT_EQ(init.back(), 3);
+
+	std::list<int> list{ 4, 5, 6 };
+	non_stl::deque<int> range(list.begin(), list.end());
+	ASSERT_TRUE(std::equal(range.begin(), range.end(), list.begin()));
+
+	// The block size is a power of two sized close to BlockBytes
+	ASSERT_EQ(non_stl::deque<int>::block_size, 1024);
+	ASSERT_EQ(small_deque::block_size, 16);
+	ASSERT_EQ((non_stl::deque<char[3000]>::block_size), 16);
+}
+
+TEST(DequeConstructTest, CopyMove) {
+	non_stl::deque<std::string> deque;
+	for (int i = 0; i < 100; ++i) {
+		deque.push_back(std::to_string(i));
+	}
+
+	non_stl::deque<std::string> copy(deque);
+	ASSERT_EQ(copy.size(), 100);
+	ASSERT_TRUE(std::equal(copy.begin(), copy.end(), deque.begin()));
+
+	non_stl::deque<std::string> moved(std::move(copy));
+	ASSERT_EQ(moved.size(), 100);
+	ASSERT_TRUE(copy.empty());
+	ASSERT_EQ(moved[42], "42");
+
+	non_stl::deque<std::string> assigned;
+	assigned.push_back("x");
+	assigned = deque;
+	ASSERT_EQ(assigned.size(), 100);
+	ASSERT_EQ(assigned.front(), "0");
+
+	assigned = std::move(moved);
+	ASSERT_EQ(assigned.back(), "99");
+
+	assigned = { "a", "b" };
+	ASSERT_EQ(assigned.size(), 2);
+	ASSERT_EQ(assigned[1], "b");
+}
+
+// Push / pop
+
+TEST(DequePushPopTest, BothEnds) {
+	small_deque deque;
+
+	for (int i = 0; i < 100; ++i) {
+		deque.push_back(i);
+		deque.push_front(-i - 1);
+	}
+	ASSERT_EQ(deque.size(), 200);
+
+	for (int i = 0; i < 200; ++i) {
+		ASSERT_EQ(deque[i], i - 100);
+	}
+	ASSERT_EQ(deque.at(0), -100);
+	ASSERT_THROW(deque.at(200), std::out_of_range);
+
+	for (int i = 0; i < 50; ++i) {
+		deque.pop_front();
+		deque.pop_back();
+	}
+	ASSERT_EQ(deque.size(), 100);
+	ASSERT_EQ(deque.front(), -50);
+	ASSERT_EQ(deque.back(), 49);
+}
+
+TEST(DequePushPopTest, StableReferences) {
+	small_deque deque;
+	deque.push_back(1);
+	int& first = deque.front();
+
+	for (int i = 0; i < 1000; ++i) {
+		deque.push_back(i);
+		deque.push_front(i);
+	}
+
+	// Growing only ever adds blocks, existing elements never move
+	ASSERT_EQ(&first, &deque[1000]);
+	ASSERT_EQ(first, 1);
+}
+
+TEST(DequePushPopTest, EmplaceSelf) {
+	non_stl::deque<std::string> deque;
+	deque.emplace_back("value");
+
+	for (int i = 0; i < 10; ++i) {
+		deque.emplace_back(deque.front());
+		deque.emplace_front(deque.back());
+	}
+	ASSERT_EQ(deque.size(), 21);
+	for (auto& s : deque) {
+		ASSERT_EQ(s, "value");
+	}
+}
+
+TEST(DequePushPopTest, QueueReusesBlocks) {
+	non_stl::deque<int, counting_allocator<int>, 16 * sizeof(int)> deque;
+
+	for (int i = 0; i < 64; ++i) {
+		deque.push_back(i);
+	}
+	const int allocations = live_allocations;
+
+	// Steady state queue, blocks emptied at the front are reused at the back
+	for (int i = 0; i < 10000; ++i) {
+		deque.push_back(i);
+		deque.pop_front();
+	}
+	ASSERT_LE(live_allocations, allocations + 1);
+	ASSERT_EQ(deque.size(), 64);
+	ASSERT_EQ(deque.back(), 9999);
+}
+
+// Iterators
+
+TEST(DequeIteratorTest, RandomAccess) {
+	small_deque deque;
+	for (int i = 0; i < 100; ++i) {
+		deque.push_front(i);
+	}
+
+	ASSERT_EQ(deque.end() - deque.begin(), 100);
+	ASSERT_EQ(*(deque.begin() + 50), 49);
+	ASSERT_EQ(deque.begin()[99], 0);
+	ASSERT_EQ(*(deque.end() - 1), 0);
+
+	auto it = deque.end();
+	it -= 100;
+	ASSERT_EQ(it, deque.begin());
+	ASSERT_TRUE(deque.begin() < deque.end());
+
+	std::sort(deque.begin(), deque.end());
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(deque[i], i);
+	}
+
+	int expected = 99;
+	for (auto rit = deque.rbegin(); rit != deque.rend(); ++rit) {
+		ASSERT_EQ(*rit, expected--);
+	}
+
+	const small_deque& cref = deque;
+	small_deque::const_iterator cit = deque.begin();
+	ASSERT_EQ(cit, cref.cbegin());
+}
+
+// Insert / erase
+
+TEST(DequeInsertTest, Ends) {
+	small_deque deque{ 50, 51 };
+
+	// Trivially copyable contiguous ranges are copied block by block
+	std::vector<int> back(40), front(40);
+	for (int i = 0; i < 40; ++i) {
+		back[i] = 52 + i;
+		front[i] = 10 + i;
+	}
+	deque.append_range(back);
+	deque.prepend_range(front);
+	ASSERT_EQ(deque.size(), 82);
+	for (int i = 0; i < 82; ++i) {
+		ASSERT_EQ(deque[i], 10 + i);
+	}
+
+	non_stl::vector<int> v{ 0, 1, 2 };
+	deque.insert(deque.begin(), v.begin(), v.end());
+	ASSERT_EQ(deque[0], 0);
+	ASSERT_EQ(deque[2], 2);
+	ASSERT_EQ(deque[3], 10);
+
+	deque.insert(deque.end(), 3, -1);
+	ASSERT_EQ(deque.size(), 88);
+	ASSERT_EQ(deque.back(), -1);
+
+	std::list<std::string> words{ "a", "b", "c" };
+	non_stl::deque<std::string> strings{ "d" };
+	strings.prepend_range(words);
+	ASSERT_EQ(strings.size(), 4);
+	ASSERT_EQ(strings[0], "a");
+	ASSERT_EQ(strings[2], "c");
+	ASSERT_EQ(strings[3], "d");
+}
+
+TEST(DequeInsertTest, Middle) {
+	small_deque deque;
+	for (int i = 0; i < 10; ++i) {
+		deque.push_back(i * 10);
+	}
+
+	auto it = deque.insert(deque.begin() + 2, 15);
+	ASSERT_EQ(*it, 15);
+	it = deque.insert(deque.begin() + 9, 75);
+	ASSERT_EQ(*it, 75);
+	it = deque.insert(deque.begin() + 1, { 1, 2, 3 });
+	ASSERT_EQ(*it, 1);
+	it = deque.insert(deque.end() - 1, 2, 85);
+	ASSERT_EQ(*it, 85);
+
+	std::istringstream stream("7 8");
+	deque.insert(deque.begin() + 5, std::istream_iterator<int>(stream), std::istream_iterator<int>());
+
+	const std::vector<int> expected{ 0, 1, 2, 3, 10, 7, 8, 15, 20, 30, 40, 50, 60, 70, 75, 80, 85, 85, 90 };
+	ASSERT_EQ(deque.size(), expected.size());
+	ASSERT_TRUE(std::equal(deque.begin(), deque.end(), expected.begin()));
+
+	auto emplaced = deque.emplace(deque.begin() + 3, 100);
+	ASSERT_EQ(*emplaced, 100);
+	ASSERT_EQ(deque[4], 3);
+}
+
+TEST(DequeEraseTest, Basic) {
+	non_stl::deque<std::string> deque;
+	for (int i = 0; i < 20; ++i) {
+		deque.push_back(std::to_string(i));
+	}
+
+	auto it = deque.erase(deque.begin() + 2);
+	ASSERT_EQ(*it, "3");
+	it = deque.erase(deque.begin() + 15, deque.begin() + 18);
+	ASSERT_EQ(*it, "19");
+	it = deque.erase(deque.begin(), deque.begin() + 2);
+	ASSERT_EQ(*it, "3");
+
+	const std::vector<std::string> expected{ "3", "4", "5", "6", "7", "8", "9", "10", "11", "12", "13", "14", "15", "19" };
+	ASSERT_EQ(deque.size(), expected.size());
+	ASSERT_TRUE(std::equal(deque.begin(), deque.end(), expected.begin()));
+
+	deque.erase(deque.begin(), deque.end());
+	ASSERT_TRUE(deque.empty());
+}
+
+// Capacity
+
+TEST(DequeResizeTest, Basic) {
+	small_deque deque;
+	deque.resize(40);
+	ASSERT_EQ(deque.size(), 40);
+	ASSERT_EQ(deque[39], 0);
+
+	deque.resize(50, 7);
+	ASSERT_EQ(deque[49], 7);
+	ASSERT_EQ(deque[39], 0);
+
+	deque.resize(5);
+	ASSERT_EQ(deque.size(), 5);
+
+	deque.assign(3, 9);
+	ASSERT_EQ(deque.size(), 3);
+	ASSERT_EQ(deque.back(), 9);
+}
+
+TEST(DequeShrinkTest, Basic) {
+	live_allocations = 0;
+	{
+		non_stl::deque<int, counting_allocator<int>, 16 * sizeof(int)> deque;
+		for (int i = 0; i < 160; ++i) {
+			deque.push_back(i);
+		}
+		// 10 blocks and the map
+		ASSERT_EQ(live_allocations, 11);
+
+		for (int i = 0; i < 150; ++i) {
+			deque.pop_front();
+		}
+		ASSERT_EQ(live_allocations, 11);
+
+		deque.shrink_to_fit();
+		ASSERT_EQ(live_allocations, 2);
+		ASSERT_EQ(deque.size(), 10);
+		ASSERT_EQ(deque.front(), 150);
+		ASSERT_EQ(deque.back(), 159);
+
+		// Still usable at both ends once shrunk
+		deque.push_front(149);
+		deque.push_back(160);
+		ASSERT_EQ(deque.size(), 12);
+		ASSERT_EQ(deque.front(), 149);
+		ASSERT_EQ(deque.back(), 160);
+
+		deque.clear();
+		deque.shrink_to_fit();
+		ASSERT_EQ(live_allocations, 0);
+	}
+	ASSERT_EQ(live_allocations, 0);
+}
+
+// Modifiers
+
+TEST(DequeSwapTest, Basic) {
+	non_stl::deque<int> a{ 1, 2, 3 };
+	non_stl::deque<int> b{ 4 };
+	a.swap(b);
+	ASSERT_EQ(a.size(), 1);
+	ASSERT_EQ(a.front(), 4);
+	ASSERT_EQ(b.size(), 3);
+	ASSERT_EQ(b.back(), 3);
+}
+
+// Allocators
+
+TEST(DequeAllocatorTest, Arena) {
+	non_stl::monotonic_buffer buffer;
+	non_stl::arena_allocator<std::string> alloc(buffer);
+
+	non_stl::deque<std::string, non_stl::arena_allocator<std::string> > deque(alloc);
+	for (int i = 0; i < 50; ++i) {
+		deque.push_front(std::to_string(i));
+	}
+	ASSERT_GT(buffer.bytes_allocated(), 0u);
+	ASSERT_EQ(deque.back(), "0");
+
+	// Unequal arenas which don't propagate move the elements over
+	non_stl::monotonic_buffer other_buffer;
+	non_stl::deque<std::string, non_stl::arena_allocator<std::string> > other(non_stl::arena_allocator<std::string>{ other_buffer });
+	other = std::move(deque);
+	ASSERT_EQ(other.size(), 50);
+	ASSERT_EQ(other.get_allocator().buffer(), &other_buffer);
+
+	non_stl::monotonic_buffer resource;
+	non_stl::pmr::deque<int> pmr(&resource);
+	for (int i = 0; i < 100; ++i) {
+		pmr.push_back(i);
+	}
+	ASSERT_EQ(pmr.size(), 100);
+	ASSERT_EQ(pmr.get_allocator().resource(), &resource);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,298 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "../../containers/dynamic_circular_buffer.h"
+#include "../../memory/arena_allocator.h"
+
+// Constructors
+
+TEST(DynamicConstructTest, Basic) {
+	non_stl::dynamic_circular_buffer<int> empty;
+	ASSERT_EQ(empty.capacity(), 0);
+	ASSERT_TRUE(empty.empty());
+
+	non_stl::dynamic_circular_buffer<int> buffer(5);
+	ASSERT_EQ(buffer.capacity(), 5);
+	ASSERT_EQ(buffer.size(), 0);
+	ASSERT_EQ(buffer.policy(), non_stl::overflow_policy::overwrite);
+}
+
+// Overwrite
+
+TEST(DynamicOverwriteTest, Basic) {
+	non_stl::dynamic_circular_buffer<int> buffer(3);
+
+	buffer.push_back(1);
+	buffer.push_back(2);
+	buffer.push_back(3);
+	ASSERT_TRUE(buffer.full());
+	ASSERT_EQ(buffer.front(), 1);
+	ASSERT_EQ(buffer.back(), 3);
+
+	// Pushing more in than the buffer can hold, should overwrite the oldest number
+	for (int i = 4; i < 10; ++i) {
+		buffer.push_back(i);
+		ASSERT_EQ(buffer.size(), 3);
+		ASSERT_EQ(buffer.front(), i - 2);
+		ASSERT_EQ(buffer.back(), i);
+		ASSERT_EQ(buffer[1], i - 1);
+	}
+	ASSERT_EQ(buffer.capacity(), 3);
+
+	buffer.pop_front();
+	ASSERT_EQ(buffer.size(), 2);
+	ASSERT_EQ(buffer.front(), 8);
+	ASSERT_THROW(buffer.at(2), std::out_of_range);
+	ASSERT_EQ(buffer.at(1), 9);
+}
+
+TEST(DynamicOverwriteSelfTest, Basic) {
+	non_stl::dynamic_circular_buffer<std::string> buffer(2);
+	buffer.push_back("first");
+	buffer.push_back("second");
+
+	buffer.push_back(buffer.front());
+	ASSERT_EQ(buffer.front(), "second");
+	ASSERT_EQ(buffer.back(), "first");
+}
+
+TEST(DynamicEmplaceOverwriteSelfTest, Basic) {
+	// The arguments may refer to the oldest element, which a full buffer overwrites
+	non_stl::dynamic_circular_buffer<std::string> buffer(2);
+	buffer.emplace_back(32, 'a');
+	buffer.emplace_back(32, 'b');
+
+	buffer.emplace_back(buffer.front());
+	ASSERT_EQ(buffer.front(), std::string(32, 'b'));
+	ASSERT_EQ(buffer.back(), std::string(32, 'a'));
+
+	buffer.emplace_back(buffer.front(), 1, 16);
+	ASSERT_EQ(buffer.size(), 2);
+	ASSERT_EQ(buffer.front(), std::string(32, 'a'));
+	ASSERT_EQ(buffer.back(), std::string(16, 'b'));
+}
+
+// Grow
+
+TEST(DynamicGrowTest, Basic) {
+	non_stl::dynamic_circular_buffer<std::string> buffer(3, non_stl::overflow_policy::grow);
+
+	buffer.push_back("0");
+	buffer.push_back("1");
+	buffer.push_back("2");
+	buffer.pop_front();
+	buffer.push_back("3");
+
+	// The contents wrap around the end of the array when growing
+	for (int i = 4; i < 20; ++i) {
+		buffer.push_back(std::to_string(i));
+	}
+	ASSERT_EQ(buffer.size(), 19);
+	ASSERT_GE(buffer.capacity(), 19);
+	for (int i = 0; i < 19; ++i) {
+		ASSERT_EQ(buffer[i], std::to_string(i + 1));
+	}
+
+	// Growing linearizes the elements
+	ASSERT_EQ(buffer.array_two().size(), 0);
+}
+
+TEST(DynamicGrowSelfTest, Basic) {
+	non_stl::dynamic_circular_buffer<std::string> buffer(2, non_stl::overflow_policy::grow);
+	buffer.push_back("first");
+	buffer.push_back("second");
+
+	// The element being pushed lives in the array being replaced
+	buffer.push_back(buffer.front());
+	ASSERT_EQ(buffer.size(), 3);
+	ASSERT_EQ(buffer.back(), "first");
+
+	non_stl::dynamic_circular_buffer<std::string> empty;
+	empty.emplace_back(3, 'a');
+	ASSERT_EQ(empty.front(), "aaa");
+}
+
+TEST(DynamicReserveTest, Basic) {
+	non_stl::dynamic_circular_buffer<int> buffer(4);
+	for (int i = 0; i < 6; ++i) {
+		buffer.push_back(i);
+	}
+
+	buffer.reserve(8);
+	ASSERT_EQ(buffer.capacity(), 8);
+	ASSERT_EQ(buffer.size(), 4);
+	ASSERT_EQ(buffer.front(), 2);
+	ASSERT_EQ(buffer.back(), 5);
+
+	// Room for more before overwriting
+	buffer.push_back(6);
+	ASSERT_EQ(buffer.size(), 5);
+	ASSERT_EQ(buffer.front(), 2);
+}
+
+// Bulk
+
+TEST(DynamicBulkTest, Basic) {
+	const int values[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+	non_stl::dynamic_circular_buffer<int> buffer(4);
+	buffer.push_back_n(values, 3);
+	buffer.push_back_n(values + 3, 3);
+	ASSERT_EQ(buffer.size(), 4);
+	ASSERT_EQ(buffer.front(), 3);
+	ASSERT_EQ(buffer.back(), 6);
+	ASSERT_EQ(buffer.array_one().size() + buffer.array_two().size(), 4);
+
+	int out[10] = {};
+	ASSERT_EQ(buffer.pop_front_into(out, 10), 4);
+	ASSERT_EQ(out[0], 3);
+	ASSERT_EQ(out[3], 6);
+	ASSERT_TRUE(buffer.empty());
+	ASSERT_EQ(buffer.pop_front_n(0), 0);
+
+	non_stl::dynamic_circular_buffer<std::string> grow(2, non_stl::overflow_policy::grow);
+	const std::string words[] = { "a", "b", "c", "d", "e" };
+	grow.push_back_n(words, 5);
+	ASSERT_EQ(grow.size(), 5);
+	ASSERT_EQ(grow.back(), "e");
+
+	non_stl::dynamic_circular_buffer<std::string> overwrite(2);
+	overwrite.push_back_n(words, 3);
+	overwrite.push_back_n(words + 3, 1);
+	ASSERT_EQ(overwrite.size(), 2);
+	ASSERT_EQ(overwrite.front(), "c");
+	ASSERT_EQ(overwrite.back(), "d");
+}
+
+TEST(DynamicFreeSpanTest, Basic) {
+	non_stl::dynamic_circular_buffer<char> buffer(4);
+	ASSERT_EQ(buffer.free_one().size(), 4);
+	ASSERT_TRUE(buffer.free_two().empty());
+
+	buffer.free_one()[0] = 'a';
+	buffer.free_one()[1] = 'b';
+	buffer.free_one()[2] = 'c';
+	buffer.commit_back(3);
+	ASSERT_EQ(buffer.pop_front_n(2), 2);
+	ASSERT_EQ(buffer.front(), 'c');
+
+	// One slot at the end of the array, two at its start
+	ASSERT_EQ(buffer.free_one().size(), 1);
+	ASSERT_EQ(buffer.free_two().size(), 2);
+	buffer.free_one()[0] = 'd';
+	buffer.free_two()[0] = 'e';
+	buffer.commit_back(2);
+	ASSERT_EQ(buffer.size(), 3);
+	ASSERT_EQ(buffer.back(), 'e');
+	ASSERT_EQ(buffer.array_two().size(), 1);
+
+	ASSERT_EQ(buffer.pop_front_n(5), 3);
+	ASSERT_EQ(buffer.free_one().size(), 4);
+
+	// A buffer without capacity has no free slot
+	non_stl::dynamic_circular_buffer<char> none;
+	ASSERT_TRUE(none.free_one().empty());
+	ASSERT_TRUE(none.free_two().empty());
+}
+
+// Iterators
+
+TEST(DynamicIteratorTest, Basic) {
+	non_stl::dynamic_circular_buffer<int> buffer(5);
+	for (int i = 0; i < 8; ++i) {
+		buffer.push_back(i);
+	}
+
+	int expected = 3;
+	for (auto it = buffer.begin(); it != buffer.end(); ++it) {
+		ASSERT_EQ(*it, expected++);
+	}
+
+	for (auto it = buffer.rbegin(); it != buffer.rend(); ++it) {
+		ASSERT_EQ(*it, --expected);
+	}
+	ASSERT_EQ(expected, 3);
+
+	const auto& cbuffer = buffer;
+	non_stl::dynamic_circular_buffer<int>::const_iterator cit = buffer.begin();
+	ASSERT_EQ(cbuffer.end() - cit, 5);
+	ASSERT_EQ(cit[4], 7);
+	ASSERT_EQ(*std::max_element(cbuffer.begin(), cbuffer.end()), 7);
+}
+
+// Copy / move
+
+TEST(DynamicCopyMoveTest, Basic) {
+	non_stl::dynamic_circular_buffer<std::string> buffer(3);
+	buffer.push_back("a");
+	buffer.push_back("b");
+	buffer.push_back("c");
+	buffer.push_back("d");
+
+	non_stl::dynamic_circular_buffer<std::string> copy(buffer);
+	ASSERT_EQ(copy.capacity(), 3);
+	ASSERT_EQ(copy.front(), "b");
+	ASSERT_EQ(copy.back(), "d");
+
+	non_stl::dynamic_circular_buffer<std::string> moved(std::move(copy));
+	ASSERT_EQ(moved.size(), 3);
+	ASSERT_EQ(copy.capacity(), 0);
+
+	non_stl::dynamic_circular_buffer<std::string> assigned(10, non_stl::overflow_policy::grow);
+	assigned.push_back("x");
+	assigned = buffer;
+	ASSERT_EQ(assigned.capacity(), 3);
+	ASSERT_EQ(assigned.policy(), non_stl::overflow_policy::overwrite);
+	ASSERT_EQ(assigned[1], "c");
+
+	assigned = std::move(moved);
+	ASSERT_EQ(assigned.front(), "b");
+
+	assigned.swap(buffer);
+	ASSERT_EQ(buffer.front(), "b");
+	ASSERT_EQ(assigned.front(), "b");
+}
+
+TEST(DynamicLifetimeTest, Basic) {
+	auto tracker = std::make_shared<int>(0);
+	{
+		non_stl::dynamic_circular_buffer<std::shared_ptr<int> > buffer(2);
+		buffer.push_back(tracker);
+		buffer.push_back(tracker);
+		buffer.push_back(tracker);
+		ASSERT_EQ(tracker.use_count(), 3);
+
+		buffer.pop_front();
+		ASSERT_EQ(tracker.use_count(), 2);
+	}
+	ASSERT_EQ(tracker.use_count(), 1);
+}
+
+// Allocators
+
+TEST(DynamicAllocatorTest, Basic) {
+	non_stl::monotonic_buffer arena;
+	non_stl::dynamic_circular_buffer<int, non_stl::arena_allocator<int> > buffer(16, non_stl::overflow_policy::overwrite, arena);
+	ASSERT_EQ(arena.bytes_allocated(), 16 * sizeof(int));
+
+	for (int i = 0; i < 40; ++i) {
+		buffer.push_back(i);
+	}
+	ASSERT_EQ(buffer.front(), 24);
+
+	non_stl::monotonic_buffer resource;
+	non_stl::pmr::dynamic_circular_buffer<int> pmr(4, non_stl::overflow_policy::grow, &resource);
+	for (int i = 0; i < 10; ++i) {
+		pmr.push_back(i);
+	}
+	ASSERT_EQ(pmr.size(), 10);
+	ASSERT_EQ(pmr.get_allocator().resource(), &resource);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
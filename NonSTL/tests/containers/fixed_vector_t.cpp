@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "../../containers/fixed_vector.h"
+#include "../../containers/vector.h"
+
+// Compile time tables
+
+// Squares of 0 to n - 1, built by a constexpr function into a constexpr variable
+template <size_type N>
+constexpr non_stl::fixed_vector<int, N> squares(int n)
+{
+	non_stl::fixed_vector<int, N> table;
+	for (int i = 0; i < n; ++i)
+	{
+		table.push_back(i * i);
+	}
+	return table;
+}
+
+constexpr auto square_table = squares<16>(10);
+static_assert(square_table.size() == 10, "table holds the pushed elements");
+static_assert(square_table[9] == 81, "table is computed at compile time");
+static_assert(square_table.capacity() == 16, "capacity is N");
+
+// Primes below 50, using insert and erase during constant evaluation
+constexpr non_stl::fixed_vector<int, 64> primes()
+{
+	non_stl::fixed_vector<int, 64> table;
+	for (int i = 2; i < 50; ++i)
+	{
+		table.push_back(i);
+	}
+
+	for (size_type i = 0; i < table.size(); ++i)
+	{
+		for (size_type j = i + 1; j < table.size();)
+		{
+			if (table[j] % table[i] == 0)
+			{
+				table.erase(table.begin() + j);
+			}
+			else
+			{
+				++j;
+			}
+		}
+	}
+
+	table.insert(table.begin(), 1);
+	table.erase(table.begin());
+	return table;
+}
+
+constexpr auto prime_table = primes();
+static_assert(prime_table.size() == 15, "15 primes below 50");
+static_assert(prime_table.front() == 2 && prime_table.back() == 47, "sieve keeps the primes in order");
+
+struct Entry
+{
+	int key = -1;
+	int value = 0;
+
+	constexpr Entry() = default;
+	constexpr Entry(int k, int v) : key(k), value(v) {}
+
+	constexpr bool operator==(const Entry& other) const { return key == other.key && value == other.value; }
+};
+
+constexpr non_stl::fixed_vector<Entry, 8> entries()
+{
+	non_stl::fixed_vector<Entry, 8> table(2);
+	table.emplace_back(3, 30);
+	table.emplace(table.begin() + 1, 1, 10);
+	table.resize(3);
+
+	non_stl::fixed_vector<Entry, 8> other = { Entry(7, 70) };
+	other.swap(table);
+	other.pop_back();
+	return other;
+}
+
+static_assert(entries().size() == 2, "swap moves the elements across");
+static_assert(entries()[1] == Entry(1, 10), "emplace shifts the tail up");
+static_assert(entries() == non_stl::fixed_vector<Entry, 8>({ Entry(), Entry(1, 10) }), "equality compares elements");
+
+#if defined(NON_STL_CONSTEXPR_DYNAMIC_ALLOC)
+// A non_stl::vector can be used while computing a table as long as it doesn't outlive the evaluation
+constexpr non_stl::fixed_vector<int, 8> from_vector()
+{
+	non_stl::vector<int> vec;
+	for (int i = 0; i < 100; ++i)
+	{
+		vec.push_back(i);
+	}
+	vec.insert(vec.begin(), { -3, -2, -1 });
+	vec.erase(vec.begin() + 3, vec.end() - 5);
+	vec.resize(10, 7);
+
+	non_stl::vector<int> copy = vec;
+	copy.reserve(1000);
+	copy.shrink_to_fit();
+
+	return non_stl::fixed_vector<int, 8>(copy.begin() + 2, copy.begin() + 10);
+}
+
+static_assert(from_vector() == non_stl::fixed_vector<int, 8>({ -1, 95, 96, 97, 98, 99, 7, 7 }), "vector is usable in constant expressions");
+
+constexpr size_type string_lengths()
+{
+	non_stl::vector<std::string> vec(3, "abc");
+	vec.emplace_back(40, 'x');
+	vec.insert(vec.begin(), "q");
+	vec.resize_default_init(6);
+
+	size_type total = 0;
+	for (const auto& s : vec)
+	{
+		total += s.size();
+	}
+	return total;
+}
+
+static_assert(string_lengths() == 50, "vector of strings is usable in constant expressions");
+#endif
+
+// Constructors
+
+TEST(FixedBasicConstruct, Basic) {
+	non_stl::fixed_vector<int, 4> vec;
+	ASSERT_EQ(vec.size(), 0);
+	ASSERT_TRUE(vec.empty());
+	ASSERT_FALSE(vec.full());
+	ASSERT_EQ(vec.capacity(), 4);
+}
+
+TEST(FixedFillConstruct, Basic) {
+	non_stl::fixed_vector<int, 4> vec(3, 5);
+	ASSERT_EQ(vec.size(), 3);
+	for (auto e : vec)
+	{
+		ASSERT_EQ(e, 5);
+	}
+
+	ASSERT_THROW((non_stl::fixed_vector<int, 4>(5)), std::length_error);
+}
+
+TEST(FixedRangeConstruct, Basic) {
+	const int arr[] = { 1, 2, 3 };
+	non_stl::fixed_vector<int, 4> vec(arr, arr + 3);
+	ASSERT_EQ(vec.size(), 3);
+	ASSERT_EQ(vec[2], 3);
+}
+
+// Compile time tables are usable at run time
+
+TEST(FixedConstexprTable, Basic) {
+	int sum = 0;
+	for (auto e : square_table)
+	{
+		sum += e;
+	}
+	ASSERT_EQ(sum, 285);
+	ASSERT_EQ(prime_table.at(3), 7);
+	ASSERT_THROW(prime_table.at(15), std::out_of_range);
+}
+
+// Capacity
+
+TEST(FixedPushPastCapacity, Basic) {
+	non_stl::fixed_vector<int, 2> vec;
+	vec.push_back(1);
+	vec.push_back(2);
+	ASSERT_TRUE(vec.full());
+	ASSERT_THROW(vec.push_back(3), std::length_error);
+	ASSERT_THROW(vec.insert(vec.begin(), 3), std::length_error);
+	ASSERT_EQ(vec.size(), 2);
+	ASSERT_EQ(vec[0], 1);
+	ASSERT_EQ(vec[1], 2);
+}
+
+// Non trivial elements use uninitialized storage
+
+TEST(FixedStrings, Basic) {
+	non_stl::fixed_vector<std::string, 4> vec = { "b", "d" };
+	vec.insert(vec.begin(), "a");
+	vec.emplace(vec.begin() + 2, 1, 'c');
+	ASSERT_TRUE(vec.full());
+	ASSERT_EQ(vec, (non_stl::fixed_vector<std::string, 4>{ "a", "b", "c", "d" }));
+
+	// Inserting an element of the vector itself
+	vec.pop_back();
+	vec.insert(vec.begin(), vec[2]);
+	ASSERT_EQ(vec, (non_stl::fixed_vector<std::string, 4>{ "c", "a", "b", "c" }));
+
+	vec.erase(vec.begin() + 1, vec.begin() + 3);
+	ASSERT_EQ(vec.size(), 2);
+	ASSERT_EQ(vec.back(), "c");
+}
+
+TEST(FixedStringsCopyMove, Basic) {
+	non_stl::fixed_vector<std::string, 4> vec = { std::string(32, 'a'), "b", "c" };
+
+	auto copy = vec;
+	ASSERT_EQ(copy, vec);
+
+	auto moved = std::move(copy);
+	ASSERT_EQ(moved, vec);
+
+	non_stl::fixed_vector<std::string, 4> shorter = { "x" };
+	shorter = vec;
+	ASSERT_EQ(shorter, vec);
+
+	non_stl::fixed_vector<std::string, 4> longer = { "1", "2", "3", "4" };
+	longer = std::move(moved);
+	ASSERT_EQ(longer, vec);
+
+	longer.resize(1);
+	longer.swap(vec);
+	ASSERT_EQ(longer.size(), 3);
+	ASSERT_EQ(vec.size(), 1);
+	ASSERT_EQ(vec[0], std::string(32, 'a'));
+	ASSERT_EQ(longer[2], "c");
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
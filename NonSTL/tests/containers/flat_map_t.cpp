@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../containers/flat_map.h"
+
+using eytzinger_map = non_stl::flat_map<int, std::string, std::less<int>, non_stl::eytzinger_search>;
+
+// Returns the keys of map in iteration order
+template <class Map>
+static std::vector<typename Map::key_type> keys(const Map& map) {
+	std::vector<typename Map::key_type> result;
+	for (auto entry : map) {
+		result.push_back(entry.first);
+	}
+	return result;
+}
+
+// Constructors
+
+TEST(FlatMapConstructTest, Basic) {
+	non_stl::flat_map<int, std::string> empty;
+	ASSERT_TRUE(empty.empty());
+	ASSERT_EQ(empty.begin(), empty.end());
+	ASSERT_EQ(empty.find(1), empty.end());
+
+	non_stl::flat_map<int, std::string> init{ { 3, "c" }, { 1, "a" }, { 2, "b" }, { 1, "z" } };
+	ASSERT_EQ(init.size(), 3);
+	ASSERT_EQ(keys(init), (std::vector<int>{ 1, 2, 3 }));
+
+	// The first of equivalent keys wins
+	ASSERT_EQ(init.at(1), "a");
+
+	non_stl::flat_map<int, std::string> copy(init);
+	ASSERT_EQ(copy, init);
+
+	non_stl::flat_map<int, std::string> moved(std::move(copy));
+	ASSERT_EQ(moved, init);
+}
+
+TEST(FlatMapConstructTest, Bulk) {
+	non_stl::vector<int> k{ 5, 3, 9, 3, 1 };
+	non_stl::vector<std::string> v{ "five", "three", "nine", "drei", "one" };
+	non_stl::flat_map<int, std::string> map(std::move(k), std::move(v));
+
+	ASSERT_EQ(keys(map), (std::vector<int>{ 1, 3, 5, 9 }));
+	ASSERT_EQ(map.at(3), "three");
+	ASSERT_EQ(map.values()[2], "five");
+
+	// Already sorted input is taken as is
+	non_stl::flat_map<int, int> sorted(non_stl::sorted_unique, non_stl::vector<int>{ 1, 2, 3 }, non_stl::vector<int>{ 4, 5, 6 });
+	ASSERT_EQ(sorted.at(2), 5);
+
+	ASSERT_THROW((non_stl::flat_map<int, int>(non_stl::vector<int>{ 1 }, non_stl::vector<int>{})), std::invalid_argument);
+
+	std::map<int, int> source{ { 2, 20 }, { 1, 10 } };
+	non_stl::flat_map<int, int> ranged(source.begin(), source.end());
+	ASSERT_EQ(ranged.size(), 2);
+	ASSERT_EQ(ranged[1], 10);
+}
+
+// Lookup
+
+TEST(FlatMapLookupTest, Basic) {
+	non_stl::flat_map<int, std::string> map{ { 10, "ten" }, { 20, "twenty" }, { 30, "thirty" } };
+
+	ASSERT_EQ(map.find(20)->second, "twenty");
+	ASSERT_EQ(map.find(25), map.end());
+	ASSERT_TRUE(map.contains(30));
+	ASSERT_EQ(map.count(10), 1);
+	ASSERT_EQ(map.count(11), 0);
+	ASSERT_THROW(map.at(40), std::out_of_range);
+
+	ASSERT_EQ(map.lower_bound(15)->first, 20);
+	ASSERT_EQ(map.lower_bound(20)->first, 20);
+	ASSERT_EQ(map.upper_bound(20)->first, 30);
+	ASSERT_EQ(map.upper_bound(30), map.end());
+
+	auto range = map.equal_range(20);
+	ASSERT_EQ(range.second - range.first, 1);
+	range = map.equal_range(21);
+	ASSERT_EQ(range.first, range.second);
+}
+
+TEST(FlatMapLookupTest, Heterogeneous) {
+	non_stl::flat_map<std::string, int, std::less<> > map{ { "a", 1 }, { "b", 2 } };
+	ASSERT_EQ(map.find("b")->second, 2);
+	ASSERT_TRUE(map.contains("a"));
+	ASSERT_EQ(map.count("c"), 0);
+}
+
+TEST(FlatMapLookupTest, Eytzinger) {
+	// Every size up to a few full levels of the implicit tree
+	for (int n = 0; n < 70; ++n) {
+		eytzinger_map map;
+		for (int i = 0; i < n; ++i) {
+			map.try_emplace(2 * i, std::to_string(i));
+		}
+		for (int i = -1; i <= 2 * n; ++i) {
+			auto it = map.lower_bound(i);
+			const int expected = i < 0 ? 0 : (i + 1) / 2 * 2;
+			if (expected >= 2 * n) {
+				ASSERT_EQ(it, map.end());
+			}
+			else {
+				ASSERT_EQ(it->first, expected);
+			}
+			ASSERT_EQ(map.contains(i), i >= 0 && i % 2 == 0 && i < 2 * n);
+		}
+	}
+}
+
+TEST(FlatMapLookupTest, Random) {
+	std::mt19937 rng(7);
+	std::map<int, int> reference;
+	non_stl::flat_map<int, int> branchless;
+	non_stl::flat_map<int, int, std::less<int>, non_stl::eytzinger_search> eytzinger;
+
+	for (int i = 0; i < 2000; ++i) {
+		const int key = static_cast<int>(rng() % 500);
+		if (rng() % 3 == 0) {
+			const auto erased = reference.erase(key);
+			ASSERT_EQ(branchless.erase(key), erased);
+			ASSERT_EQ(eytzinger.erase(key), erased);
+		}
+		else {
+			reference[key] = i;
+			branchless.insert_or_assign(key, i);
+			eytzinger.insert_or_assign(key, i);
+		}
+	}
+
+	ASSERT_EQ(branchless.size(), reference.size());
+	ASSERT_EQ(eytzinger.size(), reference.size());
+	for (int key = 0; key < 500; ++key) {
+		auto expected = reference.find(key);
+		if (expected == reference.end()) {
+			ASSERT_FALSE(branchless.contains(key));
+			ASSERT_FALSE(eytzinger.contains(key));
+		}
+		else {
+			ASSERT_EQ(branchless.at(key), expected->second);
+			ASSERT_EQ(eytzinger.at(key), expected->second);
+		}
+	}
+}
+
+// Modifiers
+
+TEST(FlatMapModifyTest, Insert) {
+	non_stl::flat_map<int, std::string> map;
+
+	auto result = map.insert({ 2, "two" });
+	ASSERT_TRUE(result.second);
+	ASSERT_EQ(result.first->second, "two");
+
+	result = map.insert({ 2, "deux" });
+	ASSERT_FALSE(result.second);
+	ASSERT_EQ(result.first->second, "two");
+
+	result = map.insert_or_assign(2, "deux");
+	ASSERT_FALSE(result.second);
+	ASSERT_EQ(map.at(2), "deux");
+
+	map.emplace(1, "one");
+	map.try_emplace(3, 3, 'x');
+	map[0] = "zero";
+	ASSERT_EQ(keys(map), (std::vector<int>{ 0, 1, 2, 3 }));
+	ASSERT_EQ(map.at(3), "xxx");
+
+	// Values are modified through the iterators
+	map.begin()->second = "nil";
+	ASSERT_EQ(map.at(0), "nil");
+}
+
+TEST(FlatMapModifyTest, BulkInsert) {
+	non_stl::flat_map<int, int> map{ { 5, 50 }, { 1, 10 } };
+
+	// Unsorted range with duplicates of existing and new keys
+	std::vector<std::pair<int, int> > more{ { 4, 40 }, { 1, 11 }, { 9, 90 }, { 4, 41 }, { 0, 0 } };
+	map.insert(more.begin(), more.end());
+	ASSERT_EQ(keys(map), (std::vector<int>{ 0, 1, 4, 5, 9 }));
+	ASSERT_EQ(map.at(1), 10);
+	ASSERT_EQ(map.at(4), 40);
+
+	// Sorted range past the end is appended without sorting
+	map.insert({ { 10, 100 }, { 11, 110 } });
+	ASSERT_EQ(map.size(), 7);
+	ASSERT_EQ(map.rbegin()->first, 11);
+
+	// The arrays stay aligned
+	for (size_t i = 0; i < map.size(); ++i) {
+		ASSERT_EQ(map.values()[i], map.keys()[i] * 10);
+	}
+}
+
+TEST(FlatMapModifyTest, Erase) {
+	non_stl::flat_map<int, int> map{ { 1, 1 }, { 2, 2 }, { 3, 3 }, { 4, 4 } };
+
+	auto it = map.erase(map.find(2));
+	ASSERT_EQ(it->first, 3);
+	ASSERT_EQ(map.erase(3), 1);
+	ASSERT_EQ(map.erase(3), 0);
+	ASSERT_EQ(keys(map), (std::vector<int>{ 1, 4 }));
+
+	map.erase(map.begin(), map.end());
+	ASSERT_TRUE(map.empty());
+}
+
+TEST(FlatMapModifyTest, ExtractReplace) {
+	eytzinger_map map{ { 2, "b" }, { 1, "a" } };
+
+	auto parts = map.extract();
+	ASSERT_TRUE(map.empty());
+	ASSERT_FALSE(map.contains(1));
+	ASSERT_EQ(parts.keys.size(), 2);
+	ASSERT_EQ(parts.keys[0], 1);
+	ASSERT_EQ(parts.values[0], "a");
+
+	parts.keys.push_back(3);
+	parts.values.push_back("c");
+	map.replace(std::move(parts.keys), std::move(parts.values));
+	ASSERT_EQ(map.at(3), "c");
+
+	eytzinger_map other{ { 7, "g" } };
+	map.swap(other);
+	ASSERT_EQ(map.size(), 1);
+	ASSERT_TRUE(map.contains(7));
+	ASSERT_TRUE(other.contains(2));
+
+	map.clear();
+	ASSERT_TRUE(map.empty());
+	ASSERT_EQ(map.find(7), map.end());
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
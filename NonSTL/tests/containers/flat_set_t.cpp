@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../../containers/flat_set.h"
+
+using eytzinger_set = non_stl::flat_set<int, std::less<int>, non_stl::eytzinger_search>;
+
+// Returns the keys of set in iteration order
+template <class Set>
+static std::vector<typename Set::key_type> keys(const Set& set) {
+	return std::vector<typename Set::key_type>(set.begin(), set.end());
+}
+
+// Constructors
+
+TEST(FlatSetConstructTest, Basic) {
+	non_stl::flat_set<int> empty;
+	ASSERT_TRUE(empty.empty());
+	ASSERT_EQ(empty.begin(), empty.end());
+
+	non_stl::flat_set<int> init{ 3, 1, 2, 1 };
+	ASSERT_EQ(keys(init), (std::vector<int>{ 1, 2, 3 }));
+
+	non_stl::flat_set<int> bulk(non_stl::vector<int>{ 9, 4, 4, 7 });
+	ASSERT_EQ(keys(bulk), (std::vector<int>{ 4, 7, 9 }));
+
+	non_stl::flat_set<int> sorted(non_stl::sorted_unique, non_stl::vector<int>{ 1, 5 });
+	ASSERT_TRUE(sorted.contains(5));
+
+	std::vector<int> source{ 8, 6, 8 };
+	non_stl::flat_set<int> ranged(source.begin(), source.end());
+	ASSERT_EQ(keys(ranged), (std::vector<int>{ 6, 8 }));
+
+	non_stl::flat_set<int> copy(init);
+	ASSERT_EQ(copy, init);
+	ASSERT_NE(copy, bulk);
+}
+
+// Lookup
+
+TEST(FlatSetLookupTest, Basic) {
+	non_stl::flat_set<int> set{ 10, 20, 30 };
+
+	ASSERT_EQ(*set.find(20), 20);
+	ASSERT_EQ(set.find(25), set.end());
+	ASSERT_EQ(set.count(30), 1);
+	ASSERT_EQ(*set.lower_bound(11), 20);
+	ASSERT_EQ(*set.upper_bound(10), 20);
+	ASSERT_EQ(set.upper_bound(30), set.end());
+	ASSERT_EQ(*set.rbegin(), 30);
+
+	auto range = set.equal_range(10);
+	ASSERT_EQ(range.second - range.first, 1);
+
+	non_stl::flat_set<std::string, std::less<> > strings{ "b", "a" };
+	ASSERT_TRUE(strings.contains("a"));
+	ASSERT_EQ(strings.find("c"), strings.end());
+}
+
+TEST(FlatSetLookupTest, Random) {
+	std::mt19937 rng(11);
+	std::set<int> reference;
+	non_stl::flat_set<int> branchless;
+	eytzinger_set eytzinger;
+
+	for (int i = 0; i < 2000; ++i) {
+		const int key = static_cast<int>(rng() % 700);
+		if (rng() % 3 == 0) {
+			const auto erased = reference.erase(key);
+			ASSERT_EQ(branchless.erase(key), erased);
+			ASSERT_EQ(eytzinger.erase(key), erased);
+		}
+		else {
+			const bool inserted = reference.insert(key).second;
+			ASSERT_EQ(branchless.insert(key).second, inserted);
+			ASSERT_EQ(eytzinger.emplace(key).second, inserted);
+		}
+	}
+
+	ASSERT_EQ(keys(branchless), std::vector<int>(reference.begin(), reference.end()));
+	for (int key = -1; key <= 700; ++key) {
+		const bool expected = reference.count(key) != 0;
+		ASSERT_EQ(branchless.contains(key), expected);
+		ASSERT_EQ(eytzinger.contains(key), expected);
+
+		auto bound = reference.lower_bound(key);
+		auto it = eytzinger.lower_bound(key);
+		if (bound == reference.end()) {
+			ASSERT_EQ(it, eytzinger.end());
+		}
+		else {
+			ASSERT_EQ(*it, *bound);
+		}
+	}
+}
+
+// Modifiers
+
+TEST(FlatSetModifyTest, Basic) {
+	eytzinger_set set{ 5, 1 };
+
+	set.insert({ 3, 9, 1, 3 });
+	ASSERT_EQ(keys(set), (std::vector<int>{ 1, 3, 5, 9 }));
+
+	auto it = set.erase(set.find(3));
+	ASSERT_EQ(*it, 5);
+	ASSERT_EQ(set.erase(9), 1);
+	ASSERT_EQ(set.erase(9), 0);
+
+	auto extracted = set.extract();
+	ASSERT_TRUE(set.empty());
+	ASSERT_FALSE(set.contains(1));
+	ASSERT_EQ(extracted.size(), 2);
+
+	set.replace(std::move(extracted));
+	ASSERT_TRUE(set.contains(5));
+
+	eytzinger_set other{ 42 };
+	swap(set, other);
+	ASSERT_EQ(keys(set), (std::vector<int>{ 42 }));
+	ASSERT_TRUE(other.contains(1));
+
+	set.clear();
+	ASSERT_TRUE(set.empty());
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../../containers/linkedhashmap.h"
+#include "../../memory/arena_allocator.h"
+
+// Transparent hash so lookups by std::string_view don't build a std::string
+struct string_hash
+{
+	using is_transparent = void;
+	size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+};
+
+// Hash sending every key to the same group to exercise probing and tombstones
+struct colliding_hash
+{
+	size_t operator()(int) const { return 0; }
+};
+
+// Returns the keys of map in iteration order
+template <class Map>
+static std::vector<typename Map::key_type> keys(const Map& map) {
+	std::vector<typename Map::key_type> result;
+	for (auto& entry : map) {
+		result.push_back(entry.first);
+	}
+	return result;
+}
+
+// Constructors
+
+TEST(LinkedHashMapConstructTest, Basic) {
+	non_stl::linkedhashmap<int, int> empty;
+	ASSERT_TRUE(empty.empty());
+	ASSERT_EQ(empty.begin(), empty.end());
+	ASSERT_EQ(empty.bucket_count(), 0);
+	ASSERT_EQ(empty.find(1), empty.end());
+
+	non_stl::linkedhashmap<int, std::string> init{ { 3, "c" }, { 1, "a" }, { 2, "b" }, { 1, "z" } };
+	ASSERT_EQ(init.size(), 3);
+	ASSERT_EQ(keys(init), (std::vector<int>{ 3, 1, 2 }));
+	ASSERT_EQ(init.at(1), "a");
+
+	non_stl::linkedhashmap<int, std::string> copy(init);
+	ASSERT_EQ(keys(copy), (std::vector<int>{ 3, 1, 2 }));
+	ASSERT_EQ(copy[2], "b");
+
+	non_stl::linkedhashmap<int, std::string> moved(std::move(copy));
+	ASSERT_TRUE(copy.empty());
+	ASSERT_EQ(moved.size(), 3);
+	ASSERT_EQ(moved.at(3), "c");
+
+	non_stl::linkedhashmap<int, std::string> assigned;
+	assigned[10] = "x";
+	assigned = init;
+	ASSERT_EQ(keys(assigned), (std::vector<int>{ 3, 1, 2 }));
+	assigned = std::move(moved);
+	ASSERT_EQ(assigned.size(), 3);
+	assigned = { { 5, "e" } };
+	ASSERT_EQ(keys(assigned), (std::vector<int>{ 5 }));
+}
+
+// Insertion order
+
+TEST(LinkedHashMapOrderTest, Basic) {
+	non_stl::linkedhashmap<std::string, int> map;
+	map["one"] = 1;
+	map["two"] = 2;
+	map["three"] = 3;
+
+	// Updating a value keeps its position
+	map["one"] = 10;
+	map.insert_or_assign("two", 20);
+	ASSERT_EQ(keys(map), (std::vector<std::string>{ "one", "two", "three" }));
+	ASSERT_EQ(map.front().second, 10);
+	ASSERT_EQ(map.back().first, "three");
+
+	auto result = map.insert({ "two", 99 });
+	ASSERT_FALSE(result.second);
+	ASSERT_EQ(result.first->second, 20);
+
+	std::vector<std::string> reversed;
+	for (auto it = map.rbegin(); it != map.rend(); ++it) {
+		reversed.push_back(it->first);
+	}
+	ASSERT_EQ(reversed, (std::vector<std::string>{ "three", "two", "one" }));
+
+	map.move_to_back(map.find("one"));
+	ASSERT_EQ(keys(map), (std::vector<std::string>{ "two", "three", "one" }));
+	map.move_to_front(map.find("three"));
+	ASSERT_EQ(keys(map), (std::vector<std::string>{ "three", "two", "one" }));
+
+	map.pop_front();
+	ASSERT_EQ(keys(map), (std::vector<std::string>{ "two", "one" }));
+}
+
+// Erase
+
+TEST(LinkedHashMapEraseTest, Basic) {
+	non_stl::linkedhashmap<int, int> map;
+	for (int i = 0; i < 10; ++i) {
+		map[i] = i * i;
+	}
+
+	ASSERT_EQ(map.erase(3), 1);
+	ASSERT_EQ(map.erase(3), 0);
+	auto it = map.erase(map.find(5));
+	ASSERT_EQ(it->first, 6);
+	it = map.erase(map.find(7), map.find(9));
+	ASSERT_EQ(it->first, 9);
+	ASSERT_EQ(keys(map), (std::vector<int>{ 0, 1, 2, 4, 6, 9 }));
+
+	// Erased nodes are reused and the new entries go to the back
+	map[100] = 1;
+	map[3] = 2;
+	ASSERT_EQ(keys(map), (std::vector<int>{ 0, 1, 2, 4, 6, 9, 100, 3 }));
+	ASSERT_FALSE(map.contains(5));
+	ASSERT_EQ(map.count(4), 1);
+}
+
+TEST(LinkedHashMapEraseTest, StableReferences) {
+	non_stl::linkedhashmap<int, std::string> map;
+	map[0] = "zero";
+	std::string& ref = map[0];
+	auto it = map.find(0);
+
+	// Growing the table never moves an entry
+	for (int i = 1; i < 1000; ++i) {
+		map[i] = std::to_string(i);
+	}
+	ASSERT_EQ(&ref, &map[0]);
+	ASSERT_EQ(it->second, "zero");
+	ASSERT_GE(map.bucket_count(), 1000);
+	ASSERT_LE(map.load_factor(), map.max_load_factor());
+}
+
+TEST(LinkedHashMapEraseTest, Collisions) {
+	non_stl::linkedhashmap<int, int, colliding_hash> map;
+
+	// Every key probes the same sequence, erasing and inserting leaves tombstones behind
+	for (int round = 0; round < 20; ++round) {
+		for (int i = 0; i < 40; ++i) {
+			map[round * 40 + i] = i;
+		}
+		for (int i = 0; i < 40; i += 2) {
+			map.erase(round * 40 + i);
+		}
+	}
+	ASSERT_EQ(map.size(), 20 * 20);
+
+	for (int round = 0; round < 20; ++round) {
+		for (int i = 0; i < 40; ++i) {
+			ASSERT_EQ(map.contains(round * 40 + i), i % 2 == 1);
+		}
+	}
+}
+
+// Compared against std::unordered_map with a mix of operations
+TEST(LinkedHashMapEraseTest, Random) {
+	non_stl::linkedhashmap<unsigned, unsigned> map;
+	std::unordered_map<unsigned, unsigned> reference;
+
+	unsigned state = 12345;
+	for (int i = 0; i < 20000; ++i) {
+		state = state * 1103515245 + 12345;
+		const unsigned key = (state >> 8) % 500;
+		if (state & 1) {
+			map[key] = i;
+			reference[key] = i;
+		}
+		else {
+			ASSERT_EQ(map.erase(key), reference.erase(key));
+		}
+	}
+
+	ASSERT_EQ(map.size(), reference.size());
+	for (auto& entry : reference) {
+		ASSERT_EQ(map.at(entry.first), entry.second);
+	}
+}
+
+// Lookup
+
+TEST(LinkedHashMapLookupTest, Heterogeneous) {
+	non_stl::linkedhashmap<std::string, int, string_hash, std::equal_to<> > map;
+	map["alpha"] = 1;
+	map.emplace("beta", 2);
+	map.try_emplace("gamma", 3);
+
+	const std::string_view key("beta");
+	ASSERT_NE(map.find(key), map.end());
+	ASSERT_EQ(map.find(key)->second, 2);
+	ASSERT_TRUE(map.contains(std::string_view("gamma")));
+	ASSERT_EQ(map.count("alpha"), 1);
+	ASSERT_FALSE(map.contains("delta"));
+
+	const auto& cmap = map;
+	ASSERT_EQ(cmap.find(std::string_view("alpha"))->second, 1);
+	ASSERT_THROW(cmap.at("delta"), std::out_of_range);
+}
+
+// Hash policy
+
+TEST(LinkedHashMapReserveTest, Basic) {
+	non_stl::linkedhashmap<int, int> map;
+	map.reserve(100);
+	const auto buckets = map.bucket_count();
+	ASSERT_GE(buckets * map.max_load_factor(), 100);
+
+	for (int i = 0; i < 100; ++i) {
+		map.emplace(i, i);
+	}
+	ASSERT_EQ(map.bucket_count(), buckets);
+
+	map.clear();
+	ASSERT_TRUE(map.empty());
+	ASSERT_EQ(map.bucket_count(), buckets);
+	ASSERT_EQ(map.begin(), map.end());
+	map[1] = 1;
+	ASSERT_EQ(map.size(), 1);
+}
+
+TEST(LinkedHashMapReserveTest, Rehash) {
+	non_stl::linkedhashmap<int, int> map;
+	for (int i = 0; i < 100; ++i) {
+		map.emplace(i, i);
+	}
+
+	map.rehash(1000);
+	ASSERT_EQ(map.bucket_count(), 1024);
+	ASSERT_EQ(map.size(), 100);
+	ASSERT_EQ(map.at(42), 42);
+
+	// Never shrinks below what the entries need
+	map.rehash(0);
+	ASSERT_GE(map.bucket_count() * map.max_load_factor(), 100);
+
+	// Churning at a constant size drops the tombstones in place
+	map.rehash(1024);
+	for (int i = 100; i < 10000; ++i) {
+		map.erase(i - 100);
+		map.emplace(i, i);
+	}
+	ASSERT_EQ(map.bucket_count(), 1024);
+	ASSERT_EQ(map.size(), 100);
+	ASSERT_EQ(map.front().first, 9900);
+}
+
+// Modifiers
+
+TEST(LinkedHashMapSwapTest, Basic) {
+	non_stl::linkedhashmap<int, int> a{ { 1, 1 }, { 2, 2 } };
+	non_stl::linkedhashmap<int, int> b{ { 3, 3 } };
+	a.swap(b);
+	ASSERT_EQ(keys(a), (std::vector<int>{ 3 }));
+	ASSERT_EQ(keys(b), (std::vector<int>{ 1, 2 }));
+}
+
+// Allocators
+
+TEST(LinkedHashMapAllocatorTest, Arena) {
+	using value_type = std::pair<const int, std::string>;
+	non_stl::monotonic_buffer buffer;
+	non_stl::arena_allocator<value_type> alloc(buffer);
+
+	non_stl::linkedhashmap<int, std::string, std::hash<int>, std::equal_to<int>, non_stl::arena_allocator<value_type> > map(alloc);
+	for (int i = 0; i < 100; ++i) {
+		map[i] = std::to_string(i);
+	}
+	ASSERT_GT(buffer.bytes_allocated(), 0u);
+
+	// Unequal arenas which don't propagate move the entries over
+	non_stl::monotonic_buffer other_buffer;
+	non_stl::linkedhashmap<int, std::string, std::hash<int>, std::equal_to<int>, non_stl::arena_allocator<value_type> > other(
+		non_stl::arena_allocator<value_type>{ other_buffer });
+	other = std::move(map);
+	ASSERT_EQ(other.size(), 100);
+	ASSERT_EQ(other.at(42), "42");
+	ASSERT_EQ(other.get_allocator().buffer(), &other_buffer);
+
+	non_stl::monotonic_buffer resource;
+	non_stl::pmr::linkedhashmap<int, int> pmr(&resource);
+	pmr[1] = 2;
+	ASSERT_EQ(pmr.get_allocator().resource(), &resource);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
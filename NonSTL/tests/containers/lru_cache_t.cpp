@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../../containers/lru_cache.h"
+
+// Allocator counting every allocation it has served
+static int total_allocations = 0;
+
+template <class T>
+struct counting_allocator
+{
+	using value_type = T;
+
+	counting_allocator() = default;
+	template <class U>
+	counting_allocator(const counting_allocator<U>&) {}
+
+	T* allocate(size_t n) {
+		++total_allocations;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T* p, size_t n) {
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	friend bool operator==(const counting_allocator&, const counting_allocator&) { return true; }
+	friend bool operator!=(const counting_allocator&, const counting_allocator&) { return false; }
+};
+
+// Eviction policy recording the evicted entries
+struct record_eviction
+{
+	std::vector<std::pair<int, std::string> >* evicted;
+
+	void operator()(const int& key, std::string& value) const {
+		evicted->emplace_back(key, value);
+	}
+};
+
+// Returns the keys of cache from the least to the most recently used
+template <class Cache>
+static std::vector<int> keys(const Cache& cache) {
+	std::vector<int> result;
+	for (auto& entry : cache) {
+		result.push_back(entry.first);
+	}
+	return result;
+}
+
+// Basic usage
+
+TEST(LruCacheTest, PutGet) {
+	non_stl::lru_cache<int, std::string, 3> cache;
+	ASSERT_TRUE(cache.empty());
+	ASSERT_EQ(cache.capacity(), 3);
+	ASSERT_EQ(cache.get(1), nullptr);
+
+	cache.put(1, "one");
+	cache.put(2, "two");
+	ASSERT_EQ(cache.size(), 2);
+	ASSERT_EQ(*cache.get(1), "one");
+	ASSERT_TRUE(cache.contains(2));
+	ASSERT_FALSE(cache.contains(3));
+
+	// Overwriting keeps a single entry
+	cache.put(2, "deux");
+	ASSERT_EQ(cache.size(), 2);
+	ASSERT_EQ(*cache.peek(2), "deux");
+
+	ASSERT_TRUE(cache.erase(1));
+	ASSERT_FALSE(cache.erase(1));
+	ASSERT_EQ(cache.size(), 1);
+
+	cache.clear();
+	ASSERT_TRUE(cache.empty());
+}
+
+// Recency
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+	non_stl::lru_cache<int, std::string, 3> cache;
+	cache.put(1, "one");
+	cache.put(2, "two");
+	cache.put(3, "three");
+	ASSERT_EQ(keys(cache), (std::vector<int>{ 1, 2, 3 }));
+
+	cache.put(4, "four");
+	ASSERT_EQ(cache.size(), 3);
+	ASSERT_FALSE(cache.contains(1));
+	ASSERT_EQ(keys(cache), (std::vector<int>{ 2, 3, 4 }));
+}
+
+TEST(LruCacheTest, HitRefreshesEntry) {
+	non_stl::lru_cache<int, std::string, 3> cache;
+	cache.put(1, "one");
+	cache.put(2, "two");
+	cache.put(3, "three");
+
+	// get moves 1 to the back, peek leaves 2 at the front
+	ASSERT_NE(cache.get(1), nullptr);
+	ASSERT_NE(cache.peek(2), nullptr);
+	ASSERT_EQ(keys(cache), (std::vector<int>{ 2, 3, 1 }));
+
+	// Overwriting refreshes too
+	cache.put(2, "deux");
+	ASSERT_EQ(keys(cache), (std::vector<int>{ 3, 1, 2 }));
+
+	cache.put(4, "four");
+	ASSERT_EQ(keys(cache), (std::vector<int>{ 1, 2, 4 }));
+
+	ASSERT_EQ(cache.get_or_emplace(1, "uno"), "one");
+	ASSERT_EQ(cache.get_or_emplace(5, "five"), "five");
+	ASSERT_EQ(keys(cache), (std::vector<int>{ 4, 1, 5 }));
+}
+
+TEST(LruCacheTest, EvictionCallback) {
+	std::vector<std::pair<int, std::string> > evicted;
+	non_stl::lru_cache<int, std::string, 2, record_eviction> cache(record_eviction{ &evicted });
+
+	cache.put(1, "one");
+	cache.put(2, "two");
+	cache.put(1, "uno");
+	ASSERT_TRUE(evicted.empty());
+
+	cache.put(3, "three");
+	ASSERT_EQ(evicted.size(), 1);
+	ASSERT_EQ(evicted[0], (std::pair<int, std::string>(2, "two")));
+
+	cache.evict();
+	ASSERT_EQ(evicted.size(), 2);
+	ASSERT_EQ(evicted[1], (std::pair<int, std::string>(1, "uno")));
+
+	// Entries removed explicitly are not reported
+	cache.erase(3);
+	cache.put(4, "four");
+	cache.clear();
+	ASSERT_EQ(evicted.size(), 2);
+}
+
+TEST(LruCacheTest, NoAllocationsOnceFull) {
+	using alloc = counting_allocator<std::pair<const int, std::string> >;
+	non_stl::lru_cache<int, std::string, 100, non_stl::ignore_eviction, std::hash<int>, std::equal_to<int>, alloc> cache;
+
+	for (int i = 0; i < 100; ++i) {
+		cache.put(i, "");
+	}
+	const int allocations = total_allocations;
+
+	for (int i = 100; i < 10000; ++i) {
+		cache.put(i, "");
+		cache.get(i - 50);
+	}
+	ASSERT_EQ(cache.size(), 100);
+	ASSERT_EQ(total_allocations, allocations);
+}
+
+// Sharded cache
+
+TEST(ShardedLruCacheTest, Basic) {
+	non_stl::sharded_lru_cache<int, std::string, 64, 4> cache;
+	ASSERT_EQ(cache.capacity(), 64);
+	ASSERT_EQ(cache.shard_count(), 4);
+	ASSERT_FALSE(cache.get(1).has_value());
+
+	cache.put(1, "one");
+	ASSERT_EQ(cache.get(1), std::optional<std::string>("one"));
+	ASSERT_TRUE(cache.contains(1));
+	ASSERT_TRUE(cache.visit(1, [](std::string& value) { value += "!"; }));
+	ASSERT_EQ(*cache.get(1), "one!");
+	ASSERT_FALSE(cache.visit(2, [](std::string&) {}));
+
+	// No shard ever holds more than its share
+	for (int i = 0; i < 1000; ++i) {
+		cache.put(i, std::to_string(i));
+	}
+	ASSERT_LE(cache.size(), 64);
+
+	ASSERT_TRUE(cache.erase(999) || !cache.contains(999));
+	cache.clear();
+	ASSERT_EQ(cache.size(), 0);
+}
+
+TEST(ShardedLruCacheTest, Concurrent) {
+	non_stl::sharded_lru_cache<int, int, 1024, 8> cache;
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&cache, t]() {
+			for (int i = 0; i < 5000; ++i) {
+				const int key = (i * 7 + t) % 2000;
+				cache.put(key, key * 2);
+				if (auto value = cache.get((key + 13) % 2000)) {
+					ASSERT_EQ(*value, ((key + 13) % 2000) * 2);
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	ASSERT_LE(cache.size(), 1024);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
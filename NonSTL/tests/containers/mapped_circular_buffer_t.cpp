@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../../containers/mapped_circular_buffer.h"
+
+// Returns a file path unique to the test and process, removing any file left behind
+static std::string temp_path(const char* name) {
+	std::string path = "/tmp/non_stl_" + std::string(name) + "_" + std::to_string(::getpid()) + ".ring";
+	std::remove(path.c_str());
+	return path;
+}
+
+// Constructors
+
+TEST(MappedConstructTest, Basic) {
+	const std::string path = temp_path("construct");
+	{
+		non_stl::mapped_circular_buffer<int> buffer(path, 10);
+		ASSERT_TRUE(buffer.empty());
+		ASSERT_EQ(buffer.size(), 0);
+
+		// The ring is rounded up to fill whole pages
+		ASSERT_GE(buffer.capacity(), 10);
+		ASSERT_EQ(buffer.capacity() * sizeof(int) % static_cast<size_t>(sysconf(_SC_PAGESIZE)), 0);
+	}
+	std::remove(path.c_str());
+}
+
+// Overwrite
+
+TEST(MappedOverwriteTest, Basic) {
+	const std::string path = temp_path("overwrite");
+	{
+		non_stl::mapped_circular_buffer<int> buffer(path, 1);
+		const int cap = static_cast<int>(buffer.capacity());
+
+		for (int i = 0; i < cap + 3; ++i) {
+			buffer.push_back(i);
+		}
+		ASSERT_EQ(buffer.size(), buffer.capacity());
+		ASSERT_EQ(buffer.front(), 3);
+		ASSERT_EQ(buffer.back(), cap + 2);
+		ASSERT_EQ(buffer[1], 4);
+
+		buffer.pop_front();
+		ASSERT_EQ(buffer.front(), 4);
+		ASSERT_EQ(buffer.size(), buffer.capacity() - 1);
+
+		buffer.clear();
+		ASSERT_TRUE(buffer.empty());
+	}
+	std::remove(path.c_str());
+}
+
+// Contents
+
+TEST(MappedContentsTest, Wraparound) {
+	const std::string path = temp_path("contents");
+	{
+		non_stl::mapped_circular_buffer<int> buffer(path, 1);
+		const int cap = static_cast<int>(buffer.capacity());
+
+		// Leave the oldest element near the end of the ring so the contents wrap
+		for (int i = 0; i < cap + cap / 2; ++i) {
+			buffer.push_back(i);
+		}
+
+		non_stl::span<int> contents = buffer.contents();
+		ASSERT_EQ(contents.size(), buffer.capacity());
+		for (int i = 0; i < cap; ++i) {
+			ASSERT_EQ(contents[i], cap / 2 + i);
+		}
+	}
+	std::remove(path.c_str());
+}
+
+// Push back n
+
+TEST(MappedPushBackNTest, Basic) {
+	const std::string path = temp_path("push_back_n");
+	{
+		non_stl::mapped_circular_buffer<int> buffer(path, 1);
+		const int cap = static_cast<int>(buffer.capacity());
+
+		int first[3] = { -1, -2, -3 };
+		buffer.push_back_n(first, 3);
+		ASSERT_EQ(buffer.size(), 3);
+		ASSERT_EQ(buffer.back(), -3);
+
+		// More than the capacity only keeps the newest elements
+		std::vector<int> values(cap + 5);
+		for (int i = 0; i < cap + 5; ++i) {
+			values[i] = i;
+		}
+		buffer.push_back_n(values.data(), values.size());
+		ASSERT_EQ(buffer.size(), buffer.capacity());
+		ASSERT_EQ(buffer.front(), 5);
+		ASSERT_EQ(buffer.back(), cap + 4);
+
+		// A batch crossing the end of the ring is copied through the mirror
+		buffer.clear();
+		buffer.push_back_n(first, 3);
+		ASSERT_EQ(buffer.size(), 3);
+		for (int i = 0; i < 3; ++i) {
+			ASSERT_EQ(buffer[i], first[i]);
+		}
+	}
+	std::remove(path.c_str());
+}
+
+// Persistence
+
+TEST(MappedReopenTest, Basic) {
+	const std::string path = temp_path("reopen");
+	size_t cap = 0;
+	{
+		non_stl::mapped_circular_buffer<int> buffer(path, 100);
+		cap = buffer.capacity();
+		for (int i = 0; i < static_cast<int>(cap) + 10; ++i) {
+			buffer.push_back(i);
+		}
+		buffer.pop_front();
+		buffer.flush();
+	}
+	{
+		// The requested capacity is ignored for an existing file
+		non_stl::mapped_circular_buffer<int> buffer(path, 5);
+		ASSERT_EQ(buffer.capacity(), cap);
+		ASSERT_EQ(buffer.size(), cap - 1);
+		ASSERT_EQ(buffer.front(), 11);
+		ASSERT_EQ(buffer.back(), static_cast<int>(cap) + 9);
+
+		buffer.push_back(-1);
+		ASSERT_EQ(buffer.back(), -1);
+	}
+	std::remove(path.c_str());
+}
+
+TEST(MappedReopenTest, Mismatch) {
+	const std::string path = temp_path("mismatch");
+	{
+		non_stl::mapped_circular_buffer<int> buffer(path, 10);
+		buffer.push_back(1);
+	}
+
+	struct pair { int a; int b; };
+	ASSERT_THROW(non_stl::mapped_circular_buffer<pair>(path, 10), std::system_error);
+	ASSERT_THROW(non_stl::mapped_circular_buffer<int>("/non_stl_missing_dir/ring", 10), std::system_error);
+
+	// The original buffer is untouched by the failed open
+	non_stl::mapped_circular_buffer<int> buffer(path, 10);
+	ASSERT_EQ(buffer.size(), 1);
+	ASSERT_EQ(buffer.front(), 1);
+	std::remove(path.c_str());
+}
+
+TEST(MappedReopenTest, CorruptHeader) {
+	const std::string path = temp_path("corrupt");
+	std::uint64_t cap = 0;
+	{
+		non_stl::mapped_circular_buffer<int> buffer(path, 10);
+		buffer.push_back(1);
+		cap = buffer.capacity();
+	}
+
+	// Overwrite head and tail, which follow magic, version, element size and capacity
+	auto write_positions = [&](std::uint64_t head, std::uint64_t tail) {
+		const std::uint64_t positions[2] = { head, tail };
+		int fd = ::open(path.c_str(), O_WRONLY);
+		ASSERT_GE(fd, 0);
+		ASSERT_EQ(::pwrite(fd, positions, sizeof(positions), 24), static_cast<ssize_t>(sizeof(positions)));
+		::close(fd);
+	};
+	auto expect_rejected = [&]() {
+		try {
+			non_stl::mapped_circular_buffer<int> buffer(path, 10);
+			FAIL();
+		}
+		catch (const std::system_error& e) {
+			ASSERT_EQ(e.code().value(), EINVAL);
+		}
+	};
+
+	// Tail behind head
+	write_positions(5, 2);
+	expect_rejected();
+
+	// More elements than the capacity
+	write_positions(0, cap + 1);
+	expect_rejected();
+
+	// A consistent full buffer still opens
+	write_positions(7, 7 + cap);
+	non_stl::mapped_circular_buffer<int> buffer(path, 10);
+	ASSERT_EQ(buffer.size(), buffer.capacity());
+	std::remove(path.c_str());
+}
+
+// Move
+
+TEST(MappedMoveTest, Basic) {
+	const std::string path = temp_path("move");
+	const std::string other_path = temp_path("move_other");
+	{
+		non_stl::mapped_circular_buffer<int> buffer(path, 10);
+		buffer.push_back(42);
+
+		non_stl::mapped_circular_buffer<int> moved(std::move(buffer));
+		ASSERT_EQ(moved.size(), 1);
+		ASSERT_EQ(moved.front(), 42);
+
+		non_stl::mapped_circular_buffer<int> other(other_path, 10);
+		other = std::move(moved);
+		ASSERT_EQ(other.front(), 42);
+	}
+	std::remove(path.c_str());
+	std::remove(other_path.c_str());
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
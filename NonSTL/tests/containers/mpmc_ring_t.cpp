@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../containers/mpmc_ring.h"
+
+// Single threaded
+
+TEST(MpmcCapacityTest, Basic) {
+	non_stl::mpmc_ring<int, 3> ring;
+	ASSERT_EQ(ring.capacity(), 3);
+	ASSERT_TRUE(ring.empty());
+
+	ASSERT_TRUE(ring.try_push(1));
+	ASSERT_TRUE(ring.try_push(2));
+	ASSERT_TRUE(ring.try_push(3));
+	ASSERT_FALSE(ring.try_push(4));
+	ASSERT_EQ(ring.size(), 3);
+
+	int out = 0;
+	ASSERT_TRUE(ring.try_pop(out));
+	ASSERT_EQ(out, 1);
+	ASSERT_TRUE(ring.try_push(4));
+
+	for (int expected = 2; expected <= 4; ++expected) {
+		ASSERT_TRUE(ring.try_pop(out));
+		ASSERT_EQ(out, expected);
+	}
+	ASSERT_FALSE(ring.try_pop(out));
+	ASSERT_EQ(out, 4);
+	ASSERT_TRUE(ring.empty());
+}
+
+TEST(MpmcPopNTest, Basic) {
+	non_stl::mpmc_ring<int, 8> ring;
+	int out[8] = {};
+
+	ASSERT_EQ(ring.try_pop_n(out, 8), 0);
+
+	for (int lap = 0; lap < 10; ++lap) {
+		for (int i = 0; i < 5; ++i) {
+			ring.push(lap * 10 + i);
+		}
+
+		ASSERT_EQ(ring.try_pop_n(out, 3), 3);
+		ASSERT_EQ(out[0], lap * 10);
+		ASSERT_EQ(out[2], lap * 10 + 2);
+
+		// Only the available elements are taken
+		ASSERT_EQ(ring.try_pop_n(out, 8), 2);
+		ASSERT_EQ(out[0], lap * 10 + 3);
+		ASSERT_EQ(out[1], lap * 10 + 4);
+	}
+	ASSERT_TRUE(ring.empty());
+}
+
+TEST(MpmcEmplaceTest, Basic) {
+	non_stl::mpmc_ring<std::string, 2> ring;
+
+	ASSERT_TRUE(ring.try_emplace(3, 'a'));
+	ring.emplace("bc");
+	ASSERT_FALSE(ring.try_emplace("de"));
+
+	std::string out;
+	ring.pop(out);
+	ASSERT_EQ(out, "aaa");
+	ring.pop(out);
+	ASSERT_EQ(out, "bc");
+}
+
+TEST(MpmcLifetimeTest, Basic) {
+	auto tracker = std::make_shared<int>(0);
+	{
+		non_stl::mpmc_ring<std::shared_ptr<int>, 4> ring;
+		ring.push(tracker);
+		ring.push(tracker);
+		ring.push(tracker);
+		ASSERT_EQ(tracker.use_count(), 4);
+
+		std::shared_ptr<int> out;
+		ring.pop(out);
+		out.reset();
+		ASSERT_EQ(tracker.use_count(), 3);
+	}
+	// Remaining elements are destroyed with the ring
+	ASSERT_EQ(tracker.use_count(), 1);
+}
+
+// Multi threaded
+
+TEST(MpmcThreadTest, FanInFanOut) {
+	constexpr int PRODUCERS = 3;
+	constexpr int CONSUMERS = 3;
+	constexpr int PER_PRODUCER = 20000;
+	non_stl::mpmc_ring<int, 64> ring;
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < PRODUCERS; ++p) {
+		threads.emplace_back([&ring, p]() {
+			for (int i = 0; i < PER_PRODUCER; ++i) {
+				ring.push(p * PER_PRODUCER + i);
+			}
+		});
+	}
+
+	// Every value is popped exactly once, and each producer's values arrive in order per consumer
+	std::vector<std::vector<int> > seen(CONSUMERS);
+	std::atomic<int> remaining(PRODUCERS * PER_PRODUCER);
+	for (int c = 0; c < CONSUMERS; ++c) {
+		threads.emplace_back([&ring, &seen, &remaining, c]() {
+			int batch[16];
+			while (remaining.load() > 0) {
+				const size_type n = ring.try_pop_n(batch, 16);
+				if (n == 0) {
+					std::this_thread::yield();
+					continue;
+				}
+				seen[c].insert(seen[c].end(), batch, batch + n);
+				remaining -= static_cast<int>(n);
+			}
+		});
+	}
+
+	for (auto& t : threads) {
+		t.join();
+	}
+
+	std::vector<int> counts(PRODUCERS * PER_PRODUCER, 0);
+	bool ordered = true;
+	for (const auto& values : seen) {
+		std::vector<int> last(PRODUCERS, -1);
+		for (int v : values) {
+			++counts[v];
+			ordered = ordered && v > last[v / PER_PRODUCER];
+			last[v / PER_PRODUCER] = v;
+		}
+	}
+
+	for (int count : counts) {
+		ASSERT_EQ(count, 1);
+	}
+	ASSERT_TRUE(ordered);
+	ASSERT_TRUE(ring.empty());
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../containers/priority_queue.h"
+
+// Pops every element of queue in order
+template <class Queue>
+static std::vector<int> drain(Queue& queue) {
+	std::vector<int> result;
+	while (!queue.empty()) {
+		result.push_back(queue.top());
+		queue.pop();
+	}
+	return result;
+}
+
+// Heap algorithms
+
+TEST(DaryHeapTest, Algorithms) {
+	std::mt19937 rng(3);
+	for (int n = 0; n < 100; ++n) {
+		std::vector<int> values(n);
+		for (auto& v : values) {
+			v = static_cast<int>(rng() % 50);
+		}
+
+		auto heap = values;
+		non_stl::dary_make_heap<3>(heap.begin(), heap.end(), std::less<int>());
+		ASSERT_TRUE(non_stl::dary_is_heap<3>(heap.begin(), heap.end(), std::less<int>()));
+
+		// Popping everything sorts the array
+		for (auto last = heap.end(); last != heap.begin(); --last) {
+			non_stl::dary_pop_heap<3>(heap.begin(), last, std::less<int>());
+		}
+		auto sorted = values;
+		std::sort(sorted.begin(), sorted.end());
+		ASSERT_EQ(heap, sorted);
+
+		heap.clear();
+		for (auto v : values) {
+			heap.push_back(v);
+			non_stl::dary_push_heap<8>(heap.begin(), heap.end(), std::less<int>());
+			ASSERT_TRUE(non_stl::dary_is_heap<8>(heap.begin(), heap.end(), std::less<int>()));
+		}
+	}
+}
+
+// Priority queue
+
+template <size_t Arity>
+static void check_against_std() {
+	std::mt19937 rng(Arity);
+	non_stl::priority_queue<int, non_stl::vector<int>, std::less<int>, Arity> queue;
+	std::priority_queue<int> reference;
+
+	for (int i = 0; i < 5000; ++i) {
+		if (reference.empty() || rng() % 3 != 0) {
+			const int v = static_cast<int>(rng() % 1000);
+			queue.push(v);
+			reference.push(v);
+		}
+		else {
+			ASSERT_EQ(queue.top(), reference.top());
+			queue.pop();
+			reference.pop();
+		}
+		ASSERT_EQ(queue.size(), reference.size());
+	}
+	while (!reference.empty()) {
+		ASSERT_EQ(queue.top(), reference.top());
+		queue.pop();
+		reference.pop();
+	}
+}
+
+TEST(PriorityQueueTest, Arity) {
+	check_against_std<2>();
+	check_against_std<4>();
+	check_against_std<8>();
+}
+
+TEST(PriorityQueueTest, Basic) {
+	non_stl::priority_queue<int> queue;
+	ASSERT_TRUE(queue.empty());
+	ASSERT_EQ(queue.arity(), 4);
+
+	queue.push(3);
+	queue.emplace(7);
+	queue.push(5);
+	ASSERT_EQ(queue.top(), 7);
+
+	queue.replace_top(1);
+	ASSERT_EQ(queue.top(), 5);
+	ASSERT_EQ(drain(queue), (std::vector<int>{ 5, 3, 1 }));
+
+	// Min heap
+	non_stl::priority_queue<int, non_stl::vector<int>, std::greater<int> > min{ std::greater<int>(), non_stl::vector<int>{ 4, 1, 3 } };
+	ASSERT_EQ(drain(min), (std::vector<int>{ 1, 3, 4 }));
+
+	std::vector<int> source{ 2, 9, 4 };
+	non_stl::priority_queue<int, non_stl::vector<int>, std::less<int>, 2> ranged(source.begin(), source.end());
+	ASSERT_EQ(ranged.top(), 9);
+
+	non_stl::priority_queue<int> other;
+	other.push(100);
+	swap(queue, other);
+	ASSERT_EQ(queue.top(), 100);
+	ASSERT_TRUE(other.empty());
+}
+
+TEST(PriorityQueueTest, PushBulk) {
+	non_stl::priority_queue<int> queue;
+
+	// Few elements onto a large heap are sifted up, many are heapified together
+	std::vector<int> many(1000);
+	for (int i = 0; i < 1000; ++i) {
+		many[i] = (i * 37) % 1000;
+	}
+	queue.push_bulk(many.begin(), many.end());
+	queue.push_bulk({ 1500, -1 });
+	queue.push_bulk(many.begin(), many.begin());
+	ASSERT_EQ(queue.size(), 1002);
+
+	auto result = drain(queue);
+	ASSERT_TRUE(std::is_sorted(result.rbegin(), result.rend()));
+	ASSERT_EQ(result.front(), 1500);
+	ASSERT_EQ(result.back(), -1);
+}
+
+// Indexed priority queue
+
+TEST(IndexedPriorityQueueTest, Basic) {
+	non_stl::indexed_priority_queue<int, std::greater<int> > queue;
+	ASSERT_TRUE(queue.empty());
+
+	auto a = queue.push(50);
+	auto b = queue.push(20);
+	auto c = queue.emplace(30);
+	ASSERT_EQ(queue.top(), 20);
+	ASSERT_EQ(queue.top_handle(), b);
+	ASSERT_EQ(queue[a], 50);
+
+	// decrease_key moves a min heap element towards the top
+	queue.decrease_key(a, 10);
+	ASSERT_EQ(queue.top_handle(), a);
+
+	// update moves either way
+	queue.update(a, 40);
+	ASSERT_EQ(queue.top_handle(), b);
+	queue.update(c, 5);
+	ASSERT_EQ(queue.top_handle(), c);
+
+	queue.erase(b);
+	ASSERT_FALSE(queue.contains(b));
+	ASSERT_EQ(queue.size(), 2);
+
+	queue.pop();
+	ASSERT_FALSE(queue.contains(c));
+	ASSERT_EQ(queue.top(), 40);
+
+	// Released handles are reused
+	auto d = queue.push(1);
+	ASSERT_TRUE(d == b || d == c);
+	ASSERT_EQ(queue[d], 1);
+
+	queue.clear();
+	ASSERT_TRUE(queue.empty());
+	ASSERT_FALSE(queue.contains(a));
+}
+
+TEST(IndexedPriorityQueueTest, Random) {
+	std::mt19937 rng(5);
+	non_stl::indexed_priority_queue<int, std::less<int>, 4> queue;
+	std::map<size_t, int> reference;
+
+	for (int i = 0; i < 5000; ++i) {
+		const auto op = rng() % 4;
+		const int v = static_cast<int>(rng() % 10000);
+		if (reference.empty() || op == 0) {
+			reference[queue.push(v)] = v;
+		}
+		else {
+			auto it = reference.begin();
+			std::advance(it, rng() % reference.size());
+			if (op == 1) {
+				queue.update(it->first, v);
+				it->second = v;
+			}
+			else if (op == 2) {
+				queue.erase(it->first);
+				reference.erase(it);
+			}
+			else {
+				ASSERT_EQ(queue[it->first], it->second);
+				const auto top = std::max_element(reference.begin(), reference.end(),
+					[](auto& lhs, auto& rhs) { return lhs.second < rhs.second; });
+				ASSERT_EQ(queue.top(), top->second);
+			}
+		}
+		ASSERT_EQ(queue.size(), reference.size());
+	}
+
+	std::vector<int> expected;
+	for (auto& entry : reference) {
+		expected.push_back(entry.second);
+	}
+	std::sort(expected.rbegin(), expected.rend());
+	ASSERT_EQ(drain(queue), expected);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../../containers/rolling_window.h"
+
+using non_stl::rolling_max;
+using non_stl::rolling_min;
+using non_stl::rolling_quantile;
+using non_stl::rolling_sum;
+using non_stl::rolling_variance;
+
+// Constructors
+
+TEST(RollingConstructTest, Basic) {
+	non_stl::rolling_window<int, 4, rolling_sum> window;
+	ASSERT_TRUE(window.empty());
+	ASSERT_FALSE(window.full());
+	ASSERT_EQ(window.capacity(), 4);
+	ASSERT_EQ(window.size(), 0);
+	ASSERT_EQ(window.get<rolling_sum>().value(), 0);
+	ASSERT_EQ(window.get<rolling_sum>().mean(), 0.0);
+}
+
+// Aggregates
+
+TEST(RollingSumTest, Basic) {
+	non_stl::rolling_window<int, 3, rolling_sum> window;
+	window.push_back(1);
+	window.push_back(2);
+	ASSERT_EQ(window.get<rolling_sum>().value(), 3);
+	ASSERT_DOUBLE_EQ(window.get<rolling_sum>().mean(), 1.5);
+
+	window.push_back(3);
+	ASSERT_TRUE(window.full());
+	ASSERT_EQ(window.get<rolling_sum>().value(), 6);
+
+	// 1 leaves the window
+	window.push_back(10);
+	ASSERT_EQ(window.size(), 3);
+	ASSERT_EQ(window.pushed(), 4);
+	ASSERT_EQ(window.samples().front(), 2);
+	ASSERT_EQ(window.get<rolling_sum>().value(), 15);
+	ASSERT_DOUBLE_EQ(window.get<rolling_sum>().mean(), 5.0);
+
+	window.clear();
+	ASSERT_TRUE(window.empty());
+	ASSERT_EQ(window.pushed(), 0);
+	ASSERT_EQ(window.get<rolling_sum>().value(), 0);
+
+	// Unsigned sums wrap around on the way and still end up exact
+	non_stl::rolling_window<std::uint32_t, 2, rolling_sum> counts;
+	counts.push_back(5);
+	counts.push_back(1);
+	counts.push_back(2);
+	ASSERT_EQ(counts.get<rolling_sum>().value(), 3u);
+}
+
+TEST(RollingMinMaxTest, Basic) {
+	non_stl::rolling_window<int, 3, rolling_min, rolling_max> window;
+	const int values[] = { 5, 3, 4, 8, 1, 1, 9, 2, 7, 7, 7 };
+	std::vector<int> seen;
+	for (int v : values) {
+		window.push_back(v);
+		seen.push_back(v);
+
+		const auto first = seen.end() - std::min<size_t>(seen.size(), 3);
+		ASSERT_EQ(window.get<rolling_min>().value(), *std::min_element(first, seen.end()));
+		ASSERT_EQ(window.get<rolling_max>().value(), *std::max_element(first, seen.end()));
+	}
+
+	window.clear();
+	window.push_back(-1);
+	ASSERT_EQ(window.get<rolling_min>().value(), -1);
+	ASSERT_EQ(window.get<rolling_max>().value(), -1);
+}
+
+TEST(RollingVarianceTest, Basic) {
+	non_stl::rolling_window<double, 4, rolling_variance> window;
+	ASSERT_EQ(window.get<rolling_variance>().variance(), 0.0);
+
+	window.push_back(2.0);
+	ASSERT_DOUBLE_EQ(window.get<rolling_variance>().mean(), 2.0);
+	ASSERT_EQ(window.get<rolling_variance>().sample_variance(), 0.0);
+
+	for (double v : { 4.0, 4.0, 6.0 }) {
+		window.push_back(v);
+	}
+	// 2 4 4 6
+	ASSERT_DOUBLE_EQ(window.get<rolling_variance>().mean(), 4.0);
+	ASSERT_DOUBLE_EQ(window.get<rolling_variance>().variance(), 2.0);
+	ASSERT_DOUBLE_EQ(window.get<rolling_variance>().sample_variance(), 8.0 / 3.0);
+
+	// 4 4 6 10
+	window.push_back(10.0);
+	ASSERT_DOUBLE_EQ(window.get<rolling_variance>().mean(), 6.0);
+	ASSERT_DOUBLE_EQ(window.get<rolling_variance>().variance(), 6.0);
+	ASSERT_DOUBLE_EQ(window.get<rolling_variance>().stddev(), std::sqrt(6.0));
+}
+
+// Matches a recomputation over a long random stream, where rounding errors would build up
+TEST(RollingDriftTest, Basic) {
+	constexpr size_t N = 64;
+	non_stl::rolling_window<double, N, rolling_sum, rolling_variance, rolling_min> window;
+	std::mt19937 gen(7);
+	std::uniform_real_distribution<double> dist(-1e6, 1e6);
+
+	std::vector<double> all;
+	for (int i = 0; i < 100000; ++i) {
+		const double v = dist(gen) + (i % 1000 == 0 ? 1e12 : 0.0);
+		window.push_back(v);
+		all.push_back(v);
+	}
+
+	double sum = 0.0;
+	for (size_t i = all.size() - N; i < all.size(); ++i) {
+		sum += all[i];
+	}
+	const double mean = sum / N;
+	double m2 = 0.0;
+	for (size_t i = all.size() - N; i < all.size(); ++i) {
+		m2 += (all[i] - mean) * (all[i] - mean);
+	}
+
+	ASSERT_NEAR(window.get<rolling_sum>().value(), sum, 1e-3);
+	ASSERT_NEAR(window.get<rolling_variance>().mean(), mean, 1e-3);
+	ASSERT_NEAR(window.get<rolling_variance>().variance(), m2 / N, m2 / N * 1e-6);
+	ASSERT_EQ(window.get<rolling_min>().value(), *std::min_element(all.end() - N, all.end()));
+}
+
+TEST(RollingQuantileTest, Basic) {
+	using quantiles = rolling_quantile<>;
+	non_stl::rolling_window<std::uint32_t, 1000, quantiles> window;
+	ASSERT_EQ(window.get<quantiles>().quantile(0.5), 0.0);
+
+	// The last 1000 of 1 .. 3000
+	for (std::uint32_t v = 1; v <= 3000; ++v) {
+		window.push_back(v);
+	}
+	const auto& q = window.get<quantiles>();
+	ASSERT_NEAR(q.quantile(0.0), 2001.0, 2001.0 * 0.01);
+	ASSERT_NEAR(q.quantile(0.5), 2500.0, 2500.0 * 0.01);
+	ASSERT_NEAR(q.quantile(0.99), 2990.0, 2990.0 * 0.01);
+	ASSERT_NEAR(q.quantile(1.0), 3000.0, 3000.0 * 0.01);
+
+	// A spike moves the top quantile only
+	for (int i = 0; i < 20; ++i) {
+		window.push_back(1000000);
+	}
+	ASSERT_NEAR(q.quantile(0.5), 2520.0, 2520.0 * 0.01);
+	ASSERT_NEAR(q.quantile(0.99), 1000000.0, 1000000.0 * 0.01);
+
+	// Samples up to 1 share the first bucket
+	using coarse = rolling_quantile<std::ratio<1, 50>, 64>;
+	non_stl::rolling_window<double, 4, coarse> small;
+	small.push_back(0.0);
+	small.push_back(0.5);
+	ASSERT_EQ(small.get<coarse>().quantile(0.5), 1.0);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
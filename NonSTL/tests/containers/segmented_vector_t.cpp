@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../containers/segmented_vector.h"
+#include "../../containers/vector.h"
+#include "../../memory/arena_allocator.h"
+
+// Small first segment so a few elements already span several segments
+using small_segmented = non_stl::segmented_vector<int, std::allocator<int>, 16 * sizeof(int)>;
+
+// Constructors
+
+TEST(SegmentedConstructTest, Basic) {
+	non_stl::segmented_vector<int> empty;
+	ASSERT_TRUE(empty.empty());
+	ASSERT_EQ(empty.begin(), empty.end());
+	ASSERT_EQ(empty.capacity(), 0);
+
+	non_stl::segmented_vector<int> sized(100);
+	ASSERT_EQ(sized.size(), 100);
+	ASSERT_EQ(sized[99], 0);
+
+	non_stl::segmented_vector<std::string> filled(40, "a");
+	ASSERT_EQ(filled.size(), 40);
+	ASSERT_EQ(filled.back(), "a");
+
+	non_stl::segmented_vector<int> init{ 1, 2, 3 };
+	ASSERT_EQ(init.size(), 3);
+	ASSERT_EQ(init.front(), 1);
+	ASSERT_EQ(init.back(), 3);
+
+	std::vector<int> source(1000);
+	std::iota(source.begin(), source.end(), 0);
+	small_segmented ranged(source.begin(), source.end());
+	ASSERT_TRUE(std::equal(ranged.begin(), ranged.end(), source.begin(), source.end()));
+
+	// Single pass iterators
+	std::istringstream stream("4 5 6");
+	small_segmented streamed{ std::istream_iterator<int>(stream), std::istream_iterator<int>() };
+	ASSERT_EQ(streamed.size(), 3);
+	ASSERT_EQ(streamed[2], 6);
+}
+
+TEST(SegmentedConstructTest, CopyMove) {
+	non_stl::segmented_vector<std::string, std::allocator<std::string>, 64> vec;
+	for (int i = 0; i < 300; ++i) {
+		vec.push_back(std::to_string(i));
+	}
+
+	auto copy = vec;
+	ASSERT_EQ(copy.size(), 300);
+	ASSERT_TRUE(std::equal(copy.begin(), copy.end(), vec.begin(), vec.end()));
+
+	const std::string* first = &vec.front();
+	auto moved = std::move(vec);
+	ASSERT_EQ(&moved.front(), first);
+	ASSERT_TRUE(vec.empty());
+
+	copy = moved;
+	ASSERT_EQ(copy[299], "299");
+	vec = std::move(copy);
+	ASSERT_EQ(vec.size(), 300);
+	vec = { "x", "y" };
+	ASSERT_EQ(vec.size(), 2);
+	ASSERT_EQ(vec[1], "y");
+}
+
+// Element access
+
+TEST(SegmentedAccessTest, Indexing) {
+	small_segmented vec;
+	for (int i = 0; i < 10000; ++i) {
+		vec.push_back(i);
+	}
+
+	for (int i = 0; i < 10000; ++i) {
+		ASSERT_EQ(vec[i], i);
+	}
+	ASSERT_EQ(vec.at(9999), 9999);
+	ASSERT_THROW(vec.at(10000), std::out_of_range);
+
+	// Segments double in size and together hold every element in order
+	ASSERT_EQ(small_segmented::first_segment_size, 16);
+	size_type total = 0;
+	for (size_type k = 0; k < vec.segment_count(); ++k) {
+		auto run = vec.segment(k);
+		if (k + 1 < vec.segment_count()) {
+			ASSERT_EQ(run.size(), 16u << k);
+		}
+		ASSERT_EQ(run[0], static_cast<int>(total));
+		total += run.size();
+	}
+	ASSERT_EQ(total, 10000);
+	ASSERT_TRUE(vec.segment(vec.segment_count()).empty());
+}
+
+// Stability
+
+TEST(SegmentedStabilityTest, AddressesSurviveGrowth) {
+	small_segmented vec;
+	vec.push_back(0);
+	const int* first = &vec[0];
+	auto it = vec.begin();
+
+	std::vector<const int*> addresses;
+	for (int i = 1; i < 5000; ++i) {
+		vec.push_back(i);
+		addresses.push_back(&vec.back());
+	}
+
+	// Nothing moved and iterators taken before the growth are still usable
+	ASSERT_EQ(&vec[0], first);
+	ASSERT_EQ(&*it, first);
+	ASSERT_EQ(it[4999], 4999);
+	for (int i = 1; i < 5000; ++i) {
+		ASSERT_EQ(addresses[i - 1], &vec[i]);
+	}
+}
+
+TEST(SegmentedStabilityTest, EmplaceFromElement) {
+	small_segmented vec;
+	for (int i = 0; i < 16; ++i) {
+		vec.push_back(i);
+	}
+
+	// The next element starts a new segment, the argument lives in the current one
+	ASSERT_EQ(vec.size(), vec.capacity());
+	vec.emplace_back(vec[3]);
+	ASSERT_EQ(vec.back(), 3);
+	vec.resize(100, vec[5]);
+	ASSERT_EQ(vec[99], 5);
+}
+
+// Capacity
+
+TEST(SegmentedCapacityTest, ReserveShrink) {
+	small_segmented vec;
+	vec.reserve(100);
+	ASSERT_GE(vec.capacity(), 100);
+	ASSERT_EQ(vec.capacity(), 16 + 32 + 64);
+	ASSERT_EQ(vec.segment_count(), 3);
+
+	vec.resize(20);
+	vec.shrink_to_fit();
+	ASSERT_EQ(vec.segment_count(), 2);
+	ASSERT_EQ(vec.capacity(), 48);
+
+	vec.resize(5);
+	ASSERT_EQ(vec.size(), 5);
+	vec.clear();
+	ASSERT_EQ(vec.capacity(), 48);
+	vec.shrink_to_fit();
+	ASSERT_EQ(vec.capacity(), 0);
+}
+
+// Modifiers
+
+TEST(SegmentedModifierTest, InsertErase) {
+	small_segmented vec;
+	std::vector<int> expected;
+	for (int i = 0; i < 40; ++i) {
+		vec.push_back(i);
+		expected.push_back(i);
+	}
+
+	vec.insert(vec.begin() + 5, -1);
+	expected.insert(expected.begin() + 5, -1);
+	vec.insert(vec.begin() + 20, 30, 7);
+	expected.insert(expected.begin() + 20, 30, 7);
+	vec.insert(vec.begin(), { 100, 101, 102 });
+	expected.insert(expected.begin(), { 100, 101, 102 });
+	vec.emplace(vec.end(), 55);
+	expected.emplace(expected.end(), 55);
+	ASSERT_TRUE(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+
+	auto it = vec.erase(vec.begin() + 2, vec.begin() + 40);
+	expected.erase(expected.begin() + 2, expected.begin() + 40);
+	ASSERT_EQ(*it, expected[2]);
+	vec.erase(vec.begin());
+	expected.erase(expected.begin());
+	ASSERT_TRUE(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+
+	vec.pop_back();
+	expected.pop_back();
+	ASSERT_EQ(vec.size(), expected.size());
+
+	non_stl::vector<int> tail{ 1, 2, 3 };
+	vec.append_range(tail);
+	ASSERT_EQ(vec.back(), 3);
+
+	vec.assign(50, 9);
+	ASSERT_EQ(vec.size(), 50);
+	ASSERT_EQ(vec[49], 9);
+
+	small_segmented other{ 1 };
+	vec.swap(other);
+	ASSERT_EQ(vec.size(), 1);
+	ASSERT_EQ(other.size(), 50);
+}
+
+TEST(SegmentedModifierTest, Algorithms) {
+	small_segmented vec;
+	for (int i = 0; i < 1000; ++i) {
+		vec.push_back((i * 7919) % 1000);
+	}
+
+	std::sort(vec.begin(), vec.end());
+	ASSERT_TRUE(std::is_sorted(vec.begin(), vec.end()));
+	ASSERT_EQ(std::accumulate(vec.rbegin(), vec.rend(), 0), 999 * 1000 / 2);
+}
+
+// Allocators
+
+TEST(SegmentedAllocatorTest, Arena) {
+	non_stl::monotonic_buffer buffer;
+	non_stl::arena_allocator<std::string> alloc(buffer);
+
+	non_stl::segmented_vector<std::string, non_stl::arena_allocator<std::string> > vec(alloc);
+	for (int i = 0; i < 50; ++i) {
+		vec.push_back(std::to_string(i));
+	}
+	ASSERT_GT(buffer.bytes_allocated(), 0u);
+
+	// Unequal arenas which don't propagate move the elements over
+	non_stl::monotonic_buffer other_buffer;
+	non_stl::segmented_vector<std::string, non_stl::arena_allocator<std::string> > other(non_stl::arena_allocator<std::string>{ other_buffer });
+	other = std::move(vec);
+	ASSERT_EQ(other.size(), 50);
+	ASSERT_EQ(other[49], "49");
+	ASSERT_EQ(other.get_allocator().buffer(), &other_buffer);
+
+	non_stl::monotonic_buffer resource;
+	non_stl::pmr::segmented_vector<int> pmr(&resource);
+	for (int i = 0; i < 100; ++i) {
+		pmr.push_back(i);
+	}
+	ASSERT_EQ(pmr.size(), 100);
+	ASSERT_EQ(pmr.get_allocator().resource(), &resource);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
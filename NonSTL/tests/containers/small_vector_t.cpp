@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "../../containers/small_vector.h"
+
+// Constructors
+
+TEST(BasicConstruct, Basic) {
+	non_stl::small_vector<int, 4> vec{ };
+	ASSERT_EQ(vec.size(), 0);
+	ASSERT_TRUE(vec.empty());
+	ASSERT_EQ(vec.capacity(), 4);
+	ASSERT_TRUE(vec.is_inline());
+}
+
+TEST(InitializerConstruct, Basic) {
+	non_stl::small_vector<int, 4> vec = { 0,1,2 };
+
+	ASSERT_EQ(vec.size(), 3);
+	ASSERT_TRUE(vec.is_inline());
+
+	ASSERT_EQ(vec[0], 0);
+	ASSERT_EQ(vec[1], 1);
+	ASSERT_EQ(vec[2], 2);
+}
+
+TEST(SizeConstruct, Basic) {
+	non_stl::small_vector<int, 2> vec(3);
+
+	ASSERT_EQ(vec.size(), 3);
+	ASSERT_FALSE(vec.is_inline());
+
+	ASSERT_EQ(vec[0], 0);
+	ASSERT_EQ(vec[1], 0);
+	ASSERT_EQ(vec[2], 0);
+}
+
+TEST(SizeConstructWithValue, Basic) {
+	non_stl::small_vector<int, 4> vec(3, 5);
+
+	ASSERT_EQ(vec.size(), 3);
+	ASSERT_EQ(vec[0], 5);
+	ASSERT_EQ(vec[1], 5);
+	ASSERT_EQ(vec[2], 5);
+}
+
+TEST(IteratorConstruct, Basic) {
+	non_stl::small_vector<int, 4> vec1{ 0,1,2 };
+	non_stl::small_vector<int, 4> vec2(vec1.begin(), vec1.end());
+
+	ASSERT_EQ(vec2.size(), 3);
+	ASSERT_EQ(vec2[0], 0);
+	ASSERT_EQ(vec2[1], 1);
+	ASSERT_EQ(vec2[2], 2);
+
+	non_stl::small_vector<int, 4> vec3(vec1.rbegin(), vec1.rend());
+	ASSERT_EQ(vec3.size(), 3);
+	ASSERT_EQ(vec3[0], 2);
+	ASSERT_EQ(vec3[1], 1);
+	ASSERT_EQ(vec3[2], 0);
+}
+
+TEST(CopyConstruct, Basic) {
+	non_stl::small_vector<std::string, 2> vec1{ "a", "b", "c" };
+	non_stl::small_vector<std::string, 2> vec2(vec1);
+
+	ASSERT_EQ(vec2.size(), vec1.size());
+	ASSERT_EQ(vec2[0], "a");
+	ASSERT_EQ(vec2[1], "b");
+	ASSERT_EQ(vec2[2], "c");
+	ASSERT_NE(vec2.data(), vec1.data());
+}
+
+TEST(MoveConstruct, Basic) {
+	// Inline elements are relocated
+	non_stl::small_vector<std::string, 4> vec1{ "a", "b" };
+	non_stl::small_vector<std::string, 4> vec2(std::move(vec1));
+	ASSERT_EQ(vec2.size(), 2);
+	ASSERT_TRUE(vec2.is_inline());
+	ASSERT_EQ(vec2[0], "a");
+	ASSERT_EQ(vec2[1], "b");
+	ASSERT_EQ(vec1.size(), 0);
+
+	// Allocated array is stolen
+	non_stl::small_vector<std::string, 1> vec3{ "a", "b", "c" };
+	auto ptr = vec3.data();
+	non_stl::small_vector<std::string, 1> vec4(std::move(vec3));
+	ASSERT_EQ(vec4.data(), ptr);
+	ASSERT_EQ(vec4.size(), 3);
+	ASSERT_EQ(vec4[2], "c");
+	ASSERT_TRUE(vec3.is_inline());
+	ASSERT_EQ(vec3.size(), 0);
+}
+
+TEST(AtTest, Basic) {
+	non_stl::small_vector<int, 4> vec{ 1,2,3 };
+	ASSERT_EQ(vec.at(0), 1);
+	ASSERT_EQ(vec.at(1), 2);
+	ASSERT_EQ(vec.at(2), 3);
+	ASSERT_THROW(vec.at(3), std::out_of_range);
+}
+
+TEST(FrontBackTest, Basic) {
+	non_stl::small_vector<int, 4> vec{ 5,6,7 };
+	ASSERT_EQ(vec.front(), 5);
+	ASSERT_EQ(vec.front(), *(vec.begin()));
+	ASSERT_EQ(vec.back(), 7);
+}
+
+TEST(SpillTest, Basic) {
+	non_stl::small_vector<int, 4> vec;
+
+	// No allocation until the inline capacity is exceeded
+	for (int i = 0; i < 4; ++i)
+	{
+		vec.push_back(i);
+		ASSERT_TRUE(vec.is_inline());
+	}
+
+	vec.push_back(4);
+	ASSERT_FALSE(vec.is_inline());
+	ASSERT_GT(vec.capacity(), 4);
+	for (int i = 0; i < 5; ++i)
+	{
+		ASSERT_EQ(vec[i], i);
+	}
+
+	// Shrinking back below N moves the elements inline again
+	vec.pop_back();
+	vec.shrink_to_fit();
+	ASSERT_TRUE(vec.is_inline());
+	ASSERT_EQ(vec.capacity(), 4);
+	ASSERT_EQ(vec.size(), 4);
+	ASSERT_EQ(vec[3], 3);
+}
+
+TEST(PushBackSelfTest, Basic) {
+	// Pushing back an element of the container across a reallocation
+	non_stl::small_vector<std::string, 2> vec{ std::string(40, 'x'), "y" };
+	vec.push_back(vec[0]);
+	ASSERT_EQ(vec.size(), 3);
+	ASSERT_EQ(vec[2], std::string(40, 'x'));
+}
+
+TEST(ResizeTest, Basic) {
+	non_stl::small_vector<int, 4> vec1;
+	vec1.resize(15);
+	ASSERT_EQ(vec1.size(), 15);
+	ASSERT_EQ(vec1[14], 0);
+
+	vec1.resize(3);
+	ASSERT_EQ(vec1.size(), 3);
+
+	vec1.resize(8, 7);
+	ASSERT_EQ(vec1.size(), 8);
+	ASSERT_EQ(vec1[2], 0);
+	ASSERT_EQ(vec1[3], 7);
+	ASSERT_EQ(vec1[7], 7);
+}
+
+TEST(AssignTest, Basic) {
+	non_stl::small_vector<int, 2> vec1 = { 0,1,2 };
+	vec1.assign({ 6,7,8,9 });
+	ASSERT_EQ(vec1.size(), 4);
+	ASSERT_EQ(vec1[0], 6);
+	ASSERT_EQ(vec1[3], 9);
+
+	non_stl::small_vector<int, 2> vec2;
+	vec2.assign(vec1.begin(), vec1.end());
+	ASSERT_EQ(vec2.size(), 4);
+	ASSERT_EQ(vec2[1], 7);
+
+	vec2.assign(5, 3);
+	ASSERT_EQ(vec2.size(), 5);
+	ASSERT_EQ(vec2[0], 3);
+	ASSERT_EQ(vec2[4], 3);
+}
+
+TEST(EmplaceBackTest, Basic) {
+	non_stl::small_vector<std::string, 2> vec;
+	vec.emplace_back(3, 'a');
+	vec.emplace_back("bc");
+	vec.emplace_back(2, 'd');
+	ASSERT_EQ(vec.size(), 3);
+	ASSERT_EQ(vec[0], "aaa");
+	ASSERT_EQ(vec[1], "bc");
+	ASSERT_EQ(vec[2], "dd");
+}
+
+TEST(InsertTest, Basic) {
+	non_stl::small_vector<int, 4> vec1{ 1,2,3 };
+
+	vec1.insert(vec1.begin(), 7);
+	ASSERT_EQ(vec1.size(), 4);
+	ASSERT_EQ(vec1[0], 7);
+	ASSERT_EQ(vec1[1], 1);
+
+	int x = 19;
+	auto it = vec1.insert(vec1.begin() + 1, x);
+	ASSERT_EQ(*it, 19);
+	ASSERT_EQ(vec1.size(), 5);
+	ASSERT_EQ(vec1[1], 19);
+	ASSERT_EQ(vec1[4], 3);
+
+	non_stl::small_vector<int, 4> vec2{ 0,1,2 };
+	vec2.insert(vec2.begin() + 1, vec1.begin(), vec1.begin() + 3);
+	ASSERT_EQ(vec2.size(), 6);
+	ASSERT_EQ(vec2[0], 0);
+	ASSERT_EQ(vec2[1], 7);
+	ASSERT_EQ(vec2[2], 19);
+	ASSERT_EQ(vec2[3], 1);
+	ASSERT_EQ(vec2[4], 1);
+	ASSERT_EQ(vec2[5], 2);
+
+	vec2.insert(vec2.end(), { 8, 9 });
+	ASSERT_EQ(vec2.size(), 8);
+	ASSERT_EQ(vec2[6], 8);
+	ASSERT_EQ(vec2[7], 9);
+}
+
+TEST(SwapTest, Basic) {
+	// Inline with allocated
+	non_stl::small_vector<std::string, 2> vec1{ "a", "b", "c" };
+	non_stl::small_vector<std::string, 2> vec2{ "d" };
+
+	vec1.swap(vec2);
+	ASSERT_EQ(vec1.size(), 1);
+	ASSERT_EQ(vec2.size(), 3);
+	ASSERT_EQ(vec1[0], "d");
+	ASSERT_EQ(vec2[2], "c");
+	ASSERT_TRUE(vec1.is_inline());
+	ASSERT_FALSE(vec2.is_inline());
+
+	// Both allocated
+	non_stl::small_vector<std::string, 2> vec3{ "e", "f", "g", "h" };
+	vec3.swap(vec2);
+	ASSERT_EQ(vec3.size(), 3);
+	ASSERT_EQ(vec2.size(), 4);
+	ASSERT_EQ(vec2[3], "h");
+}
+
+TEST(ClearTest, Basic) {
+	non_stl::small_vector<int, 2> vec = { 0,1,2 };
+	auto cap = vec.capacity();
+
+	vec.clear();
+	ASSERT_EQ(vec.size(), 0);
+	ASSERT_EQ(vec.capacity(), cap);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
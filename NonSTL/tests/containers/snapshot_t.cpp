@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../containers/snapshot.h"
+
+// Returns a file path unique to the test and process, removing any file left behind
+static std::string temp_path(const char* name) {
+	std::string path = "/tmp/non_stl_" + std::string(name) + "_" + std::to_string(::getpid()) + ".snap";
+	std::remove(path.c_str());
+	return path;
+}
+
+struct Record {
+	std::uint64_t key;
+	double value;
+	std::uint32_t flags;
+};
+
+// Vector
+
+TEST(SnapshotVectorTest, Basic) {
+	const std::string path = temp_path("vector");
+
+	non_stl::vector<Record> vec;
+	for (std::uint64_t i = 0; i < 10000; ++i) {
+		vec.push_back(Record{ i, i * 0.5, static_cast<std::uint32_t>(i % 7) });
+	}
+	non_stl::save(path, vec);
+
+	non_stl::vector<Record> loaded = { Record{ 1, 1.0, 1 } };
+	non_stl::load(path, loaded);
+	ASSERT_EQ(loaded.size(), vec.size());
+	for (size_t i = 0; i < vec.size(); ++i) {
+		ASSERT_EQ(loaded[i].key, vec[i].key);
+		ASSERT_EQ(loaded[i].value, vec[i].value);
+		ASSERT_EQ(loaded[i].flags, vec[i].flags);
+	}
+
+	// The temporary file was renamed over path
+	ASSERT_NE(::access((path + ".tmp").c_str(), F_OK), 0);
+	std::remove(path.c_str());
+}
+
+TEST(SnapshotEmptyTest, Basic) {
+	const std::string path = temp_path("empty");
+
+	non_stl::vector<int> vec;
+	vec.clear();
+	non_stl::save(path, vec);
+
+	non_stl::vector<int> loaded = { 1, 2, 3 };
+	non_stl::load(path, loaded);
+	ASSERT_TRUE(loaded.empty());
+
+	non_stl::mapped_vector_view<int> view(path);
+	ASSERT_TRUE(view.empty());
+	ASSERT_EQ(view.begin(), view.end());
+	std::remove(path.c_str());
+}
+
+// Circular buffer
+
+TEST(SnapshotCircularBufferTest, Basic) {
+	const std::string path = temp_path("ring");
+
+	// Overwrite so the contents wrap around the end of the storage
+	non_stl::circular_buffer<int, 8> buf;
+	for (int i = 0; i < 13; ++i) {
+		buf.push_back(i);
+	}
+	ASSERT_FALSE(buf.array_two().empty());
+	non_stl::save(path, buf);
+
+	non_stl::circular_buffer<int, 16> bigger;
+	bigger.push_back(-1);
+	non_stl::load(path, bigger);
+	ASSERT_EQ(bigger.size(), 8);
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_EQ(bigger[i], i + 5);
+	}
+
+	// The oldest element is first in the file, so the snapshot reads back as a vector too
+	non_stl::vector<int> vec;
+	non_stl::load(path, vec);
+	ASSERT_EQ(vec.size(), 8);
+	ASSERT_EQ(vec.front(), 5);
+	ASSERT_EQ(vec.back(), 12);
+
+	// Too many elements for the buffer
+	non_stl::circular_buffer<int, 4> smaller;
+	ASSERT_THROW(non_stl::load(path, smaller), std::system_error);
+	ASSERT_TRUE(smaller.empty());
+	std::remove(path.c_str());
+}
+
+TEST(SnapshotFailedSaveTest, Basic) {
+	// rename can't replace a directory, the temporary file is removed again
+	const std::string path = temp_path("failed");
+	ASSERT_EQ(::mkdir(path.c_str(), 0755), 0);
+
+	non_stl::vector<int> vec = { 1, 2, 3 };
+	ASSERT_THROW(non_stl::save(path, vec), std::system_error);
+	ASSERT_NE(::access((path + ".tmp").c_str(), F_OK), 0);
+	::rmdir(path.c_str());
+}
+
+// Mapped view
+
+TEST(SnapshotMappedViewTest, Basic) {
+	const std::string path = temp_path("view");
+
+	non_stl::vector<std::uint64_t> vec;
+	for (std::uint64_t i = 0; i < 100000; ++i) {
+		vec.push_back(i * i);
+	}
+	non_stl::save(path, vec);
+
+	non_stl::mapped_vector_view<std::uint64_t> view(path);
+	ASSERT_EQ(view.size(), vec.size());
+	ASSERT_EQ(view.front(), 0);
+	ASSERT_EQ(view.back(), vec.back());
+	ASSERT_EQ(view.at(300), 90000);
+	ASSERT_THROW(view.at(view.size()), std::out_of_range);
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(view.data()) % alignof(std::uint64_t), 0);
+
+	std::uint64_t sum = 0;
+	for (auto e : view) {
+		sum += e;
+	}
+	std::uint64_t expected = 0;
+	for (auto e : vec) {
+		expected += e;
+	}
+	ASSERT_EQ(sum, expected);
+
+	// Moving hands over the mapping
+	non_stl::mapped_vector_view<std::uint64_t> moved(std::move(view));
+	ASSERT_EQ(moved.contents().size(), vec.size());
+	ASSERT_TRUE(view.empty());
+	std::remove(path.c_str());
+}
+
+// Validation
+
+TEST(SnapshotRejectTest, Basic) {
+	const std::string path = temp_path("reject");
+
+	non_stl::vector<std::uint32_t> vec = { 1, 2, 3 };
+	non_stl::save(path, vec);
+
+	// A different element size
+	non_stl::vector<std::uint64_t> wide;
+	ASSERT_THROW(non_stl::load(path, wide), std::system_error);
+	ASSERT_THROW(non_stl::mapped_vector_view<std::uint64_t>{ path }, std::system_error);
+
+	// Truncated data
+	ASSERT_EQ(::truncate(path.c_str(), sizeof(non_stl::snapshot_header) + 2 * sizeof(std::uint32_t)), 0);
+	non_stl::vector<std::uint32_t> loaded;
+	ASSERT_THROW(non_stl::load(path, loaded), std::system_error);
+	ASSERT_TRUE(loaded.empty());
+	ASSERT_THROW(non_stl::mapped_vector_view<std::uint32_t>{ path }, std::system_error);
+
+	// A snapshot written with the other byte order
+	non_stl::snapshot_header header{};
+	header.magic = non_stl::snapshot_header::MAGIC;
+	header.byte_order = 0x04030201;
+	{
+		int fd = ::open(path.c_str(), O_WRONLY | O_TRUNC);
+		ASSERT_GE(fd, 0);
+		ASSERT_EQ(::write(fd, &header, sizeof(header)), static_cast<ssize_t>(sizeof(header)));
+		::close(fd);
+	}
+	try {
+		non_stl::load(path, loaded);
+		FAIL();
+	}
+	catch (const std::system_error& e) {
+		ASSERT_EQ(e.code().value(), EINVAL);
+		ASSERT_NE(std::string(e.what()).find("byte order"), std::string::npos);
+	}
+
+	// A count far beyond the file size fails before anything is allocated
+	header.byte_order = non_stl::snapshot_header::ORDER_TAG;
+	header.version = non_stl::snapshot_header::VERSION;
+	header.element_size = sizeof(std::uint32_t);
+	header.data_offset = non_stl::snapshot_header::DATA_OFFSET;
+	for (std::uint64_t count : { std::uint64_t(1) << 61, std::uint64_t(1) << 30, ~std::uint64_t(0) }) {
+		header.count = count;
+		{
+			int fd = ::open(path.c_str(), O_WRONLY | O_TRUNC);
+			ASSERT_GE(fd, 0);
+			ASSERT_EQ(::write(fd, &header, sizeof(header)), static_cast<ssize_t>(sizeof(header)));
+			::close(fd);
+		}
+		try {
+			non_stl::load(path, loaded);
+			FAIL();
+		}
+		catch (const std::system_error& e) {
+			ASSERT_EQ(e.code().value(), EINVAL);
+		}
+		ASSERT_TRUE(loaded.empty());
+	}
+
+	// Missing file
+	std::remove(path.c_str());
+	ASSERT_THROW(non_stl::load(path, loaded), std::system_error);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
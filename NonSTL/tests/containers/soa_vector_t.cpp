@@ -0,0 +1,271 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "../../algorithms/simd.h"
+#include "../../containers/soa_vector.h"
+#include "../../memory/monotonic_buffer.h"
+
+using particles = non_stl::soa_vector<float, std::uint32_t, std::string>;
+
+// Throws once the countdown reaches 0, both from copies and from moves
+struct throwing_copy {
+	static int countdown;
+
+	int value;
+
+	throwing_copy(int v = 0) : value(v) {}
+	throwing_copy(const throwing_copy& rhs) : value(rhs.value) { tick(); }
+	throwing_copy(throwing_copy&& rhs) : value(rhs.value) { tick(); }
+	throwing_copy& operator=(const throwing_copy&) = default;
+
+	static void tick() {
+		if (countdown > 0 && --countdown == 0) {
+			throw std::runtime_error("throwing_copy");
+		}
+	}
+};
+
+int throwing_copy::countdown = 0;
+
+// Constructors
+
+TEST(BasicConstruct, Basic) {
+	particles vec;
+	ASSERT_TRUE(vec.empty());
+	ASSERT_EQ(vec.size(), 0);
+	ASSERT_EQ(vec.capacity(), 0);
+	ASSERT_EQ(vec.begin(), vec.end());
+}
+
+TEST(SizeConstruct, Basic) {
+	particles vec(5);
+	ASSERT_EQ(vec.size(), 5);
+	for (auto [x, id, name] : vec) {
+		ASSERT_EQ(x, 0.0f);
+		ASSERT_EQ(id, 0u);
+		ASSERT_TRUE(name.empty());
+	}
+
+	particles filled(3, { 1.5f, 7u, "p" });
+	ASSERT_EQ(filled.size(), 3);
+	ASSERT_EQ(std::get<2>(filled[2]), "p");
+}
+
+TEST(CopyConstruct, Basic) {
+	particles vec;
+	for (std::uint32_t i = 0; i < 100; ++i) {
+		vec.emplace_back(static_cast<float>(i), i, std::to_string(i));
+	}
+
+	particles copy(vec);
+	ASSERT_EQ(copy.size(), 100);
+	ASSERT_TRUE(copy == vec);
+	ASSERT_NE(copy.data<0>(), vec.data<0>());
+
+	std::get<2>(copy[50]) = "changed";
+	ASSERT_TRUE(copy != vec);
+
+	copy = vec;
+	ASSERT_TRUE(copy == vec);
+}
+
+TEST(MoveConstruct, Basic) {
+	particles vec;
+	vec.push_back({ 1.0f, 1u, "a" });
+	vec.push_back({ 2.0f, 2u, "b" });
+	const float* column = vec.data<0>();
+
+	particles moved(std::move(vec));
+	ASSERT_EQ(moved.size(), 2);
+	ASSERT_EQ(moved.data<0>(), column);
+	ASSERT_EQ(vec.size(), 0);
+	ASSERT_EQ(vec.capacity(), 0);
+
+	particles assigned;
+	assigned = std::move(moved);
+	ASSERT_EQ(assigned.size(), 2);
+	ASSERT_EQ(std::get<2>(assigned.back()), "b");
+}
+
+// Element access
+
+TEST(ElementAccess, Basic) {
+	particles vec;
+	vec.emplace_back(0.5f, 3u, "x");
+	vec.emplace_back();
+
+	auto [x, id, name] = vec[0];
+	ASSERT_EQ(x, 0.5f);
+	ASSERT_EQ(id, 3u);
+	ASSERT_EQ(name, "x");
+
+	// Rows are references into the columns
+	std::get<1>(vec.front()) = 9u;
+	ASSERT_EQ(vec.column<1>()[0], 9u);
+	ASSERT_EQ(std::get<1>(vec.back()), 0u);
+
+	ASSERT_NO_THROW(vec.at(1));
+	ASSERT_THROW(vec.at(2), std::out_of_range);
+
+	const particles& view = vec;
+	ASSERT_EQ(std::get<2>(view.at(0)), "x");
+}
+
+TEST(Columns, Basic) {
+	particles vec;
+	for (std::uint32_t i = 0; i < 1000; ++i) {
+		vec.push_back({ static_cast<float>(i), i * 2, "" });
+	}
+
+	// Every column starts on a cache line of the same allocation
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(vec.data<0>()) % non_stl::cache_line_size, 0u);
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(vec.data<1>()) % non_stl::cache_line_size, 0u);
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(vec.data<2>()) % non_stl::cache_line_size, 0u);
+
+	auto ids = vec.column<1>();
+	ASSERT_EQ(ids.size(), 1000);
+	for (std::uint32_t i = 0; i < 1000; ++i) {
+		ASSERT_EQ(ids[i], i * 2);
+	}
+
+	// Columns stream straight into the simd algorithms
+	ASSERT_EQ(non_stl::simd::accumulate(vec.column<1>(), std::uint64_t(0)), 999u * 1000u);
+	ASSERT_EQ(non_stl::simd::find(vec.column<1>(), 20u), 10u);
+}
+
+// Iterators
+
+TEST(ZipIterator, Basic) {
+	particles vec;
+	for (std::uint32_t i = 0; i < 10; ++i) {
+		vec.emplace_back(static_cast<float>(i), i, std::to_string(i));
+	}
+
+	std::uint32_t expected = 0;
+	for (auto [x, id, name] : vec) {
+		ASSERT_EQ(x, static_cast<float>(expected));
+		ASSERT_EQ(name, std::to_string(expected));
+		id += 100;
+		++expected;
+	}
+	ASSERT_EQ(std::get<1>(vec[3]), 103u);
+
+	auto it = vec.begin();
+	ASSERT_EQ(vec.end() - it, 10);
+	ASSERT_EQ(std::get<1>(it[4]), 104u);
+	it += 9;
+	ASSERT_EQ(std::get<1>(*it), 109u);
+	ASSERT_EQ(std::get<1>(*vec.rbegin()), 109u);
+
+	particles::const_iterator cit = vec.begin();
+	ASSERT_TRUE(cit == vec.cbegin());
+	ASSERT_TRUE(cit < vec.cend());
+}
+
+// Capacity
+
+TEST(Growth, SingleReallocation) {
+	particles vec;
+	vec.reserve(10);
+	ASSERT_EQ(vec.capacity(), 10);
+
+	for (std::uint32_t i = 0; i < 10; ++i) {
+		vec.emplace_back(1.0f, i, "s");
+	}
+	const auto* ids = vec.data<1>();
+	ASSERT_EQ(vec.data<1>(), ids);
+
+	// The growth policy decides the capacity for the whole row
+	vec.emplace_back(1.0f, 10u, "s");
+	ASSERT_EQ(vec.capacity(), non_stl::double_growth::grow(10, 0));
+	ASSERT_EQ(vec.size(), 11);
+	for (std::uint32_t i = 0; i < 11; ++i) {
+		ASSERT_EQ(vec.column<1>()[i], i);
+		ASSERT_EQ(vec.column<2>()[i], "s");
+	}
+
+	vec.shrink_to_fit();
+	ASSERT_EQ(vec.capacity(), 11);
+
+	vec.resize(3);
+	ASSERT_EQ(vec.size(), 3);
+	vec.resize(6, { 2.0f, 5u, "r" });
+	ASSERT_EQ(std::get<2>(vec[5]), "r");
+}
+
+TEST(Growth, AliasingPushBack) {
+	non_stl::soa_vector<std::string, int> vec;
+	vec.emplace_back("first", 1);
+	vec.shrink_to_fit();
+
+	// The arguments refer to the row being relocated
+	vec.emplace_back(std::get<0>(vec[0]), std::get<1>(vec[0]));
+	ASSERT_EQ(std::get<0>(vec[1]), "first");
+	ASSERT_EQ(std::get<1>(vec[1]), 1);
+}
+
+TEST(Growth, StrongGuarantee) {
+	non_stl::soa_vector<std::string, throwing_copy> vec;
+	for (int i = 0; i < 4; ++i) {
+		vec.emplace_back(std::to_string(i), i);
+	}
+	vec.shrink_to_fit();
+
+	// The third copy of the second column fails while relocating
+	throwing_copy::countdown = 3;
+	ASSERT_THROW(vec.emplace_back("4", 4), std::runtime_error);
+	throwing_copy::countdown = 0;
+
+	ASSERT_EQ(vec.size(), 4);
+	for (int i = 0; i < 4; ++i) {
+		ASSERT_EQ(std::get<0>(vec[i]), std::to_string(i));
+		ASSERT_EQ(std::get<1>(vec[i]).value, i);
+	}
+}
+
+// Modifiers
+
+TEST(Modifiers, Basic) {
+	particles vec;
+	vec.push_back({ 1.0f, 1u, std::string(100, 'a') });
+	vec.push_back({ 2.0f, 2u, "b" });
+	vec.pop_back();
+	ASSERT_EQ(vec.size(), 1);
+
+	particles other(4);
+	vec.swap(other);
+	ASSERT_EQ(vec.size(), 4);
+	ASSERT_EQ(other.size(), 1);
+	ASSERT_EQ(std::get<2>(other[0]).size(), 100);
+
+	auto cap = vec.capacity();
+	vec.clear();
+	ASSERT_TRUE(vec.empty());
+	ASSERT_EQ(vec.capacity(), cap);
+}
+
+TEST(Allocator, Pmr) {
+	non_stl::monotonic_buffer resource;
+	non_stl::pmr::soa_vector<double, std::int64_t> vec(&resource);
+	for (int i = 0; i < 1000; ++i) {
+		vec.emplace_back(i * 0.5, i);
+	}
+	ASSERT_EQ(std::get<1>(vec[999]), 999);
+	ASSERT_EQ(vec.get_allocator().resource(), &resource);
+
+	// An unequal allocator takes the rows one column at a time
+	non_stl::monotonic_buffer other_resource;
+	non_stl::pmr::soa_vector<double, std::int64_t> moved(std::move(vec), &other_resource);
+	ASSERT_EQ(moved.size(), 1000);
+	ASSERT_EQ(std::get<0>(moved[10]), 5.0);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
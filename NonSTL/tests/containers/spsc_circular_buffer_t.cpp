@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../../containers/spsc_circular_buffer.h"
+
+// Single threaded
+
+TEST(SpscCapacityTest, Basic) {
+	non_stl::spsc_circular_buffer<int, 3> buf;
+	ASSERT_EQ(buf.capacity(), 3);
+	ASSERT_TRUE(buf.empty());
+
+	ASSERT_TRUE(buf.try_push(1));
+	ASSERT_TRUE(buf.try_push(2));
+	ASSERT_TRUE(buf.try_push(3));
+	ASSERT_FALSE(buf.try_push(4));
+	ASSERT_EQ(buf.size(), 3);
+
+	int out = 0;
+	ASSERT_TRUE(buf.try_pop(out));
+	ASSERT_EQ(out, 1);
+	ASSERT_TRUE(buf.try_push(4));
+
+	ASSERT_TRUE(buf.try_pop(out));
+	ASSERT_EQ(out, 2);
+	ASSERT_TRUE(buf.try_pop(out));
+	ASSERT_EQ(out, 3);
+	ASSERT_TRUE(buf.try_pop(out));
+	ASSERT_EQ(out, 4);
+	ASSERT_FALSE(buf.try_pop(out));
+	ASSERT_EQ(out, 4);
+	ASSERT_TRUE(buf.empty());
+}
+
+TEST(SpscWrapTest, Basic) {
+	non_stl::spsc_circular_buffer<int, 4> buf;
+
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_TRUE(buf.try_push(i));
+		ASSERT_TRUE(buf.try_push(i + 1000));
+		ASSERT_EQ(buf.size(), 2);
+
+		int out = 0;
+		ASSERT_TRUE(buf.try_pop(out));
+		ASSERT_EQ(out, i);
+		ASSERT_TRUE(buf.try_pop(out));
+		ASSERT_EQ(out, i + 1000);
+	}
+	ASSERT_EQ(buf.size(), 0);
+}
+
+TEST(SpscEmplaceTest, Basic) {
+	non_stl::spsc_circular_buffer<std::string, 2> buf;
+
+	ASSERT_EQ(buf.front(), nullptr);
+	ASSERT_TRUE(buf.try_emplace(3, 'a'));
+	ASSERT_TRUE(buf.try_emplace("bc"));
+	ASSERT_FALSE(buf.try_emplace("de"));
+
+	ASSERT_NE(buf.front(), nullptr);
+	ASSERT_EQ(*buf.front(), "aaa");
+	buf.pop_front();
+	ASSERT_EQ(*buf.front(), "bc");
+	buf.pop_front();
+	ASSERT_EQ(buf.front(), nullptr);
+}
+
+TEST(SpscLifetimeTest, Basic) {
+	auto tracker = std::make_shared<int>(0);
+	{
+		non_stl::spsc_circular_buffer<std::shared_ptr<int>, 4> buf;
+		buf.try_push(tracker);
+		buf.try_push(tracker);
+		ASSERT_EQ(tracker.use_count(), 3);
+
+		std::shared_ptr<int> out;
+		buf.try_pop(out);
+		ASSERT_EQ(tracker.use_count(), 3);
+		out.reset();
+		ASSERT_EQ(tracker.use_count(), 2);
+	}
+	// Remaining elements are destroyed with the buffer
+	ASSERT_EQ(tracker.use_count(), 1);
+}
+
+// Multi threaded
+
+TEST(SpscThreadTest, Ordering) {
+	constexpr int COUNT = 200000;
+	non_stl::spsc_circular_buffer<int, 64> buf;
+
+	std::thread producer([&buf]() {
+		for (int i = 0; i < COUNT; ++i) {
+			while (!buf.try_push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	bool ordered = true;
+	for (int expected = 0; expected < COUNT; ) {
+		int out;
+		if (buf.try_pop(out)) {
+			ordered = ordered && out == expected;
+			++expected;
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+
+	ASSERT_TRUE(ordered);
+	ASSERT_TRUE(buf.empty());
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../../containers/deque.h"
+#include "../../containers/stack.h"
+
+TEST(StackTest, Basic) {
+	non_stl::stack<int> stack;
+	ASSERT_TRUE(stack.empty());
+
+	stack.push(1);
+	stack.push(2);
+	ASSERT_EQ(stack.emplace(3), 3);
+	ASSERT_EQ(stack.size(), 3);
+	ASSERT_EQ(stack.top(), 3);
+
+	stack.top() = 30;
+	stack.pop();
+	ASSERT_EQ(stack.top(), 2);
+	stack.pop();
+	stack.pop();
+	ASSERT_TRUE(stack.empty());
+}
+
+TEST(StackTest, Construct) {
+	std::vector<std::string> source{ "a", "b", "c" };
+	non_stl::stack<std::string> ranged(source.begin(), source.end());
+	ASSERT_EQ(ranged.size(), 3);
+	ASSERT_EQ(ranged.top(), "c");
+
+	non_stl::vector<std::string> cont{ "x", "y" };
+	non_stl::stack<std::string> adopted(std::move(cont));
+	ASSERT_EQ(adopted.top(), "y");
+
+	adopted.push_range(source);
+	ASSERT_EQ(adopted.size(), 5);
+	ASSERT_EQ(adopted.top(), "c");
+
+	non_stl::stack<std::string> copy(adopted);
+	ASSERT_EQ(copy, adopted);
+	copy.pop();
+	ASSERT_NE(copy, adopted);
+
+	swap(copy, ranged);
+	ASSERT_EQ(copy.size(), 3);
+	ASSERT_EQ(ranged.size(), 4);
+}
+
+TEST(StackTest, Deque) {
+	// Any sequence with back, push_back and pop_back works
+	non_stl::stack<int, non_stl::deque<int> > stack;
+	for (int i = 0; i < 10000; ++i) {
+		stack.push(i);
+	}
+	for (int i = 9999; i >= 0; --i) {
+		ASSERT_EQ(stack.top(), i);
+		stack.pop();
+	}
+	ASSERT_TRUE(stack.empty());
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
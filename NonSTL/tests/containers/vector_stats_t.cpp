@@ -0,0 +1,152 @@
+#ifndef NON_STL_VECTOR_STATS
+#define NON_STL_VECTOR_STATS
+#endif
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "../../containers/vector.h"
+
+// Returns the registry entry recorded for line of this file, or nullptr
+static const non_stl::vector_site_stats* site_stats(
+	const std::vector<non_stl::vector_stats_registry::entry>& entries, unsigned line) {
+	for (const auto& entry : entries) {
+		if (entry.first.line == line && std::strstr(entry.first.file, "vector_stats_t.cpp")) {
+			return &entry.second;
+		}
+	}
+	return nullptr;
+}
+
+// Destroyed after main returns, when it still records into the registry
+static non_stl::vector<int> global_vector;
+
+// Per instance statistics
+
+TEST(VectorStatsTest, Instance) {
+	non_stl::vector<int> v;
+	const unsigned line = __LINE__ - 1;
+
+	auto stats = v.stats();
+	ASSERT_EQ(stats.site.line, line);
+	ASSERT_NE(std::strstr(stats.site.file, "vector_stats_t.cpp"), nullptr);
+	ASSERT_EQ(stats.reallocations, 0);
+
+	for (int i = 0; i < 100; ++i) {
+		v.push_back(i);
+	}
+	stats = v.stats();
+	ASSERT_GT(stats.reallocations, 0);
+	ASSERT_GT(stats.bytes_relocated, 0);
+	ASSERT_EQ(stats.bytes_relocated % sizeof(int), 0);
+	ASSERT_EQ(stats.peak_capacity, v.capacity());
+	ASSERT_EQ(stats.size, 100);
+	ASSERT_EQ(stats.capacity, v.capacity());
+	ASSERT_DOUBLE_EQ(stats.wasted_capacity_ratio(), double(v.capacity() - 100) / double(v.capacity()));
+
+	// Shrinking keeps the peak and counts as a reallocation
+	const auto peak = v.capacity();
+	const auto reallocations = stats.reallocations;
+	v.resize(10);
+	v.shrink_to_fit();
+	stats = v.stats();
+	ASSERT_EQ(stats.reallocations, reallocations + 1);
+	ASSERT_EQ(stats.peak_capacity, peak);
+	ASSERT_DOUBLE_EQ(stats.wasted_capacity_ratio(), 0.0);
+}
+
+TEST(VectorStatsTest, Reserve) {
+	non_stl::vector<std::string> v;
+	v.reserve(1000);
+	const auto reallocations = v.stats().reallocations;
+
+	for (int i = 0; i < 1000; ++i) {
+		v.emplace_back(32, 'x');
+	}
+	ASSERT_EQ(v.stats().reallocations, reallocations);
+
+	// Inserting past the capacity reallocates once and relocates every element
+	v.insert(v.begin() + 500, std::string(32, 'y'));
+	ASSERT_EQ(v.stats().reallocations, reallocations + 1);
+}
+
+TEST(VectorStatsTest, MoveKeepsPeak) {
+	non_stl::vector<int> a;
+	for (int i = 0; i < 1000; ++i) {
+		a.push_back(i);
+	}
+	const auto peak = a.capacity();
+
+	non_stl::vector<int> b(std::move(a));
+	ASSERT_EQ(b.stats().reallocations, 0);
+	ASSERT_EQ(a.stats().peak_capacity, peak);
+	ASSERT_EQ(a.stats().capacity, 0);
+
+	non_stl::vector<int> c;
+	c.swap(b);
+	ASSERT_EQ(b.stats().peak_capacity, peak);
+}
+
+// Registry
+
+TEST(VectorStatsRegistryTest, Aggregate) {
+	auto& registry = non_stl::vector_stats_registry::instance();
+	registry.reset();
+
+	unsigned churn_line = 0;
+	unsigned reserved_line = 0;
+	for (int n = 0; n < 3; ++n) {
+		non_stl::vector<int> churn; churn_line = __LINE__;
+		non_stl::vector<int> reserved; reserved_line = __LINE__;
+		reserved.reserve(500);
+		for (int i = 0; i < 500; ++i) {
+			churn.push_back(i);
+			reserved.push_back(i);
+		}
+		ASSERT_NE(churn.stats().site.line, reserved.stats().site.line);
+	}
+
+	const auto entries = registry.snapshot();
+	const auto* churn = site_stats(entries, churn_line);
+	const auto* reserved = site_stats(entries, reserved_line);
+	ASSERT_NE(churn, nullptr);
+	ASSERT_NE(reserved, nullptr);
+
+	ASSERT_EQ(churn->instances, 3);
+	ASSERT_EQ(reserved->instances, 3);
+	ASSERT_GT(churn->reallocations, reserved->reallocations);
+	ASSERT_EQ(reserved->reallocations, 3);
+	ASSERT_EQ(reserved->total_size, 1500);
+	ASSERT_EQ(reserved->total_capacity, 1500);
+	ASSERT_DOUBLE_EQ(reserved->wasted_capacity_ratio(), 0.0);
+	ASSERT_GE(churn->peak_capacity, 500);
+
+	// The sites which reallocate the most come first
+	for (size_t i = 1; i < entries.size(); ++i) {
+		ASSERT_GE(entries[i - 1].second.reallocations, entries[i].second.reallocations);
+	}
+
+	registry.reset();
+	ASSERT_TRUE(registry.snapshot().empty());
+}
+
+// Namespace scope vectors
+
+TEST(VectorStatsTest, StaticStorage) {
+	for (int i = 0; i < 100; ++i) {
+		global_vector.push_back(i);
+	}
+	ASSERT_GT(global_vector.stats().reallocations, 0);
+
+	// A function local static is destroyed before global_vector, the registry must outlive both
+	static non_stl::vector<int> local_vector(10, 1);
+	ASSERT_EQ(local_vector.size(), 10);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
 #include "../../containers/vector.h"
 
 // Constructors
@@ -131,6 +138,10 @@ TEST(ResizeTest, Basic) {
 	vec1.resize(15, 7);
 	ASSERT_EQ(vec1.size(), 15);
 	ASSERT_EQ(vec1[12], 7);
+	ASSERT_EQ(vec1[3], 7);
+
+	// Existing elements are left alone
+	ASSERT_EQ(vec1[2], 0);
 
 	// Decrease size with values, nothing should change besides size
 	vec1.resize(8, 4);
@@ -315,6 +326,37 @@ TEST(InsertTest, Basic) {
 	ASSERT_EQ(vec2[5], 2);
 }
 
+TEST(EraseTest, Basic) {
+	non_stl::vector<int> vec{ 0,1,2,3,4,5 };
+
+	auto it = vec.erase(vec.begin() + 1);
+	ASSERT_EQ(vec.size(), 5);
+	ASSERT_EQ(*it, 2);
+	ASSERT_EQ(vec[0], 0);
+	ASSERT_EQ(vec[4], 5);
+
+	it = vec.erase(vec.begin() + 1, vec.begin() + 3);
+	ASSERT_EQ(vec.size(), 3);
+	ASSERT_EQ(*it, 4);
+	ASSERT_EQ(vec[0], 0);
+	ASSERT_EQ(vec[1], 4);
+
+	// Erasing the tail returns end
+	it = vec.erase(vec.begin() + 1, vec.end());
+	ASSERT_EQ(it, vec.end());
+	ASSERT_EQ(vec.size(), 1);
+
+	vec.erase(vec.begin(), vec.begin());
+	ASSERT_EQ(vec.size(), 1);
+
+	// Non trivial elements are destroyed and shifted
+	non_stl::vector<std::string> strings{ "a", "b", "c" };
+	strings.erase(strings.begin());
+	ASSERT_EQ(strings.size(), 2);
+	ASSERT_EQ(strings[0], "b");
+	ASSERT_EQ(strings[1], "c");
+}
+
 TEST(SwapTest, Basic) {
 	non_stl::vector<int> vec1{ 0,1,2,3,4 };
 	non_stl::vector<int> vec2{ 5,6 };
@@ -340,6 +382,345 @@ TEST(ClearTest, Basic) {
 	ASSERT_EQ(vec.size(), 0);
 }
 
+TEST(GrowthPolicyTest, Basic) {
+	// Default policy doubles the capacity
+	non_stl::vector<int> vec1(4);
+	ASSERT_EQ(vec1.capacity(), 8);
+
+	// 1.5x growth
+	non_stl::vector<int, std::allocator<int>, non_stl::one_and_half_growth> vec2(4);
+	ASSERT_EQ(vec2.capacity(), 6);
+	vec2.shrink_to_fit();
+	vec2.push_back(1);
+	ASSERT_EQ(vec2.capacity(), 6);
+	ASSERT_EQ(vec2.size(), 5);
+
+	// Page rounded growth, 4096 bytes of ints
+	non_stl::vector<int, std::allocator<int>, non_stl::page_rounded_growth<>> vec3(4);
+	ASSERT_EQ(vec3.capacity(), 1024);
+
+	// Growing from an empty vector always makes progress
+	non_stl::vector<int> vec4(0);
+	vec4.push_back(3);
+	ASSERT_EQ(vec4.size(), 1);
+	ASSERT_EQ(vec4[0], 3);
+	ASSERT_GT(vec4.capacity(), 0);
+}
+
+TEST(RelocateTest, Basic) {
+	// Trivially relocatable elements survive a reallocation
+	non_stl::vector<int> vec1;
+	for (int i = 0; i < 1000; ++i)
+	{
+		vec1.push_back(i);
+	}
+	ASSERT_EQ(vec1.size(), 1000);
+	for (int i = 0; i < 1000; ++i)
+	{
+		ASSERT_EQ(vec1[i], i);
+	}
+
+	// Non trivial elements are moved into the new array
+	non_stl::vector<std::string> vec2;
+	for (int i = 0; i < 100; ++i)
+	{
+		vec2.push_back(std::string(32, (char)('a' + i % 26)));
+	}
+	ASSERT_EQ(vec2.size(), 100);
+	for (int i = 0; i < 100; ++i)
+	{
+		ASSERT_EQ(vec2[i], std::string(32, (char)('a' + i % 26)));
+	}
+
+	vec2.shrink_to_fit();
+	ASSERT_EQ(vec2.capacity(), 100);
+	ASSERT_EQ(vec2[99], std::string(32, (char)('a' + 99 % 26)));
+}
+
+TEST(IteratorArithmeticTest, Basic) {
+	non_stl::vector<int> vec{ 0,1,2,3,4,5 };
+
+	auto it = vec.begin();
+	ASSERT_EQ(*(it + 3), 3);
+	ASSERT_EQ(it[4], 4);
+	ASSERT_EQ(vec.end() - vec.begin(), 6);
+	ASSERT_TRUE(vec.begin() < vec.end());
+	ASSERT_TRUE(vec.end() >= vec.begin() + 6);
+
+	it += 5;
+	ASSERT_EQ(*it, 5);
+	it -= 2;
+	ASSERT_EQ(*it, 3);
+	ASSERT_EQ(*(it--), 3);
+	ASSERT_EQ(*it, 2);
+
+	// Equality depends on position only, not on the values
+	non_stl::vector<int> same{ 7,7,7 };
+	ASSERT_NE(same.begin(), same.begin() + 1);
+
+	// iterator converts to const_iterator
+	non_stl::vector<int>::const_iterator cit = vec.begin();
+	ASSERT_TRUE(cit == vec.begin());
+	ASSERT_EQ(vec.cend() - cit, 6);
+
+#if __cplusplus >= 202002L
+	static_assert(std::contiguous_iterator<non_stl::vector<int>::iterator>);
+	static_assert(std::contiguous_iterator<non_stl::vector<int>::const_iterator>);
+#endif
+
+	// Reverse iteration
+	auto rit = vec.rbegin();
+	ASSERT_EQ(*rit, 5);
+	ASSERT_EQ(vec.rend() - vec.rbegin(), 6);
+}
+
+TEST(IteratorAlgorithmTest, Basic) {
+	non_stl::vector<int> vec{ 5,3,9,1,7,2 };
+
+	std::sort(vec.begin(), vec.end());
+	for (size_type i = 1; i < vec.size(); ++i)
+	{
+		ASSERT_LE(vec[i - 1], vec[i]);
+	}
+
+	auto it = std::lower_bound(vec.begin(), vec.end(), 7);
+	ASSERT_EQ(*it, 7);
+	ASSERT_EQ(it - vec.begin(), 4);
+
+	// Range for loops work through the iterators
+	int sum = 0;
+	for (const auto& x : vec)
+	{
+		sum += x;
+	}
+	ASSERT_EQ(sum, 27);
+}
+
+TEST(InsertRangeTest, Basic) {
+	// Insert in the middle without reallocating
+	non_stl::vector<int> vec1{ 0,1,2,3 };
+	vec1.reserve(32);
+	auto data = vec1.data();
+	const int arr[] = { 7,8,9 };
+	auto it = vec1.insert_range(vec1.begin() + 2, arr);
+	ASSERT_EQ(vec1.data(), data);
+	ASSERT_EQ(it - vec1.begin(), 2);
+	ASSERT_EQ(vec1.size(), 7);
+	const int expected1[] = { 0,1,7,8,9,2,3 };
+	for (size_type i = 0; i < vec1.size(); ++i)
+	{
+		ASSERT_EQ(vec1[i], expected1[i]);
+	}
+
+	// Insert forcing a single reallocation large enough for the whole range
+	non_stl::vector<int> vec2{ 0,1 };
+	vec2.shrink_to_fit();
+	non_stl::vector<int> big(100, 5);
+	vec2.insert(vec2.begin() + 1, big.begin(), big.end());
+	ASSERT_EQ(vec2.size(), 102);
+	ASSERT_GE(vec2.capacity(), 102);
+	ASSERT_EQ(vec2[0], 0);
+	ASSERT_EQ(vec2[1], 5);
+	ASSERT_EQ(vec2[100], 5);
+	ASSERT_EQ(vec2[101], 1);
+
+	// Non trivial elements
+	non_stl::vector<std::string> vec3{ "a", "d" };
+	non_stl::vector<std::string> vec4{ "b", "c" };
+	vec3.insert(vec3.begin() + 1, vec4.begin(), vec4.end());
+	ASSERT_EQ(vec3.size(), 4);
+	ASSERT_EQ(vec3[0], "a");
+	ASSERT_EQ(vec3[1], "b");
+	ASSERT_EQ(vec3[2], "c");
+	ASSERT_EQ(vec3[3], "d");
+
+	vec3.insert(vec3.begin(), { "x", "y" });
+	ASSERT_EQ(vec3.size(), 6);
+	ASSERT_EQ(vec3[0], "x");
+	ASSERT_EQ(vec3[1], "y");
+	ASSERT_EQ(vec3[5], "d");
+
+	// Single pass iterators
+	std::istringstream in("4 5 6");
+	non_stl::vector<int> vec5{ 1,2,3 };
+	vec5.insert(vec5.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+	ASSERT_EQ(vec5.size(), 6);
+	const int expected5[] = { 1,4,5,6,2,3 };
+	for (size_type i = 0; i < vec5.size(); ++i)
+	{
+		ASSERT_EQ(vec5[i], expected5[i]);
+	}
+}
+
+// Counts the moves of a type which isn't trivially relocatable
+struct MoveCounted
+{
+	static int moves;
+
+	int value;
+
+	MoveCounted(int v) : value(v) {}
+	MoveCounted(const MoveCounted& other) : value(other.value) {}
+	MoveCounted(MoveCounted&& other) noexcept : value(other.value) { ++moves; }
+	MoveCounted& operator=(const MoveCounted& other) { value = other.value; return *this; }
+	MoveCounted& operator=(MoveCounted&& other) noexcept { value = other.value; ++moves; return *this; }
+};
+
+int MoveCounted::moves = 0;
+
+// Copying throws once the countdown reaches 0 and moving may throw, so relocation copies
+struct ThrowingCopy
+{
+	static int countdown;
+
+	int value;
+
+	ThrowingCopy(int v) : value(v) {}
+	ThrowingCopy(const ThrowingCopy& other) : value(other.value)
+	{
+		if (countdown > 0 && --countdown == 0)
+		{
+			throw std::runtime_error("copy");
+		}
+	}
+	ThrowingCopy& operator=(const ThrowingCopy& other) = default;
+};
+
+int ThrowingCopy::countdown = 0;
+
+TEST(InsertGrowTest, Basic) {
+	// Growing for an insert relocates every element once, straight into its final place
+	non_stl::vector<MoveCounted> vec1;
+	for (int i = 0; i < 10; ++i)
+	{
+		vec1.emplace_back(i);
+	}
+	vec1.shrink_to_fit();
+	const MoveCounted arr[] = { 100, 101, 102 };
+	MoveCounted::moves = 0;
+	vec1.insert(vec1.begin() + 4, arr, arr + 3);
+	ASSERT_EQ(MoveCounted::moves, 10);
+	const int expected1[] = { 0,1,2,3,100,101,102,4,5,6,7,8,9 };
+	ASSERT_EQ(vec1.size(), 13);
+	for (size_type i = 0; i < vec1.size(); ++i)
+	{
+		ASSERT_EQ(vec1[i].value, expected1[i]);
+	}
+
+	// A copy throwing while relocating the elements after the gap leaves the vector as it was
+	non_stl::vector<ThrowingCopy> vec2;
+	for (int i = 0; i < 6; ++i)
+	{
+		vec2.emplace_back(i);
+	}
+	vec2.shrink_to_fit();
+	const auto capacity = vec2.capacity();
+	ThrowingCopy::countdown = 5;
+	ASSERT_THROW(vec2.insert(vec2.begin() + 3, ThrowingCopy(9)), std::runtime_error);
+	ThrowingCopy::countdown = 0;
+	ASSERT_EQ(vec2.size(), 6);
+	ASSERT_EQ(vec2.capacity(), capacity);
+	for (int i = 0; i < 6; ++i)
+	{
+		ASSERT_EQ(vec2[i].value, i);
+	}
+}
+
+TEST(AppendRangeTest, Basic) {
+	non_stl::vector<int> vec1;
+	non_stl::vector<int> chunk(64, 3);
+
+	for (int i = 0; i < 100; ++i)
+	{
+		vec1.append_range(chunk);
+	}
+	ASSERT_EQ(vec1.size(), 6400);
+	ASSERT_EQ(vec1[6399], 3);
+
+	std::list<std::string> lst{ "a", "b" };
+	non_stl::vector<std::string> vec2{ "z" };
+	vec2.append_range(lst.begin(), lst.end());
+	ASSERT_EQ(vec2.size(), 3);
+	ASSERT_EQ(vec2[0], "z");
+	ASSERT_EQ(vec2[1], "a");
+	ASSERT_EQ(vec2[2], "b");
+}
+
+TEST(InsertSelfTest, Basic) {
+	// Inserting an element of the vector into itself
+	non_stl::vector<std::string> vec{ std::string(40, 'a'), std::string(40, 'b') };
+	vec.shrink_to_fit();
+	vec.insert(vec.begin(), vec[1]);
+	ASSERT_EQ(vec.size(), 3);
+	ASSERT_EQ(vec[0], std::string(40, 'b'));
+	ASSERT_EQ(vec[1], std::string(40, 'a'));
+
+	vec.shrink_to_fit();
+	vec.push_back(vec[0]);
+	ASSERT_EQ(vec[3], std::string(40, 'b'));
+}
+
+TEST(ResizeValueInitTest, Basic) {
+	// Growing value initializes the new elements
+	non_stl::vector<int> vec1{ 1,2,3 };
+	vec1.resize(1000);
+	ASSERT_EQ(vec1.size(), 1000);
+	ASSERT_EQ(vec1[2], 3);
+	for (size_type i = 3; i < vec1.size(); ++i)
+	{
+		ASSERT_EQ(vec1[i], 0);
+	}
+
+	non_stl::vector<std::string> vec2{ "a" };
+	vec2.resize(3);
+	ASSERT_EQ(vec2.size(), 3);
+	ASSERT_EQ(vec2[0], "a");
+	ASSERT_EQ(vec2[2], "");
+
+	vec2.resize(5, "b");
+	ASSERT_EQ(vec2[2], "");
+	ASSERT_EQ(vec2[3], "b");
+	ASSERT_EQ(vec2[4], "b");
+}
+
+TEST(ResizeDefaultInitTest, Basic) {
+	non_stl::vector<unsigned char> vec1{ 1,2 };
+	vec1.resize_default_init(64);
+	ASSERT_EQ(vec1.size(), 64);
+	ASSERT_EQ(vec1[0], 1);
+	ASSERT_EQ(vec1[1], 2);
+
+	vec1.resize_default_init(1);
+	ASSERT_EQ(vec1.size(), 1);
+
+	// Non trivial elements are still default constructed
+	non_stl::vector<std::string> vec2;
+	vec2.resize_default_init(4);
+	ASSERT_EQ(vec2.size(), 4);
+	ASSERT_EQ(vec2[3], "");
+}
+
+TEST(AppendUninitializedTest, Basic) {
+	non_stl::vector<float> vec{ 1.0f };
+
+	auto out = vec.append_uninitialized(3);
+	ASSERT_EQ(out.size(), 3);
+	ASSERT_EQ(vec.size(), 4);
+	ASSERT_EQ(out.data(), vec.data() + 1);
+
+	// Fill the span the way a decoder would
+	for (size_type i = 0; i < out.size(); ++i)
+	{
+		out[i] = (float)(i + 2);
+	}
+	ASSERT_EQ(vec[0], 1.0f);
+	ASSERT_EQ(vec[1], 2.0f);
+	ASSERT_EQ(vec[3], 4.0f);
+
+	auto bytes = non_stl::as_writable_bytes(out);
+	ASSERT_EQ(bytes.size(), 3 * sizeof(float));
+}
+
 int main(int argc, char** argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
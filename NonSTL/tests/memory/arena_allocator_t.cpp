@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <new>
+#include <string>
+
+#include "../../memory/arena_allocator.h"
+#include "../../containers/small_vector.h"
+#include "../../containers/vector.h"
+
+// monotonic_buffer
+
+TEST(MonotonicBufferTest, Alignment) {
+	non_stl::monotonic_buffer buffer(64);
+
+	for (size_t align : { 1, 2, 4, 8, 16, 32, 64 }) {
+		void* p = buffer.allocate_bytes(3, align);
+		ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % align, 0u);
+	}
+	ASSERT_EQ(buffer.bytes_allocated(), 21u);
+}
+
+TEST(MonotonicBufferTest, Chunks) {
+	non_stl::monotonic_buffer buffer(64);
+
+	// Allocations larger than a chunk still succeed
+	auto big = static_cast<char*>(buffer.allocate_bytes(1000, 1));
+	for (int i = 0; i < 1000; ++i) {
+		big[i] = 'a';
+	}
+
+	// Allocations never overlap
+	auto first = static_cast<int*>(buffer.allocate_bytes(sizeof(int), alignof(int)));
+	auto second = static_cast<int*>(buffer.allocate_bytes(sizeof(int), alignof(int)));
+	ASSERT_NE(first, second);
+	*first = 1;
+	*second = 2;
+	ASSERT_EQ(*first, 1);
+	ASSERT_EQ(big[999], 'a');
+}
+
+TEST(MonotonicBufferTest, HugeRequest) {
+	non_stl::monotonic_buffer buffer(64);
+
+	// Requests the chunk size can't be computed for throw instead of wrapping around
+	const size_t max = static_cast<size_t>(-1);
+	ASSERT_THROW(buffer.allocate_bytes(max, 1), std::bad_alloc);
+	ASSERT_THROW(buffer.allocate_bytes(max - 8, 16), std::bad_alloc);
+
+	// The buffer is still usable afterwards
+	auto p = static_cast<int*>(buffer.allocate_bytes(sizeof(int), alignof(int)));
+	*p = 1;
+	ASSERT_EQ(*p, 1);
+}
+
+TEST(MonotonicBufferTest, InitialBuffer) {
+	alignas(std::max_align_t) unsigned char storage[256];
+	non_stl::monotonic_buffer buffer(storage, sizeof(storage));
+
+	auto p = static_cast<unsigned char*>(buffer.allocate_bytes(100, 1));
+	ASSERT_GE(p, storage);
+	ASSERT_LT(p, storage + sizeof(storage));
+
+	// Exhausting the caller buffer goes to upstream
+	auto q = static_cast<unsigned char*>(buffer.allocate_bytes(200, 1));
+	ASSERT_FALSE(q >= storage && q < storage + sizeof(storage));
+
+	// Release restarts from the caller buffer
+	buffer.release();
+	ASSERT_EQ(buffer.bytes_allocated(), 0u);
+	ASSERT_EQ(buffer.allocate_bytes(8, 1), static_cast<void*>(storage));
+}
+
+TEST(MonotonicBufferTest, ReleaseReuse) {
+	non_stl::monotonic_buffer buffer(64);
+
+	buffer.allocate_bytes(32, 1);
+	buffer.allocate_bytes(500, 1);
+	buffer.release();
+
+	// The kept chunk serves the same workload again
+	void* p = buffer.allocate_bytes(32, 1);
+	void* q = buffer.allocate_bytes(500, 1);
+	ASSERT_NE(p, nullptr);
+	ASSERT_NE(q, nullptr);
+}
+
+TEST(MonotonicBufferTest, MemoryResource) {
+	non_stl::monotonic_buffer buffer;
+	non_stl::monotonic_buffer other;
+	std::pmr::memory_resource& res = buffer;
+
+	ASSERT_TRUE(res.is_equal(buffer));
+	ASSERT_FALSE(res.is_equal(other));
+
+	void* p = res.allocate(16, 16);
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % 16, 0u);
+	res.deallocate(p, 16, 16);
+	ASSERT_EQ(buffer.bytes_allocated(), 16u);
+}
+
+// arena_allocator
+
+template <class T>
+using arena_vector = non_stl::vector<T, non_stl::arena_allocator<T> >;
+
+TEST(ArenaAllocatorTest, Equality) {
+	non_stl::monotonic_buffer a;
+	non_stl::monotonic_buffer b;
+
+	non_stl::arena_allocator<int> ia(a);
+	non_stl::arena_allocator<double> da(ia);
+	non_stl::arena_allocator<int> ib(b);
+
+	ASSERT_TRUE(ia == da);
+	ASSERT_TRUE(ia != ib);
+	ASSERT_EQ(da.buffer(), &a);
+}
+
+TEST(ArenaAllocatorTest, Overflow) {
+	non_stl::monotonic_buffer buffer;
+	non_stl::arena_allocator<std::uint64_t> alloc(buffer);
+
+	// n * sizeof(T) would wrap around to a small block
+	ASSERT_THROW(alloc.allocate(static_cast<size_t>(-1) / 4), std::bad_array_new_length);
+	ASSERT_THROW(alloc.allocate(static_cast<size_t>(-1) / 8 + 1), std::bad_array_new_length);
+	ASSERT_EQ(buffer.bytes_allocated(), 0u);
+}
+
+TEST(ArenaAllocatorTest, Vector) {
+	non_stl::monotonic_buffer buffer;
+	arena_vector<std::string> vec(buffer);
+
+	for (int i = 0; i < 100; ++i) {
+		vec.push_back(std::to_string(i));
+	}
+
+	ASSERT_EQ(vec.size(), 100);
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(vec[i], std::to_string(i));
+	}
+	ASSERT_GE(buffer.bytes_allocated(), 100 * sizeof(std::string));
+	ASSERT_EQ(vec.get_allocator().buffer(), &buffer);
+}
+
+TEST(ArenaAllocatorTest, VectorCopy) {
+	non_stl::monotonic_buffer buffer;
+	arena_vector<int> vec({ 1, 2, 3 }, buffer);
+
+	// Copies allocate from the same arena
+	arena_vector<int> copy(vec);
+	ASSERT_EQ(copy.get_allocator(), vec.get_allocator());
+	ASSERT_EQ(copy.size(), 3);
+	ASSERT_EQ(copy[2], 3);
+}
+
+TEST(ArenaAllocatorTest, VectorAssignKeepsAllocator) {
+	non_stl::monotonic_buffer a;
+	non_stl::monotonic_buffer b;
+
+	arena_vector<std::string> lhs({ "x" }, a);
+	arena_vector<std::string> rhs({ "one", "two", "three" }, b);
+
+	lhs = rhs;
+	ASSERT_EQ(lhs.get_allocator().buffer(), &a);
+	ASSERT_EQ(lhs.size(), 3);
+	ASSERT_EQ(lhs[1], "two");
+
+	// Unequal allocators which don't propagate move element by element
+	arena_vector<std::string> moved({ "four", "five" }, b);
+	const std::string* old_data = moved.data();
+	lhs = std::move(moved);
+	ASSERT_EQ(lhs.get_allocator().buffer(), &a);
+	ASSERT_NE(lhs.data(), old_data);
+	ASSERT_EQ(lhs.size(), 2);
+	ASSERT_EQ(lhs[0], "four");
+	ASSERT_EQ(lhs[1], "five");
+	ASSERT_EQ(moved.size(), 0);
+
+	// Equal allocators steal the array
+	arena_vector<std::string> same({ "six" }, a);
+	old_data = same.data();
+	lhs = std::move(same);
+	ASSERT_EQ(lhs.data(), old_data);
+	ASSERT_EQ(lhs[0], "six");
+}
+
+TEST(ArenaAllocatorTest, VectorSwap) {
+	non_stl::monotonic_buffer a;
+	non_stl::monotonic_buffer b;
+
+	arena_vector<int> lhs({ 1, 2 }, a);
+	arena_vector<int> rhs({ 3, 4, 5 }, b);
+
+	lhs.swap(rhs);
+	ASSERT_EQ(lhs.get_allocator().buffer(), &a);
+	ASSERT_EQ(rhs.get_allocator().buffer(), &b);
+	ASSERT_EQ(lhs.size(), 3);
+	ASSERT_EQ(lhs[2], 5);
+	ASSERT_EQ(rhs.size(), 2);
+	ASSERT_EQ(rhs[0], 1);
+}
+
+TEST(ArenaAllocatorTest, SmallVector) {
+	non_stl::monotonic_buffer a;
+	non_stl::monotonic_buffer b;
+	using arena_small = non_stl::small_vector<std::string, 2, non_stl::arena_allocator<std::string> >;
+
+	arena_small lhs(a);
+	lhs.push_back("a");
+	ASSERT_EQ(a.bytes_allocated(), 0u);
+	lhs.push_back("b");
+	lhs.push_back("c");
+	ASSERT_GT(a.bytes_allocated(), 0u);
+
+	arena_small rhs({ "d", "e", "f", "g" }, b);
+	lhs.swap(rhs);
+	ASSERT_EQ(lhs.get_allocator().buffer(), &a);
+	ASSERT_EQ(lhs.size(), 4);
+	ASSERT_EQ(lhs[3], "g");
+	ASSERT_EQ(rhs.size(), 3);
+	ASSERT_EQ(rhs[0], "a");
+
+	lhs = std::move(rhs);
+	ASSERT_EQ(lhs.get_allocator().buffer(), &a);
+	ASSERT_EQ(lhs.size(), 3);
+	ASSERT_EQ(lhs[2], "c");
+}
+
+// pmr aliases
+
+TEST(PmrTest, Vector) {
+	non_stl::monotonic_buffer buffer;
+	non_stl::pmr::vector<int> vec(&buffer);
+
+	for (int i = 0; i < 50; ++i) {
+		vec.push_back(i);
+	}
+	ASSERT_EQ(vec.size(), 50);
+	ASSERT_EQ(vec[49], 49);
+	ASSERT_EQ(vec.get_allocator().resource(), &buffer);
+	ASSERT_GE(buffer.bytes_allocated(), 50 * sizeof(int));
+
+	// polymorphic_allocator doesn't propagate on copy construction
+	non_stl::pmr::vector<int> copy(vec);
+	ASSERT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+	ASSERT_EQ(copy[10], 10);
+}
+
+TEST(PmrTest, SmallVector) {
+	non_stl::monotonic_buffer buffer;
+	non_stl::pmr::small_vector<int, 4> vec(&buffer);
+
+	for (int i = 0; i < 10; ++i) {
+		vec.push_back(i);
+	}
+	ASSERT_FALSE(vec.is_inline());
+	ASSERT_EQ(vec.get_allocator().resource(), &buffer);
+	ASSERT_EQ(vec[9], 9);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,297 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../../net/socket_buffer.h"
+
+namespace net = non_stl::net;
+
+// A connected pair of non blocking stream sockets, closed on destruction
+struct socket_pair {
+	int fds[2];
+
+	socket_pair() {
+		if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+			fds[0] = fds[1] = -1;
+			return;
+		}
+		for (int fd : fds) {
+			::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+		}
+	}
+
+	~socket_pair() {
+		for (int fd : fds) {
+			if (fd >= 0) {
+				::close(fd);
+			}
+		}
+	}
+};
+
+static non_stl::span<const std::byte> bytes_of(const std::string& s) {
+	return non_stl::span<const std::byte>(reinterpret_cast<const std::byte*>(s.data()), s.size());
+}
+
+static std::string string_of(const net::frame& f) {
+	std::string s(f.size(), '\0');
+	f.copy_to(reinterpret_cast<std::byte*>(&s[0]));
+	return s;
+}
+
+// Send and receive
+
+TEST(SocketBufferTest, Basic) {
+	socket_pair pair;
+	ASSERT_GE(pair.fds[0], 0);
+
+	net::socket_buffer<16> out;
+	net::socket_buffer<16> in;
+	ASSERT_TRUE(in.empty());
+	ASSERT_EQ(in.available(), 16);
+
+	// Nothing to read yet
+	net::io_result r = in.recv(pair.fds[1]);
+	ASSERT_FALSE(r);
+	ASSERT_TRUE(r.would_block());
+
+	// Nothing to send is not an error
+	ASSERT_TRUE(out.send(pair.fds[0]));
+
+	const std::string hello = "hello world";
+	out.ring().push_back_n(bytes_of(hello).data(), hello.size());
+	r = out.send(pair.fds[0]);
+	ASSERT_TRUE(r);
+	ASSERT_EQ(r.bytes, hello.size());
+	ASSERT_TRUE(out.empty());
+
+	r = in.recv(pair.fds[1]);
+	ASSERT_TRUE(r);
+	ASSERT_EQ(r.bytes, hello.size());
+	ASSERT_EQ(in.size(), hello.size());
+	ASSERT_EQ(in.ring().front(), std::byte('h'));
+	ASSERT_EQ(in.consume(6), 6);
+	ASSERT_EQ(in.ring().front(), std::byte('w'));
+
+	// The next read lands in the 5 free slots at the end and wraps around into the 6 at the start
+	const std::string more = "0123456789a";
+	ASSERT_EQ(::write(pair.fds[0], more.data(), more.size()), static_cast<ssize_t>(more.size()));
+	r = in.recv(pair.fds[1]);
+	ASSERT_TRUE(r);
+	ASSERT_EQ(r.bytes, 11);
+	ASSERT_EQ(in.size(), 16);
+	ASSERT_EQ(in.ring().array_two().size(), 6);
+	ASSERT_EQ(in.ring().back(), std::byte('a'));
+
+	// A full buffer doesn't read
+	r = in.recv(pair.fds[1]);
+	ASSERT_EQ(r.error, ENOBUFS);
+
+	// Sending straight from the two runs of the ring
+	r = in.send(pair.fds[1]);
+	ASSERT_TRUE(r);
+	ASSERT_EQ(r.bytes, 16);
+	char echoed[16];
+	ASSERT_EQ(::read(pair.fds[0], echoed, sizeof(echoed)), 16);
+	ASSERT_EQ(std::string(echoed, 16), "world0123456789a");
+
+	::close(pair.fds[0]);
+	pair.fds[0] = -1;
+	r = in.recv(pair.fds[1]);
+	ASSERT_FALSE(r);
+	ASSERT_TRUE(r.eof);
+}
+
+TEST(DynamicSocketBufferTest, Basic) {
+	socket_pair pair;
+	ASSERT_GE(pair.fds[0], 0);
+
+	net::dynamic_socket_buffer<> in(8);
+	ASSERT_EQ(in.available(), 8);
+
+	ASSERT_EQ(::write(pair.fds[0], "abcdefghij", 10), 10);
+	net::io_result r = in.recv(pair.fds[1]);
+	ASSERT_EQ(r.bytes, 8);
+	ASSERT_EQ(in.consume(8), 8);
+
+	// An emptied buffer reads from the start of its array again
+	r = in.recv(pair.fds[1]);
+	ASSERT_EQ(r.bytes, 2);
+	ASSERT_TRUE(in.ring().array_two().empty());
+	ASSERT_EQ(in.ring().front(), std::byte('i'));
+}
+
+TEST(SocketBufferPrepareTest, Basic) {
+	net::socket_buffer<8> buffer;
+
+	// As an asynchronous backend would, fill the iovecs and report the result later
+	non_stl::span<const iovec> iov = buffer.prepare_recv();
+	ASSERT_EQ(iov.size(), 1);
+	ASSERT_EQ(iov[0].iov_len, 8);
+	std::memcpy(iov[0].iov_base, "abcde", 5);
+	ASSERT_EQ(buffer.commit_recv(5).bytes, 5);
+	ASSERT_EQ(buffer.size(), 5);
+
+	ASSERT_EQ(buffer.consume(3), 3);
+	iov = buffer.prepare_recv();
+	ASSERT_EQ(iov.size(), 2);
+	ASSERT_EQ(iov[0].iov_len + iov[1].iov_len, 6);
+
+	net::io_result r = buffer.commit_recv(-EAGAIN);
+	ASSERT_TRUE(r.would_block());
+	ASSERT_EQ(buffer.size(), 2);
+
+	iov = buffer.prepare_send();
+	ASSERT_EQ(iov.size(), 1);
+	ASSERT_EQ(iov[0].iov_len, 2);
+	ASSERT_EQ(buffer.commit_send(1).bytes, 1);
+	ASSERT_EQ(buffer.ring().front(), std::byte('e'));
+}
+
+// Framing
+
+TEST(FramingTest, Basic) {
+	net::length_prefixed_framing<> framing;
+	net::socket_buffer<32> buffer;
+	net::frame f;
+	ASSERT_EQ(framing.next(buffer, f), net::frame_status::incomplete);
+
+	ASSERT_TRUE(framing.push(buffer, bytes_of("ping")));
+	ASSERT_TRUE(framing.push(buffer, bytes_of("")));
+	ASSERT_EQ(buffer.size(), 4 + 4 + 4);
+
+	// Big endian prefix
+	ASSERT_EQ(buffer.ring()[3], std::byte(4));
+	ASSERT_EQ(buffer.ring()[0], std::byte(0));
+
+	ASSERT_EQ(framing.next(buffer, f), net::frame_status::complete);
+	ASSERT_TRUE(f.contiguous());
+	ASSERT_EQ(string_of(f), "ping");
+
+	// The payload is a view into the ring
+	ASSERT_EQ(f.one.data(), &buffer.ring()[4]);
+	framing.pop(buffer, f);
+
+	ASSERT_EQ(framing.next(buffer, f), net::frame_status::complete);
+	ASSERT_EQ(f.size(), 0);
+	framing.pop(buffer, f);
+	ASSERT_TRUE(buffer.empty());
+
+	// Too big for the free slots
+	ASSERT_FALSE(framing.push(buffer, bytes_of(std::string(29, 'x'))));
+	ASSERT_TRUE(buffer.empty());
+}
+
+TEST(FramingWrapTest, Basic) {
+	net::length_prefixed_framing<std::uint16_t, net::byte_order::little> framing;
+	net::socket_buffer<16> buffer;
+	net::frame f;
+
+	// One byte left in slot 11 keeps the buffer from starting over at slot 0
+	const std::byte filler[15] = {};
+	buffer.ring().push_back_n(filler, 12);
+	buffer.consume(11);
+
+	// The payload wraps past the end of the array
+	ASSERT_TRUE(framing.push(buffer, bytes_of("wrapped")));
+	buffer.consume(1);
+	ASSERT_EQ(buffer.ring()[0], std::byte(7));
+	ASSERT_EQ(buffer.ring()[1], std::byte(0));
+
+	// Incomplete until every byte of the payload arrived
+	net::socket_buffer<16> partial;
+	partial.ring().push_back_n(&buffer.ring()[0], 1);
+	ASSERT_EQ(framing.next(partial, f), net::frame_status::incomplete);
+	partial.ring().push_back_n(&buffer.ring()[1], 5);
+	ASSERT_EQ(framing.next(partial, f), net::frame_status::incomplete);
+
+	ASSERT_EQ(framing.next(buffer, f), net::frame_status::complete);
+	ASSERT_FALSE(f.contiguous());
+	ASSERT_EQ(f.one.size(), 2);
+	ASSERT_EQ(f.two.size(), 5);
+	ASSERT_EQ(string_of(f), "wrapped");
+	framing.pop(buffer, f);
+	ASSERT_TRUE(buffer.empty());
+
+	// The prefix itself wraps, the payload is then entirely at the start of the array
+	buffer.ring().push_back_n(filler, 15);
+	buffer.consume(14);
+	ASSERT_TRUE(framing.push(buffer, bytes_of("split")));
+	buffer.consume(1);
+	ASSERT_EQ(framing.next(buffer, f), net::frame_status::complete);
+	ASSERT_TRUE(f.one.empty());
+	ASSERT_EQ(string_of(f), "split");
+	ASSERT_EQ(f.two.data(), &buffer.ring()[2]);
+}
+
+TEST(FramingLimitTest, Basic) {
+	net::length_prefixed_framing<std::uint32_t> framing(100);
+	net::socket_buffer<64> buffer;
+	net::frame f;
+
+	// Longer than the limit
+	const std::byte big[4] = { std::byte(0), std::byte(0), std::byte(0), std::byte(101) };
+	buffer.ring().push_back_n(big, 4);
+	ASSERT_EQ(framing.next(buffer, f), net::frame_status::too_large);
+	buffer.consume(4);
+
+	// Within the limit but never fitting in the buffer
+	const std::byte wide[4] = { std::byte(0), std::byte(0), std::byte(0), std::byte(61) };
+	buffer.ring().push_back_n(wide, 4);
+	ASSERT_EQ(framing.next(buffer, f), net::frame_status::too_large);
+	buffer.consume(4);
+
+	ASSERT_FALSE(framing.push(buffer, bytes_of(std::string(101, 'x'))));
+	ASSERT_TRUE(framing.push(buffer, bytes_of(std::string(60, 'x'))));
+	ASSERT_EQ(framing.next(buffer, f), net::frame_status::complete);
+	ASSERT_EQ(f.size(), 60);
+}
+
+TEST(FramingStreamTest, Basic) {
+	socket_pair pair;
+	ASSERT_GE(pair.fds[0], 0);
+
+	// Messages go through a small ring so they keep wrapping and arrive in pieces
+	net::length_prefixed_framing<std::uint16_t> framing;
+	net::dynamic_socket_buffer<> out(64);
+	net::socket_buffer<48> in;
+
+	std::vector<std::string> sent;
+	std::vector<std::string> received;
+	for (int i = 0; i < 200; ++i) {
+		sent.push_back(std::string(static_cast<size_t>(i % 37), static_cast<char>('a' + i % 26)));
+	}
+
+	size_t next = 0;
+	while (received.size() < sent.size()) {
+		while (next < sent.size() && framing.push(out, bytes_of(sent[next]))) {
+			++next;
+		}
+		const net::io_result w = out.send(pair.fds[0]);
+		ASSERT_TRUE(w || w.would_block());
+
+		const net::io_result r = in.recv(pair.fds[1]);
+		ASSERT_TRUE(r || r.would_block() || r.error == ENOBUFS);
+
+		net::frame f;
+		while (framing.next(in, f) == net::frame_status::complete) {
+			received.push_back(string_of(f));
+			framing.pop(in, f);
+		}
+	}
+	ASSERT_EQ(received, sent);
+}
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}